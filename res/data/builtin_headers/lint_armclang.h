@@ -15,6 +15,7 @@
 #endif
 
 // internal macros
+#ifndef __EIDE_PROBED_MACROS // skipped if the macros are generated from the compiler
 #define _ILP32 1
 #define _USE_STATIC_INLINE 1
 #define __APCS_32__ 1
@@ -361,6 +362,7 @@
 #define __clang_patchlevel__ 0
 #define __clang_version__ "7.0.0 "
 #define __llvm__ 1
+#endif // !__EIDE_PROBED_MACROS
 
 // unofficial defines
 #define volatile(x)
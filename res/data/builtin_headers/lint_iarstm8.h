@@ -50,6 +50,7 @@
 #define __save_reg20
 
 // compiler predefine macros
+#ifndef __EIDE_PROBED_MACROS // skipped if the macros are generated from the compiler
 #define __CHAR_BITS__ 8
 #define __CHAR_MAX__ 0xff
 #define __CHAR_MIN__ 0
@@ -323,4 +324,5 @@
 #define _DLIB_CONFIG_FILE_HEADER_NAME "DLib_Config_Normal.h"
 #define _DLIB_CONFIG_FILE_STRING "DLib_Config_Normal.h"
 #define __VERSION__ "IAR C/C++ Compiler V3.11.1.207 for STM8"
+#endif // !__EIDE_PROBED_MACROS
 
@@ -0,0 +1,436 @@
+/*
+ * Retarget library for newlib, see 'gcc_retarget.h' for the configurations.
+ *
+ * The other system calls are still provided by the weak stubs in 'sys_stubs.c'.
+*/
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/times.h>
+
+#include "gcc_retarget.h"
+
+#ifndef RETARGET_BACKEND
+#define RETARGET_BACKEND RETARGET_BACKEND_USER
+#endif
+
+#ifndef RETARGET_BUF_SIZE
+#define RETARGET_BUF_SIZE 256
+#endif
+
+#if (RETARGET_BUF_SIZE & (RETARGET_BUF_SIZE - 1)) != 0
+#error "RETARGET_BUF_SIZE must be a power of 2"
+#endif
+
+#ifndef RETARGET_FLUSH_ON_NEWLINE
+#define RETARGET_FLUSH_ON_NEWLINE 1
+#endif
+
+#ifndef RETARGET_BLOCKING
+#define RETARGET_BLOCKING 0
+#endif
+
+#ifndef RETARGET_STACK_RESERVE
+#define RETARGET_STACK_RESERVE 1024
+#endif
+
+#ifndef RETARGET_CPU_FREQ
+#define RETARGET_CPU_FREQ 0
+#endif
+
+#ifndef RETARGET_RTT_CHANNEL
+#define RETARGET_RTT_CHANNEL 0
+#endif
+
+#define RT_BUF_MASK    (RETARGET_BUF_SIZE - 1U)
+#define RT_HEAP_GUARD  0xCAFEF00DU
+
+__attribute__((used)) volatile retarget_stats_t retarget_stats = {
+    .magic = RETARGET_STATS_MAGIC,
+    .version = 1,
+};
+
+uint32_t retarget_cpu_freq = RETARGET_CPU_FREQ;
+
+/////////////////////////////////////////////////
+// backends
+/////////////////////////////////////////////////
+
+#if RETARGET_BACKEND == RETARGET_BACKEND_ITM
+
+#define RT_ITM_PORT0_U8  (*(volatile uint8_t *)0xE0000000UL)
+#define RT_ITM_PORT0_U32 (*(volatile uint32_t *)0xE0000000UL)
+#define RT_ITM_TER       (*(volatile uint32_t *)0xE0000E00UL)
+#define RT_ITM_TCR       (*(volatile uint32_t *)0xE0000E80UL)
+
+__attribute__((weak)) size_t retarget_backend_write(const uint8_t *data, size_t len)
+{
+    size_t i = 0;
+
+    // ITM is not enabled by the debugger, discard
+    if ((RT_ITM_TCR & 1UL) == 0 || (RT_ITM_TER & 1UL) == 0)
+        return len;
+
+    // 4 chars per stimulus write
+    for (; i + 4 <= len; i += 4)
+    {
+        uint32_t word;
+        memcpy(&word, data + i, 4);
+        while (RT_ITM_PORT0_U32 == 0)
+            ;
+        RT_ITM_PORT0_U32 = word;
+    }
+
+    for (; i < len; i++)
+    {
+        while (RT_ITM_PORT0_U32 == 0)
+            ;
+        RT_ITM_PORT0_U8 = data[i];
+    }
+
+    return len;
+}
+
+#elif RETARGET_BACKEND == RETARGET_BACKEND_RTT
+
+extern unsigned SEGGER_RTT_Write(unsigned BufferIndex, const void *pBuffer, unsigned NumBytes);
+
+__attribute__((weak)) size_t retarget_backend_write(const uint8_t *data, size_t len)
+{
+    return SEGGER_RTT_Write(RETARGET_RTT_CHANNEL, data, (unsigned)len);
+}
+
+#elif RETARGET_BACKEND == RETARGET_BACKEND_UART
+
+__attribute__((weak)) size_t retarget_backend_write(const uint8_t *data, size_t len)
+{
+    return retarget_uart_write(data, len);
+}
+
+#else
+
+__attribute__((weak)) size_t retarget_backend_write(const uint8_t *data, size_t len)
+{
+    (void)data;
+    return len;
+}
+
+#endif
+
+__attribute__((weak)) void retarget_flush_begin(void)
+{
+}
+
+__attribute__((weak)) void retarget_flush_end(void)
+{
+}
+
+/////////////////////////////////////////////////
+// output
+/////////////////////////////////////////////////
+
+static uint8_t rt_buf[RETARGET_BUF_SIZE];
+static volatile uint32_t rt_head; // write position, free running
+static volatile uint32_t rt_tail; // read position, free running
+static volatile int rt_flushing;
+
+static size_t rt_backend_write(const uint8_t *data, size_t len)
+{
+    size_t n = retarget_backend_write(data, len);
+    if (n > len)
+        n = len;
+    retarget_stats.flushes++;
+    retarget_stats.bytes_written += n;
+    return n;
+}
+
+void retarget_flush(void)
+{
+    // 'printf' in the backend or the hooks
+    if (rt_flushing)
+        return;
+
+    rt_flushing = 1;
+    retarget_flush_begin();
+
+    while (rt_tail != rt_head)
+    {
+        uint32_t off = rt_tail & RT_BUF_MASK;
+        uint32_t n = rt_head - rt_tail;
+
+        // the data is wrapped, send it in 2 parts
+        if (n > RETARGET_BUF_SIZE - off)
+            n = RETARGET_BUF_SIZE - off;
+
+        size_t done = rt_backend_write(&rt_buf[off], n);
+        if (done == 0)
+            break; // the backend is busy, keep the rest in buffer
+
+        rt_tail += (uint32_t)done;
+    }
+
+    retarget_flush_end();
+    rt_flushing = 0;
+}
+
+int _write(int file, char *ptr, int len)
+{
+    const uint8_t *p = (const uint8_t *)ptr;
+    size_t remain = len > 0 ? (size_t)len : 0;
+    int flush = (file == 2);
+
+    if (file != 1 && file != 2)
+    {
+        errno = EBADF;
+        return -1;
+    }
+
+    retarget_stats.write_calls++;
+
+    // a large block, send it directly if nothing is buffered
+    if (remain >= RETARGET_BUF_SIZE && rt_head == rt_tail && !rt_flushing)
+    {
+        retarget_flush_begin();
+        while (remain >= RETARGET_BUF_SIZE)
+        {
+            size_t done = rt_backend_write(p, remain);
+            if (done == 0)
+                break;
+            p += done;
+            remain -= done;
+        }
+        retarget_flush_end();
+    }
+
+    while (remain > 0)
+    {
+        uint32_t room = RETARGET_BUF_SIZE - (rt_head - rt_tail);
+
+        if (room == 0)
+        {
+            retarget_flush();
+            room = RETARGET_BUF_SIZE - (rt_head - rt_tail);
+            if (room == 0)
+            {
+                if (RETARGET_BLOCKING && !rt_flushing)
+                    continue;
+                retarget_stats.bytes_dropped += remain;
+                break;
+            }
+        }
+
+        uint32_t off = rt_head & RT_BUF_MASK;
+        uint32_t n = RETARGET_BUF_SIZE - off;
+        if (n > room)
+            n = room;
+        if (n > remain)
+            n = (uint32_t)remain;
+
+        memcpy(&rt_buf[off], p, n);
+
+#if RETARGET_FLUSH_ON_NEWLINE
+        if (!flush && memchr(p, '\n', n) != NULL)
+            flush = 1;
+#endif
+
+        rt_head += n;
+        p += n;
+        remain -= n;
+
+        if (rt_head - rt_tail > retarget_stats.buf_peak)
+            retarget_stats.buf_peak = rt_head - rt_tail;
+    }
+
+    if (flush)
+        retarget_flush();
+
+    return len;
+}
+
+int _isatty(int file)
+{
+    if (file >= 0 && file <= 2)
+        return 1;
+    errno = EBADF;
+    return 0;
+}
+
+int _fstat(int file, struct stat *st)
+{
+    if (file < 0 || file > 2)
+    {
+        errno = EBADF;
+        return -1;
+    }
+    memset(st, 0, sizeof(*st));
+    st->st_mode = S_IFCHR;
+    return 0;
+}
+
+/////////////////////////////////////////////////
+// heap
+/////////////////////////////////////////////////
+
+#ifdef RETARGET_HEAP_SIZE
+
+static uint8_t rt_heap[RETARGET_HEAP_SIZE] __attribute__((aligned(8)));
+#define RT_HEAP_START() (rt_heap)
+#define RT_HEAP_LIMIT() (rt_heap + RETARGET_HEAP_SIZE)
+
+#else
+
+extern char end; // defined by the linker script
+#define RT_HEAP_START() ((uint8_t *)&end)
+#define RT_HEAP_LIMIT() ((uint8_t *)__builtin_frame_address(0) - RETARGET_STACK_RESERVE)
+
+#endif
+
+static uint8_t *rt_heap_base;
+static uint8_t *rt_brk;
+
+static volatile uint32_t *rt_guard_addr(void)
+{
+    return (volatile uint32_t *)(((uintptr_t)rt_brk + 3U) & ~(uintptr_t)3U);
+}
+
+int retarget_heap_check(void)
+{
+    if (rt_brk == NULL)
+        return 1;
+
+    volatile uint32_t *guard = rt_guard_addr();
+    if (*guard != RT_HEAP_GUARD)
+    {
+        retarget_stats.guard_errors++;
+        *guard = RT_HEAP_GUARD;
+        return 0;
+    }
+
+    return 1;
+}
+
+void *_sbrk(ptrdiff_t incr)
+{
+    if (rt_brk == NULL)
+    {
+        rt_heap_base = (uint8_t *)(((uintptr_t)RT_HEAP_START() + 7U) & ~(uintptr_t)7U);
+        rt_brk = rt_heap_base;
+        *rt_guard_addr() = RT_HEAP_GUARD;
+    }
+
+    retarget_heap_check();
+
+    uint8_t *limit = RT_HEAP_LIMIT();
+    uint8_t *prev = rt_brk;
+
+    retarget_stats.heap_size = limit > rt_heap_base ? (uint32_t)(limit - rt_heap_base) : 0;
+
+    // keep room for the guard
+    if ((incr > 0 && (limit - prev) < incr + 7) ||
+        (incr < 0 && (prev - rt_heap_base) < -incr))
+    {
+        retarget_stats.sbrk_fails++;
+        errno = ENOMEM;
+        return (void *)-1;
+    }
+
+    rt_brk = prev + incr;
+    *rt_guard_addr() = RT_HEAP_GUARD;
+
+    retarget_stats.heap_used = (uint32_t)(rt_brk - rt_heap_base);
+    if (retarget_stats.heap_used > retarget_stats.heap_peak)
+        retarget_stats.heap_peak = retarget_stats.heap_used;
+
+    return prev;
+}
+
+/////////////////////////////////////////////////
+// time
+/////////////////////////////////////////////////
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+    defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8_1M_MAIN__)
+
+#define RT_DEMCR      (*(volatile uint32_t *)0xE000EDFCUL)
+#define RT_DWT_CTRL   (*(volatile uint32_t *)0xE0001000UL)
+#define RT_DWT_CYCCNT (*(volatile uint32_t *)0xE0001004UL)
+
+__attribute__((weak)) uint32_t retarget_get_cycles(void)
+{
+    if ((RT_DWT_CTRL & 1UL) == 0)
+    {
+        RT_DEMCR |= (1UL << 24); // TRCENA
+        RT_DWT_CYCCNT = 0;
+        RT_DWT_CTRL |= 1UL;      // CYCCNTENA
+    }
+    return RT_DWT_CYCCNT;
+}
+
+#else
+
+__attribute__((weak)) uint32_t retarget_get_cycles(void)
+{
+    return 0;
+}
+
+#endif
+
+static uint32_t rt_cycles_last;
+static uint32_t rt_cycles_high;
+
+uint64_t retarget_cycles64(void)
+{
+    uint32_t now = retarget_get_cycles();
+    if (now < rt_cycles_last)
+        rt_cycles_high++;
+    rt_cycles_last = now;
+    return ((uint64_t)rt_cycles_high << 32) | now;
+}
+
+int _gettimeofday(struct timeval *tv, void *tz)
+{
+    (void)tz;
+
+    uint32_t freq = retarget_cpu_freq;
+    if (freq == 0)
+    {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    if (tv != NULL)
+    {
+        uint64_t cycles = retarget_cycles64();
+        tv->tv_sec = (time_t)(cycles / freq);
+        tv->tv_usec = (suseconds_t)((cycles % freq) * 1000000U / freq);
+    }
+
+    return 0;
+}
+
+clock_t _times(struct tms *buf)
+{
+    uint32_t freq = retarget_cpu_freq;
+    if (freq == 0)
+    {
+        errno = ENOSYS;
+        return (clock_t)-1;
+    }
+
+    uint64_t cycles = retarget_cycles64();
+    clock_t ticks = (clock_t)((cycles / freq) * CLOCKS_PER_SEC + (cycles % freq) * CLOCKS_PER_SEC / freq);
+
+    if (buf != NULL)
+    {
+        buf->tms_utime = ticks;
+        buf->tms_stime = 0;
+        buf->tms_cutime = 0;
+        buf->tms_cstime = 0;
+    }
+
+    return ticks;
+}
@@ -0,0 +1,113 @@
+/*
+ * Retarget library for newlib (arm-none-eabi-gcc, riscv-none-elf-gcc, ...)
+ *
+ * A replacement of the 'ENOSYS' system stubs for the calls which are used
+ * by 'printf', 'malloc' and 'clock':
+ *
+ *  - '_write' copies the data into a ring buffer, the buffer is flushed to
+ *    the backend in batches (when it is full, at a new line, or by
+ *    'retarget_flush()'), not character by character.
+ *  - '_sbrk' checks the heap limit, tracks the high watermark and keeps a
+ *    guard word at the top of the heap.
+ *  - '_gettimeofday' and '_times' are based on a cycle counter.
+ *  - 'retarget_stats' is a static struct which can be read by the debugger
+ *    (add it to the watch view, or read it by 'x/12wx &retarget_stats').
+ *
+ * Configuration (define them in the project macros):
+ *
+ *  RETARGET_BACKEND            RETARGET_BACKEND_USER (default), RETARGET_BACKEND_UART,
+ *                              RETARGET_BACKEND_ITM, RETARGET_BACKEND_RTT
+ *  RETARGET_BUF_SIZE           size of the output ring buffer, power of 2, default: 256
+ *  RETARGET_FLUSH_ON_NEWLINE   flush at '\n', default: 1
+ *  RETARGET_BLOCKING           wait for the backend when the buffer is full,
+ *                              otherwise the data is dropped, default: 0
+ *  RETARGET_HEAP_SIZE          use a static heap of this size, otherwise the heap
+ *                              begins at the linker symbol 'end' and grows to the stack
+ *  RETARGET_STACK_RESERVE      bytes kept for the stack when the heap grows to it, default: 1024
+ *  RETARGET_CPU_FREQ           initial value of 'retarget_cpu_freq' (Hz), default: 0
+*/
+
+#ifndef __GCC_RETARGET_H__
+#define __GCC_RETARGET_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RETARGET_BACKEND_USER 0
+#define RETARGET_BACKEND_UART 1
+#define RETARGET_BACKEND_ITM  2
+#define RETARGET_BACKEND_RTT  3
+
+#define RETARGET_STATS_MAGIC 0x52544753U /* 'RTGS' */
+
+/**
+ * statistics, the layout is fixed, new fields are only appended
+*/
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+
+    /* output */
+    uint32_t write_calls;   /* calls of '_write' */
+    uint32_t bytes_written; /* bytes accepted by the backend */
+    uint32_t bytes_dropped; /* bytes dropped when the buffer is full */
+    uint32_t flushes;       /* backend calls */
+    uint32_t buf_peak;      /* max used bytes of the ring buffer */
+
+    /* heap */
+    uint32_t heap_size;     /* total size of the heap, 0 if unknown */
+    uint32_t heap_used;
+    uint32_t heap_peak;     /* high watermark */
+    uint32_t sbrk_fails;
+    uint32_t guard_errors;  /* times that the heap guard is found broken */
+
+} retarget_stats_t;
+
+extern volatile retarget_stats_t retarget_stats;
+
+/** cpu frequency (Hz) used by '_gettimeofday' and '_times', 0: time is not supported */
+extern uint32_t retarget_cpu_freq;
+
+/** send all buffered data to the backend */
+void retarget_flush(void);
+
+/** check the heap guard, returns 0 if the guard is broken */
+int retarget_heap_check(void);
+
+/** 64-bit cycles, must be called at least once per overflow of the 32-bit counter */
+uint64_t retarget_cycles64(void);
+
+/*
+ * hooks, they are weak and can be overridden by the application
+*/
+
+/**
+ * write data to the backend, returns the number of the accepted bytes.
+ * the default implementation depends on RETARGET_BACKEND:
+ *  USER: discard the data
+ *  UART: call 'retarget_uart_write()', which must be provided by the application
+ *  ITM : write to the stimulus port 0
+ *  RTT : call 'SEGGER_RTT_Write()' with the channel RETARGET_RTT_CHANNEL (default: 0)
+*/
+size_t retarget_backend_write(const uint8_t *data, size_t len);
+
+/** blocking uart transmit, only used by RETARGET_BACKEND_UART */
+size_t retarget_uart_write(const uint8_t *data, size_t len);
+
+/** called before and after a batch of backend writes, e.g. to lock the uart or start a DMA */
+void retarget_flush_begin(void);
+void retarget_flush_end(void);
+
+/** read the 32-bit cycle counter, the default is DWT->CYCCNT on Cortex-M3 and above */
+uint32_t retarget_get_cycles(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
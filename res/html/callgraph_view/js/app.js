@@ -1 +1 @@
-import{y as j,J as B,O as ut,n as C,G as xe,H as Ue,w as dt,x as ne,S as ze,I as x,q as Y,R as f,_ as ft,W as P,u as D,C as pt,s as I,p as y,V as H,B as ue,M as vt,v as Ae,P as re,D as Q,m as Le,Q as N,r as K,A as gt,l as ht,k as mt,i as ee,t as R,c as ge,z as fe,g as Me,X as he,T as Oe,F as ie,K as Ge,N as yt,h as De,j as bt,L as wt,b as kt,E as Ct,e as xt,f as _t,U as Ve,a as Tt,d as Pe,o as Nt}from"./chunk-vendors.js";(function(){const o=document.createElement("link").relList;if(o&&o.supports&&o.supports("modulepreload"))return;for(const l of document.querySelectorAll('link[rel="modulepreload"]'))n(l);new MutationObserver(l=>{for(const r of l)if(r.type==="childList")for(const a of r.addedNodes)a.tagName==="LINK"&&a.rel==="modulepreload"&&n(a)}).observe(document,{childList:!0,subtree:!0});function t(l){const r={};return l.integrity&&(r.integrity=l.integrity),l.referrerPolicy&&(r.referrerPolicy=l.referrerPolicy),l.crossOrigin==="use-credentials"?r.credentials="include":l.crossOrigin==="anonymous"?r.credentials="omit":r.credentials="same-origin",r}function n(l){if(l.ep)return;l.ep=!0;const r=t(l);fetch(l.href,r)}})();const St={render(){return j("svg",{xmlns:"http://www.w3.org/2000/svg",viewBox:"0 0 24 24",width:"1em",height:"1em",fill:"currentColor"},[j("circle",{cx:5,cy:6,r:2}),j("circle",{cx:19,cy:6,r:2}),j("circle",{cx:12,cy:18,r:2}),j("path",{d:"M7 7l4 9m6-9l-4 9",stroke:"currentColor",fill:"none","stroke-width":1.5})])}},$t={render(){return j("svg",{xmlns:"http://www.w3.org/2000/svg",viewBox:"0 0 24 24",width:"1em",height:"1em",fill:"currentColor"},[j("path",{d:"M4 5h16v2H4V5zm0 4h16v2H4V9zm0 4h10v2H4v-2zm0 4h10v2H4v-2z"})])}},be={launched:"eide.callgraph_view.launched",init:"eide.callgraph_view.init",gotoDefinition:"callgraph.gotoDefinition"};class ce extends Error{constructor(o,t){super(t),this.code=o,this.name="HostBridgeError"}}const It=2e3;function Ke(e){if(typeof e!="object"||e===null)return!1;const o=e;return Array.isArray(o.callgraph)&&Array.isArray(o.stackusage)}function Et(e){return e==null||e==="$BUILD_REPORT"||typeof e=="string"&&e==="$BUILD_REPORT"}function se(){const e=window.__CALLGRAPH_VIEW_INIT__;if(!(Et(e)||!Ke(e)))return e}function We(){try{return typeof window.acquireVsCodeApi=="function"}catch{return!1}}function Bt(){var e;if(We())try{return(e=window.acquireVsCodeApi)==null?void 0:e.call(window)}catch{return}}function At(){const e=Bt(),o=e!==void 0;let t,n,l;const r=new Set;return o&&e&&window.addEventListener("message",a=>{const k=a.data;if(!k||typeof k!="object")return;const i=k;if((i.type??i.id)===be.init){const v=i.data??k.data;if(!Ke(v))return;t=v,r.forEach(h=>h(t)),n==null||n(),n=void 0,l=void 0}}),{inWebview:o,get hasInlineInit(){return se()!==void 0},ready(){return o&&e?se()?Promise.resolve():new Promise((a,k)=>{if(t){a();return}n=a,l=k,e.postMessage({id:be.launched}),setTimeout(()=>{n&&(l==null||l(new ce("WEBVIEW_INIT_TIMEOUT","WEBVIEW INIT TIMEOUT")),n=void 0,l=void 0)},It)}):se()?Promise.resolve():Promise.reject(new ce("NO_INLINE_DATA","NO INLINE DATA"))},loadReport(){if(o){if(t)return Promise.resolve(t);const k=se();return k?Promise.resolve(k):Promise.reject(new ce("INVALID_INIT","No data received from vscode webview"))}const a=se();return a?Promise.resolve(a):Promise.reject(new ce("NO_INLINE_DATA","NO INLINE DATA"))},gotoDefinition(a){var i;if(o&&e){e.postMessage({id:be.gotoDefinition,data:a});return}const k=a.line!==void 0?`${a.file}:${a.line}`:a.file;(i=navigator.clipboard)!=null&&i.writeText?navigator.clipboard.writeText(k):console.info("[Callgraph View] Go to:",k)},onReportUpdated(a){return r.add(a),()=>r.delete(a)}}}const ae=At();function Lt(e){if(!(e!=null&&e.trim()))return;const o=e.trim().match(/^(.+):(\d+):(\d+)$/);if(o)return{file:o[1],line:Number(o[2]),column:Number(o[3])}}function Mt(e,o,t){return`e-${e}-${o}-${t}`}function Dt(e){return JSON.stringify({sourcename:e.sourcename,targetname:e.targetname,label:e.label??""})}function Vt(e){const o=new Map,t=new Set,n=[];for(const l of e){for(const r of l.nodes)o.has(r.title)||o.set(r.title,r);for(const r of l.edges){const a=Dt(r);t.has(a)||(t.add(a),n.push(r))}}return{nodes:Array.from(o.values()),edges:n}}const te=-1;function Pt(e){return Array.isArray(e)?e.map(o=>{const t=o;return{graph:t.graph??{title:""},nodes:Array.isArray(t.nodes)?t.nodes:[],edges:Array.isArray(t.edges)?t.edges:[],warnings:t.warnings}}):[]}function Ft(e){return Array.isArray(e)?e.map(o=>{const t=o;return{entries:Array.isArray(t.entries)?t.entries:[],warnings:t.warnings}}):[]}function Ht(e,o,t){return o!==void 0&&t!==void 0?`${e}:${o}:${t}`:o!==void 0?`${e}:${o}`:e}const oe=ut(null),me=B(null),ye=B(!0);async function Rt(){ye.value=!0,me.value=null;try{await ae.ready(),oe.value=await ae.loadReport(),ae.onReportUpdated(e=>{oe.value=e})}catch(e){oe.value=null,me.value=e instanceof ce?e:new ce("INVALID_INIT",String(e))}finally{ye.value=!1}}function _e(){const e=C(()=>oe.value?Pt(oe.value.callgraph):[]),o=C(()=>oe.value?Ft(oe.value.stackusage):[]),t=C(()=>e.value.length>0),n=C(()=>o.value.length>0),l=C(()=>e.value.map((v,h)=>{var m;return{index:h,title:((m=v.graph)==null?void 0:m.title)||`Graph ${h+1}`,nodes:v.nodes,edges:v.edges,isEmpty:v.nodes.length===0}})),r=C(()=>{const v=l.value;if(v.length===0)return null;const{nodes:h,edges:m}=Vt(v);return{index:te,title:"Merged",nodes:h,edges:m,isEmpty:h.length===0}}),a=C(()=>o.value.map((v,h)=>({index:h,title:`Document ${h+1}`,entries:v.entries,isEmpty:v.entries.length===0}))),k=C(()=>o.value.flatMap(v=>v.entries)),i=C(()=>{const v=[];return a.value.forEach(h=>{h.entries.forEach(m=>{v.push({functionName:m.functionName,stackBytes:m.stackBytes,allocationType:m.allocationType,locationText:Ht(m.location.file,m.location.line,m.location.column),file:m.location.file,line:m.location.line,column:m.location.column,sourceDoc:h.title})})}),v}),p=C(()=>!ye.value&&!me.value&&!t.value&&!n.value);return{loading:ye,loadError:me,report:oe,callgraph:e,stackusage:o,hasCallgraph:t,hasStackUsage:n,callgraphGraphs:l,mergedCallgraphGraph:r,stackDocuments:a,allStackRows:i,allStackEntries:k,isFullyEmpty:p,hostBridge:ae}}const pe={selectedIndex:B(te),searchText:B(""),layoutDirection:B("LR"),hideOrphanNodes:B(!0),selectedNodeId:B(null),selectedEdge:B(null),selectedEdgeFlowId:B(null),graphStats:B(null)},Fe=B(!1),we=new Map,ke=new Map;function A(e,o){return getComputedStyle(document.body).getPropertyValue(e).trim()||o}function Ut(e){const o=e.trim();if(o.startsWith("#")&&o.length>=7){const t=parseInt(o.slice(1,3),16),n=parseInt(o.slice(3,5),16),l=parseInt(o.slice(5,7),16);return(t*299+n*587+l*114)/1e3<128}return!0}function zt(){const e=A("--vscode-editor-background","#1e1e1e"),o=A("--vscode-editor-foreground","#d4d4d4"),t=A("--vscode-editorWidget-background","#252526"),n=A("--vscode-editorWidget-border","#3c3c3c"),l=A("--vscode-list-hoverBackground","#2a2d2e"),r=A("--vscode-list-activeSelectionBackground","#094771"),a=A("--vscode-list-activeSelectionForeground","#ffffff"),k=A("--vscode-button-background","#0e639c"),i=A("--vscode-button-hoverBackground","#1177bb"),p=A("--vscode-input-background","#3c3c3c"),v=A("--vscode-input-foreground","#f0f0f0"),h=A("--vscode-input-placeholderForeground","#cccccc80"),m=A("--vscode-sideBar-background","#252526"),u=A("--vscode-settings-checkboxBackground",p),g=A("--vscode-settings-checkboxForeground",o),S=A("--vscode-settings-checkboxBorder",n);return{common:{bodyColor:e,cardColor:t,modalColor:t,popoverColor:t,textColorBase:o,textColor1:o,textColor2:o,textColor3:A("--vscode-descriptionForeground","#ccccccb3"),borderColor:n,dividerColor:n,hoverColor:l,primaryColor:k,primaryColorHover:i,primaryColorPressed:i,inputColor:p,inputColorDisabled:p,placeholderColor:h,iconColor:A("--vscode-icon-foreground","#cccccc"),iconColorHover:o,iconColorPressed:o,iconColorDisabled:h},Layout:{color:e,siderColor:m,headerColor:t},Menu:{color:m,itemColor:"transparent",itemColorActive:r,itemColorActiveHover:r,itemColorHover:l,itemTextColor:o,itemTextColorActive:a,itemTextColorHover:o,itemTextColorChildActive:a,itemIconColor:o,itemIconColorActive:a,itemIconColorHover:o},Select:{peers:{InternalSelection:{textColor:v,color:p,colorActive:p,border:`1px solid ${n}`,borderActive:`1px solid ${A("--vscode-focusBorder","#007acc")}`,borderHover:`1px solid ${n}`,borderFocus:`1px solid ${A("--vscode-focusBorder","#007acc")}`,boxShadowFocus:`0 0 0 1px ${A("--vscode-focusBorder","#007acc")}`,arrowColor:o},InternalSelectMenu:{color:t,optionTextColor:o,optionTextColorActive:a,optionColorPending:l,optionColorActive:r,optionColorActivePending:r}}},Input:{color:p,colorFocus:p,textColor:v,border:`1px solid ${n}`,borderHover:`1px solid ${n}`,borderFocus:`1px solid ${A("--vscode-focusBorder","#007acc")}`,boxShadowFocus:`0 0 0 1px ${A("--vscode-focusBorder","#007acc")}`,placeholderColor:h},Button:{textColor:A("--vscode-button-foreground","#ffffff"),color:k,colorHover:i,colorPressed:i,colorFocus:i,border:`1px solid ${n}`,borderHover:`1px solid ${n}`,borderPressed:`1px solid ${n}`,borderFocus:`1px solid ${A("--vscode-focusBorder","#007acc")}`},Dropdown:{color:t,optionTextColor:o,optionTextColorHover:o,optionTextColorActive:a,optionColorHover:l,optionColorActive:r},Empty:{textColor:o,iconColor:A("--vscode-icon-foreground","#cccccc"),extraTextColor:A("--vscode-descriptionForeground","#ccccccb3")},Scrollbar:{color:A("--vscode-scrollbarSlider-background","rgba(121, 121, 121, 0.4)"),colorHover:A("--vscode-scrollbarSlider-hoverBackground","rgba(100, 100, 100, 0.7)")},Spin:{color:k,textColor:o},Result:{textColor:o,titleTextColor:o},Tooltip:{color:t,textColor:o},Checkbox:{color:u,colorChecked:u,checkMarkColor:g,border:`1px solid ${S}`,borderChecked:`1px solid ${S}`,borderFocus:`1px solid ${S}`}}}function Ot(){const e=B(!0),o=B({}),t=()=>{const r=A("--vscode-editor-background","#1e1e1e");e.value=Ut(r),o.value=zt()};let n;return xe(()=>{t(),requestAnimationFrame(()=>t()),n=new MutationObserver(()=>t()),n.observe(document.body,{attributes:!0,attributeFilter:["class","data-vscode-theme","data-vscode-theme-kind"]}),n.observe(document.documentElement,{attributes:!0,attributeFilter:["class","data-vscode-theme","data-vscode-theme-kind"]})}),Ue(()=>{n==null||n.disconnect()}),{theme:C(()=>e.value?dt:null),overrides:o,refresh:t}}const Gt={key:0,xmlns:"http://www.w3.org/2000/svg",viewBox:"0 0 25 32",width:"16",height:"16","aria-hidden":"true"},Kt={key:1,xmlns:"http://www.w3.org/2000/svg",viewBox:"0 0 25 32",width:"16",height:"16","aria-hidden":"true"},Wt=ne({__name:"CallgraphControls",setup(e){const{nodesDraggable:o,setState:t}=ze();xe(()=>{o.value&&t({nodesDraggable:!1})});const n=C(()=>!o.value);function l(){t({nodesDraggable:!o.value})}return(r,a)=>(x(),Y(f(ft),{"show-interactive":!1},{default:P(()=>[D(f(pt),{class:"vue-flow__controls-interactive",title:n.value?"Unlock drag":"Lock drag",onClick:l},{default:P(()=>[n.value?(x(),I("svg",Gt,[...a[0]||(a[0]=[y("path",{fill:"currentColor",d:"M21.333 10.667H19.81V7.619C19.81 3.429 16.38 0 12.19 0 8 0 4.571 3.429 4.571 7.619v3.048H3.048A3.056 3.056 0 0 0 0 13.714v15.238A3.056 3.056 0 0 0 3.048 32h18.285a3.056 3.056 0 0 0 3.048-3.048V13.714a3.056 3.056 0 0 0-3.048-3.047zM12.19 24.533a3.056 3.056 0 0 1-3.047-3.047 3.056 3.056 0 0 1 3.047-3.048 3.056 3.056 0 0 1 3.048 3.048 3.056 3.056 0 0 1-3.048 3.047zm4.724-13.866H7.467V7.619c0-2.59 2.133-4.724 4.723-4.724 2.591 0 4.724 2.133 4.724 4.724v3.048z"},null,-1)])])):(x(),I("svg",Kt,[...a[1]||(a[1]=[y("path",{fill:"currentColor",d:"M21.333 10.667H19.81V7.619C19.81 3.429 16.38 0 12.19 0c-4.114 1.828-1.37 2.133.305 2.438 1.676.305 4.42 2.59 4.42 5.181v3.048H3.047A3.056 3.056 0 0 0 0 13.714v15.238A3.056 3.056 0 0 0 3.048 32h18.285a3.056 3.056 0 0 0 3.048-3.048V13.714a3.056 3.056 0 0 0-3.048-3.047zM12.19 24.533a3.056 3.056 0 0 1-3.047-3.047 3.056 3.056 0 0 1 3.047-3.048 3.056 3.056 0 0 1 3.048 3.048 3.056 3.056 0 0 1-3.048 3.047z"},null,-1)])]))]),_:1},8,["title"])]),_:1}))}}),qt=ne({__name:"CallgraphViewportSync",props:{flowKey:{},paneVisible:{type:Boolean}},setup(e){const o=e,{setViewport:t,viewport:n}=ze();return H(n,l=>{we.set(o.flowKey,{x:l.x,y:l.y,zoom:l.zoom})},{deep:!0}),H(()=>[o.paneVisible,o.flowKey],([l],[r])=>{if(r&&!l){we.set(o.flowKey,{x:n.value.x,y:n.value.y,zoom:n.value.zoom});return}if(!l)return;const a=we.get(o.flowKey);a&&ue(()=>{t(a,{duration:0})})}),(l,r)=>null}});function Te(e,o){const t=new Set,n=new Set;for(const l of o)l.targetname===e&&t.add(l.sourcename),l.sourcename===e&&n.add(l.targetname);return{callers:t,callees:n}}const qe=160,je=48;function jt(e){return e==="LR"?{source:re.Right,target:re.Left}:{source:re.Bottom,target:re.Top}}function Zt(e){return`n_${e.replace(/[^a-zA-Z0-9_-]/g,"_")}`}function Xt(e,o,t,n){const l=new Ae.graphlib.Graph;return l.setDefaultEdgeLabel(()=>({})),l.setGraph({rankdir:n,nodesep:24,ranksep:72}),e.forEach(r=>{l.setNode(t.get(r.title),{width:qe,height:je})}),o.forEach(r=>{const a=t.get(r.sourcename),k=t.get(r.targetname);a&&k&&l.setEdge(a,k)}),Ae.layout(l),l}function Jt(e,o,t="TB"){const n=new Map;e.forEach(g=>{n.set(g.title,Zt(g.title))});const l=Xt(e,o,n,t),{source:r,target:a}=jt(t),k=qe,i=je,p=40;let v=1/0,h=1/0;for(const g of e){const S=n.get(g.title);if(!S)continue;const L=l.node(S);L&&(v=Math.min(v,L.x-k/2),h=Math.min(h,L.y-i/2))}Number.isFinite(v)||(v=0),Number.isFinite(h)||(h=0);const m=e.map(g=>{const S=n.get(g.title),L=l.node(S);return{id:S,position:{x:((L==null?void 0:L.x)??0)-k/2-v+p,y:((L==null?void 0:L.y)??0)-i/2-h+p},width:k,height:i,style:{width:`${k}px`,height:`${i}px`},class:"callgraph-flow-node",sourcePosition:r,targetPosition:a,data:{label:g.label,shape:g.shape,location:g.location,title:g.title},type:"callgraph"}}),u=o.filter(g=>n.has(g.sourcename)&&n.has(g.targetname)).map((g,S)=>{const L=n.get(g.sourcename),F=n.get(g.targetname);return{id:Mt(S,L,F),source:L,target:F,animated:!1,markerEnd:vt.ArrowClosed,data:{sourceTitle:g.sourcename,targetTitle:g.targetname,label:g.label,vcgEdge:g}}});return{nodes:m,edges:u}}const Yt=["title"],Qt=["title"],eo={class:"cg-loc"},to=ne({__name:"CallgraphNode",props:{id:{},type:{},selected:{type:Boolean},connectable:{type:[Boolean,Number,String,Function]},position:{},dimensions:{},label:{},isValidTargetPos:{type:Function},isValidSourcePos:{type:Function},parent:{},parentNodeId:{},dragging:{type:Boolean},resizing:{type:Boolean},zIndex:{},targetPosition:{},sourcePosition:{},dragHandle:{},data:{},events:{}},setup(e){const o=e,t=C(()=>{const l=o.data.shape;return l==="triangle"?"node-triangle":l==="ellipse"?"node-ellipse":"node-box"}),n=C(()=>{const l=o.data.location;return l!=null&&l.file?l.line!==void 0&&l.column!==void 0?`${l.file}:${l.line}:${l.column}`:l.line!==void 0?`${l.file}:${l.line}`:l.file:""});return(l,r)=>{var a,k;return x(),I("div",{class:Q(["cg-node",[t.value,{selected:o.selected,"node-dimmed":o.data.dimmed,"node-highlighted":o.data.highlighted,"node-selected-role":o.data.highlightRole==="selected","node-caller":o.data.highlightRole==="caller","node-callee":o.data.highlightRole==="callee"}]])},[D(f(Le),{type:"target",position:o.targetPosition??f(re).Top},null,8,["position"]),y("div",{class:"cg-label",title:((a=o.data)==null?void 0:a.label)??""},N(((k=o.data)==null?void 0:k.label)??""),9,Yt),n.value?(x(),I("div",{key:0,class:"cg-loc-wrap",title:n.value},[y("span",eo,N(n.value),1)],8,Qt)):K("",!0),D(f(Le),{type:"source",position:o.sourcePosition??f(re).Bottom},null,8,["position"])],2)}}}),de=(e,o)=>{const t=e.__vccOpts||e;for(const[n,l]of o)t[n]=l;return t},oo=de(to,[["__scopeId","data-v-f9fa7eb9"]]),no={class:"callgraph-canvas"},lo={key:0,class:"search-hint"},ao={key:1,class:"edge-hint"},so=180,ro=52,io=ne({__name:"CallgraphCanvas",props:{graph:{},graphKey:{},searchText:{},layoutDirection:{},selectedNodeTitle:{},selectedEdgeId:{},focusNodeTitle:{},paneVisible:{type:Boolean}},emits:["nodeSelect","edgeSelect"],setup(e,{emit:o}){const t=e,n=o,l=B([]),r=B([]),a=B(new Map),k={callgraph:gt(oo)},i=C(()=>`${t.graphKey}::${t.layoutDirection}`),p=B(null),v=B(null);function h(_=0){var c;if(_>=12)return;const T=(c=p.value)==null?void 0:c.fitView;if(!T){window.setTimeout(()=>h(_+1),80);return}T({padding:.12,minZoom:.12,maxZoom:1.5,duration:0}).then(d=>{d?v.value=i.value:h(_+1)})}function m(){v.value!==i.value&&h()}function u(_,T=0){if(!_||T>=12)return;const c=p.value,d=c==null?void 0:c.setCenter;if(!d){window.setTimeout(()=>u(_,T+1),80);return}const b=a.value.get(_);if(!b){window.setTimeout(()=>u(_,T+1),80);return}d(b.x,b.y,{zoom:.85,duration:200})}const g=C(()=>{const _=t.searchText.trim().toLowerCase();if(!_||!t.graph)return new Set;const T=new Set;return t.graph.nodes.forEach(c=>{(c.label.toLowerCase().includes(_)||c.title.toLowerCase().includes(_))&&T.add(c.title)}),T}),S=C(()=>!t.searchText.trim()||g.value.size>0),L=C(()=>{var _,T;return(((_=t.graph)==null?void 0:_.edges.length)??0)===0&&(((T=t.graph)==null?void 0:T.nodes.length)??0)>0});function F(){const _=t.searchText.trim(),T=t.selectedNodeTitle,c=t.selectedEdgeId,d=T&&t.graph?Te(T,t.graph.edges):null;let b=null;if(c)for(const $ of r.value){if($.id!==c)continue;const E=$.data;E!=null&&E.sourceTitle&&(E!=null&&E.targetTitle)&&(b={source:E.sourceTitle,target:E.targetTitle});break}for(const $ of l.value){const E=$.data,U=E.title??$.id;let z=!1,J=!1,W;if(_&&(J=g.value.has(U),z=!J,t.focusNodeTitle===U&&(J=!0,z=!1,W="selected")),d)U===T?(W="selected",z=!1,J=!1):d.callers.has(U)?(W="caller",z=!1):d.callees.has(U)?(W="callee",z=!1):(!_||!g.value.has(U))&&(z=!0,W=void 0,J=!1);else if(b){const G=E.title??$.id;G===b.source||G===b.target?z=!1:(!_||!g.value.has(G))&&(z=!0),W=void 0}else W=void 0;E.dimmed=z,E.highlighted=J,E.highlightRole=W}for(const $ of r.value){const E=$.data,U=(E==null?void 0:E.sourceTitle)??"",z=(E==null?void 0:E.targetTitle)??"",J=!!c&&$.id===c,W=!!d&&!!T&&z===T;J?($.class="edge-selected",$.animated=!0):W||!!d&&!!T&&U===T?($.class=W?"edge-caller":"edge-callee",$.animated=!0):d&&T?($.class="edge-dimmed",$.animated=!1):($.class=void 0,$.animated=!1),$.style=void 0}}function V(){var c;if(!((c=t.graph)!=null&&c.nodes.length)){l.value=[],r.value=[];return}const _=Jt(t.graph.nodes,t.graph.edges,t.layoutDirection);l.value=_.nodes,r.value=_.edges;const T=new Map;for(const d of _.nodes){const b=d.data,$=b==null?void 0:b.title;$&&d.position&&T.set($,{x:d.position.x+so/2,y:d.position.y+ro/2})}a.value=T,F(),ue(()=>{m()})}H(()=>[t.graph,t.graphKey,t.layoutDirection],()=>{V()},{immediate:!0,deep:!0}),H(()=>[t.searchText,t.selectedNodeTitle,t.selectedEdgeId,t.focusNodeTitle],()=>{F()}),H(()=>t.focusNodeTitle,_=>{_&&ue(()=>u(_))}),H(l,(_,T)=>{var c;_.length===0&&T.length>0&&(((c=t.graph)==null?void 0:c.nodes.length)??0)>0&&V()});function q(_){var c;const T=((c=_.node.data)==null?void 0:c.title)??_.node.id;n("edgeSelect",null),n("nodeSelect",T)}function Z(_){var c;const T=(c=_.edge.data)==null?void 0:c.vcgEdge;T&&(n("nodeSelect",null),n("edgeSelect",{edge:T,flowId:_.edge.id}))}function X(){n("nodeSelect",null),n("edgeSelect",null)}return(_,T)=>(x(),I("div",no,[(x(),Y(f(ht),{ref_key:"vueFlowRef",ref:p,key:i.value,nodes:l.value,"onUpdate:nodes":T[0]||(T[0]=c=>l.value=c),edges:r.value,"onUpdate:edges":T[1]||(T[1]=c=>r.value=c),"node-types":k,"nodes-draggable":!1,"nodes-connectable":!1,"elements-selectable":!0,"default-zoom":1,"min-zoom":.05,"max-zoom":2,class:"callgraph-flow",onNodeClick:q,onEdgeClick:Z,onPaneClick:X,onNodesInitialized:m},{default:P(()=>[D(f(mt),{gap:16,"pattern-color":"var(--vscode-editorWidget-border, #3c3c3c)"}),D(Wt),D(qt,{"flow-key":i.value,"pane-visible":t.paneVisible??!0},null,8,["flow-key","pane-visible"])]),_:1},8,["nodes","edges"])),e.searchText.trim()&&!S.value?(x(),I("div",lo," No matched functions ")):K("",!0),L.value?(x(),I("div",ao,"No matched callgraph")):K("",!0)]))}}),co=de(io,[["__scopeId","data-v-9807dbbc"]]);function Ze(e,o){const t=new Map(o.map(n=>[n.title,n.label]));return e.sort((n,l)=>(t.get(n)??n).localeCompare(t.get(l)??l,void 0,{sensitivity:"base"}))}function uo(e,o,t){const{callers:n}=Te(e,o),l=new Set;if(n.size>0){l.add(e);for(const r of n)for(const a of o)a.sourcename===r&&l.add(a.targetname)}else{const r=new Set(o.map(a=>a.targetname));for(const a of t)r.has(a.title)||l.add(a.title);l.size===0&&l.add(e)}return Ze(Array.from(l),t)}function He(e,o,t,n){const{callers:l,callees:r}=Te(e,o);return Ze(Array.from(n==="callers"?l:r),t)}function fo(e){return e==="callers"?"callees":"callers"}function po(e){return e==="ArrowUp"||e==="ArrowDown"||e==="ArrowLeft"||e==="ArrowRight"}function vo(e){return e==="ArrowUp"?{mode:"level",delta:-1}:e==="ArrowDown"?{mode:"level",delta:1}:e==="ArrowLeft"?{mode:"callers",delta:-1}:e==="ArrowRight"?{mode:"callees",delta:1}:null}function go(){const e=document.activeElement;return e?!!(e instanceof HTMLInputElement||e instanceof HTMLTextAreaElement||e.closest(".n-base-select-menu, .n-base-selection")):!1}function ho(e){const o=B(null),t=B(0),n=B([]);let l=!1;function r(){n.value=[]}H(e.selectedNodeId,()=>{l||(o.value=null,t.value=0)}),H(e.searchText,u=>{u.trim()&&(o.value=null,t.value=0,r())});function a(u){l=!0,e.onSelectNode(u),e.onPanToNode(u),ue(()=>{l=!1})}function k(u,g,S){if(u.length!==0){if(o.value!==g){o.value=g;const L=e.selectedNodeId.value,F=L?u.indexOf(L):-1;t.value=F>=0?F:S>0?0:u.length-1}u.length===1?t.value=0:t.value=(t.value+S+u.length)%u.length,a(u[t.value])}}function i(u){const g=n.value[n.value.length-1];if(!g||g.via!==fo(u))return!1;const S=n.value.pop();o.value=u;const L=He(e.selectedNodeId.value,e.graphEdges.value,e.graphNodes.value,u);return t.value=L.indexOf(S.returnTo),a(S.returnTo),!0}function p(u,g){const S=e.selectedNodeId.value;if(!S||i(u))return;const L=e.graphEdges.value,F=e.graphNodes.value,V=He(S,L,F,u);if(V.length===0)return;if(o.value!==u){o.value=u;const Z=V.indexOf(S);t.value=Z>=0?Z:g>0?0:V.length-1}V.length===1?t.value=0:t.value=(t.value+g+V.length)%V.length;const q=V[t.value];q!==S&&n.value.push({returnTo:S,via:u}),a(q)}function v(u,g){const S=e.selectedNodeId.value;if(S){if(u==="level"){const L=uo(S,e.graphEdges.value,e.graphNodes.value);k(L,u,g);return}p(u,g)}}function h(u){e.hasSearchMatches.value&&(u.key==="ArrowDown"?(u.preventDefault(),e.goSearchNext()):u.key==="ArrowUp"&&(u.preventDefault(),e.goSearchPrev()))}function m(u){if(!e.paneVisible.value||go()||e.searchText.value.trim()||!po(u.key)||!e.selectedNodeId.value)return;const g=vo(u.key);g&&(u.preventDefault(),v(g.mode,g.delta))}return xe(()=>{window.addEventListener("keydown",m)}),Ue(()=>{window.removeEventListener("keydown",m)}),{onSearchKeydown:h,clearLrStack:r}}function mo(e,o){const t=B(0),n=C(()=>{const p=e.value.trim().toLowerCase();return p?o.value.filter(v=>v.label.toLowerCase().includes(p)||v.title.toLowerCase().includes(p)).map(v=>({title:v.title,label:v.label})).sort((v,h)=>v.label.localeCompare(h.label,void 0,{sensitivity:"base"})):[]}),l=C(()=>n.value[t.value]??null),r=C(()=>n.value.length>0);H(e,()=>{t.value=0}),H(n,p=>{if(p.length===0){t.value=0;return}t.value>=p.length&&(t.value=0)});function a(p){if(n.value.length===0){t.value=0;return}const v=Math.max(0,Math.min(p,n.value.length-1));t.value=v}function k(){n.value.length!==0&&a(t.value<=0?n.value.length-1:t.value-1)}function i(){n.value.length!==0&&a(t.value>=n.value.length-1?0:t.value+1)}return{matches:n,activeIndex:t,activeMatch:l,hasMatches:r,setActiveIndex:a,goPrev:k,goNext:i}}function Xe(e){const o=new Set;for(const t of e)o.add(t.sourcename),o.add(t.targetname);return o}function yo(e,o){const t=Xe(o),n=e.filter(a=>t.has(a.title)),l=new Set(n.map(a=>a.title)),r=o.filter(a=>l.has(a.sourcename)&&l.has(a.targetname));return{nodes:n,edges:r}}function Ce(e,o){return!Xe(o).has(e)}function bo(e){const o=e.replace(/\\/g,"/"),t=o.lastIndexOf("/");return t>=0?o.slice(t+1):o}function wo(e,o){const t=e.findIndex(n=>bo(n.title).localeCompare(o,void 0,{sensitivity:"base"})===0);return t>=0?t:null}const ko="main.c";function ve(e){return e.replace(/\\/g,"/")}function Je(e,o,t){return`${ve(e)}:${o}:${t}`}function Co(e){return/[A-Za-z_]/.test(e)}function xo(e,o){if(o!==1||!Co(e[0]))return!1;if(o+1>=e.length)return!0;const t=e[o+1];return t==="\\"||t==="/"}function _o(e,o){for(let t=o-1;t>=0;t--)if(e[t]===":"&&!xo(e,t))return t;return-1}function To(e){for(let o=e.length-3;o>=0;o--)if(e[o]==="."&&e[o+1]==="o"&&e[o+2]===":")return o+2;return-1}function No(e){const o=To(e);if(o>=0)return e.slice(o+1);const t=_o(e,e.length);return t>0?e.slice(t+1):e}function So(e){const o=new Map,t=new Map;for(const n of e){o.set(Je(n.location.file,n.location.line,n.location.column),n);const l=t.get(n.functionName)??[];l.push(n),t.set(n.functionName,l)}return{byLocation:o,byFunctionName:t}}function Re(e){return{stackBytes:e.stackBytes,allocationType:e.allocationType}}function $o(e,o){var k;if(((k=o.location)==null?void 0:k.line)===void 0)return e[0]??null;const t=ve(o.location.file),n=o.location.line,l=o.location.column??0,r=e.find(i=>ve(i.location.file)===t&&i.location.line===n&&i.location.column===l);return r||(e.find(i=>ve(i.location.file)===t&&i.location.line===n)??e[0]??null)}function Io(e,o){var n;if(((n=e.location)==null?void 0:n.line)!==void 0){const l=e.location.column??0,r=o.byLocation.get(Je(e.location.file,e.location.line,l));if(r)return Re(r)}const t=new Set;e.label&&t.add(e.label),t.add(No(e.title));for(const l of t){const r=o.byFunctionName.get(l);if(!(r!=null&&r.length))continue;const a=$o(r,e);if(a)return Re(a)}return null}function Eo(e,o){const t=new Set(e.nodes.map(i=>i.title)),n=new Map;for(const i of e.nodes){const p=Io(i,o);n.set(i.title,(p==null?void 0:p.stackBytes)??0)}const l=new Map;for(const i of e.edges){if(!t.has(i.sourcename)||!t.has(i.targetname))continue;const p=l.get(i.sourcename)??[];p.push(i.targetname),l.set(i.sourcename,p)}const r=new Map;function a(i,p){const v=r.get(i);if(v!==void 0)return v;if(p.has(i))return n.get(i)??0;p.add(i);const h=n.get(i)??0;let m=0;for(const g of l.get(i)??[])m=Math.max(m,a(g,p));p.delete(i);const u=h+m;return r.set(i,u),u}const k=new Map;for(const i of e.nodes)k.set(i.title,a(i.title,new Set));return k}const Bo={key:0,class:"page-view empty-center"},Ao={key:1,class:"page-view callgraph-page"},Lo={class:"page-toolbar callgraph-toolbar"},Mo={class:"toolbar-start"},Do=["title"],Vo={class:"search-block"},Po={class:"search-row"},Fo=["disabled"],Ho=["disabled"],Ro=["disabled"],Uo={key:0,class:"search-counter"},zo={key:0,class:"search-results-dropdown"},Oo=["title","onClick"],Go={class:"toolbar-end"},Ko={key:0,class:"empty-center"},Wo={key:1,class:"callgraph-flow-wrap"},qo={class:"node-detail"},jo={class:"max-stack-badge",tabindex:"0"},Zo="Max Stack Usage = 本函数局部栈（GCC -fstack-usage）+ 被调用函数中最大的 Max Stack Usage。仅沿当前调用图向下累计，不含调用方栈帧；多个被调函数取子链最大值（非相加）。",Xo=ne({__name:"CallgraphView",props:{paneVisible:{type:Boolean}},setup(e){const o=e,{hasCallgraph:t,hasStackUsage:n,callgraphGraphs:l,mergedCallgraphGraph:r,allStackEntries:a}=_e(),k=C(()=>So(a.value)),{selectedIndex:i,searchText:p,layoutDirection:v,hideOrphanNodes:h,selectedNodeId:m,selectedEdge:u,selectedEdgeFlowId:g}=pe;H(l,s=>{if(s.length!==0){if(!Fe.value){Fe.value=!0;const w=wo(s,ko);i.value=w??te}i.value!==te&&i.value>=s.length&&(i.value=te)}},{immediate:!0}),H([i,v,h],()=>{m.value=null,u.value=null,g.value=null});const S=C(()=>{var O;const s=`Merged (${((O=r.value)==null?void 0:O.nodes.length)??0})`,w=l.value.map(M=>{const le=`${M.title} (${M.nodes.length})`;return{label:le,value:M.index,fullLabel:le}}).sort((M,le)=>M.fullLabel.localeCompare(le.fullLabel,void 0,{sensitivity:"base"}));return[{label:s,value:te,fullLabel:s},...w]}),L=C(()=>{const s=S.value.find(w=>w.value===i.value);return(s==null?void 0:s.fullLabel)??""});function F(s){const w=s,O=w.fullLabel??(typeof w.label=="string"?w.label:"");return O?{title:O}:{}}const V=C(()=>i.value===te?r.value:l.value[i.value]??null),q=C(()=>{const s=V.value;if(!s||!h.value)return s;const{nodes:w,edges:O}=yo(s.nodes,s.edges);return{...s,nodes:w,edges:O,isEmpty:w.length===0}});H([q,t],([s,w])=>{if(!w||!s){pe.graphStats.value=null;return}pe.graphStats.value={nodes:s.nodes.length,edges:s.edges.length}},{immediate:!0});const Z=C(()=>{var w;const s=i.value===te?"__merged__":((w=V.value)==null?void 0:w.title)??String(i.value);return h.value?`${s}::no-orphan`:s}),X=C(()=>{const s=q.value;return s?{graph:{title:s.title},nodes:s.nodes,edges:s.edges}:null}),_=C(()=>{var s;return((s=q.value)==null?void 0:s.nodes)??[]});H([h,V],()=>{const s=V.value;if(!(!s||!h.value)&&(m.value&&Ce(m.value,s.edges)&&(m.value=null),u.value)){const{sourcename:w,targetname:O}=u.value;(Ce(w,s.edges)||Ce(O,s.edges))&&(u.value=null,g.value=null)}});const{matches:T,activeIndex:c,activeMatch:d,hasMatches:b,setActiveIndex:$,goPrev:E,goNext:U}=mo(p,_),z=B(null),J=C(()=>p.value.trim()&&d.value?d.value.title:z.value);H(d,s=>{s&&(m.value=s.title,u.value=null,g.value=null,z.value=s.title)}),H(c,()=>{ue(()=>{var s;(s=document.querySelector(".search-results-item.active"))==null||s.scrollIntoView({block:"nearest"})})});function W(s){$(s)}const G=C(()=>!m.value||!X.value?null:X.value.nodes.find(s=>s.title===m.value)??null),Ne=C(()=>{const s=X.value;return!s||!n.value?new Map:Eo(s,k.value)}),Se=C(()=>{const s=G.value;if(!s||!n.value)return null;const w=Ne.value.get(s.title);return w===void 0?null:w});function $e(s){var O;const w=(O=X.value)==null?void 0:O.nodes.find(M=>M.title===s);return(w==null?void 0:w.label)??s}const Ye=C(()=>u.value?$e(u.value.sourcename):""),Qe=C(()=>u.value?$e(u.value.targetname):""),Ie=C(()=>{var s;return Lt((s=u.value)==null?void 0:s.label)});function Ee(s){m.value=s,u.value=null,g.value=null,p.value.trim()||(z.value=null)}function et(s){u.value=(s==null?void 0:s.edge)??null,g.value=(s==null?void 0:s.flowId)??null,m.value=null}const tt=C(()=>{var s;return((s=X.value)==null?void 0:s.edges)??[]}),ot=C(()=>o.paneVisible??!0),{onSearchKeydown:Be,clearLrStack:nt}=ho({paneVisible:ot,searchText:p,hasSearchMatches:b,goSearchPrev:E,goSearchNext:U,selectedNodeId:m,graphEdges:tt,graphNodes:_,onSelectNode(s){Ee(s)},onPanToNode(s){z.value=s}});function lt(s){nt(),Ee(s)}const at=[{label:"Top → Bottom",value:"TB"},{label:"Left → Right",value:"LR"}];function st(){p.value=""}function rt(s){var w;(w=s.location)!=null&&w.file&&ae.gotoDefinition({file:s.location.file,line:s.location.line,column:s.location.column})}function it(){const s=G.value;s&&rt(s)}function ct(){const s=Ie.value;s!=null&&s.file&&ae.gotoDefinition({file:s.file,line:s.line,column:s.column})}return(s,w)=>{var O;return f(t)?(x(),I("div",Ao,[y("div",Lo,[y("div",Mo,[y("div",{class:"graph-select-wrap",title:L.value},[D(f(Me),{value:f(i),"onUpdate:value":w[0]||(w[0]=M=>fe(i)?i.value=M:null),class:"graph-select",options:S.value,"node-props":F,"consistent-menu-width":!1,size:"small"},null,8,["value","options"])],8,Do),y("div",Vo,[y("div",Po,[he(y("input",{"onUpdate:modelValue":w[1]||(w[1]=M=>fe(p)?p.value=M:null),class:"search-input",type:"text",placeholder:"Search function ...",onKeydown:w[2]||(w[2]=(...M)=>f(Be)&&f(Be)(...M))},null,544),[[Oe,f(p)]]),y("button",{disabled:!f(p),type:"button",class:"btn-outline btn-outline--icon search-clear-btn",title:"Clear search","aria-label":"Clear search",onClick:st}," × ",8,Fo),y("button",{type:"button",class:"btn-outline btn-outline--icon",disabled:!f(b),title:"Previous match",onClick:w[3]||(w[3]=(...M)=>f(E)&&f(E)(...M))}," ‹ ",8,Ho),y("button",{type:"button",class:"btn-outline btn-outline--icon",disabled:!f(b),title:"Next match",onClick:w[4]||(w[4]=(...M)=>f(U)&&f(U)(...M))}," › ",8,Ro),f(b)?(x(),I("span",Uo,N(f(c)+1)+" / "+N(f(T).length),1)):K("",!0)]),f(b)?(x(),I("ul",zo,[(x(!0),I(ie,null,Ge(f(T),(M,le)=>(x(),I("li",{key:M.title,class:Q(["search-results-item",{active:le===f(c)}]),title:M.label,onClick:Dn=>W(le)},N(M.label),11,Oo))),128))])):K("",!0)])]),y("div",Go,[D(f(yt),{checked:f(h),"onUpdate:checked":w[5]||(w[5]=M=>fe(h)?h.value=M:null),size:"large"},{default:P(()=>[...w[8]||(w[8]=[R(" Hide Orphan Nodes ",-1)])]),_:1},8,["checked"]),D(f(Me),{value:f(v),"onUpdate:value":w[6]||(w[6]=M=>fe(v)?v.value=M:null),class:"layout-select",options:at,size:"small"},null,8,["value"])])]),(O=q.value)!=null&&O.isEmpty?(x(),I("div",Ko,[D(f(ge),{description:"No callgraph data"})])):(x(),I("div",Wo,[D(co,{graph:X.value,"graph-key":Z.value,"search-text":f(p),"layout-direction":f(v),"selected-node-title":f(m),"selected-edge-id":f(g),"focus-node-title":J.value,"pane-visible":o.paneVisible??!0,onNodeSelect:lt,onEdgeSelect:et},null,8,["graph","graph-key","search-text","layout-direction","selected-node-title","selected-edge-id","focus-node-title","pane-visible"])])),y("div",qo,[f(u)?(x(),I(ie,{key:0},[D(f(De),{align:"center"},{default:P(()=>[D(f(ee),{strong:""},{default:P(()=>[R(N(Ye.value)+" → "+N(Qe.value),1)]),_:1}),Ie.value?(x(),I("button",{key:0,type:"button",class:"btn-outline btn-outline--tiny",onClick:ct}," Go To Definition ")):K("",!0)]),_:1}),f(u).label?(x(),Y(f(ee),{key:0,depth:"3",style:{"font-size":"11px"}},{default:P(()=>[R(N(f(u).label),1)]),_:1})):(x(),Y(f(ee),{key:1,depth:"3",style:{"font-size":"11px"}},{default:P(()=>[R(N(f(u).sourcename)+" → "+N(f(u).targetname),1)]),_:1}))],64)):G.value?(x(),I(ie,{key:1},[D(f(De),{align:"center",wrap:!1},{default:P(()=>[D(f(ee),{strong:""},{default:P(()=>[R(N(G.value.label),1)]),_:1}),Se.value!==null?(x(),Y(f(bt),{key:0,trigger:"hover",style:{maxWidth:"360px"}},{trigger:P(()=>[y("span",jo," Max Stack Usage: "+N(Se.value)+" B ",1)]),default:P(()=>[R(" "+N(Zo))]),_:1})):K("",!0),y("button",{type:"button",class:"btn-outline btn-outline--tiny",onClick:it}," Go To Definition ")]),_:1}),G.value.location?(x(),Y(f(ee),{key:0,depth:"3",style:{"font-size":"12px",padding:"4px 0px"}},{default:P(()=>[R(N(G.value.location.file)+" ",1),G.value.location.line!==void 0?(x(),I(ie,{key:0},[R(" :"+N(G.value.location.line)+":"+N(G.value.location.column),1)],64)):K("",!0)]),_:1})):K("",!0)],64)):(x(),Y(f(ee),{key:2,depth:"3",class:"node-detail-empty"},{default:P(()=>[...w[9]||(w[9]=[R("No data",-1)])]),_:1}))])])):(x(),I("div",Bo,[D(f(ge),{description:"No callgraph data"},{extra:P(()=>[D(f(ee),{depth:"3",style:{"font-size":"12px"}},{default:P(()=>[...w[7]||(w[7]=[R(" Please enable -fcallgraph-info in the build options and rebuild the project. ",-1)])]),_:1})]),_:1})]))}}}),Jo=de(Xo,[["__scopeId","data-v-2a356fdb"]]),Yo={class:"page-toolbar",style:{padding:"8px 10px"}},Qo={class:"badge"},en={key:0,class:"stack-table"},tn={class:"sort-indicator"},on={class:"sort-indicator"},nn={class:"sort-indicator"},ln={class:"sort-indicator"},an={class:"sort-indicator"},sn=["onContextmenu"],rn=["title"],cn=["title"],un=["title"],dn=["title"],fn={key:1,class:"empty-center"},pn={class:"table-footer"},vn={class:"muted"},gn=ne({__name:"StackUsageTable",props:{rows:{},showSourceColumn:{type:Boolean},scrollKey:{},paneVisible:{type:Boolean}},setup(e,{expose:o}){const t=e,n=B(null);function l(){return t.scrollKey??"default"}function r(){n.value&&ke.set(l(),n.value.scrollTop)}function a(){ue(()=>{n.value&&(n.value.scrollTop=ke.get(l())??0)})}function k(){r()}H(()=>t.scrollKey,(c,d)=>{var b;d!==void 0&&ke.set(String(d),((b=n.value)==null?void 0:b.scrollTop)??0),a()}),H(()=>t.paneVisible,(c,d)=>{d&&!c?r():c&&!d&&a()});const i=B(""),p=B("stackBytes"),v=B("desc"),h=B(null),m=B({show:!1,x:0,y:0,row:null}),u=C(()=>t.rows.reduce((c,d)=>Math.max(c,d.stackBytes),0)),g=C(()=>{const c=i.value.trim().toLowerCase();return c?t.rows.filter(d=>d.functionName.toLowerCase().includes(c)||d.locationText.toLowerCase().includes(c)||d.allocationType.toLowerCase().includes(c)||d.sourceDoc.toLowerCase().includes(c)):t.rows}),S=C(()=>{const c=[...g.value],d=v.value==="asc"?1:-1;return c.sort((b,$)=>{let E,U;switch(p.value){case"stackBytes":E=b.stackBytes,U=$.stackBytes;break;case"functionName":return b.functionName.localeCompare($.functionName)*d;case"locationText":return b.locationText.localeCompare($.locationText)*d;case"allocationType":return b.allocationType.localeCompare($.allocationType)*d;case"sourceDoc":return b.sourceDoc.localeCompare($.sourceDoc)*d;default:return 0}return E===U?0:E>U?d:-d}),c}),L=C(()=>t.rows.reduce((c,d)=>c+d.stackBytes,0));function F(c){p.value===c?v.value=v.value==="asc"?"desc":"asc":(p.value=c,v.value=c==="stackBytes"?"desc":"asc")}function V(c){return p.value!==c?"↕":v.value==="asc"?"↑":"↓"}function q(c,d,b){c.preventDefault(),h.value=b,m.value={show:!0,x:c.clientX,y:c.clientY,row:d}}function Z(){m.value.show=!1}function X(){const c=m.value.row;c&&ae.gotoDefinition({file:c.file,line:c.line,column:c.column}),Z()}const _=[{label:"Go To Definition",key:"goto"}];function T(c){c==="goto"&&X()}return o({filterText:i}),(c,d)=>(x(),I("div",{class:"table-wrapper",onClick:Z},[y("div",Yo,[he(y("input",{"onUpdate:modelValue":d[0]||(d[0]=b=>i.value=b),class:"search-input",type:"text",placeholder:"Filter by function, file, type ..."},null,512),[[Oe,i.value]]),y("span",Qo,N(g.value.length)+" functions",1)]),y("div",{ref_key:"scrollEl",ref:n,class:"table-scroll",onScroll:k},[S.value.length>0?(x(),I("table",en,[y("thead",null,[y("tr",null,[y("th",{class:Q(["sortable",{sorted:p.value==="stackBytes"}]),onClick:d[1]||(d[1]=b=>F("stackBytes"))},[d[6]||(d[6]=R(" Stack ",-1)),y("span",tn,N(V("stackBytes")),1)],2),y("th",{class:Q(["sortable",{sorted:p.value==="functionName"}]),onClick:d[2]||(d[2]=b=>F("functionName"))},[d[7]||(d[7]=R(" Function ",-1)),y("span",on,N(V("functionName")),1)],2),y("th",{class:Q(["sortable",{sorted:p.value==="locationText"}]),onClick:d[3]||(d[3]=b=>F("locationText"))},[d[8]||(d[8]=R(" Location ",-1)),y("span",nn,N(V("locationText")),1)],2),y("th",{class:Q(["sortable",{sorted:p.value==="allocationType"}]),onClick:d[4]||(d[4]=b=>F("allocationType"))},[d[9]||(d[9]=R(" Type ",-1)),y("span",ln,N(V("allocationType")),1)],2),e.showSourceColumn?(x(),I("th",{key:0,class:Q(["sortable",{sorted:p.value==="sourceDoc"}]),onClick:d[5]||(d[5]=b=>F("sourceDoc"))},[d[10]||(d[10]=R(" Source ",-1)),y("span",an,N(V("sourceDoc")),1)],2)):K("",!0)])]),y("tbody",null,[(x(!0),I(ie,null,Ge(S.value,(b,$)=>(x(),I("tr",{key:`${b.functionName}-${b.locationText}-${$}`,class:Q({selected:h.value===$}),onContextmenu:E=>q(E,b,$)},[y("td",{class:"col-stack",style:Ct({"--size-fill":u.value>0?b.stackBytes/u.value:0})},[y("span",null,N(b.stackBytes)+" B",1)],4),y("td",{class:"col-fn",title:b.functionName},N(b.functionName),9,rn),y("td",{class:"col-loc",title:b.locationText},N(b.locationText),9,cn),y("td",{class:"col-type",title:b.allocationType},N(b.allocationType),9,un),e.showSourceColumn?(x(),I("td",{key:0,class:"col-src",title:b.sourceDoc},N(b.sourceDoc),9,dn)):K("",!0)],42,sn))),128))])])):(x(),I("div",fn,[wt(c.$slots,"empty",{},()=>[d[11]||(d[11]=R("No matched results",-1))],!0)]))],544),y("div",pn,[y("span",null,"Max stack: "+N(u.value)+" B · Total: "+N(L.value)+" B",1),y("span",vn,"Sort: "+N(p.value)+" ("+N(v.value)+'), Filter: "'+N(i.value.trim())+'"',1)]),D(f(kt),{show:m.value.show,x:m.value.x,y:m.value.y,options:_,placement:"bottom-start",onSelect:T,onClickoutside:Z},null,8,["show","x","y"])]))}}),hn=de(gn,[["__scopeId","data-v-05f422d2"]]),mn={key:0,class:"empty-center"},yn={key:1,class:"stackusage-page"},bn={class:"stackusage-content"},wn={key:0,class:"empty-center"},kn=ne({__name:"StackUsageView",props:{paneVisible:{type:Boolean}},setup(e){const o=e,{hasStackUsage:t,allStackRows:n}=_e(),l=C(()=>n.value.length===0);return(r,a)=>f(t)?(x(),I("div",yn,[y("div",bn,[l.value?(x(),I("div",wn,[D(f(ge),{description:"No stack usage data"})])):(x(),Y(hn,{key:1,class:"stackusage-table-host",rows:f(n),"show-source-column":!0,"scroll-key":"merged","pane-visible":o.paneVisible??!0},null,8,["rows","pane-visible"]))])])):(x(),I("div",mn,[D(f(ge),{description:"No stack usage data"},{extra:P(()=>[D(f(ee),{depth:"3",style:{"font-size":"12px"}},{default:P(()=>[...a[0]||(a[0]=[R(" Please enable -fstack-usage in the build options and rebuild the project. ",-1)])]),_:1})]),_:1})]))}}),Cn={class:"app-sider"},xn=["title"],_n={class:"app-main"},Tn={class:"page-header"},Nn={class:"page-title"},Sn={key:0,class:"badge page-header-stats"},$n={class:"app-body"},In={key:1,class:"app-pages"},En={key:1,class:"app-pages-overlay",role:"status","aria-live":"polite","aria-label":"Loading"},Bn=ne({__name:"App",setup(e){const{theme:o,overrides:t}=Ot(),{loading:n,loadError:l}=_e(),r=B("callgraph"),a=B(!0),k=[{label:"Callgraph",key:"callgraph",icon:()=>j(Pe,null,{default:()=>j(St)})},{label:"Stack Usage",key:"stackusage",icon:()=>j(Pe,null,{default:()=>j($t)})}],i=C(()=>r.value==="callgraph"?"Callgraph":"Stack Usage"),p=C(()=>pe.graphStats.value);return(v,h)=>(x(),Y(f(Tt),{theme:f(o),"theme-overrides":f(t),"inline-theme-disabled":"","preflight-style-disabled":""},{default:P(()=>[y("div",{class:Q(["app-root",{"app-root--sider-collapsed":a.value}])},[y("aside",Cn,[D(f(xt),{value:r.value,"onUpdate:value":h[0]||(h[0]=m=>r.value=m),collapsed:a.value,"collapsed-width":48,options:k},null,8,["value","collapsed"]),y("button",{type:"button",class:"sider-toggle",title:a.value?"Expand":"Collapse",onClick:h[1]||(h[1]=m=>a.value=!a.value)},N(a.value?"»":"«"),9,xn)]),y("div",_n,[y("header",Tn,[y("span",Nn,N(i.value),1),r.value==="callgraph"&&p.value?(x(),I("span",Sn,N(p.value.nodes)+" nodes · "+N(p.value.edges)+" edges ",1)):K("",!0)]),y("main",$n,[f(l)?(x(),Y(f(_t),{key:0,status:"error",title:"Cannot load data",description:f(l).message},null,8,["description"])):(x(),I("div",In,[f(n)?K("",!0):(x(),I(ie,{key:0},[he(D(Jo,{class:"app-page","pane-visible":r.value==="callgraph"},null,8,["pane-visible"]),[[Ve,r.value==="callgraph"]]),he(D(kn,{class:"app-page","pane-visible":r.value==="stackusage"},null,8,["pane-visible"]),[[Ve,r.value==="stackusage"]])],64)),f(n)?(x(),I("div",En,[...h[2]||(h[2]=[y("div",{class:"app-loading-spinner"},null,-1),y("span",{class:"app-loading-text"},"Loading…",-1)])])):K("",!0)]))])])],2)]),_:1},8,["theme","theme-overrides"]))}}),An=de(Bn,[["__scopeId","data-v-7bf98dfb"]]);async function Ln(){if(!(se()||We()))try{console.warn("[Callgraph View] No local test data")}catch(e){console.warn("[Callgraph View] Failed to load local test data:",e)}}async function Mn(){try{await Ln()}catch(o){console.warn("[Callgraph View] Failed to load fallback data:",o)}Nt(An).mount("#app");try{await Rt()}catch(o){console.error("[Callgraph View] Failed to init:",o)}}Mn();
+import{y as j,J as B,O as ut,n as C,G as xe,H as Ue,w as dt,x as ne,S as ze,I as x,q as Y,R as f,_ as ft,W as P,u as D,C as pt,s as I,p as y,V as H,B as ue,M as vt,v as Ae,P as re,D as Q,m as Le,Q as N,r as K,A as gt,l as ht,k as mt,i as ee,t as R,c as ge,z as fe,g as Me,X as he,T as Oe,F as ie,K as Ge,N as yt,h as De,j as bt,L as wt,b as kt,E as Ct,e as xt,f as _t,U as Ve,a as Tt,d as Pe,o as Nt}from"./chunk-vendors.js";(function(){const o=document.createElement("link").relList;if(o&&o.supports&&o.supports("modulepreload"))return;for(const l of document.querySelectorAll('link[rel="modulepreload"]'))n(l);new MutationObserver(l=>{for(const r of l)if(r.type==="childList")for(const a of r.addedNodes)a.tagName==="LINK"&&a.rel==="modulepreload"&&n(a)}).observe(document,{childList:!0,subtree:!0});function t(l){const r={};return l.integrity&&(r.integrity=l.integrity),l.referrerPolicy&&(r.referrerPolicy=l.referrerPolicy),l.crossOrigin==="use-credentials"?r.credentials="include":l.crossOrigin==="anonymous"?r.credentials="omit":r.credentials="same-origin",r}function n(l){if(l.ep)return;l.ep=!0;const r=t(l);fetch(l.href,r)}})();const St={render(){return j("svg",{xmlns:"http://www.w3.org/2000/svg",viewBox:"0 0 24 24",width:"1em",height:"1em",fill:"currentColor"},[j("circle",{cx:5,cy:6,r:2}),j("circle",{cx:19,cy:6,r:2}),j("circle",{cx:12,cy:18,r:2}),j("path",{d:"M7 7l4 9m6-9l-4 9",stroke:"currentColor",fill:"none","stroke-width":1.5})])}},$t={render(){return j("svg",{xmlns:"http://www.w3.org/2000/svg",viewBox:"0 0 24 24",width:"1em",height:"1em",fill:"currentColor"},[j("path",{d:"M4 5h16v2H4V5zm0 4h16v2H4V9zm0 4h10v2H4v-2zm0 4h10v2H4v-2z"})])}},be={launched:"eide.callgraph_view.launched",init:"eide.callgraph_view.init",gotoDefinition:"callgraph.gotoDefinition",showDisassembly:"callgraph.showDisassembly"};class ce extends Error{constructor(o,t){super(t),this.code=o,this.name="HostBridgeError"}}const It=2e3;function Ke(e){if(typeof e!="object"||e===null)return!1;const o=e;return Array.isArray(o.callgraph)&&Array.isArray(o.stackusage)}function Et(e){return e==null||e==="$BUILD_REPORT"||typeof e=="string"&&e==="$BUILD_REPORT"}function se(){const e=window.__CALLGRAPH_VIEW_INIT__;if(!(Et(e)||!Ke(e)))return e}function We(){try{return typeof window.acquireVsCodeApi=="function"}catch{return!1}}function Bt(){var e;if(We())try{return(e=window.acquireVsCodeApi)==null?void 0:e.call(window)}catch{return}}function At(){const e=Bt(),o=e!==void 0;let t,n,l;const r=new Set;return o&&e&&window.addEventListener("message",a=>{const k=a.data;if(!k||typeof k!="object")return;const i=k;if((i.type??i.id)===be.init){const v=i.data??k.data;if(!Ke(v))return;t=v,r.forEach(h=>h(t)),n==null||n(),n=void 0,l=void 0}}),{inWebview:o,get hasInlineInit(){return se()!==void 0},ready(){return o&&e?se()?Promise.resolve():new Promise((a,k)=>{if(t){a();return}n=a,l=k,e.postMessage({id:be.launched}),setTimeout(()=>{n&&(l==null||l(new ce("WEBVIEW_INIT_TIMEOUT","WEBVIEW INIT TIMEOUT")),n=void 0,l=void 0)},It)}):se()?Promise.resolve():Promise.reject(new ce("NO_INLINE_DATA","NO INLINE DATA"))},loadReport(){if(o){if(t)return Promise.resolve(t);const k=se();return k?Promise.resolve(k):Promise.reject(new ce("INVALID_INIT","No data received from vscode webview"))}const a=se();return a?Promise.resolve(a):Promise.reject(new ce("NO_INLINE_DATA","NO INLINE DATA"))},gotoDefinition(a){var i;if(o&&e){e.postMessage({id:be.gotoDefinition,data:a});return}const k=a.line!==void 0?`${a.file}:${a.line}`:a.file;(i=navigator.clipboard)!=null&&i.writeText?navigator.clipboard.writeText(k):console.info("[Callgraph View] Go to:",k)},showDisassembly(a){if(o&&e){e.postMessage({id:be.showDisassembly,data:{symbol:a}});return}console.info("[Callgraph View] Disassemble:",a)},onReportUpdated(a){return r.add(a),()=>r.delete(a)}}}const ae=At();function Lt(e){if(!(e!=null&&e.trim()))return;const o=e.trim().match(/^(.+):(\d+):(\d+)$/);if(o)return{file:o[1],line:Number(o[2]),column:Number(o[3])}}function Mt(e,o,t){return`e-${e}-${o}-${t}`}function Dt(e){return JSON.stringify({sourcename:e.sourcename,targetname:e.targetname,label:e.label??""})}function Vt(e){const o=new Map,t=new Set,n=[];for(const l of e){for(const r of l.nodes)o.has(r.title)||o.set(r.title,r);for(const r of l.edges){const a=Dt(r);t.has(a)||(t.add(a),n.push(r))}}return{nodes:Array.from(o.values()),edges:n}}const te=-1;function Pt(e){return Array.isArray(e)?e.map(o=>{const t=o;return{graph:t.graph??{title:""},nodes:Array.isArray(t.nodes)?t.nodes:[],edges:Array.isArray(t.edges)?t.edges:[],warnings:t.warnings}}):[]}function Ft(e){return Array.isArray(e)?e.map(o=>{const t=o;return{entries:Array.isArray(t.entries)?t.entries:[],warnings:t.warnings}}):[]}function Ht(e,o,t){return o!==void 0&&t!==void 0?`${e}:${o}:${t}`:o!==void 0?`${e}:${o}`:e}const oe=ut(null),me=B(null),ye=B(!0);async function Rt(){ye.value=!0,me.value=null;try{await ae.ready(),oe.value=await ae.loadReport(),ae.onReportUpdated(e=>{oe.value=e})}catch(e){oe.value=null,me.value=e instanceof ce?e:new ce("INVALID_INIT",String(e))}finally{ye.value=!1}}function _e(){const e=C(()=>oe.value?Pt(oe.value.callgraph):[]),o=C(()=>oe.value?Ft(oe.value.stackusage):[]),t=C(()=>e.value.length>0),n=C(()=>o.value.length>0),l=C(()=>e.value.map((v,h)=>{var m;return{index:h,title:((m=v.graph)==null?void 0:m.title)||`Graph ${h+1}`,nodes:v.nodes,edges:v.edges,isEmpty:v.nodes.length===0}})),r=C(()=>{const v=l.value;if(v.length===0)return null;const{nodes:h,edges:m}=Vt(v);return{index:te,title:"Merged",nodes:h,edges:m,isEmpty:h.length===0}}),a=C(()=>o.value.map((v,h)=>({index:h,title:`Document ${h+1}`,entries:v.entries,isEmpty:v.entries.length===0}))),k=C(()=>o.value.flatMap(v=>v.entries)),i=C(()=>{const v=[];return a.value.forEach(h=>{h.entries.forEach(m=>{v.push({functionName:m.functionName,stackBytes:m.stackBytes,allocationType:m.allocationType,locationText:Ht(m.location.file,m.location.line,m.location.column),file:m.location.file,line:m.location.line,column:m.location.column,sourceDoc:h.title})})}),v}),p=C(()=>!ye.value&&!me.value&&!t.value&&!n.value);return{loading:ye,loadError:me,report:oe,callgraph:e,stackusage:o,hasCallgraph:t,hasStackUsage:n,callgraphGraphs:l,mergedCallgraphGraph:r,stackDocuments:a,allStackRows:i,allStackEntries:k,isFullyEmpty:p,hostBridge:ae}}const pe={selectedIndex:B(te),searchText:B(""),layoutDirection:B("LR"),hideOrphanNodes:B(!0),selectedNodeId:B(null),selectedEdge:B(null),selectedEdgeFlowId:B(null),graphStats:B(null)},Fe=B(!1),we=new Map,ke=new Map;function A(e,o){return getComputedStyle(document.body).getPropertyValue(e).trim()||o}function Ut(e){const o=e.trim();if(o.startsWith("#")&&o.length>=7){const t=parseInt(o.slice(1,3),16),n=parseInt(o.slice(3,5),16),l=parseInt(o.slice(5,7),16);return(t*299+n*587+l*114)/1e3<128}return!0}function zt(){const e=A("--vscode-editor-background","#1e1e1e"),o=A("--vscode-editor-foreground","#d4d4d4"),t=A("--vscode-editorWidget-background","#252526"),n=A("--vscode-editorWidget-border","#3c3c3c"),l=A("--vscode-list-hoverBackground","#2a2d2e"),r=A("--vscode-list-activeSelectionBackground","#094771"),a=A("--vscode-list-activeSelectionForeground","#ffffff"),k=A("--vscode-button-background","#0e639c"),i=A("--vscode-button-hoverBackground","#1177bb"),p=A("--vscode-input-background","#3c3c3c"),v=A("--vscode-input-foreground","#f0f0f0"),h=A("--vscode-input-placeholderForeground","#cccccc80"),m=A("--vscode-sideBar-background","#252526"),u=A("--vscode-settings-checkboxBackground",p),g=A("--vscode-settings-checkboxForeground",o),S=A("--vscode-settings-checkboxBorder",n);return{common:{bodyColor:e,cardColor:t,modalColor:t,popoverColor:t,textColorBase:o,textColor1:o,textColor2:o,textColor3:A("--vscode-descriptionForeground","#ccccccb3"),borderColor:n,dividerColor:n,hoverColor:l,primaryColor:k,primaryColorHover:i,primaryColorPressed:i,inputColor:p,inputColorDisabled:p,placeholderColor:h,iconColor:A("--vscode-icon-foreground","#cccccc"),iconColorHover:o,iconColorPressed:o,iconColorDisabled:h},Layout:{color:e,siderColor:m,headerColor:t},Menu:{color:m,itemColor:"transparent",itemColorActive:r,itemColorActiveHover:r,itemColorHover:l,itemTextColor:o,itemTextColorActive:a,itemTextColorHover:o,itemTextColorChildActive:a,itemIconColor:o,itemIconColorActive:a,itemIconColorHover:o},Select:{peers:{InternalSelection:{textColor:v,color:p,colorActive:p,border:`1px solid ${n}`,borderActive:`1px solid ${A("--vscode-focusBorder","#007acc")}`,borderHover:`1px solid ${n}`,borderFocus:`1px solid ${A("--vscode-focusBorder","#007acc")}`,boxShadowFocus:`0 0 0 1px ${A("--vscode-focusBorder","#007acc")}`,arrowColor:o},InternalSelectMenu:{color:t,optionTextColor:o,optionTextColorActive:a,optionColorPending:l,optionColorActive:r,optionColorActivePending:r}}},Input:{color:p,colorFocus:p,textColor:v,border:`1px solid ${n}`,borderHover:`1px solid ${n}`,borderFocus:`1px solid ${A("--vscode-focusBorder","#007acc")}`,boxShadowFocus:`0 0 0 1px ${A("--vscode-focusBorder","#007acc")}`,placeholderColor:h},Button:{textColor:A("--vscode-button-foreground","#ffffff"),color:k,colorHover:i,colorPressed:i,colorFocus:i,border:`1px solid ${n}`,borderHover:`1px solid ${n}`,borderPressed:`1px solid ${n}`,borderFocus:`1px solid ${A("--vscode-focusBorder","#007acc")}`},Dropdown:{color:t,optionTextColor:o,optionTextColorHover:o,optionTextColorActive:a,optionColorHover:l,optionColorActive:r},Empty:{textColor:o,iconColor:A("--vscode-icon-foreground","#cccccc"),extraTextColor:A("--vscode-descriptionForeground","#ccccccb3")},Scrollbar:{color:A("--vscode-scrollbarSlider-background","rgba(121, 121, 121, 0.4)"),colorHover:A("--vscode-scrollbarSlider-hoverBackground","rgba(100, 100, 100, 0.7)")},Spin:{color:k,textColor:o},Result:{textColor:o,titleTextColor:o},Tooltip:{color:t,textColor:o},Checkbox:{color:u,colorChecked:u,checkMarkColor:g,border:`1px solid ${S}`,borderChecked:`1px solid ${S}`,borderFocus:`1px solid ${S}`}}}function Ot(){const e=B(!0),o=B({}),t=()=>{const r=A("--vscode-editor-background","#1e1e1e");e.value=Ut(r),o.value=zt()};let n;return xe(()=>{t(),requestAnimationFrame(()=>t()),n=new MutationObserver(()=>t()),n.observe(document.body,{attributes:!0,attributeFilter:["class","data-vscode-theme","data-vscode-theme-kind"]}),n.observe(document.documentElement,{attributes:!0,attributeFilter:["class","data-vscode-theme","data-vscode-theme-kind"]})}),Ue(()=>{n==null||n.disconnect()}),{theme:C(()=>e.value?dt:null),overrides:o,refresh:t}}const Gt={key:0,xmlns:"http://www.w3.org/2000/svg",viewBox:"0 0 25 32",width:"16",height:"16","aria-hidden":"true"},Kt={key:1,xmlns:"http://www.w3.org/2000/svg",viewBox:"0 0 25 32",width:"16",height:"16","aria-hidden":"true"},Wt=ne({__name:"CallgraphControls",setup(e){const{nodesDraggable:o,setState:t}=ze();xe(()=>{o.value&&t({nodesDraggable:!1})});const n=C(()=>!o.value);function l(){t({nodesDraggable:!o.value})}return(r,a)=>(x(),Y(f(ft),{"show-interactive":!1},{default:P(()=>[D(f(pt),{class:"vue-flow__controls-interactive",title:n.value?"Unlock drag":"Lock drag",onClick:l},{default:P(()=>[n.value?(x(),I("svg",Gt,[...a[0]||(a[0]=[y("path",{fill:"currentColor",d:"M21.333 10.667H19.81V7.619C19.81 3.429 16.38 0 12.19 0 8 0 4.571 3.429 4.571 7.619v3.048H3.048A3.056 3.056 0 0 0 0 13.714v15.238A3.056 3.056 0 0 0 3.048 32h18.285a3.056 3.056 0 0 0 3.048-3.048V13.714a3.056 3.056 0 0 0-3.048-3.047zM12.19 24.533a3.056 3.056 0 0 1-3.047-3.047 3.056 3.056 0 0 1 3.047-3.048 3.056 3.056 0 0 1 3.048 3.048 3.056 3.056 0 0 1-3.048 3.047zm4.724-13.866H7.467V7.619c0-2.59 2.133-4.724 4.723-4.724 2.591 0 4.724 2.133 4.724 4.724v3.048z"},null,-1)])])):(x(),I("svg",Kt,[...a[1]||(a[1]=[y("path",{fill:"currentColor",d:"M21.333 10.667H19.81V7.619C19.81 3.429 16.38 0 12.19 0c-4.114 1.828-1.37 2.133.305 2.438 1.676.305 4.42 2.59 4.42 5.181v3.048H3.047A3.056 3.056 0 0 0 0 13.714v15.238A3.056 3.056 0 0 0 3.048 32h18.285a3.056 3.056 0 0 0 3.048-3.048V13.714a3.056 3.056 0 0 0-3.048-3.047zM12.19 24.533a3.056 3.056 0 0 1-3.047-3.047 3.056 3.056 0 0 1 3.047-3.048 3.056 3.056 0 0 1 3.048 3.048 3.056 3.056 0 0 1-3.048 3.047z"},null,-1)])]))]),_:1},8,["title"])]),_:1}))}}),qt=ne({__name:"CallgraphViewportSync",props:{flowKey:{},paneVisible:{type:Boolean}},setup(e){const o=e,{setViewport:t,viewport:n}=ze();return H(n,l=>{we.set(o.flowKey,{x:l.x,y:l.y,zoom:l.zoom})},{deep:!0}),H(()=>[o.paneVisible,o.flowKey],([l],[r])=>{if(r&&!l){we.set(o.flowKey,{x:n.value.x,y:n.value.y,zoom:n.value.zoom});return}if(!l)return;const a=we.get(o.flowKey);a&&ue(()=>{t(a,{duration:0})})}),(l,r)=>null}});function Te(e,o){const t=new Set,n=new Set;for(const l of o)l.targetname===e&&t.add(l.sourcename),l.sourcename===e&&n.add(l.targetname);return{callers:t,callees:n}}const qe=160,je=48;function jt(e){return e==="LR"?{source:re.Right,target:re.Left}:{source:re.Bottom,target:re.Top}}function Zt(e){return`n_${e.replace(/[^a-zA-Z0-9_-]/g,"_")}`}function Xt(e,o,t,n){const l=new Ae.graphlib.Graph;return l.setDefaultEdgeLabel(()=>({})),l.setGraph({rankdir:n,nodesep:24,ranksep:72}),e.forEach(r=>{l.setNode(t.get(r.title),{width:qe,height:je})}),o.forEach(r=>{const a=t.get(r.sourcename),k=t.get(r.targetname);a&&k&&l.setEdge(a,k)}),Ae.layout(l),l}function Jt(e,o,t="TB"){const n=new Map;e.forEach(g=>{n.set(g.title,Zt(g.title))});const l=Xt(e,o,n,t),{source:r,target:a}=jt(t),k=qe,i=je,p=40;let v=1/0,h=1/0;for(const g of e){const S=n.get(g.title);if(!S)continue;const L=l.node(S);L&&(v=Math.min(v,L.x-k/2),h=Math.min(h,L.y-i/2))}Number.isFinite(v)||(v=0),Number.isFinite(h)||(h=0);const m=e.map(g=>{const S=n.get(g.title),L=l.node(S);return{id:S,position:{x:((L==null?void 0:L.x)??0)-k/2-v+p,y:((L==null?void 0:L.y)??0)-i/2-h+p},width:k,height:i,style:{width:`${k}px`,height:`${i}px`},class:"callgraph-flow-node",sourcePosition:r,targetPosition:a,data:{label:g.label,shape:g.shape,location:g.location,title:g.title},type:"callgraph"}}),u=o.filter(g=>n.has(g.sourcename)&&n.has(g.targetname)).map((g,S)=>{const L=n.get(g.sourcename),F=n.get(g.targetname);return{id:Mt(S,L,F),source:L,target:F,animated:!1,markerEnd:vt.ArrowClosed,data:{sourceTitle:g.sourcename,targetTitle:g.targetname,label:g.label,vcgEdge:g}}});return{nodes:m,edges:u}}const Yt=["title"],Qt=["title"],eo={class:"cg-loc"},to=ne({__name:"CallgraphNode",props:{id:{},type:{},selected:{type:Boolean},connectable:{type:[Boolean,Number,String,Function]},position:{},dimensions:{},label:{},isValidTargetPos:{type:Function},isValidSourcePos:{type:Function},parent:{},parentNodeId:{},dragging:{type:Boolean},resizing:{type:Boolean},zIndex:{},targetPosition:{},sourcePosition:{},dragHandle:{},data:{},events:{}},setup(e){const o=e,t=C(()=>{const l=o.data.shape;return l==="triangle"?"node-triangle":l==="ellipse"?"node-ellipse":"node-box"}),n=C(()=>{const l=o.data.location;return l!=null&&l.file?l.line!==void 0&&l.column!==void 0?`${l.file}:${l.line}:${l.column}`:l.line!==void 0?`${l.file}:${l.line}`:l.file:""});return(l,r)=>{var a,k;return x(),I("div",{class:Q(["cg-node",[t.value,{selected:o.selected,"node-dimmed":o.data.dimmed,"node-highlighted":o.data.highlighted,"node-selected-role":o.data.highlightRole==="selected","node-caller":o.data.highlightRole==="caller","node-callee":o.data.highlightRole==="callee"}]])},[D(f(Le),{type:"target",position:o.targetPosition??f(re).Top},null,8,["position"]),y("div",{class:"cg-label",title:((a=o.data)==null?void 0:a.label)??""},N(((k=o.data)==null?void 0:k.label)??""),9,Yt),n.value?(x(),I("div",{key:0,class:"cg-loc-wrap",title:n.value},[y("span",eo,N(n.value),1)],8,Qt)):K("",!0),D(f(Le),{type:"source",position:o.sourcePosition??f(re).Bottom},null,8,["position"])],2)}}}),de=(e,o)=>{const t=e.__vccOpts||e;for(const[n,l]of o)t[n]=l;return t},oo=de(to,[["__scopeId","data-v-f9fa7eb9"]]),no={class:"callgraph-canvas"},lo={key:0,class:"search-hint"},ao={key:1,class:"edge-hint"},so=180,ro=52,io=ne({__name:"CallgraphCanvas",props:{graph:{},graphKey:{},searchText:{},layoutDirection:{},selectedNodeTitle:{},selectedEdgeId:{},focusNodeTitle:{},paneVisible:{type:Boolean}},emits:["nodeSelect","edgeSelect"],setup(e,{emit:o}){const t=e,n=o,l=B([]),r=B([]),a=B(new Map),k={callgraph:gt(oo)},i=C(()=>`${t.graphKey}::${t.layoutDirection}`),p=B(null),v=B(null);function h(_=0){var c;if(_>=12)return;const T=(c=p.value)==null?void 0:c.fitView;if(!T){window.setTimeout(()=>h(_+1),80);return}T({padding:.12,minZoom:.12,maxZoom:1.5,duration:0}).then(d=>{d?v.value=i.value:h(_+1)})}function m(){v.value!==i.value&&h()}function u(_,T=0){if(!_||T>=12)return;const c=p.value,d=c==null?void 0:c.setCenter;if(!d){window.setTimeout(()=>u(_,T+1),80);return}const b=a.value.get(_);if(!b){window.setTimeout(()=>u(_,T+1),80);return}d(b.x,b.y,{zoom:.85,duration:200})}const g=C(()=>{const _=t.searchText.trim().toLowerCase();if(!_||!t.graph)return new Set;const T=new Set;return t.graph.nodes.forEach(c=>{(c.label.toLowerCase().includes(_)||c.title.toLowerCase().includes(_))&&T.add(c.title)}),T}),S=C(()=>!t.searchText.trim()||g.value.size>0),L=C(()=>{var _,T;return(((_=t.graph)==null?void 0:_.edges.length)??0)===0&&(((T=t.graph)==null?void 0:T.nodes.length)??0)>0});function F(){const _=t.searchText.trim(),T=t.selectedNodeTitle,c=t.selectedEdgeId,d=T&&t.graph?Te(T,t.graph.edges):null;let b=null;if(c)for(const $ of r.value){if($.id!==c)continue;const E=$.data;E!=null&&E.sourceTitle&&(E!=null&&E.targetTitle)&&(b={source:E.sourceTitle,target:E.targetTitle});break}for(const $ of l.value){const E=$.data,U=E.title??$.id;let z=!1,J=!1,W;if(_&&(J=g.value.has(U),z=!J,t.focusNodeTitle===U&&(J=!0,z=!1,W="selected")),d)U===T?(W="selected",z=!1,J=!1):d.callers.has(U)?(W="caller",z=!1):d.callees.has(U)?(W="callee",z=!1):(!_||!g.value.has(U))&&(z=!0,W=void 0,J=!1);else if(b){const G=E.title??$.id;G===b.source||G===b.target?z=!1:(!_||!g.value.has(G))&&(z=!0),W=void 0}else W=void 0;E.dimmed=z,E.highlighted=J,E.highlightRole=W}for(const $ of r.value){const E=$.data,U=(E==null?void 0:E.sourceTitle)??"",z=(E==null?void 0:E.targetTitle)??"",J=!!c&&$.id===c,W=!!d&&!!T&&z===T;J?($.class="edge-selected",$.animated=!0):W||!!d&&!!T&&U===T?($.class=W?"edge-caller":"edge-callee",$.animated=!0):d&&T?($.class="edge-dimmed",$.animated=!1):($.class=void 0,$.animated=!1),$.style=void 0}}function V(){var c;if(!((c=t.graph)!=null&&c.nodes.length)){l.value=[],r.value=[];return}const _=Jt(t.graph.nodes,t.graph.edges,t.layoutDirection);l.value=_.nodes,r.value=_.edges;const T=new Map;for(const d of _.nodes){const b=d.data,$=b==null?void 0:b.title;$&&d.position&&T.set($,{x:d.position.x+so/2,y:d.position.y+ro/2})}a.value=T,F(),ue(()=>{m()})}H(()=>[t.graph,t.graphKey,t.layoutDirection],()=>{V()},{immediate:!0,deep:!0}),H(()=>[t.searchText,t.selectedNodeTitle,t.selectedEdgeId,t.focusNodeTitle],()=>{F()}),H(()=>t.focusNodeTitle,_=>{_&&ue(()=>u(_))}),H(l,(_,T)=>{var c;_.length===0&&T.length>0&&(((c=t.graph)==null?void 0:c.nodes.length)??0)>0&&V()});function q(_){var c;const T=((c=_.node.data)==null?void 0:c.title)??_.node.id;n("edgeSelect",null),n("nodeSelect",T)}function Z(_){var c;const T=(c=_.edge.data)==null?void 0:c.vcgEdge;T&&(n("nodeSelect",null),n("edgeSelect",{edge:T,flowId:_.edge.id}))}function X(){n("nodeSelect",null),n("edgeSelect",null)}return(_,T)=>(x(),I("div",no,[(x(),Y(f(ht),{ref_key:"vueFlowRef",ref:p,key:i.value,nodes:l.value,"onUpdate:nodes":T[0]||(T[0]=c=>l.value=c),edges:r.value,"onUpdate:edges":T[1]||(T[1]=c=>r.value=c),"node-types":k,"nodes-draggable":!1,"nodes-connectable":!1,"elements-selectable":!0,"default-zoom":1,"min-zoom":.05,"max-zoom":2,class:"callgraph-flow",onNodeClick:q,onEdgeClick:Z,onPaneClick:X,onNodesInitialized:m},{default:P(()=>[D(f(mt),{gap:16,"pattern-color":"var(--vscode-editorWidget-border, #3c3c3c)"}),D(Wt),D(qt,{"flow-key":i.value,"pane-visible":t.paneVisible??!0},null,8,["flow-key","pane-visible"])]),_:1},8,["nodes","edges"])),e.searchText.trim()&&!S.value?(x(),I("div",lo," No matched functions ")):K("",!0),L.value?(x(),I("div",ao,"No matched callgraph")):K("",!0)]))}}),co=de(io,[["__scopeId","data-v-9807dbbc"]]);function Ze(e,o){const t=new Map(o.map(n=>[n.title,n.label]));return e.sort((n,l)=>(t.get(n)??n).localeCompare(t.get(l)??l,void 0,{sensitivity:"base"}))}function uo(e,o,t){const{callers:n}=Te(e,o),l=new Set;if(n.size>0){l.add(e);for(const r of n)for(const a of o)a.sourcename===r&&l.add(a.targetname)}else{const r=new Set(o.map(a=>a.targetname));for(const a of t)r.has(a.title)||l.add(a.title);l.size===0&&l.add(e)}return Ze(Array.from(l),t)}function He(e,o,t,n){const{callers:l,callees:r}=Te(e,o);return Ze(Array.from(n==="callers"?l:r),t)}function fo(e){return e==="callers"?"callees":"callers"}function po(e){return e==="ArrowUp"||e==="ArrowDown"||e==="ArrowLeft"||e==="ArrowRight"}function vo(e){return e==="ArrowUp"?{mode:"level",delta:-1}:e==="ArrowDown"?{mode:"level",delta:1}:e==="ArrowLeft"?{mode:"callers",delta:-1}:e==="ArrowRight"?{mode:"callees",delta:1}:null}function go(){const e=document.activeElement;return e?!!(e instanceof HTMLInputElement||e instanceof HTMLTextAreaElement||e.closest(".n-base-select-menu, .n-base-selection")):!1}function ho(e){const o=B(null),t=B(0),n=B([]);let l=!1;function r(){n.value=[]}H(e.selectedNodeId,()=>{l||(o.value=null,t.value=0)}),H(e.searchText,u=>{u.trim()&&(o.value=null,t.value=0,r())});function a(u){l=!0,e.onSelectNode(u),e.onPanToNode(u),ue(()=>{l=!1})}function k(u,g,S){if(u.length!==0){if(o.value!==g){o.value=g;const L=e.selectedNodeId.value,F=L?u.indexOf(L):-1;t.value=F>=0?F:S>0?0:u.length-1}u.length===1?t.value=0:t.value=(t.value+S+u.length)%u.length,a(u[t.value])}}function i(u){const g=n.value[n.value.length-1];if(!g||g.via!==fo(u))return!1;const S=n.value.pop();o.value=u;const L=He(e.selectedNodeId.value,e.graphEdges.value,e.graphNodes.value,u);return t.value=L.indexOf(S.returnTo),a(S.returnTo),!0}function p(u,g){const S=e.selectedNodeId.value;if(!S||i(u))return;const L=e.graphEdges.value,F=e.graphNodes.value,V=He(S,L,F,u);if(V.length===0)return;if(o.value!==u){o.value=u;const Z=V.indexOf(S);t.value=Z>=0?Z:g>0?0:V.length-1}V.length===1?t.value=0:t.value=(t.value+g+V.length)%V.length;const q=V[t.value];q!==S&&n.value.push({returnTo:S,via:u}),a(q)}function v(u,g){const S=e.selectedNodeId.value;if(S){if(u==="level"){const L=uo(S,e.graphEdges.value,e.graphNodes.value);k(L,u,g);return}p(u,g)}}function h(u){e.hasSearchMatches.value&&(u.key==="ArrowDown"?(u.preventDefault(),e.goSearchNext()):u.key==="ArrowUp"&&(u.preventDefault(),e.goSearchPrev()))}function m(u){if(!e.paneVisible.value||go()||e.searchText.value.trim()||!po(u.key)||!e.selectedNodeId.value)return;const g=vo(u.key);g&&(u.preventDefault(),v(g.mode,g.delta))}return xe(()=>{window.addEventListener("keydown",m)}),Ue(()=>{window.removeEventListener("keydown",m)}),{onSearchKeydown:h,clearLrStack:r}}function mo(e,o){const t=B(0),n=C(()=>{const p=e.value.trim().toLowerCase();return p?o.value.filter(v=>v.label.toLowerCase().includes(p)||v.title.toLowerCase().includes(p)).map(v=>({title:v.title,label:v.label})).sort((v,h)=>v.label.localeCompare(h.label,void 0,{sensitivity:"base"})):[]}),l=C(()=>n.value[t.value]??null),r=C(()=>n.value.length>0);H(e,()=>{t.value=0}),H(n,p=>{if(p.length===0){t.value=0;return}t.value>=p.length&&(t.value=0)});function a(p){if(n.value.length===0){t.value=0;return}const v=Math.max(0,Math.min(p,n.value.length-1));t.value=v}function k(){n.value.length!==0&&a(t.value<=0?n.value.length-1:t.value-1)}function i(){n.value.length!==0&&a(t.value>=n.value.length-1?0:t.value+1)}return{matches:n,activeIndex:t,activeMatch:l,hasMatches:r,setActiveIndex:a,goPrev:k,goNext:i}}function Xe(e){const o=new Set;for(const t of e)o.add(t.sourcename),o.add(t.targetname);return o}function yo(e,o){const t=Xe(o),n=e.filter(a=>t.has(a.title)),l=new Set(n.map(a=>a.title)),r=o.filter(a=>l.has(a.sourcename)&&l.has(a.targetname));return{nodes:n,edges:r}}function Ce(e,o){return!Xe(o).has(e)}function bo(e){const o=e.replace(/\\/g,"/"),t=o.lastIndexOf("/");return t>=0?o.slice(t+1):o}function wo(e,o){const t=e.findIndex(n=>bo(n.title).localeCompare(o,void 0,{sensitivity:"base"})===0);return t>=0?t:null}const ko="main.c";function ve(e){return e.replace(/\\/g,"/")}function Je(e,o,t){return`${ve(e)}:${o}:${t}`}function Co(e){return/[A-Za-z_]/.test(e)}function xo(e,o){if(o!==1||!Co(e[0]))return!1;if(o+1>=e.length)return!0;const t=e[o+1];return t==="\\"||t==="/"}function _o(e,o){for(let t=o-1;t>=0;t--)if(e[t]===":"&&!xo(e,t))return t;return-1}function To(e){for(let o=e.length-3;o>=0;o--)if(e[o]==="."&&e[o+1]==="o"&&e[o+2]===":")return o+2;return-1}function No(e){const o=To(e);if(o>=0)return e.slice(o+1);const t=_o(e,e.length);return t>0?e.slice(t+1):e}function So(e){const o=new Map,t=new Map;for(const n of e){o.set(Je(n.location.file,n.location.line,n.location.column),n);const l=t.get(n.functionName)??[];l.push(n),t.set(n.functionName,l)}return{byLocation:o,byFunctionName:t}}function Re(e){return{stackBytes:e.stackBytes,allocationType:e.allocationType}}function $o(e,o){var k;if(((k=o.location)==null?void 0:k.line)===void 0)return e[0]??null;const t=ve(o.location.file),n=o.location.line,l=o.location.column??0,r=e.find(i=>ve(i.location.file)===t&&i.location.line===n&&i.location.column===l);return r||(e.find(i=>ve(i.location.file)===t&&i.location.line===n)??e[0]??null)}function Io(e,o){var n;if(((n=e.location)==null?void 0:n.line)!==void 0){const l=e.location.column??0,r=o.byLocation.get(Je(e.location.file,e.location.line,l));if(r)return Re(r)}const t=new Set;e.label&&t.add(e.label),t.add(No(e.title));for(const l of t){const r=o.byFunctionName.get(l);if(!(r!=null&&r.length))continue;const a=$o(r,e);if(a)return Re(a)}return null}function Eo(e,o){const t=new Set(e.nodes.map(i=>i.title)),n=new Map;for(const i of e.nodes){const p=Io(i,o);n.set(i.title,(p==null?void 0:p.stackBytes)??0)}const l=new Map;for(const i of e.edges){if(!t.has(i.sourcename)||!t.has(i.targetname))continue;const p=l.get(i.sourcename)??[];p.push(i.targetname),l.set(i.sourcename,p)}const r=new Map;function a(i,p){const v=r.get(i);if(v!==void 0)return v;if(p.has(i))return n.get(i)??0;p.add(i);const h=n.get(i)??0;let m=0;for(const g of l.get(i)??[])m=Math.max(m,a(g,p));p.delete(i);const u=h+m;return r.set(i,u),u}const k=new Map;for(const i of e.nodes)k.set(i.title,a(i.title,new Set));return k}const Bo={key:0,class:"page-view empty-center"},Ao={key:1,class:"page-view callgraph-page"},Lo={class:"page-toolbar callgraph-toolbar"},Mo={class:"toolbar-start"},Do=["title"],Vo={class:"search-block"},Po={class:"search-row"},Fo=["disabled"],Ho=["disabled"],Ro=["disabled"],Uo={key:0,class:"search-counter"},zo={key:0,class:"search-results-dropdown"},Oo=["title","onClick"],Go={class:"toolbar-end"},Ko={key:0,class:"empty-center"},Wo={key:1,class:"callgraph-flow-wrap"},qo={class:"node-detail"},jo={class:"max-stack-badge",tabindex:"0"},Zo="Max Stack Usage = 本函数局部栈（GCC -fstack-usage）+ 被调用函数中最大的 Max Stack Usage。仅沿当前调用图向下累计，不含调用方栈帧；多个被调函数取子链最大值（非相加）。",Xo=ne({__name:"CallgraphView",props:{paneVisible:{type:Boolean}},setup(e){const o=e,{hasCallgraph:t,hasStackUsage:n,callgraphGraphs:l,mergedCallgraphGraph:r,allStackEntries:a}=_e(),k=C(()=>So(a.value)),{selectedIndex:i,searchText:p,layoutDirection:v,hideOrphanNodes:h,selectedNodeId:m,selectedEdge:u,selectedEdgeFlowId:g}=pe;H(l,s=>{if(s.length!==0){if(!Fe.value){Fe.value=!0;const w=wo(s,ko);i.value=w??te}i.value!==te&&i.value>=s.length&&(i.value=te)}},{immediate:!0}),H([i,v,h],()=>{m.value=null,u.value=null,g.value=null});const S=C(()=>{var O;const s=`Merged (${((O=r.value)==null?void 0:O.nodes.length)??0})`,w=l.value.map(M=>{const le=`${M.title} (${M.nodes.length})`;return{label:le,value:M.index,fullLabel:le}}).sort((M,le)=>M.fullLabel.localeCompare(le.fullLabel,void 0,{sensitivity:"base"}));return[{label:s,value:te,fullLabel:s},...w]}),L=C(()=>{const s=S.value.find(w=>w.value===i.value);return(s==null?void 0:s.fullLabel)??""});function F(s){const w=s,O=w.fullLabel??(typeof w.label=="string"?w.label:"");return O?{title:O}:{}}const V=C(()=>i.value===te?r.value:l.value[i.value]??null),q=C(()=>{const s=V.value;if(!s||!h.value)return s;const{nodes:w,edges:O}=yo(s.nodes,s.edges);return{...s,nodes:w,edges:O,isEmpty:w.length===0}});H([q,t],([s,w])=>{if(!w||!s){pe.graphStats.value=null;return}pe.graphStats.value={nodes:s.nodes.length,edges:s.edges.length}},{immediate:!0});const Z=C(()=>{var w;const s=i.value===te?"__merged__":((w=V.value)==null?void 0:w.title)??String(i.value);return h.value?`${s}::no-orphan`:s}),X=C(()=>{const s=q.value;return s?{graph:{title:s.title},nodes:s.nodes,edges:s.edges}:null}),_=C(()=>{var s;return((s=q.value)==null?void 0:s.nodes)??[]});H([h,V],()=>{const s=V.value;if(!(!s||!h.value)&&(m.value&&Ce(m.value,s.edges)&&(m.value=null),u.value)){const{sourcename:w,targetname:O}=u.value;(Ce(w,s.edges)||Ce(O,s.edges))&&(u.value=null,g.value=null)}});const{matches:T,activeIndex:c,activeMatch:d,hasMatches:b,setActiveIndex:$,goPrev:E,goNext:U}=mo(p,_),z=B(null),J=C(()=>p.value.trim()&&d.value?d.value.title:z.value);H(d,s=>{s&&(m.value=s.title,u.value=null,g.value=null,z.value=s.title)}),H(c,()=>{ue(()=>{var s;(s=document.querySelector(".search-results-item.active"))==null||s.scrollIntoView({block:"nearest"})})});function W(s){$(s)}const G=C(()=>!m.value||!X.value?null:X.value.nodes.find(s=>s.title===m.value)??null),Ne=C(()=>{const s=X.value;return!s||!n.value?new Map:Eo(s,k.value)}),Se=C(()=>{const s=G.value;if(!s||!n.value)return null;const w=Ne.value.get(s.title);return w===void 0?null:w});function $e(s){var O;const w=(O=X.value)==null?void 0:O.nodes.find(M=>M.title===s);return(w==null?void 0:w.label)??s}const Ye=C(()=>u.value?$e(u.value.sourcename):""),Qe=C(()=>u.value?$e(u.value.targetname):""),Ie=C(()=>{var s;return Lt((s=u.value)==null?void 0:s.label)});function Ee(s){m.value=s,u.value=null,g.value=null,p.value.trim()||(z.value=null)}function et(s){u.value=(s==null?void 0:s.edge)??null,g.value=(s==null?void 0:s.flowId)??null,m.value=null}const tt=C(()=>{var s;return((s=X.value)==null?void 0:s.edges)??[]}),ot=C(()=>o.paneVisible??!0),{onSearchKeydown:Be,clearLrStack:nt}=ho({paneVisible:ot,searchText:p,hasSearchMatches:b,goSearchPrev:E,goSearchNext:U,selectedNodeId:m,graphEdges:tt,graphNodes:_,onSelectNode(s){Ee(s)},onPanToNode(s){z.value=s}});function lt(s){nt(),Ee(s)}const at=[{label:"Top → Bottom",value:"TB"},{label:"Left → Right",value:"LR"}];function st(){p.value=""}function rt(s){var w;(w=s.location)!=null&&w.file&&ae.gotoDefinition({file:s.location.file,line:s.location.line,column:s.location.column})}function it(){const s=G.value;s&&rt(s)}function aa(){const s=G.value;s&&ae.showDisassembly(No(s.title))}function ct(){const s=Ie.value;s!=null&&s.file&&ae.gotoDefinition({file:s.file,line:s.line,column:s.column})}return(s,w)=>{var O;return f(t)?(x(),I("div",Ao,[y("div",Lo,[y("div",Mo,[y("div",{class:"graph-select-wrap",title:L.value},[D(f(Me),{value:f(i),"onUpdate:value":w[0]||(w[0]=M=>fe(i)?i.value=M:null),class:"graph-select",options:S.value,"node-props":F,"consistent-menu-width":!1,size:"small"},null,8,["value","options"])],8,Do),y("div",Vo,[y("div",Po,[he(y("input",{"onUpdate:modelValue":w[1]||(w[1]=M=>fe(p)?p.value=M:null),class:"search-input",type:"text",placeholder:"Search function ...",onKeydown:w[2]||(w[2]=(...M)=>f(Be)&&f(Be)(...M))},null,544),[[Oe,f(p)]]),y("button",{disabled:!f(p),type:"button",class:"btn-outline btn-outline--icon search-clear-btn",title:"Clear search","aria-label":"Clear search",onClick:st}," × ",8,Fo),y("button",{type:"button",class:"btn-outline btn-outline--icon",disabled:!f(b),title:"Previous match",onClick:w[3]||(w[3]=(...M)=>f(E)&&f(E)(...M))}," ‹ ",8,Ho),y("button",{type:"button",class:"btn-outline btn-outline--icon",disabled:!f(b),title:"Next match",onClick:w[4]||(w[4]=(...M)=>f(U)&&f(U)(...M))}," › ",8,Ro),f(b)?(x(),I("span",Uo,N(f(c)+1)+" / "+N(f(T).length),1)):K("",!0)]),f(b)?(x(),I("ul",zo,[(x(!0),I(ie,null,Ge(f(T),(M,le)=>(x(),I("li",{key:M.title,class:Q(["search-results-item",{active:le===f(c)}]),title:M.label,onClick:Dn=>W(le)},N(M.label),11,Oo))),128))])):K("",!0)])]),y("div",Go,[D(f(yt),{checked:f(h),"onUpdate:checked":w[5]||(w[5]=M=>fe(h)?h.value=M:null),size:"large"},{default:P(()=>[...w[8]||(w[8]=[R(" Hide Orphan Nodes ",-1)])]),_:1},8,["checked"]),D(f(Me),{value:f(v),"onUpdate:value":w[6]||(w[6]=M=>fe(v)?v.value=M:null),class:"layout-select",options:at,size:"small"},null,8,["value"])])]),(O=q.value)!=null&&O.isEmpty?(x(),I("div",Ko,[D(f(ge),{description:"No callgraph data"})])):(x(),I("div",Wo,[D(co,{graph:X.value,"graph-key":Z.value,"search-text":f(p),"layout-direction":f(v),"selected-node-title":f(m),"selected-edge-id":f(g),"focus-node-title":J.value,"pane-visible":o.paneVisible??!0,onNodeSelect:lt,onEdgeSelect:et},null,8,["graph","graph-key","search-text","layout-direction","selected-node-title","selected-edge-id","focus-node-title","pane-visible"])])),y("div",qo,[f(u)?(x(),I(ie,{key:0},[D(f(De),{align:"center"},{default:P(()=>[D(f(ee),{strong:""},{default:P(()=>[R(N(Ye.value)+" → "+N(Qe.value),1)]),_:1}),Ie.value?(x(),I("button",{key:0,type:"button",class:"btn-outline btn-outline--tiny",onClick:ct}," Go To Definition ")):K("",!0)]),_:1}),f(u).label?(x(),Y(f(ee),{key:0,depth:"3",style:{"font-size":"11px"}},{default:P(()=>[R(N(f(u).label),1)]),_:1})):(x(),Y(f(ee),{key:1,depth:"3",style:{"font-size":"11px"}},{default:P(()=>[R(N(f(u).sourcename)+" → "+N(f(u).targetname),1)]),_:1}))],64)):G.value?(x(),I(ie,{key:1},[D(f(De),{align:"center",wrap:!1},{default:P(()=>[D(f(ee),{strong:""},{default:P(()=>[R(N(G.value.label),1)]),_:1}),Se.value!==null?(x(),Y(f(bt),{key:0,trigger:"hover",style:{maxWidth:"360px"}},{trigger:P(()=>[y("span",jo," Max Stack Usage: "+N(Se.value)+" B ",1)]),default:P(()=>[R(" "+N(Zo))]),_:1})):K("",!0),y("button",{type:"button",class:"btn-outline btn-outline--tiny",onClick:it}," Go To Definition "),y("button",{type:"button",class:"btn-outline btn-outline--tiny",onClick:aa}," Show Disassembly ")]),_:1}),G.value.location?(x(),Y(f(ee),{key:0,depth:"3",style:{"font-size":"12px",padding:"4px 0px"}},{default:P(()=>[R(N(G.value.location.file)+" ",1),G.value.location.line!==void 0?(x(),I(ie,{key:0},[R(" :"+N(G.value.location.line)+":"+N(G.value.location.column),1)],64)):K("",!0)]),_:1})):K("",!0)],64)):(x(),Y(f(ee),{key:2,depth:"3",class:"node-detail-empty"},{default:P(()=>[...w[9]||(w[9]=[R("No data",-1)])]),_:1}))])])):(x(),I("div",Bo,[D(f(ge),{description:"No callgraph data"},{extra:P(()=>[D(f(ee),{depth:"3",style:{"font-size":"12px"}},{default:P(()=>[...w[7]||(w[7]=[R(" Please enable -fcallgraph-info in the build options and rebuild the project. ",-1)])]),_:1})]),_:1})]))}}}),Jo=de(Xo,[["__scopeId","data-v-2a356fdb"]]),Yo={class:"page-toolbar",style:{padding:"8px 10px"}},Qo={class:"badge"},en={key:0,class:"stack-table"},tn={class:"sort-indicator"},on={class:"sort-indicator"},nn={class:"sort-indicator"},ln={class:"sort-indicator"},an={class:"sort-indicator"},sn=["onContextmenu"],rn=["title"],cn=["title"],un=["title"],dn=["title"],fn={key:1,class:"empty-center"},pn={class:"table-footer"},vn={class:"muted"},gn=ne({__name:"StackUsageTable",props:{rows:{},showSourceColumn:{type:Boolean},scrollKey:{},paneVisible:{type:Boolean}},setup(e,{expose:o}){const t=e,n=B(null);function l(){return t.scrollKey??"default"}function r(){n.value&&ke.set(l(),n.value.scrollTop)}function a(){ue(()=>{n.value&&(n.value.scrollTop=ke.get(l())??0)})}function k(){r()}H(()=>t.scrollKey,(c,d)=>{var b;d!==void 0&&ke.set(String(d),((b=n.value)==null?void 0:b.scrollTop)??0),a()}),H(()=>t.paneVisible,(c,d)=>{d&&!c?r():c&&!d&&a()});const i=B(""),p=B("stackBytes"),v=B("desc"),h=B(null),m=B({show:!1,x:0,y:0,row:null}),u=C(()=>t.rows.reduce((c,d)=>Math.max(c,d.stackBytes),0)),g=C(()=>{const c=i.value.trim().toLowerCase();return c?t.rows.filter(d=>d.functionName.toLowerCase().includes(c)||d.locationText.toLowerCase().includes(c)||d.allocationType.toLowerCase().includes(c)||d.sourceDoc.toLowerCase().includes(c)):t.rows}),S=C(()=>{const c=[...g.value],d=v.value==="asc"?1:-1;return c.sort((b,$)=>{let E,U;switch(p.value){case"stackBytes":E=b.stackBytes,U=$.stackBytes;break;case"functionName":return b.functionName.localeCompare($.functionName)*d;case"locationText":return b.locationText.localeCompare($.locationText)*d;case"allocationType":return b.allocationType.localeCompare($.allocationType)*d;case"sourceDoc":return b.sourceDoc.localeCompare($.sourceDoc)*d;default:return 0}return E===U?0:E>U?d:-d}),c}),L=C(()=>t.rows.reduce((c,d)=>c+d.stackBytes,0));function F(c){p.value===c?v.value=v.value==="asc"?"desc":"asc":(p.value=c,v.value=c==="stackBytes"?"desc":"asc")}function V(c){return p.value!==c?"↕":v.value==="asc"?"↑":"↓"}function q(c,d,b){c.preventDefault(),h.value=b,m.value={show:!0,x:c.clientX,y:c.clientY,row:d}}function Z(){m.value.show=!1}function X(){const c=m.value.row;c&&ae.gotoDefinition({file:c.file,line:c.line,column:c.column}),Z()}const _=[{label:"Go To Definition",key:"goto"}];function T(c){c==="goto"&&X()}return o({filterText:i}),(c,d)=>(x(),I("div",{class:"table-wrapper",onClick:Z},[y("div",Yo,[he(y("input",{"onUpdate:modelValue":d[0]||(d[0]=b=>i.value=b),class:"search-input",type:"text",placeholder:"Filter by function, file, type ..."},null,512),[[Oe,i.value]]),y("span",Qo,N(g.value.length)+" functions",1)]),y("div",{ref_key:"scrollEl",ref:n,class:"table-scroll",onScroll:k},[S.value.length>0?(x(),I("table",en,[y("thead",null,[y("tr",null,[y("th",{class:Q(["sortable",{sorted:p.value==="stackBytes"}]),onClick:d[1]||(d[1]=b=>F("stackBytes"))},[d[6]||(d[6]=R(" Stack ",-1)),y("span",tn,N(V("stackBytes")),1)],2),y("th",{class:Q(["sortable",{sorted:p.value==="functionName"}]),onClick:d[2]||(d[2]=b=>F("functionName"))},[d[7]||(d[7]=R(" Function ",-1)),y("span",on,N(V("functionName")),1)],2),y("th",{class:Q(["sortable",{sorted:p.value==="locationText"}]),onClick:d[3]||(d[3]=b=>F("locationText"))},[d[8]||(d[8]=R(" Location ",-1)),y("span",nn,N(V("locationText")),1)],2),y("th",{class:Q(["sortable",{sorted:p.value==="allocationType"}]),onClick:d[4]||(d[4]=b=>F("allocationType"))},[d[9]||(d[9]=R(" Type ",-1)),y("span",ln,N(V("allocationType")),1)],2),e.showSourceColumn?(x(),I("th",{key:0,class:Q(["sortable",{sorted:p.value==="sourceDoc"}]),onClick:d[5]||(d[5]=b=>F("sourceDoc"))},[d[10]||(d[10]=R(" Source ",-1)),y("span",an,N(V("sourceDoc")),1)],2)):K("",!0)])]),y("tbody",null,[(x(!0),I(ie,null,Ge(S.value,(b,$)=>(x(),I("tr",{key:`${b.functionName}-${b.locationText}-${$}`,class:Q({selected:h.value===$}),onContextmenu:E=>q(E,b,$)},[y("td",{class:"col-stack",style:Ct({"--size-fill":u.value>0?b.stackBytes/u.value:0})},[y("span",null,N(b.stackBytes)+" B",1)],4),y("td",{class:"col-fn",title:b.functionName},N(b.functionName),9,rn),y("td",{class:"col-loc",title:b.locationText},N(b.locationText),9,cn),y("td",{class:"col-type",title:b.allocationType},N(b.allocationType),9,un),e.showSourceColumn?(x(),I("td",{key:0,class:"col-src",title:b.sourceDoc},N(b.sourceDoc),9,dn)):K("",!0)],42,sn))),128))])])):(x(),I("div",fn,[wt(c.$slots,"empty",{},()=>[d[11]||(d[11]=R("No matched results",-1))],!0)]))],544),y("div",pn,[y("span",null,"Max stack: "+N(u.value)+" B · Total: "+N(L.value)+" B",1),y("span",vn,"Sort: "+N(p.value)+" ("+N(v.value)+'), Filter: "'+N(i.value.trim())+'"',1)]),D(f(kt),{show:m.value.show,x:m.value.x,y:m.value.y,options:_,placement:"bottom-start",onSelect:T,onClickoutside:Z},null,8,["show","x","y"])]))}}),hn=de(gn,[["__scopeId","data-v-05f422d2"]]),mn={key:0,class:"empty-center"},yn={key:1,class:"stackusage-page"},bn={class:"stackusage-content"},wn={key:0,class:"empty-center"},kn=ne({__name:"StackUsageView",props:{paneVisible:{type:Boolean}},setup(e){const o=e,{hasStackUsage:t,allStackRows:n}=_e(),l=C(()=>n.value.length===0);return(r,a)=>f(t)?(x(),I("div",yn,[y("div",bn,[l.value?(x(),I("div",wn,[D(f(ge),{description:"No stack usage data"})])):(x(),Y(hn,{key:1,class:"stackusage-table-host",rows:f(n),"show-source-column":!0,"scroll-key":"merged","pane-visible":o.paneVisible??!0},null,8,["rows","pane-visible"]))])])):(x(),I("div",mn,[D(f(ge),{description:"No stack usage data"},{extra:P(()=>[D(f(ee),{depth:"3",style:{"font-size":"12px"}},{default:P(()=>[...a[0]||(a[0]=[R(" Please enable -fstack-usage in the build options and rebuild the project. ",-1)])]),_:1})]),_:1})]))}}),Cn={class:"app-sider"},xn=["title"],_n={class:"app-main"},Tn={class:"page-header"},Nn={class:"page-title"},Sn={key:0,class:"badge page-header-stats"},$n={class:"app-body"},In={key:1,class:"app-pages"},En={key:1,class:"app-pages-overlay",role:"status","aria-live":"polite","aria-label":"Loading"},Bn=ne({__name:"App",setup(e){const{theme:o,overrides:t}=Ot(),{loading:n,loadError:l}=_e(),r=B("callgraph"),a=B(!0),k=[{label:"Callgraph",key:"callgraph",icon:()=>j(Pe,null,{default:()=>j(St)})},{label:"Stack Usage",key:"stackusage",icon:()=>j(Pe,null,{default:()=>j($t)})}],i=C(()=>r.value==="callgraph"?"Callgraph":"Stack Usage"),p=C(()=>pe.graphStats.value);return(v,h)=>(x(),Y(f(Tt),{theme:f(o),"theme-overrides":f(t),"inline-theme-disabled":"","preflight-style-disabled":""},{default:P(()=>[y("div",{class:Q(["app-root",{"app-root--sider-collapsed":a.value}])},[y("aside",Cn,[D(f(xt),{value:r.value,"onUpdate:value":h[0]||(h[0]=m=>r.value=m),collapsed:a.value,"collapsed-width":48,options:k},null,8,["value","collapsed"]),y("button",{type:"button",class:"sider-toggle",title:a.value?"Expand":"Collapse",onClick:h[1]||(h[1]=m=>a.value=!a.value)},N(a.value?"»":"«"),9,xn)]),y("div",_n,[y("header",Tn,[y("span",Nn,N(i.value),1),r.value==="callgraph"&&p.value?(x(),I("span",Sn,N(p.value.nodes)+" nodes · "+N(p.value.edges)+" edges ",1)):K("",!0)]),y("main",$n,[f(l)?(x(),Y(f(_t),{key:0,status:"error",title:"Cannot load data",description:f(l).message},null,8,["description"])):(x(),I("div",In,[f(n)?K("",!0):(x(),I(ie,{key:0},[he(D(Jo,{class:"app-page","pane-visible":r.value==="callgraph"},null,8,["pane-visible"]),[[Ve,r.value==="callgraph"]]),he(D(kn,{class:"app-page","pane-visible":r.value==="stackusage"},null,8,["pane-visible"]),[[Ve,r.value==="stackusage"]])],64)),f(n)?(x(),I("div",En,[...h[2]||(h[2]=[y("div",{class:"app-loading-spinner"},null,-1),y("span",{class:"app-loading-text"},"Loading…",-1)])])):K("",!0)]))])])],2)]),_:1},8,["theme","theme-overrides"]))}}),An=de(Bn,[["__scopeId","data-v-7bf98dfb"]]);async function Ln(){if(!(se()||We()))try{console.warn("[Callgraph View] No local test data")}catch(e){console.warn("[Callgraph View] Failed to load local test data:",e)}}async function Mn(){try{await Ln()}catch(o){console.warn("[Callgraph View] Failed to load fallback data:",o)}Nt(An).mount("#app");try{await Rt()}catch(o){console.error("[Callgraph View] Failed to init:",o)}}Mn();
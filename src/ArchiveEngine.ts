@@ -0,0 +1,637 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as NodePath from 'path';
+import * as zlib from 'zlib';
+import * as crypto from 'crypto';
+
+import { ZipArchive, crc32, safeJoin, checkLinkTarget } from './ZipArchive';
+
+/** 'none': the format is not supported by the engine, use 7z or tar */
+export type ArchiveFormat = 'zip' | 'tar' | 'tar.gz' | 'none';
+
+export interface ExtractOptions {
+
+    /** return false to skip the entry, `name` is the path in the archive, use '/' as the separator */
+    filter?: (name: string) => boolean;
+
+    /** max number of entries decompressed at the same time, default: number of cpus (zip only) */
+    concurrency?: number;
+
+    /** @param total total size of the uncompressed data, it's the archive size for tar files */
+    onProgress?: (done: number, total: number, entryName: string) => void;
+
+    /** return true to stop the extraction */
+    isCanceled?: () => boolean;
+}
+
+export interface ZipFileOptions {
+
+    /** return true to exclude a file or a folder, `relPath` uses '/' as the separator */
+    exclude?: (relPath: string, isDir: boolean) => boolean;
+
+    /** zlib level, default: 9 */
+    level?: number;
+
+    onProgress?: (done: number, total: number, relPath: string) => void;
+}
+
+/**
+ * Detect the archive format by the file header, the file suffix is not reliable
+*/
+export function detectArchiveFormat(path: string): ArchiveFormat {
+
+    const head = Buffer.alloc(512);
+    let n = 0;
+    const fd = fs.openSync(path, 'r');
+    try {
+        n = fs.readSync(fd, head, 0, head.length, 0);
+    } finally {
+        fs.closeSync(fd);
+    }
+
+    if (n >= 4 && head.readUInt32LE(0) == 0x04034b50)
+        return 'zip';
+
+    // empty zip file
+    if (n >= 4 && head.readUInt32LE(0) == 0x06054b50)
+        return 'zip';
+
+    if (n >= 2 && head[0] == 0x1f && head[1] == 0x8b)
+        return /\.(tar\.gz|tgz)$/i.test(path) ? 'tar.gz' : 'none';
+
+    if (n == 512 && head.toString('ascii', 257, 262) == 'ustar')
+        return 'tar';
+
+    return 'none';
+}
+
+export async function extractArchive(archivePath: string, outDir: string, options?: ExtractOptions): Promise<void> {
+
+    const format = detectArchiveFormat(archivePath);
+
+    switch (format) {
+        case 'zip':
+            return extractZip(archivePath, outDir, options);
+        case 'tar':
+        case 'tar.gz':
+            return extractTar(archivePath, outDir, format == 'tar.gz', options);
+        default:
+            throw new Error(`Unsupported archive format: '${archivePath}'`);
+    }
+}
+
+//
+// zip
+//
+
+async function extractZip(archivePath: string, outDir: string, options?: ExtractOptions): Promise<void> {
+
+    const opts = options || {};
+    const zip = ZipArchive.open(archivePath);
+
+    try {
+
+        const entries = zip.entries.filter(e => !opts.filter || opts.filter(e.name));
+
+        // symlinks are created at the end, so that no file is written through a link
+        const files = entries.filter(e => !ZipArchive.isSymlink(e));
+        const links = entries.filter(e => ZipArchive.isSymlink(e));
+
+        let total = 0;
+        files.forEach(e => total += e.size);
+
+        let done = 0;
+        let next = 0;
+        let error: Error | undefined;
+
+        const worker = async () => {
+            while (next < files.length && error == undefined) {
+                if (opts.isCanceled && opts.isCanceled())
+                    return;
+                const entry = files[next++];
+                try {
+                    await zip.extractAsync(entry, safeJoin(outDir, entry.name), outDir, (n) => {
+                        done += n;
+                        if (opts.onProgress) opts.onProgress(done, total, entry.name);
+                    });
+                } catch (err) {
+                    error = error || <Error>err;
+                }
+            }
+        };
+
+        const concurrency = Math.max(1, opts.concurrency || os.cpus().length);
+        const workers: Promise<void>[] = [];
+        for (let i = 0; i < Math.min(concurrency, files.length); i++)
+            workers.push(worker());
+        await Promise.all(workers);
+
+        if (error)
+            throw error;
+
+        for (const entry of links) {
+            if (opts.isCanceled && opts.isCanceled())
+                return;
+            zip.extract(entry, safeJoin(outDir, entry.name), outDir);
+        }
+
+    } finally {
+        zip.close();
+    }
+}
+
+/**
+ * Extract a zip file synchronously, it's used by the sync callers, such as `SevenZipper.UnzipSync`
+ *
+ * @returns the extracted entry names
+*/
+export function extractZipSync(archivePath: string, outDir: string, filter?: (name: string) => boolean): string[] {
+
+    const zip = ZipArchive.open(archivePath);
+
+    try {
+        const entries = zip.entries.filter(e => !filter || filter(e.name));
+        const sorted = entries.filter(e => !ZipArchive.isSymlink(e))
+            .concat(entries.filter(e => ZipArchive.isSymlink(e)));
+        for (const entry of sorted) {
+            zip.extract(entry, safeJoin(outDir, entry.name), outDir);
+        }
+        return sorted.map(e => e.name);
+    } finally {
+        zip.close();
+    }
+}
+
+//
+// tar
+//
+
+interface TarHeader {
+    name: string;
+    type: string;
+    size: number;
+    mode: number;
+    mtime: number;
+    linkname: string;
+}
+
+function parseOctal(buf: Buffer, start: number, len: number): number {
+
+    // base-256 encoding for big numbers
+    if (buf[start] & 0x80) {
+        let n = buf[start] & 0x7f;
+        for (let i = 1; i < len; i++)
+            n = n * 256 + buf[start + i];
+        return n;
+    }
+
+    const str = buf.toString('ascii', start, start + len).replace(/\0.*$/, '').trim();
+    return str ? parseInt(str, 8) : 0;
+}
+
+function parseCString(buf: Buffer, start: number, len: number): string {
+    const end = buf.indexOf(0, start);
+    return buf.toString('utf8', start, end >= 0 && end < start + len ? end : start + len);
+}
+
+/** parse the pax extended header, such as: '30 path=a/very/long/file/name\n' */
+function parsePax(data: Buffer): { [key: string]: string } {
+    const result: { [key: string]: string } = {};
+    let pos = 0;
+    while (pos < data.length) {
+        const sp = data.indexOf(0x20, pos);
+        if (sp < 0) break;
+        const len = parseInt(data.toString('ascii', pos, sp));
+        if (!(len > 0)) break;
+        const record = data.toString('utf8', sp + 1, pos + len - 1);
+        const eq = record.indexOf('=');
+        if (eq > 0) result[record.substr(0, eq)] = record.substr(eq + 1);
+        pos += len;
+    }
+    return result;
+}
+
+async function extractTar(archivePath: string, outDir: string, gzip: boolean, options?: ExtractOptions): Promise<void> {
+
+    const opts = options || {};
+    const total = fs.statSync(archivePath).size;
+
+    const input = fs.createReadStream(archivePath, { highWaterMark: 1024 * 1024 });
+    const stream: NodeJS.ReadableStream = gzip ? input.pipe(zlib.createGunzip()) : input;
+
+    let compressedDone = 0;
+    input.on('data', (chunk) => compressedDone += chunk.length);
+
+    const links: { header: TarHeader, dest: string }[] = [];
+
+    // state of the parser
+    let pending = Buffer.alloc(0);
+    let header: TarHeader | undefined;
+    let remain = 0;         // data bytes of the current entry
+    let padding = 0;        // padding bytes after the data
+    let output: number | undefined; // fd
+    let outPath = '';
+    let extData: Buffer[] | undefined; // data of a pax or GNU long name header
+    let longName: string | undefined;
+    let longLink: string | undefined;
+    let paxName: string | undefined;
+    let paxLink: string | undefined;
+    let ended = false;
+
+    const finishEntry = () => {
+        if (header == undefined)
+            return;
+        if (output !== undefined) {
+            fs.closeSync(output);
+            output = undefined;
+            const mtime = new Date(header.mtime * 1000);
+            fs.utimesSync(outPath, mtime, mtime);
+            if (process.platform != 'win32')
+                fs.chmodSync(outPath, header.mode & 0o777);
+        }
+        if (extData) {
+            const data = Buffer.concat(extData);
+            extData = undefined;
+            if (header.type == 'L') longName = parseCString(data, 0, data.length);
+            else if (header.type == 'K') longLink = parseCString(data, 0, data.length);
+            else if (header.type == 'x') {
+                const pax = parsePax(data);
+                paxName = pax['path'];
+                paxLink = pax['linkpath'];
+            }
+        }
+        header = undefined;
+    };
+
+    const startEntry = (block: Buffer) => {
+
+        const h: TarHeader = {
+            name: parseCString(block, 0, 100),
+            mode: parseOctal(block, 100, 8),
+            size: parseOctal(block, 124, 12),
+            mtime: parseOctal(block, 136, 12),
+            type: String.fromCharCode(block[156] || 0x30),
+            linkname: parseCString(block, 157, 100)
+        };
+
+        const prefix = block.toString('ascii', 257, 262) == 'ustar' ? parseCString(block, 345, 155) : '';
+        if (prefix) h.name = prefix + '/' + h.name;
+
+        header = h;
+        remain = h.size;
+        padding = (512 - (h.size % 512)) % 512;
+
+        // extended headers, they are applied to the next entry
+        if (h.type == 'L' || h.type == 'K' || h.type == 'x' || h.type == 'g') {
+            extData = h.type == 'g' ? undefined : [];
+            return;
+        }
+
+        h.name = paxName || longName || h.name;
+        h.linkname = paxLink || longLink || h.linkname;
+        paxName = paxLink = longName = longLink = undefined;
+
+        const name = h.name.replace(/^\.\//, '');
+        if (name == '' || (opts.filter && !opts.filter(name)))
+            return;
+
+        const dest = safeJoin(outDir, name);
+
+        switch (h.type) {
+            case '0':
+            case '7':
+                fs.mkdirSync(NodePath.dirname(dest), { recursive: true });
+                try { fs.unlinkSync(dest); } catch (error) { /* not exist */ }
+                output = fs.openSync(dest, 'w');
+                outPath = dest;
+                break;
+            case '5':
+                fs.mkdirSync(dest, { recursive: true });
+                break;
+            case '1':
+            case '2':
+                links.push({ header: h, dest: dest });
+                break;
+            default: // device files, fifo ...
+                break;
+        }
+
+        if (opts.onProgress)
+            opts.onProgress(compressedDone, total, name);
+    };
+
+    const consume = (chunk: Buffer) => {
+
+        let buf = pending.length > 0 ? Buffer.concat([pending, chunk]) : chunk;
+        let pos = 0;
+
+        while (pos < buf.length && !ended) {
+
+            if (remain > 0) {
+                const n = Math.min(remain, buf.length - pos);
+                const data = buf.subarray(pos, pos + n);
+                if (output !== undefined) {
+                    let w = 0;
+                    while (w < n) w += fs.writeSync(output, data, w, n - w);
+                } else if (extData) {
+                    extData.push(Buffer.from(data));
+                }
+                remain -= n;
+                pos += n;
+                continue;
+            }
+
+            if (padding > 0) {
+                const n = Math.min(padding, buf.length - pos);
+                padding -= n;
+                pos += n;
+                continue;
+            }
+
+            finishEntry();
+
+            if (buf.length - pos < 512)
+                break;
+
+            const block = buf.subarray(pos, pos + 512);
+            pos += 512;
+
+            if (block.every(b => b == 0)) {
+                ended = true; // end of archive
+                break;
+            }
+
+            startEntry(block);
+        }
+
+        pending = Buffer.from(buf.subarray(pos));
+    };
+
+    await new Promise<void>((resolve, reject) => {
+
+        let failed = false;
+        const fail = (err: Error) => {
+            if (failed) return;
+            failed = true;
+            input.destroy();
+            if (output !== undefined) { fs.closeSync(output); output = undefined; }
+            reject(err);
+        };
+
+        stream.on('data', (chunk: Buffer) => {
+            if (failed)
+                return;
+            if (opts.isCanceled && opts.isCanceled()) {
+                fail(new Error(`Extraction canceled: '${archivePath}'`));
+                return;
+            }
+            try {
+                consume(chunk);
+            } catch (error) {
+                fail(<Error>error);
+            }
+        });
+
+        stream.on('end', () => {
+            try {
+                finishEntry();
+                if (!ended && (remain > 0 || pending.length > 0))
+                    throw new Error(`Unexpected end of tar file: '${archivePath}'`);
+                resolve();
+            } catch (error) {
+                fail(<Error>error);
+            }
+        });
+
+        stream.on('error', (err: Error) => fail(err));
+        input.on('error', (err) => fail(err));
+    });
+
+    // create links at the end
+    for (const link of links) {
+        try { fs.unlinkSync(link.dest); } catch (error) { /* not exist */ }
+        fs.mkdirSync(NodePath.dirname(link.dest), { recursive: true });
+        if (link.header.type == '2') {
+            checkLinkTarget(outDir, link.dest, link.header.linkname);
+            fs.symlinkSync(link.header.linkname, link.dest);
+        } else {
+            fs.copyFileSync(safeJoin(outDir, link.header.linkname), link.dest);
+        }
+    }
+}
+
+//
+// create a zip file
+//
+
+interface ZipWriteItem {
+    name: string;
+    path: string;
+    isDir: boolean;
+}
+
+function listFiles(dir: string, opts: ZipFileOptions): ZipWriteItem[] {
+
+    const result: ZipWriteItem[] = [];
+
+    const walk = (absDir: string, relDir: string) => {
+        const names = fs.readdirSync(absDir).sort();
+        for (const name of names) {
+            const abs = NodePath.join(absDir, name);
+            const rel = relDir ? `${relDir}/${name}` : name;
+            const isDir = fs.statSync(abs).isDirectory();
+            if (opts.exclude && opts.exclude(rel, isDir))
+                continue;
+            if (isDir) {
+                result.push({ name: rel + '/', path: abs, isDir: true });
+                walk(abs, rel);
+            } else {
+                result.push({ name: rel, path: abs, isDir: false });
+            }
+        }
+    };
+
+    walk(dir, '');
+    return result;
+}
+
+function toDosTime(date: Date): { time: number, date: number } {
+    return {
+        time: (date.getHours() << 11) | (date.getMinutes() << 5) | Math.floor(date.getSeconds() / 2),
+        date: ((Math.max(date.getFullYear(), 1980) - 1980) << 9) | ((date.getMonth() + 1) << 5) | date.getDate()
+    };
+}
+
+/**
+ * Pack the files in a folder into a zip file (deflate), the files are compressed one by one by streams.
+ * Files larger than 4 GB are not supported.
+*/
+export async function zipDirectory(dir: string, outFile: string, options?: ZipFileOptions): Promise<void> {
+
+    const opts = options || {};
+    const items = listFiles(dir, opts);
+
+    let total = 0;
+    const sizes = items.map(it => it.isDir ? 0 : fs.statSync(it.path).size);
+    sizes.forEach(n => total += n);
+
+    const tmpPath = `${outFile}.${process.pid}.tmp`;
+    const fd = fs.openSync(tmpPath, 'w');
+
+    const centrals: Buffer[] = [];
+    let offset = 0;
+    let done = 0;
+
+    const write = (buf: Buffer) => {
+        let w = 0;
+        while (w < buf.length) w += fs.writeSync(fd, buf, w, buf.length - w, offset + w);
+        offset += buf.length;
+    };
+
+    try {
+
+        for (let i = 0; i < items.length; i++) {
+
+            const item = items[i];
+            const name = Buffer.from(item.name);
+            const stat = fs.statSync(item.path);
+            const dos = toDosTime(stat.mtime);
+            const headerOffset = offset;
+
+            // write the local header, the crc and sizes are filled after the data is written
+            const local = Buffer.alloc(30);
+            local.writeUInt32LE(0x04034b50, 0);
+            local.writeUInt16LE(20, 4);
+            local.writeUInt16LE(0x0800, 6); // utf8 name
+            local.writeUInt16LE(item.isDir ? 0 : 8, 8);
+            local.writeUInt16LE(dos.time, 10);
+            local.writeUInt16LE(dos.date, 12);
+            local.writeUInt16LE(name.length, 26);
+            write(local);
+            write(name);
+
+            let crc = 0;
+            let compressedSize = 0;
+            let size = 0;
+
+            if (!item.isDir) {
+                await new Promise<void>((resolve, reject) => {
+                    const input = fs.createReadStream(item.path, { highWaterMark: 256 * 1024 });
+                    const deflate = zlib.createDeflateRaw({ level: opts.level !== undefined ? opts.level : 9 });
+                    input.on('data', (chunk: Buffer) => {
+                        crc = crc32(chunk, crc);
+                        size += chunk.length;
+                        done += chunk.length;
+                        if (opts.onProgress) opts.onProgress(done, total, item.name);
+                    });
+                    deflate.on('data', (chunk: Buffer) => {
+                        write(chunk);
+                        compressedSize += chunk.length;
+                    });
+                    deflate.on('end', () => resolve());
+                    deflate.on('error', reject);
+                    input.on('error', reject);
+                    input.pipe(deflate);
+                });
+            }
+
+            if (offset > 0xffffffff || size > 0xffffffff)
+                throw new Error(`The zip file is too large (> 4 GB): '${outFile}'`);
+
+            const sizeInfo = Buffer.alloc(12);
+            sizeInfo.writeUInt32LE(crc, 0);
+            sizeInfo.writeUInt32LE(compressedSize, 4);
+            sizeInfo.writeUInt32LE(size, 8);
+            fs.writeSync(fd, sizeInfo, 0, 12, headerOffset + 14);
+
+            const central = Buffer.alloc(46);
+            central.writeUInt32LE(0x02014b50, 0);
+            central.writeUInt16LE((process.platform == 'win32' ? 0 : 3) << 8 | 20, 4);
+            central.writeUInt16LE(20, 6);
+            central.writeUInt16LE(0x0800, 8);
+            central.writeUInt16LE(item.isDir ? 0 : 8, 10);
+            central.writeUInt16LE(dos.time, 12);
+            central.writeUInt16LE(dos.date, 14);
+            sizeInfo.copy(central, 16);
+            central.writeUInt16LE(name.length, 28);
+            central.writeUInt32LE(((process.platform == 'win32' ? 0 : stat.mode) << 16 | (item.isDir ? 0x10 : 0)) >>> 0, 38);
+            central.writeUInt32LE(headerOffset, 42);
+            centrals.push(central, name);
+        }
+
+        const cd = Buffer.concat(centrals);
+        const cdOffset = offset;
+        write(cd);
+
+        if (items.length > 0xffff)
+            throw new Error(`Too many files for a zip file (> 65535): '${outFile}'`);
+
+        const eocd = Buffer.alloc(22);
+        eocd.writeUInt32LE(0x06054b50, 0);
+        eocd.writeUInt16LE(items.length, 8);
+        eocd.writeUInt16LE(items.length, 10);
+        eocd.writeUInt32LE(cd.length, 12);
+        eocd.writeUInt32LE(cdOffset, 16);
+        write(eocd);
+
+    } catch (error) {
+        fs.closeSync(fd);
+        try { fs.unlinkSync(tmpPath); } catch (err) { /* not exist */ }
+        throw error;
+    }
+
+    fs.closeSync(fd);
+    fs.renameSync(tmpPath, outFile);
+}
+
+//
+// hash
+//
+
+export function hashFileSync(path: string, algorithm: string): string {
+    const hash = crypto.createHash(algorithm);
+    const fd = fs.openSync(path, 'r');
+    try {
+        const buf = Buffer.alloc(1024 * 1024);
+        let n: number;
+        while ((n = fs.readSync(fd, buf, 0, buf.length, null)) > 0)
+            hash.update(buf.subarray(0, n));
+    } finally {
+        fs.closeSync(fd);
+    }
+    return hash.digest('hex');
+}
+
+export function hashFile(path: string, algorithm: string): Promise<string> {
+    return new Promise((resolve, reject) => {
+        const hash = crypto.createHash(algorithm);
+        fs.createReadStream(path, { highWaterMark: 1024 * 1024 })
+            .on('data', (chunk) => hash.update(chunk))
+            .on('end', () => resolve(hash.digest('hex')))
+            .on('error', reject);
+    });
+}
@@ -0,0 +1,626 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+import * as NodePath from 'path';
+import * as crypto from 'crypto';
+
+import { hashFileSync } from './ArchiveEngine';
+
+/*
+ * Layout of the store folder:
+ *
+ *  - blobs/<hash[0:2]>/<hash>/<name>  the content of the artifacts, the hash is the sha256 of the content,
+ *                                    the name of the first added file is kept for the tools which need it
+ *  - index.json                sizes and holders of the blobs, aliases of the blobs
+ *  - store.lock                the lock of the index, it's shared by all vscode windows
+ *  - tmp/                      files in writing, they are renamed into 'blobs' when done
+ *
+ * The last access time of a blob is the mtime of the blob file, so a read never rewrites the index.
+*/
+
+const INDEX_VERSION = '1.0';
+
+export interface ArtifactStoreOptions {
+
+    /** disk budget in bytes, blobs which are not held are evicted in LRU order over it. 0: no limit */
+    maxSize?: number;
+
+    /** max time to wait for the lock of another window, default: 10s */
+    lockTimeout?: number;
+
+    /**
+     * a lock older than it is left by a crashed process and is broken, default: 5s,
+     * it must be shorter than `lockTimeout`, so a waiter breaks the lock instead of timing out,
+     * the lock is only held while the index is read and written
+    */
+    staleLockTime?: number;
+}
+
+export interface PutOptions {
+
+    /** the alias of the artifact, an old alias with the same name is replaced */
+    alias?: string;
+
+    /** user data of the alias */
+    meta?: { [key: string]: any };
+
+    /** hold the artifact, it's not evicted until it's released by the holder */
+    holder?: string;
+
+    /** move the source file into the store instead of copy it (putFile only) */
+    move?: boolean;
+
+    /** file name of the blob, default: the name of the source file or the alias */
+    fileName?: string;
+}
+
+export interface ArtifactInfo {
+    hash: string;
+    path: string;
+    size: number;
+    refs: number;
+}
+
+export interface ArtifactAlias extends ArtifactInfo {
+    name: string;
+    meta: { [key: string]: any };
+    time: number;
+}
+
+interface BlobRecord {
+    size: number;
+    refs: string[];
+    file: string;
+}
+
+interface AliasRecord {
+    hash: string;
+    time: number;
+    meta?: { [key: string]: any };
+}
+
+interface StoreIndex {
+    version: string;
+    blobs: { [hash: string]: BlobRecord };
+    aliases: { [name: string]: AliasRecord };
+}
+
+function sleepSync(ms: number) {
+    Atomics.wait(new Int32Array(new SharedArrayBuffer(4)), 0, 0, ms);
+}
+
+/**
+ * A content-addressed file store shared by all projects and vscode windows.
+ * All changes of the index are done under a lock file, files are written to a temp file and renamed.
+*/
+export class ArtifactStore {
+
+    private root: string;
+    private indexPath: string;
+    private lockPath: string;
+    private options: ArtifactStoreOptions;
+
+    private index: StoreIndex = { version: INDEX_VERSION, blobs: {}, aliases: {} };
+    private indexStamp: string = '';
+    private lockDepth: number = 0;
+
+    constructor(root: string, options?: ArtifactStoreOptions) {
+        this.root = root;
+        this.indexPath = NodePath.join(root, 'index.json');
+        this.lockPath = NodePath.join(root, 'store.lock');
+        this.options = options || {};
+        fs.mkdirSync(NodePath.join(root, 'tmp'), { recursive: true });
+        this.removeStaleTempFiles();
+    }
+
+    get rootPath(): string {
+        return this.root;
+    }
+
+    setMaxSize(maxSize: number) {
+        this.options.maxSize = maxSize;
+    }
+
+    private blobPath(hash: string, fileName: string): string {
+        return NodePath.join(this.root, 'blobs', hash.substr(0, 2), hash, fileName);
+    }
+
+    // ---------- read ----------
+
+    /**
+     * Get an artifact by the sha256 of the content, it's marked as recently used
+    */
+    get(hash: string): ArtifactInfo | undefined {
+        this.reload();
+        return this.access(hash.toLowerCase());
+    }
+
+    /**
+     * Get an artifact by the alias, it's marked as recently used
+    */
+    resolve(name: string): ArtifactAlias | undefined {
+
+        this.reload();
+
+        const alias = this.index.aliases[name];
+        if (alias == undefined)
+            return undefined;
+
+        const info = this.access(alias.hash);
+        if (info == undefined)
+            return undefined;
+
+        return { ...info, name: name, meta: alias.meta || {}, time: alias.time };
+    }
+
+    getUsage(): { count: number, size: number } {
+        this.reload();
+        let size = 0;
+        const hashes = Object.keys(this.index.blobs);
+        hashes.forEach((h) => size += this.index.blobs[h].size);
+        return { count: hashes.length, size: size };
+    }
+
+    // ---------- write ----------
+
+    /**
+     * Add a file, the hash is computed while it's copied. The file is stored only once for the same content
+    */
+    putFile(srcPath: string, options?: PutOptions): ArtifactInfo {
+
+        const opts = options || {};
+
+        // it's a blob of this store, no need to copy it
+        const blobsDir = NodePath.join(this.root, 'blobs') + NodePath.sep;
+        if (NodePath.resolve(srcPath).startsWith(blobsDir)) {
+            const blobHash = NodePath.basename(NodePath.dirname(srcPath));
+            return this.commit(this.newTempPath(), blobHash, fs.statSync(srcPath).size, opts);
+        }
+
+        const tmpPath = this.newTempPath();
+        let hash: string;
+        let size: number;
+
+        try {
+            if (opts.move) {
+                hash = hashFileSync(srcPath, 'sha256');
+                size = fs.statSync(srcPath).size;
+                try {
+                    fs.renameSync(srcPath, tmpPath);
+                } catch (error) { // not the same device
+                    copyFile(srcPath, tmpPath);
+                    fs.unlinkSync(srcPath);
+                }
+            } else {
+                const res = copyFile(srcPath, tmpPath);
+                hash = res.hash;
+                size = res.size;
+            }
+        } catch (error) {
+            removeFile(tmpPath);
+            throw error;
+        }
+
+        return this.commit(tmpPath, hash, size, { fileName: NodePath.basename(srcPath), ...opts });
+    }
+
+    putData(data: Buffer | string, options?: PutOptions): ArtifactInfo {
+        const buf = typeof data == 'string' ? Buffer.from(data) : data;
+        const tmpPath = this.newTempPath();
+        fs.writeFileSync(tmpPath, buf);
+        const opts = options || {};
+        return this.commit(tmpPath, crypto.createHash('sha256').update(buf).digest('hex'), buf.length, { fileName: NodePath.basename(opts.alias || 'data'), ...opts });
+    }
+
+    setAlias(name: string, hash: string, meta?: { [key: string]: any }) {
+        this.transaction((index) => {
+            if (index.blobs[hash] == undefined)
+                throw new Error(`Not found artifact: '${hash}'`);
+            const old = index.aliases[name];
+            index.aliases[name] = { hash: hash, time: Date.now(), meta: meta };
+            if (old) this.dropOrphan(index, old.hash);
+            return true;
+        });
+    }
+
+    removeAlias(name: string) {
+        this.transaction((index) => {
+            const old = index.aliases[name];
+            if (old == undefined)
+                return false;
+            delete index.aliases[name];
+            this.dropOrphan(index, old.hash);
+            return true;
+        });
+    }
+
+    /**
+     * Hold an artifact, the holder is an unique id (a project path for example),
+     * hold it again with the same holder is ignored.
+     * A holder which is an absolute path is dropped when the path is deleted
+    */
+    acquire(hash: string, holder: string) {
+        this.transaction((index) => {
+            const blob = index.blobs[hash];
+            if (blob == undefined)
+                throw new Error(`Not found artifact: '${hash}'`);
+            if (blob.refs.includes(holder))
+                return false;
+            blob.refs.push(holder);
+            return true;
+        });
+    }
+
+    release(hash: string, holder: string) {
+        this.transaction((index) => {
+            const blob = index.blobs[hash];
+            if (blob == undefined || !blob.refs.includes(holder))
+                return false;
+            blob.refs = blob.refs.filter((r) => r != holder);
+            this.evictOver(index, this.options.maxSize);
+            return true;
+        });
+    }
+
+    /**
+     * Release all artifacts held by the holder
+    */
+    releaseAll(holder: string) {
+        this.transaction((index) => {
+            let changed = false;
+            for (const hash in index.blobs) {
+                const blob = index.blobs[hash];
+                if (blob.refs.includes(holder)) {
+                    blob.refs = blob.refs.filter((r) => r != holder);
+                    changed = true;
+                }
+            }
+            if (changed)
+                this.evictOver(index, this.options.maxSize);
+            return changed;
+        });
+    }
+
+    /**
+     * Evict the least recently used artifacts which are not held until the total size is under the budget
+     * @param maxSize default: the budget of the store
+     * @returns hashes of the evicted artifacts
+    */
+    evict(maxSize?: number): string[] {
+        let removed: string[] = [];
+        this.transaction((index) => {
+            removed = this.evictOver(index, maxSize != undefined ? maxSize : this.options.maxSize, true);
+            return removed.length > 0;
+        });
+        return removed;
+    }
+
+    // ---------- internal ----------
+
+    private commit(tmpPath: string, hash: string, size: number, opts: PutOptions): ArtifactInfo {
+
+        const result: ArtifactInfo[] = [];
+
+        try {
+            this.transaction((index) => {
+
+                let blob = index.blobs[hash];
+                let dest = blob ? this.blobPath(hash, blob.file) : '';
+
+                if (blob && fs.existsSync(dest) && fs.statSync(dest).size == size) { // same content, reuse it
+                    touchFile(dest);
+                } else {
+                    blob = index.blobs[hash] = { size: size, refs: blob ? blob.refs : [], file: safeFileName(opts.fileName) };
+                    dest = this.blobPath(hash, blob.file);
+                    fs.mkdirSync(NodePath.dirname(dest), { recursive: true });
+                    fs.renameSync(tmpPath, dest);
+                }
+
+                if (opts.holder && !blob.refs.includes(opts.holder))
+                    blob.refs.push(opts.holder);
+
+                if (opts.alias) {
+                    const old = index.aliases[opts.alias];
+                    index.aliases[opts.alias] = { hash: hash, time: Date.now(), meta: opts.meta };
+                    if (old) this.dropOrphan(index, old.hash);
+                }
+
+                this.evictOver(index, this.options.maxSize, false, hash);
+
+                result.push({ hash: hash, path: dest, size: size, refs: blob.refs.length });
+                return true;
+            });
+        } finally {
+            removeFile(tmpPath);
+        }
+
+        return result[0];
+    }
+
+    private access(hash: string): ArtifactInfo | undefined {
+
+        const blob = this.index.blobs[hash];
+        if (blob == undefined)
+            return undefined;
+
+        const path = this.blobPath(hash, blob.file);
+        if (!touchFile(path)) // deleted by user
+            return undefined;
+
+        return { hash: hash, path: path, size: blob.size, refs: blob.refs.length };
+    }
+
+    /**
+     * Delete the old content of a replaced alias if nothing uses it
+    */
+    private dropOrphan(index: StoreIndex, hash: string) {
+
+        const blob = index.blobs[hash];
+        if (blob == undefined || blob.refs.length > 0)
+            return;
+
+        for (const name in index.aliases) {
+            if (index.aliases[name].hash == hash)
+                return;
+        }
+
+        if (removeBlob(this.blobPath(hash, blob.file)))
+            delete index.blobs[hash];
+    }
+
+    /**
+     * @param prune also drop the index records of the deleted blob files
+     * @param keep the blob which is just added
+    */
+    private evictOver(index: StoreIndex, maxSize: number | undefined, prune?: boolean, keep?: string): string[] {
+
+        const removed: string[] = [];
+        const candidates: { hash: string, path: string, size: number, atime: number }[] = [];
+        let total = 0;
+
+        for (const hash in index.blobs) {
+            const blob = index.blobs[hash];
+            let atime: number;
+            try {
+                atime = fs.statSync(this.blobPath(hash, blob.file)).mtimeMs;
+            } catch (error) {
+                if (prune) {
+                    delete index.blobs[hash];
+                    removed.push(hash);
+                }
+                continue;
+            }
+            total += blob.size;
+            // the holder folder is deleted without release
+            blob.refs = blob.refs.filter((r) => !NodePath.isAbsolute(r) || fs.existsSync(r));
+            if (blob.refs.length == 0 && hash != keep)
+                candidates.push({ hash: hash, path: this.blobPath(hash, blob.file), size: blob.size, atime: atime });
+        }
+
+        if (maxSize && total > maxSize) {
+            candidates.sort((a, b) => a.atime - b.atime);
+            for (const c of candidates) {
+                if (total <= maxSize)
+                    break;
+                if (removeBlob(c.path)) {
+                    delete index.blobs[c.hash];
+                    removed.push(c.hash);
+                    total -= c.size;
+                }
+            }
+        }
+
+        if (removed.length > 0) {
+            for (const name in index.aliases) {
+                if (index.blobs[index.aliases[name].hash] == undefined)
+                    delete index.aliases[name];
+            }
+        }
+
+        return removed;
+    }
+
+    /**
+     * Lock the store, reload the index, modify it and save it if `fn` returns true
+    */
+    private transaction(fn: (index: StoreIndex) => boolean) {
+
+        this.lock();
+
+        try {
+            this.reload();
+            if (fn(this.index))
+                this.save();
+        } finally {
+            this.unlock();
+        }
+    }
+
+    private reload() {
+
+        let stamp: string;
+        try {
+            const st = fs.statSync(this.indexPath);
+            stamp = `${st.mtimeMs}:${st.size}:${st.ino}`;
+        } catch (error) {
+            stamp = '';
+        }
+
+        if (stamp == this.indexStamp)
+            return;
+
+        let index: StoreIndex | undefined;
+        if (stamp) {
+            try {
+                index = JSON.parse(fs.readFileSync(this.indexPath, 'utf8'));
+            } catch (error) {
+                // broken index, the blobs are lost
+            }
+        }
+
+        this.index = index && index.version == INDEX_VERSION ? index : { version: INDEX_VERSION, blobs: {}, aliases: {} };
+        this.indexStamp = stamp;
+    }
+
+    private save() {
+        const tmpPath = this.newTempPath();
+        fs.writeFileSync(tmpPath, JSON.stringify(this.index));
+        fs.renameSync(tmpPath, this.indexPath);
+        const st = fs.statSync(this.indexPath);
+        this.indexStamp = `${st.mtimeMs}:${st.size}:${st.ino}`;
+    }
+
+    private lock() {
+
+        if (this.lockDepth++ > 0)
+            return;
+
+        const timeout = this.options.lockTimeout || 10 * 1000;
+        const staleTime = this.options.staleLockTime || 5 * 1000;
+        const start = Date.now();
+
+        for (;;) {
+
+            try {
+                fs.writeFileSync(this.lockPath, `${process.pid}`, { flag: 'wx' });
+                return;
+            } catch (error) {
+                if ((<NodeJS.ErrnoException>error).code != 'EEXIST') {
+                    this.lockDepth--;
+                    throw error;
+                }
+            }
+
+            try {
+                if (Date.now() - fs.statSync(this.lockPath).mtimeMs > staleTime) {
+                    removeFile(this.lockPath);
+                    continue;
+                }
+            } catch (error) {
+                continue; // unlocked
+            }
+
+            if (Date.now() - start > timeout) {
+                this.lockDepth--;
+                throw new Error(`Timeout to lock the artifact store: '${this.root}', delete '${this.lockPath}' if no vscode is running`);
+            }
+
+            sleepSync(20);
+        }
+    }
+
+    private unlock() {
+        if (--this.lockDepth == 0)
+            removeFile(this.lockPath);
+    }
+
+    /**
+     * Temp files left by a crashed process
+    */
+    private removeStaleTempFiles() {
+        const tmpDir = NodePath.join(this.root, 'tmp');
+        for (const name of fs.readdirSync(tmpDir)) {
+            const path = NodePath.join(tmpDir, name);
+            try {
+                if (Date.now() - fs.statSync(path).mtimeMs > 3600 * 1000)
+                    fs.unlinkSync(path);
+            } catch (error) {
+                // in use
+            }
+        }
+    }
+
+    private newTempPath(): string {
+        return NodePath.join(this.root, 'tmp', `${process.pid}-${crypto.randomBytes(6).toString('hex')}`);
+    }
+}
+
+/**
+ * Copy a file and compute the sha256 in one pass
+*/
+function copyFile(src: string, dest: string): { hash: string, size: number } {
+
+    const hash = crypto.createHash('sha256');
+    const buf = Buffer.alloc(1024 * 1024);
+    const fdIn = fs.openSync(src, 'r');
+    let size = 0;
+
+    try {
+        const fdOut = fs.openSync(dest, 'w');
+        try {
+            let n: number;
+            while ((n = fs.readSync(fdIn, buf, 0, buf.length, null)) > 0) {
+                const chunk = buf.subarray(0, n);
+                hash.update(chunk);
+                fs.writeSync(fdOut, chunk);
+                size += n;
+            }
+        } finally {
+            fs.closeSync(fdOut);
+        }
+    } finally {
+        fs.closeSync(fdIn);
+    }
+
+    return { hash: hash.digest('hex'), size: size };
+}
+
+function safeFileName(name: string | undefined): string {
+    const res = (name || '').replace(/[<>:"/\\|?*\x00-\x1f]/g, '_').replace(/^\.+$/, '_');
+    return res || 'data';
+}
+
+/**
+ * Delete a blob file and its folder, return true if it's deleted or not exist
+*/
+function removeBlob(path: string): boolean {
+    if (!removeFile(path) && fs.existsSync(path))
+        return false;
+    try {
+        fs.rmdirSync(NodePath.dirname(path));
+    } catch (error) {
+        // not empty
+    }
+    return true;
+}
+
+function touchFile(path: string): boolean {
+    try {
+        const now = new Date();
+        fs.utimesSync(path, now, now);
+        return true;
+    } catch (error) {
+        return false;
+    }
+}
+
+function removeFile(path: string): boolean {
+    try {
+        fs.unlinkSync(path);
+        return true;
+    } catch (error) {
+        return false;
+    }
+}
@@ -0,0 +1,309 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as NodePath from 'path';
+
+/** file name of the bulk import report, it's placed in the root folder of the import */
+export const BULK_IMPORT_REPORT_FILE_NAME = 'eide.import.report.txt';
+
+export const BULK_IMPORT_DEF_CONCURRENCY = 4;
+
+export type BulkImportType = 'mdk' | 'iar' | 'eclipse';
+
+export interface BulkImportItem {
+
+    type: BulkImportType;
+
+    /** '.uvprojx', '.uvproj', '.eww' or '.cproject' */
+    projectFile: string;
+}
+
+export interface BulkImportSkipped {
+    path: string;
+    reason: string;
+}
+
+/**
+ * Collects the result of a headless import, no ui is shown by the importer when it's given
+*/
+export interface HeadlessImportReport {
+
+    warnings: string[];
+
+    /** workspace file of the imported project, the first one for a IAR workbench */
+    workspaceFile?: string;
+}
+
+export interface BulkVerifyResult {
+    success: boolean;
+    message: string;
+}
+
+export interface BulkImportResult {
+
+    item: BulkImportItem;
+
+    success: boolean;
+
+    warnings: string[];
+
+    /** time used by the import and the verification (ms) */
+    duration: number;
+
+    workspaceFile?: string;
+
+    error?: string;
+
+    /** result of the dry-run build, only if it's enabled */
+    verify?: BulkVerifyResult;
+}
+
+export interface BulkImportReport {
+
+    rootDir: string;
+
+    /** unix time (ms) */
+    startTime: number;
+
+    /** time used by the whole run (ms) */
+    duration: number;
+
+    concurrency: number;
+
+    results: BulkImportResult[];
+
+    skipped: BulkImportSkipped[];
+
+    imported: number;
+
+    failed: number;
+}
+
+export interface BulkImportOptions {
+
+    /** max number of projects imported at the same time */
+    concurrency?: number;
+
+    /** called when a project is done */
+    onProjectDone?: (result: BulkImportResult, done: number, total: number) => void;
+}
+
+const SKIP_DIR_MATCHER = /^(\..*|node_modules)$/;
+
+/**
+ * Find the projects which can be imported in a folder tree.
+ *
+ * The importers write '.eide' next to the project file, so only one project is taken in a folder,
+ * the folders which already have an eide project are skipped unless `force` is set.
+ * The IAR projects ('.ewp') are imported by their workbench ('.eww').
+*/
+export function scanImportableProjects(rootDir: string, force?: boolean): { items: BulkImportItem[], skipped: BulkImportSkipped[] } {
+
+    const items: BulkImportItem[] = [];
+    const skipped: BulkImportSkipped[] = [];
+    const stack: string[] = [rootDir];
+
+    while (stack.length > 0) {
+
+        const dir = <string>stack.pop();
+
+        let entries: fs.Dirent[];
+        try {
+            entries = fs.readdirSync(dir, { withFileTypes: true });
+        } catch (error) {
+            skipped.push({ path: dir, reason: `can not read folder: ${(<Error>error).message}` });
+            continue;
+        }
+
+        const names = new Set(entries.filter(e => e.isFile()).map(e => e.name));
+        const found: BulkImportItem[] = [];
+
+        for (const name of Array.from(names).sort()) {
+            const path = NodePath.join(dir, name);
+            if (/\.uvprojx$/i.test(name)) {
+                found.push({ type: 'mdk', projectFile: path });
+            } else if (/\.uvproj$/i.test(name)) {
+                // MDK keeps the old '.uvproj' after the project is migrated
+                if (!names.has(name + 'x'))
+                    found.push({ type: 'mdk', projectFile: path });
+            } else if (/\.eww$/i.test(name)) {
+                found.push({ type: 'iar', projectFile: path });
+            } else if (name == '.cproject') {
+                if (names.has('.project'))
+                    found.push({ type: 'eclipse', projectFile: path });
+                else
+                    skipped.push({ path, reason: `not found '.project' of the eclipse project` });
+            }
+        }
+
+        if (found.length > 0) {
+            if (!force && fs.existsSync(NodePath.join(dir, '.eide', 'eide.yml'))) {
+                found.forEach(item => skipped.push({ path: item.projectFile, reason: 'already imported' }));
+            } else {
+                items.push(found[0]);
+                found.slice(1).forEach(item => skipped.push({
+                    path: item.projectFile,
+                    reason: `'${NodePath.basename(found[0].projectFile)}' is imported in the same folder`
+                }));
+            }
+        }
+
+        entries
+            .filter(e => e.isDirectory() && !SKIP_DIR_MATCHER.test(e.name))
+            .map(e => NodePath.join(dir, e.name))
+            .sort()
+            .reverse()
+            .forEach(d => stack.push(d));
+    }
+
+    return { items, skipped };
+}
+
+/**
+ * Import the projects in parallel, at most `concurrency` projects are imported at the same time.
+ *
+ * @param importProject import a project, a thrown error fails the project but not the others
+*/
+export async function runBulkImport(rootDir: string, items: BulkImportItem[],
+    importProject: (item: BulkImportItem, report: HeadlessImportReport) => Promise<BulkVerifyResult | void>,
+    skipped: BulkImportSkipped[], options?: BulkImportOptions): Promise<BulkImportReport> {
+
+    const opts = options || {};
+    const concurrency = Math.max(1, Math.min(opts.concurrency || BULK_IMPORT_DEF_CONCURRENCY, items.length || 1));
+
+    const startTime = Date.now();
+    const results: BulkImportResult[] = new Array(items.length);
+    let next = 0;
+    let done = 0;
+
+    const worker = async () => {
+        while (next < items.length) {
+
+            const idx = next++;
+            const item = items[idx];
+            const report: HeadlessImportReport = { warnings: [] };
+            const result: BulkImportResult = { item, success: false, warnings: report.warnings, duration: 0 };
+            const t0 = Date.now();
+
+            try {
+                const verify = await importProject(item, report);
+                result.workspaceFile = report.workspaceFile;
+                result.success = true;
+                if (verify) {
+                    result.verify = verify;
+                    result.success = verify.success;
+                }
+            } catch (error) {
+                result.error = (<Error>error).message || String(error);
+            }
+
+            result.duration = Date.now() - t0;
+            results[idx] = result;
+
+            done++;
+            if (opts.onProjectDone) {
+                opts.onProjectDone(result, done, items.length);
+            }
+        }
+    };
+
+    const workers: Promise<void>[] = [];
+    for (let i = 0; i < concurrency; i++) {
+        workers.push(worker());
+    }
+    await Promise.all(workers);
+
+    const imported = results.filter(r => r.success).length;
+
+    return {
+        rootDir,
+        startTime,
+        duration: Date.now() - startTime,
+        concurrency,
+        results,
+        skipped,
+        imported,
+        failed: results.length - imported
+    };
+}
+
+/**
+ * Make a text report: a summary table, then the warnings and errors of each project
+*/
+export function formatBulkImportReport(report: BulkImportReport): string {
+
+    const lines: string[] = [];
+    const secs = (ms: number) => (ms / 1000).toFixed(1) + 's';
+    const relPath = (p: string) => NodePath.relative(report.rootDir, p) || p;
+    const warnings = report.results.reduce((sum, r) => sum + r.warnings.length, 0);
+
+    lines.push(`Bulk Import Report: ${report.rootDir}`);
+    lines.push(`Time: ${new Date(report.startTime).toLocaleString()}, Duration: ${secs(report.duration)}, Concurrency: ${report.concurrency}`);
+    lines.push(`Result: ${report.imported} imported, ${report.failed} failed, ${report.skipped.length} skipped, ${warnings} warnings`);
+    lines.push('');
+
+    lines.push(`Result  Type     Warns  Time     Project`);
+    for (const r of report.results) {
+        const state = r.success ? 'OK' : (r.verify && !r.verify.success ? 'VERIFY' : 'FAIL');
+        lines.push([
+            state.padEnd(6),
+            r.item.type.padEnd(7),
+            r.warnings.length.toString().padEnd(5),
+            secs(r.duration).padEnd(7),
+            relPath(r.item.projectFile)
+        ].join('  '));
+    }
+
+    for (const r of report.results) {
+
+        if (r.success && r.warnings.length == 0)
+            continue;
+
+        lines.push('');
+        lines.push(`=== ${relPath(r.item.projectFile)} ===`);
+
+        if (r.error)
+            lines.push(`error: ${r.error}`);
+
+        for (const w of r.warnings)
+            lines.push(`warning: ${w.replace(/\r?\n/g, os.EOL + '    ')}`);
+
+        if (r.verify && !r.verify.success) {
+            const log = r.verify.message.split(/\r?\n/).filter(l => l.trim() != '');
+            lines.push(`dry-run build failed:`);
+            log.slice(-20).forEach(l => lines.push(`    ${l}`));
+        }
+    }
+
+    if (report.skipped.length > 0) {
+        lines.push('');
+        lines.push('=== skipped ===');
+        for (const s of report.skipped)
+            lines.push(`${relPath(s.path)}: ${s.reason}`);
+    }
+
+    return lines.join(os.EOL) + os.EOL;
+}
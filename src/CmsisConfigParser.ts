@@ -101,278 +101,562 @@ export interface CmsisConfiguration {
     items: CmsisConfigItem[];
 };
 
+/**
+ * a children list is changed, like 'Array.splice'
+ * 'path' is the index path of the parent item, an empty path is the top level list
+*/
+export interface CmsisConfigSplice {
+
+    path: number[];
+
+    start: number;
+
+    deleteCount: number;
+
+    items: CmsisConfigItem[];
+};
+
+/**
+ * the minimal update of a configuration after a text change,
+ * apply 'lines', then 'shift', then 'splices' in order
+*/
+export interface CmsisConfigUpdate {
+
+    // the text change, 'lines' are the original (untrimmed) lines
+    lines: { start: number, deleteCount: number, lines: string[] };
+
+    // all line numbers of the items which >= 'line' are moved by 'delta'
+    shift?: { line: number, delta: number };
+
+    splices: CmsisConfigSplice[];
+
+    // the wizard section is changed, the whole configuration is re-parsed
+    reset?: boolean;
+};
+
 export function parse(lines: string[]): CmsisConfiguration | undefined {
+    return new CmsisConfigDocument(lines).getConfiguration();
+}
 
-    // rm whitespace for line
-    lines = lines.map((line) => line.trimEnd());
+/**
+ * A parsed config header which can be updated by text changes.
+ *
+ * The wizard section is split into spans, a span begins at a line which creates a new element
+ * (not a group), the parser state before this line is saved in the span. A text change only
+ * re-parses the spans from the changed line, until the state is synced with an old span again.
+ * The C defines are matched with indexes, and only the items whose matched value is changed are updated.
+*/
+export class CmsisConfigDocument {
 
-    let startIdx = -1, endIdx = -1;
-    {
-        // The Configuration Wizard section must begin within the first 100 lines of code and must start with the following comment line:
-        //  '// <<< Use Configuration Wizard in Context Menu >>>'
-        for (let idx = 0; idx < Math.min(200, lines.length); idx++) {
-            const line = lines[idx].toLowerCase();
-            if (line.indexOf('<<< use configuration wizard in context menu >>>') != -1) {
-                startIdx = idx;
-                break;
+    private lines: string[];
+
+    private startIdx: number = -1;
+    private endIdx: number = -1;
+    private hasEndTag: boolean = false;
+
+    private items: CmsisConfigItem[] = [];
+    private spans: ParseSpan[] = [];
+
+    private owners: Map<CmsisConfigItem, ParseSpan> = new Map();
+    private parents: Map<CmsisConfigItem, CmsisConfigItem | undefined> = new Map();
+    private records: Map<CmsisConfigItem, MatchRecord> = new Map();
+    private failed: Set<CmsisConfigItem> = new Set();
+    private namedItems: Map<string, Set<CmsisConfigItem>> = new Map();
+    private maxSkip: number = 0;
+
+    // all C defines in line order, and the defines of a name
+    private macros: MacroItem[] = [];
+    private macroNames: Map<string, MacroItem[]> = new Map();
+
+    constructor(lines: string[]) {
+        this.lines = lines.slice();
+        this.rebuild();
+    }
+
+    getConfiguration(): CmsisConfiguration | undefined {
+        return this.startIdx == -1 ? undefined : { items: this.items };
+    }
+
+    getLines(): string[] {
+        return this.lines;
+    }
+
+    /**
+     * replace 'deleteCount' lines at 'start' by 'newLines'
+    */
+    applyChange(start: number, deleteCount: number, newLines: string[]): CmsisConfigUpdate {
+
+        start = Math.max(0, Math.min(start, this.lines.length));
+        deleteCount = Math.max(0, Math.min(deleteCount, this.lines.length - start));
+
+        const oldEnd = start + deleteCount;
+        const delta = newLines.length - deleteCount;
+
+        const update: CmsisConfigUpdate = {
+            lines: { start: start, deleteCount: deleteCount, lines: newLines },
+            splices: []
+        };
+
+        // the wizard tags are changed, re-parse all
+        if (this.startIdx == -1 ||
+            newLines.some((line) => isWizardTag(line)) ||
+            (start <= this.startIdx && this.startIdx < oldEnd) ||
+            (this.hasEndTag && start <= this.endIdx && this.endIdx < oldEnd) ||
+            (oldEnd <= this.startIdx && this.startIdx + delta >= WIZARD_START_MAX_LINE)) {
+            spliceArray(this.lines, start, deleteCount, newLines);
+            this.rebuild();
+            update.reset = true;
+            return update;
+        }
+
+        const inSection = start > this.startIdx && (!this.hasEndTag || start <= this.endIdx);
+
+        // find the span to re-parse and the first span which may be synced (old line index)
+        // the lines at the beginning of a span may be a part of the previous span after the change
+        let k = 0, j = 0, first = this.startIdx + 1;
+        if (inSection) {
+            k = Math.max(0, this.findSpan((span) => span.start > start) - 1);
+            if (k > 0 && this.spans[k].start == start)
+                k--;
+            j = Math.max(k + 1, this.findSpan((span) => span.start >= oldEnd));
+            if (k < this.spans.length)
+                first = this.spans[k].start;
+        }
+
+        spliceArray(this.lines, start, deleteCount, newLines);
+
+        if (delta != 0) {
+            update.shift = { line: oldEnd, delta: delta };
+            this.shiftLines(oldEnd, delta);
+        }
+
+        if (!this.hasEndTag)
+            this.endIdx = this.lines.length - 1;
+
+        if (!inSection) {
+            update.splices = this.matchItems([], this.failed);
+            return update;
+        }
+
+        const entry: ParseSpan | undefined = this.spans[k];
+
+        // the new items of the open groups are put into empty lists, then they replace the old items
+        const containers = (<(CmsisConfigItem | undefined)[]>[undefined]).concat(entry ? entry.grp_stack : []).map((grp) => {
+            const list = grp ? grp.children : this.items;
+            const start = lowerBound(list, (item) => this.getOwner(item).start >= first);
+            if (grp) grp.children = [];
+            return { grp: grp, list: list, start: start };
+        });
+
+        // a failed section is changed to 'notice', but its end tag is matched by the type when parsing
+        const failed = entry ? entry.grp_stack.filter((grp) => this.failed.has(grp)) : [];
+        failed.forEach((grp) => grp.type = (<MatchRecord>this.records.get(grp)).type);
+
+        const topItems: CmsisConfigItem[] = [];
+        const res = this.parseSpans(newParserContext(topItems, entry), first, j);
+
+        failed.forEach((grp) => grp.type = 'notice');
+
+        const removed = this.spans.slice(k, res.synced);
+        const removedSpans = new Set(removed);
+        this.spans.splice(k, res.synced - k, ...res.spans);
+
+        for (const c of containers) {
+            const added = c.grp ? c.grp.children : topItems;
+            let count = 0;
+            while (c.start + count < c.list.length && removedSpans.has(this.getOwner(c.list[c.start + count])))
+                count++;
+            if (c.grp)
+                c.grp.children = c.list;
+            if (added.length > 0 || count > 0) {
+                spliceArray(c.list, c.start, count, added);
+                update.splices.push({
+                    path: this.getPath(c.grp),
+                    start: c.start,
+                    deleteCount: count,
+                    items: added
+                });
             }
         }
 
-        // The Configuration Wizard section can end with the following optional comment:
-        //  '// <<< end of configuration section >>>'
-        if (startIdx != -1) {
-            for (let idx = startIdx + 1; idx < lines.length; idx++) {
-                const line = lines[idx].toLowerCase();
-                if (line.indexOf('<<< end of configuration section >>>') != -1) {
-                    endIdx = idx;
+        for (const span of removed) {
+            for (const item of span.items) {
+                this.owners.delete(item);
+                this.parents.delete(item);
+                this.deleteRecord(item);
+            }
+        }
+
+        const macroChange = this.updateMacros(first, removed, res.spans);
+
+        // the old items which may be matched to other defines:
+        //  - the items which use the changed names
+        //  - the items before the changed range, whose next defines may be changed
+        const check = new Set(this.failed);
+
+        for (const name of macroChange.names) {
+            this.namedItems.get(name)?.forEach((item) => check.add(item));
+        }
+
+        const bound = macroChange.index - 1 - this.maxSkip;
+        const minLine = bound >= 0 ? this.macros[bound].line_idx : -1;
+        for (let i = k - 1, done = false; i >= 0 && !done; i--) {
+            const items = this.spans[i].items;
+            for (let n = items.length - 1; n >= 0; n--) {
+                const item = items[n];
+                if (item.type == 'group')
+                    continue;
+                if (item.line_idx < minLine) {
+                    done = true;
                     break;
                 }
+                if (this.records.has(item))
+                    check.add(item);
             }
         }
-    }
 
-    // check index
-    if (startIdx == -1) {
-        return undefined; // not found config
+        update.splices = update.splices.concat(this.matchItems(res.created, check));
+
+        return update;
     }
 
-    // The Configuration Wizard end tag is OPTIONAL. Some CMSIS devices config files no define.
-    // If undefine, the last line is end. 
-    if (endIdx == -1) {
-        endIdx = lines.length - 1;
+    /**
+     * update all lines, only the changed range is re-parsed
+    */
+    setLines(lines: string[]): CmsisConfigUpdate | undefined {
+
+        const oldLines = this.lines;
+        const max = Math.min(oldLines.length, lines.length);
+
+        let s = 0;
+        while (s < max && oldLines[s] == lines[s])
+            s++;
+
+        let e = 0;
+        while (e < max - s && oldLines[oldLines.length - 1 - e] == lines[lines.length - 1 - e])
+            e++;
+
+        if (s == oldLines.length && s == lines.length)
+            return undefined; // no changes
+
+        return this.applyChange(s, oldLines.length - s - e, lines.slice(s, lines.length - e));
     }
 
-    const cmsisConfig: CmsisConfiguration = { items: [] };
+    // --- internal
 
-    // parser start
+    private rebuild() {
 
-    const context: ParserContext = {
-        grp_stack: [],
-        last_ele: undefined,
-        macro_list: [],
-        comment_skip_line_count: 0
-    };
+        this.items = [];
+        this.spans = [];
+        this.owners.clear();
+        this.parents.clear();
+        this.records.clear();
+        this.failed.clear();
+        this.namedItems.clear();
+        this.maxSkip = 0;
+        this.macros = [];
+        this.macroNames.clear();
+
+        this.startIdx = -1;
+        this.endIdx = -1;
+        this.hasEndTag = false;
+
+        // The Configuration Wizard section must begin within the first 100 lines of code and must start with the following comment line:
+        //  '// <<< Use Configuration Wizard in Context Menu >>>'
+        for (let idx = 0; idx < Math.min(WIZARD_START_MAX_LINE, this.lines.length); idx++) {
+            if (this.lines[idx].toLowerCase().indexOf(WIZARD_START_TAG) != -1) {
+                this.startIdx = idx;
+                break;
+            }
+        }
 
-    for (let index = startIdx + 1; index < endIdx; index++) {
+        // check index
+        if (this.startIdx == -1) {
+            return; // not found config
+        }
 
-        const cur_grp  = getCurGroup(context);
-        const cur_line = lines[index];
-        const cur_ele  = context.last_ele;
+        // The Configuration Wizard section can end with the following optional comment:
+        //  '// <<< end of configuration section >>>'
+        for (let idx = this.startIdx + 1; idx < this.lines.length; idx++) {
+            if (this.lines[idx].toLowerCase().indexOf(WIZARD_END_TAG) != -1) {
+                this.endIdx = idx;
+                this.hasEndTag = true;
+                break;
+            }
+        }
 
-        // skip some lines for <c> tag
-        if (cur_ele?.type == 'code')
-            context.comment_skip_line_count++;
+        // The Configuration Wizard end tag is OPTIONAL. Some CMSIS devices config files no define.
+        // If undefine, the last line is end. 
+        if (!this.hasEndTag) {
+            this.endIdx = this.lines.length - 1;
+        }
 
-        // is a cmsis header start ? 
-        if (isCmsisTag(cur_line)) {
+        const res = this.parseSpans(newParserContext(this.items), this.startIdx + 1, 0);
+        this.spans = res.spans;
+        this.updateMacros(0, [], res.spans);
+        this.matchItems(res.created, []);
+    }
 
-            // is a group start ?
-            if (fieldMatcher['group'].start.test(cur_line)) {
-                const match = fieldMatcher['group'].start.exec(cur_line);
-                if (match && match.length > 1) {
-                    const nGrp = newItemsGroup();
-                    nGrp.name = match[1];
-                    context.grp_stack.push(nGrp);
-                    cur_grp ? cur_grp.children.push(nGrp) : cmsisConfig.items.push(nGrp);
-                    continue; // go next line
-                }
+    /**
+     * parse lines from 'start' and split them to spans,
+     * stop at an old span (from index 'syncFrom') if the parser state is same as it
+    */
+    private parseSpans(context: ParserContext, start: number, syncFrom: number): { spans: ParseSpan[], synced: number, created: CmsisConfigItem[] } {
+
+        const spans: ParseSpan[] = [];
+        const created: CmsisConfigItem[] = [];
+
+        let span = newParseSpan(start, context);
+        let synced = this.spans.length;
+
+        context.macro_list = span.macros;
+        context.on_new_item = (item, parent) => {
+            created.push(item);
+            this.parents.set(item, parent);
+            span.items.push(item);
+        };
+
+        for (let index = start, old = syncFrom; index < this.endIdx; index++) {
+
+            // the state is synced with an old span, the rest are not changed
+            while (old < this.spans.length && this.spans[old].start < index)
+                old++;
+            if (old < this.spans.length && this.spans[old].start == index &&
+                isSameState(context, this.spans[old])) {
+                this.spans[old].last_ele = context.last_ele;
+                this.spans[old].comment_skip_line_count = context.comment_skip_line_count;
+                synced = old;
+                break;
             }
-            // is group end tag ?
-            else if (cur_grp && fieldMatcher[cur_grp.type] && fieldMatcher[cur_grp.type].end?.test(cur_line)) {
-                context.grp_stack.pop();
-                context.last_ele = undefined;
-                continue; // go next line
+
+            const last_ele = context.last_ele;
+            const skip_count = context.comment_skip_line_count;
+
+            if (parseLine(context, this.lines[index].trimEnd(), index)) {
+                // a new element begins a new span
+                const item = <CmsisConfigItem>context.last_ele;
+                span.items.pop();
+                span.end = index;
+                if (span.end > span.start || span.items.length > 0)
+                    spans.push(span);
+                const stk = context.grp_stack;
+                span = {
+                    start: index,
+                    end: index,
+                    grp_stack: stk[stk.length - 1] == item ? stk.slice(0, -1) : stk.slice(),
+                    last_ele: last_ele,
+                    comment_skip_line_count: skip_count,
+                    items: [item],
+                    macros: []
+                };
+                context.macro_list = span.macros;
             }
+        }
+
+        span.end = synced < this.spans.length ? this.spans[synced].start : this.endIdx;
+        if (span.end > span.start || span.items.length > 0)
+            spans.push(span);
+
+        for (const s of spans) {
+            for (const item of s.items)
+                this.owners.set(item, s);
+        }
+
+        context.on_new_item = undefined;
 
-            // 检查是否处于 <c> 标签的内容范围内
-            let is_in_code_region = false;
-            if (cur_ele?.type == 'code') {
-                // 将被跳过的行不属于 <c> 的内容文本
-                if (cur_ele.var_skip_val && cur_ele.var_skip_val >= context.comment_skip_line_count)
-                    is_in_code_region = false;
-                else
-                    is_in_code_region = true;
+        return { spans: spans, synced: synced, created: created };
+    }
+
+    /**
+     * match C defines for the new items, and check the old items in 'check',
+     * returns the splices of the changed old items
+    */
+    private matchItems(created: CmsisConfigItem[], check: Iterable<CmsisConfigItem>): CmsisConfigSplice[] {
+
+        const macros = this.macros;
+
+        const findMacro = (item: CmsisConfigItem): MacroItem | undefined => {
+            // 如果指定了标识符名字，则必须匹配标识符
+            if (item.var_name) {
+                const list = this.macroNames.get(item.var_name);
+                return list ? list[0] : undefined;
             }
+            // 查找该配置项之后的宏
+            const idx = lowerBound(macros, (macro) => macro.line_idx > item.line_idx);
+            return idx < macros.length ? macros[idx + (item.var_skip_val || 0)] : undefined;
+        };
 
-            // is a new element (skip parse '//' comment for code type)
-            if (!is_in_code_region) {
+        const newItems = new Set(created);
 
-                let validElement = false;
+        for (const item of created) {
 
-                for (const fieldType in fieldMatcher) {
-                    const match = fieldMatcher[fieldType].start.exec(cur_line);
-                    if (match && match.length > 1) {
-                        if (fieldType == 'group') { // this node is a group
-                            const nGrp = newItemsGroup();
-                            nGrp.name = match[1];
-                            context.grp_stack.push(nGrp);
-                            cur_grp ? cur_grp.children.push(nGrp) : cmsisConfig.items.push(nGrp);
-                            context.comment_skip_line_count = 0;
-                            validElement = true;
-                            break;
-                        } else { // this node is a element
-                            const newItem = parseElement(cur_line, fieldType, match, context);
-                            if (newItem) {
-                                newItem.line_idx = index;
-                                context.last_ele = newItem;
-                                cur_grp ? cur_grp.children.push(newItem) : cmsisConfig.items.push(newItem);
-                                context.comment_skip_line_count = 0;
-                                validElement = true;
-                                // if this element have a END matcher, push it to stack
-                                if (fieldMatcher[fieldType].end)
-                                    context.grp_stack.push(newItem);
-                                break;
-                            }
-                        }
-                    }
-                }
+            // <h> 标签：仅作为分组；<!c> 标签：已经处理过了，不需要匹配对应的宏定义
+            if (item.type == 'group' || item.type == 'code' || this.isInCode(item))
+                continue;
 
-                if (validElement)
-                    continue; // go next line
+            // <n> 标签是没有值的，因此 location 是它自身
+            if (item.type == 'notice') {
+                item.location = { start: item.line_idx };
+                continue;
             }
+
+            this.setRecord(item, matchConfigItem(item, findMacro(item)));
         }
 
-        // parse element content
-        if (cur_ele) {
+        const splices: CmsisConfigSplice[] = [];
 
-            // <c> 标签作特殊处理
-            if (cur_ele.type == 'code') {
+        for (const item of Array.from(check)) {
 
-                // check skip lines
-                if (cur_ele.var_skip_val && cur_ele.var_skip_val >= context.comment_skip_line_count)
-                    continue;
+            const rec = this.records.get(item);
+            if (rec == undefined || newItems.has(item))
+                continue;
 
-                if (cur_ele.location == undefined)
-                    cur_ele.location = { start: index };
-                cur_ele.location.end = index;
+            const macro = findMacro(item);
 
-                // '!' 表示代码段已被注释，'' 表示取消注释
-                cur_ele.var_value = cur_line.trimStart().startsWith('//')
-                    ? '!' 
-                    : '';
+            const matched = macro && rec.macro
+                ? (macro == rec.macro || (macro.value == rec.macro.value && macro.line_idx == rec.macro.line_idx))
+                : macro == rec.macro;
+
+            // the line numbers are a part of the error message
+            if (matched && (!rec.failed || (rec.line_idx == item.line_idx && rec.macro_line == (macro ? macro.line_idx : -1)))) {
+                rec.macro = macro; // it may be a new object of the same define
+                continue;
             }
+
+            restoreConfigItem(item, rec);
+            this.setRecord(item, matchConfigItem(item, macro));
+
+            const parent = this.parents.get(item);
+            splices.push({
+                path: this.getPath(parent),
+                start: (parent ? parent.children : this.items).indexOf(item),
+                deleteCount: 1,
+                items: [item]
+            });
         }
 
-        // 解析宏定义或者赋值语句
-        const macroMatcher = /^\s*#\s*define\s+(?<key>\w+)\s*(?<value>.+)?/;
-        let match = macroMatcher.exec(cur_line);
-        if (!match || match.groups == undefined) {
-            if (cur_line.trim().startsWith('//') || 
-                cur_line.trim().startsWith('/*'))
-                continue; // 跳过注释
-            // 匹配赋值表达式：'GPIO.G.redPortMode = A = 1; // ABC'
-            const exprMatcher_s = /(?<key>[a-zA-Z_][\w$]*)\s*=/;
-            match = exprMatcher_s.exec(cur_line);
-            if (!match || match.groups == undefined)
-                continue; // 没有匹配到任何 宏定义 或者 赋值语句，则跳过
-            const exprMatcher_e = /=(?<value>[^=;]+);/;
-            const m = exprMatcher_e.exec(cur_line);
-            if (!m || m.groups == undefined)
-                continue; // 没有匹配到 赋值 ，则跳过
-            match.groups['value'] = m.groups['value'].trim();
-        }
-
-        const keyVal = match.groups;
-        if (keyVal['value'] == undefined)
-            keyVal['value'] = '1'; // 没有显式指定值的，则赋默认值 1
-
-        const macroItem: MacroItem = {
-            name: keyVal['key'],
-            value: keyVal['value'].trim(),
-            line_idx: index,
-            line_txt: cur_line,
-        };
-        context.macro_list.push(macroItem);
+        return splices;
     }
 
-    const updateConfigItemValue = (configItem: CmsisConfigItem, macroItem: MacroItem) => {
-        configItem.var_value = macroItem.value;
-        configItem.location = { start: macroItem.line_idx };
-        updateElementDispVal(configItem);
-    };
+    /**
+     * replace the defines of the removed spans (begin at line 'start') by the defines of the new spans,
+     * returns the index of the changed defines and the changed names
+    */
+    private updateMacros(start: number, removed: ParseSpan[], added: ParseSpan[]): { index: number, names: Set<string> } {
 
-    const findNextMacro = (line_idx: number, skip_count?: number, range?: { start: number, end: number }): MacroItem | undefined => {
-        // 使用顺序遍历
-        for (let i = 0; i < context.macro_list.length; i++) {
-            const macro = context.macro_list[i];
-            if (range) {
-                if (macro.line_idx < range.start)
-                    continue;
-                if (macro.line_idx > range.end)
-                    return undefined;
-            }
-            if (macro.line_idx > line_idx)
-                return context.macro_list[i + (skip_count || 0)];
+        const oldList: MacroItem[] = [];
+        removed.forEach((span) => span.macros.forEach((macro) => oldList.push(macro)));
+        const newList: MacroItem[] = [];
+        added.forEach((span) => span.macros.forEach((macro) => newList.push(macro)));
+
+        const idx = lowerBound(this.macros, (macro) => macro.line_idx >= start);
+        spliceArray(this.macros, idx, oldList.length, newList);
+
+        for (const macro of oldList) {
+            const list = <MacroItem[]>this.macroNames.get(macro.name);
+            list.splice(list.indexOf(macro), 1);
+            if (list.length == 0)
+                this.macroNames.delete(macro.name);
         }
-    };
-    const findNextMacroByName = (name: string, range?: { start: number, end: number }): MacroItem | undefined => {
-        return context.macro_list.find((macro) => {
-            if (range) {
-                if (macro.line_idx < range.start)
-                    return false;
-                if (macro.line_idx > range.end)
-                    return false;
+
+        for (const macro of newList) {
+            const list = this.macroNames.get(macro.name);
+            if (list) {
+                list.splice(lowerBound(list, (m) => m.line_idx > macro.line_idx), 0, macro);
+            } else {
+                this.macroNames.set(macro.name, [macro]);
             }
-            if (macro.name == name)
-                return true;
-        });
-    };
+        }
+
+        const names: Set<string> = new Set();
+        oldList.forEach((macro) => names.add(macro.name));
+        newList.forEach((macro) => names.add(macro.name));
 
-    //
-    // 接下来统一处理所有解析完成的 c defines 和 配置项
-    // 为 每个配置项 匹配一个 c defines
-    //
+        return { index: idx, names: names };
+    }
 
-    const stk = cmsisConfig.items.map(item => item);
-    while (stk.length > 0) {
-        const cur_item = <CmsisConfigItem>stk.shift();
+    private setRecord(item: CmsisConfigItem, rec: MatchRecord) {
 
-        // <h> 标签：仅作为分组，不需要匹配对应的宏定义
-        if (cur_item.type == 'group') {
-            cur_item.children.forEach(t => stk.push(t));
-            continue;
-        }
+        this.records.set(item, rec);
 
-        // <!c> 标签：已经处理过了，不需要匹配对应的宏定义，直接跳过
-        if (cur_item.type == 'code')
-            continue;
+        if (rec.failed)
+            this.failed.add(item);
+        else
+            this.failed.delete(item);
 
-        // <n> 标签是没有值的，因此 location 是它自身
-        if (cur_item.type == 'notice') {
-            cur_item.location = { start: cur_item.line_idx };
-            continue;
+        if (item.var_name) {
+            const set = this.namedItems.get(item.var_name);
+            if (set) set.add(item); else this.namedItems.set(item.var_name, new Set([item]));
         }
 
-        // 为每个配置项查找与之匹配的宏，然后更新配置项的值
-        let macroItem: MacroItem | undefined;
-        if (cur_item.var_name) { // 如果指定了标识符名字，则必须匹配标识符
-            macroItem = findNextMacroByName(cur_item.var_name);
-        } else {
-            macroItem = findNextMacro(cur_item.line_idx, cur_item.var_skip_val);
+        if (item.var_skip_val && item.var_skip_val > this.maxSkip)
+            this.maxSkip = item.var_skip_val;
+    }
+
+    private deleteRecord(item: CmsisConfigItem) {
+
+        if (!this.records.delete(item))
+            return;
+
+        this.failed.delete(item);
+
+        const set = item.var_name ? this.namedItems.get(item.var_name) : undefined;
+        if (set) {
+            set.delete(item);
+            if (set.size == 0)
+                this.namedItems.delete(<string>item.var_name);
         }
+    }
 
-        try {
-            if (macroItem) {
-                updateConfigItemValue(cur_item, macroItem);
-            }
-            if (!cur_item.location) {
-                throw Error(`Error: Not match any C defines, at line ${cur_item.line_idx + 1}`);
+    private shiftLines(from: number, delta: number) {
+
+        const mv = (n: number) => n >= from ? n + delta : n;
+
+        for (const span of this.spans) {
+            span.start = mv(span.start);
+            span.end = mv(span.end);
+            for (const macro of span.macros)
+                macro.line_idx = mv(macro.line_idx);
+            for (const item of span.items) {
+                item.line_idx = mv(item.line_idx);
+                if (item.location) {
+                    item.location.start = mv(item.location.start);
+                    if (item.location.end != undefined)
+                        item.location.end = mv(item.location.end);
+                }
             }
-        } catch (error) {
-            // 对于发生错误的项，GUI标红提示
-            cur_item.type = 'notice'; // 强制改为 notice, 避免用户去修改选项值
-            cur_item.location = { start: cur_item.line_idx };
-            cur_item.name += ' - !!! ' + (<Error>error).message;
-            cur_item.detail.push((<Error>error).message);
-            cur_item.detail.push((<Error>error).message);
-            cur_item.detail.push((<Error>error).message);
-            cur_item.css_class = 'err_blink';
         }
 
-        cur_item.children.forEach(t => stk.push(t));
+        this.startIdx = mv(this.startIdx);
+        this.endIdx = mv(this.endIdx);
     }
 
-    return cmsisConfig;
+    private findSpan(pred: (span: ParseSpan) => boolean): number {
+        return lowerBound(this.spans, pred);
+    }
+
+    private getOwner(item: CmsisConfigItem): ParseSpan {
+        return <ParseSpan>this.owners.get(item);
+    }
+
+    private getPath(grp: CmsisConfigItem | undefined): number[] {
+        const path: number[] = [];
+        while (grp) {
+            const parent = this.parents.get(grp);
+            path.unshift((parent ? parent.children : this.items).indexOf(grp));
+            grp = parent;
+        }
+        return path;
+    }
+
+    // the items in <c> are never matched
+    private isInCode(item: CmsisConfigItem): boolean {
+        for (let p = this.parents.get(item); p; p = this.parents.get(p)) {
+            if (p.type == 'code')
+                return true;
+        }
+        return false;
+    }
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -391,12 +675,165 @@ interface MacroItem {
 };
 
 interface ParserContext {
+    items: CmsisConfigItem[]; // top level items
     grp_stack: CmsisConfigItem[];
     last_ele: CmsisConfigItem | undefined;
     macro_list: MacroItem[];
     comment_skip_line_count: number; // 仅给 <!c> 标签使用
+    on_new_item?: (item: CmsisConfigItem, parent: CmsisConfigItem | undefined) => void;
+};
+
+interface ParseSpan {
+    start: number;
+    end: number; // not included
+    // parser state before the first line
+    grp_stack: CmsisConfigItem[];
+    last_ele: CmsisConfigItem | undefined;
+    comment_skip_line_count: number;
+    // the items and defines which are created in this span
+    items: CmsisConfigItem[];
+    macros: MacroItem[];
 };
 
+interface MatchRecord {
+    macro: MacroItem | undefined;
+    macro_line: number;
+    line_idx: number;
+    failed: boolean;
+    // the item values before matching
+    type: string;
+    name: string;
+    detail_len: number;
+    var_value: string;
+    var_mod_bit_end?: number;
+};
+
+const WIZARD_START_TAG = '<<< use configuration wizard in context menu >>>';
+const WIZARD_END_TAG = '<<< end of configuration section >>>';
+const WIZARD_START_MAX_LINE = 200;
+
+function isWizardTag(line: string): boolean {
+    const str = line.toLowerCase();
+    return str.indexOf(WIZARD_START_TAG) != -1 || str.indexOf(WIZARD_END_TAG) != -1;
+}
+
+/**
+ * the first index which 'pred' is true, 'pred' is false for the items before it
+*/
+function lowerBound<T>(arr: T[], pred: (item: T) => boolean): number {
+    let l = 0, r = arr.length;
+    while (l < r) {
+        const m = (l + r) >> 1;
+        if (pred(arr[m])) r = m; else l = m + 1;
+    }
+    return l;
+}
+
+function spliceArray<T>(arr: T[], start: number, deleteCount: number, items: T[]) {
+    if (items.length < 4096) {
+        arr.splice(start, deleteCount, ...items);
+    } else { // too many arguments for 'splice'
+        const tail = arr.slice(start + deleteCount);
+        arr.length = start;
+        for (const item of items) arr.push(item);
+        for (const item of tail) arr.push(item);
+    }
+}
+
+function newParserContext(items: CmsisConfigItem[], state?: ParseSpan): ParserContext {
+    return {
+        items: items,
+        grp_stack: state ? state.grp_stack.slice() : [],
+        last_ele: state?.last_ele,
+        macro_list: [],
+        comment_skip_line_count: state ? state.comment_skip_line_count : 0
+    };
+}
+
+function newParseSpan(start: number, context: ParserContext): ParseSpan {
+    return {
+        start: start,
+        end: start,
+        grp_stack: context.grp_stack.slice(),
+        last_ele: context.last_ele,
+        comment_skip_line_count: context.comment_skip_line_count,
+        items: [],
+        macros: []
+    };
+}
+
+/**
+ * the next line will create the same element as the span does
+*/
+function isSameState(context: ParserContext, span: ParseSpan): boolean {
+    if (context.last_ele?.type == 'code' || span.last_ele?.type == 'code')
+        return false;
+    if (context.grp_stack.length != span.grp_stack.length)
+        return false;
+    return context.grp_stack.every((grp, idx) => grp == span.grp_stack[idx]);
+}
+
+function addItem(context: ParserContext, parent: CmsisConfigItem | undefined, item: CmsisConfigItem) {
+    parent ? parent.children.push(item) : context.items.push(item);
+    if (context.on_new_item)
+        context.on_new_item(item, parent);
+}
+
+/**
+ * 为配置项匹配一个宏定义，然后更新配置项的值，
+ * returns the values before matching, they are used to match it again
+*/
+function matchConfigItem(item: CmsisConfigItem, macroItem: MacroItem | undefined): MatchRecord {
+
+    const rec: MatchRecord = {
+        macro: macroItem,
+        macro_line: macroItem ? macroItem.line_idx : -1,
+        line_idx: item.line_idx,
+        failed: false,
+        type: item.type,
+        name: item.name,
+        detail_len: item.detail.length,
+        var_value: item.var_value,
+        var_mod_bit_end: item.var_mod_bit?.end
+    };
+
+    try {
+        if (macroItem) {
+            item.var_value = macroItem.value;
+            item.location = { start: macroItem.line_idx };
+            updateElementDispVal(item);
+        }
+        if (!item.location) {
+            throw Error(`Error: Not match any C defines, at line ${item.line_idx + 1}`);
+        }
+    } catch (error) {
+        // 对于发生错误的项，GUI标红提示
+        item.type = 'notice'; // 强制改为 notice, 避免用户去修改选项值
+        item.location = { start: item.line_idx };
+        item.name += ' - !!! ' + (<Error>error).message;
+        item.detail.push((<Error>error).message);
+        item.detail.push((<Error>error).message);
+        item.detail.push((<Error>error).message);
+        item.css_class = 'err_blink';
+        rec.failed = true;
+    }
+
+    return rec;
+}
+
+function restoreConfigItem(item: CmsisConfigItem, rec: MatchRecord) {
+    item.type = rec.type;
+    item.name = rec.name;
+    item.detail.length = rec.detail_len;
+    item.var_value = rec.var_value;
+    if (item.var_mod_bit)
+        item.var_mod_bit.end = rec.var_mod_bit_end;
+    delete item.location;
+    delete item.var_disp_value;
+    delete item.var_fmt_value;
+    delete item.css_class;
+}
+
 // ---
 
 const fieldMatcher: TagMatcher = {
@@ -506,6 +943,144 @@ function newItemsGroup(): CmsisConfigItem {
     return item;
 }
 
+/**
+ * parse a line of the wizard section,
+ * returns true if a new element (not a group) is created by this line
+*/
+function parseLine(context: ParserContext, line: string, index: number): boolean {
+
+    const cur_grp  = getCurGroup(context);
+    const cur_line = line;
+    const cur_ele  = context.last_ele;
+
+    // skip some lines for <c> tag
+    if (cur_ele?.type == 'code')
+        context.comment_skip_line_count++;
+
+    // is a cmsis header start ? 
+    if (isCmsisTag(cur_line)) {
+
+        // is a group start ?
+        if (fieldMatcher['group'].start.test(cur_line)) {
+            const match = fieldMatcher['group'].start.exec(cur_line);
+            if (match && match.length > 1) {
+                const nGrp = newItemsGroup();
+                nGrp.name = match[1];
+                context.grp_stack.push(nGrp);
+                addItem(context, cur_grp, nGrp);
+                return false; // go next line
+            }
+        }
+        // is group end tag ?
+        else if (cur_grp && fieldMatcher[cur_grp.type] && fieldMatcher[cur_grp.type].end?.test(cur_line)) {
+            context.grp_stack.pop();
+            context.last_ele = undefined;
+            return false; // go next line
+        }
+
+        // 检查是否处于 <c> 标签的内容范围内
+        let is_in_code_region = false;
+        if (cur_ele?.type == 'code') {
+            // 将被跳过的行不属于 <c> 的内容文本
+            if (cur_ele.var_skip_val && cur_ele.var_skip_val >= context.comment_skip_line_count)
+                is_in_code_region = false;
+            else
+                is_in_code_region = true;
+        }
+
+        // is a new element (skip parse '//' comment for code type)
+        if (!is_in_code_region) {
+
+            let validElement: string | undefined;
+
+            for (const fieldType in fieldMatcher) {
+                const match = fieldMatcher[fieldType].start.exec(cur_line);
+                if (match && match.length > 1) {
+                    if (fieldType == 'group') { // this node is a group
+                        const nGrp = newItemsGroup();
+                        nGrp.name = match[1];
+                        context.grp_stack.push(nGrp);
+                        addItem(context, cur_grp, nGrp);
+                        context.comment_skip_line_count = 0;
+                        validElement = 'group';
+                        break;
+                    } else { // this node is a element
+                        const newItem = parseElement(cur_line, fieldType, match, context);
+                        if (newItem) {
+                            newItem.line_idx = index;
+                            context.last_ele = newItem;
+                            addItem(context, cur_grp, newItem);
+                            context.comment_skip_line_count = 0;
+                            validElement = fieldType;
+                            // if this element have a END matcher, push it to stack
+                            if (fieldMatcher[fieldType].end)
+                                context.grp_stack.push(newItem);
+                            break;
+                        }
+                    }
+                }
+            }
+
+            if (validElement)
+                return validElement != 'group'; // go next line
+        }
+    }
+
+    // parse element content
+    if (cur_ele) {
+
+        // <c> 标签作特殊处理
+        if (cur_ele.type == 'code') {
+
+            // check skip lines
+            if (cur_ele.var_skip_val && cur_ele.var_skip_val >= context.comment_skip_line_count)
+                return false;
+
+            if (cur_ele.location == undefined)
+                cur_ele.location = { start: index };
+            cur_ele.location.end = index;
+
+            // '!' 表示代码段已被注释，'' 表示取消注释
+            cur_ele.var_value = cur_line.trimStart().startsWith('//')
+                ? '!' 
+                : '';
+        }
+    }
+
+    // 解析宏定义或者赋值语句
+    const macroMatcher = /^\s*#\s*define\s+(?<key>\w+)\s*(?<value>.+)?/;
+    let match = macroMatcher.exec(cur_line);
+    if (!match || match.groups == undefined) {
+        if (cur_line.trim().startsWith('//') || 
+            cur_line.trim().startsWith('/*'))
+            return false; // 跳过注释
+        // 匹配赋值表达式：'GPIO.G.redPortMode = A = 1; // ABC'
+        const exprMatcher_s = /(?<key>[a-zA-Z_][\w$]*)\s*=/;
+        match = exprMatcher_s.exec(cur_line);
+        if (!match || match.groups == undefined)
+            return false; // 没有匹配到任何 宏定义 或者 赋值语句，则跳过
+        const exprMatcher_e = /=(?<value>[^=;]+);/;
+        const m = exprMatcher_e.exec(cur_line);
+        if (!m || m.groups == undefined)
+            return false; // 没有匹配到 赋值 ，则跳过
+        match.groups['value'] = m.groups['value'].trim();
+    }
+
+    const keyVal = match.groups;
+    if (keyVal['value'] == undefined)
+        keyVal['value'] = '1'; // 没有显式指定值的，则赋默认值 1
+
+    const macroItem: MacroItem = {
+        name: keyVal['key'],
+        value: keyVal['value'].trim(),
+        line_idx: index,
+        line_txt: cur_line,
+    };
+    context.macro_list.push(macroItem);
+
+    return false;
+}
+
 // ---
 
 const subNodeNames = [
@@ -59,6 +59,7 @@ import { FileWatcher } from "../lib/node-utility/FileWatcher";
 import { STVPFlasherOptions } from './HexUploader';
 import * as ArmCpuUtils from './ArmCpuUtils';
 import { view_str$gen_sct_failed } from './StringTable';
+import { Tracer } from './Tracer';
 
 export interface BuildOptions {
 
@@ -377,7 +378,9 @@ export abstract class CodeBuilder {
         const outDir = File.ToUnixPath(this.project.getOutputDir());
         const compileOptions: BuilderOptions = this.project.GetConfiguration().toolchainConfigModel.getOptions();
         const memMaxSize = this.getMcuMemorySize();
+        const srcSpan = Tracer.span('CodeBuilder.genSourceInfo', 'build');
         const sourceInfo = this.genSourceInfo();
+        srcSpan.end(() => ({ sources: sourceInfo.sources.length }));
         const builderModeList: string[] = []; // build mode
 
         const builderOptions: BuilderParams = {
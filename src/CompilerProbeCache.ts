@@ -0,0 +1,230 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+import * as NodePath from 'path';
+import * as crypto from 'crypto';
+
+const CACHE_VERSION = '1.0';
+
+/** 'defines': `-E -dM`, 'search-list': `-E -v`, or other probes of a compiler */
+export type CompilerProbeKind = 'defines' | 'search-list' | string;
+
+export interface CompilerProbe {
+    kind: CompilerProbeKind;
+
+    /** full path of the compiler */
+    compiler: string;
+
+    args: string[];
+}
+
+interface ProbeRecord {
+    kind: string;
+    compiler: string;
+    output: string;
+    time: number;
+}
+
+interface ProbeCacheData {
+    version: string;
+    probes: { [key: string]: ProbeRecord };
+}
+
+/**
+ * A persistent cache of the compiler outputs (predefined macros, system include paths ...),
+ * the key is the identity of the compiler binary (path, size, mtime), the kind and the arguments.
+ *
+ * The cache file is shared by all vscode windows, it's reloaded when it's changed by other windows
+ * and the records are merged when it's saved. Failed probes are not cached.
+*/
+export class CompilerProbeCache {
+
+    private cacheFile: string;
+    private maxEntries: number;
+
+    private data: ProbeCacheData = { version: CACHE_VERSION, probes: {} };
+    private stamp: string = '';
+    private pending: Map<string, Promise<string>> = new Map();
+
+    constructor(cacheFile: string, maxEntries?: number) {
+        this.cacheFile = cacheFile;
+        this.maxEntries = maxEntries || 256;
+    }
+
+    /**
+     * The cache key, undefined if the compiler is not found (it's not cached)
+    */
+    static keyOf(probe: CompilerProbe): string | undefined {
+
+        let identity: string;
+        try {
+            const path = fs.realpathSync(probe.compiler);
+            const st = fs.statSync(path);
+            identity = `${NodePath.normalize(path)}|${st.size}|${Math.floor(st.mtimeMs)}`;
+        } catch (error) {
+            return undefined;
+        }
+
+        const args = probe.args
+            .map((a) => a.trim().replace(/\s+/g, ' '))
+            .filter((a) => a != '');
+
+        return crypto.createHash('sha1')
+            .update(JSON.stringify([identity, probe.kind, args]))
+            .digest('hex');
+    }
+
+    getCached(probe: CompilerProbe): string | undefined {
+        const key = CompilerProbeCache.keyOf(probe);
+        if (key) {
+            this.reload();
+            const record = this.data.probes[key];
+            return record ? record.output : undefined;
+        }
+    }
+
+    /**
+     * Get the output of a probe, run it synchronously if it's not cached
+    */
+    getSync(probe: CompilerProbe, run: () => string): string {
+
+        const key = CompilerProbeCache.keyOf(probe);
+        if (key == undefined)
+            return run();
+
+        this.reload();
+        const record = this.data.probes[key];
+        if (record)
+            return record.output;
+
+        const output = run();
+        this.put(key, probe, output);
+        return output;
+    }
+
+    /**
+     * Get the output of a probe, run it asynchronously if it's not cached.
+     * The same probe in running is shared by all callers
+    */
+    get(probe: CompilerProbe, run: () => Promise<string>): Promise<string> {
+
+        const key = CompilerProbeCache.keyOf(probe);
+        if (key == undefined)
+            return run();
+
+        this.reload();
+        const record = this.data.probes[key];
+        if (record)
+            return Promise.resolve(record.output);
+
+        let task = this.pending.get(key);
+        if (task == undefined) {
+            task = run().then((output) => {
+                this.pending.delete(key);
+                this.put(key, probe, output);
+                return output;
+            }, (error) => {
+                this.pending.delete(key);
+                throw error;
+            });
+            this.pending.set(key, task);
+        }
+
+        return task;
+    }
+
+    clear() {
+        this.data = { version: CACHE_VERSION, probes: {} };
+        this.pending.clear();
+        try {
+            fs.unlinkSync(this.cacheFile);
+        } catch (error) {
+            // not exist
+        }
+        this.stamp = '';
+    }
+
+    private put(key: string, probe: CompilerProbe, output: string) {
+
+        this.reload(); // merge the records of other windows
+
+        this.data.probes[key] = {
+            kind: probe.kind,
+            compiler: probe.compiler,
+            output: output,
+            time: Date.now()
+        };
+
+        // drop the oldest records
+        const keys = Object.keys(this.data.probes);
+        if (keys.length > this.maxEntries) {
+            keys.sort((a, b) => this.data.probes[a].time - this.data.probes[b].time)
+                .slice(0, keys.length - this.maxEntries)
+                .forEach((k) => delete this.data.probes[k]);
+        }
+
+        try {
+            fs.mkdirSync(NodePath.dirname(this.cacheFile), { recursive: true });
+            const tmpFile = `${this.cacheFile}.${process.pid}.tmp`;
+            fs.writeFileSync(tmpFile, JSON.stringify(this.data));
+            fs.renameSync(tmpFile, this.cacheFile);
+            this.stamp = fileStamp(this.cacheFile);
+        } catch (error) {
+            // it's only a cache, the records are kept in memory
+        }
+    }
+
+    private reload() {
+
+        const stamp = fileStamp(this.cacheFile);
+        if (stamp == '' || stamp == this.stamp)
+            return;
+
+        try {
+            const data: ProbeCacheData = JSON.parse(fs.readFileSync(this.cacheFile, 'utf8'));
+            if (data.version == CACHE_VERSION && data.probes) {
+                // keep the records which are not saved
+                for (const key in this.data.probes) {
+                    if (data.probes[key] == undefined)
+                        data.probes[key] = this.data.probes[key];
+                }
+                this.data = data;
+            }
+        } catch (error) {
+            // broken file, it's rewritten by the next probe
+        }
+
+        this.stamp = stamp;
+    }
+}
+
+function fileStamp(path: string): string {
+    try {
+        const st = fs.statSync(path);
+        return `${st.mtimeMs}:${st.size}:${st.ino}`;
+    } catch (error) {
+        return '';
+    }
+}
@@ -27,7 +27,9 @@ import { ExeFile, ExeCmd } from "../lib/node-utility/Executable";
 import * as events from 'events';
 import * as child_process from 'child_process';
 import * as platform from './Platform';
+import * as os from 'os';
 import { ResManager } from "./ResManager";
+import { detectArchiveFormat, extractArchive, extractZipSync, zipDirectory, hashFileSync } from './ArchiveEngine';
 
 export interface CompressOption {
     zipType: string;
@@ -54,9 +56,55 @@ export class SevenZipper {
         this._event = new events.EventEmitter();
         if (_7zFolder == undefined) _7zFolder = ResManager.GetInstance().Get7zDir();
         this._7za = File.fromArray([_7zFolder.path, `7za${platform.exeSuffix()}`]);
+    }
+
+    // 7za is only used for the formats which are not supported by the archive engine, such as 7z
+    private _7za_path(): string {
         if (!this._7za.IsFile()) {
             throw new Error(`\'7za${platform.exeSuffix()}\' is not exist`);
         }
+        return this._7za.path;
+    }
+
+    private async _unzip_native(zipFile: File, outDir?: File): Promise<Error | void> {
+
+        const outPath = outDir ? outDir.path : zipFile.dir;
+        let prevPercent = -1;
+
+        try {
+            await extractArchive(zipFile.path, outPath, {
+                onProgress: (done, total, entryName) => {
+                    const percent = total > 0 ? Math.floor(done * 100 / total) : 0;
+                    if (percent != prevPercent) {
+                        prevPercent = percent;
+                        this._event.emit('progress', percent, entryName);
+                    }
+                }
+            });
+        } catch (error) {
+            return <Error>error;
+        }
+    }
+
+    /**
+     * Convert the 7z exclude patterns ('-xr!' switch) to a filter,
+     * a pattern with wildcards is matched with the file name, or the relative path if it contains a separator
+    */
+    private _exclude_filter(excludeList: string[]): (relPath: string) => boolean {
+
+        const matchers = excludeList.map((pattern) => {
+            pattern = pattern.trim().replace(/\\/g, '/').replace(/\/+$/, '');
+            const reg = new RegExp('^' + pattern
+                .replace(/[.+^${}()|[\]]/g, '\\$&')
+                .replace(/\*/g, '.*')
+                .replace(/\?/g, '.') + '$', os.platform() == 'win32' ? 'i' : undefined);
+            return { reg: reg, byPath: pattern.includes('/') };
+        });
+
+        return (relPath: string) => {
+            const name = relPath.substr(relPath.lastIndexOf('/') + 1);
+            return matchers.some(m => m.reg.test(m.byPath ? relPath : name));
+        };
     }
 
     private _unzip_tar(zipFile: File, outDir?: File): Promise<Error | void> {
@@ -150,7 +198,7 @@ export class SevenZipper {
                 this._event.emit('progress', outputCount);
             });
 
-            process.Run(this._7za.path, paramList, { windowsHide: true });
+            process.Run(this._7za_path(), paramList, { windowsHide: true });
         });
     }
 
@@ -172,7 +220,9 @@ export class SevenZipper {
             throw new Error('\'' + zipFile.path + '\' is not exist');
         }
 
-        if (this._is_tar(zipFile.name)) {
+        if (detectArchiveFormat(zipFile.path) != 'none') {
+            return this._unzip_native(zipFile, outDir);
+        } else if (this._is_tar(zipFile.name)) {
             return this._unzip_tar(zipFile, outDir);
         } else {
             return this._unzip_zip_7z(zipFile, outDir);
@@ -185,6 +235,11 @@ export class SevenZipper {
             throw new Error('\'' + zipFile.path + '\' is not exist');
         }
 
+        // zip files are extracted in process
+        if (detectArchiveFormat(zipFile.path) == 'zip') {
+            return extractZipSync(zipFile.path, outDir ? outDir.path : zipFile.dir).join(os.EOL);
+        }
+
         // use tar
         if (this._is_tar(zipFile.name)) {
 
@@ -208,7 +263,7 @@ export class SevenZipper {
             paramList.push(zipFile.path);
             paramList.push('-o' + (outDir ? outDir.path : zipFile.dir));
 
-            return child_process.execFileSync(this._7za.path, paramList, { windowsHide: true }).toString();
+            return child_process.execFileSync(this._7za_path(), paramList, { windowsHide: true }).toString();
         }
     }
 
@@ -218,6 +273,23 @@ export class SevenZipper {
             throw new Error('\'' + dirOrFile.path + '\' is not exist');
         }
 
+        // zip files are created in process
+        if (option.zipType == 'zip' && dirOrFile.IsDir()) {
+            const outPath = (outDir ? outDir.path : '.') + File.sep + option.fileName;
+            const exclude = this._exclude_filter(option.excludeList || []);
+            let prevPercent = -1;
+            return zipDirectory(dirOrFile.path, outPath, {
+                exclude: (relPath) => exclude(relPath),
+                onProgress: (done, total) => {
+                    const percent = total > 0 ? Math.floor(done * 100 / total) : 0;
+                    if (percent != prevPercent) {
+                        prevPercent = percent;
+                        this._event.emit('progress', percent);
+                    }
+                }
+            }).catch((error) => <Error>error);
+        }
+
         return new Promise((resolve) => {
 
             let paramList: string[] = [];
@@ -270,22 +342,13 @@ export class SevenZipper {
                 this._event.emit('progress', outputCount);
             });
 
-            process.Run(this._7za.path, paramList, { windowsHide: true });
+            process.Run(this._7za_path(), paramList, { windowsHide: true });
         });
     }
 
     sha256(file: File): string | undefined {
         try {
-            const args = ['h', '-scrcSHA256', file.path];
-            const resLi = child_process.execFileSync(this._7za.path, args).toString()
-                .split(/\r\n|\n/).map((s) => s.trim());
-            const header = 'SHA256 for data:';
-            for (const line of resLi) {
-                if (line.startsWith(header)) {
-                    const hashStr = line.replace(header, '').trim();
-                    if (hashStr.length == 64) return hashStr.toLowerCase();
-                }
-            }
+            return hashFileSync(file.path, 'sha256');
         } catch (error) {
             // do nothing
         }
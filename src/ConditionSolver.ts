@@ -0,0 +1,353 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import { PackComponent, PackCondition, PackConditionGroup } from './PackIndex';
+
+/** only the required components of this class are installed, others are ignored */
+const DEVICE_CLASS_PREFIX = 'Device.';
+
+/**
+ * The device and toolchain which the conditions are evaluated for
+*/
+export interface ConditionContext {
+
+    /** vendor of the device family, such as 'STMicroelectronics:13' */
+    vendor: string;
+
+    /** device name */
+    device: string;
+
+    /** toolchain category name, such as 'AC6', the compiler conditions are ignored if it's undefined */
+    compiler?: string;
+
+    /** toolchain name */
+    compilerOption?: string;
+}
+
+export interface ConditionResult {
+
+    passed: boolean;
+
+    /** full names of the components required by the condition, such as 'Device.Startup' */
+    requires: string[];
+
+    /** the reason, if it's not passed */
+    error?: string;
+}
+
+export interface ComponentConflict {
+    component: string;
+    condition: string;
+    reason: string;
+}
+
+export interface ComponentResolution<T extends PackComponent> {
+
+    /** components to install, dependencies are placed before the components which require them,
+     *  the conflicted components are excluded */
+    components: T[];
+
+    /** required components which are not device components, they are not installed */
+    ignored: string[];
+
+    /** required components which are not found in the pack */
+    missing: string[];
+
+    /** components whose condition is not satisfied */
+    conflicts: ComponentConflict[];
+}
+
+const PASSED: ConditionResult = { passed: true, requires: [] };
+
+function addUnique(list: string[], items: string[]) {
+    for (const item of items) {
+        if (!list.includes(item))
+            list.push(item);
+    }
+}
+
+/**
+ * Evaluate the conditions of a CMSIS pack for one device and toolchain.
+ *
+ * Every condition is evaluated once, the result is cached by the condition id,
+ * so create a new solver when the device or the toolchain is changed.
+*/
+export class ConditionSolver {
+
+    readonly context: ConditionContext;
+
+    private conditionMap: Map<string, PackConditionGroup>;
+    private cache: Map<string, ConditionResult>;
+
+    // conditions which are being evaluated, value is the depth in the stack
+    private evaluating: Map<string, number>;
+
+    constructor(conditionMap: Map<string, PackConditionGroup>, context: ConditionContext) {
+        this.conditionMap = conditionMap;
+        this.context = context;
+        this.cache = new Map();
+        this.evaluating = new Map();
+    }
+
+    /**
+     * Make a key of the context, two solvers with the same key and the same pack give the same results
+    */
+    static contextKey(context: ConditionContext): string {
+        return [context.vendor, context.device, context.compiler || '', context.compilerOption || ''].join('|');
+    }
+
+    check(conditionId: string): boolean {
+        return this.evaluate(conditionId).passed;
+    }
+
+    evaluate(conditionId: string): ConditionResult {
+        return this._evaluate(conditionId).result;
+    }
+
+    /**
+     * @returns `low`: the min depth of the conditions in the stack which the result depends on,
+     *  a result which depends on an unfinished condition (a loop) is not cached
+    */
+    private _evaluate(id: string): { result: ConditionResult, low: number } {
+
+        const cached = this.cache.get(id);
+        if (cached)
+            return { result: cached, low: Infinity };
+
+        // a loop, the condition is treated as passed
+        const depth = this.evaluating.get(id);
+        if (depth !== undefined)
+            return { result: PASSED, low: depth };
+
+        const group = this.conditionMap.get(id);
+        if (group == undefined)
+            return { result: PASSED, low: Infinity };
+
+        const myDepth = this.evaluating.size;
+        this.evaluating.set(id, myDepth);
+
+        let res: { result: ConditionResult, low: number };
+        try {
+            res = this.evaluateGroup(group);
+        } finally {
+            this.evaluating.delete(id);
+        }
+
+        if (res.low >= myDepth) {
+            this.cache.set(id, res.result);
+            res.low = Infinity;
+        }
+
+        return res;
+    }
+
+    private evaluateGroup(group: PackConditionGroup): { result: ConditionResult, low: number } {
+
+        const ctx = this.context;
+        const requires: string[] = [];
+        let low = Infinity;
+
+        const fail = (error: string) => {
+            return { result: { passed: false, requires: [], error: error }, low: low };
+        };
+
+        for (const con of group.requireList) {
+
+            if (ctx.compiler !== undefined) {
+
+                if (con.compiler && con.compiler !== ctx.compiler)
+                    return fail(`Compiler category '${ctx.compiler}' not match, expect: ${con.compiler}`);
+
+                if (con.compilerOption && con.compilerOption !== ctx.compilerOption)
+                    return fail(`Compiler name '${ctx.compilerOption}' not match, expect: ${con.compilerOption}`);
+            }
+
+            if (con.Dvendor && con.Dvendor !== ctx.vendor)
+                return fail(`Family vendor '${ctx.vendor}' not match, expect: ${con.Dvendor}`);
+
+            if (con.Dname && !con.Dname.test(ctx.device))
+                return fail(`Device name '${ctx.device}' not match, expect: ${con.Dname}`);
+
+            if (con.component)
+                addUnique(requires, [con.component]);
+
+            if (con.condition) {
+                const sub = this._evaluate(con.condition);
+                low = Math.min(low, sub.low);
+                if (!sub.result.passed)
+                    return fail(sub.result.error || `Condition '${con.condition}' not match`);
+                addUnique(requires, sub.result.requires);
+            }
+        }
+
+        if (group.acceptList.length === 0)
+            return { result: { passed: true, requires: requires }, low: low };
+
+        // passed, if one of them is passed
+        for (const con of group.acceptList) {
+            const sub = this.evaluateAccept(con);
+            low = Math.min(low, sub.low);
+            if (sub.requires) {
+                addUnique(requires, sub.requires);
+                return { result: { passed: true, requires: requires }, low: low };
+            }
+        }
+
+        return fail(`Not match any 'accept' conditions !`);
+    }
+
+    /**
+     * @returns `requires` is undefined if it's not passed
+    */
+    private evaluateAccept(con: PackCondition): { requires?: string[], low: number } {
+
+        const ctx = this.context;
+
+        if (ctx.compiler !== undefined) {
+            if (con.compiler && con.compiler !== ctx.compiler)
+                return { low: Infinity };
+            if (con.compilerOption && con.compilerOption !== ctx.compilerOption)
+                return { low: Infinity };
+        }
+
+        if (con.Dvendor && con.Dvendor !== ctx.vendor)
+            return { low: Infinity };
+
+        if (con.Dname && !con.Dname.test(ctx.device))
+            return { low: Infinity };
+
+        const requires: string[] = [];
+        let low = Infinity;
+
+        if (con.condition) {
+            const sub = this._evaluate(con.condition);
+            low = sub.low;
+            if (!sub.result.passed)
+                return { low: low };
+            addUnique(requires, sub.result.requires);
+        }
+
+        if (con.component)
+            addUnique(requires, [con.component]);
+
+        return { requires: requires, low: low };
+    }
+
+    /**
+     * Resolve the full dependency closure of the selected components in one pass.
+     *
+     * A required component 'Device.A' matches the enabled components 'A' and 'A.*',
+     * the installed dependencies are skipped, the selected components are always in the result.
+     *
+     * @param available all components of the pack
+    */
+    resolveComponents<T extends PackComponent>(selection: T[], available: T[],
+        isInstalled: (groupName: string) => boolean): ComponentResolution<T> {
+
+        const resolution: ComponentResolution<T> = { components: [], ignored: [], missing: [], conflicts: [] };
+
+        const matchCache = new Map<string, T[]>();
+        const findComponents = (name: string): T[] => {
+            let list = matchCache.get(name);
+            if (list == undefined) {
+                list = available.filter(c => c.enable && (c.groupName === name || c.groupName.startsWith(name + '.')));
+                matchCache.set(name, list);
+            }
+            return list;
+        };
+
+        // collect the closure, in the order they are found
+        const nodes: T[] = [];
+        const deps = new Map<T, T[]>();
+        const queue: T[] = [];
+
+        const visit = (comp: T) => {
+            if (!deps.has(comp)) {
+                deps.set(comp, []);
+                nodes.push(comp);
+                queue.push(comp);
+            }
+        };
+
+        selection.forEach(visit);
+
+        while (queue.length > 0) {
+
+            const comp = <T>queue.shift();
+            if (!comp.condition)
+                continue;
+
+            const res = this.evaluate(comp.condition);
+            if (!res.passed) {
+                resolution.conflicts.push({
+                    component: comp.groupName,
+                    condition: comp.condition,
+                    reason: res.error || 'failed'
+                });
+                continue;
+            }
+
+            const compDeps = <T[]>deps.get(comp);
+            for (const fullname of res.requires) {
+
+                if (!fullname.startsWith(DEVICE_CLASS_PREFIX)) {
+                    addUnique(resolution.ignored, [fullname]);
+                    continue;
+                }
+
+                const matched = findComponents(fullname.substr(DEVICE_CLASS_PREFIX.length));
+                if (matched.length == 0) {
+                    addUnique(resolution.missing, [fullname]);
+                    continue;
+                }
+
+                for (const dep of matched) {
+                    if (dep === comp || compDeps.includes(dep))
+                        continue;
+                    if (!deps.has(dep) && isInstalled(dep.groupName))
+                        continue;
+                    compDeps.push(dep);
+                    visit(dep);
+                }
+            }
+        }
+
+        // sort the closure, dependencies first, the found order is kept for independent components
+        const state = new Map<T, number>(); // 1: visiting, 2: done
+        const sort = (comp: T) => {
+            if (state.has(comp))
+                return; // done, or a dependency loop
+            state.set(comp, 1);
+            for (const dep of <T[]>deps.get(comp))
+                sort(dep);
+            state.set(comp, 2);
+            if (!resolution.conflicts.some(c => c.component === comp.groupName))
+                resolution.components.push(comp);
+        };
+
+        nodes.forEach(sort);
+
+        return resolution;
+    }
+}
@@ -0,0 +1,229 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+import * as NodePath from 'path';
+import * as child_process from 'child_process';
+
+/** Max entries kept in the persistent cache, the oldest entries are dropped first. */
+const CACHE_MAX_ENTRIES = 200 * 1000;
+
+/**
+ * Whether a symbol name looks like an Itanium C++ ABI mangled name.
+ * (`__Z` is the Mach-O form, which c++filt also accepts)
+*/
+export function isMangledName(name: string): boolean {
+    return name.startsWith('_Z') || name.startsWith('__Z');
+}
+
+/**
+ * Batch C++ symbol demangler.
+ *
+ * All names of one request are sent to a single `c++filt` process over stdin
+ * (c++filt prints one line per input line, in order), and the results are
+ * memoized in a name cache which can be persisted to disk. The cache is keyed
+ * by the demangler tool too, the toolchains do not share their names.
+*/
+export class CxxDemangler {
+
+    private cache: Map<string, string> = new Map();
+    private cacheFile: string | undefined;
+    private cacheLoaded = false;
+    private dirty = false;
+
+    constructor(cacheFile?: string) {
+        this.cacheFile = cacheFile;
+    }
+
+    /**
+     * Demangle a list of names, return a map: mangled name -> demangled name.
+     * Names which are not mangled or failed to be demangled map to themselves.
+    */
+    async demangle(names: Iterable<string>, cxxfilt: string): Promise<Map<string, string>> {
+
+        const { result, pending } = this.lookup(names, cxxfilt);
+
+        if (pending.length > 0) {
+            const lines = await this.runCxxFilt(cxxfilt, pending);
+            this.store(cxxfilt, pending, lines, result);
+        }
+
+        return result;
+    }
+
+    /**
+     * Same as `demangle()`, but block until c++filt exit.
+     * Use it only in the sync context, it still spawn only one process for all names.
+    */
+    demangleSync(names: Iterable<string>, cxxfilt: string): Map<string, string> {
+
+        const { result, pending } = this.lookup(names, cxxfilt);
+
+        if (pending.length > 0) {
+            let lines: string[] | undefined;
+            try {
+                const r = child_process.spawnSync(cxxfilt, [], {
+                    input: pending.join('\n') + '\n',
+                    maxBuffer: 256 * 1024 * 1024,
+                    windowsHide: true
+                });
+                if (r.status == 0 && r.stdout)
+                    lines = r.stdout.toString().split(/\r?\n/);
+            } catch (error) {
+                // c++filt not found
+            }
+            this.store(cxxfilt, pending, lines, result);
+        }
+
+        return result;
+    }
+
+    /**
+     * Get a cached name without spawning any process.
+    */
+    getCached(name: string, cxxfilt: string): string | undefined {
+        this.loadCache();
+        return this.cache.get(cacheKey(cxxfilt, name));
+    }
+
+    /**
+     * Write the name cache to disk if it was changed.
+     *
+     * The on-disk content is merged before writing, other vscode windows may
+     * have written their names after we loaded it.
+    */
+    flush() {
+
+        if (!this.dirty || this.cacheFile == undefined)
+            return;
+
+        try {
+            const merged = this.readCacheFile();
+            for (const [k, v] of this.cache)
+                merged.set(k, v);
+            while (merged.size > CACHE_MAX_ENTRIES) {
+                const first = merged.keys().next();
+                if (first.done) break;
+                merged.delete(first.value);
+            }
+            const obj: { [name: string]: string } = {};
+            for (const [k, v] of merged)
+                obj[k] = v;
+            const tmpFile = `${this.cacheFile}.${process.pid}.tmp`;
+            fs.writeFileSync(tmpFile, JSON.stringify(obj));
+            fs.renameSync(tmpFile, this.cacheFile);
+            this.cache = merged;
+            this.dirty = false;
+        } catch (error) {
+            // ignore, it's just a cache
+        }
+    }
+
+    //---
+
+    private lookup(names: Iterable<string>, cxxfilt: string): { result: Map<string, string>, pending: string[] } {
+
+        this.loadCache();
+
+        const result = new Map<string, string>();
+        const pending: string[] = [];
+
+        for (const name of names) {
+            if (result.has(name))
+                continue;
+            const cached = isMangledName(name) ? this.cache.get(cacheKey(cxxfilt, name)) : name;
+            if (cached !== undefined) {
+                result.set(name, cached);
+            } else {
+                result.set(name, name); // placeholder, will be overwritten
+                pending.push(name);
+            }
+        }
+
+        return { result, pending };
+    }
+
+    private store(cxxfilt: string, pending: string[], lines: string[] | undefined, result: Map<string, string>) {
+
+        // the output is unusable if the line count is not matched, just keep the raw names
+        if (lines == undefined || lines.length < pending.length)
+            return;
+
+        for (let i = 0; i < pending.length; i++) {
+            const demangled = lines[i].trim() || pending[i];
+            result.set(pending[i], demangled);
+            this.cache.set(cacheKey(cxxfilt, pending[i]), demangled);
+        }
+
+        this.dirty = true;
+    }
+
+    private runCxxFilt(cxxfilt: string, names: string[]): Promise<string[] | undefined> {
+        return new Promise((resolve) => {
+            let proc: child_process.ChildProcess;
+            try {
+                proc = child_process.spawn(cxxfilt, [], { windowsHide: true });
+            } catch (error) {
+                resolve(undefined);
+                return;
+            }
+            const chunks: Buffer[] = [];
+            proc.stdout?.on('data', (chunk: Buffer) => chunks.push(chunk));
+            proc.on('error', () => resolve(undefined));
+            proc.on('close', (code) => {
+                if (code != 0) {
+                    resolve(undefined);
+                    return;
+                }
+                resolve(Buffer.concat(chunks).toString().split(/\r?\n/));
+            });
+            proc.stdin?.on('error', () => { /* process exited early, handled by 'close' */ });
+            proc.stdin?.end(names.join('\n') + '\n');
+        });
+    }
+
+    private loadCache() {
+        if (this.cacheLoaded)
+            return;
+        this.cacheLoaded = true;
+        this.cache = this.readCacheFile();
+    }
+
+    private readCacheFile(): Map<string, string> {
+        try {
+            if (this.cacheFile && fs.existsSync(this.cacheFile)) {
+                const obj = JSON.parse(fs.readFileSync(this.cacheFile, 'utf8'));
+                if (obj && typeof obj == 'object') // drop the old entries which are not keyed by the tool
+                    return new Map(Object.entries(obj).filter(([k]) => k.includes('|')) as [string, string][]);
+            }
+        } catch (error) {
+            // broken cache file, ignore it
+        }
+        return new Map();
+    }
+}
+
+function cacheKey(cxxfilt: string, name: string): string {
+    return `${NodePath.normalize(cxxfilt)}|${name}`;
+}
@@ -65,51 +65,55 @@ export class DependenceManager implements ManagerInterface {
     }
 
     InstallComponent(packName: string, component: Component) {
-        GlobalEvent.log_info(`Install CMSIS Component: ${component.groupName} ...`);
-        this._installComponent(packName, component, [component.groupName]);
-        GlobalEvent.log_info(`Done.`);
-    }
 
-    private _installComponent(packName: string, component: Component, pendingList: string[]) {
+        GlobalEvent.log_info(`Install CMSIS Component: ${component.groupName} ...`);
 
-        const config         = this.project.GetConfiguration();
         const toolchain      = this.project.getToolchain();
         const packageManager = this.project.GetPackManager();
-        const vSource        = this.project.getVirtualSourceManager();
 
-        /* 安装此组件的依赖项 */
-        if (component.condition) {
-            // check and get dependences
-            let depList: string[] = [];
-            try {
-                depList= packageManager.checkComponentRequirement(component.condition, toolchain);
-            } catch (error) {
-                GlobalEvent.log_warn(`${(<Error>error).message}`);
-                throw new Error(`Condition '${component.condition}' is not fit for this component: '${component.groupName}'`);
+        /* 一次性解析此组件及其全部依赖项 */
+        const resolution = packageManager.resolveComponents([component], toolchain,
+            (groupName) => this.isInstalled(packName, groupName));
+
+        if (resolution) {
+
+            resolution.ignored.forEach((fullname) => {
+                GlobalEvent.log_warn(` -> ignore component: '${fullname}'`); /* 排除非 Device 类型的组件 */
+            });
+
+            resolution.missing.forEach((fullname) => {
+                GlobalEvent.log_warn(` -> not found component: '${fullname}'`);
+            });
+
+            if (resolution.conflicts.length > 0) {
+                resolution.conflicts.forEach((conflict) => {
+                    GlobalEvent.log_warn(` -> '${conflict.component}': ${conflict.reason}`);
+                });
+                const conflict = resolution.conflicts[0];
+                throw new Error(`Condition '${conflict.condition}' is not fit for this component: '${conflict.component}'`);
             }
-            // try install dependences
-            for (const fullname of depList) {
-                if (!fullname.startsWith('Device.')) {
-                    GlobalEvent.log_warn(`${' '.repeat(pendingList.length)}-> ignore component: '${fullname}'`);
-                    continue; /* 排除非 Device 类型的组件 */
-                }
-                const reqName  = fullname.replace('Device.', '');
-                const compList = packageManager.FindAllComponents(reqName);
-                if (compList) {
-                    for (const item of compList) {
-                        if (this.isInstalled(packName, item.groupName))
-                            continue; /* 排除已安装的 */
-                        if (pendingList.includes(item.groupName))
-                            continue; /* 排除队列中已存在的 */
-                        pendingList.push(item.groupName);
-                        GlobalEvent.log_info(`${' '.repeat(pendingList.length)}-> install dependence component: ${item.groupName}`);
-                        this._installComponent(packName, item, pendingList);
-                        pendingList.pop();
-                    }
+
+            /* 依赖项排在前面 */
+            for (const item of resolution.components) {
+                if (item !== component) {
+                    GlobalEvent.log_info(` -> install dependence component: ${item.groupName}`);
                 }
+                this._installComponent(packName, item);
             }
+        } else {
+            this._installComponent(packName, component);
         }
 
+        GlobalEvent.log_info(`Done.`);
+    }
+
+    private _installComponent(packName: string, component: Component) {
+
+        const config         = this.project.GetConfiguration();
+        const toolchain      = this.project.getToolchain();
+        const packageManager = this.project.GetPackManager();
+        const vSource        = this.project.getVirtualSourceManager();
+
         const item_filter = function (item: ComponentFileItem): boolean {
             return (item.attr != 'template')
                 && (item.condition ? packageManager.CheckCondition(item.condition, toolchain) : true);
@@ -150,6 +154,10 @@ export class DependenceManager implements ManagerInterface {
 
         // add source files
         const _srcfiles = ArrayDelRepetition(headerList.concat(cFileList, asmList).map(f => f.path));
+
+        // the pack may be installed lazily, extract the used files from the pack archive
+        packageManager.ExtractPackFiles(this.getComponentFilePaths(component, _srcfiles));
+
         this.createComponentDir(packName, component.groupName);
         vSource.addFiles(
             VirtualSource.toAbsPath(DependenceManager.DEPS_VFOLDER_NAME, packName, component.groupName), _srcfiles);
@@ -402,6 +410,14 @@ export class DependenceManager implements ManagerInterface {
 
                 prjConfig.MergeDependence(packInfo.name, dep);
 
+                // the files may be not extracted yet, if the pack is installed lazily
+                try {
+                    const files = component.headerList.concat(component.cFileList, component.asmList).map(f => f.path);
+                    this.project.GetPackManager().ExtractPackFiles(this.getComponentFilePaths(component, files));
+                } catch (error) {
+                    GlobalEvent.log_warn(<Error>error);
+                }
+
                 // load cache
                 this.loadComponentCaches(packInfo.name, component);
 
@@ -417,6 +433,13 @@ export class DependenceManager implements ManagerInterface {
         }
     }
 
+    private getComponentFilePaths(component: Component, sourceFiles: string[]): string[] {
+        return component.incDirList.map(item => item.path).concat(
+            sourceFiles,
+            component.libList ? component.libList.map(item => item.path) : [],
+            component.linkerList ? component.linkerList.map(item => item.path) : []);
+    }
+
     private AddRTEComponents(component: Component) {
         if (this.isAutoGenRTEHeader() && !this.componentDefines.has(component.groupName)) {
             this.componentDefines.set(component.groupName, component.RTE_define || '');
@@ -0,0 +1,299 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as vscode from 'vscode';
+import * as fs from 'fs';
+import * as child_process from 'child_process';
+import * as NodePath from 'path';
+
+import { File } from '../lib/node-utility/File';
+import { AbstractProject } from './EIDEProject';
+import { VirtualDocument } from './VirtualDocsProvider';
+import { ElfFile, ElfSymbol } from './ElfReader';
+import { isGccFamilyToolchain } from './utility';
+import { exeSuffix } from './Platform';
+import { GlobalEvent } from './GlobalEvents';
+
+/** Max cached disassembly results */
+const CACHE_MAX_ENTRIES = 64;
+
+/** Max total size (chars) of the cached results, a bigger result (e.g. a whole image) is not cached */
+const CACHE_MAX_SIZE = 16 * 1024 * 1024;
+
+/** Min interval of the document refresh while the disassembler is running */
+const STREAM_UPDATE_INTERVAL = 300;
+
+/** EM_ARM, the lowest bit of a thumb function address must be cleared */
+const EM_ARM = 40;
+
+/** not '& ~1', it's a signed 32-bit operation, the addresses >= 0x80000000 become negative */
+function clearThumbBit(addr: number): number {
+    return addr - (addr % 2);
+}
+
+export interface DisassemblyRange {
+    /** inclusive */
+    start: number;
+    /** exclusive */
+    stop: number;
+}
+
+interface DisassemblerTool {
+    path: string;
+    /** can disassemble an address range, if false, always do whole image */
+    supportRange: boolean;
+    args: (elfPath: string, range?: DisassemblyRange) => string[];
+}
+
+let _instance: DisassemblyProvider | undefined;
+
+/**
+ * Provide per-function (or address range) disassembly as `eide://` virtual documents.
+ *
+ * The disassembler runs asynchronously and the output is streamed into the
+ * document, results are cached by the elf build id (or size + mtime if the elf
+ * not have a build id) so that re-open a function is instant. The cache is bounded
+ * by the total size, the whole image results are usually too big to be cached.
+*/
+export class DisassemblyProvider {
+
+    private cache: Map<string, string> = new Map();
+    private cacheSize = 0;
+    private running: Map<string, Promise<string>> = new Map();
+
+    private constructor() {
+        // nothing
+    }
+
+    static instance(): DisassemblyProvider {
+        if (!_instance) { _instance = new DisassemblyProvider(); }
+        return _instance;
+    }
+
+    /**
+     * Show disassembly of a function symbol in elf
+     *
+     * @param symbolName the raw (mangled) symbol name or an address ('0x...')
+    */
+    async showSymbol(prj: AbstractProject, elfPath: string, symbolName: string) {
+
+        const elf = ElfFile.open(elfPath);
+        let found: ElfSymbol | undefined;
+        let isArm = false;
+
+        try {
+            isArm = elf.header.machine == EM_ARM;
+            const addr = /^0x[0-9a-f]+$/i.test(symbolName) ? parseInt(symbolName, 16) : undefined;
+            elf.forEachSymbol((sym) => {
+                if (sym.type != 'FUNC' || sym.section == undefined)
+                    return;
+                if (addr !== undefined ? clearThumbBit(sym.value) == clearThumbBit(addr) : sym.name == symbolName) {
+                    found = sym;
+                    return false;
+                }
+            });
+        } finally {
+            elf.close();
+        }
+
+        if (found == undefined)
+            throw new Error(`Not found function '${symbolName}' in '${elfPath}' !`);
+
+        const start = isArm ? clearThumbBit(found.value) : found.value;
+        const range: DisassemblyRange = {
+            start: start,
+            stop: start + Math.max(found.size, 1)
+        };
+
+        await this.showRange(prj, elfPath, range, found.name);
+    }
+
+    /**
+     * Show disassembly of an address range, or the whole image if range is undefined
+    */
+    async showRange(prj: AbstractProject, elfPath: string, range: DisassemblyRange | undefined, title?: string) {
+
+        const tool = this.getDisassembler(prj);
+        if (!tool.supportRange)
+            range = undefined;
+
+        const docName = title || (range ? `0x${range.start.toString(16)}` : 'all');
+        const docPath = `${elfPath}.${docName.replace(/[^\w\.\-]/g, '_')}.edasm`;
+        const vdoc = VirtualDocument.instance();
+        const docUri = vscode.Uri.parse(vdoc.getUriByPath(docPath));
+
+        const cacheKey = [this.getImageId(elfPath), tool.path, range ? `${range.start}-${range.stop}` : 'all'].join(':');
+
+        const cached = this.cache.get(cacheKey);
+        if (cached !== undefined) {
+            // move to the end of LRU list
+            this.cache.delete(cacheKey);
+            this.cache.set(cacheKey, cached);
+            vdoc.updateDocument(docPath, cached);
+            await vscode.window.showTextDocument(docUri, { preview: true, viewColumn: vscode.ViewColumn.Two });
+            return;
+        }
+
+        vdoc.updateDocument(docPath, `; disassembling '${docName}' ...\n`);
+        await vscode.window.showTextDocument(docUri, { preview: true, viewColumn: vscode.ViewColumn.Two });
+
+        let task = this.running.get(cacheKey);
+        if (task == undefined) {
+            task = this.runDisassembler(tool, elfPath, range, (partial) => vdoc.updateDocument(docPath, partial));
+            this.running.set(cacheKey, task);
+        }
+
+        try {
+            const content = await task;
+            this.putCache(cacheKey, content);
+            vdoc.updateDocument(docPath, content);
+        } finally {
+            this.running.delete(cacheKey);
+        }
+    }
+
+    //---
+
+    private putCache(key: string, content: string) {
+
+        if (content.length > CACHE_MAX_SIZE / 4)
+            return;
+
+        const old = this.cache.get(key);
+        if (old !== undefined) {
+            this.cache.delete(key);
+            this.cacheSize -= old.length;
+        }
+
+        this.cache.set(key, content);
+        this.cacheSize += content.length;
+
+        while (this.cache.size > CACHE_MAX_ENTRIES || this.cacheSize > CACHE_MAX_SIZE) {
+            const first = this.cache.entries().next();
+            if (first.done) break;
+            this.cache.delete(first.value[0]);
+            this.cacheSize -= first.value[1].length;
+        }
+    }
+
+    private getImageId(elfPath: string): string {
+
+        try {
+            const elf = ElfFile.open(elfPath);
+            try {
+                const buildId = elf.readBuildId();
+                if (buildId) return buildId;
+            } finally {
+                elf.close();
+            }
+        } catch (error) {
+            // not an elf ?, use file stat
+        }
+
+        const st = fs.statSync(elfPath);
+        return `${elfPath}|${st.size}|${st.mtimeMs}`;
+    }
+
+    private getDisassembler(prj: AbstractProject): DisassemblerTool {
+
+        const toolchain = prj.getToolchain();
+        const toolchainName = toolchain.name;
+        const binDir = File.from(toolchain.getToolchainDir().path, 'bin').path;
+
+        const objdumpArgs = (elfPath: string, range?: DisassemblyRange): string[] => {
+            const args = ['-d', '-S', '-l', '-C'];
+            if (range) {
+                args.push(`--start-address=0x${range.start.toString(16)}`);
+                args.push(`--stop-address=0x${range.stop.toString(16)}`);
+            }
+            args.push(elfPath);
+            return args;
+        };
+
+        let tool: DisassemblerTool;
+
+        if (isGccFamilyToolchain(toolchainName)) {
+            const toolPrefix = toolchain.getToolchainPrefix ? toolchain.getToolchainPrefix() : '';
+            tool = { path: NodePath.join(binDir, `${toolPrefix}objdump${exeSuffix()}`), supportRange: true, args: objdumpArgs };
+        }
+        else if (toolchainName == 'LLVM_ARM') {
+            tool = { path: NodePath.join(binDir, `llvm-objdump${exeSuffix()}`), supportRange: true, args: objdumpArgs };
+        }
+        else if (toolchainName == 'GNU_SDCC_MCS51') {
+            tool = { path: NodePath.join(binDir, `i51-elf-objdump${exeSuffix()}`), supportRange: true, args: objdumpArgs };
+        }
+        else if (toolchainName.startsWith('AC')) { // fromelf can not limit address range
+            tool = { path: NodePath.join(binDir, `fromelf${exeSuffix()}`), supportRange: false, args: (elfPath) => ['-c', elfPath] };
+        }
+        else {
+            throw new Error(`Not support disassembly for toolchain: '${toolchainName}' !`);
+        }
+
+        if (!File.IsFile(tool.path))
+            throw new Error(`Not found '${NodePath.basename(tool.path)}' !`);
+
+        return tool;
+    }
+
+    private runDisassembler(tool: DisassemblerTool, elfPath: string, range: DisassemblyRange | undefined,
+        onPartial: (content: string) => void): Promise<string> {
+
+        return new Promise((resolve, reject) => {
+
+            const chunks: string[] = [];
+            let lastUpdate = Date.now();
+            let stderr = '';
+
+            const proc = child_process.spawn(tool.path, tool.args(elfPath, range), {
+                cwd: NodePath.dirname(elfPath),
+                windowsHide: true
+            });
+
+            proc.stdout.setEncoding('utf8');
+            proc.stdout.on('data', (chunk: string) => {
+                chunks.push(chunk);
+                const now = Date.now();
+                if (now - lastUpdate >= STREAM_UPDATE_INTERVAL) {
+                    lastUpdate = now;
+                    onPartial(chunks.join(''));
+                }
+            });
+
+            proc.stderr.setEncoding('utf8');
+            proc.stderr.on('data', (chunk: string) => {
+                if (stderr.length < 4096) stderr += chunk;
+            });
+
+            proc.on('error', (err) => reject(err));
+            proc.on('close', (code) => {
+                if (code != 0 && chunks.length == 0) {
+                    reject(new Error(`'${NodePath.basename(tool.path)}' exit with code ${code}: ${stderr}`));
+                    return;
+                }
+                if (stderr) GlobalEvent.log_warn(stderr);
+                resolve(chunks.join(''));
+            });
+        });
+    }
+}
@@ -60,7 +60,7 @@ import * as platform from './Platform';
 import {
     md5, copyObject, compareVersion, isGccFamilyToolchain, deepCloneObject, 
     notifyReloadWindow, copyAndMakeObjectKeysToLowerCase, sendCommandToTerminal, 
-    execInternalCommand, cxxDemangle
+    execInternalCommand, getCxxDemangler
 } from './utility';
 import { ResInstaller } from './ResInstaller';
 import {
@@ -86,6 +86,10 @@ import { EventData, CurrentDevice, ArmBaseCompileConfigModel, ArmBaseCompileData
 import * as FileLock from '../lib/node-utility/FileLock';
 import { CompilerCommandsDatabaseItem, CodeBuilder } from './CodeBuilder';
 import { xpackRequireDevTools } from './XpackDevTools';
+import { ElfFile, isElfFile, getGnuSymbolTypeChar } from './ElfReader';
+import { isMangledName } from './CxxDemangler';
+import { writeMacroHeader } from './MacroHeader';
+import { Tracer } from './Tracer';
 
 export class CheckError extends Error {
 }
@@ -721,6 +725,10 @@ class SourceRootList implements SourceProvider {
 
         rootFolderInfo.needUpdate = false;
 
+        const span = Tracer.span('SourceRootList.updateFolder', 'source',
+            () => ({ root: rootFolder.path, partial: targetFolderList != undefined }));
+        let folderCount = 0;
+
         try {
 
             while (folderStack.length > 0) {
@@ -734,6 +742,8 @@ class SourceRootList implements SourceProvider {
                 if (cFolder.name.startsWith('.') && !isSourceRoot)
                     continue; // skip sub '.xxx' folders, but not root folder
 
+                folderCount++;
+
                 const fileList = cFolder.GetList(fileFilter, File.EXCLUDE_ALL_FILTER);
                 if (fileList.length > 0) {
 
@@ -784,6 +794,8 @@ class SourceRootList implements SourceProvider {
             rootFolderInfo.needUpdate = true; // set need update flag
             GlobalEvent.log_warn(error);
         }
+
+        span.end(() => ({ folders: folderCount, groups: rootFolderInfo.fileGroups.length }));
     }
 }
 
@@ -871,6 +883,9 @@ export abstract class AbstractProject implements CustomConfigurationProvider, Pr
 
     private lock_handle: number | undefined;
 
+    /** increased on every change of the project, see 'getConfigVersion()' */
+    private configVersion: number = 0;
+
     //-----------------------------------------------------------
     //- cpptools provider interface
     //-----------------------------------------------------------
@@ -924,6 +939,14 @@ export abstract class AbstractProject implements CustomConfigurationProvider, Pr
         return miscInfo.uid;
     }
 
+    /**
+     * A counter which is increased on every change of the project (config, target, sources ...),
+     * the results computed from the project can be cached until it is changed.
+    */
+    public getConfigVersion(): number {
+        return this.configVersion;
+    }
+
     public toolchainName(): ToolchainName {
         return this.getToolchain().name;
     }
@@ -1076,6 +1099,9 @@ export abstract class AbstractProject implements CustomConfigurationProvider, Pr
     protected emit(event: 'targetSwitched', t: { name: string, isNew?: boolean; }): boolean;
     protected emit(event: 'projectFileChanged'): boolean;
     protected emit(event: any, argc?: any): boolean {
+        // all the changes of the project are notified by these events
+        this.configVersion++;
+        this._event.emit('configVersionChanged', this.configVersion);
         return this._event.emit(event, argc);
     }
 
@@ -1083,6 +1109,7 @@ export abstract class AbstractProject implements CustomConfigurationProvider, Pr
     on(event: 'cppConfigChanged', listener: () => void): this;
     on(event: 'targetSwitched', listener: (t: { name: string, isNew?: boolean; }) => void): this;
     on(event: 'projectFileChanged', listener: () => void): this;
+    on(event: 'configVersionChanged', listener: (version: number) => void): this;
     on(event: any, listener: (argc?: any) => void): this {
         this._event.on(event, listener);
         return this;
@@ -2651,7 +2678,7 @@ $(OUT_DIR):
                 let elfpath = '';
                 let elftool = '';
                 let elfcmds = [''];
-                let cxxfilt: string | undefined; // c++filt tools
+                const cxxfilt = prj.getCxxFiltPath(); // c++filt tools
 
                 let staMatcher: RegExp | undefined;
                 let endMatcher: RegExp | undefined;
@@ -2705,7 +2732,6 @@ $(OUT_DIR):
                     case 'MTI_GCC':
                         elfpath = prj.getExecutablePath();
                         elftool = [toolchain.getToolchainDir().path, 'bin', `${toolchainPrefix}nm${platform.exeSuffix()}`].join(File.sep);
-                        cxxfilt = [toolchain.getToolchainDir().path, 'bin', `${toolchainPrefix}c++filt${platform.exeSuffix()}`].join(File.sep);
                         elfcmds = ['-ln', '-S', elfpath];
                         symMatcher = /^(?<addr>[0-9a-f]+)\s+(?<size>[0-9a-f]+\s+)?(?<type>\w)\s+(?<name>[^\s]+)\s+(?<loca>.*)/i;
                         symTypConv = (t) => this.convGnuSymbolType2ReadableString(t)
@@ -2732,7 +2758,6 @@ $(OUT_DIR):
                         // 20011c14 00000001 B __lock___libc_recursive_mutex
                         elfpath = prj.getExecutablePath();
                         elftool = [toolchain.getToolchainDir().path, 'bin', `llvm-nm${platform.exeSuffix()}`].join(File.sep);
-                        cxxfilt = [toolchain.getToolchainDir().path, 'bin', `llvm-cxxfilt${platform.exeSuffix()}`].join(File.sep);
                         elfcmds = ['-ln', '-S', elfpath];
                         symMatcher = /^(?<addr>[0-9a-f]+)\s+(?<size>[0-9a-f]+\s+)?(?<type>\w)\s+(?<name>[^\s]+)\s+(?<loca>.*)/i;
                         symTypConv = (t) => this.convGnuSymbolType2ReadableString(t)
@@ -2752,10 +2777,6 @@ $(OUT_DIR):
                     throw new Error(`Not found elf file: '${elfpath}', please build your project !`);
                 }
 
-                if (!File.IsFile(elftool)) {
-                    throw new Error(`Not found elf tool: '${elftool}' !`);
-                }
-
                 // Don't use 'child_process.execFileSync' because a huge file 
                 // will cause an ENOBUF Error.
                 const doReadSymbolLines = (toolpath: string, cmds: string[]): Promise<string[]> => {
@@ -2775,6 +2796,20 @@ $(OUT_DIR):
                     });
                 };
 
+                // read symbols from elf directly, only use external tools for non-elf outputs
+                if (isElfFile(elfpath)) {
+                    allSymbols.push(...this.readElfSymbolsNative(elfpath));
+                    // the symbol table only has the file names of the locals, the line info ('file:line')
+                    // is resolved by 'resolveSymbolLocation()' when a symbol is opened, 'nm -l' is too slow
+                    await prj.demangleSymbolNames(allSymbols, cxxfilt);
+                    resolve(allSymbols);
+                    return;
+                }
+
+                if (!File.IsFile(elftool)) {
+                    throw new Error(`Not found elf tool: '${elftool}' !`);
+                }
+
                 let textLines = await doReadSymbolLines(elftool, elfcmds);
 
                 // filter lines
@@ -2843,10 +2878,6 @@ $(OUT_DIR):
                         continue;
                     }
 
-                    // C++ symbol name demangler
-                    if (cxxfilt && name.startsWith('_Z'))
-                        name = cxxDemangle(name, cxxfilt);
-
                     if (type && symTypConv) {
                         type = symTypConv(type);
                     }
@@ -2866,6 +2897,8 @@ $(OUT_DIR):
                     allSymbols.push({ addr, size, type, name, loca });
                 }
 
+                await prj.demangleSymbolNames(allSymbols, cxxfilt);
+
                 resolve(allSymbols);
 
             } catch (error) {
@@ -2881,6 +2914,143 @@ $(OUT_DIR):
         });
     }
 
+    /**
+     * Get the c++filt tool of current toolchain, undefined if the toolchain not have it
+    */
+    getCxxFiltPath(): string | undefined {
+
+        const toolchain = this.getToolchain();
+        const toolchainPrefix = toolchain.getToolchainPrefix ? toolchain.getToolchainPrefix() : '';
+
+        switch (toolchain.name) {
+            case 'GCC':
+            case 'RISCV_GCC':
+            case 'ANY_GCC':
+            case 'MIPS_GCC':
+            case 'MTI_GCC':
+                return [toolchain.getToolchainDir().path, 'bin', `${toolchainPrefix}c++filt${platform.exeSuffix()}`].join(File.sep);
+            case 'LLVM_ARM':
+                return [toolchain.getToolchainDir().path, 'bin', `llvm-cxxfilt${platform.exeSuffix()}`].join(File.sep);
+            default:
+                return undefined;
+        }
+    }
+
+    private getAddr2LinePath(): string | undefined {
+
+        const toolchain = this.getToolchain();
+        const toolchainPrefix = toolchain.getToolchainPrefix ? toolchain.getToolchainPrefix() : '';
+
+        switch (toolchain.name) {
+            case 'GCC':
+            case 'RISCV_GCC':
+            case 'ANY_GCC':
+            case 'MIPS_GCC':
+            case 'MTI_GCC':
+                return [toolchain.getToolchainDir().path, 'bin', `${toolchainPrefix}addr2line${platform.exeSuffix()}`].join(File.sep);
+            case 'LLVM_ARM':
+                return [toolchain.getToolchainDir().path, 'bin', `llvm-addr2line${platform.exeSuffix()}`].join(File.sep);
+            case 'GNU_SDCC_MCS51':
+                return [toolchain.getToolchainDir().path, 'bin', `i51-elf-addr2line${platform.exeSuffix()}`].join(File.sep);
+            default:
+                return undefined;
+        }
+    }
+
+    /**
+     * Resolve the source location of a symbol address by the debug info ('addr2line'),
+     * it's done for one symbol when it's opened, the line lookup of all symbols is slow
+     *
+     * @returns undefined if the tool is not available or the address has no line info
+    */
+    resolveSymbolLocation(addr: string): Promise<{ path: string, line: number } | undefined> {
+
+        const addr2line = this.getAddr2LinePath();
+        const elfpath = this.getExecutablePath();
+        if (addr2line == undefined || !File.IsFile(addr2line) || !File.IsFile(elfpath))
+            return Promise.resolve(undefined);
+
+        return new Promise((resolve) => {
+            child_process.execFile(addr2line, ['-e', elfpath, addr], { timeout: 10 * 1000, windowsHide: true }, (err, stdout) => {
+                // '/path/main.c:45', '/path/main.c:45 (discriminator 1)' or '??:0'
+                const m = err ? null : /^(.+?):(\d+)/.exec(stdout.toString().trim());
+                if (m && m[1] != '??' && m[2] != '0')
+                    resolve({ path: this.toAbsolutePath(m[1]), line: parseInt(m[2]) });
+                else
+                    resolve(undefined);
+            });
+        });
+    }
+
+    /**
+     * Demangle C++ symbol names in place, all names are handled by one c++filt process
+    */
+    private async demangleSymbolNames(symbols: SymbolInfo[], cxxfilt: string | undefined) {
+
+        if (cxxfilt == undefined || !File.IsFile(cxxfilt))
+            return;
+
+        const names = symbols.filter(s => isMangledName(s.name)).map(s => s.name);
+        if (names.length == 0)
+            return;
+
+        const demangler = getCxxDemangler();
+        const nameMap = await demangler.demangle(names, cxxfilt);
+        symbols.forEach((s) => {
+            s.name = nameMap.get(s.name) || s.name;
+        });
+        demangler.flush();
+    }
+
+    private readElfSymbolsNative(elfpath: string): SymbolInfo[] {
+
+        const allSymbols: SymbolInfo[] = [];
+        const elf = ElfFile.open(elfpath);
+
+        // 'STT_FILE' is only a file name (like 'main.c'), find it in the source list
+        const sourceMap = new Map<string, string | undefined>();
+        this.getAllSources().forEach((src) => {
+            const name = NodePath.basename(src.path);
+            sourceMap.set(name, sourceMap.has(name) ? undefined : this.toAbsolutePath(src.path)); // not unique
+        });
+
+        try {
+
+            let sym_cur_file_location: string | undefined;
+
+            elf.forEachSymbol((sym) => {
+
+                if (sym.type == 'FILE') {
+                    sym_cur_file_location = sym.name ? (sourceMap.get(NodePath.basename(sym.name)) || sym.name) : undefined;
+                    return;
+                }
+
+                // skip null entry, section symbols and arm/riscv mapping symbols ($t, $d, $x ...)
+                if (sym.name == '' || sym.type == 'SECTION' || sym.name.startsWith('$'))
+                    return;
+
+                let loca = '--';
+                if (sym.bind == 'LOCAL' && sym_cur_file_location)
+                    loca = sym_cur_file_location;
+                else if (sym.section)
+                    loca = sym.section;
+
+                allSymbols.push({
+                    addr: '0x' + sym.value.toString(16).padStart(8, '0'),
+                    size: sym.size.toString(),
+                    type: this.convGnuSymbolType2ReadableString(getGnuSymbolTypeChar(sym, elf.sections)),
+                    name: sym.name,
+                    loca: loca
+                });
+            });
+
+        } finally {
+            elf.close();
+        }
+
+        return allSymbols;
+    }
+
     //---
 
     protected loadToolchain() {
@@ -4318,6 +4488,38 @@ class EIDEProject extends AbstractProject {
         }
     }
 
+    /**
+     * Generate a forced include header from the compiler macros of the current target,
+     * the builtin headers of the toolchain are included by it.
+     * Use the builtin headers if the toolchain has no macros (gcc/clang: cpptools queries the compiler)
+    */
+    private _getIntelliSenseHeaders<T extends BuilderConfigData>(
+        toolchain: IToolchian, builderCfg: T, builderOpts: BuilderOptions): { headers: string[], generated: boolean } {
+
+        const baseHeaders = toolchain.getForceIncludeHeaders() || [];
+
+        if (isGccFamilyToolchain(toolchain.name) || toolchain.name == 'LLVM_ARM') {
+            return { headers: baseHeaders, generated: false };
+        }
+
+        try {
+            const macros = toolchain.getInternalDefines(builderCfg, builderOpts);
+            if (macros.length > 0) {
+                const outDir = File.fromArray([ResManager.GetInstance().getEideHomeFolder().path, 'intellisense']);
+                const header = writeMacroHeader(outDir.path, {
+                    toolchain: toolchain.name,
+                    macros: macros,
+                    baseHeaders: baseHeaders
+                });
+                return { headers: [header], generated: true };
+            }
+        } catch (error) {
+            GlobalEvent.log_warn(<Error>error);
+        }
+
+        return { headers: baseHeaders, generated: false };
+    }
+
     private _getCompilerIntrDefsForCpptools<T extends BuilderConfigData>(
         toolchain: IToolchian, builderCfg: T, builderOpts: BuilderOptions): string[] {
 
@@ -4358,7 +4560,9 @@ class EIDEProject extends AbstractProject {
         // get project includes and defines
         const depMerge = prjConfig.GetAllMergeDep();
         const defMacros: string[] = ['__VSCODE_CPPTOOL']; // it's for internal force include header
-        const intrDefs = this._getCompilerIntrDefsForCpptools(toolchain, <any>prjConfig.config.toolchainConfig, builderOpts);
+        const intrHeaders = this._getIntelliSenseHeaders(toolchain, <any>prjConfig.config.toolchainConfig, builderOpts);
+        const intrDefs = intrHeaders.generated ? [] :
+            this._getCompilerIntrDefsForCpptools(toolchain, <any>prjConfig.config.toolchainConfig, builderOpts);
         const defLi = defMacros.concat(depMerge.defineList, intrDefs);
         depMerge.incList = depMerge.incList.concat(this.getSourceIncludeList()).map(p => this.ToAbsolutePath(p));
 
@@ -4498,7 +4702,7 @@ class EIDEProject extends AbstractProject {
         // update forceinclude headers
         this.cppToolsConfig.forcedInclude = [];
 
-        toolchain.getForceIncludeHeaders()?.forEach((f_path) => {
+        intrHeaders.headers.forEach((f_path) => {
             this.cppToolsConfig.forcedInclude?.push(File.normalize(f_path));
         });
 
@@ -4548,6 +4752,8 @@ class EIDEProject extends AbstractProject {
 
         return new Promise((resolve) => {
 
+            const span = Tracer.span('cpptools.provideConfigurations', 'intellisense', () => ({ files: uris.length }));
+
             resolve(uris.map((uri) => {
 
                 let fileArgs: string[] | undefined;
@@ -4610,6 +4816,8 @@ class EIDEProject extends AbstractProject {
                     };
                 }
             }));
+
+            span.end();
         });
     }
 
@@ -101,9 +101,9 @@ import { SevenZipper, CompressOption } from './Compress';
 import { DependenceManager } from './DependenceManager';
 import { ArrayDelRepetition } from '../lib/node-utility/Utility';
 import {
-    copyObject, downloadFileWithProgress,
-    sendCommandToTerminal, redirectHost, readGithubRepoFolder, FileCache,
-    genGithubHash, md5, toArray, newMarkdownString, newFileTooltipString, FileTooltipInfo, escapeXml,
+    copyObject, downloadFileToDisk,
+    sendCommandToTerminal, redirectHost, readGithubRepoFolder,
+    md5, toArray, newMarkdownString, newFileTooltipString, FileTooltipInfo, escapeXml,
     readGithubRepoTxtFile, downloadFile, notifyReloadWindow, formatPath, execInternalCommand,
     copyAndMakeObjectKeysToLowerCase,
     sortPaths,
@@ -115,11 +115,14 @@ import {
     generateDotnetProgramCmd,
     isGccFamilyToolchain,
     cxxDemangle,
+    getCxxDemangler,
     DEBUGGER_MAPS
 } from './utility';
 import { concatSystemEnvPath, DeleteDir, exeSuffix, kill, osType, DeleteAllChildren, userhome, getGlobalState } from './Platform';
 import { KeilARMOption, KeilC51Option, KeilParser, KeilRteDependence } from './KeilXmlParser';
 import { VirtualDocument } from './VirtualDocsProvider';
+import { DisassemblyProvider } from './DisassemblyProvider';
+import { ElfFile } from './ElfReader';
 import { ResInstaller } from './ResInstaller';
 import { ExeCmd, ExecutableOption, ExeFile } from '../lib/node-utility/Executable';
 import { CmdLineHandler } from './CmdLineHandler';
@@ -147,6 +150,13 @@ import { StatusBarManager } from './StatusBarManager';
 import { doMigration, detectProject } from './EIDEProjectMigration';
 import { onRegisterClangdProvider } from './clangdConfigProvider';
 import * as hooks from './Hooks';
+import { SizeHistory, formatSizeDiff } from './SizeHistory';
+import { GANG_REPORT_FILE_NAME, formatGangReport, parseProbeSerials, runGang } from './GangProgrammer';
+import { Tracer } from './Tracer';
+import {
+    BULK_IMPORT_REPORT_FILE_NAME, BulkImportReport, BulkVerifyResult, HeadlessImportReport,
+    formatBulkImportReport, runBulkImport, scanImportableProjects
+} from './BulkImporter';
 
 enum TreeItemType {
     SOLUTION,
@@ -1873,9 +1883,14 @@ class ProjectDataProvider implements vscode.TreeDataProvider<ProjTreeItem>, vsco
         }
 
         try {
-            await doMigration(File.from(wsFile.dir));
-            const prj = AbstractProject.NewProject(workspaceState);
-            await prj.Load(wsFile);
+            const prj = await Tracer.traceAsync('project.open', 'project', async () => {
+                await doMigration(File.from(wsFile.dir));
+                const prj = AbstractProject.NewProject(workspaceState);
+                await prj.Load(wsFile);
+                return prj;
+            }, () => ({ path: wsFile.path }));
+            if (Tracer.enabled)
+                Tracer.counter('heapUsed (MB)', Math.round(process.memoryUsage().heapUsed / 1048576));
             this.registerProject(prj);
             GlobalEvent.emit('project.opened', prj);
             return prj;
@@ -1989,16 +2004,36 @@ class ProjectDataProvider implements vscode.TreeDataProvider<ProjTreeItem>, vsco
         }
     }
 
-    private async ImportIarProject(option: ImportOptions) {
+    /**
+     * Import a project without any ui, the warnings are collected into the report
+    */
+    async ImportProjectHeadless(option: ImportOptions, report: HeadlessImportReport): Promise<void> {
+        switch (option.type) {
+            case 'mdk':
+                return this.ImportKeilProject(option, report);
+            case 'eclipse':
+                return this.ImportEclipseProject(option, report);
+            case 'iar':
+                return this.ImportIarProject(option, report);
+            default:
+                throw new Error(`Not support project type: '${option.type}'`);
+        }
+    }
+
+    private async ImportIarProject(option: ImportOptions, report?: HeadlessImportReport) {
 
         if (!ToolchainManager.getInstance().isToolchainPathReady('IAR_ARM')) {
             const msg = `Your 'IAR_ARM' toolchain path is invalid, we suggest that you set it before start to import !`;
-            const ans = await vscode.window.showWarningMessage(msg, `Ok`, 'Skip');
-            if (ans != 'Skip') {
-                if (ans == 'Ok') { // jump to setup toolchain
-                    vscode.commands.executeCommand('eide.operation.install_toolchain');
+            if (report) {
+                report.warnings.push(msg);
+            } else {
+                const ans = await vscode.window.showWarningMessage(msg, `Ok`, 'Skip');
+                if (ans != 'Skip') {
+                    if (ans == 'Ok') { // jump to setup toolchain
+                        vscode.commands.executeCommand('eide.operation.install_toolchain');
+                    }
+                    return;
                 }
-                return;
             }
         }
 
@@ -2263,6 +2298,11 @@ class ProjectDataProvider implements vscode.TreeDataProvider<ProjTreeItem>, vsco
         // store vscode workspace
         fs.writeFileSync(vscWorkspaceFile.path, JSON.stringify(vscWorkspace, undefined, 4));
 
+        if (report) {
+            report.workspaceFile = project0workspacefile.path;
+            return;
+        }
+
         // switch project
         const selection = await vscode.window.showInformationMessage(
             view_str$operation$import_done, continue_text, cancel_text);
@@ -2273,7 +2313,7 @@ class ProjectDataProvider implements vscode.TreeDataProvider<ProjTreeItem>, vsco
         }
     }
 
-    private async ImportEclipseProject(option: ImportOptions) {
+    private async ImportEclipseProject(option: ImportOptions, report?: HeadlessImportReport) {
 
         const ePrjInfo = await eclipseParser.parseEclipseProject(option.projectFile.path);
         const ePrjRoot = new File(option.projectFile.dir);
@@ -2526,6 +2566,11 @@ class ProjectDataProvider implements vscode.TreeDataProvider<ProjTreeItem>, vsco
         const optFile = File.fromArray([basePrj.rootFolder.path, AbstractProject.EIDE_DIR, `files.options.yml`]);
         optFile.Write(view_str$prompt$filesOptionsComment + yaml.stringify(srcOptsObj, { indent: 4, lineWidth: 1000 }));
 
+        if (report) {
+            report.workspaceFile = basePrj.workspaceFile.path;
+            return;
+        }
+
         // switch project
         const selection = await vscode.window.showInformationMessage(
             view_str$operation$import_done, continue_text, cancel_text);
@@ -2534,12 +2579,17 @@ class ProjectDataProvider implements vscode.TreeDataProvider<ProjTreeItem>, vsco
         }
     }
 
-    private async ImportKeilProject(option: ImportOptions) {
+    private async ImportKeilProject(option: ImportOptions, report?: HeadlessImportReport) {
 
         const keilPrjFile = option.projectFile;
-        const keilParser = KeilParser.NewInstance(option.projectFile, <any>option.mdk_prod);
+        const keilParser = await KeilParser.Load(option.projectFile, option.mdk_prod);
         const targets = keilParser.ParseData();
 
+        const logWarn = (msg: string) => {
+            GlobalEvent.log_warn(msg);
+            report?.warnings.push(msg);
+        };
+
         if (targets.length == 0) {
             throw Error(`Not found any target in '${keilPrjFile.path}' !`);
         }
@@ -2662,14 +2712,14 @@ class ProjectDataProvider implements vscode.TreeDataProvider<ProjTreeItem>, vsco
 
                 // check category
                 if (!(dep.category && fileTypeMatchers.some(reg => reg.test(dep.category || '')))) {
-                    GlobalEvent.log_warn(`[Keil RTE Import] dependence '${dep.name}' is not a source file !`);
+                    logWarn(`[Keil RTE Import] dependence '${dep.name}' is not a source file !`);
                     unresolved_deps.push(dep); /* resolve failed !, store dep */
                     return;
                 }
 
                 // check source file
                 if (!dep.instance) {
-                    GlobalEvent.log_warn(`[Keil RTE Import] dependence '${dep.name}' have no instances !`);
+                    logWarn(`[Keil RTE Import] dependence '${dep.name}' have no instances !`);
                     unresolved_deps.push(dep); /* resolve failed !, store dep */
                     return;
                 }
@@ -2678,7 +2728,7 @@ class ProjectDataProvider implements vscode.TreeDataProvider<ProjTreeItem>, vsco
                 const vFolder = getVirtualFolder(`${VirtualSource.rootName}/::${dep.class}`, false);
 
                 if (!vFolder) {
-                    GlobalEvent.log_warn(`[Keil RTE Import] No such folder '::${dep.class}'`);
+                    logWarn(`[Keil RTE Import] No such folder '::${dep.class}'`);
                     unresolved_deps.push(dep); /* resolve failed !, store dep */
                     return;
                 }
@@ -2688,7 +2738,7 @@ class ProjectDataProvider implements vscode.TreeDataProvider<ProjTreeItem>, vsco
 
                     /* check condition */
                     if (!File.IsFile(srcPath)) {
-                        GlobalEvent.log_warn(`[Keil RTE Import] No such file '${srcPath}'`);
+                        logWarn(`[Keil RTE Import] No such file '${srcPath}'`);
                         continue;
                     }
 
@@ -2744,12 +2794,16 @@ class ProjectDataProvider implements vscode.TreeDataProvider<ProjTreeItem>, vsco
                     lines.push(nLine.join(os.EOL));
                 });
 
-                const cont = lines.join(`${os.EOL}${os.EOL}`);
-                const file = File.fromArray([baseInfo.rootFolder.path, `keil.${AbstractProject.importerWarningBaseName}`]);
-                file.Write(cont); // write content to file
-                const doc = await vscode.workspace.openTextDocument(vscode.Uri.parse(file.ToUri()));
-                vscode.window.showTextDocument(doc, { preview: false });
-                GlobalEvent.log_show();
+                if (report) {
+                    report.warnings.push(lines.slice(1).join(os.EOL));
+                } else {
+                    const cont = lines.join(`${os.EOL}${os.EOL}`);
+                    const file = File.fromArray([baseInfo.rootFolder.path, `keil.${AbstractProject.importerWarningBaseName}`]);
+                    file.Write(cont); // write content to file
+                    const doc = await vscode.workspace.openTextDocument(vscode.Uri.parse(file.ToUri()));
+                    vscode.window.showTextDocument(doc, { preview: false });
+                    GlobalEvent.log_show();
+                }
             }
         }
 
@@ -2907,6 +2961,11 @@ class ProjectDataProvider implements vscode.TreeDataProvider<ProjTreeItem>, vsco
         const optFile = File.fromArray([baseInfo.rootFolder.path, AbstractProject.EIDE_DIR, `files.options.yml`]);
         optFile.Write(view_str$prompt$filesOptionsComment + yaml.stringify(srcOptsObj, { indent: 4, lineWidth: 1000 }));
 
+        if (report) {
+            report.workspaceFile = baseInfo.workspaceFile.path;
+            return;
+        }
+
         // switch project
         const selection = await vscode.window.showInformationMessage(
             view_str$operation$import_done, continue_text, cancel_text);
@@ -3611,7 +3670,7 @@ export class ProjectExplorer implements CustomConfigurationProvider {
 
     // -------
 
-    createSysStubs(prjuid: string | undefined) {
+    createSysStubs(prjuid: string | undefined, retarget?: boolean) {
 
         const prj = prjuid 
             ? this.dataProvider.getProjectByUid(prjuid)
@@ -3619,23 +3678,40 @@ export class ProjectExplorer implements CustomConfigurationProvider {
         if (!prj)
             return; // no project
 
-        const tarFile = File.from(prj.getRootDir().path, 'sys_stubs.c');
-        for (const grp of prj.getFileGroups()) {
-            for (const e of grp.files) {
-                if (tarFile.path === e.file.path)
-                    return; // it's existed, abort.
-            }
+        // retarget lib: buffered '_write', '_sbrk' with watermark, '_times' ...
+        // the others are still provided by the weak stubs in 'sys_stubs.c'
+        const srcList: { src: string, dst: string }[] = [
+            { src: 'gcc_posix_stubs.c', dst: 'sys_stubs.c' }
+        ];
+        if (retarget) {
+            srcList.push({ src: 'gcc_retarget.h', dst: 'gcc_retarget.h' });
+            srcList.push({ src: 'gcc_retarget.c', dst: 'gcc_retarget.c' });
         }
 
+        const existed = (f: File) => prj.getFileGroups().some(grp => grp.files.some(e => e.file.path === f.path));
+
         try {
-            const srcFile = File.from(ResManager.instance().getAppDataDir().path, 'gcc_posix_stubs.c');
-            tarFile.Write(srcFile.Read());
+            const added: string[] = [];
             const vSrcManger = prj.getVirtualSourceManager();
-            vSrcManger.addFile(VirtualSource.rootName, tarFile.path);
+            for (const item of srcList) {
+                const tarFile = File.from(prj.getRootDir().path, item.dst);
+                if (existed(tarFile))
+                    continue;
+                if (!tarFile.IsFile() || tarFile.name.endsWith('.c')) {
+                    const srcFile = File.from(ResManager.instance().getAppDataDir().path, item.src);
+                    tarFile.Write(srcFile.Read());
+                }
+                if (tarFile.name.endsWith('.c')) {
+                    vSrcManger.addFile(VirtualSource.rootName, tarFile.path);
+                    added.push(tarFile.name);
+                }
+            }
+            if (added.length == 0)
+                return; // it's existed, abort.
             // clear diags
             const uri = vscode.Uri.file(File.from(prj.getOutputFolder().path, 'compiler.log').path);
             this.compiler_diags.get(prj.getUid())?.delete(uri);
-            GlobalEvent.show_msgbox('Info', view_str$missed_stubs_added.replace('{}', tarFile.name));
+            GlobalEvent.show_msgbox('Info', view_str$missed_stubs_added.replace('{}', added.join('", "')));
         } catch (error) {
             GlobalEvent.show_msgbox('Error', error);
         }
@@ -4010,7 +4086,10 @@ export class ProjectExplorer implements CustomConfigurationProvider {
     }
 
     private _builderLock: boolean = false;
-    async buildProject(prj?: AbstractProject, options?: BuildOptions, noTerminal?: boolean): Promise<{ success: boolean; message: string; }> {
+    /**
+     * @param onOutput receives the builder output while building, only used with 'noTerminal'
+    */
+    async buildProject(prj?: AbstractProject, options?: BuildOptions, noTerminal?: boolean, onOutput?: (text: string) => void): Promise<{ success: boolean; message: string; }> {
 
         if (prj === undefined) {
             GlobalEvent.show_msgbox('Warning', 'No active project !');
@@ -4028,6 +4107,10 @@ export class ProjectExplorer implements CustomConfigurationProvider {
             };
         }
 
+        const span = Tracer.asyncSpan('project.build', 'build',
+            () => ({ project: prj.getProjectName(), rebuild: options?.notRebuild === false }));
+        let success = false;
+
         try {
             this._builderLock = true;
 
@@ -4049,7 +4132,7 @@ export class ProjectExplorer implements CustomConfigurationProvider {
                         if (buildbar) {
                             buildbar.text = `$(loading~spin) Building`;
                         }
-                        child_process.exec(commandLine, { cwd: prj.getProjectRoot().path }, (error, stdout, stderr) => {
+                        const proc = child_process.exec(commandLine, { cwd: prj.getProjectRoot().path }, async (error, stdout, stderr) => {
                             prj.notifyUpdateSourceRefs(toolchain);
                             this.notifyUpdateOutputFolder(prj);
                             this.updateCompilerDiagsAfterBuild(prj);
@@ -4060,6 +4143,11 @@ export class ProjectExplorer implements CustomConfigurationProvider {
                                     success: false,
                                     message: `Failed.\n\nError: ${error.message}\n\nBuilder log:\n\n${stdout.toString()}`
                                 });
+                            } else if (!(await hooks.recordBuildSize(prj))) {
+                                resolve({
+                                    success: false,
+                                    message: `Failed.\n\nError: size budget exceeded, see the eide log for details.\n\nBuilder log:\n\n${stdout.toString()}`
+                                });
                             } else {
                                 resolve({
                                     success: true,
@@ -4067,6 +4155,10 @@ export class ProjectExplorer implements CustomConfigurationProvider {
                                 });
                             }
                         });
+                        if (onOutput) {
+                            proc.stdout?.on('data', (data) => onOutput(data.toString()));
+                            proc.stderr?.on('data', (data) => onOutput(data.toString()));
+                        }
                     } else {
                         resolve({
                             success: false,
@@ -4086,15 +4178,16 @@ export class ProjectExplorer implements CustomConfigurationProvider {
                     });
 
                     // build finish event
-                    builder.on('finished', (done) => {
+                    builder.on('finished', async (done) => {
                         prj.notifyUpdateSourceRefs(toolchain);
                         this.notifyUpdateOutputFolder(prj);
                         this.updateCompilerDiagsAfterBuild(prj);
-                        if (options?.flashAfterBuild && done)
+                        const sizeOk = done ? await hooks.recordBuildSize(prj) : true;
+                        hooks.onProjectBuildFinished(prj, done && sizeOk);
+                        if (options?.flashAfterBuild && done && sizeOk)
                             this.programFlashProject(prj);
                         this.dataProvider.updateStatusBarForActiveProjects();
-                        hooks.onProjectBuildFinished(prj, done);
-                        if (done) {
+                        if (done && sizeOk) {
                             resolve({
                                 success: true,
                                 message: 'Succeed.'
@@ -4115,6 +4208,7 @@ export class ProjectExplorer implements CustomConfigurationProvider {
             });
 
             this._builderLock = false;
+            success = res.success;
             return res;
 
         } catch (error) {
@@ -4124,6 +4218,8 @@ export class ProjectExplorer implements CustomConfigurationProvider {
                 success: false,
                 message: `${ExceptionToMessage(error).type}:${ExceptionToMessage(error).content}`
             };
+        } finally {
+            span.end(() => ({ success }));
         }
     }
 
@@ -4411,7 +4507,10 @@ export class ProjectExplorer implements CustomConfigurationProvider {
     }
 
     private _uploadLock: boolean = false;
-    async programFlashProject(prj?: AbstractProject, eraseAll?: boolean, noTerminal?: boolean): Promise<FlashCommandResult | void> {
+    /**
+     * @param onOutput receives the flasher output, only used with 'noTerminal'
+    */
+    async programFlashProject(prj?: AbstractProject, eraseAll?: boolean, noTerminal?: boolean, onOutput?: (text: string) => void): Promise<FlashCommandResult | void> {
 
         if (prj === undefined) {
             GlobalEvent.show_msgbox('Warning', 'No active project !');
@@ -4432,10 +4531,14 @@ export class ProjectExplorer implements CustomConfigurationProvider {
         this._uploadLock = true;
 
         let result: FlashCommandResult | void;
+        const span = Tracer.asyncSpan('project.flash', 'flash',
+            () => ({ project: prj.getProjectName(), eraseAll: eraseAll || false }));
         try {
             const uploader = HexUploaderManager.getInstance().createUploader(prj);
-            if (noTerminal)
+            if (noTerminal) {
                 uploader.disableTerminal();
+                uploader.setOutputListener(onOutput);
+            }
             result = await uploader.upload(eraseAll);
         } catch (error) {
             GlobalEvent.emit('error', error);
@@ -4446,11 +4549,207 @@ export class ProjectExplorer implements CustomConfigurationProvider {
             };
         }
 
+        span.end(() => ({ success: result ? result.success : false }));
         this._uploadLock = false;
 
         return result;
     }
 
+    /**
+     * Flash the same image onto many boards, one probe for each board, see 'EIDE.Flasher.Gang.*'
+    */
+    async gangFlashProject(prjItem?: ProjTreeItem) {
+
+        const prj = this.getProjectByTreeItem(prjItem);
+        if (prj === undefined) {
+            GlobalEvent.show_msgbox('Warning', 'No active project !');
+            return;
+        }
+
+        if (this._uploadLock) {
+            GlobalEvent.show_msgbox('Warning', 'Busy ! Please wait.');
+            return;
+        }
+
+        const settings = SettingManager.instance();
+
+        let serials = parseProbeSerials(settings.getGangProbeSerials());
+        if (serials.length == 0) {
+            const input = await vscode.window.showInputBox({
+                placeHolder: 'SN1, SN2, ...',
+                prompt: 'Input the serial numbers of the probes, separated by \',\'',
+                ignoreFocusOut: true
+            });
+            if (!input)
+                return;
+            serials = parseProbeSerials(input);
+            if (serials.length == 0)
+                return;
+        }
+
+        this._uploadLock = true;
+
+        try {
+
+            const flasher = HexUploaderManager.getInstance().createUploader(prj);
+            if (!flasher.isProbeSelectable()) {
+                const hint = flasher.toolType == 'Custom' ? ` Use '\${probeSerial}' or the env 'EIDE_PROBE_SERIAL' in the flash command.` : '';
+                throw new Error(`Gang flash is not supported by '${flasher.toolType}' flasher, it can not select a probe by the serial number !${hint}`);
+            }
+
+            const reportPath = File.from(prj.getOutputFolder().path, GANG_REPORT_FILE_NAME).path;
+
+            while (serials.length > 0) {
+
+                const total = serials.length;
+                const report = await vscode.window.withProgress({
+                    location: vscode.ProgressLocation.Notification,
+                    title: `Gang flashing ${total} boards`
+                }, (progress) => runGang(serials, async (sn) => {
+                    const uploader = HexUploaderManager.getInstance().createUploader(prj);
+                    uploader.selectProbe(sn);
+                    uploader.disableTerminal();
+                    return (await uploader.upload()) || { success: false, message: 'canceled' };
+                }, {
+                    concurrency: settings.getGangConcurrency(),
+                    retries: settings.getGangRetries(),
+                    onBoardDone: (board, done) => progress.report({
+                        increment: 100 / total,
+                        message: `${done}/${total}, '${board.serial}' ${board.success ? 'passed' : 'failed'}`
+                    })
+                }));
+
+                const text = formatGangReport(report, `${prj.getProjectName()} (${prj.getCurrentTarget()})`);
+                GlobalEvent.log_info(text);
+                fs.mkdirSync(NodePath.dirname(reportPath), { recursive: true });
+                fs.writeFileSync(reportPath, text);
+
+                const msg = `Gang flash done: ${report.passed} passed, ${report.failed} failed.`;
+                const sel = report.failed == 0
+                    ? await vscode.window.showInformationMessage(msg, 'Show Report')
+                    : await vscode.window.showWarningMessage(msg, 'Retry Failed', 'Show Report');
+
+                if (sel == 'Show Report')
+                    vscode.window.showTextDocument(vscode.Uri.file(reportPath), { preview: true });
+
+                if (sel != 'Retry Failed')
+                    break;
+
+                serials = report.boards.filter(b => !b.success).map(b => b.serial);
+            }
+
+        } catch (error) {
+            GlobalEvent.emit('msg', ExceptionToMessage(error, 'Warning'));
+        } finally {
+            this._uploadLock = false;
+        }
+    }
+
+    /**
+     * Import all Keil, IAR and Eclipse projects in a folder tree, the projects are imported in parallel,
+     * the warnings of all projects are written into one report in the root folder.
+     *
+     * @param rootDir the folder is selected by user if it's not given
+     * @param options verify: check each project by a dry-run build
+    */
+    async bulkImportProjects(rootDir?: string, options?: { verify?: boolean, concurrency?: number, force?: boolean }): Promise<BulkImportReport | undefined> {
+
+        let opts = options || {};
+
+        if (!rootDir) {
+            const uri = await vscode.window.showOpenDialog({
+                openLabel: 'Import',
+                canSelectFolders: true,
+                canSelectFiles: false,
+                canSelectMany: false
+            });
+            if (uri === undefined || uri.length === 0)
+                return;
+            rootDir = uri[0].fsPath;
+            if (options == undefined) {
+                const ans = await vscode.window.showQuickPick(['No', 'Yes'], { placeHolder: 'Verify each project by a dry-run build ?' });
+                if (ans === undefined)
+                    return;
+                opts = { verify: ans == 'Yes' };
+            }
+        }
+
+        const rootPath = rootDir;
+        const { items, skipped } = scanImportableProjects(rootPath, opts.force);
+        if (items.length == 0) {
+            GlobalEvent.show_msgbox('Warning', `Not found any project to import in '${rootPath}' !`);
+            return;
+        }
+
+        const report = await vscode.window.withProgress({
+            location: vscode.ProgressLocation.Notification,
+            title: `Importing ${items.length} projects`
+        }, (progress) => runBulkImport(rootPath, items, async (item, r) => {
+            await this.dataProvider.ImportProjectHeadless({
+                type: item.type,
+                projectFile: new File(item.projectFile),
+                outDir: new File(NodePath.dirname(item.projectFile))
+            }, r);
+            if (opts.verify && r.workspaceFile)
+                return this.verifyImportedProject(r.workspaceFile);
+        }, skipped, {
+            concurrency: opts.concurrency,
+            onProjectDone: (result, done, total) => progress.report({
+                increment: 100 / total,
+                message: `${done}/${total}, '${NodePath.basename(result.item.projectFile)}' ${result.success ? 'done' : 'failed'}`
+            })
+        }));
+
+        const text = formatBulkImportReport(report);
+        const reportPath = File.from(rootPath, BULK_IMPORT_REPORT_FILE_NAME).path;
+        GlobalEvent.log_info(text);
+        try {
+            fs.writeFileSync(reportPath, text);
+        } catch (error) {
+            GlobalEvent.log_warn(error);
+        }
+
+        const msg = `Import done: ${report.imported} imported, ${report.failed} failed, ${report.skipped.length} skipped.`;
+        const notify = report.failed == 0
+            ? vscode.window.showInformationMessage(msg, 'Show Report')
+            : vscode.window.showWarningMessage(msg, 'Show Report');
+        notify.then((sel) => {
+            if (sel == 'Show Report')
+                vscode.window.showTextDocument(vscode.Uri.file(reportPath), { preview: true });
+        });
+
+        return report;
+    }
+
+    /** load the project and run a dry-run build, the project is not opened */
+    private async verifyImportedProject(workspaceFile: string): Promise<BulkVerifyResult> {
+
+        const prj = AbstractProject.NewProject(getGlobalState());
+        await prj.Load(new File(workspaceFile));
+
+        try {
+            const toolchain = prj.getToolchain();
+            if (!ToolchainManager.getInstance().isToolchainPathReady(toolchain.name))
+                return { success: false, message: `Toolchain '${toolchain.name}' is not installed.` };
+
+            const cmdLine = CodeBuilder.NewBuilder(prj).genBuildCommand({ otherArgs: ['--dry-run'] });
+            if (!cmdLine)
+                return { success: false, message: 'builder.genBuildCommand return null.' };
+
+            return await new Promise<BulkVerifyResult>((resolve) => {
+                const opts = { cwd: prj.getProjectRoot().path, maxBuffer: 16 * 1024 * 1024 };
+                child_process.exec(cmdLine, opts, (error, stdout, stderr) => {
+                    resolve({
+                        success: !error,
+                        message: error ? `${stdout}${stderr}${os.EOL}${error.message}` : stdout.toString()
+                    });
+                });
+            });
+        } finally {
+            prj.Close();
+        }
+    }
+
     compileSingleFile(item: ProjTreeItem) {
 
         const project = this.getProjectByTreeItem(item);
@@ -4701,14 +5000,12 @@ export class ProjectExplorer implements CustomConfigurationProvider {
                 let packageFile: File | undefined;
 
                 const resManager = ResManager.GetInstance();
-                const packDir = File.fromArray([resManager.getEideHomeFolder().path, 'pack', 'cmsis']);
-                packDir.CreateDir(true);
+                const cacheName = `cmsis-pack/${gitFileInfo.name}`;
 
                 // read cache
-                const cache = new FileCache(packDir);
-                packageFile = cache.get(gitFileInfo.name, gitFileInfo.sha);
-                if (packageFile) { // found cache, use it
-                    return packageFile;
+                const cache = resManager.getCache(cacheName);
+                if (cache && cache.sha == gitFileInfo.sha) { // found cache, use it
+                    return cache.file;
                 }
 
                 // download it
@@ -4719,26 +5016,24 @@ export class ProjectExplorer implements CustomConfigurationProvider {
                 }
 
                 const url = redirectHost(gitFileInfo.download_url);
-                const buff = await downloadFileWithProgress(url, gitFileInfo.name, progress, cancelToken);
+                packageFile = File.fromArray([resManager.GetTmpDir().path, gitFileInfo.name]);
+                const res = await downloadFileToDisk(url, packageFile.path, gitFileInfo.name, progress, cancelToken, { hashes: ['git-sha1'] });
 
-                if (buff == undefined) { // canceled
+                if (res == undefined) { // canceled
                     return undefined;
                 }
 
-                if (buff instanceof Error) {
-                    return buff;
+                if (res instanceof Error) {
+                    return res;
                 }
 
-                // save file
-                packageFile = File.fromArray([packDir.path, gitFileInfo.name]);
-                fs.writeFileSync(packageFile.path, buff);
-
                 // add to cache
-                const sha = genGithubHash(buff);
-                cache.add(packageFile.name, sha);
-                cache.save();
+                const newCache = resManager.addCache({
+                    name: cacheName,
+                    sha: res.hashes['git-sha1']
+                }, packageFile);
 
-                return packageFile;
+                return newCache ? newCache.file : packageFile;
 
             } catch (error) {
                 return error;
@@ -5737,82 +6032,121 @@ export class ProjectExplorer implements CustomConfigurationProvider {
 
         try {
 
-            const toolchainName = prj.getToolchain().name;
-
-            // prepare command
-            let exeFile: File;
-            let cmds: string[];
+            // list all functions, only disassemble the selected one
+            const items: (vscode.QuickPickItem & { symbol?: string })[] = [];
 
-            const dasmFile = File.fromArray([prj.getOutputFolder().path, `${NodePath.basename(elfPath)}.edasm`]);
-            if (dasmFile.IsFile()) { // force del tmp file
-                try { fs.unlinkSync(dasmFile.path); } catch (error) { }
+            const elf = ElfFile.open(elfPath);
+            try {
+                const demangler = getCxxDemangler();
+                const cxxfilt = prj.getCxxFiltPath();
+                elf.forEachSymbol((sym) => {
+                    if (sym.type != 'FUNC' || sym.section == undefined || sym.size == 0)
+                        return;
+                    items.push({
+                        label: (cxxfilt ? demangler.getCached(sym.name, cxxfilt) : undefined) || sym.name,
+                        description: `0x${sym.value.toString(16).padStart(8, '0')}, ${sym.size} bytes`,
+                        symbol: sym.name
+                    });
+                });
+            } finally {
+                elf.close();
             }
 
-            if (isGccFamilyToolchain(toolchainName)) { // gcc
-                const toolchain = ToolchainManager.getInstance().getToolchainByName(toolchainName);
-                if (!toolchain) throw Error(`Can't get toolchain '${toolchainName}'`);
-                const toolPrefix = toolchain.getToolchainPrefix ? toolchain.getToolchainPrefix() : '';
-                exeFile = File.fromArray([prj.getToolchain().getToolchainDir().path, 'bin', `${toolPrefix}objdump${exeSuffix()}`]);
-                if (!exeFile.IsFile()) throw Error(`Not found '${exeFile.name}' !`);
-                cmds = ['-S', '-l', elfPath, '>', dasmFile.path];
-                // https://interrupt.memfault.com/blog/gnu-binutils#new-feature-visualize-jumps
-                const binutilsVer = getGccBinutilsVersion(exeFile.dir, toolPrefix, 'objdump');
-                // if (binutilsVer && compareVersion(binutilsVer, '2.34') > 0) {
-                //     cmds = ['--visualize-jumps'].concat(cmds);
-                // }
-            }
-            else if (toolchainName.startsWith('AC')) { // armcc
-                exeFile = File.fromArray([prj.getToolchain().getToolchainDir().path, 'bin', `fromelf${exeSuffix()}`]);
-                if (!exeFile.IsFile()) throw Error(`Not found '${exeFile.name}' !`);
-                cmds = ['-c', elfPath, '--output', dasmFile.path];
-            }
-            else if (toolchainName == 'LLVM_ARM') {
-                exeFile = File.from(prj.getToolchain().getToolchainDir().path, 'bin', `llvm-objdump${exeSuffix()}`);
-                if (!exeFile.IsFile()) throw Error(`Not found '${exeFile.name}' !`);
-                cmds = ['-S', '-l', elfPath, '>', dasmFile.path];
-            }
-            else if (toolchainName == 'GNU_SDCC_MCS51') {
-                exeFile = File.from(prj.getToolchain().getToolchainDir().path, 'bin', `i51-elf-objdump${exeSuffix()}`);
-                if (!exeFile.IsFile()) throw Error(`Not found '${exeFile.name}' !`);
-                cmds = ['-S', '-l', elfPath, '>', dasmFile.path];
-            }
-            else {
-                throw new Error(`Not support showDisassemblyForElf for toolchain: '${toolchainName}' !`);
-            }
+            items.sort((a, b) => a.label.localeCompare(b.label));
+            items.unshift({
+                label: '$(file-binary) All',
+                description: 'Disassemble the whole image (slow for big image)'
+            });
 
-            // do disassembly code
-            const err = await vscode.window.withProgress({
-                location: vscode.ProgressLocation.Notification,
-                title: 'Disassemble program',
-                cancellable: false,
-            }, async (progress): Promise<Error | void> => {
-                try {
-                    progress.report({ message: elfPath });
-                    await new Promise<void>((resolve) => { setTimeout(() => resolve(), 500); });
+            const sel = await vscode.window.showQuickPick(items, {
+                placeHolder: `Select a function to disassemble, '${NodePath.basename(elfPath)}'`,
+                matchOnDescription: true,
+                canPickMany: false
+            });
 
-                    // run
-                    const cmdLine = CmdLineHandler.getCommandLine(exeFile.path, cmds, false);
-                    child_process.execSync(cmdLine, { encoding: 'ascii' });
+            if (sel == undefined)
+                return;
 
-                    progress.report({ message: 'Done !' });
-                    await new Promise<void>((resolve) => { setTimeout(() => resolve(), 500); });
-                } catch (error) {
-                    return error;
-                }
+            if (sel.symbol)
+                await DisassemblyProvider.instance().showSymbol(prj, elfPath, sel.symbol);
+            else
+                await DisassemblyProvider.instance().showRange(prj, elfPath, undefined);
+
+        } catch (error) {
+            GlobalEvent.emit('msg', ExceptionToMessage(error, 'Warning'));
+        }
+    }
+
+    async showSizeDiff(prjItem?: ProjTreeItem) {
+
+        try {
+
+            const prj = this.getProjectByTreeItem(prjItem);
+            if (!prj)
+                throw new Error('Not found active project !');
+
+            const history = SizeHistory.load(prj.getOutputFolder().path);
+            if (history.count() == 0)
+                throw new Error(`No size history for target '${prj.getCurrentTarget()}', please build your project !`);
+
+            const items: (vscode.QuickPickItem & { ref: string })[] = [{
+                label: 'Previous Build',
+                description: 'Compare with the previous successful build',
+                ref: 'previous'
+            }];
+
+            history.getTags().forEach((tag) => {
+                const snap = history.find(tag);
+                items.push({
+                    label: `$(tag) ${tag}`,
+                    description: snap ? `#${snap.id} ${new Date(snap.time).toLocaleString()}` : undefined,
+                    ref: tag
+                });
             });
 
-            if (err) { throw err }
+            const sel = items.length == 1 ? items[0] : await vscode.window.showQuickPick(items, {
+                placeHolder: 'Select a base build to compare with the latest build'
+            });
+            if (sel == undefined)
+                return;
 
-            // check result file
-            if (!dasmFile.IsFile()) {
-                throw new Error(`Not found disassembly result file: '${dasmFile.path}' !`);
-            }
+            const diff = history.diff(sel.ref, 50);
+            if (diff == undefined)
+                throw new Error(`Not found base build: '${sel.ref}', need at least 2 builds !`);
 
-            // show
-            vscode.window.showTextDocument(vscode.Uri.file(dasmFile.path), {
-                preview: true,
-                viewColumn: vscode.ViewColumn.Two
+            const docPath = File.from(prj.getOutputFolder().path, `${prj.getCurrentTarget()}.size-diff.txt`).path;
+            const vdoc = VirtualDocument.instance();
+            vdoc.updateDocument(docPath, formatSizeDiff(diff));
+            await vscode.window.showTextDocument(vscode.Uri.parse(vdoc.getUriByPath(docPath)), { preview: true });
+
+        } catch (error) {
+            GlobalEvent.emit('msg', ExceptionToMessage(error, 'Warning'));
+        }
+    }
+
+    async tagSizeBaseline(prjItem?: ProjTreeItem) {
+
+        try {
+
+            const prj = this.getProjectByTreeItem(prjItem);
+            if (!prj)
+                throw new Error('Not found active project !');
+
+            const history = SizeHistory.load(prj.getOutputFolder().path);
+            const latest = history.latest();
+            if (latest == undefined)
+                throw new Error(`No size history for target '${prj.getCurrentTarget()}', please build your project !`);
+
+            const tag = await vscode.window.showInputBox({
+                placeHolder: 'Input a tag name, like: v1.0.0',
+                prompt: `Tag the latest build (#${latest.id}, ${new Date(latest.time).toLocaleString()}) as a size baseline`,
+                validateInput: (v) => /^[\w\.\-]+$/.test(v) ? undefined : 'Only letters, digits, \'.\', \'-\' and \'_\' are allowed'
             });
+            if (!tag)
+                return;
+
+            history.setTag(tag);
+            history.save();
 
         } catch (error) {
             GlobalEvent.emit('msg', ExceptionToMessage(error, 'Warning'));
@@ -145,6 +145,14 @@ export interface CurrentDevice {
     deviceIndex: number;
 }
 
+export interface DeviceFlashAlgorithm {
+    /** absolute path of the .FLM file */
+    path: string;
+    start: string;
+    size: string;
+    default?: boolean;
+}
+
 export interface DeviceInfo {
     name: string;
     devClassName: string;
@@ -153,6 +161,7 @@ export interface DeviceInfo {
     endian?: string;
     svdPath?: string;
     storageLayout: ARMStorageLayout;
+    flashAlgorithms?: DeviceFlashAlgorithm[];
 }
 
 export interface SubFamily {
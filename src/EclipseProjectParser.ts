@@ -1,7 +1,6 @@
-import * as fs from 'fs';
 import * as NodePath from 'path';
 import * as os from 'os';
-import * as xml2js from 'xml2js';
+import { parseXmlFile } from './XmlStreamParser';
 import { VirtualFolder } from './EIDETypeDefine';
 import { VirtualSource, AbstractProject } from './EIDEProject';
 import { isArray } from 'util';
@@ -122,11 +121,17 @@ export function formatFilePath(path: string): string {
 
 export async function parseEclipseProject(cprojectPath: string): Promise<EclipseProjectInfo> {
 
-    let _prjDom = (await xml2js.parseStringPromise(
-        fs.readFileSync(NodePath.dirname(cprojectPath) + NodePath.sep + '.project').toString()))['projectDescription'];
+    // the top level modules except the cdt settings (scanner configs, refresh scopes, ...) are not used
+    const cprjSkip = (path: string, attrs: { [name: string]: string }) =>
+        path == 'cproject.storageModule' && attrs['moduleId'] != 'org.eclipse.cdt.core.settings';
 
-    let cprjDom = (await xml2js.parseStringPromise(
-        fs.readFileSync(cprojectPath).toString()))['cproject'];
+    const doms = await Promise.all([
+        parseXmlFile(NodePath.dirname(cprojectPath) + NodePath.sep + '.project'),
+        parseXmlFile(cprojectPath, { skip: cprjSkip })
+    ]);
+
+    let _prjDom = doms[0]['projectDescription'];
+    let cprjDom = doms[1]['cproject'];
 
     const cprojectDir = new File(NodePath.dirname(cprojectPath));
 
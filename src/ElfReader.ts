@@ -0,0 +1,558 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+
+// ---------------------------------------------------------------------------
+// ELF constants (only what we need)
+// ---------------------------------------------------------------------------
+
+const ELFCLASS32 = 1;
+const ELFCLASS64 = 2;
+const ELFDATA2LSB = 1;
+const ELFDATA2MSB = 2;
+
+export const SHT_NULL = 0;
+export const SHT_SYMTAB = 2;
+export const SHT_STRTAB = 3;
+export const SHT_NOTE = 7;
+export const SHT_NOBITS = 8;
+
+const NT_GNU_BUILD_ID = 3;
+
+export const PT_LOAD = 1;
+
+export const SHF_WRITE = 0x1;
+export const SHF_ALLOC = 0x2;
+export const SHF_EXECINSTR = 0x4;
+
+export const SHN_UNDEF = 0;
+export const SHN_LORESERVE = 0xff00;
+export const SHN_ABS = 0xfff1;
+export const SHN_COMMON = 0xfff2;
+export const SHN_XINDEX = 0xffff;
+
+/** Max symbols decoded per read, keeps memory bounded on huge symbol tables. */
+const SYMBOL_READ_BATCH = 4096;
+
+// ---------------------------------------------------------------------------
+// Types
+// ---------------------------------------------------------------------------
+
+export type ElfSymbolBind = 'LOCAL' | 'GLOBAL' | 'WEAK' | 'UNKNOWN';
+
+export type ElfSymbolType = 'NOTYPE' | 'OBJECT' | 'FUNC' | 'SECTION' | 'FILE' | 'COMMON' | 'TLS' | 'UNKNOWN';
+
+export interface ElfHeaderInfo {
+    is64: boolean;
+    littleEndian: boolean;
+    /** e_type, e.g. 2 = ET_EXEC */
+    type: number;
+    /** e_machine, e.g. 40 = EM_ARM, 243 = EM_RISCV */
+    machine: number;
+    entry: number;
+}
+
+export interface ElfSectionInfo {
+    index: number;
+    name: string;
+    type: number;
+    flags: number;
+    addr: number;
+    offset: number;
+    size: number;
+    link: number;
+    entsize: number;
+}
+
+/** One program header (segment) entry. */
+export interface ElfSegmentInfo {
+    type: number;
+    flags: number;
+    offset: number;
+    /** virtual address */
+    vaddr: number;
+    /** physical (load) address */
+    paddr: number;
+    filesz: number;
+    memsz: number;
+}
+
+/** One decoded `.symtab` entry. */
+export interface ElfSymbol {
+    name: string;
+    value: number;
+    size: number;
+    bind: ElfSymbolBind;
+    type: ElfSymbolType;
+    /** raw st_shndx (may be SHN_ABS, SHN_COMMON ...) */
+    shndx: number;
+    /** name of the section this symbol is defined in, undefined for special indexes */
+    section?: string;
+}
+
+export interface ElfSymbolTable {
+    header: ElfHeaderInfo;
+    sections: ElfSectionInfo[];
+    symbols: ElfSymbol[];
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+const BIND_NAMES: ElfSymbolBind[] = ['LOCAL', 'GLOBAL', 'WEAK'];
+const TYPE_NAMES: ElfSymbolType[] = ['NOTYPE', 'OBJECT', 'FUNC', 'SECTION', 'FILE', 'COMMON', 'TLS'];
+
+/**
+ * Check the ELF magic of a file without reading the whole file.
+*/
+export function isElfFile(path: string): boolean {
+    let fd: number | undefined;
+    try {
+        fd = fs.openSync(path, 'r');
+        const magic = Buffer.alloc(4);
+        if (fs.readSync(fd, magic, 0, 4, 0) != 4)
+            return false;
+        return magic[0] == 0x7f && magic[1] == 0x45 && magic[2] == 0x4c && magic[3] == 0x46;
+    } catch (error) {
+        return false;
+    } finally {
+        if (fd !== undefined)
+            fs.closeSync(fd);
+    }
+}
+
+/**
+ * A minimal ELF32/ELF64 reader (little and big endian).
+ *
+ * Only the file header and the section header table are loaded when opened,
+ * section contents are read on demand with positioned reads, so memory usage
+ * does not grow with the size of the image.
+*/
+export class ElfFile {
+
+    readonly header: ElfHeaderInfo;
+    readonly sections: ElfSectionInfo[] = [];
+
+    private fd: number;
+
+    private constructor(fd: number) {
+        this.fd = fd;
+        this.header = this.readHeader();
+        this.readSectionHeaders();
+    }
+
+    static open(path: string): ElfFile {
+        const fd = fs.openSync(path, 'r');
+        try {
+            return new ElfFile(fd);
+        } catch (error) {
+            fs.closeSync(fd);
+            throw error;
+        }
+    }
+
+    close() {
+        if (this.fd >= 0) {
+            fs.closeSync(this.fd);
+            this.fd = -1;
+        }
+    }
+
+    findSection(name: string): ElfSectionInfo | undefined {
+        return this.sections.find(s => s.name == name);
+    }
+
+    /**
+     * Read raw bytes of a file region
+    */
+    readBytes(offset: number, size: number): Buffer {
+        const buf = Buffer.alloc(size);
+        let done = 0;
+        while (done < size) {
+            const n = fs.readSync(this.fd, buf, done, size - done, offset + done);
+            if (n <= 0)
+                throw new Error(`Unexpected end of elf file at offset 0x${(offset + done).toString(16)}`);
+            done += n;
+        }
+        return buf;
+    }
+
+    readSectionData(sec: ElfSectionInfo): Buffer {
+        if (sec.type == SHT_NOBITS || sec.size == 0)
+            return Buffer.alloc(0);
+        return this.readBytes(sec.offset, sec.size);
+    }
+
+    /**
+     * Get the GNU build id (hex string) from `.note.gnu.build-id`, undefined if not exist.
+    */
+    readBuildId(): string | undefined {
+
+        const sec = this.findSection('.note.gnu.build-id');
+        if (sec == undefined || sec.type != SHT_NOTE || sec.size < 12)
+            return undefined;
+
+        const data = this.readSectionData(sec);
+        let off = 0;
+
+        // Elf_Nhdr: namesz, descsz, type, name (4-bytes aligned), desc
+        while (off + 12 <= data.length) {
+            const namesz = this.u32(data, off);
+            const descsz = this.u32(data, off + 4);
+            const type = this.u32(data, off + 8);
+            const descOff = off + 12 + align4(namesz);
+            if (descOff + descsz > data.length)
+                break;
+            if (type == NT_GNU_BUILD_ID)
+                return data.toString('hex', descOff, descOff + descsz);
+            off = descOff + align4(descsz);
+        }
+
+        return undefined;
+    }
+
+    /**
+     * Read the program header table, it is not loaded when opened.
+    */
+    readSegments(): ElfSegmentInfo[] {
+
+        const result: ElfSegmentInfo[] = [];
+        if (this._phoff == 0 || this._phentsize == 0 || this._phnum == 0)
+            return result;
+
+        const table = this.readBytes(this._phoff, this._phnum * this._phentsize);
+
+        for (let i = 0; i < this._phnum; i++) {
+            const off = i * this._phentsize;
+            if (this._is64) {
+                result.push({
+                    type: this.u32(table, off),
+                    flags: this.u32(table, off + 4),
+                    offset: this.u64(table, off + 8),
+                    vaddr: this.u64(table, off + 16),
+                    paddr: this.u64(table, off + 24),
+                    filesz: this.u64(table, off + 32),
+                    memsz: this.u64(table, off + 40)
+                });
+            } else {
+                result.push({
+                    type: this.u32(table, off),
+                    offset: this.u32(table, off + 4),
+                    vaddr: this.u32(table, off + 8),
+                    paddr: this.u32(table, off + 12),
+                    filesz: this.u32(table, off + 16),
+                    memsz: this.u32(table, off + 20),
+                    flags: this.u32(table, off + 24)
+                });
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Iterate all entries of `.symtab` in one pass.
+     *
+     * The symbol table is decoded in fixed size batches, only the string table
+     * is kept in memory while iterating.
+     *
+     * @param callback return false to stop iterating
+    */
+    forEachSymbol(callback: (sym: ElfSymbol, index: number) => boolean | void) {
+
+        const symtab = this.sections.find(s => s.type == SHT_SYMTAB);
+        if (symtab == undefined)
+            return;
+
+        const strtabSec = this.sections[symtab.link];
+        const strtab = strtabSec ? this.readSectionData(strtabSec) : Buffer.alloc(0);
+
+        const entsize = symtab.entsize || (this.header.is64 ? 24 : 16);
+        const total = Math.floor(symtab.size / entsize);
+
+        // SHN_XINDEX support
+        const shndxSec = this.sections.find(s => s.type == 18 /* SHT_SYMTAB_SHNDX */ && s.link == symtab.index);
+        const shndxTable = shndxSec ? this.readSectionData(shndxSec) : undefined;
+
+        for (let base = 0; base < total; base += SYMBOL_READ_BATCH) {
+
+            const count = Math.min(SYMBOL_READ_BATCH, total - base);
+            const chunk = this.readBytes(symtab.offset + base * entsize, count * entsize);
+
+            for (let i = 0; i < count; i++) {
+
+                const off = i * entsize;
+                let nameIdx: number, value: number, size: number, info: number, shndx: number;
+
+                if (this.header.is64) {
+                    nameIdx = this.u32(chunk, off);
+                    info = chunk[off + 4];
+                    shndx = this.u16(chunk, off + 6);
+                    value = this.u64(chunk, off + 8);
+                    size = this.u64(chunk, off + 16);
+                } else {
+                    nameIdx = this.u32(chunk, off);
+                    value = this.u32(chunk, off + 4);
+                    size = this.u32(chunk, off + 8);
+                    info = chunk[off + 12];
+                    shndx = this.u16(chunk, off + 14);
+                }
+
+                const symIndex = base + i;
+                if (shndx == SHN_XINDEX && shndxTable && shndxTable.length >= (symIndex + 1) * 4) {
+                    shndx = this.u32(shndxTable, symIndex * 4);
+                }
+
+                const sym: ElfSymbol = {
+                    name: readCString(strtab, nameIdx),
+                    value: value,
+                    size: size,
+                    bind: BIND_NAMES[info >> 4] || 'UNKNOWN',
+                    type: TYPE_NAMES[info & 0xf] || 'UNKNOWN',
+                    shndx: shndx
+                };
+
+                if (shndx != SHN_UNDEF && shndx < SHN_LORESERVE && this.sections[shndx])
+                    sym.section = this.sections[shndx].name;
+
+                if (callback(sym, symIndex) === false)
+                    return;
+            }
+        }
+    }
+
+    //-------------------------------------------
+
+    private u16(buf: Buffer, off: number): number {
+        return this._le ? buf.readUInt16LE(off) : buf.readUInt16BE(off);
+    }
+
+    private u32(buf: Buffer, off: number): number {
+        return this._le ? buf.readUInt32LE(off) : buf.readUInt32BE(off);
+    }
+
+    private u64(buf: Buffer, off: number): number {
+        const v = this._le ? buf.readBigUInt64LE(off) : buf.readBigUInt64BE(off);
+        return Number(v);
+    }
+
+    private word(buf: Buffer, off: number): number {
+        return this._is64 ? this.u64(buf, off) : this.u32(buf, off);
+    }
+
+    private _is64 = false;
+    private _le = true;
+    private _phoff = 0;
+    private _phentsize = 0;
+    private _phnum = 0;
+    private _shoff = 0;
+    private _shentsize = 0;
+    private _shnum = 0;
+    private _shstrndx = 0;
+
+    private readHeader(): ElfHeaderInfo {
+
+        const ident = this.readBytes(0, 16);
+        if (!(ident[0] == 0x7f && ident[1] == 0x45 && ident[2] == 0x4c && ident[3] == 0x46))
+            throw new Error(`Not an elf file (bad magic)`);
+
+        const cls = ident[4];
+        const data = ident[5];
+        if (cls != ELFCLASS32 && cls != ELFCLASS64)
+            throw new Error(`Unsupported elf class: ${cls}`);
+        if (data != ELFDATA2LSB && data != ELFDATA2MSB)
+            throw new Error(`Unsupported elf data encoding: ${data}`);
+
+        // set these first, the integer helpers depend on them
+        this._is64 = cls == ELFCLASS64;
+        this._le = data == ELFDATA2LSB;
+
+        const buf = this.readBytes(0, this._is64 ? 64 : 52);
+        const hdr: ElfHeaderInfo = {
+            is64: this._is64,
+            littleEndian: this._le,
+            type: this.u16(buf, 16),
+            machine: this.u16(buf, 18),
+            entry: this.word(buf, 24)
+        };
+
+        if (hdr.is64) {
+            this._phoff = this.u64(buf, 32);
+            this._phentsize = this.u16(buf, 54);
+            this._phnum = this.u16(buf, 56);
+            this._shoff = this.u64(buf, 40);
+            this._shentsize = this.u16(buf, 58);
+            this._shnum = this.u16(buf, 60);
+            this._shstrndx = this.u16(buf, 62);
+        } else {
+            this._phoff = this.u32(buf, 28);
+            this._phentsize = this.u16(buf, 42);
+            this._phnum = this.u16(buf, 44);
+            this._shoff = this.u32(buf, 32);
+            this._shentsize = this.u16(buf, 46);
+            this._shnum = this.u16(buf, 48);
+            this._shstrndx = this.u16(buf, 50);
+        }
+
+        return hdr;
+    }
+
+    private readSectionHeaders() {
+
+        if (this._shoff == 0 || this._shentsize == 0)
+            return;
+
+        // e_shnum == 0 and e_shstrndx == SHN_XINDEX: real values are stored in section 0
+        let shnum = this._shnum;
+        let shstrndx = this._shstrndx;
+        if (shnum == 0 || shstrndx == SHN_XINDEX) {
+            const sh0 = this.readBytes(this._shoff, this._shentsize);
+            if (shnum == 0)
+                shnum = this._is64 ? this.u64(sh0, 32) : this.u32(sh0, 20);
+            if (shstrndx == SHN_XINDEX)
+                shstrndx = this.u32(sh0, this._is64 ? 40 : 24);
+        }
+
+        const table = this.readBytes(this._shoff, shnum * this._shentsize);
+        const nameOffsets: number[] = [];
+
+        for (let i = 0; i < shnum; i++) {
+            const off = i * this._shentsize;
+            let sec: ElfSectionInfo;
+            if (this._is64) {
+                sec = {
+                    index: i,
+                    name: '',
+                    type: this.u32(table, off + 4),
+                    flags: this.u64(table, off + 8),
+                    addr: this.u64(table, off + 16),
+                    offset: this.u64(table, off + 24),
+                    size: this.u64(table, off + 32),
+                    link: this.u32(table, off + 40),
+                    entsize: this.u64(table, off + 56)
+                };
+            } else {
+                sec = {
+                    index: i,
+                    name: '',
+                    type: this.u32(table, off + 4),
+                    flags: this.u32(table, off + 8),
+                    addr: this.u32(table, off + 12),
+                    offset: this.u32(table, off + 16),
+                    size: this.u32(table, off + 20),
+                    link: this.u32(table, off + 24),
+                    entsize: this.u32(table, off + 36)
+                };
+            }
+            nameOffsets.push(this.u32(table, off));
+            this.sections.push(sec);
+        }
+
+        const shstrtab = this.sections[shstrndx];
+        if (shstrtab && shstrtab.type == SHT_STRTAB) {
+            const names = this.readSectionData(shstrtab);
+            for (let i = 0; i < this.sections.length; i++)
+                this.sections[i].name = readCString(names, nameOffsets[i]);
+        }
+    }
+}
+
+function align4(n: number): number {
+    return (n + 3) & ~3;
+}
+
+function readCString(buf: Buffer, offset: number): string {
+    if (offset >= buf.length)
+        return '';
+    let end = offset;
+    while (end < buf.length && buf[end] != 0)
+        end++;
+    return buf.toString('utf8', offset, end);
+}
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+/**
+ * Read header, sections and all symbols of an elf file.
+*/
+export function readElfSymbolTable(path: string): ElfSymbolTable {
+    const elf = ElfFile.open(path);
+    try {
+        const symbols: ElfSymbol[] = [];
+        elf.forEachSymbol((sym) => { symbols.push(sym); });
+        return {
+            header: elf.header,
+            sections: elf.sections,
+            symbols: symbols
+        };
+    } finally {
+        elf.close();
+    }
+}
+
+/**
+ * Get the GNU nm style type letter of a symbol, e.g. 'T', 'b', 'W' ...
+ *
+ * Uppercase is global, lowercase is local.
+*/
+export function getGnuSymbolTypeChar(sym: ElfSymbol, sections: ElfSectionInfo[]): string {
+
+    if (sym.shndx == SHN_COMMON)
+        return 'C';
+
+    if (sym.shndx == SHN_UNDEF) {
+        if (sym.bind == 'WEAK')
+            return sym.type == 'OBJECT' ? 'v' : 'w';
+        return 'U';
+    }
+
+    if (sym.bind == 'WEAK')
+        return sym.type == 'OBJECT' ? 'V' : 'W';
+
+    let c = '?';
+
+    if (sym.shndx == SHN_ABS) {
+        c = 'a';
+    } else {
+        const sec = sections[sym.shndx];
+        if (sec) {
+            if (sec.flags & SHF_EXECINSTR)
+                c = 't';
+            else if (sec.type == SHT_NOBITS)
+                c = 'b';
+            else if ((sec.flags & SHF_ALLOC) && (sec.flags & SHF_WRITE))
+                c = 'd';
+            else if (sec.flags & SHF_ALLOC)
+                c = 'r';
+            else
+                c = 'n';
+        }
+    }
+
+    return sym.bind == 'LOCAL' ? c : c.toUpperCase();
+}
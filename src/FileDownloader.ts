@@ -0,0 +1,573 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+import * as http from 'http';
+import * as https from 'https';
+import * as crypto from 'crypto';
+
+/** suffix of the temp file, the data is written to it, then it's renamed to the target file */
+export const DOWNLOAD_TEMP_SUFFIX = '.download';
+
+/** suffix of the resume state file, it's placed next to the temp file */
+export const DOWNLOAD_STATE_SUFFIX = '.download.json';
+
+const MAX_REDIRECTS = 8;
+
+/** min size of a range segment, smaller files are not split */
+const MIN_SEGMENT_SIZE = 1024 * 1024;
+
+/** interval to save the resume state (ms) */
+const STATE_SAVE_INTERVAL = 1000;
+
+/** 'git-sha1' is the git blob hash: sha1 of 'blob <size>\0' + content, the same as the 'sha' of the github api */
+export type DownloadHashAlgorithm = 'md5' | 'sha1' | 'sha256' | 'git-sha1';
+
+export interface DownloadOptions {
+
+    headers?: { [key: string]: string | undefined };
+
+    /** hashes to compute, they are computed while the data is received */
+    hashes?: DownloadHashAlgorithm[];
+
+    /** verify the file, the download is failed if the hash is not matched */
+    expectedHash?: { algorithm: DownloadHashAlgorithm, value: string };
+
+    /** number of parallel range requests, default: 1, the server must support 'Range' */
+    segments?: number;
+
+    /** max retries for a broken connection, default: 3, the transfer is resumed from the broken position */
+    retries?: number;
+
+    /** idle timeout of a connection (ms), default: 30000 */
+    timeout?: number;
+
+    rejectUnauthorized?: boolean;
+
+    /** @param total is undefined if the server does not tell the size */
+    onProgress?: (received: number, total: number | undefined) => void;
+}
+
+export interface DownloadResult {
+
+    path: string;
+
+    size: number;
+
+    /** hex digests of `DownloadOptions.hashes` */
+    hashes: { [algorithm: string]: string };
+
+    /** the transfer is resumed from a previous broken download */
+    resumed: boolean;
+}
+
+export class DownloadCanceledError extends Error {
+    constructor(url: string) {
+        super(`Download canceled: '${url}'`);
+        this.name = 'DownloadCanceledError';
+    }
+}
+
+interface Segment {
+
+    start: number;
+
+    /** inclusive, -1 if the size is unknown */
+    end: number;
+
+    /** next position to write */
+    pos: number;
+}
+
+interface DownloadState {
+    url: string;
+    size: number;
+    etag?: string;
+    lastModified?: string;
+    segments: Segment[];
+}
+
+interface ResponseInfo {
+    res: http.IncomingMessage;
+    req: http.ClientRequest;
+    url: string;
+}
+
+/**
+ * Download a file straight to the disk.
+ *
+ * The data is written to '<dest>.download', the received ranges are saved in '<dest>.download.json',
+ * so a broken download is resumed by the 'Range' request next time (if the file on the server is not changed).
+ * The temp file is renamed to the target file when it's done and verified.
+*/
+export class FileDownloader {
+
+    readonly url: string;
+    readonly destPath: string;
+
+    private options: DownloadOptions;
+
+    private canceled: boolean;
+    private stopped: boolean;
+    private requests: Set<http.ClientRequest>;
+
+    constructor(url: string, destPath: string, options?: DownloadOptions) {
+        this.url = url;
+        this.destPath = destPath;
+        this.options = options || {};
+        this.canceled = false;
+        this.stopped = false;
+        this.requests = new Set();
+    }
+
+    get tempPath(): string {
+        return this.destPath + DOWNLOAD_TEMP_SUFFIX;
+    }
+
+    get statePath(): string {
+        return this.destPath + DOWNLOAD_STATE_SUFFIX;
+    }
+
+    cancel() {
+        this.canceled = true;
+        this.stop();
+    }
+
+    private stop() {
+        this.stopped = true;
+        this.requests.forEach(req => req.destroy());
+        this.requests.clear();
+    }
+
+    /**
+     * Delete the temp files of a broken download
+    */
+    clean() {
+        for (const p of [this.tempPath, this.statePath]) {
+            try { fs.unlinkSync(p); } catch (error) { /* not exist */ }
+        }
+    }
+
+    async download(): Promise<DownloadResult> {
+
+        const prevState = this.loadState();
+
+        let state: DownloadState;
+        let first: ResponseInfo | undefined;
+        let firstSeg: Segment | undefined;
+        let resumed = false;
+
+        if (prevState) {
+            firstSeg = prevState.segments.find(s => s.end < 0 || s.pos <= s.end);
+            if (firstSeg) {
+                first = await this.request(this.url, this.rangeHeader(firstSeg), prevState);
+            }
+        } else {
+            first = await this.request(this.url, 'bytes=0-');
+        }
+
+        if (prevState && (first == undefined || first.res.statusCode == 206)) {
+            state = prevState;
+            resumed = true;
+        } else {
+            // fresh start, or the server does not support 'Range', or the file was changed
+            state = this.newState(<ResponseInfo>first);
+            firstSeg = state.segments[0];
+            fs.writeFileSync(this.tempPath, Buffer.alloc(0));
+        }
+
+        const fd = fs.openSync(this.tempPath, 'r+');
+
+        // if there is only one segment, hash the data while it's received,
+        // otherwise the data is not received in order, hash the file at the end
+        // (the git hash needs the size before the data, so do it at the end if the size is unknown)
+        const hashers = (state.segments.length == 1 && (state.size >= 0 || !this.hashAlgorithms().includes('git-sha1')))
+            ? this.createHashers(state.size) : undefined;
+
+        let lastSave = Date.now();
+        const progress = () => {
+            if (Date.now() - lastSave > STATE_SAVE_INTERVAL) {
+                lastSave = Date.now();
+                this.saveState(state);
+            }
+            if (this.options.onProgress) {
+                this.options.onProgress(this.receivedSize(state), state.size >= 0 ? state.size : undefined);
+            }
+        };
+
+        if (hashers && state.segments[0].pos > 0) {
+            this.hashFile(hashers, fd, state.segments[0].pos);
+        }
+
+        const jobs = state.segments.map((seg) => {
+            return this.downloadSegment(seg, fd, hashers, progress, seg === firstSeg ? first : undefined, state);
+        });
+
+        try {
+
+            await Promise.all(jobs);
+
+            if (state.size < 0) {
+                state.size = state.segments[0].pos;
+            }
+
+            if (fs.fstatSync(fd).size != state.size || this.receivedSize(state) != state.size) {
+                throw new Error(`Download incomplete: '${this.url}'`);
+            }
+
+        } catch (error) {
+            // stop other segments, the fd must not be used after it's closed
+            this.stop();
+            await Promise.all(jobs.map(job => job.catch(() => { })));
+            fs.closeSync(fd);
+            this.saveState(state);
+            throw this.canceled ? new DownloadCanceledError(this.url) : error;
+        }
+
+        const hashes: { [algorithm: string]: string } = {};
+        let allHashers = hashers;
+        if (allHashers == undefined) {
+            allHashers = this.createHashers(state.size);
+            this.hashFile(allHashers, fd, state.size);
+        }
+        allHashers.forEach((h, alg) => hashes[alg] = h.digest('hex'));
+
+        fs.closeSync(fd);
+
+        const expected = this.options.expectedHash;
+        if (expected && hashes[expected.algorithm] != expected.value.toLowerCase()) {
+            this.clean();
+            throw new Error(`The ${expected.algorithm} of '${this.url}' is not matched, expect: ${expected.value}, actual: ${hashes[expected.algorithm]}`);
+        }
+
+        fs.renameSync(this.tempPath, this.destPath);
+        try { fs.unlinkSync(this.statePath); } catch (error) { /* not exist */ }
+
+        return {
+            path: this.destPath,
+            size: state.size,
+            hashes: hashes,
+            resumed: resumed
+        };
+    }
+
+    //
+    // state
+    //
+
+    private loadState(): DownloadState | undefined {
+        try {
+            const state: DownloadState = JSON.parse(fs.readFileSync(this.statePath, 'utf8'));
+            if (state.url == this.url && Array.isArray(state.segments) && state.segments.length > 0 &&
+                fs.statSync(this.tempPath).size >= Math.max(...state.segments.map(s => s.pos)) &&
+                (state.etag || state.lastModified)) {
+                return state;
+            }
+        } catch (error) {
+            // no state
+        }
+        this.clean();
+        return undefined;
+    }
+
+    private saveState(state: DownloadState) {
+        try {
+            fs.writeFileSync(this.statePath, JSON.stringify(state));
+        } catch (error) {
+            // ignore, the download can not be resumed
+        }
+    }
+
+    private newState(first: ResponseInfo): DownloadState {
+
+        const res = first.res;
+        let size = -1;
+
+        if (res.statusCode == 206) {
+            const m = /\/(\d+)\s*$/.exec(res.headers['content-range'] || '');
+            if (m) size = parseInt(m[1]);
+        } else if (res.headers['content-length'] && !res.headers['content-encoding']) {
+            size = parseInt(res.headers['content-length']);
+        }
+
+        const state: DownloadState = {
+            url: this.url,
+            size: size,
+            etag: <string | undefined>res.headers['etag'],
+            lastModified: <string | undefined>res.headers['last-modified'],
+            segments: [{ start: 0, end: size - 1, pos: 0 }]
+        };
+
+        // split the file into segments, the first segment uses the first response
+        const count = Math.max(1, Math.floor(this.options.segments || 1));
+        if (count > 1 && res.statusCode == 206 && size >= MIN_SEGMENT_SIZE * 2) {
+            const n = Math.min(count, Math.floor(size / MIN_SEGMENT_SIZE));
+            const len = Math.ceil(size / n);
+            state.segments = [];
+            for (let start = 0; start < size; start += len) {
+                state.segments.push({ start: start, end: Math.min(start + len, size) - 1, pos: start });
+            }
+        }
+
+        return state;
+    }
+
+    private receivedSize(state: DownloadState): number {
+        let n = 0;
+        state.segments.forEach(s => n += s.pos - s.start);
+        return n;
+    }
+
+    private rangeHeader(seg: Segment): string {
+        return `bytes=${seg.pos}-${seg.end >= 0 ? seg.end : ''}`;
+    }
+
+    //
+    // transfer
+    //
+
+    private async downloadSegment(seg: Segment, fd: number, hashers: Map<string, crypto.Hash> | undefined,
+        progress: () => void, response: ResponseInfo | undefined, state: DownloadState): Promise<void> {
+
+        let retries = this.options.retries !== undefined ? this.options.retries : 3;
+
+        while (seg.end < 0 || seg.pos <= seg.end) {
+
+            if (this.stopped)
+                throw new DownloadCanceledError(this.url);
+
+            try {
+
+                let info = response;
+                response = undefined;
+
+                if (info == undefined) {
+                    info = await this.request(this.url, this.rangeHeader(seg), state);
+                    if (info.res.statusCode != 206) {
+                        info.req.destroy();
+                        const err = new Error(`The server does not support to resume the download (http ${info.res.statusCode}): '${this.url}'`);
+                        (<any>err).fatal = true;
+                        throw err;
+                    }
+                }
+
+                await this.receive(info, seg, fd, hashers, progress);
+
+                if (seg.end < 0)
+                    return; // size is unknown, done at the end of the stream
+
+            } catch (error) {
+                if (this.stopped || retries <= 0 || (<any>error).fatal)
+                    throw error;
+                retries--;
+            }
+        }
+    }
+
+    private receive(info: ResponseInfo, seg: Segment, fd: number,
+        hashers: Map<string, crypto.Hash> | undefined, progress: () => void): Promise<void> {
+
+        return new Promise((resolve, reject) => {
+
+            let finished = false;
+            const finish = (error?: Error) => {
+                if (!finished) {
+                    finished = true;
+                    this.requests.delete(info.req);
+                    if (error) reject(error); else resolve();
+                }
+            };
+
+            info.res.on('data', (chunk: Buffer) => {
+
+                if (finished || this.stopped)
+                    return;
+
+                // the rest of the response is not needed, it's for another segment
+                if (seg.end >= 0 && seg.pos + chunk.length > seg.end + 1) {
+                    chunk = chunk.subarray(0, seg.end + 1 - seg.pos);
+                }
+
+                try {
+                    let done = 0;
+                    while (done < chunk.length)
+                        done += fs.writeSync(fd, chunk, done, chunk.length - done, seg.pos + done);
+                } catch (error) {
+                    (<any>error).fatal = true;
+                    info.req.destroy();
+                    finish(<Error>error);
+                    return;
+                }
+
+                if (hashers) {
+                    hashers.forEach(h => h.update(chunk));
+                }
+
+                seg.pos += chunk.length;
+                progress();
+
+                if (seg.end >= 0 && seg.pos > seg.end) {
+                    info.req.destroy();
+                    finish();
+                }
+            });
+
+            info.res.on('end', () => {
+                if (seg.end >= 0 && seg.pos <= seg.end) {
+                    finish(new Error(`Connection closed before the download is completed: '${this.url}'`));
+                } else {
+                    finish();
+                }
+            });
+
+            info.res.on('error', (err) => finish(err));
+            info.res.on('aborted', () => finish(new Error(`Connection aborted: '${this.url}'`)));
+            info.req.on('error', (err) => finish(err));
+            info.req.on('close', () => {
+                if (seg.end >= 0 && seg.pos <= seg.end)
+                    finish(new Error(`Connection closed before the download is completed: '${this.url}'`));
+            });
+        });
+    }
+
+    /**
+     * Send a GET request, the redirects are followed
+     *
+     * @param state if it's specified, the request is failed if the file on the server is changed
+    */
+    private request(url: string, range: string, state?: DownloadState, redirects?: number): Promise<ResponseInfo> {
+
+        return new Promise((resolve, reject) => {
+
+            if (this.stopped) {
+                reject(new DownloadCanceledError(this.url));
+                return;
+            }
+
+            const headers: http.OutgoingHttpHeaders = {};
+            const optHeaders = this.options.headers || {};
+            for (const key in optHeaders) {
+                if (optHeaders[key] !== undefined)
+                    headers[key] = optHeaders[key];
+            }
+
+            if (range) {
+                headers['Range'] = range;
+            }
+            headers['Accept-Encoding'] = 'identity';
+
+            const validator = state ? (state.etag || state.lastModified) : undefined;
+            if (validator) {
+                headers['If-Range'] = validator;
+            }
+
+            const urlObj = new URL(url);
+            const mod = urlObj.protocol == 'http:' ? http : https;
+
+            const req = mod.get(urlObj, {
+                headers: headers,
+                timeout: this.options.timeout || 30000,
+                rejectUnauthorized: this.options.rejectUnauthorized !== false
+            }, (res) => {
+
+                const code = res.statusCode || 0;
+
+                if (code >= 300 && code < 400 && res.headers.location) {
+                    res.resume();
+                    this.requests.delete(req);
+                    if ((redirects || 0) >= MAX_REDIRECTS) {
+                        reject(new Error(`Too many redirects: '${this.url}'`));
+                        return;
+                    }
+                    const next = new URL(res.headers.location, url).toString();
+                    this.request(next, range, state, (redirects || 0) + 1).then(resolve, reject);
+                    return;
+                }
+
+                if (code == 416 && state == undefined && range) {
+                    // empty file, the range 'bytes=0-' is not satisfiable
+                    res.resume();
+                    this.requests.delete(req);
+                    this.request(url, '', state, redirects).then(resolve, reject);
+                    return;
+                }
+
+                if (code != 200 && code != 206) {
+                    res.resume();
+                    this.requests.delete(req);
+                    const err = new Error(`Download file failed !, http code: ${code}, msg: ${res.statusMessage}, url: '${url}'`);
+                    (<any>err).fatal = code >= 400 && code < 500;
+                    reject(err);
+                    return;
+                }
+
+                resolve({ res: res, req: req, url: url });
+            });
+
+            req.on('timeout', () => req.destroy(new Error(`Connection timeout: '${url}'`)));
+            req.on('error', (err) => {
+                this.requests.delete(req);
+                reject(this.stopped ? new DownloadCanceledError(this.url) : err);
+            });
+
+            this.requests.add(req);
+        });
+    }
+
+    //
+    // hash
+    //
+
+    private hashAlgorithms(): DownloadHashAlgorithm[] {
+        const algs: DownloadHashAlgorithm[] = (this.options.hashes || []).slice();
+        if (this.options.expectedHash && !algs.includes(this.options.expectedHash.algorithm))
+            algs.push(this.options.expectedHash.algorithm);
+        return algs;
+    }
+
+    private createHashers(size: number): Map<string, crypto.Hash> {
+        const map = new Map<string, crypto.Hash>();
+        this.hashAlgorithms().forEach(alg => {
+            if (alg == 'git-sha1') {
+                map.set(alg, crypto.createHash('sha1').update(`blob ${size}\0`));
+            } else {
+                map.set(alg, crypto.createHash(alg));
+            }
+        });
+        return map;
+    }
+
+    private hashFile(hashers: Map<string, crypto.Hash>, fd: number, size: number) {
+        if (hashers.size == 0)
+            return;
+        const buf = Buffer.alloc(1024 * 1024);
+        for (let pos = 0; pos < size;) {
+            const n = fs.readSync(fd, buf, 0, Math.min(buf.length, size - pos), pos);
+            if (n <= 0) break;
+            const chunk = buf.subarray(0, n);
+            hashers.forEach(h => h.update(chunk));
+            pos += n;
+        }
+    }
+}
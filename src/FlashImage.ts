@@ -0,0 +1,655 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+import * as NodePath from 'path';
+import { ElfFile, PT_LOAD, SHF_ALLOC, SHT_NOBITS, isElfFile } from './ElfReader';
+
+/** magic of the saved image file */
+const IMAGE_FILE_MAGIC = 'EIDEFIMG';
+const IMAGE_FILE_VERSION = 1;
+
+export interface FlashSegment {
+    addr: number;
+    data: Buffer;
+}
+
+/**
+ * A flash region which is divided into sectors with the same size
+*/
+export interface FlashSectorRegion {
+    start: number;
+    /** end address (exclusive) */
+    end: number;
+    sectorSize: number;
+    /** value of the erased flash, usually 0xFF */
+    erasedValue: number;
+}
+
+/**
+ * Two input files write different data to the same address range
+*/
+export interface FlashImageOverlap {
+    start: number;
+    /** end address (exclusive) */
+    end: number;
+    files: [string, string];
+}
+
+export interface FlashDeltaChunk {
+    addr: number;
+    data: Buffer;
+}
+
+export interface FlashDelta {
+    /** changed sectors, adjacent sectors are merged into one chunk */
+    chunks: FlashDeltaChunk[];
+    changedSectors: number;
+    totalSectors: number;
+}
+
+/**
+ * A sparse memory image loaded from hex/s19/bin/elf files.
+ *
+ * Later writes override the earlier ones, segments are kept sorted and
+ * not overlapped, adjacent segments are merged.
+*/
+export class FlashImage {
+
+    /** entry point, from the elf header or the start address record of the hex file */
+    entry: number | undefined;
+
+    private _segments: FlashSegment[] = [];
+    private pieces: FlashSegment[] = [];
+
+    get segments(): FlashSegment[] {
+        this.normalize();
+        return this._segments;
+    }
+
+    /**
+     * Load a program file, the format is detected by the suffix (and the elf magic)
+     *
+     * @param binAddr load address of a raw binary file
+    */
+    static fromFile(path: string, binAddr?: number): FlashImage {
+        const img = new FlashImage();
+        img.addFile(path, binAddr);
+        return img;
+    }
+
+    addFile(path: string, binAddr?: number) {
+        const suffix = NodePath.extname(path).toLowerCase();
+        if (['.hex', '.ihex', '.ihx'].includes(suffix)) {
+            this.addIntelHex(fs.readFileSync(path, 'ascii'));
+        } else if (['.s19', '.s28', '.s37', '.srec', '.mot'].includes(suffix)) {
+            this.addSrecord(fs.readFileSync(path, 'ascii'));
+        } else if (suffix == '.bin') {
+            this.write(binAddr || 0, fs.readFileSync(path));
+        } else if (isElfFile(path)) {
+            this.addElf(path);
+        } else {
+            throw new Error(`Unsupported program file format: '${path}'`);
+        }
+    }
+
+    write(addr: number, data: Buffer) {
+        if (data.length > 0) {
+            this.pieces.push({ addr: addr, data: data });
+        }
+    }
+
+    addIntelHex(content: string) {
+
+        let base = 0;
+        let lineNum = 0;
+
+        for (const rawLine of content.split(/\r\n|\n/)) {
+
+            lineNum++;
+
+            const line = rawLine.trim();
+            if (line == '')
+                continue;
+
+            if (line[0] != ':' || line.length < 11)
+                throw new Error(`Invalid hex record at line ${lineNum}`);
+
+            const rec = Buffer.from(line.substr(1), 'hex');
+            if (rec.length < 5 || rec.length != rec[0] + 5)
+                throw new Error(`Invalid hex record length at line ${lineNum}`);
+            if (checksum8(rec) != 0)
+                throw new Error(`Hex record checksum error at line ${lineNum}`);
+
+            const len = rec[0];
+            const offset = rec.readUInt16BE(1);
+            const type = rec[3];
+
+            switch (type) {
+                case 0x00: // data
+                    this.write(base + offset, rec.slice(4, 4 + len));
+                    break;
+                case 0x01: // end of file
+                    return;
+                case 0x02: // extended segment address
+                    base = rec.readUInt16BE(4) * 16;
+                    break;
+                case 0x04: // extended linear address
+                    base = rec.readUInt16BE(4) * 0x10000;
+                    break;
+                case 0x05: // start linear address
+                    this.entry = rec.readUInt32BE(4);
+                    break;
+                default: // start segment address
+                    break;
+            }
+        }
+    }
+
+    addSrecord(content: string) {
+
+        let lineNum = 0;
+
+        for (const rawLine of content.split(/\r\n|\n/)) {
+
+            lineNum++;
+
+            const line = rawLine.trim();
+            if (line == '')
+                continue;
+
+            if (line[0] != 'S' || line.length < 4)
+                throw new Error(`Invalid s-record at line ${lineNum}`);
+
+            const type = line[1];
+            const rec = Buffer.from(line.substr(2), 'hex');
+            if (rec.length < 3 || rec.length != rec[0] + 1)
+                throw new Error(`Invalid s-record length at line ${lineNum}`);
+            if (((checksum8(rec) + 1) & 0xff) != 0)
+                throw new Error(`S-record checksum error at line ${lineNum}`);
+
+            const addrLen = type == '1' ? 2 : type == '2' ? 3 : type == '3' ? 4 : 0;
+            if (addrLen == 0)
+                continue; // header, count and start address records
+
+            const addr = rec.readUIntBE(1, addrLen);
+            this.write(addr, rec.slice(1 + addrLen, rec.length - 1));
+        }
+    }
+
+    /**
+     * Load the allocated sections of an elf file at their load address (LMA),
+     * like 'objcopy', the `PT_LOAD` segments are used if there is no section header.
+    */
+    addElf(path: string) {
+        const elf = ElfFile.open(path);
+        try {
+            this.entry = elf.header.entry;
+            const segments = elf.readSegments().filter(seg => seg.type == PT_LOAD && seg.filesz > 0);
+            const sections = elf.sections.filter(sec => (sec.flags & SHF_ALLOC) && sec.type != SHT_NOBITS && sec.size > 0);
+            if (sections.length == 0) {
+                for (const seg of segments) {
+                    this.write(seg.paddr, elf.readBytes(seg.offset, seg.filesz));
+                }
+            } else {
+                for (const sec of sections) {
+                    // the LMA of a section is decided by the segment which contains it
+                    const seg = segments.find(seg => sec.offset >= seg.offset && sec.offset + sec.size <= seg.offset + seg.filesz);
+                    if (seg == undefined)
+                        continue; // not loaded
+                    this.write(seg.paddr + (sec.offset - seg.offset), elf.readSectionData(sec));
+                }
+            }
+        } finally {
+            elf.close();
+        }
+    }
+
+    /**
+     * Get the contents of [start, end), the bytes not in the image are filled by `fill`
+    */
+    read(start: number, end: number, fill: number): Buffer {
+
+        const buf = Buffer.alloc(end - start, fill);
+        const segs = this.segments;
+
+        let i = this.findFirstSegment(start);
+        for (; i < segs.length && segs[i].addr < end; i++) {
+            const seg = segs[i];
+            const from = Math.max(start, seg.addr);
+            const to = Math.min(end, seg.addr + seg.data.length);
+            if (from < to)
+                seg.data.copy(buf, from - start, from - seg.addr, to - seg.addr);
+        }
+
+        return buf;
+    }
+
+    isEmpty(): boolean {
+        return this.segments.length == 0;
+    }
+
+    size(): number {
+        return this.segments.reduce((sum, seg) => sum + seg.data.length, 0);
+    }
+
+    /**
+     * Convert to intel hex, the same layout as 'objcopy -O ihex'
+    */
+    toIntelHex(): string {
+
+        const lines: string[] = [];
+        let upper = 0;
+
+        const record = (type: number, offset: number, data: Buffer) => {
+            const rec = Buffer.alloc(data.length + 5);
+            rec[0] = data.length;
+            rec.writeUInt16BE(offset, 1);
+            rec[3] = type;
+            data.copy(rec, 4);
+            rec[rec.length - 1] = (0x100 - checksum8(rec.slice(0, rec.length - 1))) & 0xff;
+            lines.push(':' + rec.toString('hex').toUpperCase());
+        };
+
+        for (const seg of this.segments) {
+            let off = 0;
+            while (off < seg.data.length) {
+                const addr = seg.addr + off;
+                if (addr > 0xffffffff)
+                    throw new Error(`Address 0x${addr.toString(16)} is out of the intel hex range`);
+                const hi = Math.floor(addr / 0x10000);
+                if (hi != upper) {
+                    const ext = Buffer.alloc(2);
+                    ext.writeUInt16BE(hi, 0);
+                    record(0x04, 0, ext);
+                    upper = hi;
+                }
+                // a record never crosses a 64K boundary
+                const len = Math.min(16, seg.data.length - off, 0x10000 - (addr & 0xffff));
+                record(0x00, addr & 0xffff, seg.data.slice(off, off + len));
+                off += len;
+            }
+        }
+
+        if (this.entry != undefined) {
+            const start = Buffer.alloc(4);
+            start.writeUInt32BE(this.entry >>> 0, 0);
+            record(0x05, 0, start);
+        }
+
+        record(0x01, 0, Buffer.alloc(0));
+
+        return lines.join('\n') + '\n';
+    }
+
+    /**
+     * Convert to a raw binary from the lowest to the highest address
+     *
+     * @param fill the value of the gaps
+    */
+    toBinary(fill: number = 0xff): { addr: number, data: Buffer } {
+        const segs = this.segments;
+        if (segs.length == 0)
+            return { addr: 0, data: Buffer.alloc(0) };
+        const last = segs[segs.length - 1];
+        const start = segs[0].addr;
+        return { addr: start, data: this.read(start, last.addr + last.data.length, fill) };
+    }
+
+    /**
+     * Write the image to a '.hex' or '.bin' file
+    */
+    writeFile(path: string, fill?: number) {
+        const suffix = NodePath.extname(path).toLowerCase();
+        let content: string | Buffer;
+        if (suffix == '.hex' || suffix == '.ihex') {
+            content = this.toIntelHex();
+        } else if (suffix == '.bin') {
+            content = this.toBinary(fill).data;
+        } else {
+            throw new Error(`Unsupported output file format: '${path}'`);
+        }
+        // keep the file untouched if nothing is changed, it may be read by a running flasher
+        if (fs.existsSync(path) && fs.readFileSync(path).equals(Buffer.from(content)))
+            return;
+        fs.mkdirSync(NodePath.dirname(path), { recursive: true });
+        fs.writeFileSync(path, content);
+    }
+
+    /**
+     * Merge program files into one image, and report the overlapped ranges which have different data
+     *
+     * @param binAddr default load address of the '.bin' files
+    */
+    static merge(files: { path: string, addr?: string }[], binAddr?: string): { image: FlashImage, overlaps: FlashImageOverlap[] } {
+
+        const result = new FlashImage();
+        const overlaps: FlashImageOverlap[] = [];
+        const loaded: { path: string, image: FlashImage }[] = [];
+
+        for (const file of files) {
+
+            const addr = file.addr || binAddr;
+            const img = FlashImage.fromFile(file.path, addr ? parseInt(addr) : undefined);
+
+            for (const prev of loaded) {
+                for (const seg of img.segments) {
+                    const segEnd = seg.addr + seg.data.length;
+                    for (const other of prev.image.segments) {
+                        const start = Math.max(seg.addr, other.addr);
+                        const end = Math.min(segEnd, other.addr + other.data.length);
+                        if (start < end && !img.read(start, end, 0).equals(prev.image.read(start, end, 0))) {
+                            overlaps.push({ start, end, files: [prev.path, file.path] });
+                        }
+                    }
+                }
+            }
+
+            for (const seg of img.segments) {
+                result.write(seg.addr, seg.data);
+            }
+
+            if (result.entry == undefined)
+                result.entry = img.entry;
+
+            loaded.push({ path: file.path, image: img });
+        }
+
+        return { image: result, overlaps: overlaps };
+    }
+
+    /**
+     * Save the image into a binary file, the content is: magic, version, segment count,
+     * and [addr(f64), size(u32), data] for each segment
+    */
+    save(path: string) {
+
+        const segs = this.segments;
+        const header = Buffer.alloc(IMAGE_FILE_MAGIC.length + 8);
+        header.write(IMAGE_FILE_MAGIC, 0, 'ascii');
+        header.writeUInt32LE(IMAGE_FILE_VERSION, IMAGE_FILE_MAGIC.length);
+        header.writeUInt32LE(segs.length, IMAGE_FILE_MAGIC.length + 4);
+
+        const parts: Buffer[] = [header];
+        for (const seg of segs) {
+            const h = Buffer.alloc(12);
+            h.writeDoubleLE(seg.addr, 0);
+            h.writeUInt32LE(seg.data.length, 8);
+            parts.push(h, seg.data);
+        }
+
+        fs.mkdirSync(NodePath.dirname(path), { recursive: true });
+        const tmpPath = path + '.tmp';
+        fs.writeFileSync(tmpPath, Buffer.concat(parts));
+        fs.renameSync(tmpPath, path);
+    }
+
+    static load(path: string): FlashImage {
+
+        const buf = fs.readFileSync(path);
+        const hdrLen = IMAGE_FILE_MAGIC.length + 8;
+        if (buf.length < hdrLen || buf.toString('ascii', 0, IMAGE_FILE_MAGIC.length) != IMAGE_FILE_MAGIC)
+            throw new Error(`Invalid image file: '${path}'`);
+        if (buf.readUInt32LE(IMAGE_FILE_MAGIC.length) != IMAGE_FILE_VERSION)
+            throw new Error(`Unsupported image file version: '${path}'`);
+
+        const img = new FlashImage();
+        const count = buf.readUInt32LE(IMAGE_FILE_MAGIC.length + 4);
+
+        let off = hdrLen;
+        for (let i = 0; i < count; i++) {
+            if (off + 12 > buf.length)
+                throw new Error(`Unexpected end of image file: '${path}'`);
+            const addr = buf.readDoubleLE(off);
+            const size = buf.readUInt32LE(off + 8);
+            off += 12;
+            if (off + size > buf.length)
+                throw new Error(`Unexpected end of image file: '${path}'`);
+            img.write(addr, buf.slice(off, off + size));
+            off += size;
+        }
+
+        return img;
+    }
+
+    //---
+
+    private normalize() {
+
+        if (this.pieces.length == 0)
+            return;
+
+        const all = this._segments.concat(this.pieces);
+        this.pieces = [];
+
+        // the spans covered by all pieces
+        const sorted = all.slice().sort((a, b) => a.addr - b.addr);
+        const spans: { addr: number, end: number }[] = [];
+        for (const p of sorted) {
+            const end = p.addr + p.data.length;
+            const last = spans[spans.length - 1];
+            if (last && p.addr <= last.end) {
+                last.end = Math.max(last.end, end);
+            } else {
+                spans.push({ addr: p.addr, end: end });
+            }
+        }
+
+        const result: FlashSegment[] = spans.map((s) => {
+            return { addr: s.addr, data: Buffer.alloc(s.end - s.addr) };
+        });
+
+        // paint the pieces in write order, so the later one wins
+        for (const p of all) {
+            const seg = result[findSpan(result, p.addr)];
+            p.data.copy(seg.data, p.addr - seg.addr);
+        }
+
+        this._segments = result;
+    }
+
+    /** index of the first segment which ends after 'addr' */
+    private findFirstSegment(addr: number): number {
+        const segs = this._segments;
+        let lo = 0, hi = segs.length;
+        while (lo < hi) {
+            const mid = (lo + hi) >> 1;
+            if (segs[mid].addr + segs[mid].data.length <= addr)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+}
+
+function checksum8(buf: Buffer): number {
+    let sum = 0;
+    for (let i = 0; i < buf.length; i++)
+        sum = (sum + buf[i]) & 0xff;
+    return sum;
+}
+
+/** index of the span which contains 'addr', the spans must be sorted */
+function findSpan(spans: FlashSegment[], addr: number): number {
+    let lo = 0, hi = spans.length - 1;
+    while (lo < hi) {
+        const mid = (lo + hi + 1) >> 1;
+        if (spans[mid].addr <= addr)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+//////////////////////////////////////////////////////////////
+// sector layout
+//////////////////////////////////////////////////////////////
+
+/**
+ * Read the sector layout from the `FlashDevice` description of a CMSIS flash algorithm (.FLM)
+ *
+ * @param base the flash start address in the pack, override the 'DevAdr' of the algorithm
+*/
+export function readFlmSectorLayout(flmPath: string, base?: number): FlashSectorRegion[] {
+
+    const elf = ElfFile.open(flmPath);
+
+    try {
+
+        let devSym: { value: number, shndx: number } | undefined;
+        elf.forEachSymbol((sym) => {
+            if (sym.name == 'FlashDevice') {
+                devSym = sym;
+                return false;
+            }
+        });
+
+        if (devSym == undefined || elf.sections[devSym.shndx] == undefined)
+            throw new Error(`Not found 'FlashDevice' in '${flmPath}'`);
+
+        const sec = elf.sections[devSym.shndx];
+        const off = sec.offset + (devSym.value - sec.addr);
+
+        /*
+            struct FlashDevice {
+                unsigned short Vers;
+                char DevName[128];
+                unsigned short DevType;
+                unsigned long DevAdr;       // +132
+                unsigned long szDev;        // +136
+                unsigned long szPage;
+                unsigned long Res;
+                unsigned char valEmpty;     // +148
+                unsigned long toProg;
+                unsigned long toErase;
+                struct { unsigned long szSector, AddrSector; } sectors[]; // +160, end with 0xFFFFFFFF
+            };
+        */
+        const le = elf.header.littleEndian;
+        const u32 = (b: Buffer, o: number) => le ? b.readUInt32LE(o) : b.readUInt32BE(o);
+
+        const dev = elf.readBytes(off, 160);
+        const devAdr = u32(dev, 132);
+        const szDev = u32(dev, 136);
+        const erasedValue = dev[148];
+        const start = base != undefined ? base : devAdr;
+
+        const sectors: { size: number, addr: number }[] = [];
+        for (let p = off + 160; ; p += 8) {
+            const item = elf.readBytes(p, 8);
+            const size = u32(item, 0);
+            const addr = u32(item, 4);
+            if (size == 0xffffffff || addr == 0xffffffff || size == 0)
+                break;
+            sectors.push({ size, addr });
+        }
+
+        return sectors.map((s, i) => {
+            const end = i + 1 < sectors.length ? sectors[i + 1].addr : szDev;
+            return {
+                start: start + s.addr,
+                end: start + end,
+                sectorSize: s.size,
+                erasedValue: erasedValue
+            };
+        }).filter(r => r.end > r.start);
+
+    } finally {
+        elf.close();
+    }
+}
+
+function findRegion(layout: FlashSectorRegion[], addr: number): FlashSectorRegion | undefined {
+    return layout.find(r => addr >= r.start && addr < r.end);
+}
+
+/**
+ * Diff two images at the sector granularity.
+ *
+ * @returns undefined if the new image has any bytes out of the sector layout,
+ *  in that case, a delta flash is not safe.
+*/
+export function diffFlashImage(oldImage: FlashImage, newImage: FlashImage, layout: FlashSectorRegion[]): FlashDelta | undefined {
+
+    // collect the sectors touched by both images
+    const sectorMap = new Map<number, FlashSectorRegion>();
+
+    const collect = (img: FlashImage, strict: boolean): boolean => {
+        for (const seg of img.segments) {
+            const segEnd = seg.addr + seg.data.length;
+            let addr = seg.addr;
+            while (addr < segEnd) {
+                const region = findRegion(layout, addr);
+                if (region == undefined) {
+                    if (strict)
+                        return false;
+                    // skip to the next region, old bytes out of the layout are ignored
+                    addr = layout.filter(r => r.start > addr && r.start < segEnd)
+                        .reduce((min, r) => Math.min(min, r.start), segEnd);
+                    continue;
+                }
+                const sector = region.start + Math.floor((addr - region.start) / region.sectorSize) * region.sectorSize;
+                sectorMap.set(sector, region);
+                addr = Math.min(sector + region.sectorSize, region.end);
+            }
+        }
+        return true;
+    };
+
+    if (!collect(newImage, true))
+        return undefined;
+
+    collect(oldImage, false);
+
+    const sectors = Array.from(sectorMap.keys()).sort((a, b) => a - b);
+    const result: FlashDelta = {
+        chunks: [],
+        changedSectors: 0,
+        totalSectors: sectors.length
+    };
+
+    for (const sector of sectors) {
+
+        const region = <FlashSectorRegion>sectorMap.get(sector);
+        const end = Math.min(sector + region.sectorSize, region.end);
+
+        const newData = newImage.read(sector, end, region.erasedValue);
+        const oldData = oldImage.read(sector, end, region.erasedValue);
+        if (newData.equals(oldData))
+            continue;
+
+        result.changedSectors++;
+
+        const last = result.chunks[result.chunks.length - 1];
+        if (last && last.addr + last.data.length == sector) {
+            last.data = Buffer.concat([last.data, newData]);
+        } else {
+            result.chunks.push({ addr: sector, data: newData });
+        }
+    }
+
+    return result;
+}
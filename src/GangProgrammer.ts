@@ -0,0 +1,213 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as os from 'os';
+
+/** file name of the gang programming report, it's placed in the target output folder */
+export const GANG_REPORT_FILE_NAME = 'gang_report.txt';
+
+export const GANG_DEF_CONCURRENCY = 4;
+
+/** Result of one flash attempt, compatible with `FlashCommandResult` of the uploader */
+export interface GangFlashResult {
+    success: boolean;
+    message: string;
+    error?: Error;
+}
+
+export interface GangBoardResult {
+
+    /** serial number of the probe */
+    serial: string;
+
+    success: boolean;
+
+    /** number of flash attempts, include the retries */
+    attempts: number;
+
+    /** time used by all attempts (ms) */
+    duration: number;
+
+    /** flasher outputs of all attempts */
+    log: string;
+
+    error?: string;
+}
+
+export interface GangReport {
+
+    /** unix time (ms) */
+    startTime: number;
+
+    /** time used by the whole run (ms) */
+    duration: number;
+
+    concurrency: number;
+
+    boards: GangBoardResult[];
+
+    passed: number;
+
+    failed: number;
+}
+
+export interface GangOptions {
+
+    /** max number of boards flashed at the same time */
+    concurrency?: number;
+
+    /** max retries for a failed board */
+    retries?: number;
+
+    /** called when a board is done */
+    onBoardDone?: (board: GangBoardResult, done: number, total: number) => void;
+}
+
+/**
+ * Split the probe serial numbers, separated by ',', ';' or white spaces, duplicates are removed
+*/
+export function parseProbeSerials(input: string | string[]): string[] {
+    const list = Array.isArray(input) ? input : input.split(/[,;\s]+/);
+    const result: string[] = [];
+    for (const sn of list.map(s => s.trim())) {
+        if (sn != '' && !result.includes(sn))
+            result.push(sn);
+    }
+    return result;
+}
+
+/**
+ * Flash boards in parallel, one flash job for each probe, at most `concurrency` jobs run at the same time.
+ * A failed board is retried right away, until it's passed or the retries are used up.
+ *
+ * @param flash flash the board which is connected to the probe, it should not throw
+*/
+export async function runGang(serials: string[], flash: (serial: string) => Promise<GangFlashResult>,
+    options?: GangOptions): Promise<GangReport> {
+
+    const opts = options || {};
+    const concurrency = Math.max(1, Math.min(opts.concurrency || GANG_DEF_CONCURRENCY, serials.length || 1));
+    const retries = Math.max(0, opts.retries || 0);
+
+    const startTime = Date.now();
+    const boards: GangBoardResult[] = new Array(serials.length);
+    let next = 0;
+    let done = 0;
+
+    const flashBoard = async (serial: string): Promise<GangBoardResult> => {
+
+        const board: GangBoardResult = { serial, success: false, attempts: 0, duration: 0, log: '' };
+        const t0 = Date.now();
+
+        while (!board.success && board.attempts <= retries) {
+
+            board.attempts++;
+
+            let res: GangFlashResult;
+            try {
+                res = await flash(serial);
+            } catch (error) {
+                res = { success: false, message: '', error: <Error>error };
+            }
+
+            board.success = res.success;
+            board.log += `--- attempt ${board.attempts}: ${res.success ? 'passed' : 'failed'}${os.EOL}`;
+            if (res.message) board.log += res.message.trim() + os.EOL;
+
+            if (res.success) {
+                board.error = undefined;
+            } else {
+                // the last line of the flasher output is more useful than 'Command failed: ...'
+                const lines = (res.message || '').split(/\r?\n/).filter(l => l.trim() != '');
+                board.error = lines.length > 0 ? lines[lines.length - 1].trim()
+                    : (res.error ? res.error.message.split(/\r?\n/)[0] : 'failed');
+            }
+        }
+
+        board.duration = Date.now() - t0;
+        return board;
+    };
+
+    const worker = async () => {
+        while (next < serials.length) {
+            const idx = next++;
+            boards[idx] = await flashBoard(serials[idx]);
+            done++;
+            if (opts.onBoardDone) {
+                opts.onBoardDone(boards[idx], done, serials.length);
+            }
+        }
+    };
+
+    const workers: Promise<void>[] = [];
+    for (let i = 0; i < concurrency; i++) {
+        workers.push(worker());
+    }
+    await Promise.all(workers);
+
+    const passed = boards.filter(b => b.success).length;
+
+    return {
+        startTime,
+        duration: Date.now() - startTime,
+        concurrency,
+        boards,
+        passed,
+        failed: boards.length - passed
+    };
+}
+
+/**
+ * Make a text report: a summary table, then the logs of the failed boards
+*/
+export function formatGangReport(report: GangReport, title?: string): string {
+
+    const lines: string[] = [];
+    const secs = (ms: number) => (ms / 1000).toFixed(1) + 's';
+    const snWidth = Math.max(6, ...report.boards.map(b => b.serial.length));
+
+    lines.push(`Gang Programming Report${title ? (': ' + title) : ''}`);
+    lines.push(`Time: ${new Date(report.startTime).toLocaleString()}, Duration: ${secs(report.duration)}, Concurrency: ${report.concurrency}`);
+    lines.push(`Result: ${report.passed} passed, ${report.failed} failed, ${report.boards.length} total`);
+    lines.push('');
+
+    lines.push(`${'Serial'.padEnd(snWidth)}  Result  Tries  Time     Error`);
+    for (const b of report.boards) {
+        lines.push([
+            b.serial.padEnd(snWidth),
+            (b.success ? 'PASS' : 'FAIL').padEnd(6),
+            b.attempts.toString().padEnd(5),
+            secs(b.duration).padEnd(7),
+            b.error || ''
+        ].join('  ').trimEnd());
+    }
+
+    for (const b of report.boards.filter(b => !b.success)) {
+        lines.push('');
+        lines.push(`=== ${b.serial} ===`);
+        lines.push(b.log.trimEnd());
+    }
+
+    return lines.join(os.EOL) + os.EOL;
+}
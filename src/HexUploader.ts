@@ -31,7 +31,7 @@ import { CmdLineHandler } from "./CmdLineHandler";
 import { gotoSet_text, view_str$download_software } from "./StringTable";
 import { EncodingConverter } from "./EncodingConverter";
 import { ToolchainName, ToolchainManager } from "./ToolchainManager";
-import { sendCommandToTerminal, deepCloneObject, probers_install } from './utility';
+import { sendCommandToTerminal, deepCloneObject, probers_install, md5 } from './utility';
 import { WorkspaceManager } from "./WorkspaceManager";
 
 import * as child_process from "child_process";
@@ -44,9 +44,15 @@ import { ResInstaller } from "./ResInstaller";
 import { newMessage } from "./Message";
 import { concatSystemEnvPath, exeSuffix, prependToSysEnv, osType, appendToSysEnv, userhome } from "./Platform";
 import { StatusBarManager } from "./StatusBarManager";
+import { SerialPortEnumerator } from "./SerialPortEnumerator";
+import { FlashImage, FlashSectorRegion, diffFlashImage, readFlmSectorLayout } from "./FlashImage";
+import { isElfFile } from "./ElfReader";
+import { ProbeSessionManager, ProbeServerSession, ProbeSessionResult, OpenOCDSession, PyOCDCommanderSession } from "./ProbeSession";
 
 let _mInstance: HexUploaderManager | undefined;
 
+let _prepareQueue: Promise<any> = Promise.resolve();
+
 export type HexUploaderType = 'JLink' | 'STVP' | 'STLink' | 'stcgal' | 'pyOCD' | 'OpenOCD' | 'probe-rs' | 'Custom';
 
 export interface UploadOption {
@@ -189,6 +195,28 @@ export interface FlashProgramFile {
     addr?: string;
 };
 
+interface DeltaFlashPlan {
+
+    /** changed sectors, saved as binary files */
+    chunks: FlashProgramFile[];
+
+    /** all segments of the new image, only if full verify is enabled */
+    verifyFiles?: FlashProgramFile[];
+
+    /** only for 'in-script' verification: the segments of the last flashed image, they must be verified before the chunks are written */
+    oldFiles?: FlashProgramFile[];
+
+    /** only for 'in-script' verification: all segments of the new image, written if the old image is not matched */
+    imageFiles?: FlashProgramFile[];
+}
+
+/**
+ * Check the last flashed image on the target before a delta flash:
+ *  - a function: run the verification, the delta flash is used only if it returns true
+ *  - 'in-script': the flasher commands verify the old image and fall back to a full flash by themselves
+*/
+type DeltaFlashVerifier = ((oldFiles: FlashProgramFile[]) => Promise<boolean>) | 'in-script';
+
 export abstract class HexUploader<InvokeParamsType> {
 
     abstract readonly toolType: HexUploaderType;
@@ -198,6 +226,13 @@ export abstract class HexUploader<InvokeParamsType> {
     protected project: AbstractProject;
     protected shellPath: string | undefined;
     protected notUseTerminal: boolean;
+    protected outputListener: ((text: string) => void) | undefined;
+
+    /** the image will be flashed, it is saved as the last flashed image after a successful flash */
+    private flashState: { path: string, image: FlashImage } | undefined;
+
+    /** serial number of the probe to use, if undefined, the flasher uses its default probe */
+    protected probeSerial: string | undefined;
 
     constructor(prj: AbstractProject) {
         this.project = prj;
@@ -207,7 +242,20 @@ export abstract class HexUploader<InvokeParamsType> {
 
     async upload(eraseAll?: boolean): Promise<FlashCommandResult | void> {
 
-        const dat = await this._prepare(eraseAll);
+        // uploaders may run in parallel (gang programming), but they share the
+        // files generated in the output folder, so prepare them one by one
+        const prev = _prepareQueue;
+        const prepare = () => {
+            if (!eraseAll) this.generateDefaultHexFile();
+            return this._prepare(eraseAll);
+        };
+        const dat = await (_prepareQueue = prev.then(prepare, prepare));
+
+        // the chip will be changed by a flasher without delta flash support,
+        // or by an erase, so the last flashed images are out of date
+        if (dat.isOk === true && this.flashState == undefined) {
+            this.clearFlashStates();
+        }
 
         if (this.notUseTerminal) {
             if (dat.isOk === false) { // canceled
@@ -277,19 +325,44 @@ export abstract class HexUploader<InvokeParamsType> {
         return result;
     }
 
-    resolveHexFilePathEnvs(input: string, programs: FlashProgramFile[]): string {
-
-        let portList: string[] = [];
+    /**
+     * The '.hex' file is the default program file, generate it from the output elf before a flash
+     * if the toolchain did not (no objcopy/fromelf, or the tool failed), or it's older than the elf.
+    */
+    private generateDefaultHexFile() {
         try {
-            portList = ResManager.GetInstance().enumSerialPort();
+            if (this.getUploadOptions<UploadOption>().bin.trim() !== '')
+                return; // the program files are set by user
+            const hexPath = this.project.getExecutablePathWithoutSuffix() + '.hex';
+            const elfPath = this.project.getExecutablePath();
+            if (!File.IsFile(elfPath) || !isElfFile(elfPath))
+                return;
+            if (File.IsFile(hexPath) && fs.statSync(hexPath).mtimeMs >= fs.statSync(elfPath).mtimeMs)
+                return;
+            FlashImage.fromFile(elfPath).writeFile(hexPath);
+            GlobalEvent.log_info(`generated '${NodePath.basename(hexPath)}' from '${NodePath.basename(elfPath)}'`);
         } catch (error) {
-            GlobalEvent.log_error(error);
+            GlobalEvent.log_warn(<Error>error);
+        }
+    }
+
+    async resolveHexFilePathEnvs(input: string, programs: FlashProgramFile[]): Promise<string> {
+
+        // only enum serial ports when they are used
+        let portList: string[] = [];
+        if (SerialPortEnumerator.isPortVarReferenced(input)) {
+            try {
+                portList = await SerialPortEnumerator.instance().list();
+            } catch (error) {
+                GlobalEvent.log_error(error);
+            }
         }
 
         let commandLine = input
             .replace(/\$\{hexFile\}|\$\{binFile\}|\$\{programFile\}/ig, programs[0].path)
             .replace(/\$\{port\}/ig, portList[0] || '')
             .replace(/\$\{portList\}/ig, portList.join(' '))
+            .replace(/\$\{probeSerial\}/ig, this.probeSerial || '')
             .replace('${port[0]}', portList[0] || '')
             .replace('${port[1]}', portList[1] || '')
             .replace('${port[2]}', portList[2] || '')
@@ -315,6 +388,329 @@ export abstract class HexUploader<InvokeParamsType> {
         return this.parseProgramFiles(this.getUploadOptions<any>());
     }
 
+    /**
+     * Merge multiple program files into one hex file, so that they are flashed in one session
+     *
+     * @param binAddr default load address of the '.bin' files
+     * @returns the merged file, or the origin list if there is only one file
+    */
+    protected mergeProgramFiles(programs: FlashProgramFile[], binAddr: string | undefined): FlashProgramFile[] {
+
+        if (programs.length <= 1)
+            return programs;
+
+        const r = FlashImage.merge(programs, binAddr || this.DEF_BIN_ADDR);
+        if (r.overlaps.length > 0) {
+            const lines = r.overlaps.map(o => {
+                const range = `0x${o.start.toString(16)}-0x${(o.end - 1).toString(16)}`;
+                return `${range}: '${NodePath.basename(o.files[0])}' <-> '${NodePath.basename(o.files[1])}'`;
+            });
+            throw new Error(`program files are overlapped:\n  ${lines.join('\n  ')}`);
+        }
+
+        const mergedPath = NodePath.join(this.getFlashStateDir(), 'merged.hex');
+        r.image.writeFile(mergedPath);
+
+        return [{ path: mergedPath }];
+    }
+
+    //--- delta flash
+
+    private getFlashStateDir(): string {
+        return NodePath.join(this.project.getOutputFolder().path, '.flash');
+    }
+
+    private clearFlashStates() {
+        try {
+            const dir = this.getFlashStateDir();
+            if (fs.existsSync(dir)) {
+                fs.readdirSync(dir)
+                    .filter(name => name.endsWith('.img'))
+                    .forEach(name => fs.unlinkSync(NodePath.join(dir, name)));
+            }
+        } catch (error) {
+            GlobalEvent.log_warn(<Error>error);
+        }
+    }
+
+    /**
+     * Save the flashed image as the last flashed image, called after a successful flash
+    */
+    protected saveFlashState() {
+        if (this.flashState) {
+            try {
+                this.flashState.image.save(this.flashState.path);
+            } catch (error) {
+                GlobalEvent.log_warn(<Error>error);
+            }
+            this.flashState = undefined;
+        }
+    }
+
+    /**
+     * Get the flash sector layout from the user setting or the flash algorithms of the device pack
+    */
+    protected getFlashSectorLayout(): FlashSectorRegion[] | undefined {
+
+        const sectorSize = SettingManager.instance().getDeltaFlashSectorSize();
+        if (sectorSize > 0) {
+            return [{ start: 0, end: 0x100000000, sectorSize: sectorSize, erasedValue: 0xff }];
+        }
+
+        const devInfo = this.project.GetPackManager().getCurrentDevInfo();
+        if (devInfo == undefined || devInfo.flashAlgorithms == undefined)
+            return undefined;
+
+        const layout: FlashSectorRegion[] = [];
+        for (const algo of devInfo.flashAlgorithms) {
+            if (!File.IsFile(algo.path))
+                continue;
+            try {
+                const base = parseInt(algo.start);
+                const regions = readFlmSectorLayout(algo.path, isNaN(base) ? undefined : base);
+                // the same flash may be described by more than one algorithm, use the first one
+                layout.push(...regions.filter(r => !layout.some(l => r.start < l.end && l.start < r.end)));
+            } catch (error) {
+                GlobalEvent.log_warn(<Error>error);
+            }
+        }
+
+        return layout.length > 0 ? layout : undefined;
+    }
+
+    /**
+     * The serial number of the probe which is selected by the user options, '' if the default probe is used
+    */
+    protected getProbeIdentity(userOptions: string | undefined, matcher: RegExp): string {
+        if (this.probeSerial)
+            return this.probeSerial;
+        const m = userOptions ? matcher.exec(userOptions) : null;
+        return m ? m[1] : '';
+    }
+
+    /**
+     * Run a verify-only (or read) command line of the flasher, returns the output if it's done without errors
+    */
+    protected async runVerifyCommand(commandLine: string, env?: any): Promise<string | undefined> {
+
+        // the probe may be opened by a resident session
+        await ProbeSessionManager.instance().closeAll();
+
+        GlobalEvent.log_info(`delta flash: verify the last flashed image: ${commandLine}`);
+
+        return new Promise((resolve) => {
+            child_process.exec(commandLine, { env: env, timeout: 120 * 1000, maxBuffer: 64 * 1024 * 1024, windowsHide: true },
+                (err, stdout, stderr) => resolve(err ? undefined : `${stdout}${stderr}`));
+        });
+    }
+
+    /**
+     * Read the memory of the files back by the flasher and compare them
+     *
+     * @param commandLine the command line which saves each memory range into 'path'
+    */
+    protected async verifyByReadBack(files: FlashProgramFile[],
+        commandLine: (reads: { addr: string, size: number, path: string }[]) => string, env?: any): Promise<boolean> {
+
+        const reads = files.map((file) => {
+            return { addr: file.addr || '0x0', size: fs.statSync(file.path).size, path: `${file.path}.read` };
+        });
+
+        if (await this.runVerifyCommand(commandLine(reads), env) == undefined)
+            return false;
+
+        return reads.every((r, i) => {
+            try {
+                return fs.readFileSync(r.path).equals(fs.readFileSync(files[i].path));
+            } catch (error) {
+                return false;
+            }
+        });
+    }
+
+    /**
+     * Diff the program files with the last flashed image of this flasher/target,
+     * and write the changed sectors into binary files.
+     *
+     * The unchanged sectors are not written, so the last flashed image must still be on the chip
+     * (the board may be swapped), it's checked by 'verifier' before a delta flash.
+     *
+     * @param binAddr default load address of the '.bin' files
+     * @param probeKey identify the probe (serial number) and the target chip
+     * @param verifier check the last flashed image on the target, a full flash is used if it's not matched
+     * @param noVerifyCmd the flasher has no verify-only command, a full flash is needed if full verify is enabled
+     * @returns undefined if a full flash is needed
+    */
+    protected async prepareDeltaFlash(programs: FlashProgramFile[], binAddr: string | undefined,
+        probeKey: string, verifier: DeltaFlashVerifier, noVerifyCmd?: boolean): Promise<DeltaFlashPlan | undefined> {
+
+        const settings = SettingManager.instance();
+        // the boards of a gang are changed every time, there is no last flashed image
+        if (!settings.isDeltaFlashEnabled() || this.probeSerial)
+            return undefined;
+
+        const stateDir = this.getFlashStateDir();
+        const statePath = NodePath.join(stateDir, `${this.toolType}-${md5(probeKey).substr(0, 8)}.img`);
+
+        const newImage = new FlashImage();
+        let oldImage: FlashImage | undefined;
+
+        try {
+
+            for (const file of programs) {
+                newImage.addFile(file.path, parseInt(file.addr || binAddr || this.DEF_BIN_ADDR));
+            }
+
+            if (fs.existsSync(statePath)) {
+                oldImage = FlashImage.load(statePath);
+            }
+
+        } catch (error) {
+            GlobalEvent.log_warn(<Error>error);
+            return undefined;
+        } finally {
+            // the chip will be changed, drop all old images
+            this.clearFlashStates();
+        }
+
+        this.flashState = { path: statePath, image: newImage };
+
+        if (oldImage == undefined)
+            return undefined; // first flash
+
+        if (noVerifyCmd && settings.isDeltaFlashFullVerify())
+            return undefined;
+
+        const layout = this.getFlashSectorLayout();
+        if (layout == undefined) {
+            GlobalEvent.log_info(`delta flash: flash sector layout is unknown, use full flash.`);
+            return undefined;
+        }
+
+        const delta = diffFlashImage(oldImage, newImage, layout);
+        if (delta == undefined) {
+            GlobalEvent.log_info(`delta flash: the image is out of the flash sector layout, use full flash.`);
+            return undefined;
+        }
+
+        // nothing changed, program the first sector anyway to keep the flow (connect, reset and run)
+        if (delta.chunks.length == 0) {
+            const first = newImage.segments[0];
+            const region = layout.find(r => first.addr >= r.start && first.addr < r.end);
+            if (region == undefined)
+                return undefined;
+            const sector = region.start + Math.floor((first.addr - region.start) / region.sectorSize) * region.sectorSize;
+            const end = Math.min(sector + region.sectorSize, region.end);
+            delta.chunks.push({ addr: sector, data: newImage.read(sector, end, region.erasedValue) });
+        }
+
+        const chunkDir = NodePath.join(stateDir, 'delta');
+        fs.rmSync(chunkDir, { recursive: true, force: true });
+        fs.mkdirSync(chunkDir, { recursive: true });
+
+        const toFiles = (list: { addr: number, data: Buffer }[], prefix: string): FlashProgramFile[] => {
+            return list.map((item) => {
+                const addr = '0x' + item.addr.toString(16).padStart(8, '0');
+                const path = NodePath.join(chunkDir, `${prefix}_${addr}.bin`);
+                fs.writeFileSync(path, item.data);
+                return { path: path, addr: addr };
+            });
+        };
+
+        const plan: DeltaFlashPlan = {
+            chunks: toFiles(delta.chunks, 'sector')
+        };
+
+        const oldFiles = toFiles(oldImage.segments, 'old');
+
+        if (verifier == 'in-script') {
+            plan.oldFiles = oldFiles;
+            plan.imageFiles = toFiles(newImage.segments, 'image');
+        } else {
+            let matched = false;
+            try {
+                matched = await verifier(oldFiles);
+            } catch (error) {
+                GlobalEvent.log_warn(<Error>error);
+            }
+            if (!matched) {
+                GlobalEvent.log_info(`delta flash: the last flashed image is not on the target, use full flash.`);
+                return undefined;
+            }
+        }
+
+        if (settings.isDeltaFlashFullVerify()) {
+            plan.verifyFiles = plan.imageFiles || toFiles(newImage.segments, 'image');
+        }
+
+        const bytes = delta.chunks.reduce((sum, c) => sum + c.data.length, 0);
+        GlobalEvent.log_info(`delta flash: ${delta.changedSectors}/${delta.totalSectors} sectors changed, ${bytes} bytes will be programmed.`);
+
+        return plan;
+    }
+
+    //--- resident probe session
+
+    protected isProbeSessionEnabled(): boolean {
+        return SettingManager.instance().isResidentProbeSessionEnabled() && this.probeSerial == undefined;
+    }
+
+    /**
+     * Run the commands in the resident probe session, the server is started once and reused.
+     *
+     * @param key identify the probe and the server configs
+     * @returns undefined if the session is not available, the caller should use the command line flasher
+    */
+    protected async runInProbeSession(key: string, factory: () => ProbeServerSession,
+        commands: string[]): Promise<{ result: FlashCommandResult | void } | undefined> {
+
+        const bar = StatusBarManager.getInstance().get('flash');
+        if (bar) {
+            bar.text = `$(loading~spin) Flashing`;
+        }
+
+        const startTime = Date.now();
+        let res: ProbeSessionResult;
+
+        try {
+            res = await ProbeSessionManager.instance().run(`${this.toolType}:${key}`, factory, commands);
+        } catch (error) {
+            GlobalEvent.log_warn(`${this.toolType} session is not available, use the command line: ${(<Error>error).message}`);
+            await ProbeSessionManager.instance().close(`${this.toolType}:${key}`);
+            return undefined;
+        } finally {
+            if (bar) {
+                bar.text = '$(arrow-down) Flash';
+            }
+        }
+
+        GlobalEvent.log_info(`[${this.toolType} session]${os.EOL}${res.output}`);
+
+        if (res.success) {
+            this.saveFlashState();
+        }
+
+        if (this.notUseTerminal) {
+            return {
+                result: {
+                    success: res.success,
+                    message: res.output,
+                    error: res.success ? undefined : new Error(res.error)
+                }
+            };
+        }
+
+        if (res.success) {
+            const secs = ((Date.now() - startTime) / 1000).toFixed(1);
+            vscode.window.setStatusBarMessage(`$(check) Flash done (${secs}s)`, 5000);
+        } else {
+            GlobalEvent.emit('msg', newMessage('Error', `Flash failed: ${res.error}`));
+            GlobalEvent.log_show();
+        }
+
+        return { result: undefined };
+    }
+
     /**
      * if called, the command will not be sent to vscode terminal, rather than run it by internal call.
     */
@@ -322,13 +718,39 @@ export abstract class HexUploader<InvokeParamsType> {
         this.notUseTerminal = true;
     }
 
+    /**
+     * Receive the output of the flasher while it is running, only used if the terminal is disabled
+    */
+    setOutputListener(listener: ((text: string) => void) | undefined) {
+        this.outputListener = listener;
+    }
+
+    /**
+     * Whether the flasher can select a probe by the serial number, used by gang programming
+    */
+    isProbeSelectable(): boolean {
+        return true;
+    }
+
+    /**
+     * Use the probe with the serial number instead of the default probe.
+     * The delta flash and the resident probe session are not used for a selected probe.
+    */
+    selectProbe(serial: string) {
+        this.probeSerial = serial;
+    }
+
     /**
      * @returns If disableTerminal called, return @FlashCommandResult otherwise return @void
     */
     async executeShellCommand(title: string, commandLine: string, env?: any, useTerminal?: boolean, cwd?: string): Promise<FlashCommandResult | void> {
+
+        // the probe may be opened by a resident session
+        await ProbeSessionManager.instance().closeAll();
+
         if (this.notUseTerminal) {
             return new Promise<FlashCommandResult | void>((resolve) => {
-                child_process.exec(commandLine, { env, cwd }, (error, stdout, stderr) => {
+                const proc = child_process.exec(commandLine, { env, cwd }, (error, stdout, stderr) => {
                     if (error) {
                         resolve({
                             success: false,
@@ -336,12 +758,18 @@ export abstract class HexUploader<InvokeParamsType> {
                             error
                         });
                     } else {
+                        this.saveFlashState();
                         resolve({
                             success: true,
                             message: stdout.toString() + '\n\n' + stderr.toString(),
                         });
                     }
                 });
+                const listener = this.outputListener;
+                if (listener) {
+                    proc.stdout?.on('data', (data) => listener(data.toString()));
+                    proc.stderr?.on('data', (data) => listener(data.toString()));
+                }
             }).catch((reason) => {
                 return {
                     success: false,
@@ -363,6 +791,16 @@ export abstract class HexUploader<InvokeParamsType> {
                 bar.text = `$(loading~spin) Flashing`;
                 bar.tooltip = `Command: ${commandLine}`;
             }
+            // the result is unknown if the command is sent to a terminal
+            if (etask && this.flashState) {
+                const disposable = vscode.tasks.onDidEndTaskProcess((e) => {
+                    if (e.execution === etask) {
+                        disposable.dispose();
+                        if (e.exitCode === 0)
+                            this.saveFlashState();
+                    }
+                });
+            }
         }
     }
 
@@ -420,7 +858,8 @@ class JLinkUploader extends HexUploader<any> {
         // create output dir
         const outFolder = new File(this.project.ToAbsolutePath(this.project.getOutputDir()));
         outFolder.CreateDir(true);
-        const jlinkCommandsFile = File.fromArray([outFolder.path, 'commands.jlink']);
+        const jlinkCommandsFile = File.fromArray([outFolder.path,
+            this.probeSerial ? `commands_${this.probeSerial}.jlink` : 'commands.jlink']);
 
         const option = this.getUploadOptions<JLinkOptions>();
         const files = this.parseProgramFiles(option);
@@ -446,7 +885,14 @@ class JLinkUploader extends HexUploader<any> {
                 'halt'
             );
 
-            files.forEach((file) => {
+            // flash all files in one session, and only program the changed sectors if possible
+            const programs = this.mergeProgramFiles(files, option.baseAddr);
+            const probeId = this.getProbeIdentity(option.otherCmds, /-SelectEmuBySN\s+(\S+)/i);
+            const delta = await this.prepareDeltaFlash(programs, option.baseAddr,
+                `${option.cpuInfo.cpuName}:${JLinkProtocolType[option.proType]}:${probeId}`,
+                (oldFiles) => this.verifyOnTarget(option, outFolder, oldFiles));
+
+            (delta ? delta.chunks : programs).forEach((file) => {
                 if (/\.bin$/i.test(file.path)) {
                     const addr = file.addr || option.baseAddr
                     flasherCmds.push(`loadfile "${file.path}"${addr ? (`,${addr}`) : ''}`);
@@ -455,6 +901,12 @@ class JLinkUploader extends HexUploader<any> {
                 }
             });
 
+            if (delta && delta.verifyFiles) {
+                delta.verifyFiles.forEach((file) => {
+                    flasherCmds.push(`verifybin "${file.path}",${file.addr}`);
+                });
+            }
+
             flasherCmds.push(
                 'r',
                 'go'
@@ -473,7 +925,7 @@ class JLinkUploader extends HexUploader<any> {
 
         // replace vars
         jlinkCommandtemplate = jlinkCommandtemplate.replace(/\$\{EIDE_JLINK_FLASHER_CMD\}/g, flasherCmds.join(os.EOL));
-        jlinkCommandtemplate = this.resolveHexFilePathEnvs(jlinkCommandtemplate, files);
+        jlinkCommandtemplate = await this.resolveHexFilePathEnvs(jlinkCommandtemplate, files);
         jlinkCommandtemplate = this.project.resolveEnvVar(jlinkCommandtemplate);
         jlinkCommandtemplate = jlinkCommandtemplate + os.EOL + 'exit'; // append 'exit' command
 
@@ -486,24 +938,48 @@ class JLinkUploader extends HexUploader<any> {
             jlinkCommandsFile.Write(jlinkCommandtemplate);
         }
 
-        // -AutoConnect 1 -Device <DevName> -If <Interface> -Speed <value> -CommandFile <file>
+        return {
+            isOk: true,
+            params: this.getConnectArgs(option, jlinkCommandsFile.path)
+        };
+    }
+
+    // -AutoConnect 1 -Device <DevName> -If <Interface> -Speed <value> -CommandFile <file>
+    private getConnectArgs(option: JLinkOptions, commandFile: string): string[] {
+
         const cmdList: string[] = [
             '-ExitOnError', '1',
             '-AutoConnect', '1',
             '-Device', option.cpuInfo.cpuName,
             '-If', JLinkProtocolType[option.proType],
             '-Speed', `${option.speed || 4000}`,
-            '-CommandFile', jlinkCommandsFile.path
+            '-CommandFile', commandFile
         ];
 
         if ([JLinkProtocolType.JTAG, JLinkProtocolType.cJTAG].includes(option.proType)) {
             cmdList.push('-JTAGConf', '-1,-1');
         }
 
-        return {
-            isOk: true,
-            params: cmdList
-        };
+        if (this.probeSerial) {
+            cmdList.push('-SelectEmuBySN', this.probeSerial);
+        }
+
+        return cmdList;
+    }
+
+    /** 'verifybin' the files, JLink exits with an error code if they are not matched */
+    private verifyOnTarget(option: JLinkOptions, outFolder: File, files: FlashProgramFile[]): Promise<boolean> {
+
+        const cmdFile = File.fromArray([outFolder.path, 'verify.jlink']);
+        cmdFile.Write(['r', 'halt']
+            .concat(files.map((file) => `verifybin "${file.path}",${file.addr}`))
+            .concat('r', 'go', 'exit')
+            .join(os.EOL));
+
+        const jlinkExePath = SettingManager.instance().getJlinkExePath();
+        const commandLine = CmdLineHandler.getCommandLine(jlinkExePath, this.getConnectArgs(option, cmdFile.path));
+        return this.runVerifyCommand(`${commandLine} ${option.otherCmds || ''}`.trimEnd())
+            .then((output) => output != undefined && !/verify failed|mismatch/i.test(output));
     }
 
     protected _launch(commandLines: string[]): Promise<FlashCommandResult | void> {
@@ -547,11 +1023,9 @@ class StcgalUploader extends HexUploader<string[]> {
             return { isOk: false };
         }
 
-        const resManager = ResManager.GetInstance();
-
         let portList: string[];
         try {
-            portList = resManager.enumSerialPort();
+            portList = await SerialPortEnumerator.instance().list(true);
         } catch (error) {
             GlobalEvent.emit('error', error);
             return { isOk: false };
@@ -577,8 +1051,13 @@ class StcgalUploader extends HexUploader<string[]> {
             }
         }
 
+        // gang programming: the serial port of each board is used as the 'probe serial'
+        if (this.probeSerial) {
+            option['port'] = this.probeSerial;
+        }
+
         // not found port OR invalid port
-        if (!option['port'] || !portList.includes(option['port'])) {
+        else if (!option['port'] || !portList.includes(option['port'])) {
             if (portList.length > 1) {
                 const port = await vscode.window.showQuickPick(portList, {
                     placeHolder: 'select a serialport to connect',
@@ -696,6 +1175,10 @@ class STLinkUploader extends HexUploader<string[]> {
             '-c', options.proType, `FREQ=${options.speed.toString()}`, 'UR'
         );
 
+        if (this.probeSerial) {
+            commands.push(`SN=${this.probeSerial}`);
+        }
+
         /* reset mode */
         if (options.resetMode && options.resetMode != 'default') {
             const optMap: any = { 'SWrst': 'Srst', 'HWrst': 'Hrst' };
@@ -769,6 +1252,10 @@ class STLinkUploader extends HexUploader<string[]> {
         /* connect cmd */
         commands.push('-c', `port=${options.proType}`, `freq=${options.speed}`);
 
+        if (this.probeSerial) {
+            commands.push(`sn=${this.probeSerial}`);
+        }
+
         /* reset mode */
         if (options.resetMode && options.resetMode != 'default') {
             commands.push(`reset=${options.resetMode}`);
@@ -883,6 +1370,11 @@ class STVPHexUploader extends HexUploader<string[]> {
         super(prj);
     }
 
+    // 'STVP_CmdLine' always uses the first stlink
+    isProbeSelectable(): boolean {
+        return false;
+    }
+
     protected async _prepare(eraseAll?: boolean): Promise<UploaderPreData<string[]>> {
 
         const exe = new File(SettingManager.GetInstance().getStvpExePath());
@@ -1002,13 +1494,31 @@ export interface PyOCDFlashOptions extends UploadOption {
     otherCmds: string;
 }
 
-class PyOCDUploader extends HexUploader<string[]> {
+interface ProbeSessionParams {
+
+    /** arguments to start the server */
+    args: string[];
+
+    /** commands run in the session */
+    commands: string[];
+}
+
+interface PyOCDInvokeParams {
+
+    commandLines: string[];
+
+    session?: ProbeSessionParams;
+}
+
+class PyOCDUploader extends HexUploader<PyOCDInvokeParams> {
 
     toolType: HexUploaderType = 'pyOCD';
 
-    protected async _prepare(eraseAll?: boolean): Promise<UploaderPreData<string[]>> {
+    protected async _prepare(eraseAll?: boolean): Promise<UploaderPreData<PyOCDInvokeParams>> {
 
         const commandLines: string[] = [];
+        const sessionArgs: string[] = [];
+        const sessionCommands: string[] = [];
 
         const option = this.getUploadOptions<PyOCDFlashOptions>();
         const programs = this.parseProgramFiles(option);
@@ -1033,44 +1543,95 @@ class PyOCDUploader extends HexUploader<string[]> {
             if (confFile.IsFile()) {
                 commandLines.push('--config');
                 commandLines.push(confFile.path);
+                sessionArgs.push('--config', confFile.path);
             }
         }
 
         // target name
         commandLines.push('-t');
         commandLines.push(option.targetName);
+        sessionArgs.push('-t', option.targetName);
+
+        // probe unique id
+        if (this.probeSerial) {
+            commandLines.push('-u');
+            commandLines.push(this.probeSerial);
+        }
 
         // speed
         if (option.speed) {
             commandLines.push('-f');
             commandLines.push(option.speed);
+            sessionArgs.push('-f', option.speed);
         }
 
         // file path
         if (!eraseAll) {
-            programs.forEach((file) => {
-                if (/\.bin$/i.test(file.path)) {
-                    const baseAddr = programs[0].addr || option.baseAddr || this.DEF_BIN_ADDR;
-                    commandLines.push(`${file.path}@${baseAddr}`);
-                } else {
-                    commandLines.push(file.path);
-                }
-            });
+
+            // flash all files in one session, and only program the changed sectors if possible,
+            // pyOCD has no verify-only command, the old image is read back by 'savemem',
+            // and a full verify is done by a full flash
+            const baseAddr = option.baseAddr || this.DEF_BIN_ADDR;
+            const files = this.mergeProgramFiles(programs.map(f => { return { path: f.path, addr: f.addr || baseAddr }; }), baseAddr);
+            const probeId = this.getProbeIdentity(option.otherCmds, /(?:-u|--uid|--probe)[\s=]+(\S+)/);
+            const delta = await this.prepareDeltaFlash(files, baseAddr,
+                `${option.targetName}:${option.config || ''}:${option.otherCmds || ''}:${probeId}`,
+                (oldFiles) => this.verifyByReadBack(oldFiles, (reads) => {
+                    const args = ['commander'].concat(sessionArgs);
+                    reads.forEach((r) => args.push('-c', `savemem ${r.addr} ${r.size} ${File.ToUnixPath(r.path)}`));
+                    return 'pyocd ' + args.map((arg) => CmdLineHandler.quoteString(arg, '"')).join(' ') +
+                        (option.otherCmds ? ` ${option.otherCmds}` : '');
+                }), true);
+
+            if (delta) {
+                delta.chunks.forEach((file) => {
+                    commandLines.push(`${file.path}@${file.addr}`);
+                    sessionCommands.push(`load "${File.ToUnixPath(file.path)}" ${file.addr}`);
+                });
+            } else {
+                files.forEach((file) => {
+                    if (/\.bin$/i.test(file.path)) {
+                        const addrStr = file.addr || baseAddr;
+                        commandLines.push(`${file.path}@${addrStr}`);
+                        sessionCommands.push(`load "${File.ToUnixPath(file.path)}" ${addrStr}`);
+                    } else {
+                        commandLines.push(file.path);
+                        sessionCommands.push(`load "${File.ToUnixPath(file.path)}"`);
+                    }
+                });
+            }
+
+            sessionCommands.push('reset');
         }
 
         return {
             isOk: true,
-            params: commandLines
+            params: {
+                commandLines: commandLines,
+                // erase is not done in the session
+                session: eraseAll ? undefined : { args: sessionArgs, commands: sessionCommands }
+            }
         };
     }
 
-    protected _launch(commands: string[]): Promise<FlashCommandResult | void> {
+    protected async _launch(params: PyOCDInvokeParams): Promise<FlashCommandResult | void> {
+
+        const options = this.getUploadOptions<STLinkOptions>();
+
+        // use the resident 'pyocd commander' session
+        if (params.session && this.isProbeSessionEnabled()) {
+            const args = params.session.args.concat(
+                options.otherCmds ? options.otherCmds.trim().split(/\s+/) : []);
+            const r = await this.runInProbeSession(args.join(' '),
+                () => new PyOCDCommanderSession('pyocd', args, { cwd: this.project.getRootDir().path }),
+                params.session.commands);
+            if (r) return r.result;
+        }
 
         let commandLine: string = 'pyocd ' +
-            commands.map((line) => CmdLineHandler.quoteString(line, '"')).join(' ');
+            params.commandLines.map((line) => CmdLineHandler.quoteString(line, '"')).join(' ');
 
         // add user cmds
-        const options = this.getUploadOptions<STLinkOptions>();
         if (options.otherCmds) {
             commandLine = commandLine.replace(/^pyocd\s+(\w+)/, `pyocd $1 ` + options.otherCmds);
         }
@@ -1092,11 +1653,20 @@ export interface OpenOCDFlashOptions extends UploadOption {
     baseAddr?: string;
 }
 
-class OpenOCDUploader extends HexUploader<string[]> {
+interface OpenOCDInvokeParams {
+
+    /** '-s' and '-f' arguments */
+    configArgs: string[];
+
+    /** tcl commands */
+    commands: string[];
+}
+
+class OpenOCDUploader extends HexUploader<OpenOCDInvokeParams> {
 
     toolType: HexUploaderType = 'OpenOCD';
 
-    protected async _prepare(eraseAll?: boolean): Promise<UploaderPreData<string[]>> {
+    protected async _prepare(eraseAll?: boolean): Promise<UploaderPreData<OpenOCDInvokeParams>> {
 
         if (eraseAll) {
             GlobalEvent.emit('msg', newMessage('Warning', `not support 'Erase Chip' for '${this.toolType}' flasher`));
@@ -1116,13 +1686,12 @@ class OpenOCDUploader extends HexUploader<string[]> {
             throw new Error(`no any program files !`);
         }
 
+        const configArgs: string[] = [];
         const commands: string[] = [];
 
         const wsFolder = WorkspaceManager.getInstance().getWorkspaceRoot();
         if (wsFolder) {
-            commands.push(
-                `-s "${wsFolder.path}"`
-            );
+            configArgs.push('-s', wsFolder.path);
         }
 
         const addConfig = (typ: 'interface' | 'target', fname: string) => {
@@ -1130,36 +1699,97 @@ class OpenOCDUploader extends HexUploader<string[]> {
                 let fpath: string = fname.startsWith('${workspaceFolder}/')
                     ? fname.replace('${workspaceFolder}/', '')
                     : `${typ}/${fname}`;
-                let cfg = `-f ${fpath}.cfg`;
-                if (!commands.includes(cfg))
-                    commands.push(cfg);
+                let cfg = `${fpath}.cfg`;
+                if (!configArgs.includes(cfg))
+                    configArgs.push('-f', cfg);
             }
         };
 
         addConfig('interface', option.interface);
         addConfig('target', option.target);
 
-        programs.forEach(file => {
-            if (/\.bin$/i.test(file.path)) {
-                const addrStr = file.addr || option.baseAddr || this.DEF_BIN_ADDR;
-                commands.push(`-c "program \\"${File.ToUnixPath(file.path)}\\" ${addrStr} verify"`);
-            } else {
-                commands.push(`-c "program \\"${File.ToUnixPath(file.path)}\\" verify"`);
-            }
-        });
+        // flash all files in one session, and only program the changed sectors if possible
+        const files = this.mergeProgramFiles(programs, option.baseAddr);
+        const probeId = this.getProbeIdentity(this.readOpenOCDConfig(wsFolder, option.interface),
+            /^\s*(?:adapter\s+serial|hla_serial|jlink\s+serial|cmsis_dap_serial)\s+"?([^"\s]+)/m);
+        const delta = await this.prepareDeltaFlash(files, option.baseAddr,
+            `${option.interface}:${option.target}:${probeId}`, 'in-script');
+
+        if (delta && delta.oldFiles && delta.imageFiles) {
+            const toCommands = (cmd: string, list: FlashProgramFile[]) => {
+                return list.map(file => `${cmd} "${File.ToUnixPath(file.path)}" ${file.addr} bin`).join('; ');
+            };
+            // 'write_image erase' only erases the sectors which are written,
+            // write the whole image if the last flashed image is not on the target
+            commands.push(`init`, `reset init`);
+            commands.push(`if {[catch {${toCommands('verify_image', delta.oldFiles)}}]} ` +
+                `{ echo "delta flash: the last flashed image is not on the target, use full flash."; ` +
+                `${toCommands('flash write_image erase', delta.imageFiles)}; ${toCommands('verify_image', delta.imageFiles)} } ` +
+                `else { ${toCommands('flash write_image erase', delta.chunks)}` +
+                (delta.verifyFiles ? `; ${toCommands('verify_image', delta.verifyFiles)}` : '') + ` }`);
+        } else {
+            files.forEach(file => {
+                if (/\.bin$/i.test(file.path)) {
+                    const addrStr = file.addr || option.baseAddr || this.DEF_BIN_ADDR;
+                    commands.push(`program "${File.ToUnixPath(file.path)}" ${addrStr} verify`);
+                } else {
+                    commands.push(`program "${File.ToUnixPath(file.path)}" verify`);
+                }
+            });
+        }
+
+        commands.push(`reset run`);
 
-        commands.push(`-c "reset run"`);
-        commands.push(`-c "exit"`);
+        if (this.probeSerial) {
+            configArgs.push('-c', `adapter serial ${this.probeSerial}`);
+        }
 
         return {
             isOk: true,
-            params: commands
+            params: {
+                configArgs: configArgs,
+                commands: commands
+            }
         };
     }
 
-    protected _launch(commands: string[]): Promise<FlashCommandResult | void> {
+    /**
+     * Read the interface config in the workspace, the probe serial may be set in it
+    */
+    private readOpenOCDConfig(wsFolder: File | undefined, fname: string): string | undefined {
+        if (wsFolder && fname.startsWith('${workspaceFolder}/')) {
+            try {
+                return fs.readFileSync(NodePath.join(wsFolder.path, `${fname.replace('${workspaceFolder}/', '')}.cfg`), 'utf8');
+            } catch (error) {
+                // the config file is checked by openocd
+            }
+        }
+        return undefined;
+    }
+
+    protected async _launch(params: OpenOCDInvokeParams): Promise<FlashCommandResult | void> {
+
         const exePath = SettingManager.instance().getOpenOCDExePath();
-        const commandLine = `${CmdLineHandler.quoteString(exePath, '"')} ${commands.join(' ')}`;
+
+        // use the resident openocd server, the commands are sent by the tcl rpc port
+        if (this.isProbeSessionEnabled()) {
+            const r = await this.runInProbeSession(params.configArgs.join(' '),
+                () => new OpenOCDSession(exePath, params.configArgs),
+                params.commands);
+            if (r) return r.result;
+        }
+
+        const args: string[] = [];
+        for (let i = 0; i < params.configArgs.length; i += 2) {
+            const val = params.configArgs[i + 1];
+            args.push(params.configArgs[i] == '-f' ? `-f ${val}` : `${params.configArgs[i]} "${val}"`);
+        }
+
+        params.commands
+            .concat('exit')
+            .forEach(cmd => args.push(`-c "${cmd.replace(/"/g, '\\"')}"`));
+
+        const commandLine = `${CmdLineHandler.quoteString(exePath, '"')} ${args.join(' ')}`;
         return this.executeShellCommand(this.toolType, commandLine);
     }
 }
@@ -1202,7 +1832,7 @@ export interface ProbeRSFlashOptions extends UploadOption {
     otherOptions: string;
 }
 
-class ProbeRSUploader extends HexUploader<string[]> {
+class ProbeRSUploader extends HexUploader<string[][]> {
 
     toolType: HexUploaderType = 'probe-rs';
 
@@ -1240,7 +1870,7 @@ class ProbeRSUploader extends HexUploader<string[]> {
         return result;
     }
 
-    protected async _prepare(eraseAll?: boolean): Promise<UploaderPreData<string[]>> {
+    protected async _prepare(eraseAll?: boolean): Promise<UploaderPreData<string[][]>> {
 
         try {
             // PS C:\Users\Administrator> cargo-flash --version
@@ -1273,6 +1903,11 @@ class ProbeRSUploader extends HexUploader<string[]> {
             `--protocol ${option.protocol}`
         ];
 
+        // probe selector: '<VID>:<PID>[:<Serial>]'
+        if (this.probeSerial) {
+            commands.push(`--probe ${this.probeSerial}`);
+        }
+
         const wsFolder = WorkspaceManager.getInstance().getWorkspaceRoot();
         if (wsFolder) {
             commands.push(
@@ -1280,33 +1915,93 @@ class ProbeRSUploader extends HexUploader<string[]> {
             );
         }
 
-        // just support one file
-        commands.push(`--path "${programs[0].path}"`);
-        // if (programs[0].path.endsWith('.bin')) {
-        //     if (programs[0].addr || option.baseAddr) {
-        //         const baseAddr = programs[0].addr || option.baseAddr;
-        //         commands.push(`--base-address ${baseAddr}`);
-        //     }
-        // }
-        commands.push(`--verify`);
+        const userOptions: string[] = [];
 
         if (option.speed)
-            commands.push(`--speed ${option.speed}`);
+            userOptions.push(`--speed ${option.speed}`);
         // if (option.allowEraseAll)
         //     commands.push(`--allow-erase-all`);
 
         // place otherOptions at the last, maybe user want to override some options.
         if (option.otherOptions)
-            commands.push(option.otherOptions);
+            userOptions.push(option.otherOptions);
+
+        // multiple files are merged into one hex file, so that they are flashed in one session
+        const files = this.mergeProgramFiles(programs.map(f => {
+            return { path: this.project.toAbsolutePath(f.path), addr: f.addr };
+        }), option.baseAddr);
+
+        // only program the changed sectors if possible, one 'cargo-flash' call for each chunk,
+        // cargo-flash has no verify-only command, the old image is read back by 'probe-rs read',
+        // and a full verify is done by a full flash
+        const probeId = this.getProbeIdentity(option.otherOptions, /--probe[\s=]+(\S+)/);
+        const delta = await this.prepareDeltaFlash(files, option.baseAddr,
+            `${option.target}:${option.protocol}:${option.otherOptions || ''}:${probeId}`,
+            (oldFiles) => this.verifyOnTarget(option, probeId, oldFiles), true);
+
+        if (delta) {
+            return {
+                isOk: true,
+                params: delta.chunks.map((file) => {
+                    return commands.concat(
+                        `--path "${file.path}"`,
+                        `--binary-format bin`,
+                        `--base-address ${file.addr}`,
+                        `--verify`,
+                        ...userOptions);
+                })
+            };
+        }
+
+        if (programs.length > 1) {
+            commands.push(`--path "${files[0].path}"`, `--binary-format hex`);
+        } else {
+            commands.push(`--path "${programs[0].path}"`);
+        }
+        // if (programs[0].path.endsWith('.bin')) {
+        //     if (programs[0].addr || option.baseAddr) {
+        //         const baseAddr = programs[0].addr || option.baseAddr;
+        //         commands.push(`--base-address ${baseAddr}`);
+        //     }
+        // }
+        commands.push(`--verify`);
 
         return {
             isOk: true,
-            params: commands
+            params: [commands.concat(userOptions)]
         };
     }
 
-    protected _launch(commands: string[]): Promise<FlashCommandResult | void> {
-        const commandLine = `cargo-flash ${commands.join(' ')}`;
+    /**
+     * Read the segments of the last flashed image by 'probe-rs read' and compare them
+    */
+    private async verifyOnTarget(option: ProbeRSFlashOptions, probeId: string, oldFiles: FlashProgramFile[]): Promise<boolean> {
+
+        for (const file of oldFiles) {
+
+            const data = fs.readFileSync(file.path);
+            const args = [`read`, `--chip ${option.target}`, `--protocol ${option.protocol}`];
+            if (probeId) args.push(`--probe ${probeId}`);
+            if (option.speed) args.push(`--speed ${option.speed}`);
+            args.push(`b8`, file.addr || '0x0', data.length.toString());
+
+            const output = await this.runVerifyCommand(`probe-rs ${args.join(' ')}`, this._getEnv());
+            if (output == undefined)
+                return false;
+
+            // the bytes are printed as hex words
+            const bytes = output.split(/\s+/).filter((word) => /^[0-9a-f]{2}$/i.test(word));
+            if (bytes.length != data.length || bytes.some((b, i) => parseInt(b, 16) != data[i]))
+                return false;
+        }
+
+        return true;
+    }
+
+    protected _launch(commandsList: string[][]): Promise<FlashCommandResult | void> {
+        const commandLine = commandsList
+            .map((commands) => `cargo-flash ${commands.join(' ')}`)
+            .join(' && ');
         return this.executeShellCommand(this.toolType, commandLine, this._getEnv());
     }
 }
@@ -1323,6 +2018,13 @@ class CustomUploader extends HexUploader<string> {
 
     toolType: HexUploaderType = 'Custom';
 
+    // the command must select the probe by '${probeSerial}' or the env 'EIDE_PROBE_SERIAL',
+    // otherwise all boards of a gang are flashed by the same (default) probe
+    isProbeSelectable(): boolean {
+        const option = this.getUploadOptions<CustomFlashOptions>();
+        return /\$\{probeSerial\}|EIDE_PROBE_SERIAL/i.test(option.commandLine || '');
+    }
+
     protected async _prepare(eraseAll?: boolean): Promise<UploaderPreData<string>> {
 
         const option = this.getUploadOptions<CustomFlashOptions>();
@@ -1351,7 +2053,7 @@ class CustomUploader extends HexUploader<string> {
             }
         }
 
-        let commandLine = this.resolveHexFilePathEnvs(option.commandLine, programs);
+        let commandLine = await this.resolveHexFilePathEnvs(option.commandLine, programs);
 
         // replace env
         commandLine = this.project.replacePathEnv(commandLine);
@@ -1366,6 +2068,11 @@ class CustomUploader extends HexUploader<string> {
 
         let env = process.env;
 
+        // the probe serial for gang programming, it can also be used by '${probeSerial}'
+        if (this.probeSerial) {
+            env = Object.assign({}, env, { EIDE_PROBE_SERIAL: this.probeSerial });
+        }
+
         // set env
         const prjEnv = this.project.getProjectVariables();
         if (prjEnv) {
@@ -4,8 +4,15 @@ import { AbstractProject } from "./EIDEProject";
 import { CallgraphVcg, parseCallgraphVcgFile } from './GccCallgraphParser';
 import { parseStackUsageFile, StackUsageDocument } from './GccStackUsageParser';
 import { GlobalEvent } from './GlobalEvents';
-import { checkGccFFlag, reverseStringMap } from './utility';
+import { checkGccFFlag, getCxxDemangler, reverseStringMap } from './utility';
+import { isMangledName } from './CxxDemangler';
+import { isElfFile } from './ElfReader';
+import { getMapFileTypeByToolchain, parseMapLines, readLines } from './MapFileParser';
+import { SizeHistory, makeSizeSnapshot, checkSizeBudgets } from './SizeHistory';
+import { SettingManager } from './SettingManager';
+import { Tracer } from './Tracer';
 import * as NodePath from 'node:path';
+import * as fs from 'fs';
 
 interface BuildFlags {
     fcallgraphInfo: boolean;
@@ -29,6 +36,7 @@ function checkflags(cli: string): BuildFlags {
 }
 
 export function onProjectBuildFinished(prj: AbstractProject, succeed: boolean) {
+    const span = Tracer.span('hooks.onProjectBuildFinished', 'build', () => ({ succeed }));
     try {
         if (succeed) {
             const buildOutDir = prj.getOutputFolder();
@@ -92,6 +100,28 @@ export function onProjectBuildFinished(prj: AbstractProject, succeed: boolean) {
                 let r = parseStackUsageFile(path);
                 stackusage.push(r);
             });
+            // demangle c++ node labels and stack usage names, all names are handled by one c++filt process
+            const cxxfilt = prj.getCxxFiltPath();
+            if (cxxfilt && File.IsFile(cxxfilt)) {
+                const names: string[] = [];
+                callgraph.forEach(g => g.nodes.forEach(n => {
+                    if (isMangledName(n.label)) names.push(n.label);
+                }));
+                stackusage.forEach(doc => doc.entries.forEach(e => {
+                    if (isMangledName(e.functionName)) names.push(e.functionName);
+                }));
+                if (names.length > 0) {
+                    const demangler = getCxxDemangler();
+                    const nameMap = demangler.demangleSync(names, cxxfilt);
+                    callgraph.forEach(g => g.nodes.forEach(n => {
+                        n.label = nameMap.get(n.label) || n.label;
+                    }));
+                    stackusage.forEach(doc => doc.entries.forEach(e => {
+                        e.functionName = nameMap.get(e.functionName) || e.functionName;
+                    }));
+                    demangler.flush();
+                }
+            }
             // dump
             File.from(buildOutDir.path, 'statistic.json')
                 .Write(JSON.stringify({
@@ -103,4 +133,74 @@ export function onProjectBuildFinished(prj: AbstractProject, succeed: boolean) {
         GlobalEvent.log_error(error);
         GlobalEvent.log_show();
     }
+    span.end();
+}
+
+/**
+ * Record the code size of the output elf into the size history of the current target,
+ * then check the size budgets.
+ *
+ * @returns false if any size budget is exceeded
+*/
+export async function recordBuildSize(prj: AbstractProject): Promise<boolean> {
+
+    const settings = SettingManager.GetInstance();
+    if (!settings.isSizeHistoryEnabled())
+        return true;
+
+    const span = Tracer.asyncSpan('hooks.recordBuildSize', 'build');
+
+    try {
+
+        const elfPath = prj.getExecutablePath();
+        if (!File.IsFile(elfPath) || !isElfFile(elfPath))
+            return true;
+
+        const buildOutDir = prj.getOutputFolder();
+
+        // rom/ram size of the mcu, they are resolved by the builder
+        let limits: { rom?: number, ram?: number } = {};
+        const paramsFile = File.from(buildOutDir.path, 'builder.params');
+        if (paramsFile.IsFile()) {
+            const params = JSON.parse(paramsFile.Read());
+            limits = { rom: params['rom'], ram: params['ram'] };
+        }
+
+        // object sizes from map file
+        let objects: { [name: string]: number } | undefined;
+        const mapType = getMapFileTypeByToolchain(prj.getToolchain().name);
+        const mapPath = prj.getExecutablePathWithoutSuffix() + '.map';
+        if (mapType && File.IsFile(mapPath)) {
+            objects = {};
+            const r = parseMapLines(readLines(mapPath), mapType);
+            for (const [name, sizes] of r.modules) {
+                const size = ['.text', '.data', '.bss', '.rodata']
+                    .reduce((sum, sec) => sum + (sizes[sec] || 0), 0);
+                if (size > 0)
+                    objects[name] = size;
+            }
+        }
+
+        // the symbol sizes are read from the elf, the slow symbol table parser (demangling) is not needed
+        const snapshot = makeSizeSnapshot(elfPath, prj.getCurrentTarget(), undefined, objects, limits);
+
+        const history = SizeHistory.load(buildOutDir.path);
+        history.add(snapshot);
+        history.save();
+
+        const violations = checkSizeBudgets(snapshot, settings.getSizeBudgets());
+        if (violations.length > 0) {
+            const lines = violations.map(v => `'${v.name}': ${v.size} bytes, budget: ${v.budget} bytes (+${v.size - v.budget})`);
+            GlobalEvent.log_error(`Size budget exceeded:\n  ${lines.join('\n  ')}`);
+            GlobalEvent.show_msgbox('Error', `Build failed, size budget exceeded: ${violations.map(v => v.name).join(', ')}`);
+            return false;
+        }
+
+    } catch (error) {
+        GlobalEvent.log_warn(error);
+    } finally {
+        span.end();
+    }
+
+    return true;
 }
@@ -1,7 +1,6 @@
-import * as fs from 'fs';
 import * as NodePath from 'path';
 import * as os from 'os';
-import * as xml2js from 'xml2js';
+import { parseXmlFile } from './XmlStreamParser';
 import * as ini from 'ini';
 import { VirtualFolder } from './EIDETypeDefine';
 import { VirtualSource, AbstractProject } from './EIDEProject';
@@ -96,7 +95,7 @@ export async function parseIarWorkbench(ewwFile: File, iarToolchainRoot: File):
     //
     const cusEnvFile = File.fromArray([ewwFile.dir, ewwFile.noSuffixName + '.custom_argvars']);
     if (cusEnvFile.IsFile()) {
-        const envDom = (await xml2js.parseStringPromise(fs.readFileSync(cusEnvFile.path).toString()))['iarUserArgVars'];
+        const envDom = (await parseXmlFile(cusEnvFile.path))['iarUserArgVars'];
         toArray(envDom['group']).forEach(groupNode => {
             if (groupNode.$['active'] == 'true') {
                 toArray(groupNode['variable']).forEach(var_ => {
@@ -114,8 +113,7 @@ export async function parseIarWorkbench(ewwFile: File, iarToolchainRoot: File):
     // parse workspace
     //
 
-    const ewwDom = (await xml2js.parseStringPromise(
-        fs.readFileSync(ewwFile.path).toString()))['workspace'];
+    const ewwDom = (await parseXmlFile(ewwFile.path))['workspace'];
 
     const ewpFiles: string[] = toArray(ewwDom.project)
         .map(n => resolveEnv(n.path[0] || ''))
@@ -127,8 +125,7 @@ export async function parseIarWorkbench(ewwFile: File, iarToolchainRoot: File):
 
     for (const prjpath of ewpFiles) {
 
-        const prjdom = (await xml2js.parseStringPromise(
-            fs.readFileSync(prjpath).toString()))['project'];
+        const prjdom = (await parseXmlFile(prjpath))['project'];
 
         const project: IarProjectInfo = {
             name: new File(prjpath).noSuffixName,
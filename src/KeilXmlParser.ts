@@ -35,6 +35,7 @@ import { DependenceManager } from './DependenceManager';
 import { ArrayDelRepetition } from '../lib/node-utility/Utility';
 import { CurrentDevice, C51BaseCompileData, ArmBaseCompileData, ARMStorageLayout, ArmBaseCompileConfigModel } from './EIDEProjectModules';
 import * as utility from './utility';
+import { parseXmlFile } from './XmlStreamParser';
 
 export interface KeilRteDependence {
     name: string;
@@ -87,23 +88,28 @@ export abstract class KeilParser<T> {
     private _folder: File;
     protected doc: any;
 
-    constructor(_file: File) {
+    private static readonly ARRAY_ACCESS_PATHS = [
+        'Project.Targets.Target',
+        'Project.Targets.Target.Groups.Group',
+        'Project.Targets.Target.Groups.Group.Files',
+        'Project.Targets.Target.Groups.Group.Files.File',
+        'Project.RTE.files',
+        'Project.RTE.files.file',
+        'Project.RTE.files.file.instance'
+    ];
+
+    /**
+     * @param doc the parsed document, the file is read if it's not given
+    */
+    constructor(_file: File, doc?: any) {
         this._file = _file;
         this._folder = new File(_file.dir);
         this.parser = new xml2js({
             attributePrefix: '$',
             enableToStringFunc: true,
-            arrayAccessFormPaths: [
-                'Project.Targets.Target',
-                'Project.Targets.Target.Groups.Group',
-                'Project.Targets.Target.Groups.Group.Files',
-                'Project.Targets.Target.Groups.Group.Files.File',
-                'Project.RTE.files',
-                'Project.RTE.files.file',
-                'Project.RTE.files.file.instance'
-            ]
+            arrayAccessFormPaths: KeilParser.ARRAY_ACCESS_PATHS
         });
-        this.doc = this.parser.xml2js<any>(this._file.Read());
+        this.doc = doc || this.parser.xml2js<any>(this._file.Read());
     }
 
     protected getNodeText(node: any): string {
@@ -284,17 +290,39 @@ export abstract class KeilParser<T> {
         }
     }
 
-    static NewInstance(file: File, product_type: string): KeilParser<any> {
+    static NewInstance(file: File, product_type: string, doc?: any): KeilParser<any> {
         switch (product_type) {
             case 'c51':
-                return new C51Parser(file);
+                return new C51Parser(file, doc);
             case 'arm':
-                return new ARMParser(file);
+                return new ARMParser(file, doc);
             default:
                 throw new Error(`not support this project type: '${product_type}'`);
         }
     }
 
+    /**
+     * Read the project file by a stream, it's used by the importer
+     * @param product_type 'c51' or 'arm', it's detected by the toolset of the first target if it's not given
+    */
+    static async Load(file: File, product_type?: string): Promise<KeilParser<any>> {
+
+        const doc = await parseXmlFile(file.path, {
+            format: 'x2js',
+            attributePrefix: '$',
+            enableToStringFunc: true,
+            arrayPaths: KeilParser.ARRAY_ACCESS_PATHS
+        });
+
+        if (product_type == undefined) {
+            const targets: any[] = doc.Project?.Targets?.Target || [];
+            const toolset = targets.length > 0 ? String(targets[0].ToolsetName || '') : '';
+            product_type = /51/.test(toolset) ? 'c51' : 'arm';
+        }
+
+        return KeilParser.NewInstance(file, product_type, doc);
+    }
+
     Save(outDir: File, name: string): File {
         const prjMap: any = KeilParser.TYPE_SUFFIX_MAP;
         if (prjMap[this.TYPE_TAG] == undefined) { throw new Error(`Not support '${this.TYPE_TAG}' project !`); }
@@ -319,8 +347,8 @@ class C51Parser extends KeilParser<KeilC51Option> {
 
     TYPE_TAG: ProjectType = 'C51';
 
-    constructor(f: File) {
-        super(f);
+    constructor(f: File, doc?: any) {
+        super(f, doc);
     }
 
     private getOption(targetOptionObj: any, option: KeilC51Option) {
@@ -691,8 +719,8 @@ class ARMParser extends KeilParser<KeilARMOption> {
 
     TYPE_TAG: ProjectType = 'ARM';
 
-    constructor(f: File) {
-        super(f);
+    constructor(f: File, doc?: any) {
+        super(f, doc);
     }
 
     private getOption(targetOptionObj: any, option: KeilARMOption, env: { [n: string]: string }) {
@@ -0,0 +1,132 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+import * as NodePath from 'path';
+import * as crypto from 'crypto';
+
+/** defined by the generated header, the static headers skip their macro snapshots if it's defined */
+export const PROBED_MACROS_FLAG = '__EIDE_PROBED_MACROS';
+
+/** headers which are not used for this time are deleted */
+const HEADER_EXPIRED_TIME = 30 * 24 * 3600 * 1000;
+
+export interface MacroDefine {
+    type: 'var' | 'func';
+
+    /** macro name, it includes the parameters for 'func' macros, like: `FOO(a, b)` */
+    name: string;
+
+    value: string;
+}
+
+export interface MacroHeaderSource {
+
+    toolchain: string;
+
+    /** macros of the compiler for the current target */
+    macros: MacroDefine[];
+
+    /** the builtin headers of the toolchain, they're included after the macros */
+    baseHeaders: string[];
+}
+
+/**
+ * Make the content of a forced include header for IntelliSense
+*/
+export function renderMacroHeader(src: MacroHeaderSource): string {
+
+    const lines: string[] = [
+        `/***`,
+        ` * !!! Don't include this file in your project !, it can only be used for code analysis !!!`,
+        ` * Generated from the compiler macros of the toolchain '${src.toolchain}'`,
+        `*/`,
+        ``,
+        `#ifndef __VSCODE_CPPTOOL`,
+        `#error "Don't include this file in your project !, it can only be used for code analysis !"`,
+        `#endif // !`,
+        ``,
+        `#define ${PROBED_MACROS_FLAG} 1`,
+        ``,
+        `// compiler macros`,
+    ];
+
+    const names = new Set<string>();
+    for (const m of src.macros) {
+        const id = m.name.replace(/\(.*$/, '');
+        if (names.has(id) || id == '__VSCODE_CPPTOOL')
+            continue;
+        names.add(id);
+        lines.push(m.value != '' ? `#define ${m.name} ${m.value}` : `#define ${m.name}`);
+    }
+
+    if (src.baseHeaders.length > 0) {
+        lines.push(``, `// builtin keywords and intrinsics`);
+        for (const h of src.baseHeaders)
+            lines.push(`#include "${h.replace(/\\/g, '/')}"`);
+    }
+
+    lines.push(``);
+    return lines.join('\n');
+}
+
+/**
+ * Write the header to the folder, the file name is the hash of the content,
+ * so it's written only if the compiler or the target options are changed
+ * @returns the path of the header
+*/
+export function writeMacroHeader(outDir: string, src: MacroHeaderSource): string {
+
+    const content = renderMacroHeader(src);
+    const hash = crypto.createHash('sha1').update(content).digest('hex').substr(0, 16);
+    const name = `${src.toolchain.toLowerCase().replace(/[^\w-]/g, '_')}_${hash}.h`;
+    const path = NodePath.join(outDir, name);
+
+    if (fs.existsSync(path)) {
+        const now = new Date();
+        fs.utimesSync(path, now, now); // it's still used
+        return path;
+    }
+
+    fs.mkdirSync(outDir, { recursive: true });
+    removeExpiredHeaders(outDir);
+
+    const tmpPath = `${path}.${process.pid}.tmp`;
+    fs.writeFileSync(tmpPath, content);
+    fs.renameSync(tmpPath, path);
+
+    return path;
+}
+
+function removeExpiredHeaders(outDir: string) {
+    for (const name of fs.readdirSync(outDir)) {
+        const path = NodePath.join(outDir, name);
+        try {
+            if (Date.now() - fs.statSync(path).mtimeMs > HEADER_EXPIRED_TIME)
+                fs.unlinkSync(path);
+        } catch (error) {
+            // ignore
+        }
+    }
+}
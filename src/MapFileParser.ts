@@ -0,0 +1,719 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Linker map file analyzer, a TypeScript port of res/data/patches/memap.py
+ * (mbed-os memap, Apache-2.0), supports GCC/LLD, armlink and IAR map files.
+ *
+ * The map file is read line by line with fixed size chunks, the module/section
+ * accumulation and the report are the same as memap.py.
+*/
+
+import * as fs from 'fs';
+import * as NodePath from 'path';
+import { StringDecoder } from 'string_decoder';
+
+export type MapFileType = 'GCC_ARM' | 'ARM_MICRO' | 'IAR';
+
+/** section name -> size */
+export type MapSectionSizes = { [section: string]: number };
+
+/** object/module path -> section sizes */
+export type MapModules = Map<string, MapSectionSizes>;
+
+export interface MapFileParseOptions {
+    /** toolchain root dir, used to shorten the paths of toolchain builtin libs */
+    toolchainRoot?: string;
+}
+
+export interface MapModuleReportItem {
+    module: string;
+    /** '.text', '.data', '.bss', '.rodata' and their '-delta' */
+    size: MapSectionSizes;
+}
+
+export interface MapMemorySummary {
+    static_ram: number;
+    static_ram_delta: number;
+    total_flash: number;
+    total_flash_delta: number;
+}
+
+export interface MapMemoryReport {
+    modules: MapModuleReportItem[];
+    subtotal: MapSectionSizes;
+    summary: MapMemorySummary;
+    warnings: string[];
+}
+
+const SECTIONS = ['.text', '.data', '.bss', '.heap', '.stack', '.rodata'];
+const MISC_FLASH_SECTIONS = ['.interrupts', '.flash_config'];
+const OTHER_SECTIONS = ['.interrupts_ram', '.init', '.ARM.extab',
+    '.ARM.exidx', '.ARM.attributes', '.eh_frame',
+    '.init_array', '.fini_array', '.jcr', '.stab',
+    '.stabstr', '.ARM.exidx', '.ARM'];
+
+const PRINT_SECTIONS = ['.text', '.data', '.bss', '.rodata'];
+
+const OBJECT_EXTENSIONS = ['.o', '.obj'];
+
+const READ_CHUNK_SIZE = 256 * 1024;
+
+// ---------------------------------------------------------------------------
+// Line reader
+// ---------------------------------------------------------------------------
+
+/**
+ * Read a text file line by line with a bounded buffer, line endings are removed.
+*/
+export function* readLines(path: string): Generator<string> {
+
+    const fd = fs.openSync(path, 'r');
+
+    try {
+
+        const buf = Buffer.alloc(READ_CHUNK_SIZE);
+        // utf8 (non-ascii paths), a char which is split by the chunk is kept by the decoder
+        const decoder = new StringDecoder('utf8');
+        let rest = '';
+        let n: number;
+
+        while ((n = fs.readSync(fd, buf, 0, buf.length, null)) > 0) {
+            const text = rest + decoder.write(buf.subarray(0, n));
+            let start = 0;
+            let idx: number;
+            while ((idx = text.indexOf('\n', start)) != -1) {
+                let end = idx;
+                if (end > start && text.charCodeAt(end - 1) == 13 /* \r */)
+                    end--;
+                yield text.substring(start, end);
+                start = idx + 1;
+            }
+            rest = text.substring(start);
+        }
+
+        rest += decoder.end();
+
+        if (rest.length > 0)
+            yield rest.endsWith('\r') ? rest.substring(0, rest.length - 1) : rest;
+
+    } finally {
+        fs.closeSync(fd);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Path helpers (same behavior as python os.path)
+// ---------------------------------------------------------------------------
+
+function endsWithObjExt(name: string): boolean {
+    return OBJECT_EXTENSIONS.some(ext => name.endsWith(ext));
+}
+
+function commonPrefix(list: string[]): string {
+    if (list.length == 0)
+        return '';
+    let min = list[0], max = list[0];
+    for (const s of list) {
+        if (s < min) min = s;
+        if (s > max) max = s;
+    }
+    let i = 0;
+    while (i < min.length && min[i] == max[i])
+        i++;
+    return min.substring(0, i);
+}
+
+function pyDirname(p: string): string {
+    const idx = p.lastIndexOf(NodePath.sep);
+    if (idx == -1)
+        return '';
+    const head = p.substring(0, idx + 1);
+    // strip trailing slashes, unless it's the root
+    const stripped = head.replace(new RegExp(`\\${NodePath.sep}+$`), '');
+    return stripped.length > 0 ? stripped : head;
+}
+
+function pyJoin(...parts: string[]): string {
+    return parts.join(NodePath.sep);
+}
+
+function pyNormpath(p: string): string {
+    let r = NodePath.normalize(p);
+    if (r.length > 1 && r.endsWith(NodePath.sep))
+        r = r.substring(0, r.length - 1);
+    return r;
+}
+
+function toRelativePath(path: string, root: string, toolchainRoot?: string): string {
+    try {
+        // remove prefix: ./xxx/xxx/.obj or xxx/xxx/.obj
+        const parts = path.split(/\/|\\/);
+        if (parts.length > 4 && parts[0] == '.' && parts[3] == '.obj')
+            return pyNormpath(parts.slice(4).join('/'));
+        if (parts.length > 3 && parts[2] == '.obj')
+            return pyNormpath(parts.slice(3).join('/'));
+        // remove toolchain dir prefix
+        if (root.trim() == '') {
+            if (toolchainRoot && path.includes(NodePath.basename(toolchainRoot))) {
+                let result = pyNormpath(NodePath.relative(toolchainRoot, path));
+                if (!NodePath.isAbsolute(result))
+                    result = pyJoin('[lib]', 'misc', result);
+                return result;
+            } else {
+                return pyNormpath(path);
+            }
+        } else {
+            return pyNormpath(NodePath.relative(root, path));
+        }
+    } catch (error) {
+        return pyNormpath(path);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Parsers
+// ---------------------------------------------------------------------------
+
+abstract class MapParserBase {
+
+    readonly modules: MapModules = new Map();
+    readonly warnings: string[] = [];
+
+    // basename -> first module path which ends with 'sep + basename'
+    private baseNameIndex: Map<string, string> | undefined = new Map();
+
+    protected opts: MapFileParseOptions;
+
+    constructor(opts: MapFileParseOptions) {
+        this.opts = opts;
+    }
+
+    abstract parse(lines: Iterator<string>): MapModules;
+
+    protected moduleAdd(objectName: string, size: number, section: string) {
+
+        if (!objectName || !size || !section)
+            return;
+
+        const exist = this.modules.get(objectName);
+        if (exist) {
+            exist[section] = (exist[section] || 0) + size;
+            return;
+        }
+
+        const baseName = NodePath.basename(objectName);
+        const matched = this.getBaseNameIndex().get(baseName);
+        if (matched !== undefined) {
+            const contents = <MapSectionSizes>this.modules.get(matched);
+            contents[section] = (contents[section] || 0) + size;
+            return;
+        }
+
+        this.modules.set(objectName, { [section]: size });
+        if (objectName.endsWith(NodePath.sep + baseName))
+            this.getBaseNameIndex().set(baseName, objectName);
+    }
+
+    protected moduleReplace(oldObject: string, newObject: string) {
+        const val = this.modules.get(oldObject);
+        if (val !== undefined) {
+            this.modules.set(newObject, val);
+            this.modules.delete(oldObject);
+            this.baseNameIndex = undefined;
+        }
+    }
+
+    protected warn(msg: string) {
+        if (this.warnings.length < 100)
+            this.warnings.push(msg);
+    }
+
+    private getBaseNameIndex(): Map<string, string> {
+        if (this.baseNameIndex == undefined) {
+            this.baseNameIndex = new Map();
+            for (const name of this.modules.keys()) {
+                const b = NodePath.basename(name);
+                if (name.endsWith(NodePath.sep + b) && !this.baseNameIndex.has(b))
+                    this.baseNameIndex.set(b, name);
+            }
+        }
+        return this.baseNameIndex;
+    }
+
+    protected relocateModules(isExcluded: (name: string) => boolean): MapModules {
+
+        const prefix = pyDirname(commonPrefix(
+            Array.from(this.modules.keys()).filter(o => endsWithObjExt(o) && !isExcluded(o))));
+
+        const newModules: MapModules = new Map();
+        for (const [name, stats] of this.modules) {
+            if (isExcluded(name))
+                newModules.set(name, stats);
+            else if (endsWithObjExt(name))
+                newModules.set(toRelativePath(name, prefix, this.opts.toolchainRoot), stats);
+            else
+                newModules.set(name, stats);
+        }
+
+        return newModules;
+    }
+}
+
+class GccMapParser extends MapParserBase {
+
+    private static readonly RE_OBJECT_FILE = /^(.+\/.+\.o(bj)?)$/;
+    private static readonly RE_LIBRARY_OBJECT = /^.+lib((.+\.a)\((.+\.o(bj)?)\))$/;
+    private static readonly RE_STD_SECTION = /^\s+.*0x(\w{8,16})\s+0x(\w+)\s(.+)$/;
+    private static readonly RE_FILL_SECTION = /^\s*\*fill\*\s+0x(\w{8,16})\s+0x(\w+).*$/;
+    private static readonly RE_TRANS_FILE = /^(.+\/|.+\.ltrans.o(bj)?)$/;
+
+    private static readonly ALL_SECTIONS = SECTIONS
+        .concat(OTHER_SECTIONS)
+        .concat(MISC_FLASH_SECTIONS)
+        .concat(['unknown', 'OUTPUT']);
+
+    private checkNewSection(line: string): string | undefined {
+        const line_s = line.trim();
+        for (const sec of GccMapParser.ALL_SECTIONS) {
+            if (line_s.startsWith(sec))
+                return sec;
+        }
+        if (line.startsWith('.'))
+            return 'unknown';
+        return undefined;
+    }
+
+    private parseObjectName(line: string): string {
+
+        if (GccMapParser.RE_TRANS_FILE.test(line))
+            return '[misc]';
+
+        const m = GccMapParser.RE_OBJECT_FILE.exec(line);
+        if (m) {
+            const objectName = m[1];
+            // corner case: certain objects are provided by the GCC toolchain
+            if (line.includes('arm-none-eabi'))
+                return pyJoin('[lib]', 'misc', NodePath.basename(objectName));
+            return objectName;
+        }
+
+        const lm = GccMapParser.RE_LIBRARY_OBJECT.exec(line);
+        if (lm)
+            return pyJoin('[lib]', lm[2], lm[3]);
+
+        if (!line.startsWith('LONG') && !line.startsWith('linker stubs'))
+            this.warn(`Unknown object name found in GCC map file: ${line}`);
+
+        return '[misc]';
+    }
+
+    private parseSection(line: string): [string, number] {
+
+        const fill = GccMapParser.RE_FILL_SECTION.exec(line);
+        if (fill)
+            return ['[fill]', parseInt(fill[2], 16)];
+
+        const sec = GccMapParser.RE_STD_SECTION.exec(line);
+        if (sec) {
+            const size = parseInt(sec[2], 16);
+            if (size)
+                return [this.parseObjectName(sec[3]), size];
+        }
+
+        return ['', 0];
+    }
+
+    parse(lines: Iterator<string>): MapModules {
+
+        let currentSection = 'unknown';
+
+        for (let r = lines.next(); !r.done; r = lines.next()) {
+            if (r.value.startsWith('Linker script and memory map'))
+                break;
+        }
+
+        for (let r = lines.next(); !r.done; r = lines.next()) {
+
+            const line = r.value;
+            const nextSection = this.checkNewSection(line);
+
+            if (nextSection == 'OUTPUT')
+                break;
+            else if (nextSection)
+                currentSection = nextSection;
+
+            const [name, size] = this.parseSection(line);
+            this.moduleAdd(name, size, currentSection);
+        }
+
+        return this.relocateModules((name) => name.startsWith('[lib]'));
+    }
+}
+
+class ArmccMapParser extends MapParserBase {
+
+    private static readonly RE = /^\s+0x(\w{8})\s+0x(\w{8})\s+(\w+)\s+(\w+)\s+(\d+)\s+[*]?.+\s+(.+)$/;
+    private static readonly RE_OBJECT = /^(.+\.(l|lib|ar))\((.+\.o(bj)?)\)/;
+
+    private parseObjectName(line: string): string {
+
+        if (endsWithObjExt(line))
+            return line;
+
+        const m = ArmccMapParser.RE_OBJECT.exec(line);
+        if (m)
+            return pyJoin('[lib]', NodePath.basename(m[1]), m[3]);
+
+        this.warn(`Malformed input found when parsing ARMCC map: ${line}`);
+        return '[misc]';
+    }
+
+    private parseSection(line: string): [string, number, string] {
+
+        const m = ArmccMapParser.RE.exec(line);
+        if (!m || line.includes('ARM_LIB_HEAP'))
+            return ['', 0, ''];
+
+        const size = parseInt(m[2], 16);
+        let section: string;
+
+        if (m[4] == 'RO') {
+            section = m[3] == 'Data' ? '.rodata' : '.text';
+        } else {
+            if (m[3] == 'Data')
+                section = '.data';
+            else if (m[3] == 'Zero')
+                section = '.bss';
+            else if (m[3] == 'Code')
+                section = '.text';
+            else {
+                this.warn(`Malformed input found when parsing armcc map: ${line}`);
+                return ['', 0, ''];
+            }
+        }
+
+        return [this.parseObjectName(m[6]), size, section];
+    }
+
+    parse(lines: Iterator<string>): MapModules {
+
+        for (let r = lines.next(); !r.done; r = lines.next()) {
+            if (r.value.startsWith('    Base Addr    Size'))
+                break;
+        }
+
+        for (let r = lines.next(); !r.done; r = lines.next()) {
+            const [name, size, section] = this.parseSection(r.value);
+            this.moduleAdd(name, size, section);
+        }
+
+        const isAnonObj = (name: string) => name == 'anon$$obj.o' || name == 'anon$$obj.obj';
+        return this.relocateModules((name) => isAnonObj(name) || name.startsWith('[lib]'));
+    }
+}
+
+class IarMapParser extends MapParserBase {
+
+    private static readonly RE = /^\s+(.+)\s+(zero|const|ro code|inited|uninit)\s+0x(['\w]+)\s+0x(\w+)\s+(.+)\s.+$/;
+    private static readonly RE_LIBRARY = /^(.+\.a):.+$/;
+    private static readonly RE_OBJECT_LIBRARY = /^\s+(.+\.o(bj)?)\s.*/;
+
+    // modules passed to the linker on the command line, looked up by their basename
+    private cmdModules: Map<string, string> = new Map();
+
+    private parseObjectName(objectName: string): string {
+        if (endsWithObjExt(objectName))
+            return this.cmdModules.get(objectName) ?? objectName;
+        return '[misc]';
+    }
+
+    private parseSection(line: string): [string, number, string] {
+
+        const m = IarMapParser.RE.exec(line);
+        if (!m)
+            return ['', 0, ''];
+
+        let section: string;
+
+        if (m[2] == 'ro code') {
+            section = '.text';
+        } else if (m[2] == 'const') {
+            section = '.rodata';
+        } else if (m[2] == 'zero' || m[2] == 'uninit') {
+            if (m[1].substring(0, 4) == 'HEAP')
+                section = '.heap';
+            else if (m[1].substring(0, 6) == 'CSTACK')
+                section = '.stack';
+            else
+                section = '.bss';
+        } else if (m[2] == 'inited') {
+            section = '.data';
+        } else {
+            this.warn(`Malformed input found when parsing IAR map: ${line}`);
+            return ['', 0, ''];
+        }
+
+        return [this.parseObjectName(m[5]), parseInt(m[4], 16), section];
+    }
+
+    private parseCommandLine(lines: Iterator<string>) {
+
+        for (let r = lines.next(); !r.done; r = lines.next()) {
+            const line = r.value;
+            if (line.startsWith('*'))
+                break;
+            for (let arg of line.split(' ')) {
+                arg = arg.replace(/[ \n]+$/, '');
+                if (!arg.startsWith('-') && endsWithObjExt(arg))
+                    this.cmdModules.set(NodePath.basename(arg), arg);
+            }
+        }
+
+        const prefix = pyDirname(commonPrefix(Array.from(this.cmdModules.values())));
+        for (const [k, f] of this.cmdModules)
+            this.cmdModules.set(k, toRelativePath(f, prefix, this.opts.toolchainRoot));
+    }
+
+    parse(lines: Iterator<string>): MapModules {
+
+        this.parseCommandLine(lines);
+
+        for (let r = lines.next(); !r.done; r = lines.next()) {
+            if (r.value.startsWith('  Section  '))
+                break;
+        }
+
+        for (let r = lines.next(); !r.done; r = lines.next()) {
+            const [name, size, section] = this.parseSection(r.value);
+            this.moduleAdd(name, size, section);
+            if (r.value.startsWith('*** MODULE SUMMARY')) // finish section
+                break;
+        }
+
+        let currentLibrary = '';
+        for (let r = lines.next(); !r.done; r = lines.next()) {
+
+            const lib = IarMapParser.RE_LIBRARY.exec(r.value);
+            if (lib)
+                currentLibrary = lib[1];
+
+            const obj = IarMapParser.RE_OBJECT_LIBRARY.exec(r.value);
+            if (obj && currentLibrary)
+                this.moduleReplace(obj[1], pyJoin('[lib]', currentLibrary, obj[1]));
+        }
+
+        return this.modules;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+/**
+ * Get the map file format of a toolchain, return undefined if it's not supported
+*/
+export function getMapFileTypeByToolchain(toolchainName: string): MapFileType | undefined {
+    switch (toolchainName) {
+        case 'AC5':
+        case 'AC6':
+            return 'ARM_MICRO';
+        case 'GCC':
+        case 'GNU_SDCC_MCS51':
+            return 'GCC_ARM';
+        case 'IAR_ARM':
+            return 'IAR';
+        default:
+            return undefined;
+    }
+}
+
+function newParser(type: MapFileType, opts: MapFileParseOptions): MapParserBase {
+    switch (type) {
+        case 'GCC_ARM':
+            return new GccMapParser(opts);
+        case 'ARM_MICRO':
+            return new ArmccMapParser(opts);
+        case 'IAR':
+            return new IarMapParser(opts);
+        default:
+            throw new Error(`Unsupported map file type: '${type}'`);
+    }
+}
+
+/**
+ * Parse map text lines, return all modules and their section sizes.
+*/
+export function parseMapLines(lines: Iterable<string>, type: MapFileType, opts?: MapFileParseOptions): { modules: MapModules, warnings: string[] } {
+    const parser = newParser(type, opts || {});
+    const modules = parser.parse(lines[Symbol.iterator]());
+    return { modules, warnings: parser.warnings };
+}
+
+/**
+ * Parse a map file and make the memory report (compare with '<mapfile>.old' if it exists).
+ *
+ * @param depth directory depth of module names in the report, <= 0 means not group modules
+*/
+export function parseMapFileReport(mapPath: string, type: MapFileType, depth: number, opts?: MapFileParseOptions): MapMemoryReport {
+
+    const cur = parseMapLines(readLines(mapPath), type, opts);
+
+    let old: MapModules | undefined;
+    if (fs.existsSync(mapPath + '.old')) {
+        try {
+            old = parseMapLines(readLines(mapPath + '.old'), type, opts).modules;
+        } catch (error) {
+            // ignore the old map
+        }
+    }
+
+    return makeMemoryReport(cur.modules, old, depth, cur.warnings);
+}
+
+function reduceModuleName(name: string, depth: number): string {
+    let parts = name.split(NodePath.sep);
+    if (parts[0] == '')
+        parts = parts.slice(1);
+    return pyJoin(...parts.slice(0, depth));
+}
+
+export function makeMemoryReport(modules: MapModules, oldModules: MapModules | undefined, depth: number, warnings?: string[]): MapMemoryReport {
+
+    // modules grouped by depth
+    const shortModules: Map<string, MapSectionSizes> = new Map();
+
+    if (depth <= 0) {
+        for (const [name, v] of modules)
+            shortModules.set(name, Object.assign({}, v));
+    } else {
+        const add = (name: string, key: string, value: number) => {
+            let m = shortModules.get(name);
+            if (m == undefined) {
+                m = {};
+                shortModules.set(name, m);
+            }
+            m[key] = (m[key] || 0) + value;
+        };
+        for (const [name, v] of modules) {
+            const newName = reduceModuleName(name, depth);
+            if (!shortModules.has(newName)) shortModules.set(newName, {});
+            for (const sec in v) {
+                add(newName, sec, v[sec]);
+                add(newName, sec + '-delta', v[sec]);
+            }
+        }
+        if (oldModules) {
+            for (const [name, v] of oldModules) {
+                const newName = reduceModuleName(name, depth);
+                for (const sec in v)
+                    add(newName, sec + '-delta', -v[sec]);
+            }
+        }
+    }
+
+    const subtotal: MapSectionSizes = {};
+    const inc = (key: string, value: number) => subtotal[key] = (subtotal[key] || 0) + value;
+    for (const sec of SECTIONS) {
+        inc(sec, 0);
+        inc(sec + '-delta', 0);
+    }
+    for (const mod of modules.values()) {
+        for (const sec of SECTIONS) {
+            inc(sec, mod[sec] || 0);
+            inc(sec + '-delta', mod[sec] || 0);
+        }
+    }
+    if (oldModules) {
+        for (const mod of oldModules.values()) {
+            for (const sec of SECTIONS)
+                inc(sec + '-delta', -(mod[sec] || 0));
+        }
+    }
+
+    const summary: MapMemorySummary = {
+        static_ram: subtotal['.data'] + subtotal['.bss'],
+        static_ram_delta: subtotal['.data-delta'] + subtotal['.bss-delta'],
+        total_flash: subtotal['.text'] + subtotal['.data'] + subtotal['.rodata'],
+        total_flash_delta: subtotal['.text-delta'] + subtotal['.data-delta'] + subtotal['.rodata-delta'],
+    };
+
+    const reportModules: MapModuleReportItem[] = [];
+    for (const name of Array.from(shortModules.keys()).sort(pyStrCompare)) {
+        const sizes = <MapSectionSizes>shortModules.get(name);
+        const size: MapSectionSizes = {};
+        for (const sec of PRINT_SECTIONS) {
+            size[sec] = sizes[sec] || 0;
+            size[sec + '-delta'] = sizes[sec + '-delta'] || 0;
+        }
+        reportModules.push({ module: name, size: size });
+    }
+
+    return {
+        modules: reportModules,
+        subtotal: subtotal,
+        summary: summary,
+        warnings: warnings || []
+    };
+}
+
+/** python sorts str by code point */
+function pyStrCompare(a: string, b: string): number {
+    return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+function fmtDelta(val: number, delta: number): string {
+    return `${val}(${delta >= 0 ? '+' : ''}${delta})`;
+}
+
+/**
+ * Make the same text table as `memap -e table`
+*/
+export function makeMemoryReportTable(report: MapMemoryReport): string[] {
+
+    const header = ['Module'].concat(PRINT_SECTIONS);
+    const rows: string[][] = [];
+
+    for (const m of report.modules)
+        rows.push([m.module].concat(PRINT_SECTIONS.map(s => fmtDelta(m.size[s], m.size[s + '-delta']))));
+
+    rows.push(['Subtotals'].concat(PRINT_SECTIONS.map(s => fmtDelta(report.subtotal[s], report.subtotal[s + '-delta']))));
+
+    const widths = header.map((h, i) => Math.max(h.length, ...rows.map(r => r[i].length)));
+    const fmtRow = (row: string[]) => '|' + row.map((cell, i) => {
+        return ' ' + (i == 0 ? cell.padEnd(widths[i]) : cell.padStart(widths[i])) + ' ';
+    }).join('|') + '|';
+
+    const lines: string[] = [];
+    lines.push(fmtRow(header));
+    lines.push('|' + widths.map(w => ''.padEnd(w + 2, '-')).join('|') + '|');
+    rows.forEach(r => lines.push(fmtRow(r)));
+
+    const s = report.summary;
+    lines.push(`Total Static RAM memory (data + bss): ${fmtDelta(s.static_ram, s.static_ram_delta)} bytes`);
+    lines.push(`Total Flash memory (text + data + rodata): ${fmtDelta(s.total_flash, s.total_flash_delta)} bytes`);
+
+    return lines;
+}
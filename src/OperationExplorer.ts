@@ -1221,9 +1221,8 @@ export class OperationExplorer {
                 let repoFileList: GitFileInfo[];
 
                 const cache = resManager.getCache('eide-template-list.json');
-                if (cache && (cache.lastUpdateTime || 0) + (10 * utility.TIME_ONE_MINUTE) > Date.now() &&
-                    resManager.getCachedFileByName(cache.name).IsFile()) {
-                    repoFileList = JSON.parse(resManager.getCachedFileByName(cache.name).Read());
+                if (cache && (cache.lastUpdateTime || 0) + (10 * utility.TIME_ONE_MINUTE) > Date.now()) {
+                    repoFileList = JSON.parse(cache.file.Read());
                 }
                 // if no cache, fetch it.
                 else {
@@ -1299,9 +1298,8 @@ export class OperationExplorer {
                 let templateInfoList: TemplateInfo[] = <any>null;
 
                 const idxCache = resManager.getCache('template.index.json');
-                if (idxCache && (idxCache.lastUpdateTime || 0) + (15 * utility.TIME_ONE_MINUTE) > Date.now() &&
-                    resManager.getCachedFileByName(idxCache.name).IsFile()) {
-                    templateIndexInfo = JSON.parse(resManager.getCachedFileByName(idxCache.name).Read());
+                if (idxCache && (idxCache.lastUpdateTime || 0) + (15 * utility.TIME_ONE_MINUTE) > Date.now()) {
+                    templateIndexInfo = JSON.parse(idxCache.file.Read());
                     templateInfoList = templateIndexInfo.template_list;
                 }
                 // if no cache, fetch it.
@@ -1409,8 +1407,7 @@ export class OperationExplorer {
                     // check whether has cache
                     const cacheInfo = resManager.getCache(templateInfo.file_name);
                     const hasCache = cacheInfo !== undefined
-                        && cacheInfo.version === tPickItem.version
-                        && resManager.getCachedFileByName(templateInfo.file_name).IsFile();
+                        && cacheInfo.version === tPickItem.version;
                     if (hasCache) {
                         tPickItem.cacheFileName = templateInfo.file_name;
                         desc_list.push(found_cache_desc);
@@ -1469,13 +1466,14 @@ export class OperationExplorer {
                 else if (temp_sel_item.download_url) {
 
                     // found cache, use cache install
-                    if (temp_sel_item.cacheFileName) {
-                        targetTempFile = resManager.getCachedFileByName(temp_sel_item.cacheFileName);
+                    const cache = temp_sel_item.cacheFileName ? resManager.getCache(temp_sel_item.cacheFileName) : undefined;
+                    if (cache) {
+                        targetTempFile = cache.file;
                     }
                     // has no cache, redownload it
                     else {
-                        // create cache file
-                        targetTempFile = resManager.getCachedFileByName(temp_sel_item.file_name);
+                        // download to a temp file, it's moved into the cache when done
+                        targetTempFile = File.fromArray([resManager.GetTmpDir().path, temp_sel_item.file_name]);
 
                         const done = await vscode.window.withProgress({
                             location: vscode.ProgressLocation.Notification,
@@ -1484,23 +1482,24 @@ export class OperationExplorer {
                         }, (progress, token): Thenable<boolean> => {
                             return new Promise(async (resolve) => {
 
-                                const res = await utility.downloadFileWithProgress(
-                                    <string>temp_sel_item.download_url, temp_sel_item.file_name, progress, token);
+                                const res = await utility.downloadFileToDisk(<string>temp_sel_item.download_url,
+                                    (<File>targetTempFile).path, temp_sel_item.file_name, progress, token);
 
-                                if (res instanceof Buffer) {
-                                    fs.writeFileSync((<File>targetTempFile).path, res);
-                                    resManager.addCache({
-                                        name: (<File>targetTempFile).name,
-                                        size: res.length,
-                                        version: temp_sel_item.version
-                                    });
-                                    resolve(true);
+                                if (res instanceof Error) {
+                                    GlobalEvent.emit('msg', ExceptionToMessage(res, 'Warning'));
+                                    resolve(false);
                                     return;
                                 }
 
-                                else if (res instanceof Error) {
-                                    GlobalEvent.emit('msg', ExceptionToMessage(res, 'Warning'));
-                                    resolve(false);
+                                else if (res) {
+                                    const cache = resManager.addCache({
+                                        name: (<File>targetTempFile).name,
+                                        version: temp_sel_item.version
+                                    }, <File>targetTempFile);
+                                    if (cache) {
+                                        targetTempFile = cache.file;
+                                    }
+                                    resolve(true);
                                     return;
                                 }
 
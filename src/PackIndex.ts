@@ -0,0 +1,520 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+import * as NodePath from 'path';
+
+/** file name of the pack index, it's placed in the pack folder, next to the '.pdsc' file */
+export const PACK_INDEX_FILE_NAME = '.eide.pack.index.json';
+
+const PACK_INDEX_VERSION = 1;
+
+//
+// The pack types below are compatible with `PackInfo` of the project modules,
+// they are not imported, because the project modules depend on vscode.
+//
+
+export interface PackMemoryItem {
+    tag: any;
+    id: number;
+    mem: { startAddr: string; size: string; };
+    isChecked: boolean;
+    noInit?: boolean;
+    isStartup?: boolean;
+}
+
+export interface PackDeviceInfo {
+    name: string;
+    devClassName: string;
+    core?: string;
+    define?: string;
+    endian?: string;
+    svdPath?: string;
+    storageLayout: { RAM: any[]; ROM: any[]; };
+    flashAlgorithms?: { path: string; start: string; size: string; default?: boolean; }[];
+}
+
+export interface PackFileItem {
+    attr?: string;
+    condition?: string;
+    path: string;
+}
+
+export interface PackComponent {
+    groupName: string;
+    description?: string;
+    enable: boolean;
+    RTE_define?: string;
+    incDirList: PackFileItem[];
+    headerList: PackFileItem[];
+    cFileList: PackFileItem[];
+    asmList: PackFileItem[];
+    libList?: PackFileItem[];
+    linkerList?: PackFileItem[];
+    defineList?: string[];
+    condition?: string;
+}
+
+export interface PackCondition {
+    condition?: string;
+    Dvendor?: string;
+    Dname?: RegExp;
+    compiler?: string;
+    compilerOption?: string;
+    component?: string;
+}
+
+export interface PackConditionGroup {
+    acceptList: PackCondition[];
+    requireList: PackCondition[];
+}
+
+export interface PackIndexInfo {
+    vendor: string;
+    name: string;
+    familyList: {
+        name: string;
+        vendor: string;
+        core?: string;
+        series: string;
+        description?: string;
+        deviceList: PackDeviceInfo[];
+        subFamilyList: {
+            name: string;
+            core?: string;
+            description?: string;
+            deviceList: PackDeviceInfo[];
+        }[];
+    }[];
+    components: PackComponent[];
+    conditionMap: Map<string, PackConditionGroup>;
+}
+
+//
+// index file format
+//
+
+/** [tag, id, startAddr, size, isChecked, noInit | isStartup] */
+type IdxMemory = [string, number, string, string, number, number];
+
+/** [RAM list, ROM list] */
+type IdxLayout = [IdxMemory[], IdxMemory[]];
+
+/** [relative path, start, size, default] */
+type IdxAlgorithm = [string, string, string, number];
+
+/**
+ * [name, class name, core, define, endian, svd path, layout, algorithms]
+ *
+ * the strings except the name are indexes of the string table, -1 means undefined,
+ * the layout and the algorithms are indexes of the shared tables
+*/
+type IdxDevice = [string, number, number, number, number, number, number, number];
+
+/** [relative path, attr, condition] */
+type IdxFile = [string, string?, string?];
+
+interface IdxSubFamily {
+    name: string;
+    core?: string;
+    description?: string;
+    devices: IdxDevice[];
+}
+
+interface IdxFamily extends IdxSubFamily {
+    vendor: string;
+    series: string;
+    subFamilies: IdxSubFamily[];
+}
+
+interface IdxComponent {
+    groupName: string;
+    description?: any;
+    RTE_define?: string;
+    condition?: string;
+    defineList?: string[];
+    files: { [listName: string]: IdxFile[] };
+}
+
+/** Dname is saved as the regexp source */
+type IdxCondition = { [key: string]: string | undefined };
+
+interface IdxFileData {
+    version: number;
+    /** the '.pdsc' file which the index is made from */
+    source: { name: string; size: number; mtime: number; };
+    vendor: string;
+    name: string;
+    strings: string[];
+    layouts: IdxLayout[];
+    algorithms: IdxAlgorithm[][];
+    families: IdxFamily[];
+    components: IdxComponent[];
+    conditions: { id: string; accept: IdxCondition[]; require: IdxCondition[]; }[];
+}
+
+const COMPONENT_FILE_LISTS = ['incDirList', 'headerList', 'cFileList', 'asmList', 'libList', 'linkerList'];
+
+/**
+ * Define a property which is created at the first access
+*/
+function defineLazy<T>(obj: any, key: string, init: () => T) {
+    const setValue = (val: T) => {
+        Object.defineProperty(obj, key, { value: val, writable: true, enumerable: true, configurable: true });
+    };
+    Object.defineProperty(obj, key, {
+        enumerable: true,
+        configurable: true,
+        get: () => {
+            const val = init();
+            setValue(val);
+            return val;
+        },
+        set: setValue
+    });
+}
+
+/**
+ * A normalized, compact index of a CMSIS pack: devices, memories, flash algorithms,
+ * components, files and conditions. It's made once after the pack is installed,
+ * and loaded instead of the '.pdsc' file when the project is opened.
+ *
+ * Memory layouts and algorithm lists are shared by devices in the index, and paths are
+ * relative to the pack folder. The layouts and algorithms of a device are only created
+ * when they are accessed.
+*/
+export class PackIndex {
+
+    private data: IdxFileData;
+    private packDir: string;
+
+    private constructor(packDir: string, data: IdxFileData) {
+        this.packDir = packDir;
+        this.data = data;
+    }
+
+    static getIndexPath(pdscPath: string): string {
+        return NodePath.join(NodePath.dirname(pdscPath), PACK_INDEX_FILE_NAME);
+    }
+
+    private static getSourceInfo(pdscPath: string): { name: string; size: number; mtime: number; } {
+        const st = fs.statSync(pdscPath);
+        return { name: NodePath.basename(pdscPath), size: st.size, mtime: Math.floor(st.mtimeMs) };
+    }
+
+    /**
+     * Load the index of the pack
+     *
+     * @returns undefined if the index is not found, or it is out of date
+    */
+    static load(pdscPath: string): PackIndex | undefined {
+
+        const idxPath = PackIndex.getIndexPath(pdscPath);
+        if (!fs.existsSync(idxPath))
+            return undefined;
+
+        try {
+            const data = <IdxFileData>JSON.parse(fs.readFileSync(idxPath, 'utf8'));
+            const src = PackIndex.getSourceInfo(pdscPath);
+            if (data.version !== PACK_INDEX_VERSION || data.source == undefined ||
+                data.source.name !== src.name || data.source.size !== src.size || data.source.mtime !== src.mtime) {
+                return undefined;
+            }
+            return new PackIndex(NodePath.dirname(pdscPath), data);
+        } catch (error) {
+            return undefined; // broken index, make a new one
+        }
+    }
+
+    /**
+     * Make an index from the parsed pack, all paths in the pack must be under the pack folder
+    */
+    static fromPackInfo(pdscPath: string, pack: PackIndexInfo): PackIndex {
+
+        const packDir = NodePath.dirname(pdscPath);
+        const base = packDir + NodePath.sep;
+
+        const strings: string[] = [];
+        const stringMap = new Map<string, number>();
+        const layouts: IdxLayout[] = [];
+        const layoutMap = new Map<string, number>();
+        const algorithms: IdxAlgorithm[][] = [];
+        const algorithmMap = new Map<string, number>();
+
+        const toRelative = (p: string): string => {
+            const rel = p.startsWith(base) ? p.substr(base.length) : p;
+            return rel.replace(/\\/g, '/');
+        };
+
+        const str = (s: string | undefined): number => {
+            if (s === undefined) return -1;
+            let idx = stringMap.get(s);
+            if (idx === undefined) {
+                idx = strings.push(s) - 1;
+                stringMap.set(s, idx);
+            }
+            return idx;
+        };
+
+        const share = <T>(table: T[], map: Map<string, number>, val: T): number => {
+            const key = JSON.stringify(val);
+            let idx = map.get(key);
+            if (idx === undefined) {
+                idx = table.push(val) - 1;
+                map.set(key, idx);
+            }
+            return idx;
+        };
+
+        const mem = (m: PackMemoryItem, isRom: boolean): IdxMemory => {
+            const flag = isRom ? m.isStartup : m.noInit;
+            return [m.tag, m.id, m.mem.startAddr, m.mem.size, m.isChecked ? 1 : 0, flag ? 1 : 0];
+        };
+
+        const device = (d: PackDeviceInfo): IdxDevice => {
+            const layout: IdxLayout = [
+                d.storageLayout.RAM.map(m => mem(m, false)),
+                d.storageLayout.ROM.map(m => mem(m, true))
+            ];
+            const algos: IdxAlgorithm[] = (d.flashAlgorithms || [])
+                .map(a => <IdxAlgorithm>[toRelative(a.path), a.start, a.size, a.default ? 1 : 0]);
+            return [
+                d.name,
+                d.devClassName === d.name ? -1 : str(d.devClassName),
+                str(d.core),
+                str(d.define),
+                str(d.endian),
+                str(d.svdPath === undefined ? undefined : toRelative(d.svdPath)),
+                share(layouts, layoutMap, layout),
+                d.flashAlgorithms ? share(algorithms, algorithmMap, algos) : -1
+            ];
+        };
+
+        const condition = (c: PackCondition): IdxCondition => {
+            const r: IdxCondition = {};
+            for (const key in c) {
+                const val = (<any>c)[key];
+                if (val !== undefined)
+                    r[key] = val instanceof RegExp ? val.source : val;
+            }
+            return r;
+        };
+
+        const data: IdxFileData = {
+            version: PACK_INDEX_VERSION,
+            source: PackIndex.getSourceInfo(pdscPath),
+            vendor: pack.vendor,
+            name: pack.name,
+            strings: strings,
+            layouts: layouts,
+            algorithms: algorithms,
+            families: pack.familyList.map((family) => {
+                return {
+                    name: family.name,
+                    vendor: family.vendor,
+                    core: family.core,
+                    series: family.series,
+                    description: family.description,
+                    devices: family.deviceList.map(device),
+                    subFamilies: family.subFamilyList.map((sub) => {
+                        return {
+                            name: sub.name,
+                            core: sub.core,
+                            description: sub.description,
+                            devices: sub.deviceList.map(device)
+                        };
+                    })
+                };
+            }),
+            components: pack.components.map((comp) => {
+                const files: { [listName: string]: IdxFile[] } = {};
+                for (const listName of COMPONENT_FILE_LISTS) {
+                    const list: PackFileItem[] | undefined = (<any>comp)[listName];
+                    if (list) {
+                        files[listName] = list.map((f) => {
+                            const item: IdxFile = [toRelative(f.path)];
+                            if (f.attr !== undefined || f.condition !== undefined)
+                                item.push(f.attr, f.condition);
+                            return item;
+                        });
+                    }
+                }
+                return {
+                    groupName: comp.groupName,
+                    description: comp.description,
+                    RTE_define: comp.RTE_define,
+                    condition: comp.condition,
+                    defineList: comp.defineList,
+                    files: files
+                };
+            }),
+            conditions: []
+        };
+
+        pack.conditionMap.forEach((group, id) => {
+            data.conditions.push({
+                id: id,
+                accept: group.acceptList.map(condition),
+                require: group.requireList.map(condition)
+            });
+        });
+
+        return new PackIndex(packDir, data);
+    }
+
+    save() {
+        fs.writeFileSync(NodePath.join(this.packDir, PACK_INDEX_FILE_NAME), JSON.stringify(this.data));
+    }
+
+    get deviceCount(): number {
+        let count = 0;
+        for (const family of this.data.families) {
+            count += family.devices.length;
+            family.subFamilies.forEach(sub => count += sub.devices.length);
+        }
+        return count;
+    }
+
+    /**
+     * Map the index to the pack info, the memory layouts and the flash algorithms
+     * of the devices are created when they are accessed
+    */
+    toPackInfo(): PackIndexInfo {
+
+        const data = this.data;
+        const base = this.packDir + NodePath.sep;
+
+        const toAbsolute = (rel: string): string => {
+            return NodePath.isAbsolute(rel) ? rel : base + rel.replace(/\//g, NodePath.sep);
+        };
+
+        const str = (idx: number): string | undefined => {
+            return idx < 0 ? undefined : data.strings[idx];
+        };
+
+        const mem = (m: IdxMemory, isRom: boolean): PackMemoryItem => {
+            const item: PackMemoryItem = {
+                tag: m[0],
+                id: m[1],
+                mem: { startAddr: m[2], size: m[3] },
+                isChecked: m[4] == 1
+            };
+            if (isRom) item.isStartup = m[5] == 1;
+            else item.noInit = m[5] == 1;
+            return item;
+        };
+
+        const device = (d: IdxDevice): PackDeviceInfo => {
+
+            const svd = str(d[5]);
+            const info: any = {
+                name: d[0],
+                devClassName: d[1] < 0 ? d[0] : data.strings[d[1]],
+                core: str(d[2]),
+                define: str(d[3]),
+                endian: str(d[4]),
+                svdPath: svd === undefined ? undefined : toAbsolute(svd)
+            };
+
+            defineLazy(info, 'storageLayout', () => {
+                const layout = data.layouts[d[6]];
+                return {
+                    RAM: layout[0].map(m => mem(m, false)),
+                    ROM: layout[1].map(m => mem(m, true))
+                };
+            });
+
+            if (d[7] >= 0) {
+                defineLazy(info, 'flashAlgorithms', () => {
+                    return data.algorithms[d[7]].map((a) => {
+                        return { path: toAbsolute(a[0]), start: a[1], size: a[2], default: a[3] == 1 };
+                    });
+                });
+            }
+
+            return info;
+        };
+
+        const condition = (c: IdxCondition): PackCondition => {
+            const r: any = {};
+            for (const key in c) {
+                r[key] = key == 'Dname' ? new RegExp(<string>c[key], 'i') : c[key];
+            }
+            return r;
+        };
+
+        const conditionMap = new Map<string, PackConditionGroup>();
+        for (const c of data.conditions) {
+            conditionMap.set(c.id, {
+                acceptList: c.accept.map(condition),
+                requireList: c.require.map(condition)
+            });
+        }
+
+        return {
+            vendor: data.vendor,
+            name: data.name,
+            familyList: data.families.map((family) => {
+                return {
+                    name: family.name,
+                    vendor: family.vendor,
+                    core: family.core,
+                    series: family.series,
+                    description: family.description,
+                    deviceList: family.devices.map(device),
+                    subFamilyList: family.subFamilies.map((sub) => {
+                        return {
+                            name: sub.name,
+                            core: sub.core,
+                            description: sub.description,
+                            deviceList: sub.devices.map(device)
+                        };
+                    })
+                };
+            }),
+            components: data.components.map((comp) => {
+                const item: any = {
+                    groupName: comp.groupName,
+                    description: comp.description,
+                    enable: false,
+                    RTE_define: comp.RTE_define,
+                    condition: comp.condition,
+                    incDirList: [],
+                    headerList: [],
+                    cFileList: [],
+                    asmList: []
+                };
+                if (comp.defineList)
+                    item.defineList = comp.defineList.slice();
+                for (const listName in comp.files) {
+                    item[listName] = comp.files[listName].map((f) => {
+                        return { attr: f[1], condition: f[2], path: toAbsolute(f[0]) };
+                    });
+                }
+                return item;
+            }),
+            conditionMap: conditionMap
+        };
+    }
+}
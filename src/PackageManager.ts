@@ -31,7 +31,7 @@ import * as Xml2JS from 'x2js';
 import {
     PackInfo, CurrentDevice, SubFamily, DeviceInfo, Component,
     ConditionGroup, DeviceFamily, ConditionMap,
-    ARMRamItem, ARMRomItem, Condition, ArmBaseCompileData, ComponentFileItem
+    ARMRamItem, ARMRomItem, Condition, ArmBaseCompileData, ComponentFileItem, DeviceFlashAlgorithm
 } from './EIDEProjectModules';
 import { IToolchian } from './ToolchainManager';
 import { GlobalEvent } from './GlobalEvents';
@@ -40,7 +40,12 @@ import { AbstractProject } from './EIDEProject';
 import { ExceptionToMessage, newMessage } from './Message';
 import { ResManager } from './ResManager';
 import { ExeCmd } from '../lib/node-utility/Executable';
-import { ArrayDelRepetition } from '../lib/node-utility/Utility';
+import { PackIndex } from './PackIndex';
+import { ZipArchive } from './ZipArchive';
+import { ConditionSolver, ConditionContext, ComponentResolution } from './ConditionSolver';
+import { SettingManager } from './SettingManager';
+import * as NodePath from 'path';
+import { Tracer } from './Tracer';
 
 export enum ComponentUpdateType {
     Disabled = 1,
@@ -56,6 +61,9 @@ export class PackageManager {
 
     static PACK_DIR = '.pack';
 
+    /** if this file exists in the pack folder, the pack files are extracted on demand from the archive */
+    static PACK_SOURCE_FILE = '.eide.pack.source';
+
     private packList: PackInfo[];
 
     private currentPackDir: File | undefined;
@@ -64,14 +72,13 @@ export class PackageManager {
     private compress: SevenZipper;
     private xmlParser: Xml2JS;
     private _event: events.EventEmitter;
-    private _recurseList: string[];
+    private _conditionSolver: { key: string, conditionMap: ConditionMap, solver: ConditionSolver } | undefined;
 
     private currentDevice: CurrentDevice | undefined;
 
     constructor(_project: AbstractProject) {
         this.project = _project;
         this.packList = [];
-        this._recurseList = [];
         this._event = new events.EventEmitter();
         this.compress = new SevenZipper(ResManager.GetInstance().Get7zDir());
         this.xmlParser = new Xml2JS({
@@ -270,11 +277,102 @@ export class PackageManager {
         let oledDevice = this.currentDevice;
         this.currentDevice = dev;
         if (dev) {
+            this._extractDeviceFiles(dev);
             this._refreshComponents(dev);
         }
         this.emit('deviceChanged', oledDevice);
     }
 
+    private _extractDeviceFiles(dev: CurrentDevice) {
+        const devInfo = this.getCurrentDevInfo(dev);
+        if (devInfo) {
+            const files: string[] = [];
+            if (devInfo.svdPath) files.push(devInfo.svdPath);
+            if (devInfo.flashAlgorithms) devInfo.flashAlgorithms.forEach(algo => files.push(algo.path));
+            try {
+                this.ExtractPackFiles(files);
+            } catch (error) {
+                GlobalEvent.log_warn(<Error>error);
+            }
+        }
+    }
+
+    /**
+     * Extract the files of a lazily installed pack from the pack archive, only for the files which
+     * are not extracted yet. If a path is a folder, all files under it are extracted.
+     * Do nothing if the pack is fully extracted.
+    */
+    ExtractPackFiles(paths: string[]) {
+
+        const packDir = this.currentPackDir;
+        if (packDir == undefined)
+            return;
+
+        const sourceFile = File.from(packDir.path, PackageManager.PACK_SOURCE_FILE);
+        if (!sourceFile.IsFile())
+            return;
+
+        const missing = paths.filter(p => File.isSubPathOf(packDir.path, p) && !fs.existsSync(p));
+        if (missing.length == 0)
+            return;
+
+        const source: { archive: string } = JSON.parse(sourceFile.Read());
+        if (!fs.existsSync(source.archive))
+            throw new Error(`Not found the pack archive: '${source.archive}', please reinstall the pack !`);
+
+        const zip = ZipArchive.open(source.archive);
+
+        try {
+
+            for (const path of missing) {
+
+                const name = File.ToUnixPath(NodePath.relative(packDir.path, path));
+                const entry = zip.getEntry(name);
+                const list = entry && !entry.name.endsWith('/') ? [entry] : zip.getEntriesUnder(name);
+
+                if (list.length == 0) {
+                    GlobalEvent.log_warn(`Not found '${name}' in the pack archive: '${source.archive}'`);
+                    continue;
+                }
+
+                for (const e of list) {
+                    const dest = NodePath.join(packDir.path, ...e.name.split('/'));
+                    if (File.isSubPathOf(packDir.path, dest) && !fs.existsSync(dest)) {
+                        zip.extract(e, dest, packDir.path);
+                    }
+                }
+            }
+
+        } finally {
+            zip.close();
+        }
+    }
+
+    /**
+     * Add the pack archive to the artifact store and only extract the '.pdsc' file,
+     * other files are extracted by `ExtractPackFiles()` when they are used.
+     * The archive is held by the pack folder until the pack is uninstalled
+    */
+    private installPackLazily(pack: File, outDir: File) {
+
+        // all projects use one copy of the archive
+        const archivePath = ResManager.GetInstance().getArtifactStore()
+            .putFile(pack.path, { holder: this.packRootDir().path }).path;
+
+        const zip = ZipArchive.open(archivePath);
+
+        try {
+            const pdsc = zip.entries.find(e => !e.name.includes('/') && /\.pdsc$/i.test(e.name));
+            if (pdsc == undefined)
+                throw new Error(`Not found '.pdsc' file in the pack: '${pack.name}'`);
+            zip.extract(pdsc, File.from(outDir.path, pdsc.name).path, outDir.path);
+        } finally {
+            zip.close();
+        }
+
+        File.from(outDir.path, PackageManager.PACK_SOURCE_FILE).Write(JSON.stringify({ archive: archivePath }));
+    }
+
     private _refreshComponents(dev: CurrentDevice) {
 
         const cToolchain = this.project.getToolchain();
@@ -323,164 +421,61 @@ export class PackageManager {
         if (this.packRootDir().IsDir()) {
             DeleteDir(this.packRootDir());
         }
-    }
-
-    private _checkConditionGroup(gMap: ConditionMap, 
-        cGroup: ConditionGroup, cDev: CurrentDevice, 
-        comp_requires: string[], toolchain?: IToolchian): void {
-
-        const familyInfo = cDev.packInfo.familyList[cDev.familyIndex];
-        const devInfo = this.getCurrentDevInfo(cDev);
-
-        if (devInfo == undefined) {
-            throw new Error(`No such device info: deviceIndex=${cDev.deviceIndex}`);
-        }
-
-        for (const con of cGroup.requireList) {
-
-            if (toolchain) {
-
-                if (con.compiler && con.compiler !== toolchain.categoryName) {
-                    throw new Error(`Compiler category '${toolchain.categoryName}' not match, expect: ${con.compiler}`);
-                }
-
-                if (con.compilerOption && con.compilerOption !== toolchain.name) {
-                    throw new Error(`Compiler name '${toolchain.name}' not match, expect: ${con.compilerOption}`);
-                }
-            }
-
-            if (con.Dvendor && con.Dvendor !== familyInfo.vendor) {
-                throw new Error(`Family vendor '${familyInfo.vendor}' not match, expect: ${con.Dvendor}`);
-            }
-
-            if (con.Dname && !con.Dname.test(devInfo.name)) {
-                throw new Error(`Device name '${devInfo.name}' not match, expect: ${con.Dname}`);
-            }
-
-            if (con.component) {
-                comp_requires.push(con.component);
-            }
-
-            if (con.condition && !this._recurseList.includes(con.condition)) {
-                const _group = gMap.get(con.condition);
-                if (_group) {
-                    this._recurseList.push(con.condition);
-                    this._checkConditionGroup(gMap, _group, cDev, comp_requires, toolchain);
-                }
-            }
-        }
-
-        if (cGroup.acceptList.length === 0) {
-            return;
+        try {
+            ResManager.GetInstance().getArtifactStore().releaseAll(this.packRootDir().path);
+        } catch (error) {
+            GlobalEvent.log_warn(<Error>error);
         }
+    }
 
-        // return, if one passed
-        let passCount = 0;
-        for (const con of cGroup.acceptList) {
-
-            passCount = 0;
-
-            if (con.compiler && toolchain) {
-                if (con.compiler === toolchain.categoryName) {
-                    passCount++;
-                }
-            } else {
-                passCount++;
-            }
-
-            if (con.compilerOption && toolchain) {
-                if (con.compilerOption === toolchain.name) {
-                    passCount++;
-                }
-            } else {
-                passCount++;
-            }
-
-            if (con.Dvendor) {
-                if (con.Dvendor === familyInfo.vendor) {
-                    passCount++;
-                }
-            } else {
-                passCount++;
-            }
+    /**
+     * Get the condition solver of the current device and toolchain,
+     * it's reused until the pack, the device or the toolchain is changed
+    */
+    getConditionSolver(toolchain?: IToolchian): ConditionSolver | undefined {
 
-            if (con.Dname) {
-                if (con.Dname.test(devInfo.name)) {
-                    passCount++;
-                }
-            } else {
-                passCount++;
-            }
+        if (this.currentDevice == undefined)
+            return undefined;
 
-            if (con.condition && !this._recurseList.includes(con.condition)) {
-                const _group = gMap.get(con.condition);
-                if (_group) {
-                    this._recurseList.push(con.condition);
-                    try {
-                        this._checkConditionGroup(gMap, _group, cDev, comp_requires, toolchain);
-                        passCount++;
-                    } catch (error) {
-                        // nothing todo for accept condition
-                    }
-                } else {
-                    passCount++;
-                }
-            } else {
-                passCount++;
-            }
+        const cDev = this.currentDevice;
+        const devInfo = this.getCurrentDevInfo(cDev);
+        const context: ConditionContext = {
+            vendor: cDev.packInfo.familyList[cDev.familyIndex].vendor,
+            device: devInfo ? devInfo.name : '',
+            compiler: toolchain?.categoryName,
+            compilerOption: toolchain?.name
+        };
 
-            // 1. compiler
-            // 2. compilerOption
-            // 3. Dvendor
-            // 4. Dname
-            // 5. condition
-            // ---
-            // if satisfy above conditions, passCount will be 5
-            if (passCount === 5) {
-                // if this 'accept' is require a component, append it.
-                if (con.component) {
-                    comp_requires.push(con.component);
-                }
-                return;
-            }
+        const key = ConditionSolver.contextKey(context);
+        if (this._conditionSolver == undefined ||
+            this._conditionSolver.key != key ||
+            this._conditionSolver.conditionMap !== cDev.packInfo.conditionMap) {
+            this._conditionSolver = {
+                key: key,
+                conditionMap: cDev.packInfo.conditionMap,
+                solver: new ConditionSolver(cDev.packInfo.conditionMap, context)
+            };
         }
 
-        throw new Error(`Not match any 'accept' conditions !`);
+        return this._conditionSolver.solver;
     }
 
     CheckCondition(conditionName: string, toolchain: IToolchian): boolean {
-
-        if (this.currentDevice) {
-            const cMap = this.currentDevice.packInfo.conditionMap;
-            const cGroup = cMap.get(conditionName);
-            if (cGroup) {
-                this._recurseList = [conditionName];
-                try {
-                    this._checkConditionGroup(cMap, cGroup, this.currentDevice, [], toolchain);
-                    return true;
-                } catch (error) {
-                    return false;
-                }
-            }
-        }
-
-        return true;
+        const solver = this.getConditionSolver(toolchain);
+        return solver ? solver.check(conditionName) : true;
     }
 
-    checkComponentRequirement(conditionName: string, toolchain: IToolchian): string[] {
+    /**
+     * Resolve the components to install for the selected components, include all dependencies
+    */
+    resolveComponents(selection: Component[], toolchain: IToolchian,
+        isInstalled: (groupName: string) => boolean): ComponentResolution<Component> | undefined {
 
-        if (this.currentDevice) {
-            const cMap = this.currentDevice.packInfo.conditionMap;
-            const cGroup = cMap.get(conditionName);
-            if (cGroup) {
-                const components: string[] = [];
-                this._recurseList = [conditionName];
-                this._checkConditionGroup(cMap, cGroup, this.currentDevice, components, toolchain);
-                return ArrayDelRepetition(components);
-            }
-        }
+        const solver = this.getConditionSolver(toolchain);
+        if (solver == undefined || this.packList.length == 0)
+            return undefined;
 
-        return [];
+        return solver.resolveComponents(selection, this.packList[0].components, isInstalled);
     }
 
     makeComponentGroupName(...names: string[]): string {
@@ -497,9 +492,10 @@ export class PackageManager {
             if (subFamily.processor && subFamily.processor.length > 1 &&
                 subFamily.processor[0].$Pname) {
 
-                const _objStr = JSON.stringify(subFamily);
                 for (const proc of (<any[]>subFamily.processor)) {
-                    const nSubFamily = JSON.parse(_objStr);
+
+                    // only the filtered fields are replaced, others are shared
+                    const nSubFamily = Object.assign({}, subFamily);
 
                     if (nSubFamily.processor) {
                         nSubFamily.processor = (<any[]>nSubFamily.processor).filter((obj) => {
@@ -528,6 +524,7 @@ export class PackageManager {
                     }
 
                     if (nSubFamily.device) {
+                        nSubFamily.device = (<any[]>nSubFamily.device).map(d => Object.assign({}, d));
                         for (const dev of (<any[]>nSubFamily.device)) {
                             if (dev.compile) {
                                 dev.compile = (<any[]>dev.compile).filter((obj) => {
@@ -686,6 +683,33 @@ export class PackageManager {
 
         pdscFile = fList[0];
 
+        // use the pack index if it's up to date, or make it from the '.pdsc' file
+        let packInfo: PackInfo;
+        const span = Tracer.span('PackageManager.LoadPackage', 'pack', () => ({ pdsc: pdscFile.name }));
+        const index = PackIndex.load(pdscFile.path);
+        if (index) {
+            packInfo = <PackInfo>index.toPackInfo();
+        } else {
+            packInfo = this.parsePackDescription(pdscFile);
+            try {
+                PackIndex.fromPackInfo(pdscFile.path, packInfo).save();
+            } catch (error) {
+                GlobalEvent.log_warn(<Error>error);
+            }
+        }
+        span.end(() => ({ cached: index != undefined }));
+
+        this.packList.push(packInfo);
+        this.currentPackDir = packDir;
+
+        //Clear Current Device
+        this.ChangeCurrentDevice();
+
+        this.emit('packageChanged');
+    }
+
+    private parsePackDescription(pdscFile: File): PackInfo {
+
         let doc: any = this.xmlParser.xml2js(pdscFile.Read());
         let pack = doc.package;
         let packInfo: PackInfo = {
@@ -700,6 +724,22 @@ export class PackageManager {
         let _svdPath: string | undefined;
         let _endianMode: string | undefined;
 
+        const getAlgorithms = (obj: any): DeviceFlashAlgorithm[] => {
+            if (obj.algorithm == undefined)
+                return [];
+            const list: any[] = Array.isArray(obj.algorithm) ? obj.algorithm : [obj.algorithm];
+            return list
+                .filter((algo) => algo.$name && algo.$start && algo.$size)
+                .map((algo) => {
+                    return {
+                        path: this.ToAbsolutePath(pdscFile, algo.$name),
+                        start: algo.$start,
+                        size: algo.$size,
+                        default: algo.$default === '1' || algo.$default === 'true'
+                    };
+                });
+        };
+
         const setDevDefine = (obj: any) => {
             for (let def of (<any[]>obj.compile)) {
                 if (def.$define) {
@@ -726,6 +766,8 @@ export class PackageManager {
                 _svdPath = this.ToAbsolutePath(pdscFile, family.debug.$svd);
             }
 
+            const familyAlgorithms = getAlgorithms(family);
+
             let _famliy: DeviceFamily = {
                 name: family.$Dfamily,
                 vendor: family.$Dvendor,
@@ -777,6 +819,8 @@ export class PackageManager {
                         this.parseMemory(subFamily.memory, ramList, romList);
                     }
 
+                    const subFamilyAlgorithms = getAlgorithms(subFamily).concat(familyAlgorithms);
+
                     let deviceList = subFamily.device;
 
                     // merge variant device
@@ -786,34 +830,24 @@ export class PackageManager {
                             if (dev.variant) {
                                 for (const variant of dev.variant) {
 
+                                    // the xml objects are only read later, so they are shared, not cloned
                                     const _nVariant = {
                                         $Dname: variant.$Dvariant,
                                         $DClassName: dev.$Dname,
-                                        compile: dev.compile ? JSON.parse(JSON.stringify(dev.compile)) : undefined,
-                                        debug: dev.debug ? JSON.parse(JSON.stringify(dev.debug)) : undefined,
-                                        memory: dev.memory ? JSON.parse(JSON.stringify(dev.memory)) : undefined
+                                        compile: dev.compile,
+                                        debug: variant.debug || dev.debug,
+                                        memory: dev.memory,
+                                        algorithm: variant.algorithm || dev.algorithm
                                     };
 
-                                    if (variant.debug) {
-                                        _nVariant.debug = JSON.parse(JSON.stringify(variant.debug));
-                                    }
-
                                     if (variant.compile) {
-                                        if (_nVariant.compile) {
-                                            _nVariant.compile = _nVariant.compile
-                                                .concat(JSON.parse(JSON.stringify(variant.compile)));
-                                        } else {
-                                            _nVariant.compile = JSON.parse(JSON.stringify(variant.compile));
-                                        }
+                                        _nVariant.compile = _nVariant.compile
+                                            ? _nVariant.compile.concat(variant.compile) : variant.compile;
                                     }
 
                                     if (variant.memory) {
-                                        if (_nVariant.memory) {
-                                            _nVariant.memory = _nVariant.memory
-                                                .concat(JSON.parse(JSON.stringify(variant.memory)));
-                                        } else {
-                                            _nVariant.memory = JSON.parse(JSON.stringify(variant.memory));
-                                        }
+                                        _nVariant.memory = _nVariant.memory
+                                            ? _nVariant.memory.concat(variant.memory) : variant.memory;
                                     }
 
                                     devices.push(_nVariant);
@@ -852,7 +886,8 @@ export class PackageManager {
                             storageLayout: {
                                 RAM: [],
                                 ROM: []
-                            }
+                            },
+                            flashAlgorithms: getAlgorithms(device).concat(subFamilyAlgorithms)
                         };
 
                         if (dInfo.core === undefined) {
@@ -939,7 +974,8 @@ export class PackageManager {
                         storageLayout: {
                             RAM: [],
                             ROM: []
-                        }
+                        },
+                        flashAlgorithms: getAlgorithms(device).concat(familyAlgorithms)
                     };
 
                     if (dInfo.core === undefined) {
@@ -1154,13 +1190,7 @@ export class PackageManager {
             }
         }
 
-        this.packList.push(packInfo);
-        this.currentPackDir = packDir;
-
-        //Clear Current Device
-        this.ChangeCurrentDevice();
-
-        this.emit('packageChanged');
+        return packInfo;
     }
 
     private ToAbsolutePath(pdscFile: File, path: string): string {
@@ -1182,23 +1212,6 @@ export class PackageManager {
         return undefined;
     }
 
-    FindAllComponents(matchName: string): Component[] | undefined {
-        if (this.packList.length > 0) {
-            return this.packList[0].components.filter((comp) => {
-                if (!comp.enable)
-                    return false
-                // case 1: matchName == 'A' and comp.groupName == 'A'
-                if (comp.groupName === matchName)
-                    return true
-                // case 2: matchName == 'A' and comp.groupName == 'A.B.C'
-                if (comp.groupName.startsWith(matchName + '.'))
-                    return true;
-                return false
-            });
-        }
-        return undefined;
-    }
-
     async Uninstall(packName: string) {
 
         this.ClearAll();
@@ -1231,21 +1244,32 @@ export class PackageManager {
         const outDir = File.fromArray([packDir.path, vender, name]);
         outDir.CreateDir(true);
 
-        this.compress.on('progress', (progress) => {
-            if (reporter) {
-                reporter(progress, `${pack.noSuffixName}`);
+        if (SettingManager.GetInstance().isCmsisPackLazyExtractEnabled() && /\.pack$|\.zip$/i.test(pack.name)) {
+            try {
+                this.installPackLazily(pack, outDir);
+            } catch (error) {
+                GlobalEvent.emit('error', error);
+                GlobalEvent.emit('msg', newMessage('Warning', 'Unzip package error ! ' + (<Error>error).message));
+                return;
             }
-        });
+        } else {
 
-        const err = await this.compress.Unzip(pack, outDir);
-        if (err) {
-            GlobalEvent.emit('error', err);
-            GlobalEvent.emit('msg', {
-                type: 'Warning',
-                contentType: 'string',
-                content: 'Unzip package error ! ' + (<Error>err).message
+            this.compress.on('progress', (progress) => {
+                if (reporter) {
+                    reporter(progress, `${pack.noSuffixName}`);
+                }
             });
-            return;
+
+            const err = await this.compress.Unzip(pack, outDir);
+            if (err) {
+                GlobalEvent.emit('error', err);
+                GlobalEvent.emit('msg', {
+                    type: 'Warning',
+                    contentType: 'string',
+                    content: 'Unzip package error ! ' + (<Error>err).message
+                });
+                return;
+            }
         }
 
         if (reporter) {
@@ -0,0 +1,542 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as net from 'net';
+import * as ChildProcess from 'child_process';
+
+/** the command/response terminator of the OpenOCD TCL RPC protocol */
+const TCL_RPC_EOF = '\x1a';
+
+/** wait time for the server to be ready after it is spawned (ms) */
+const SERVER_START_TIMEOUT = 15 * 1000;
+
+/** timeout of the health check command (ms) */
+const HEALTH_CHECK_TIMEOUT = 2000;
+
+/** timeout of a flash command, the whole chip may be erased and programmed (ms) */
+const COMMAND_TIMEOUT = 5 * 60 * 1000;
+
+/** a session is closed if it is not used in this time (ms), so that the probe is released */
+const SESSION_IDLE_TIMEOUT = 5 * 60 * 1000;
+
+export interface ProbeSessionResult {
+    success: boolean;
+    /** all outputs of the commands */
+    output: string;
+    /** the error message of the failed command */
+    error?: string;
+}
+
+function delay(ms: number): Promise<void> {
+    return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+/**
+ * Get an unused local tcp port
+*/
+export function getFreePort(): Promise<number> {
+    return new Promise((resolve, reject) => {
+        const server = net.createServer();
+        server.unref();
+        server.on('error', reject);
+        server.listen(0, '127.0.0.1', () => {
+            const addr = <net.AddressInfo>server.address();
+            server.close(() => resolve(addr.port));
+        });
+    });
+}
+
+/**
+ * Client of the OpenOCD TCL RPC server (`tcl_port`).
+ *
+ * A command is sent with a trailing `0x1a`, the server replies the result
+ * of the command with a trailing `0x1a`. Commands are executed one by one.
+*/
+export class TclRpcClient {
+
+    private socket: net.Socket | undefined;
+    private buffer = '';
+    private queue: { resolve: (res: string) => void, reject: (err: Error) => void }[] = [];
+    private tail: Promise<any> = Promise.resolve();
+
+    private host: string;
+    private port: number;
+
+    constructor(port: number, host?: string) {
+        this.port = port;
+        this.host = host || '127.0.0.1';
+    }
+
+    get connected(): boolean {
+        return this.socket != undefined && !this.socket.destroyed;
+    }
+
+    connect(timeout: number = 3000): Promise<void> {
+        return new Promise((resolve, reject) => {
+
+            const socket = net.connect(this.port, this.host);
+            const timer = setTimeout(() => {
+                socket.destroy();
+                reject(new Error(`connect to ${this.host}:${this.port} timeout`));
+            }, timeout);
+
+            socket.setEncoding('utf8');
+            socket.setNoDelay(true);
+
+            socket.once('connect', () => {
+                clearTimeout(timer);
+                this.socket = socket;
+                resolve();
+            });
+
+            socket.on('data', (data: string) => this.onData(data));
+
+            socket.on('error', (err) => {
+                clearTimeout(timer);
+                if (this.socket !== socket) reject(err);
+                this.onClose(err);
+            });
+
+            socket.on('close', () => this.onClose(new Error('connection closed')));
+        });
+    }
+
+    /**
+     * Execute a command and get the result
+    */
+    exec(command: string, timeout?: number): Promise<string> {
+        const task = this.tail.then(() => this.send(command, timeout));
+        this.tail = task.catch(() => { /* next command */ });
+        return task;
+    }
+
+    close() {
+        this.socket?.destroy();
+        this.socket = undefined;
+    }
+
+    //---
+
+    private send(command: string, timeout?: number): Promise<string> {
+        return new Promise((resolve, reject) => {
+
+            if (!this.connected) {
+                reject(new Error('not connected'));
+                return;
+            }
+
+            let timer: NodeJS.Timeout | undefined;
+            if (timeout) {
+                timer = setTimeout(() => {
+                    // the response of this command will break the next one, drop the connection
+                    this.close();
+                    this.onClose(new Error(`command timeout: '${command}'`));
+                }, timeout);
+            }
+
+            this.queue.push({
+                resolve: (res) => { if (timer) clearTimeout(timer); resolve(res); },
+                reject: (err) => { if (timer) clearTimeout(timer); reject(err); }
+            });
+
+            (<net.Socket>this.socket).write(command + TCL_RPC_EOF);
+        });
+    }
+
+    private onData(data: string) {
+        this.buffer += data;
+        let idx: number;
+        while ((idx = this.buffer.indexOf(TCL_RPC_EOF)) >= 0) {
+            const res = this.buffer.substr(0, idx);
+            this.buffer = this.buffer.substr(idx + 1);
+            const req = this.queue.shift();
+            if (req) req.resolve(res);
+        }
+    }
+
+    private onClose(err: Error) {
+        this.socket = undefined;
+        this.buffer = '';
+        const pending = this.queue;
+        this.queue = [];
+        pending.forEach(req => req.reject(err));
+    }
+}
+
+/**
+ * A resident debug probe server, the target is connected once
+ * and the commands are sent over the existing connection.
+*/
+export abstract class ProbeServerSession {
+
+    protected proc: ChildProcess.ChildProcess | undefined;
+    protected log: string = '';
+
+    private lock: Promise<any> = Promise.resolve();
+
+    /** if a command is timeout, the server is stopped and the command is failed with an error */
+    commandTimeout: number = COMMAND_TIMEOUT;
+
+    /**
+     * The process is running and the server responds
+    */
+    abstract isHealthy(): Promise<boolean>;
+
+    protected abstract startServer(): Promise<void>;
+
+    protected abstract execCommands(commands: string[]): Promise<ProbeSessionResult>;
+
+    get alive(): boolean {
+        return this.proc != undefined && this.proc.exitCode == null && this.proc.signalCode == null;
+    }
+
+    /**
+     * Run commands in this session, the server is started (or restarted if it died) when needed
+    */
+    run(commands: string[]): Promise<ProbeSessionResult> {
+        const task = this.lock.then(async () => {
+            if (!this.alive || !(await this.isHealthy())) {
+                await this.stop();
+                await this.startServer();
+            }
+            return this.execCommands(commands);
+        });
+        this.lock = task.catch(() => { /* next task */ });
+        return task;
+    }
+
+    /**
+     * Kill the server and wait it exit
+    */
+    stop(): Promise<void> {
+        const proc = this.proc;
+        this.proc = undefined;
+        if (proc == undefined || proc.exitCode != null || proc.signalCode != null)
+            return Promise.resolve();
+        return new Promise((resolve) => {
+            const timer = setTimeout(() => { proc.kill('SIGKILL'); resolve(); }, 3000);
+            proc.once('exit', () => { clearTimeout(timer); resolve(); });
+            proc.kill();
+        });
+    }
+
+    /**
+     * The latest outputs of the server process, for troubleshooting
+    */
+    getServerLog(): string {
+        return this.log;
+    }
+
+    protected spawn(exe: string, args: string[], opts: ChildProcess.SpawnOptions) {
+        this.log = '';
+        const proc = ChildProcess.spawn(exe, args, Object.assign({ windowsHide: true }, opts));
+        const onData = (data: Buffer) => {
+            this.log = (this.log + data.toString()).slice(-64 * 1024);
+        };
+        proc.stdout?.on('data', onData);
+        proc.stderr?.on('data', onData);
+        proc.on('error', (err) => onData(Buffer.from(err.message)));
+        this.proc = proc;
+        return proc;
+    }
+}
+
+/**
+ * OpenOCD session, the commands are sent by the TCL RPC server,
+ * gdb and telnet servers are disabled.
+*/
+export class OpenOCDSession extends ProbeServerSession {
+
+    private client: TclRpcClient | undefined;
+
+    private exe: string;
+    private args: string[];
+    private opts: ChildProcess.SpawnOptions;
+
+    /**
+     * @param args arguments to load the interface and target configs
+    */
+    constructor(exe: string, args: string[], opts?: ChildProcess.SpawnOptions) {
+        super();
+        this.exe = exe;
+        this.args = args;
+        this.opts = opts || {};
+    }
+
+    async isHealthy(): Promise<boolean> {
+        if (this.client == undefined || !this.client.connected)
+            return false;
+        try {
+            await this.client.exec('version', HEALTH_CHECK_TIMEOUT);
+            return true;
+        } catch (error) {
+            return false;
+        }
+    }
+
+    async stop(): Promise<void> {
+        this.client?.close();
+        this.client = undefined;
+        await super.stop();
+    }
+
+    protected async startServer(): Promise<void> {
+
+        const port = await getFreePort();
+        this.spawn(this.exe, this.args.concat(
+            '-c', 'gdb_port disabled',
+            '-c', 'telnet_port disabled',
+            '-c', `tcl_port ${port}`), this.opts);
+
+        // wait the server ready, 'init' is done before the servers are started
+        const deadline = Date.now() + SERVER_START_TIMEOUT;
+        while (Date.now() < deadline) {
+            if (!this.alive)
+                break;
+            const client = new TclRpcClient(port);
+            try {
+                await client.connect(1000);
+                this.client = client;
+                return;
+            } catch (error) {
+                await delay(200);
+            }
+        }
+
+        await this.stop();
+        throw new Error(`start openocd server failed:\n${this.getServerLog()}`);
+    }
+
+    protected async execCommands(commands: string[]): Promise<ProbeSessionResult> {
+
+        const client = <TclRpcClient>this.client;
+        const outputs: string[] = [];
+
+        for (const cmd of commands) {
+            // get the command output and the error status in one request
+            let res: string;
+            try {
+                res = await client.exec(`list [catch {capture {${cmd}}} eide_out] $eide_out`, this.commandTimeout);
+            } catch (error) {
+                // the server is hung or died, drop it, the caller uses the command line flasher
+                await this.stop();
+                throw error;
+            }
+            const m = /^\s*(\d+)\s+([\s\S]*)$/.exec(res);
+            const code = m ? parseInt(m[1]) : 1;
+            const output = m ? unbraceTclString(m[2]) : res;
+            outputs.push(`> ${cmd}`, output);
+            if (code != 0) {
+                return { success: false, output: outputs.join('\n'), error: output.trim() || `command failed: '${cmd}'` };
+            }
+        }
+
+        return { success: true, output: outputs.join('\n') };
+    }
+}
+
+/**
+ * pyOCD session, the commands are sent to a `pyocd commander` REPL by stdin.
+*/
+export class PyOCDCommanderSession extends ProbeServerSession {
+
+    static readonly PROMPT = 'pyocd> ';
+
+    private stdout = '';
+    private stderr = '';
+    private waiter: (() => void) | undefined;
+
+    private exe: string;
+    private args: string[];
+    private opts: ChildProcess.SpawnOptions;
+
+    /**
+     * @param args arguments of 'pyocd commander' (target, probe, config ...)
+    */
+    constructor(exe: string, args: string[], opts?: ChildProcess.SpawnOptions) {
+        super();
+        this.exe = exe;
+        this.args = args;
+        this.opts = opts || {};
+    }
+
+    async isHealthy(): Promise<boolean> {
+        if (!this.alive)
+            return false;
+        try {
+            const r = await this.command('status', HEALTH_CHECK_TIMEOUT);
+            return r.error == undefined;
+        } catch (error) {
+            return false;
+        }
+    }
+
+    protected async startServer(): Promise<void> {
+
+        const proc = this.spawn(this.exe, ['commander'].concat(this.args), Object.assign({}, this.opts, { stdio: 'pipe' }));
+
+        this.stdout = '';
+        this.stderr = '';
+        proc.stdout?.on('data', (data: Buffer) => { this.stdout += data.toString(); this.waiter?.(); });
+        proc.stderr?.on('data', (data: Buffer) => { this.stderr += data.toString(); });
+        proc.on('exit', () => this.waiter?.());
+
+        try {
+            await this.waitPrompt(SERVER_START_TIMEOUT);
+        } catch (error) {
+            await this.stop();
+            throw new Error(`start pyocd commander failed:\n${this.getServerLog()}`);
+        }
+    }
+
+    protected async execCommands(commands: string[]): Promise<ProbeSessionResult> {
+        const outputs: string[] = [];
+        for (const cmd of commands) {
+            let r: { output: string, error?: string };
+            try {
+                r = await this.command(cmd, this.commandTimeout);
+            } catch (error) {
+                await this.stop();
+                throw error;
+            }
+            outputs.push(`> ${cmd}`, r.output);
+            if (r.error != undefined) {
+                return { success: false, output: outputs.join('\n'), error: r.error || `command failed: '${cmd}'` };
+            }
+        }
+        return { success: true, output: outputs.join('\n') };
+    }
+
+    //---
+
+    private async command(cmd: string, timeout?: number): Promise<{ output: string, error?: string }> {
+        this.stdout = '';
+        this.stderr = '';
+        this.proc?.stdin?.write(cmd + '\n');
+        const output = await this.waitPrompt(timeout);
+        // commander reports errors to stderr with a 'Error:' prefix
+        const errLine = this.stderr.split(/\r?\n/).find(l => /^\s*error\b/i.test(l));
+        return { output: output + this.stderr, error: errLine };
+    }
+
+    private waitPrompt(timeout?: number): Promise<string> {
+        return new Promise((resolve, reject) => {
+            let timer: NodeJS.Timeout | undefined;
+            const check = () => {
+                const idx = this.stdout.lastIndexOf(PyOCDCommanderSession.PROMPT);
+                if (idx >= 0) {
+                    const out = this.stdout.substr(0, idx);
+                    this.stdout = '';
+                    done();
+                    resolve(out);
+                } else if (!this.alive) {
+                    done();
+                    reject(new Error('pyocd commander exited'));
+                }
+            };
+            const done = () => {
+                this.waiter = undefined;
+                if (timer) clearTimeout(timer);
+            };
+            if (timeout) {
+                timer = setTimeout(() => { done(); reject(new Error('pyocd commander timeout')); }, timeout);
+            }
+            this.waiter = check;
+            check();
+        });
+    }
+}
+
+/** remove the outer braces of a tcl list element */
+function unbraceTclString(str: string): string {
+    str = str.trim();
+    if (str.startsWith('{') && str.endsWith('}'))
+        return str.substr(1, str.length - 2);
+    return str;
+}
+
+let _instance: ProbeSessionManager | undefined;
+
+/**
+ * Keep one resident session for each probe
+*/
+export class ProbeSessionManager {
+
+    private sessions: Map<string, { session: ProbeServerSession, timer: NodeJS.Timeout | undefined }> = new Map();
+
+    private constructor() {
+        // nothing
+    }
+
+    static instance(): ProbeSessionManager {
+        if (!_instance) { _instance = new ProbeSessionManager(); }
+        return _instance;
+    }
+
+    /**
+     * Run commands in the session of a probe
+     *
+     * @param key identify the probe and the server configs
+     * @param factory create a new session if not exist
+    */
+    async run(key: string, factory: () => ProbeServerSession, commands: string[]): Promise<ProbeSessionResult> {
+
+        let item = this.sessions.get(key);
+        if (item == undefined) {
+            // one probe can be opened by one server only, close the other sessions
+            await this.closeAll();
+            item = { session: factory(), timer: undefined };
+            this.sessions.set(key, item);
+        }
+
+        if (item.timer) clearTimeout(item.timer);
+        try {
+            return await item.session.run(commands);
+        } finally {
+            const it = item;
+            it.timer = setTimeout(() => this.close(key), SESSION_IDLE_TIMEOUT);
+            it.timer.unref?.();
+        }
+    }
+
+    has(key: string): boolean {
+        return this.sessions.has(key);
+    }
+
+    async close(key: string): Promise<void> {
+        const item = this.sessions.get(key);
+        if (item) {
+            this.sessions.delete(key);
+            if (item.timer) clearTimeout(item.timer);
+            await item.session.stop();
+        }
+    }
+
+    /**
+     * Close all sessions to release the probes, for example, before a debug session is started
+    */
+    async closeAll(): Promise<void> {
+        await Promise.all(Array.from(this.sessions.keys()).map(key => this.close(key)));
+    }
+}
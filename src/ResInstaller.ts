@@ -44,6 +44,7 @@ import { ResManager } from './ResManager';
 import * as platform from './Platform';
 import { ExternalUtilToolIndexDef } from './WebInterface/WebInterface';
 import { ExeCmd } from '../lib/node-utility/Executable';
+import { DownloadResult } from './FileDownloader';
 
 let _instance: ResInstaller | undefined;
 
@@ -397,6 +398,9 @@ export class ResInstaller {
             resourceFile = File.fromArray([os.tmpdir(), `${resourceName}.${toolInfo.zip_type || '7z'}`])
         }
 
+        // the package is moved into the artifact cache after it's downloaded
+        const cacheName = `tools/${toolInfo.use_external_index ? toolInfo.url : resourceFile.name}`;
+
         try {
 
             const done = await vscode.window.withProgress({
@@ -405,7 +409,14 @@ export class ResInstaller {
                 cancellable: true
             }, async (progress, token): Promise<boolean> => {
 
-                let res: Buffer | undefined | Error = undefined;
+                // a package downloaded recently (a failed installation), reuse it
+                const cache = ResManager.GetInstance().getCache(cacheName);
+                if (cache && (cache.lastUpdateTime || 0) + utility.TIME_ONE_DAY > Date.now()) {
+                    resourceFile = cache.file;
+                    return true;
+                }
+
+                let res: DownloadResult | undefined | Error = undefined;
 
                 // for built-in tools
                 if (!toolInfo.use_external_index) {
@@ -417,15 +428,15 @@ export class ResInstaller {
 
                     for (const site of this.downloadSites) {
                         const downloadUrl = utility.redirectHost(`${site}/${resourceFile.name}`);
-                        res = await utility.downloadFileWithProgress(downloadUrl, resourceFile.name, progress, token);
-                        if (res instanceof Buffer) { break; } /* if done, exit loop */
+                        res = await utility.downloadFileToDisk(downloadUrl, resourceFile.path, resourceFile.name, progress, token);
+                        if (res && !(res instanceof Error)) { break; } /* if done, exit loop */
                         progress.report({ message: 'Switch to next download site !' });
                     }
                 }
                 // for external tools
                 else {
                     const downloadUrl = utility.redirectHost(toolInfo.url || 'null');
-                    res = await utility.downloadFileWithProgress(downloadUrl, resourceFile.name, progress, token);
+                    res = await utility.downloadFileToDisk(downloadUrl, resourceFile.path, resourceFile.name, progress, token);
                 }
 
                 if (res instanceof Error) { /* download failed */
@@ -435,8 +446,10 @@ export class ResInstaller {
                     return false;
                 }
 
-                /* save to file */
-                fs.writeFileSync(resourceFile.path, res);
+                const newCache = ResManager.GetInstance().addCache({ name: cacheName, lastUpdateTime: Date.now() }, resourceFile);
+                if (newCache) {
+                    resourceFile = newCache.file;
+                }
 
                 return true;
             });
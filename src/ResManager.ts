@@ -41,8 +41,9 @@ import { SettingManager } from "./SettingManager";
 import * as utility from './utility'
 import { CmdLineHandler } from "./CmdLineHandler";
 import * as yaml from 'yaml';
-import { EncodingConverter } from "./EncodingConverter";
 import { jsonc } from "jsonc";
+import { ArtifactStore } from "./ArtifactStore";
+import { toolStamp, uniqueBy } from "./ToolCatalog";
 
 let resManager: ResManager | undefined;
 
@@ -68,7 +69,6 @@ const eideBinariesDirs: { [key: string]: string } = {
 };
 
 const codePage = GetLocalCodePage();
-const cacheName = 'eide.cache';
 
 export interface FileCacheInfo {
     name: string;
@@ -78,6 +78,12 @@ export interface FileCacheInfo {
     lastUpdateTime?: number;
 }
 
+export interface CachedFile extends FileCacheInfo {
+    /** sha256 of the content */
+    hash: string;
+    file: File;
+}
+
 export interface HostInfo {
     host: string;
     port: number;
@@ -93,7 +99,7 @@ export class ResManager extends events.EventEmitter {
     private extension: vscode.Extension<any>;
 
     private devList: CPUInfo[];
-    private cacheInfoList: FileCacheInfo[];
+    private artifactStore: ArtifactStore | undefined;
     private stm8DevList: string[];
 
     private appConfig: any;
@@ -103,7 +109,6 @@ export class ResManager extends events.EventEmitter {
         super();
         this.dirMap = new Map();
         this.iconMap = new Map();
-        this.cacheInfoList = [];
         this.devList = [];
         this.stm8DevList = [];
         this.appConfig = Object.create(null);
@@ -121,16 +126,15 @@ export class ResManager extends events.EventEmitter {
 
         this.InitIcons();
         this.LoadAppConfig();
-        this.loadCache();
 
         /* delay load */
         GlobalEvent.on('extension_launch_done', () => {
-            this.loadJlinkDevList();
+            this.initJlinkDevList();
             this.loadStm8DevList();
         });
     }
     onDispose() {
-        this.saveCache();
+        // nothing todo, the artifact store is saved on every change
     }
 
     static GetInstance(context?: vscode.ExtensionContext): ResManager {
@@ -160,18 +164,6 @@ export class ResManager extends events.EventEmitter {
             || /cmd.exe$/i.test(vscode.env.shell);
     }
 
-    enumSerialPort(): string[] {
-        try {
-            const cmd = utility.generateDotnetProgramCmd(this.getSerialPortExe());
-            const data = ChildProcess.execSync(cmd, { env: process.env });
-            const portList: string[] = JSON.parse(EncodingConverter.trimUtf8BomHeader(data));
-            if (!Array.isArray(portList)) { throw Error("get current port list error !"); }
-            return portList;
-        } catch (error) {
-            throw Error(`enum serialport error !, msg: ${(<Error>error).message}`);
-        }
-    }
-
     getVersion(): string {
         return this.extension.packageJSON['version'];
     }
@@ -191,22 +183,6 @@ export class ResManager extends events.EventEmitter {
         }
     }
 
-    private loadCache() {
-        const cacheFile = new File(this.GetTmpDir().path + File.sep + cacheName);
-        try {
-            if (cacheFile.IsFile()) {
-                this.cacheInfoList = JSON.parse(cacheFile.Read());
-            }
-        } catch (error) {
-            cacheFile.Write('[]');
-        }
-    }
-
-    private saveCache() {
-        const cacheFile = new File(this.GetTmpDir().path + File.sep + cacheName);
-        cacheFile.Write(JSON.stringify(this.cacheInfoList));
-    }
-
     //====================
 
     private LoadAppConfig() {
@@ -252,32 +228,51 @@ export class ResManager extends events.EventEmitter {
 
     //=====================
 
-    getCache(name: string): FileCacheInfo | undefined {
-        const index = this.cacheInfoList.findIndex((val) => { return val.name === name; });
-        if (index !== -1) {
-            return this.cacheInfoList[index];
+    /**
+     * The content-addressed file cache in '~/.eide/cache', it's shared by all projects and vscode windows
+    */
+    getArtifactStore(): ArtifactStore {
+        if (this.artifactStore === undefined) {
+            this.artifactStore = new ArtifactStore(File.fromArray([this.getEideHomeFolder().path, 'cache']).path);
         }
+        this.artifactStore.setMaxSize(SettingManager.GetInstance().getCacheMaxSize());
+        return this.artifactStore;
     }
 
     /**
-     * 按照文件名字，在 /tmp/EIDE 目录下寻找缓存的临时文件
+     * Get a cached file by the name, return undefined if not found or the cache is not available
     */
-    getCachedFileByName(name: string): File {
-        return new File(this.GetTmpDir().path + File.sep + name);
-    }
-
-    addCache(cacheInfo: FileCacheInfo, content?: Buffer | string) {
-        const oldCache = this.getCache(cacheInfo.name);
-        if (oldCache === undefined) {
-            this.cacheInfoList.push(cacheInfo);
-        } else {
-            for (const key in cacheInfo) {
-                (<any>oldCache)[key] = (<any>cacheInfo)[key];
+    getCache(name: string): CachedFile | undefined {
+        try {
+            const res = this.getArtifactStore().resolve(name);
+            if (res) {
+                return { ...res.meta, name: name, size: res.size, hash: res.hash, file: new File(res.path) };
             }
+        } catch (error) {
+            GlobalEvent.log_warn(error);
         }
-        if (content) {
-            const f = this.getCachedFileByName(cacheInfo.name);
-            fs.writeFileSync(f.path, content);
+    }
+
+    /**
+     * Add a file to the cache, the old one with the same name is replaced
+     * @param content the data or a file, the file is moved into the cache
+     * @returns undefined if failed
+    */
+    addCache(cacheInfo: FileCacheInfo, content: Buffer | string | File): CachedFile | undefined {
+
+        const meta: any = { ...cacheInfo };
+        delete meta.name;
+        delete meta.size;
+
+        try {
+            const store = this.getArtifactStore();
+            const opts = { alias: cacheInfo.name, meta: meta };
+            const res = content instanceof File
+                ? store.putFile(content.path, { ...opts, move: true })
+                : store.putData(content, opts);
+            return { ...meta, name: cacheInfo.name, size: res.size, hash: res.hash, file: new File(res.path) };
+        } catch (error) {
+            GlobalEvent.log_warn(error);
         }
     }
 
@@ -531,58 +526,99 @@ export class ResManager extends events.EventEmitter {
         }
     }
 
-    loadJlinkDevList(jlinkDevXmlFile?: File): boolean | undefined {
+    /**
+     * use the cached device list, it's rebuilt in the background if it's too old or the J-Link is changed,
+     * the list of another J-Link version is not used
+    */
+    private initJlinkDevList() {
 
-        /* clear old data */
-        this.devList = [];
+        const catalog = utility.getToolCatalog();
+        const key = this.jlinkDevCatalogKey();
 
-        /* load internal device list */
-        const loadDone = this.loadJlinkInternalDevs();
+        const cached = catalog.lookup<CPUInfo>(key.name, key.stamp);
+        if (cached && cached.stampMatched) {
+            this.devList = cached.items;
+        }
+
+        const task = catalog.refresh<CPUInfo>(key.name, key.stamp, () => this.exportJlinkDevList());
+        if (task) {
+            task.then((devList) => this.devList = devList, () => { /* reported by the catalog */ });
+        }
+    }
+
+    /**
+     * rebuild the device list
+    */
+    async loadJlinkDevList(jlinkDevXmlFile?: File): Promise<boolean | undefined> {
+
+        const key = this.jlinkDevCatalogKey(jlinkDevXmlFile);
 
-        /* load extension device list */
         try {
+            this.devList = await utility.getToolCatalog().rebuild<CPUInfo>(key.name, key.stamp,
+                () => this.exportJlinkDevList(jlinkDevXmlFile));
+            return true;
+        } catch (error) {
+            GlobalEvent.emit('msg', ExceptionToMessage(error, 'Warning'));
+        }
+    }
 
-            const jlinkDefFile = File.fromArray([SettingManager.GetInstance().getJlinkDir(), 'JLinkDevices.xml']);
-            const file = jlinkDevXmlFile || jlinkDefFile;
+    private jlinkDevCatalogKey(jlinkDevXmlFile?: File): { name: string, stamp: string } {
+        const jlinkDevFile = jlinkDevXmlFile || File.fromArray([SettingManager.GetInstance().getJlinkDir(), 'JLinkDevices.xml']);
+        return {
+            name: 'jlink-devices',
+            stamp: toolStamp([SettingManager.instance().getJlinkExePath(), jlinkDevFile.path])
+        };
+    }
 
-            if (file && file.IsFile()) {
-                const parser = new x2js({
-                    arrayAccessFormPaths: ['DataBase.Device', 'Database.Device'],
-                    attributePrefix: '$'
-                });
+    /**
+     * the internal devices of JLinkExe and the devices in 'JLinkDevices.xml'
+    */
+    private async exportJlinkDevList(jlinkDevXmlFile?: File): Promise<CPUInfo[]> {
 
-                const dom = parser.xml2js<any>(file.Read());
+        const devList: CPUInfo[] = [];
 
-                // compat old DataBase version
-                if (dom.DataBase == undefined && dom.Database) {
-                    dom.DataBase = dom.Database;
-                }
+        /* load internal device list */
+        const jlinkExe = SettingManager.instance().getJlinkExePath();
+        const loadDone = await this.loadJlinkInternalDevs(jlinkExe, devList);
+        if (!loadDone && File.IsFile(jlinkExe)) {
+            throw Error(`Failed to export the device list of '${jlinkExe}'`); // keep the old list
+        }
 
-                if (dom.DataBase == undefined || dom.DataBase.Device == undefined) {
-                    throw Error(`'JLinkDevices.xml' format error, not found 'DataBase' or 'DataBase.Device' xml node !, [path]: '${file.path}'`);
-                }
+        /* load extension device list */
+        const jlinkDefFile = File.fromArray([SettingManager.GetInstance().getJlinkDir(), 'JLinkDevices.xml']);
+        const file = jlinkDevXmlFile || jlinkDefFile;
 
-                const jlinkDevList: any[] = dom.DataBase.Device;
-                for (const device of jlinkDevList) {
-                    if (device.ChipInfo) {
-                        const mcuInf = { vendor: device.ChipInfo.$Vendor, cpuName: device.ChipInfo.$Name };
-                        if (this.devList.findIndex((item => item.vendor == mcuInf.vendor && item.cpuName == mcuInf.cpuName)) != -1) continue;
-                        this.devList.push(mcuInf);
-                    }
-                }
+        if (file && file.IsFile()) {
+            const parser = new x2js({
+                arrayAccessFormPaths: ['DataBase.Device', 'Database.Device'],
+                attributePrefix: '$'
+            });
+
+            const dom = parser.xml2js<any>(file.Read());
+
+            // compat old DataBase version
+            if (dom.DataBase == undefined && dom.Database) {
+                dom.DataBase = dom.Database;
             }
 
-            return loadDone;
+            if (dom.DataBase == undefined || dom.DataBase.Device == undefined) {
+                throw Error(`'JLinkDevices.xml' format error, not found 'DataBase' or 'DataBase.Device' xml node !, [path]: '${file.path}'`);
+            }
 
-        } catch (error) {
-            GlobalEvent.emit('msg', ExceptionToMessage(error, 'Warning'));
+            const jlinkDevList: any[] = dom.DataBase.Device;
+            for (const device of jlinkDevList) {
+                if (device.ChipInfo) {
+                    devList.push({ vendor: device.ChipInfo.$Vendor, cpuName: device.ChipInfo.$Name });
+                }
+            }
         }
+
+        return uniqueBy(devList, (dev) => `${dev.vendor}\n${dev.cpuName}`);
     }
 
-    private loadJlinkInternalDevs(): boolean | undefined {
+    private async loadJlinkInternalDevs(jlinkExe: string, devList: CPUInfo[]): Promise<boolean | undefined> {
 
         /* get jlink internal device list */
-        const jlinkExe = SettingManager.instance().getJlinkExePath();
         const timestamp = Date.now();
         const devXmlFile = File.fromArray([os.tmpdir(), `jlink_internal_devices_tmp.${timestamp}.xml`]);
         const jlinkTmpCmdFile = File.fromArray([os.tmpdir(), `jlink_cmds_tmp.${timestamp}.jlink`]);
@@ -592,7 +628,9 @@ export class ResManager extends events.EventEmitter {
 
         /* gen jlink internal device list to file */
         try { fs.unlinkSync(devXmlFile.path) } catch (error) { /* do nothing */ }
-        try { ChildProcess.execSync(cmd) } catch (error) { /* do nothing */ }
+        await new Promise<void>((resolve) => {
+            ChildProcess.exec(cmd, { timeout: 60 * 1000, windowsHide: true }, () => resolve());
+        });
         try { fs.unlinkSync(jlinkTmpCmdFile.path) } catch (error) { /* do nothing */ } // rm tmp file
 
         try {
@@ -640,14 +678,14 @@ export class ResManager extends events.EventEmitter {
                             if (!device.$Name) {
                                 throw new Error('Parser Error on \'DeviceInfo.Name\' at JLinkDevices.xml File');
                             } else {
-                                this.devList.push({
+                                devList.push({
                                     vendor: vendorInfo.$Name,
                                     cpuName: device.$Name,
                                 });
                             }
                         });
                     } else {
-                        this.devList.push({
+                        devList.push({
                             vendor: vendorInfo.$Name,
                             cpuName: dList.$Name
                         });
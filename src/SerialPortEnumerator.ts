@@ -0,0 +1,221 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+import * as NodePath from 'path';
+import * as ChildProcess from 'child_process';
+
+import { ResManager } from './ResManager';
+import { EncodingConverter } from './EncodingConverter';
+import { generateDotnetProgramCmd } from './utility';
+import { osType } from './Platform';
+
+/** cached port list is valid in this time (ms), if hotplug event is not available */
+const CACHE_TTL = 3000;
+
+/** cached port list is valid in this time (ms), when we are watching hotplug event */
+const CACHE_TTL_WATCHED = 60 * 1000;
+
+const SYS_CLASS_TTY = '/sys/class/tty';
+const DEV_SERIAL_BY_ID = '/dev/serial/by-id';
+
+let _instance: SerialPortEnumerator | undefined;
+
+/**
+ * Serial port enumeration service.
+ *
+ * On Linux, the ports are read from sysfs directly, otherwise the `serial_monitor`
+ * helper is spawned asynchronously. The result is cached, and the cache is dropped
+ * when a tty device is added/removed (Linux) or the TTL expired.
+*/
+export class SerialPortEnumerator {
+
+    private cache: string[] | undefined;
+    private cacheTime = 0;
+    private pending: Promise<string[]> | undefined;
+    private watcher: fs.FSWatcher | undefined;
+
+    private constructor() {
+        // nothing
+    }
+
+    static instance(): SerialPortEnumerator {
+        if (!_instance) { _instance = new SerialPortEnumerator(); }
+        return _instance;
+    }
+
+    /**
+     * Whether a command line references any serial port variable:
+     * `${port}`, `${portList}`, `${port[n]}`
+    */
+    static isPortVarReferenced(commandLine: string): boolean {
+        return /\$\{port(?:List|\[\d+\])?\}/i.test(commandLine);
+    }
+
+    /**
+     * Get current serial port list
+     *
+     * @param refresh ignore the cache
+    */
+    async list(refresh?: boolean): Promise<string[]> {
+
+        const ttl = this.watcher ? CACHE_TTL_WATCHED : CACHE_TTL;
+        if (!refresh && this.cache && Date.now() - this.cacheTime < ttl)
+            return this.cache;
+
+        if (this.pending == undefined) {
+            this.pending = this.enumPorts()
+                .then((ports) => {
+                    this.cache = ports;
+                    this.cacheTime = Date.now();
+                    return ports;
+                })
+                .finally(() => this.pending = undefined);
+        }
+
+        return this.pending;
+    }
+
+    invalidate() {
+        this.cache = undefined;
+    }
+
+    dispose() {
+        this.watcher?.close();
+        this.watcher = undefined;
+        this.invalidate();
+    }
+
+    //---
+
+    private async enumPorts(): Promise<string[]> {
+
+        if (osType() == 'linux') {
+            this.watchHotplug();
+            return listLinuxSerialPorts();
+        }
+
+        return this.enumPortsByHelper();
+    }
+
+    private watchHotplug() {
+
+        if (this.watcher)
+            return;
+
+        try {
+            // tty device nodes are created/removed under /dev
+            this.watcher = fs.watch('/dev', { persistent: false }, (_event, fileName) => {
+                if (fileName == undefined || /^(?:tty|rfcomm|serial)/.test(fileName.toString()))
+                    this.invalidate();
+            });
+            this.watcher.on('error', () => {
+                this.watcher?.close();
+                this.watcher = undefined;
+            });
+        } catch (error) {
+            // not support, use the short TTL
+            this.watcher = undefined;
+        }
+    }
+
+    private enumPortsByHelper(): Promise<string[]> {
+        return new Promise((resolve, reject) => {
+            const cmd = generateDotnetProgramCmd(ResManager.instance().getSerialPortExe());
+            ChildProcess.exec(cmd, { env: process.env, encoding: 'buffer', windowsHide: true }, (err, stdout) => {
+                if (err) {
+                    reject(new Error(`enum serialport error !, msg: ${err.message}`));
+                    return;
+                }
+                try {
+                    const portList: string[] = JSON.parse(EncodingConverter.trimUtf8BomHeader(stdout));
+                    if (!Array.isArray(portList)) { throw Error("get current port list error !"); }
+                    resolve(portList);
+                } catch (error) {
+                    reject(new Error(`enum serialport error !, msg: ${(<Error>error).message}`));
+                }
+            });
+        });
+    }
+}
+
+function readLinkName(path: string): string | undefined {
+    try {
+        return NodePath.basename(fs.readlinkSync(path));
+    } catch (error) {
+        return undefined;
+    }
+}
+
+/**
+ * List serial ports from '/sys/class/tty' and '/dev/serial/by-id'.
+ *
+ * A tty is a real serial port only if it has a 'device' link, and the legacy
+ * 8250 ports (ttyS*) are reported only if the uart type is known.
+*/
+export async function listLinuxSerialPorts(): Promise<string[]> {
+
+    const ports = new Set<string>();
+
+    let ttyNames: string[] = [];
+    try {
+        ttyNames = await fs.promises.readdir(SYS_CLASS_TTY);
+    } catch (error) {
+        // no sysfs
+    }
+
+    for (const name of ttyNames) {
+
+        const devDir = NodePath.join(SYS_CLASS_TTY, name, 'device');
+        if (!fs.existsSync(devDir))
+            continue; // virtual terminal
+
+        const subsystem = readLinkName(NodePath.join(devDir, 'subsystem'));
+        if (subsystem == 'platform' || subsystem == 'serial-base' ||
+            readLinkName(NodePath.join(devDir, 'driver')) == 'serial8250') {
+            // legacy uart, 'type' is 0 if no hardware
+            try {
+                const type = (await fs.promises.readFile(NodePath.join(SYS_CLASS_TTY, name, 'type'), 'utf8')).trim();
+                if (type == '' || type == '0')
+                    continue;
+            } catch (error) {
+                continue;
+            }
+        }
+
+        ports.add(`/dev/${name}`);
+    }
+
+    // usb serial devices
+    try {
+        for (const name of await fs.promises.readdir(DEV_SERIAL_BY_ID)) {
+            const realPath = await fs.promises.realpath(NodePath.join(DEV_SERIAL_BY_ID, name));
+            ports.add(realPath);
+        }
+    } catch (error) {
+        // no usb serial device plugged
+    }
+
+    return Array.from(ports).sort((a, b) => a.localeCompare(b, undefined, { numeric: true }));
+}
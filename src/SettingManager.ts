@@ -37,6 +37,7 @@ import { WorkspaceManager } from './WorkspaceManager';
 import { ToolchainName } from './ToolchainManager';
 import { view_str$prompt$needReloadToUpdateEnv, WARNING, view_str$prompt$needReload } from './StringTable';
 import { xpackRequireDevTools } from './XpackDevTools';
+import { Tracer } from './Tracer';
 
 export enum CheckStatus {
     All_Verified,
@@ -94,6 +95,8 @@ export class SettingManager {
         this.eideEnv.set('${userRoot}', userhome());
         this.eideEnv.set('${userHome}', userhome());
 
+        this.syncTracerConfig();
+
         try {
             this.refreshMDKStatus();
             this.refreshC51Status();
@@ -127,6 +130,10 @@ export class SettingManager {
                         Utility.notifyReloadWindow(view_str$prompt$needReload);
                     }
 
+                    if (e.affectsConfiguration('EIDE.Trace')) {
+                        this.syncTracerConfig();
+                    }
+
                     //! 暂时弃用 ccache
                     // // for non-win32 platform, we provide a check when user want to use 'ccache'
                     // if (osType() != 'win32') {
@@ -309,6 +316,11 @@ export class SettingManager {
         return this.getConfiguration().get<boolean>('Option.SilentWhenBuildOrFlash') || false;
     }
 
+    syncTracerConfig() {
+        Tracer.setCapacity(this.getTraceBufferSize());
+        Tracer.enable(this.isTraceEnabled());
+    }
+
     syncGlobalEnvVariablesToNodeEnv() {
         const envs = this.getGlobalEnvVariables();
         for (const key in envs) {
@@ -385,6 +397,46 @@ export class SettingManager {
         return this.getConfiguration().get<string>('Builder.AdditionalCommandLine');
     }
 
+    getSizeBudgets(): { [name: string]: string | number } {
+        return this.getConfiguration().get<{ [name: string]: string | number }>('Builder.SizeBudgets') || {};
+    }
+
+    isSizeHistoryEnabled(): boolean {
+        return this.getConfiguration().get<boolean>('Builder.SizeHistory.Enable') !== false;
+    }
+
+    isCmsisPackLazyExtractEnabled(): boolean {
+        return this.getConfiguration().get<boolean>('ARM.CmsisPack.LazyExtract') === true;
+    }
+
+    isDeltaFlashEnabled(): boolean {
+        return this.getConfiguration().get<boolean>('Flasher.DeltaFlash.Enable') === true;
+    }
+
+    isDeltaFlashFullVerify(): boolean {
+        return this.getConfiguration().get<boolean>('Flasher.DeltaFlash.FullVerify') === true;
+    }
+
+    getDeltaFlashSectorSize(): number {
+        return this.getConfiguration().get<number>('Flasher.DeltaFlash.SectorSize') || 0;
+    }
+
+    isResidentProbeSessionEnabled(): boolean {
+        return this.getConfiguration().get<boolean>('Flasher.ResidentProbeSession') === true;
+    }
+
+    getGangProbeSerials(): string[] {
+        return this.getConfiguration().get<string[]>('Flasher.Gang.ProbeSerials') || [];
+    }
+
+    getGangConcurrency(): number {
+        return this.getConfiguration().get<number>('Flasher.Gang.Concurrency') || 4;
+    }
+
+    getGangRetries(): number {
+        return this.getConfiguration().get<number>('Flasher.Gang.Retries') || 0;
+    }
+
     getMapViewParserDepth(): number {
         return this.getConfiguration().get<number>('Option.MapViewParserDepth') || 0;
     }
@@ -426,6 +478,29 @@ export class SettingManager {
         return this.getConfiguration().get<boolean>('Repository.UseProxy') || false;
     }
 
+    getDownloadSegments(): number {
+        return this.getConfiguration().get<number>('Repository.Download.ParallelSegments') || 1;
+    }
+
+    /**
+     * disk budget of the artifact cache in bytes, 0: no limit
+    */
+    getCacheMaxSize(): number {
+        const size = this.getConfiguration().get<number>('Repository.Cache.MaxSize');
+        return size != undefined ? size * 1024 * 1024 : 4096 * 1024 * 1024;
+    }
+
+    isTraceEnabled(): boolean {
+        return this.getConfiguration().get<boolean>('Trace.Enable') || false;
+    }
+
+    /**
+     * max number of the events kept by the trace recorder
+    */
+    getTraceBufferSize(): number {
+        return this.getConfiguration().get<number>('Trace.BufferSize') || 100000;
+    }
+
     isUseTaskToBuild(): boolean {
         return this.getConfiguration().get<boolean>('Option.UseTaskToBuild') || false;
     }
@@ -0,0 +1,595 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+import * as NodePath from 'path';
+
+import { ElfFile, SHF_ALLOC, SHF_WRITE, SHT_NOBITS } from './ElfReader';
+
+/** file name of the size history database, it's placed in the target output folder */
+export const SIZE_HISTORY_FILE_NAME = 'size_history.json';
+
+/** Max records kept in the history, tagged records are never dropped */
+const HISTORY_MAX_RECORDS = 100;
+
+const HISTORY_VERSION = 1;
+
+/** The symbol fields we need, compatible with `SymbolInfo` of the project */
+export interface SizeSymbolInput {
+    name: string;
+    size: string;
+    type: string;
+    loca: string;
+}
+
+export interface SizeSnapshot {
+    id: number;
+    /** unix time (ms) */
+    time: number;
+    target: string;
+    buildId?: string;
+    /** bytes in flash: sum of all allocated sections which have content */
+    rom: number;
+    /** bytes in ram: sum of all allocated writable sections */
+    ram: number;
+    romLimit?: number;
+    ramLimit?: number;
+    /** section name -> size */
+    sections: { [name: string]: number };
+    /** the sections in ram (writable or no content), the percent budgets of them use 'ramLimit' */
+    ramSections?: string[];
+    /** symbol name -> size */
+    symbols: { [name: string]: number };
+    /** object file -> size (.text + .data + .bss + .rodata), only if the map file can be parsed */
+    objects: { [name: string]: number };
+}
+
+export interface SizeDeltaItem {
+    name: string;
+    old: number;
+    new: number;
+    delta: number;
+}
+
+export interface SizeDiff {
+    base: { id: number, time: number, tag?: string };
+    current: { id: number, time: number, tag?: string };
+    rom: SizeDeltaItem;
+    ram: SizeDeltaItem;
+    romLimit?: number;
+    ramLimit?: number;
+    sections: SizeDeltaItem[];
+    /** top growing symbols */
+    symbols: SizeDeltaItem[];
+    /** top growing objects */
+    objects: SizeDeltaItem[];
+}
+
+/**
+ * Size budgets, key is 'rom', 'ram' or a section name.
+ *
+ * value is a number of bytes, or a string like: '120K', '1M', '0x400' or a
+ * percent of the mcu rom/ram size: '97%'
+*/
+export type SizeBudgets = { [name: string]: string | number };
+
+export interface SizeBudgetViolation {
+    name: string;
+    size: number;
+    budget: number;
+}
+
+//
+// compact on-disk format, symbol and object names are stored only once:
+//   symbols/objects: [nameIdx0, size0, nameIdx1, size1, ...]
+//
+interface SizeRecordData {
+    id: number;
+    time: number;
+    target: string;
+    buildId?: string;
+    rom: number;
+    ram: number;
+    romLimit?: number;
+    ramLimit?: number;
+    sections: { [name: string]: number };
+    ramSections?: string[];
+    symbols: number[];
+    objects: number[];
+}
+
+interface SizeHistoryData {
+    version: number;
+    names: string[];
+    tags: { [tag: string]: number };
+    records: SizeRecordData[];
+}
+
+// ---------------------------------------------------------------------------
+// Snapshot
+// ---------------------------------------------------------------------------
+
+function parseSymbolSize(size: string): number {
+    const s = size.trim();
+    if (/^0x[0-9a-f]+$/i.test(s))
+        return parseInt(s, 16);
+    if (/^\d+$/.test(s))
+        return parseInt(s, 10);
+    return 0;
+}
+
+/**
+ * Make a size snapshot of an elf file.
+ *
+ * @param symbols the result of `parseElfSymbolTable()`, if undefined, the symbols are read from the elf
+ *  (no demangling and source lookup, so it's fast enough to run after every build)
+ * @param objects object sizes from the map file (optional)
+*/
+export function makeSizeSnapshot(elfPath: string, target: string, symbols: SizeSymbolInput[] | undefined,
+    objects?: { [name: string]: number }, limits?: { rom?: number, ram?: number }): SizeSnapshot {
+
+    const snap: SizeSnapshot = {
+        id: 0,
+        time: Date.now(),
+        target: target,
+        rom: 0,
+        ram: 0,
+        romLimit: limits?.rom,
+        ramLimit: limits?.ram,
+        sections: {},
+        ramSections: [],
+        symbols: {},
+        objects: objects || {}
+    };
+
+    const elf = ElfFile.open(elfPath);
+    try {
+        snap.buildId = elf.readBuildId();
+        for (const sec of elf.sections) {
+            if ((sec.flags & SHF_ALLOC) == 0 || sec.size == 0)
+                continue;
+            snap.sections[sec.name] = (snap.sections[sec.name] || 0) + sec.size;
+            if (sec.type != SHT_NOBITS)
+                snap.rom += sec.size;
+            if (sec.flags & SHF_WRITE)
+                snap.ram += sec.size;
+            if (((sec.flags & SHF_WRITE) || sec.type == SHT_NOBITS) && !snap.ramSections!.includes(sec.name))
+                snap.ramSections!.push(sec.name);
+        }
+        if (symbols == undefined) {
+            let file: string | undefined;
+            elf.forEachSymbol((sym) => {
+                if (sym.type == 'FILE') {
+                    file = sym.name ? NodePath.basename(sym.name) : undefined;
+                    return;
+                }
+                if (sym.size <= 0 || sym.name == '' || sym.type == 'SECTION' || sym.name.startsWith('$'))
+                    return;
+                // local symbols may have the same name in different files
+                const name = sym.bind == 'LOCAL' && file ? `${sym.name} (${file})` : sym.name;
+                snap.symbols[name] = (snap.symbols[name] || 0) + sym.size;
+            });
+        }
+    } finally {
+        elf.close();
+    }
+
+    for (const sym of symbols || []) {
+        const size = parseSymbolSize(sym.size);
+        if (size <= 0)
+            continue;
+        // local symbols may have the same name in different files
+        let name = sym.name;
+        if (sym.type.includes('(Local)') && sym.loca && sym.loca != '--')
+            name = `${sym.name} (${NodePath.basename(sym.loca)})`;
+        snap.symbols[name] = (snap.symbols[name] || 0) + size;
+    }
+
+    return snap;
+}
+
+// ---------------------------------------------------------------------------
+// Budgets
+// ---------------------------------------------------------------------------
+
+/**
+ * Parse a budget value to bytes, return undefined if it's invalid
+ *
+ * @param base used by the percent value
+*/
+export function parseSizeBudget(val: string | number, base?: number): number | undefined {
+
+    if (typeof val == 'number')
+        return val >= 0 ? val : undefined;
+
+    const s = val.trim();
+    let m: RegExpMatchArray | null;
+
+    if ((m = /^(\d+(?:\.\d+)?)\s*%$/.exec(s))) {
+        return base != undefined ? Math.floor(base * parseFloat(m[1]) / 100) : undefined;
+    }
+
+    if (/^0x[0-9a-f]+$/i.test(s))
+        return parseInt(s, 16);
+
+    if ((m = /^(\d+(?:\.\d+)?)\s*([KMG]?)i?B?$/i.exec(s))) {
+        const unit: { [k: string]: number } = { '': 1, 'K': 1024, 'M': 1024 * 1024, 'G': 1024 * 1024 * 1024 };
+        return Math.floor(parseFloat(m[1]) * unit[m[2].toUpperCase()]);
+    }
+
+    return undefined;
+}
+
+/**
+ * Check a snapshot with the budgets, return all exceeded items
+*/
+export function checkSizeBudgets(snap: SizeSnapshot, budgets: SizeBudgets): SizeBudgetViolation[] {
+
+    const result: SizeBudgetViolation[] = [];
+
+    for (const name in budgets) {
+
+        let size: number | undefined;
+        let base: number | undefined;
+
+        if (name == 'rom') {
+            size = snap.rom;
+            base = snap.romLimit;
+        } else if (name == 'ram') {
+            size = snap.ram;
+            base = snap.ramLimit;
+        } else {
+            size = snap.sections[name];
+            base = snap.ramSections && snap.ramSections.includes(name) ? snap.ramLimit : snap.romLimit;
+        }
+
+        const budget = parseSizeBudget(budgets[name], base);
+        if (size != undefined && budget != undefined && size > budget)
+            result.push({ name, size, budget });
+    }
+
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// History database
+// ---------------------------------------------------------------------------
+
+/**
+ * Per-target size history, stored as `size_history.json` in the output folder
+*/
+export class SizeHistory {
+
+    private path: string;
+    private data: SizeHistoryData;
+
+    private constructor(path: string, data: SizeHistoryData) {
+        this.path = path;
+        this.data = data;
+    }
+
+    static load(outDir: string): SizeHistory {
+
+        const path = NodePath.join(outDir, SIZE_HISTORY_FILE_NAME);
+
+        try {
+            if (fs.existsSync(path)) {
+                const data = <SizeHistoryData>JSON.parse(fs.readFileSync(path, 'utf8'));
+                if (data.version == HISTORY_VERSION && Array.isArray(data.records))
+                    return new SizeHistory(path, data);
+            }
+        } catch (error) {
+            // broken file, drop it
+        }
+
+        return new SizeHistory(path, { version: HISTORY_VERSION, names: [], tags: {}, records: [] });
+    }
+
+    save() {
+        this.compact();
+        const tmpFile = `${this.path}.${process.pid}.tmp`;
+        fs.writeFileSync(tmpFile, JSON.stringify(this.data));
+        fs.renameSync(tmpFile, this.path);
+    }
+
+    /**
+     * Append a snapshot, return its id
+    */
+    add(snap: SizeSnapshot): number {
+
+        const nameIdx = new Map<string, number>();
+        this.data.names.forEach((n, i) => nameIdx.set(n, i));
+        const pack = (obj: { [name: string]: number }): number[] => {
+            const arr: number[] = [];
+            for (const name in obj) {
+                let idx = nameIdx.get(name);
+                if (idx == undefined) {
+                    idx = this.data.names.push(name) - 1;
+                    nameIdx.set(name, idx);
+                }
+                arr.push(idx, obj[name]);
+            }
+            return arr;
+        };
+
+        const records = this.data.records;
+        const id = records.length > 0 ? records[records.length - 1].id + 1 : 1;
+
+        records.push({
+            id: id,
+            time: snap.time,
+            target: snap.target,
+            buildId: snap.buildId,
+            rom: snap.rom,
+            ram: snap.ram,
+            romLimit: snap.romLimit,
+            ramLimit: snap.ramLimit,
+            sections: snap.sections,
+            ramSections: snap.ramSections,
+            symbols: pack(snap.symbols),
+            objects: pack(snap.objects)
+        });
+
+        // drop the oldest untagged records
+        const tagged = new Set(Object.values(this.data.tags));
+        while (records.length > HISTORY_MAX_RECORDS) {
+            const idx = records.findIndex(r => !tagged.has(r.id));
+            if (idx == -1 || idx == records.length - 1) break;
+            records.splice(idx, 1);
+        }
+
+        return id;
+    }
+
+    /**
+     * Tag a record as a baseline, use the latest record if id is not specified
+    */
+    setTag(tag: string, id?: number): boolean {
+        const rec = id != undefined ? this.data.records.find(r => r.id == id) : this.latestRecord();
+        if (rec == undefined)
+            return false;
+        this.data.tags[tag] = rec.id;
+        return true;
+    }
+
+    getTags(): string[] {
+        return Object.keys(this.data.tags);
+    }
+
+    count(): number {
+        return this.data.records.length;
+    }
+
+    latest(): SizeSnapshot | undefined {
+        const rec = this.latestRecord();
+        return rec ? this.unpack(rec) : undefined;
+    }
+
+    /**
+     * Get a snapshot by a tag name, record id ('#12') or 'previous' (the record before the latest)
+    */
+    find(ref: string): SizeSnapshot | undefined {
+
+        const records = this.data.records;
+
+        if (ref == 'previous')
+            return records.length >= 2 ? this.unpack(records[records.length - 2]) : undefined;
+
+        const tagId = this.data.tags[ref];
+        if (tagId != undefined) {
+            const rec = records.find(r => r.id == tagId);
+            return rec ? this.unpack(rec) : undefined;
+        }
+
+        const m = /^#?(\d+)$/.exec(ref);
+        if (m) {
+            const rec = records.find(r => r.id == parseInt(m[1]));
+            return rec ? this.unpack(rec) : undefined;
+        }
+
+        return undefined;
+    }
+
+    /**
+     * Diff the latest snapshot with a base snapshot
+     *
+     * @param baseRef see `find()`
+     * @param topN max number of symbols/objects in the result
+    */
+    diff(baseRef: string, topN: number = 20): SizeDiff | undefined {
+        const cur = this.latest();
+        const base = this.find(baseRef);
+        if (cur == undefined || base == undefined)
+            return undefined;
+        return diffSizeSnapshot(base, cur, topN, this.getTagName(base.id), this.getTagName(cur.id));
+    }
+
+    //---
+
+    private getTagName(id: number): string | undefined {
+        for (const tag in this.data.tags) {
+            if (this.data.tags[tag] == id)
+                return tag;
+        }
+        return undefined;
+    }
+
+    private latestRecord(): SizeRecordData | undefined {
+        const records = this.data.records;
+        return records.length > 0 ? records[records.length - 1] : undefined;
+    }
+
+    private unpack(rec: SizeRecordData): SizeSnapshot {
+        const names = this.data.names;
+        const unpack = (arr: number[]) => {
+            const obj: { [name: string]: number } = {};
+            for (let i = 0; i + 1 < arr.length; i += 2)
+                obj[names[arr[i]]] = arr[i + 1];
+            return obj;
+        };
+        return {
+            id: rec.id,
+            time: rec.time,
+            target: rec.target,
+            buildId: rec.buildId,
+            rom: rec.rom,
+            ram: rec.ram,
+            romLimit: rec.romLimit,
+            ramLimit: rec.ramLimit,
+            sections: rec.sections,
+            ramSections: rec.ramSections,
+            symbols: unpack(rec.symbols),
+            objects: unpack(rec.objects)
+        };
+    }
+
+    /** drop the unused names, records may be removed */
+    private compact() {
+
+        const used = new Map<number, number>();
+        const names: string[] = [];
+        const remap = (arr: number[]) => {
+            for (let i = 0; i + 1 < arr.length; i += 2) {
+                let idx = used.get(arr[i]);
+                if (idx == undefined) {
+                    idx = names.push(this.data.names[arr[i]]) - 1;
+                    used.set(arr[i], idx);
+                }
+                arr[i] = idx;
+            }
+        };
+
+        for (const rec of this.data.records) {
+            remap(rec.symbols);
+            remap(rec.objects);
+        }
+
+        this.data.names = names;
+
+        for (const tag in this.data.tags) {
+            if (!this.data.records.some(r => r.id == this.data.tags[tag]))
+                delete this.data.tags[tag];
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Diff
+// ---------------------------------------------------------------------------
+
+function diffMap(oldMap: { [name: string]: number }, newMap: { [name: string]: number }): SizeDeltaItem[] {
+
+    const result: SizeDeltaItem[] = [];
+
+    for (const name in newMap) {
+        const o = oldMap[name] || 0;
+        result.push({ name, old: o, new: newMap[name], delta: newMap[name] - o });
+    }
+
+    for (const name in oldMap) {
+        if (newMap[name] == undefined)
+            result.push({ name, old: oldMap[name], new: 0, delta: -oldMap[name] });
+    }
+
+    return result;
+}
+
+function topGrowing(items: SizeDeltaItem[], topN: number): SizeDeltaItem[] {
+    return items
+        .filter(i => i.delta > 0)
+        .sort((a, b) => b.delta - a.delta || (a.name < b.name ? -1 : 1))
+        .slice(0, topN);
+}
+
+export function diffSizeSnapshot(base: SizeSnapshot, cur: SizeSnapshot, topN: number,
+    baseTag?: string, curTag?: string): SizeDiff {
+
+    return {
+        base: { id: base.id, time: base.time, tag: baseTag },
+        current: { id: cur.id, time: cur.time, tag: curTag },
+        rom: { name: 'rom', old: base.rom, new: cur.rom, delta: cur.rom - base.rom },
+        ram: { name: 'ram', old: base.ram, new: cur.ram, delta: cur.ram - base.ram },
+        romLimit: cur.romLimit,
+        ramLimit: cur.ramLimit,
+        sections: diffMap(base.sections, cur.sections)
+            .filter(i => i.delta != 0 || i.new != 0)
+            .sort((a, b) => b.new - a.new),
+        symbols: topGrowing(diffMap(base.symbols, cur.symbols), topN),
+        objects: topGrowing(diffMap(base.objects, cur.objects), topN)
+    };
+}
+
+function fmtDelta(delta: number): string {
+    return (delta >= 0 ? '+' : '') + delta.toString();
+}
+
+function fmtUsage(size: number, limit?: number): string {
+    if (limit == undefined || limit <= 0)
+        return '';
+    return ` (${(size * 100 / limit).toFixed(1)}% of ${limit})`;
+}
+
+function fmtTable(header: string[], rows: string[][]): string[] {
+    const widths = header.map((h, i) => Math.max(h.length, ...rows.map(r => r[i].length)));
+    const fmt = (r: string[]) => r.map((c, i) => i == 0 ? c.padEnd(widths[i]) : c.padStart(widths[i])).join('  ');
+    return [fmt(header), widths.map(w => ''.padEnd(w, '-')).join('  ')].concat(rows.map(fmt));
+}
+
+/**
+ * Format a size diff as a plain text report
+*/
+export function formatSizeDiff(diff: SizeDiff): string {
+
+    const name = (r: { id: number, time: number, tag?: string }) =>
+        `#${r.id}${r.tag ? ` [${r.tag}]` : ''} ${new Date(r.time).toLocaleString()}`;
+
+    const lines: string[] = [];
+    const itemRow = (i: SizeDeltaItem) => [i.name, i.old.toString(), i.new.toString(), fmtDelta(i.delta)];
+
+    lines.push(`Size diff: ${name(diff.base)} -> ${name(diff.current)}`);
+    lines.push('');
+    lines.push(`ROM: ${diff.rom.new} bytes (${fmtDelta(diff.rom.delta)})${fmtUsage(diff.rom.new, diff.romLimit)}`);
+    lines.push(`RAM: ${diff.ram.new} bytes (${fmtDelta(diff.ram.delta)})${fmtUsage(diff.ram.new, diff.ramLimit)}`);
+
+    lines.push('');
+    lines.push(...fmtTable(['Section', 'Old', 'New', 'Delta'], diff.sections.map(itemRow)));
+
+    lines.push('');
+    lines.push(`Top growing symbols:`);
+    lines.push('');
+    if (diff.symbols.length > 0)
+        lines.push(...fmtTable(['Symbol', 'Old', 'New', 'Delta'], diff.symbols.map(itemRow)));
+    else
+        lines.push('  (none)');
+
+    lines.push('');
+    lines.push(`Top growing objects:`);
+    lines.push('');
+    if (diff.objects.length > 0)
+        lines.push(...fmtTable(['Object', 'Old', 'New', 'Delta'], diff.objects.map(itemRow)));
+    else
+        lines.push('  (none)');
+
+    return lines.join('\n') + '\n';
+}
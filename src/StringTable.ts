@@ -489,6 +489,11 @@ export const view_str$add_missed_stubs = [
     'Add missed stubs'
 ][langIndex];
 
+export const view_str$add_retarget_lib = [
+    '添加带缓冲的重定向库 (printf/malloc/clock)',
+    'Add buffered retarget library (printf/malloc/clock)'
+][langIndex];
+
 export const view_str$prompt$migrationFailed = [
     `迁移旧项目失败！路径：{}`,
     `Migrate Old Project Failed ! Path: {}`
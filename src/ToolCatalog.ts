@@ -0,0 +1,326 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+import * as NodePath from 'path';
+
+const CATALOG_VERSION = '1.0';
+
+interface CatalogRecord {
+    stamp: string;
+    time: number;
+    items: any[];
+}
+
+interface CatalogData {
+    version: string;
+    catalogs: { [name: string]: CatalogRecord };
+}
+
+export interface ToolCatalogOptions {
+
+    /** a catalog older than this (ms) is still used, but rebuilt in the background, default: 1 day */
+    maxAge?: number;
+
+    /** called when a background rebuild is failed, the old catalog is kept */
+    onError?: (name: string, error: any) => void;
+}
+
+/**
+ * A persistent cache of the lists which are exported by the external tools
+ * (J-Link devices, pyOCD targets, OpenOCD configs ...).
+ *
+ * A catalog is saved with a stamp of the tool (path, size, mtime of the executable and the data files),
+ * it's rebuilt before it's returned when the stamp is changed, since the list of the old tool is wrong.
+ * A catalog which is only too old is still returned at once and rebuilt in the background,
+ * so the callers only wait for a tool when the catalog is never built or the tool is changed.
+ *
+ * The cache file is shared by all vscode windows like 'CompilerProbeCache'. Failed builds are not cached.
+*/
+export class ToolCatalog {
+
+    private cacheFile: string;
+    private maxAge: number;
+    private onError: ((name: string, error: any) => void) | undefined;
+
+    private data: CatalogData = { version: CATALOG_VERSION, catalogs: {} };
+    private stamp: string = '';
+    private pending: Map<string, Promise<any[]>> = new Map();
+
+    constructor(cacheFile: string, options?: ToolCatalogOptions) {
+        this.cacheFile = cacheFile;
+        this.maxAge = options?.maxAge != undefined ? options.maxAge : 24 * 3600 * 1000;
+        this.onError = options?.onError;
+    }
+
+    /**
+     * The cached items, 'stampMatched' is false if the tool is changed,
+     * 'fresh' is false if the stamp is changed or the catalog is too old
+    */
+    lookup<T>(name: string, stamp: string): { items: T[], stampMatched: boolean, fresh: boolean } | undefined {
+
+        this.reload();
+
+        const record = this.data.catalogs[name];
+        if (record == undefined)
+            return undefined;
+
+        const stampMatched = record.stamp == stamp;
+
+        return {
+            items: record.items,
+            stampMatched: stampMatched,
+            fresh: stampMatched && Date.now() - record.time < this.maxAge
+        };
+    }
+
+    /**
+     * Build a catalog and save it, the same catalog in building is shared by all callers
+    */
+    rebuild<T>(name: string, stamp: string, build: () => Promise<T[]>): Promise<T[]> {
+
+        let task = this.pending.get(name);
+        if (task == undefined) {
+            task = build().then((items) => {
+                this.pending.delete(name);
+                this.put(name, stamp, items);
+                return items;
+            }, (error) => {
+                this.pending.delete(name);
+                throw error;
+            });
+            this.pending.set(name, task);
+        }
+
+        return task;
+    }
+
+    /**
+     * Get a catalog, wait for the build only if it's not cached or the tool is changed
+    */
+    get<T>(name: string, stamp: string, build: () => Promise<T[]>): Promise<T[]> {
+
+        const cached = this.lookup<T>(name, stamp);
+        if (cached == undefined || !cached.stampMatched)
+            return this.rebuild(name, stamp, build);
+
+        if (!cached.fresh)
+            this.rebuildInBackground(name, stamp, build);
+
+        return Promise.resolve(cached.items);
+    }
+
+    /**
+     * Get a catalog synchronously, 'buildSync' is only called if it's not cached or the tool is changed,
+     * a catalog which is too old is rebuilt by 'build' in the background
+    */
+    getSync<T>(name: string, stamp: string, buildSync: () => T[], build: () => Promise<T[]>): T[] {
+
+        const cached = this.lookup<T>(name, stamp);
+        if (cached == undefined || !cached.stampMatched) {
+            const items = buildSync();
+            this.put(name, stamp, items);
+            return items;
+        }
+
+        if (!cached.fresh)
+            this.rebuildInBackground(name, stamp, build);
+
+        return cached.items;
+    }
+
+    /**
+     * Rebuild a catalog in the background if it's stale or not cached, returns the building task
+    */
+    refresh<T>(name: string, stamp: string, build: () => Promise<T[]>): Promise<T[]> | undefined {
+        const cached = this.lookup<T>(name, stamp);
+        if (cached == undefined || !cached.fresh)
+            return this.rebuildInBackground(name, stamp, build);
+    }
+
+    invalidate(name: string) {
+        this.reload();
+        if (this.data.catalogs[name]) {
+            delete this.data.catalogs[name];
+            this.save();
+        }
+    }
+
+    private rebuildInBackground<T>(name: string, stamp: string, build: () => Promise<T[]>): Promise<T[]> {
+        const task = this.rebuild(name, stamp, build);
+        task.catch((error) => {
+            if (this.onError) this.onError(name, error);
+        });
+        return task;
+    }
+
+    private put(name: string, stamp: string, items: any[]) {
+
+        this.reload(); // merge the catalogs of other windows
+
+        this.data.catalogs[name] = {
+            stamp: stamp,
+            time: Date.now(),
+            items: items
+        };
+
+        this.save();
+    }
+
+    private save() {
+        try {
+            fs.mkdirSync(NodePath.dirname(this.cacheFile), { recursive: true });
+            const tmpFile = `${this.cacheFile}.${process.pid}.tmp`;
+            fs.writeFileSync(tmpFile, JSON.stringify(this.data));
+            fs.renameSync(tmpFile, this.cacheFile);
+            this.stamp = cacheFileStamp(this.cacheFile);
+        } catch (error) {
+            // it's only a cache, the catalogs are kept in memory
+        }
+    }
+
+    private reload() {
+
+        const stamp = cacheFileStamp(this.cacheFile);
+        if (stamp == '' || stamp == this.stamp)
+            return;
+
+        try {
+            const data: CatalogData = JSON.parse(fs.readFileSync(this.cacheFile, 'utf8'));
+            if (data.version == CATALOG_VERSION && data.catalogs) {
+                // keep the newer catalogs of this window
+                for (const name in this.data.catalogs) {
+                    const other = data.catalogs[name];
+                    if (other == undefined || other.time < this.data.catalogs[name].time)
+                        data.catalogs[name] = this.data.catalogs[name];
+                }
+                this.data = data;
+            }
+        } catch (error) {
+            // broken file, it's rewritten by the next build
+        }
+
+        this.stamp = stamp;
+    }
+}
+
+function cacheFileStamp(path: string): string {
+    try {
+        const st = fs.statSync(path);
+        return `${st.mtimeMs}:${st.size}:${st.ino}`;
+    } catch (error) {
+        return '';
+    }
+}
+
+/**
+ * The stamp of the tool files (path, size, mtime), a missing file is a part of the stamp too
+*/
+export function toolStamp(paths: (string | undefined)[]): string {
+    return paths.map((path) => {
+        if (!path) return '-';
+        try {
+            const real = fs.realpathSync(path);
+            const st = fs.statSync(real);
+            return `${NodePath.normalize(real)}|${st.size}|${Math.floor(st.mtimeMs)}`;
+        } catch (error) {
+            return `${path}|none`;
+        }
+    }).join(';');
+}
+
+/**
+ * The stamp of a folder and its sub folders (only the first 'depth' levels),
+ * the mtime of a folder is changed when a file is added, removed or renamed in it
+*/
+export function folderStamp(dir: string, depth: number = 1): string {
+
+    const parts: string[] = [];
+
+    const walk = (absDir: string, rel: string, level: number) => {
+        for (const ent of fs.readdirSync(absDir, { withFileTypes: true })) {
+            if (ent.isDirectory()) {
+                const relPath = rel ? `${rel}/${ent.name}` : ent.name;
+                const st = fs.statSync(NodePath.join(absDir, ent.name));
+                parts.push(`${relPath}|${Math.floor(st.mtimeMs)}`);
+                if (level < depth)
+                    walk(NodePath.join(absDir, ent.name), relPath, level + 1);
+            }
+        }
+    };
+
+    try {
+        parts.push(`${NodePath.normalize(dir)}|${Math.floor(fs.statSync(dir).mtimeMs)}`);
+        walk(dir, '', 1);
+    } catch (error) {
+        return `${dir}|none`;
+    }
+
+    return parts.sort().join(';');
+}
+
+/**
+ * Remove the duplicated items, the first one is kept
+*/
+export function uniqueBy<T>(items: Iterable<T>, keyOf: (item: T) => string): T[] {
+
+    const keys = new Set<string>();
+    const result: T[] = [];
+
+    for (const item of items) {
+        const key = keyOf(item);
+        if (!keys.has(key)) {
+            keys.add(key);
+            result.push(item);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * List the files in a folder recursively without blocking, returns the relative paths ('/' separated)
+*/
+export async function scanFiles(dir: string, pattern: RegExp): Promise<string[]> {
+
+    const result: string[] = [];
+
+    const walk = async (absDir: string, rel: string) => {
+        const entries = await fs.promises.readdir(absDir, { withFileTypes: true });
+        const folders: Promise<void>[] = [];
+        for (const ent of entries) {
+            const relPath = rel ? `${rel}/${ent.name}` : ent.name;
+            if (ent.isDirectory()) {
+                folders.push(walk(NodePath.join(absDir, ent.name), relPath));
+            } else if (pattern.test(ent.name)) {
+                result.push(relPath);
+            }
+        }
+        await Promise.all(folders);
+    };
+
+    await walk(dir, '');
+
+    return result.sort();
+}
@@ -1862,7 +1862,8 @@ class AC5 implements IToolchian {
                 }
 
                 const cmd = `armcc ${cmdList.join(' ')} --list_macros -E - <${platform.osGetNullDev()}`;
-                child_process.execSync(cmd, { cwd: armccDir, encoding: 'utf8' })
+                const probe = { kind: 'armcc-macros', compiler: NodePath.join(armccDir, `armcc${platform.exeSuffix()}`), args: cmdList };
+                utility.getCompilerProbeCache().getSync(probe, () => child_process.execSync(cmd, { cwd: armccDir, encoding: 'utf8' }))
                     .trim().split(/\r\n|\n/)
                     .forEach((line) => {
                         const macro = utility.CppMacroParser.parse(line);
@@ -2606,13 +2607,16 @@ class IARARM implements IToolchian {
             if (compilerArgs.length > 0) {
                 // example:
                 //  D:\IAR_ARM\arm\bin\iccarm.exe --cpu=Cortex-M3 --thumb --predef_macros "C:\Users\Administrator\Desktop\tmp.txt"
-                const tmpCfile = File.from(os.tmpdir(),  `foo_${this.randomPlaceholder}.c`);
-                tmpCfile.Write('int foo(int a) { return a * a; }');
-                const predefsfile = File.from(os.tmpdir(), `foo_${this.randomPlaceholder}.defs`);
-                const cmdArgs = compilerArgs.concat(['--predef_macros', predefsfile.path, tmpCfile.path]);
                 const iccarm = File.from(this.getToolchainDir().path, 'bin', `iccarm${platform.exeSuffix()}`).path;
-                child_process.execFileSync(iccarm, cmdArgs, { cwd: tmpCfile.dir });
-                const outputs = predefsfile.Read().split(/\r\n|\n/);
+                const probe = { kind: 'iar-predef-macros', compiler: iccarm, args: compilerArgs };
+                const outputs = utility.getCompilerProbeCache().getSync(probe, () => {
+                    const tmpCfile = File.from(os.tmpdir(),  `foo_${this.randomPlaceholder}.c`);
+                    tmpCfile.Write('int foo(int a) { return a * a; }');
+                    const predefsfile = File.from(os.tmpdir(), `foo_${this.randomPlaceholder}.defs`);
+                    const cmdArgs = compilerArgs.concat(['--predef_macros', predefsfile.path, tmpCfile.path]);
+                    child_process.execFileSync(iccarm, cmdArgs, { cwd: tmpCfile.dir });
+                    return predefsfile.Read();
+                }).split(/\r\n|\n/);
                 const results: utility.CppMacroDefine[] = [];
                 outputs.filter((line) => { return line.trim() !== ''; })
                     .forEach((line) => {
@@ -0,0 +1,265 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import { performance } from 'perf_hooks';
+
+export type TraceArgs = { [name: string]: string | number | boolean | undefined };
+
+/** the args or a function to make them, the function is only called when the tracer is enabled */
+export type LazyTraceArgs = TraceArgs | (() => TraceArgs);
+
+export interface TraceSpan {
+    end(args?: LazyTraceArgs): void;
+}
+
+const KIND_COMPLETE = 0;
+const KIND_ASYNC = 1;
+const KIND_COUNTER = 2;
+const KIND_INSTANT = 3;
+
+const noopSpan: TraceSpan = { end: () => { } };
+
+function resolveArgs(args: LazyTraceArgs | undefined): TraceArgs | undefined {
+    return typeof args === 'function' ? args() : args;
+}
+
+class ActiveSpan implements TraceSpan {
+
+    private done = false;
+
+    constructor(
+        private readonly recorder: TraceRecorder,
+        private readonly kind: number,
+        private readonly name: string,
+        private readonly cat: string,
+        private readonly start: number,
+        private readonly args: TraceArgs | undefined
+    ) {
+    }
+
+    end(lazyArgs?: LazyTraceArgs) {
+        if (this.done) return;
+        this.done = true;
+        const args = this.recorder.enabled ? resolveArgs(lazyArgs) : undefined;
+        const merged = args ? (this.args ? Object.assign({}, this.args, args) : args) : this.args;
+        this.recorder.record(this.kind, this.name, this.cat, this.start, this.recorder.now() - this.start, merged);
+    }
+}
+
+/**
+ * A low overhead recorder of the spans and counters on the hot paths,
+ * the events are kept in a ring buffer, the oldest ones are overwritten.
+ *
+ * When it's disabled, every api is only a flag check, and the buffer is not allocated.
+ * The events can be exported as a Chrome trace (chrome://tracing, https://ui.perfetto.dev).
+*/
+export class TraceRecorder {
+
+    private _enabled = false;
+
+    private capacity = 0;
+    private kinds = new Uint8Array(0);
+    private times = new Float64Array(0);    // start time (us)
+    private values = new Float64Array(0);   // duration (us) or counter value
+    private ids = new Uint32Array(0);       // id of the async spans
+    private names: string[] = [];
+    private cats: string[] = [];
+    private args: (TraceArgs | undefined)[] = [];
+
+    private next = 0;
+    private size = 0;
+    private overwritten = 0;
+    private asyncId = 0;
+
+    constructor(capacity: number = 65536) {
+        this.capacity = Math.max(16, Math.floor(capacity));
+    }
+
+    get enabled(): boolean {
+        return this._enabled;
+    }
+
+    /** the ring buffer is allocated when it's enabled, and freed (with the events) when it's disabled */
+    enable(enabled: boolean) {
+        if (enabled === this._enabled) return;
+        this._enabled = enabled;
+        this.allocate(enabled ? this.capacity : 0);
+    }
+
+    /** change the size of the ring buffer, the recorded events are dropped */
+    setCapacity(capacity: number) {
+        capacity = Math.max(16, Math.floor(capacity));
+        if (capacity === this.capacity) return;
+        this.capacity = capacity;
+        if (this._enabled) this.allocate(capacity);
+    }
+
+    private allocate(size: number) {
+        this.kinds = new Uint8Array(size);
+        this.times = new Float64Array(size);
+        this.values = new Float64Array(size);
+        this.ids = new Uint32Array(size);
+        this.names = new Array<string>(size).fill('');
+        this.cats = new Array<string>(size).fill('');
+        this.args = new Array<TraceArgs | undefined>(size).fill(undefined);
+        this.clear();
+    }
+
+    clear() {
+        this.next = 0;
+        this.size = 0;
+        this.overwritten = 0;
+        this.args.fill(undefined);
+    }
+
+    /** number of the events in the buffer */
+    count(): number {
+        return this.size;
+    }
+
+    /** microseconds */
+    now(): number {
+        return performance.now() * 1000;
+    }
+
+    /**
+     * Start a span, it's recorded when 'end()' is called.
+     * The spans on the same call stack must be nested, use 'asyncSpan()' for the overlapped ones.
+    */
+    span(name: string, cat: string = 'eide', args?: LazyTraceArgs): TraceSpan {
+        if (!this._enabled) return noopSpan;
+        return new ActiveSpan(this, KIND_COMPLETE, name, cat, this.now(), resolveArgs(args));
+    }
+
+    /**
+     * Start a span which may overlap other spans (async operations)
+    */
+    asyncSpan(name: string, cat: string = 'eide', args?: LazyTraceArgs): TraceSpan {
+        if (!this._enabled) return noopSpan;
+        return new ActiveSpan(this, KIND_ASYNC, name, cat, this.now(), resolveArgs(args));
+    }
+
+    trace<T>(name: string, cat: string, func: () => T, args?: LazyTraceArgs): T {
+        if (!this._enabled) return func();
+        const span = this.span(name, cat, args);
+        try {
+            return func();
+        } finally {
+            span.end();
+        }
+    }
+
+    async traceAsync<T>(name: string, cat: string, func: () => Promise<T>, args?: LazyTraceArgs): Promise<T> {
+        if (!this._enabled) return func();
+        const span = this.asyncSpan(name, cat, args);
+        try {
+            return await func();
+        } finally {
+            span.end();
+        }
+    }
+
+    counter(name: string, value: number, cat: string = 'eide') {
+        if (!this._enabled) return;
+        this.record(KIND_COUNTER, name, cat, this.now(), value, undefined);
+    }
+
+    instant(name: string, cat: string = 'eide', args?: LazyTraceArgs) {
+        if (!this._enabled) return;
+        this.record(KIND_INSTANT, name, cat, this.now(), 0, resolveArgs(args));
+    }
+
+    /** @note internal, used by the spans */
+    record(kind: number, name: string, cat: string, time: number, value: number, args: TraceArgs | undefined) {
+        if (!this._enabled) return; // the span is ended after the recorder is disabled
+        const i = this.next;
+        this.kinds[i] = kind;
+        this.times[i] = time;
+        this.values[i] = value;
+        this.ids[i] = kind === KIND_ASYNC ? ++this.asyncId : 0;
+        this.names[i] = name;
+        this.cats[i] = cat;
+        this.args[i] = args;
+        this.next = (i + 1) % this.capacity;
+        if (this.size < this.capacity) {
+            this.size++;
+        } else {
+            this.overwritten++;
+        }
+    }
+
+    /**
+     * Export the events in the Chrome trace event format
+    */
+    toChromeTrace(): { traceEvents: any[], displayTimeUnit: string, otherData: { [key: string]: any } } {
+
+        const pid = process.pid;
+        const tid = 1;
+        const origin = performance.timeOrigin * 1000;
+        const events: any[] = [];
+
+        const start = (this.next - this.size + this.capacity) % this.capacity;
+        for (let n = 0; n < this.size; n++) {
+            const i = (start + n) % this.capacity;
+            const ts = origin + this.times[i];
+            const base: any = { name: this.names[i], cat: this.cats[i], pid, tid, ts };
+            switch (this.kinds[i]) {
+                case KIND_COMPLETE:
+                    events.push(Object.assign(base, { ph: 'X', dur: this.values[i], args: this.args[i] || {} }));
+                    break;
+                case KIND_ASYNC: {
+                    const id = '0x' + this.ids[i].toString(16);
+                    events.push(Object.assign(base, { ph: 'b', id, args: this.args[i] || {} }));
+                    events.push({ name: this.names[i], cat: this.cats[i], pid, tid, ts: ts + this.values[i], ph: 'e', id });
+                    break;
+                }
+                case KIND_COUNTER:
+                    events.push(Object.assign(base, { ph: 'C', args: { [this.names[i]]: this.values[i] } }));
+                    break;
+                default:
+                    events.push(Object.assign(base, { ph: 'i', s: 't', args: this.args[i] || {} }));
+                    break;
+            }
+        }
+
+        events.sort((a, b) => a.ts - b.ts);
+
+        events.unshift(
+            { name: 'process_name', ph: 'M', pid, tid, args: { name: 'eide' } },
+            { name: 'thread_name', ph: 'M', pid, tid, args: { name: 'extension host' } }
+        );
+
+        return {
+            traceEvents: events,
+            displayTimeUnit: 'ms',
+            otherData: {
+                capacity: this.capacity,
+                overwritten: this.overwritten
+            }
+        };
+    }
+}
+
+/** the recorder of the extension, enabled by 'EIDE.Trace.Enable' */
+export const Tracer = new TraceRecorder();
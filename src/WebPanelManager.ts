@@ -47,6 +47,7 @@ import * as fs from 'fs';
 import { EncodingConverter } from "./EncodingConverter";
 import { SimpleUIConfig } from "./SimpleUIDef";
 import { newMessage, ExceptionToMessage } from "./Message";
+import { DisassemblyProvider } from "./DisassemblyProvider";
 import * as jsonc_parser from 'jsonc-parser';
 
 let _instance: WebPanelManager;
@@ -352,12 +353,16 @@ export class WebPanelManager {
             fileContUtf8Buf = EncodingConverter.toUtf8Code(fileContUtf8Buf, fencoding);
         }
 
-        const lines = fileContUtf8Buf.toString().split(/\r\n|\n/);
+        // prefer the content of the editor if the file is opened
+        const openedDoc = vscode.workspace.textDocuments.find((doc) => doc.uri.fsPath == uri.fsPath);
+        const lines = (openedDoc ? openedDoc.getText() : fileContUtf8Buf.toString()).split(/\r\n|\n/);
 
+        let cmsisDoc: CmsisConfigParser.CmsisConfigDocument;
         let cmsisConfig: CmsisConfigParser.CmsisConfiguration | undefined;
 
         try {
-            cmsisConfig = CmsisConfigParser.parse(lines);
+            cmsisDoc = new CmsisConfigParser.CmsisConfigDocument(lines);
+            cmsisConfig = cmsisDoc.getConfiguration();
         } catch (error) {
             GlobalEvent.log_error(error);
             return; // parse error
@@ -390,15 +395,51 @@ export class WebPanelManager {
         // init panel data
         panel.iconPath = vscode.Uri.parse(resManager.GetIconByName('Property_16x.svg').ToUri());
 
-        /* prepare page-init event data */
-        const initMsg = {
-            data: cmsisConfig,
-            lines: lines,
+        let launched = false;
+
+        /* post the changes of the header, the view only patches the changed items */
+        const postUpdate = (update: CmsisConfigParser.CmsisConfigUpdate | undefined) => {
+            if (update == undefined || !launched) return;
+            if (update.reset) {
+                panel.webview.postMessage({ data: cmsisDoc.getConfiguration() || { items: [] }, lines: cmsisDoc.getLines() });
+            } else {
+                panel.webview.postMessage({ update: update });
+            }
         };
 
+        const docWatcher = vscode.workspace.onDidChangeTextDocument((e) => {
+
+            if (e.document.uri.fsPath != uri.fsPath || e.contentChanges.length == 0)
+                return;
+
+            try {
+                const doc = e.document;
+
+                if (e.contentChanges.length == 1) {
+                    const change = e.contentChanges[0];
+                    const start = change.range.start.line;
+                    const deleteCount = change.range.end.line - start + 1;
+                    const addCount = change.text.split(/\r\n|\n/).length;
+                    // the line count must match, otherwise the view is out of sync (e.g. reloaded after saving)
+                    if (cmsisDoc.getLines().length - deleteCount + addCount == doc.lineCount) {
+                        const newLines: string[] = [];
+                        for (let i = start; i < start + addCount; i++)
+                            newLines.push(doc.lineAt(i).text);
+                        postUpdate(cmsisDoc.applyChange(start, deleteCount, newLines));
+                        return;
+                    }
+                }
+
+                postUpdate(cmsisDoc.setLines(doc.getText().split(/\r\n|\n/)));
+            } catch (error) {
+                GlobalEvent.log_error(error);
+            }
+        });
+
         panel.onDidDispose(() => {
             console.log(`[eide] onDidDispose CmsisConfigWizard for ${uri.fsPath}`);
             this.cmsisHeaderViewRef.delete(uri.fsPath);
+            docWatcher.dispose();
         });
 
         panel.webview.onDidReceiveMessage((data) => {
@@ -412,7 +453,8 @@ export class WebPanelManager {
                         break;
                     /* post page-init event */
                     case 'eide.cmsis_config_wizard.launched':
-                        panel.webview.postMessage(initMsg);
+                        launched = true;
+                        panel.webview.postMessage({ data: cmsisDoc.getConfiguration() || { items: [] }, lines: cmsisDoc.getLines() });
                         break;
                     default:
                         break;
@@ -462,6 +504,14 @@ export class WebPanelManager {
                 }
 
                 panel.webview.postMessage({ status: status });
+
+                if (status.success) {
+                    try {
+                        postUpdate(cmsisDoc.setLines(data));
+                    } catch (error) {
+                        GlobalEvent.log_error(error);
+                    }
+                }
             }
         });
 
@@ -512,13 +562,36 @@ export class WebPanelManager {
             });
         };
 
+        const showDisassembly = async (addr: string) => {
+            try {
+                await DisassemblyProvider.instance().showSymbol(project, project.getExecutablePath(), addr);
+            } catch (error) {
+                GlobalEvent.emit('msg', ExceptionToMessage(error, 'Warning'));
+            }
+        };
+
         webviewPanel.iconPath = vscode.Uri.file(ResManager.GetInstance().GetIconByName('Table_16x.svg').path);
         webviewPanel.webview.html = htmlTemplate.Read().replace('$SYMBOL_TABLE', JSON.stringify(symbols));
         webviewPanel.webview.onDidReceiveMessage(async (_message: any) => {
             const msg: {id: string, data: any} = <any>_message;
             if (msg.id === 'symbol.gotoDefinition') {
-                const inf = <{abspath: string, line?: number}>msg.data;
-                showTextDocumentAtLine(inf.abspath, inf.line);
+                const inf = <{abspath: string, line?: number, addr?: string}>msg.data;
+                // the symbol table has no line info, resolve it now
+                if (inf.line === undefined && inf.addr) {
+                    const loc = await project.resolveSymbolLocation(inf.addr);
+                    if (loc && File.IsFile(loc.path)) {
+                        showTextDocumentAtLine(loc.path, loc.line);
+                        return;
+                    }
+                }
+                if (File.IsFile(inf.abspath))
+                    showTextDocumentAtLine(inf.abspath, inf.line);
+                else
+                    GlobalEvent.emit('msg', newMessage('Info', `No source location of the symbol: '${inf.abspath}'`));
+            }
+            else if (msg.id === 'symbol.showDisassembly') {
+                const inf = <{addr: string}>msg.data;
+                showDisassembly(inf.addr);
             }
         });
 
@@ -585,6 +658,14 @@ export class WebPanelManager {
                 if (File.IsFile(fspath))
                     gotoDefinition(fspath, inf.line ?? 0, inf.column ?? 0);
             }
+            else if (msg.id === 'callgraph.showDisassembly') {
+                const inf = <{symbol: string}>msg.data;
+                try {
+                    await DisassemblyProvider.instance().showSymbol(project, project.getExecutablePath(), inf.symbol);
+                } catch (error) {
+                    GlobalEvent.emit('msg', ExceptionToMessage(error, 'Warning'));
+                }
+            }
             else if (msg.id === 'eide.callgraph_view.launched') {
                 webviewPanel.webview.postMessage({ id: 'eide.callgraph_view.init', data: dataJson });
             }
@@ -0,0 +1,416 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+
+//
+// A streaming xml reader for the project importers.
+//
+// The file is read by chunks and tokenized incrementally, the whole text is never held in memory,
+// the unwanted sub trees can be dropped while reading ('skip' option).
+// The result has the same layout as the 'xml2js' or 'x2js' packages, so the parsers which are
+// written for them can use it directly.
+//
+
+export interface XmlAttributes {
+    [name: string]: string;
+}
+
+export interface XmlStreamHandler {
+    onOpenTag(name: string, attrs: XmlAttributes, selfClosing: boolean): void;
+    onCloseTag(name: string): void;
+    onText(text: string): void;
+}
+
+const XML_ENTITIES: { [name: string]: string } = {
+    'amp': '&', 'lt': '<', 'gt': '>', 'quot': '"', 'apos': '\''
+};
+
+export function decodeXmlEntities(text: string): string {
+    if (!text.includes('&')) return text;
+    return text.replace(/&(#x[0-9a-fA-F]+|#[0-9]+|[a-zA-Z]+);/g, (m, name: string) => {
+        if (name.charAt(0) == '#') {
+            const code = name.charAt(1) == 'x' || name.charAt(1) == 'X'
+                ? parseInt(name.substr(2), 16) : parseInt(name.substr(1), 10);
+            return isNaN(code) ? m : String.fromCodePoint(code);
+        }
+        return XML_ENTITIES[name] != undefined ? XML_ENTITIES[name] : m;
+    });
+}
+
+/**
+ * An incremental xml tokenizer, the text can be split at any position
+*/
+export class XmlTokenizer {
+
+    private buf = '';
+    private pos = 0;
+    private started = false;
+
+    constructor(private handler: XmlStreamHandler) {
+    }
+
+    write(chunk: string) {
+
+        if (!this.started) {
+            this.started = true;
+            if (chunk.charCodeAt(0) == 0xFEFF) // BOM
+                chunk = chunk.substr(1);
+        }
+
+        this.buf = this.pos < this.buf.length ? this.buf.substr(this.pos) + chunk : chunk;
+        this.pos = 0;
+
+        while (this.next()) { /* parse all complete tokens */ }
+    }
+
+    end() {
+        const text = this.buf.substr(this.pos);
+        if (text.includes('<'))
+            throw new Error(`Unexpected end of xml: '${text.substr(0, 32)}'`);
+        if (text.trim() != '')
+            this.handler.onText(decodeXmlEntities(text));
+        this.buf = '';
+        this.pos = 0;
+    }
+
+    /**
+     * parse a token, returns false if more data is needed,
+     * an incomplete token has no terminator in the buffer, so it's always waited
+    */
+    private next(): boolean {
+
+        const buf = this.buf;
+        const lt = buf.indexOf('<', this.pos);
+
+        if (lt == -1) {
+            // hold the text until the next tag, an entity may be split
+            return false;
+        }
+
+        if (lt > this.pos) {
+            this.handler.onText(decodeXmlEntities(buf.substring(this.pos, lt)));
+            this.pos = lt;
+        }
+
+        if (buf.startsWith('<!--', lt)) {
+            const end = buf.indexOf('-->', lt + 4);
+            if (end == -1) return false;
+            this.pos = end + 3;
+            return true;
+        }
+
+        if (buf.startsWith('<![CDATA[', lt)) {
+            const end = buf.indexOf(']]>', lt + 9);
+            if (end == -1) return false;
+            this.handler.onText(buf.substring(lt + 9, end));
+            this.pos = end + 3;
+            return true;
+        }
+
+        if (buf.startsWith('<?', lt)) {
+            const end = buf.indexOf('?>', lt + 2);
+            if (end == -1) return false;
+            this.pos = end + 2;
+            return true;
+        }
+
+        if (buf.startsWith('<!', lt)) { // <!DOCTYPE ...>, with an optional internal subset
+            const gt = buf.indexOf('>', lt);
+            if (gt == -1) return false;
+            const bracket = buf.indexOf('[', lt);
+            if (bracket != -1 && bracket < gt) {
+                const end = buf.indexOf(']>', bracket);
+                if (end == -1) return false;
+                this.pos = end + 2;
+            } else {
+                this.pos = gt + 1;
+            }
+            return true;
+        }
+
+        // find the end of the tag, '>' in the attribute values is skipped
+        let quote = '';
+        let gt = -1;
+        for (let i = lt + 1; i < buf.length; i++) {
+            const c = buf.charAt(i);
+            if (quote) {
+                if (c == quote) quote = '';
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '>') {
+                gt = i;
+                break;
+            }
+        }
+
+        if (gt == -1) return false;
+
+        this.pos = gt + 1;
+
+        if (buf.charAt(lt + 1) == '/') {
+            this.handler.onCloseTag(buf.substring(lt + 2, gt).trim());
+            return true;
+        }
+
+        const selfClosing = buf.charAt(gt - 1) == '/';
+        const body = buf.substring(lt + 1, selfClosing ? gt - 1 : gt);
+        const m = /^[^\s\/>]+/.exec(body);
+        if (!m)
+            throw new Error(`Invalid xml tag: '${buf.substring(lt, gt + 1).substr(0, 64)}'`);
+
+        const attrs: XmlAttributes = {};
+        const attrMatcher = /([^\s=]+)\s*=\s*(?:"([^"]*)"|'([^']*)')/g;
+        attrMatcher.lastIndex = m[0].length;
+        let a: RegExpExecArray | null;
+        while ((a = attrMatcher.exec(body))) {
+            attrs[a[1]] = decodeXmlEntities(a[2] != undefined ? a[2] : a[3]);
+        }
+
+        this.handler.onOpenTag(m[0], attrs, selfClosing);
+        if (selfClosing)
+            this.handler.onCloseTag(m[0]);
+
+        return true;
+    }
+}
+
+export interface XmlParseOptions {
+
+    /**
+     * layout of the result:
+     *  - 'xml2js': the default options of the 'xml2js' package (explicit arrays, '$' for attributes, '_' for text)
+     *  - 'x2js': the 'x2js' package, arrays only for the repeated elements or 'arrayPaths'
+    */
+    format?: 'xml2js' | 'x2js';
+
+    /** 'x2js' only, prefix of the attribute names, default: '_' */
+    attributePrefix?: string;
+
+    /** 'x2js' only, the element paths which are always arrays, like 'Project.Targets.Target' */
+    arrayPaths?: string[];
+
+    /** 'x2js' only, add a 'toString()' which returns the text to the objects with text */
+    enableToStringFunc?: boolean;
+
+    /**
+     * drop an element and all its children, the elements are not kept in memory
+     * @param path element path, like 'Project.Targets.Target'
+    */
+    skip?: (path: string, attrs: XmlAttributes) => boolean;
+}
+
+interface DomFrame {
+    name: string;
+    path: string;
+    attrs: XmlAttributes;
+    children: { [name: string]: any };
+    childCount: number;
+    texts: string[];
+}
+
+/**
+ * Build the document object from the tokens
+*/
+export class XmlDomBuilder implements XmlStreamHandler {
+
+    private readonly isX2js: boolean;
+    private readonly attrPrefix: string;
+    private readonly arrayPaths: Set<string>;
+
+    private stack: DomFrame[] = [];
+    private skipDepth = 0;
+    private root: any;
+
+    constructor(private options: XmlParseOptions = {}) {
+        this.isX2js = options.format == 'x2js';
+        this.attrPrefix = options.attributePrefix != undefined ? options.attributePrefix : '_';
+        this.arrayPaths = new Set(options.arrayPaths || []);
+    }
+
+    getResult(): any {
+        if (this.stack.length > 0)
+            throw new Error(`Unexpected end of xml, element '<${this.stack[this.stack.length - 1].name}>' is not closed`);
+        if (this.root == undefined)
+            throw new Error(`Not found root element of xml`);
+        return this.root;
+    }
+
+    onOpenTag(name: string, attrs: XmlAttributes) {
+
+        if (this.skipDepth > 0) {
+            this.skipDepth++;
+            return;
+        }
+
+        const parent = this.stack[this.stack.length - 1];
+        if (parent == undefined && this.root != undefined)
+            throw new Error(`Multiple root elements of xml: '<${name}>'`);
+
+        const localName = this.isX2js ? name.substr(name.indexOf(':') + 1) : name;
+        const path = parent ? `${parent.path}.${localName}` : localName;
+
+        if (this.options.skip && this.options.skip(path, attrs)) {
+            this.skipDepth = 1;
+            return;
+        }
+
+        this.stack.push({ name, path, attrs, children: {}, childCount: 0, texts: [] });
+    }
+
+    onCloseTag(name: string) {
+
+        if (this.skipDepth > 0) {
+            this.skipDepth--;
+            return;
+        }
+
+        const frame = this.stack.pop();
+        if (frame == undefined || frame.name != name)
+            throw new Error(`Unexpected closing tag '</${name}>'` + (frame ? `, expected '</${frame.name}>'` : ''));
+
+        const value = this.isX2js ? this.toX2js(frame) : this.toXml2js(frame);
+        const localName = this.isX2js ? name.substr(name.indexOf(':') + 1) : name;
+        const parent = this.stack[this.stack.length - 1];
+
+        if (parent == undefined) {
+            this.root = { [localName]: value };
+            return;
+        }
+
+        parent.childCount++;
+
+        if (!this.isX2js) {
+            if (parent.children[localName] == undefined)
+                parent.children[localName] = [value];
+            else
+                parent.children[localName].push(value);
+        } else {
+            const prev = parent.children[localName];
+            if (prev == undefined) {
+                parent.children[localName] = this.arrayPaths.has(frame.path) ? [value] : value;
+            } else if (Array.isArray(prev)) {
+                prev.push(value);
+            } else {
+                parent.children[localName] = [prev, value];
+            }
+        }
+    }
+
+    onText(text: string) {
+        if (this.skipDepth > 0) return;
+        const frame = this.stack[this.stack.length - 1];
+        if (frame) frame.texts.push(text);
+    }
+
+    private toXml2js(frame: DomFrame): any {
+
+        const text = frame.texts.join('');
+        let hasAttrs = false;
+        for (const _ in frame.attrs) { hasAttrs = true; break; }
+
+        if (!hasAttrs && frame.childCount == 0)
+            return text;
+
+        const obj: any = {};
+        if (hasAttrs) obj['$'] = frame.attrs;
+        if (text.trim() != '') obj['_'] = text;
+        for (const name in frame.children)
+            obj[name] = frame.children[name];
+        return obj;
+    }
+
+    private toX2js(frame: DomFrame): any {
+
+        let attrCount = 0;
+        for (const _ in frame.attrs) attrCount++;
+
+        // a text node is counted as a child, like the dom
+        const texts = frame.texts;
+        if (frame.childCount + attrCount == 0)
+            return texts.length > 0 ? texts.join('') : '';
+
+        const obj: any = frame.children;
+        for (const name in frame.attrs)
+            obj[this.attrPrefix + name] = frame.attrs[name];
+
+        const text = texts.join('').trim();
+        if (text != '') {
+            obj.__text = text;
+            if (this.options.enableToStringFunc) {
+                obj.toString = function () { return this.__text != undefined ? this.__text : ''; };
+            }
+        }
+
+        return obj;
+    }
+}
+
+/**
+ * Parse a xml string
+*/
+export function parseXmlString(text: string, options?: XmlParseOptions): any {
+    const builder = new XmlDomBuilder(options);
+    const tokenizer = new XmlTokenizer(builder);
+    tokenizer.write(text);
+    tokenizer.end();
+    return builder.getResult();
+}
+
+/**
+ * Parse a xml file by chunks
+*/
+export function parseXmlFile(path: string, options?: XmlParseOptions, chunkSize: number = 64 * 1024): Promise<any> {
+
+    return new Promise((resolve, reject) => {
+
+        const builder = new XmlDomBuilder(options);
+        const tokenizer = new XmlTokenizer(builder);
+        const stream = fs.createReadStream(path, { encoding: 'utf8', highWaterMark: chunkSize });
+
+        const fail = (err: Error) => {
+            stream.destroy();
+            reject(new Error(`Failed to parse '${path}': ${err.message}`));
+        };
+
+        stream.on('data', (chunk) => {
+            try {
+                tokenizer.write(<string>chunk);
+            } catch (error) {
+                fail(<Error>error);
+            }
+        });
+
+        stream.on('end', () => {
+            try {
+                tokenizer.end();
+                resolve(builder.getResult());
+            } catch (error) {
+                fail(<Error>error);
+            }
+        });
+
+        stream.on('error', (err) => reject(err));
+    });
+}
@@ -0,0 +1,448 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import * as fs from 'fs';
+import * as NodePath from 'path';
+import * as zlib from 'zlib';
+
+const SIG_LOCAL_HEADER = 0x04034b50;
+const SIG_CENTRAL_HEADER = 0x02014b50;
+const SIG_EOCD = 0x06054b50;
+const SIG_EOCD64 = 0x06064b50;
+const SIG_EOCD64_LOCATOR = 0x07064b50;
+
+const METHOD_STORE = 0;
+const METHOD_DEFLATE = 8;
+
+const HOST_UNIX = 3;
+
+const S_IFMT = 0o170000;
+const S_IFLNK = 0o120000;
+
+/** EOCD record (22 bytes) + max comment length */
+const EOCD_SEARCH_SIZE = 22 + 0xffff;
+
+export interface ZipEntry {
+
+    /** path in the archive, use '/' as the separator, directories end with '/' */
+    name: string;
+
+    method: number;
+
+    flags: number;
+
+    crc32: number;
+
+    compressedSize: number;
+
+    size: number;
+
+    /** offset of the local file header */
+    offset: number;
+
+    /** unix time (ms) */
+    mtime: number;
+
+    /** unix file mode, if the archive is made on unix */
+    mode?: number;
+}
+
+let _crcTable: Int32Array | undefined;
+
+export function crc32(data: Buffer, prev?: number): number {
+
+    if (_crcTable == undefined) {
+        _crcTable = new Int32Array(256);
+        for (let n = 0; n < 256; n++) {
+            let c = n;
+            for (let k = 0; k < 8; k++)
+                c = (c & 1) ? (0xedb88320 ^ (c >>> 1)) : (c >>> 1);
+            _crcTable[n] = c;
+        }
+    }
+
+    let crc = (prev === undefined ? 0 : prev) ^ -1;
+    for (let i = 0; i < data.length; i++)
+        crc = _crcTable[(crc ^ data[i]) & 0xff] ^ (crc >>> 8);
+    return (crc ^ -1) >>> 0;
+}
+
+/**
+ * Check that the extracted file is in the output folder (zip-slip)
+*/
+export function safeJoin(outDir: string, name: string): string {
+    const dest = NodePath.resolve(outDir, name.replace(/^[\\/]+/, ''));
+    const root = NodePath.resolve(outDir);
+    if (dest != root && !dest.startsWith(root + NodePath.sep))
+        throw new Error(`Illegal file path in the archive: '${name}'`);
+    return dest;
+}
+
+/**
+ * Check that the target of a symlink is in the output folder
+*/
+export function checkLinkTarget(outDir: string, linkPath: string, target: string) {
+    if (NodePath.isAbsolute(target))
+        throw new Error(`Illegal link target in the archive: '${target}'`);
+    safeJoin(outDir, NodePath.relative(outDir, NodePath.resolve(NodePath.dirname(linkPath), target)));
+}
+
+function dosTimeToUnix(time: number, date: number): number {
+    return new Date(
+        ((date >> 9) & 0x7f) + 1980, ((date >> 5) & 0x0f) - 1, date & 0x1f,
+        (time >> 11) & 0x1f, (time >> 5) & 0x3f, (time & 0x1f) * 2).getTime();
+}
+
+/**
+ * Read the files of a zip archive (such as a CMSIS '.pack') from its central directory,
+ * without extracting the whole archive
+*/
+export class ZipArchive {
+
+    readonly path: string;
+
+    readonly entries: ZipEntry[];
+
+    private fd: number;
+    private entryMap: Map<string, ZipEntry>;
+    private entryMapLower: Map<string, ZipEntry> | undefined;
+
+    private constructor(path: string, fd: number) {
+        this.path = path;
+        this.fd = fd;
+        this.entries = [];
+        this.entryMap = new Map();
+    }
+
+    static open(path: string): ZipArchive {
+        const fd = fs.openSync(path, 'r');
+        const zip = new ZipArchive(path, fd);
+        try {
+            zip.readCentralDirectory();
+        } catch (error) {
+            zip.close();
+            throw error;
+        }
+        return zip;
+    }
+
+    close() {
+        if (this.fd >= 0) {
+            fs.closeSync(this.fd);
+            this.fd = -1;
+        }
+    }
+
+    private readAt(offset: number, length: number): Buffer {
+        const buf = Buffer.alloc(length);
+        let done = 0;
+        while (done < length) {
+            const n = fs.readSync(this.fd, buf, done, length - done, offset + done);
+            if (n <= 0)
+                throw new Error(`Unexpected end of zip file: '${this.path}'`);
+            done += n;
+        }
+        return buf;
+    }
+
+    private readCentralDirectory() {
+
+        const fileSize = fs.fstatSync(this.fd).size;
+        const tailSize = Math.min(fileSize, EOCD_SEARCH_SIZE);
+        const tail = this.readAt(fileSize - tailSize, tailSize);
+
+        let eocd = -1;
+        for (let i = tail.length - 22; i >= 0; i--) {
+            if (tail.readUInt32LE(i) == SIG_EOCD) {
+                eocd = i;
+                break;
+            }
+        }
+
+        if (eocd < 0)
+            throw new Error(`Not a zip file: '${this.path}'`);
+
+        let count = tail.readUInt16LE(eocd + 10);
+        let cdSize = tail.readUInt32LE(eocd + 12);
+        let cdOffset = tail.readUInt32LE(eocd + 16);
+
+        // zip64
+        if (eocd >= 20 && tail.readUInt32LE(eocd - 20) == SIG_EOCD64_LOCATOR) {
+            const eocd64Offset = Number(tail.readBigUInt64LE(eocd - 20 + 8));
+            const eocd64 = this.readAt(eocd64Offset, 56);
+            if (eocd64.readUInt32LE(0) != SIG_EOCD64)
+                throw new Error(`Invalid zip64 end of central directory: '${this.path}'`);
+            count = Number(eocd64.readBigUInt64LE(32));
+            cdSize = Number(eocd64.readBigUInt64LE(40));
+            cdOffset = Number(eocd64.readBigUInt64LE(48));
+        }
+
+        const cd = this.readAt(cdOffset, cdSize);
+
+        let pos = 0;
+        for (let i = 0; i < count; i++) {
+
+            if (pos + 46 > cd.length || cd.readUInt32LE(pos) != SIG_CENTRAL_HEADER)
+                throw new Error(`Invalid zip central directory: '${this.path}'`);
+
+            const nameLen = cd.readUInt16LE(pos + 28);
+            const extraLen = cd.readUInt16LE(pos + 30);
+            const commentLen = cd.readUInt16LE(pos + 32);
+
+            const entry: ZipEntry = {
+                name: cd.toString('utf8', pos + 46, pos + 46 + nameLen).replace(/\\/g, '/'),
+                flags: cd.readUInt16LE(pos + 8),
+                method: cd.readUInt16LE(pos + 10),
+                mtime: dosTimeToUnix(cd.readUInt16LE(pos + 12), cd.readUInt16LE(pos + 14)),
+                crc32: cd.readUInt32LE(pos + 16),
+                compressedSize: cd.readUInt32LE(pos + 20),
+                size: cd.readUInt32LE(pos + 24),
+                offset: cd.readUInt32LE(pos + 42)
+            };
+
+            if ((cd.readUInt16LE(pos + 4) >> 8) == HOST_UNIX) {
+                const mode = cd.readUInt32LE(pos + 38) >>> 16;
+                if (mode != 0) entry.mode = mode;
+            }
+
+            // zip64 extended information
+            let ext = pos + 46 + nameLen;
+            const extEnd = ext + extraLen;
+            while (ext + 4 <= extEnd) {
+                const id = cd.readUInt16LE(ext);
+                const len = cd.readUInt16LE(ext + 2);
+                if (id == 0x0001) {
+                    let p = ext + 4;
+                    if (entry.size == 0xffffffff) { entry.size = Number(cd.readBigUInt64LE(p)); p += 8; }
+                    if (entry.compressedSize == 0xffffffff) { entry.compressedSize = Number(cd.readBigUInt64LE(p)); p += 8; }
+                    if (entry.offset == 0xffffffff) { entry.offset = Number(cd.readBigUInt64LE(p)); p += 8; }
+                }
+                ext += 4 + len;
+            }
+
+            this.entries.push(entry);
+            this.entryMap.set(entry.name, entry);
+
+            pos += 46 + nameLen + extraLen + commentLen;
+        }
+    }
+
+    /**
+     * Find an entry by the path in the archive, the case is ignored if not found
+    */
+    getEntry(name: string): ZipEntry | undefined {
+
+        name = name.replace(/\\/g, '/').replace(/^\.\//, '');
+
+        const entry = this.entryMap.get(name);
+        if (entry)
+            return entry;
+
+        if (this.entryMapLower == undefined) {
+            this.entryMapLower = new Map();
+            for (const e of this.entries)
+                this.entryMapLower.set(e.name.toLowerCase(), e);
+        }
+
+        return this.entryMapLower.get(name.toLowerCase());
+    }
+
+    /**
+     * Get the files under a folder of the archive
+    */
+    getEntriesUnder(dir: string): ZipEntry[] {
+        let prefix = dir.replace(/\\/g, '/').replace(/^\.\//, '').toLowerCase();
+        if (prefix != '' && !prefix.endsWith('/'))
+            prefix += '/';
+        return this.entries.filter(e => !e.name.endsWith('/') && e.name.toLowerCase().startsWith(prefix));
+    }
+
+    static isSymlink(entry: ZipEntry): boolean {
+        return entry.mode !== undefined && (entry.mode & S_IFMT) == S_IFLNK;
+    }
+
+    private dataOffset(entry: ZipEntry): number {
+
+        if (entry.flags & 0x1)
+            throw new Error(`Encrypted zip entry is not supported: '${entry.name}'`);
+
+        const header = this.readAt(entry.offset, 30);
+        if (header.readUInt32LE(0) != SIG_LOCAL_HEADER)
+            throw new Error(`Invalid zip local file header: '${entry.name}'`);
+
+        return entry.offset + 30 + header.readUInt16LE(26) + header.readUInt16LE(28);
+    }
+
+    /**
+     * Read the data of an entry, the data is verified by crc32
+    */
+    read(entry: ZipEntry): Buffer {
+
+        const raw = this.readAt(this.dataOffset(entry), entry.compressedSize);
+
+        let data: Buffer;
+        if (entry.method == METHOD_STORE) {
+            data = raw;
+        } else if (entry.method == METHOD_DEFLATE) {
+            data = zlib.inflateRawSync(raw);
+        } else {
+            throw new Error(`Unsupported zip compression method ${entry.method}: '${entry.name}'`);
+        }
+
+        if (data.length != entry.size || crc32(data) != entry.crc32)
+            throw new Error(`Zip entry is corrupted (crc32 mismatch): '${entry.name}'`);
+
+        return data;
+    }
+
+    /**
+     * Extract an entry to a file
+     *
+     * @param rootDir the extraction root, the file and the target of a symlink must be in it
+    */
+    extract(entry: ZipEntry, destPath: string, rootDir: string) {
+
+        ZipArchive.checkDestPath(entry, destPath, rootDir);
+
+        if (entry.name.endsWith('/')) {
+            fs.mkdirSync(destPath, { recursive: true });
+            return;
+        }
+
+        const data = this.read(entry);
+        fs.mkdirSync(NodePath.dirname(destPath), { recursive: true });
+
+        if (ZipArchive.isSymlink(entry)) {
+            ZipArchive.makeSymlink(data.toString(), destPath, rootDir);
+            return;
+        }
+
+        // write to a temp file first, so that a broken file is never left
+        const tmpPath = `${destPath}.${process.pid}.tmp`;
+        fs.writeFileSync(tmpPath, data);
+        fs.renameSync(tmpPath, destPath);
+
+        ZipArchive.setFileAttr(entry, destPath);
+    }
+
+    /**
+     * Extract an entry to a file by streams, the data is not loaded into memory,
+     * the decompression runs in the thread pool, so many entries can be extracted in parallel
+     *
+     * @param rootDir the extraction root, the file and the target of a symlink must be in it
+     * @param onData called with the size of the uncompressed data
+    */
+    async extractAsync(entry: ZipEntry, destPath: string, rootDir: string, onData?: (size: number) => void): Promise<void> {
+
+        ZipArchive.checkDestPath(entry, destPath, rootDir);
+
+        if (entry.name.endsWith('/')) {
+            await fs.promises.mkdir(destPath, { recursive: true });
+            return;
+        }
+
+        await fs.promises.mkdir(NodePath.dirname(destPath), { recursive: true });
+
+        if (ZipArchive.isSymlink(entry)) {
+            ZipArchive.makeSymlink(this.read(entry).toString(), destPath, rootDir);
+            return;
+        }
+
+        if (entry.method != METHOD_STORE && entry.method != METHOD_DEFLATE)
+            throw new Error(`Unsupported zip compression method ${entry.method}: '${entry.name}'`);
+
+        const start = this.dataOffset(entry);
+        const tmpPath = `${destPath}.${process.pid}.tmp`;
+
+        let crc = 0;
+        let size = 0;
+
+        await new Promise<void>((resolve, reject) => {
+
+            const input = fs.createReadStream(this.path, {
+                start: start,
+                end: start + entry.compressedSize - 1,
+                highWaterMark: 256 * 1024
+            });
+            const data = entry.method == METHOD_DEFLATE ? input.pipe(zlib.createInflateRaw()) : input;
+            const output = fs.createWriteStream(tmpPath);
+
+            const fail = (err: Error) => {
+                input.destroy();
+                output.destroy();
+                reject(err);
+            };
+
+            input.on('error', fail);
+            data.on('error', fail);
+            output.on('error', fail);
+
+            data.on('data', (chunk: Buffer) => {
+                crc = crc32(chunk, crc);
+                size += chunk.length;
+                if (onData) onData(chunk.length);
+            });
+
+            output.on('finish', () => resolve());
+            data.pipe(output);
+
+        }).catch((err) => {
+            try { fs.unlinkSync(tmpPath); } catch (error) { /* not exist */ }
+            throw err;
+        });
+
+        if (size != entry.size || crc != entry.crc32) {
+            try { fs.unlinkSync(tmpPath); } catch (error) { /* not exist */ }
+            throw new Error(`Zip entry is corrupted (crc32 mismatch): '${entry.name}'`);
+        }
+
+        await fs.promises.rename(tmpPath, destPath);
+        ZipArchive.setFileAttr(entry, destPath);
+    }
+
+    private static checkDestPath(entry: ZipEntry, destPath: string, rootDir: string) {
+        const rel = NodePath.relative(rootDir, destPath);
+        if (NodePath.isAbsolute(rel))
+            throw new Error(`Illegal file path in the archive: '${entry.name}'`);
+        safeJoin(rootDir, rel);
+    }
+
+    private static makeSymlink(target: string, destPath: string, rootDir: string) {
+        // 'a -> /etc' and then 'a/x' would write a file out of the root
+        checkLinkTarget(rootDir, destPath, target);
+        try { fs.unlinkSync(destPath); } catch (error) { /* not exist */ }
+        fs.symlinkSync(target, destPath);
+    }
+
+    private static setFileAttr(entry: ZipEntry, destPath: string) {
+
+        const mtime = new Date(entry.mtime);
+        fs.utimesSync(destPath, mtime, mtime);
+
+        // keep the executable bits on unix
+        if (entry.mode !== undefined && process.platform != 'win32') {
+            fs.chmodSync(destPath, entry.mode & 0o777);
+        }
+    }
+}
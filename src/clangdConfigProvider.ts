@@ -12,7 +12,7 @@ import { AbstractProject } from './EIDEProject';
 import { SettingManager } from './SettingManager';
 import { GlobalEvent } from './GlobalEvents';
 import { File } from '../lib/node-utility/File';
-import { isGccFamilyToolchain, getGccSystemSearchList } from './utility';
+import { isGccFamilyToolchain, getGccSystemSearchListAsync } from './utility';
 import { ArrayDelRepetition } from '../lib/node-utility/Utility';
 
 const CLANGD_EXTENSION = 'llvm-vs-code-extensions.vscode-clangd';
@@ -117,7 +117,7 @@ export async function onRegisterClangdProvider(prj: AbstractProject) {
     //     api.languageClient.registerFeature(new _ConfigProvider(prj, api.languageClient));
     // }
 
-    prj.on('cppConfigChanged', () => {
+    prj.on('cppConfigChanged', async () => {
 
         if (!SettingManager.instance().isEnableClangdConfigGenerator()) {
             GlobalEvent.log_info(`ignore update .clangd, because "EIDE.Option.EnableClangdConfigGenerator" is not set`);
@@ -162,7 +162,7 @@ export async function onRegisterClangdProvider(prj: AbstractProject) {
                         // 移除工具链目录下的 include 路径（系统头路径）
                         return !File.isSubPathOf(tRoot, incPath);
                     });
-                    let li = getGccSystemSearchList(File.ToLocalPath(gccLikePath), ['-xc++'].concat(compilerArgs || []));
+                    let li = await getGccSystemSearchListAsync(File.ToLocalPath(gccLikePath), ['-xc++'].concat(compilerArgs || []));
                     if (li) {
                         // 重新添加系统头路径。使用 -isystem 前缀，避免 clangd 对系统头进行诊断
                         li.forEach(p => { clangdCompileFlags.push(sysIncPrefix + File.normalize(p)); });
@@ -27,6 +27,7 @@ import * as fs from 'fs';
 import * as os from 'os';
 import * as node7z from 'node-7z';
 import * as NodePath from 'path';
+import { URLSearchParams } from 'url';
 import * as ChildProcess from 'child_process';
 import * as yaml from 'yaml';
 
@@ -45,7 +46,7 @@ import {
     view_str$prompt$install_dotnet_and_restart_vscode,
     view_str$prompt$install_dotnet_failed,
     view_str$prompt$not_found_compiler, view_str$prompt$debugCfgNotSupported, not_support_no_arm_project,
-    view_str$prompt$requireOtherExtension, view_str$add_missed_stubs
+    view_str$prompt$requireOtherExtension, view_str$add_missed_stubs, view_str$add_retarget_lib
 } from './StringTable';
 import { LogDumper } from './LogDumper';
 import { StatusBarManager } from './StatusBarManager';
@@ -56,6 +57,9 @@ import { WorkspaceManager } from './WorkspaceManager';
 import { VirtualDocument } from './VirtualDocsProvider';
 import * as utility from './utility';
 import * as platform from './Platform';
+import { ProbeSessionManager } from './ProbeSession';
+import { DownloadResult } from './FileDownloader';
+import { Tracer } from './Tracer';
 
 const extension_deps: string[] = [];
 
@@ -116,6 +120,7 @@ export async function activate(context: vscode.ExtensionContext) {
     subscriptions.push(vscode.commands.registerCommand('eide.ReloadStm8Devs', () => reloadStm8Devices()));
     subscriptions.push(vscode.commands.registerCommand('eide.create.clang-format.file', () => newClangFormatFile()));
     subscriptions.push(vscode.commands.registerCommand('eide.cleanCache', () => cleanCache()));
+    subscriptions.push(vscode.commands.registerCommand('eide.trace.export', () => exportTrace()));
     subscriptions.push(vscode.commands.registerCommand('eide.refresh.external_tools_index', () => {
         ResInstaller.instance()
             .refreshExternalToolsIndex(true)
@@ -159,6 +164,39 @@ export async function activate(context: vscode.ExtensionContext) {
     subscriptions.push(vscode.commands.registerCommand('_cl.eide.workspace.rebuild', () => projectExplorer.buildWorkspace(true)));
     subscriptions.push(vscode.commands.registerCommand('_cl.eide.workspace.open.config', () => projectExplorer.openWorkspaceConfig()));
     subscriptions.push(vscode.commands.registerCommand('_cl.eide.workspace.make.template', (item) => projectExplorer.ExportProjectTemplate(undefined, true)));
+    subscriptions.push(vscode.commands.registerCommand('eide.operation.bulk_import_projects', (rootDir?: string, options?: any) => projectExplorer.bulkImportProjects(rootDir, options)));
+
+    // entry from the command line:
+    //  code --open-url "vscode://cl.eide/bulk-import?dir=<folder>&concurrency=4"
+    // the uri can be opened by any web page, so the user must confirm it,
+    // and the verification (it runs the builder) is only chosen by the user
+    subscriptions.push(vscode.window.registerUriHandler({
+        handleUri: async (uri) => {
+            if (uri.path == '/bulk-import') {
+                const query = new URLSearchParams(uri.query);
+                const dir = query.get('dir');
+                if (!dir) {
+                    GlobalEvent.show_msgbox('Warning', `Missing 'dir' in the uri: ${uri.toString()}`);
+                    return;
+                }
+                if (!File.IsDir(dir)) {
+                    GlobalEvent.show_msgbox('Warning', `Folder not existed, [path]: ${dir}`);
+                    return;
+                }
+                const ans = await vscode.window.showWarningMessage(`Import all projects in '${dir}' ?`, {
+                    modal: true,
+                    detail: `This request is from a link (${uri.scheme}://${uri.authority}${uri.path}), ignore it if you did not open it. ` +
+                        `'Import and Verify' runs a dry-run build of each imported project.`
+                }, 'Import', 'Import and Verify');
+                if (ans === undefined)
+                    return;
+                projectExplorer.bulkImportProjects(dir, {
+                    verify: ans == 'Import and Verify',
+                    concurrency: parseInt(query.get('concurrency') || '') || undefined
+                });
+            }
+        }
+    }));
 
     // project user cmds
     subscriptions.push(vscode.commands.registerCommand('eide.project.save', (item) => projectExplorer.saveProject(item)));
@@ -168,10 +206,11 @@ export async function activate(context: vscode.ExtensionContext) {
     subscriptions.push(vscode.commands.registerCommand('eide.project.uploadToDevice', (item) => projectExplorer.programFlashProject(projectExplorer.getProjectByTreeItem(item))));
     subscriptions.push(vscode.commands.registerCommand('eide.reinstall.binaries', () => checkAndInstallBinaries(true)));
     subscriptions.push(vscode.commands.registerCommand('eide.project.flash.erase.all', (item) => projectExplorer.programFlashProject(projectExplorer.getProjectByTreeItem(item), true)));
+    subscriptions.push(vscode.commands.registerCommand('_cl.eide.project.gangFlash', (item) => projectExplorer.gangFlashProject(item)));
     subscriptions.push(vscode.commands.registerCommand('eide.project.buildAndFlash', (item) => projectExplorer.buildProject(projectExplorer.getProjectByTreeItem(item), { notRebuild: true, flashAfterBuild: true })));
     subscriptions.push(vscode.commands.registerCommand('eide.project.genBuilderParams', (item) => projectExplorer.buildProject(projectExplorer.getProjectByTreeItem(item), { notRebuild: true, onlyDumpBuilderParams: true })));
     subscriptions.push(vscode.commands.registerCommand('eide.open.makelibs.cfg', (item) => projectExplorer.openLibsGeneratorConfig(item)));
-    subscriptions.push(vscode.commands.registerCommand('eide.project.create_sys_stubs', (projuid) => projectExplorer.createSysStubs(projuid)));
+    subscriptions.push(vscode.commands.registerCommand('eide.project.create_sys_stubs', (projuid, retarget) => projectExplorer.createSysStubs(projuid, retarget)));
 
     // operations bar
     subscriptions.push(vscode.commands.registerCommand('_cl.eide.project.historyRecord', () => projectExplorer.openHistoryRecords()));
@@ -188,6 +227,8 @@ export async function activate(context: vscode.ExtensionContext) {
     subscriptions.push(vscode.commands.registerCommand('_cl.eide.project.exportXml', (item) => projectExplorer.ExportKeilXml(item)));
     subscriptions.push(vscode.commands.registerCommand('_cl.eide.project.exportMakefile', (item) => projectExplorer.ExportMakefile(item)));
     subscriptions.push(vscode.commands.registerCommand('_cl.eide.project.show_proj_vars', (item) => projectExplorer.ShowProjectVariables(item)));
+    subscriptions.push(vscode.commands.registerCommand('_cl.eide.project.showSizeDiff', (item) => projectExplorer.showSizeDiff(item)));
+    subscriptions.push(vscode.commands.registerCommand('_cl.eide.project.tagSizeBaseline', (item) => projectExplorer.tagSizeBaseline(item)));
 
     // project explorer
     subscriptions.push(vscode.commands.registerCommand('_cl.eide.project.addSrcDir', (item) => projectExplorer.AddSrcDir(item)));
@@ -297,6 +338,14 @@ export async function activate(context: vscode.ExtensionContext) {
     // vscode.debug.registerDebugConfigurationProvider('stm8-debug', new ExternalDebugConfigProvider('stm8-debug'),
     //     vscode.DebugConfigurationProviderTriggerKind.Dynamic);
 
+    // release the probes opened by the resident flasher sessions before debugging
+    vscode.debug.registerDebugConfigurationProvider('*', {
+        resolveDebugConfiguration: async (folder, config) => {
+            await ProbeSessionManager.instance().closeAll();
+            return config;
+        }
+    });
+
     // others
     vscode.workspace.registerTextDocumentContentProvider(VirtualDocument.scheme, VirtualDocument.instance());
     vscode.workspace.registerTaskProvider(EideTaskProvider.TASK_TYPE_BASH, new EideTaskProvider());
@@ -325,6 +374,7 @@ export function deactivate() {
     LogDumper.getInstance().onDispose();
     StatusBarManager.getInstance().disposeAll();
     mcp.mcpServerStop().catch(err => GlobalEvent.log_error(err));
+    ProbeSessionManager.instance().closeAll();
 }
 
 function postLaunchHook(extensionCtx: vscode.ExtensionContext) {
@@ -489,8 +539,8 @@ function ShowUUID() {
     });
 }
 
-function reloadJlinkDevices() {
-    if (ResManager.GetInstance().loadJlinkDevList()) {
+async function reloadJlinkDevices() {
+    if (await ResManager.GetInstance().loadJlinkDevList()) {
         GlobalEvent.emit('msg', newMessage('Info', 'Done !, JLink devices list has been reloaded !'));
     }
 }
@@ -529,6 +579,32 @@ function cleanCache() {
     }
 }
 
+async function exportTrace() {
+
+    if (Tracer.count() == 0) {
+        const msg = Tracer.enabled
+            ? `No trace events were recorded yet !`
+            : `The trace recorder is disabled, enable 'EIDE.Trace.Enable' and reproduce the problem first !`;
+        vscode.window.showWarningMessage(msg);
+        return;
+    }
+
+    const defPath = File.from(ResManager.GetInstance().GetLogDir().path, `eide-trace-${Date.now()}.json`);
+    const uri = await vscode.window.showSaveDialog({
+        defaultUri: vscode.Uri.file(defPath.path),
+        filters: { 'Chrome Trace': ['json'] }
+    });
+
+    if (uri) {
+        try {
+            fs.writeFileSync(uri.fsPath, JSON.stringify(Tracer.toChromeTrace()));
+            GlobalEvent.show_msgbox('Info', `Trace was saved to '${uri.fsPath}', open it in 'https://ui.perfetto.dev'.`);
+        } catch (error) {
+            GlobalEvent.show_msgbox('Error', error);
+        }
+    }
+}
+
 //////////////////////////////////////////////////
 // eide binaries installer
 //////////////////////////////////////////////////
@@ -755,11 +831,11 @@ async function tryInstallBinaries(binFolder: File, binVersion: string): Promise<
             cancellable: false
         }, async (progress, token): Promise<boolean> => {
 
-            let res: Buffer | undefined | Error = undefined;
+            let res: DownloadResult | undefined | Error = undefined;
 
             for (const site of downloadSites) {
-                res = await utility.downloadFileWithProgress(site, tmpFile.name, progress, token);
-                if (res instanceof Buffer) { break; } /* if done, exit loop */
+                res = await utility.downloadFileToDisk(site, tmpFile.path, tmpFile.name, progress, token);
+                if (res && !(res instanceof Error)) { break; } /* if done, exit loop */
                 progress.report({ message: 'failed, switch to next download site ...' });
             }
 
@@ -770,9 +846,6 @@ async function tryInstallBinaries(binFolder: File, binVersion: string): Promise<
                 return false;
             }
 
-            /* save to file */
-            fs.writeFileSync(tmpFile.path, res);
-
             return true;
         });
 
@@ -1140,10 +1213,10 @@ async function checkAndInstallRuntime() {
             else {
 
                 pkgFile = File.fromArray([os.tmpdir(), defPkgName]);
+                const reqSha256 = 'A085714B879DC1CB85538109640E22A2CBFF2B91195DF540A5F98AEA09AF2C1E'.toLowerCase();
                 if (pkgFile.IsFile()) { // if we have a cached old file, check it
                     const sevenZip = utility.newSevenZipperInstance();
                     const pkgSha256 = sevenZip.sha256(pkgFile);
-                    const reqSha256 = 'A085714B879DC1CB85538109640E22A2CBFF2B91195DF540A5F98AEA09AF2C1E'.toLowerCase();
                     if (pkgSha256 == reqSha256) { pkgReady = true; } // sha256 verified, use cached old file
                     else { try { fs.unlinkSync(pkgFile.path); } catch { } } // sha256 verify failed, del old file
                 }
@@ -1158,22 +1231,15 @@ async function checkAndInstallRuntime() {
                         cancellable: false
                     }, async (progress, token): Promise<boolean> => {
 
-                        const res = await utility.downloadFileWithProgress(downloadUrl, pkgFile.name, progress, token);
-
-                        if (res instanceof Buffer) {
-                            try {
-                                fs.writeFileSync(pkgFile.path, res);
-                                return true;
-                            } catch (error) {
-                                return false;
-                            }
-                        }
+                        const res = await utility.downloadFileToDisk(downloadUrl, pkgFile.path, pkgFile.name, progress, token,
+                            { expectedHash: { algorithm: 'sha256', value: reqSha256 } });
 
                         if (res instanceof Error) {
                             GlobalEvent.emit('error', res);
+                            return false;
                         }
 
-                        return false;
+                        return res != undefined;
                     });
                 }
             }
@@ -1656,8 +1722,9 @@ import {
 } from './HexUploader';
 import { AbstractProject } from './EIDEProject';
 import { EideDiagnosticCode } from './ProblemMatcher';
+import { getMapFileTypeByToolchain, parseMapFileReport, makeMemoryReportTable } from './MapFileParser';
 
-type MapViewParserType = 'memap' | 'builtin';
+type MapViewParserType = 'native' | 'builtin';
 
 interface MapViewRef {
 
@@ -1674,6 +1741,8 @@ interface MapViewRef {
     treeDepth: number;
 
     mapPath: string;
+
+    toolchainRoot?: string;
 };
 
 interface MapViewInfo {
@@ -1711,7 +1780,8 @@ class MapViewEditorProvider implements vscode.CustomTextEditorProvider {
             tool?: string, 
             fileName?: string, 
             compilerName?: string,
-            compilerFullName?: string
+            compilerFullName?: string,
+            compilerPath?: string
         } = yaml.parse(viewFile.Read());
         if (!conf.tool) {
             webviewPanel.webview.html = this.genErrorHtml(title, `<span class="error">Error</span>: Invalid toolchain type !`);
@@ -1730,7 +1800,7 @@ class MapViewEditorProvider implements vscode.CustomTextEditorProvider {
         if (fileDepth <= 0)
             fileDepth = 100;
 
-        let parser: MapViewParserType = 'memap';
+        let parser: MapViewParserType = 'native';
 
         switch (toolchainId) {
             case 'AC5':
@@ -1738,7 +1808,7 @@ class MapViewEditorProvider implements vscode.CustomTextEditorProvider {
             case 'GCC':
             case 'GNU_SDCC_MCS51':
             case 'IAR_ARM':
-                parser = 'memap';
+                parser = 'native';
                 break;
             default:
                 parser = 'builtin';
@@ -1789,7 +1859,8 @@ class MapViewEditorProvider implements vscode.CustomTextEditorProvider {
                 parser: parser,
                 toolchainId: toolchainId,
                 treeDepth: fileDepth,
-                mapPath: mapFile.path
+                mapPath: mapFile.path,
+                toolchainRoot: conf.compilerPath ? NodePath.dirname(NodePath.dirname(conf.compilerPath)) : undefined
             });
 
         } catch (error) {
@@ -1837,41 +1908,16 @@ class MapViewEditorProvider implements vscode.CustomTextEditorProvider {
 
                     let lines: string[] = [];
 
-                    // use memap tools
-                    if (vInfo.parser == 'memap') {
-
-                        let memapTyp = 'ARM_MICRO';
-
-                        switch (vInfo.toolchainId) {
-                            case 'AC5':
-                            case 'AC6':
-                                memapTyp = 'ARM_MICRO';
-                                break;
-                            case 'GCC':
-                            case 'GNU_SDCC_MCS51':
-                                memapTyp = 'GCC_ARM';
-                                break;
-                            case 'IAR_ARM':
-                                memapTyp = 'IAR';
-                                break;
-                            default:
-                                throw new Error(`We don't support this toolchain type: '${vInfo.toolchainId}' yet !`);
-                        }
-
-                        if (os.platform() == 'win32') {
-                            // "%USERPROFILE%\.eide\bin\python36\python3" -m memap %*
-                            const py3 = ResManager.instance().getPython3();
-                            lines = ChildProcess
-                                .execFileSync(py3, ['-m', 'memap', '-t', memapTyp, '-d', vInfo.treeDepth.toString(), vInfo.mapPath])
-                                .toString().split(/\r\n|\n/);
-                        } else {
-                            // PYTHONPATH="/home/xxx/.eide/bin/builder/utils/memap" python -m memap -t GCC_ARM -d 100 "/home/xxx/build/Debug/stm32f1xx_gcc.map"
-                            const memapPkgDir = File.from(ResManager.GetInstance().getLegacyBuilderDir().path, 'utils', 'memap');
-                            const command = `PYTHONPATH="${memapPkgDir.path}" python -m memap -t ${memapTyp} -d ${vInfo.treeDepth} "${vInfo.mapPath}"`;
-                            lines = ChildProcess
-                                .execSync(command, { cwd: memapPkgDir.dir })
-                                .toString().split(/\r\n|\n/);
-                        }
+                    // use native map parser
+                    if (vInfo.parser == 'native') {
+                        const mapType = getMapFileTypeByToolchain(vInfo.toolchainId);
+                        if (mapType == undefined)
+                            throw new Error(`We don't support this toolchain type: '${vInfo.toolchainId}' yet !`);
+                        const report = parseMapFileReport(vInfo.mapPath, mapType, vInfo.treeDepth, {
+                            toolchainRoot: vInfo.toolchainRoot
+                        });
+                        lines = makeMemoryReportTable(report);
+                        report.warnings.forEach((msg) => GlobalEvent.log_warn(msg));
                     }
                     // use built-in tools
                     else {
@@ -2565,6 +2611,14 @@ class CompilerLogCodeActionProvider implements vscode.CodeActionProvider {
                 arguments: [prjuid]
             };
             results.push(act);
+            const retargetAct = new vscode.CodeAction(view_str$add_retarget_lib, vscode.CodeActionKind.QuickFix);
+            retargetAct.diagnostics = stub_missed_diags;
+            retargetAct.command = {
+                title: view_str$add_retarget_lib,
+                command: 'eide.project.create_sys_stubs',
+                arguments: [prjuid, true]
+            };
+            results.push(retargetAct);
         }
 
         return results;
@@ -4,6 +4,7 @@ export const HostMsg = {
   launched: 'eide.callgraph_view.launched',
   init: 'eide.callgraph_view.init',
   gotoDefinition: 'callgraph.gotoDefinition',
+  showDisassembly: 'callgraph.showDisassembly',
 } as const;
 
 export interface GotoDefinitionPayload {
@@ -74,6 +75,7 @@ export type HostBridge = {
   ready(): Promise<void>;
   loadReport(): Promise<BuildReport>;
   gotoDefinition(payload: GotoDefinitionPayload): void;
+  showDisassembly(symbol: string): void;
   onReportUpdated(cb: (report: BuildReport) => void): () => void;
 };
 
@@ -198,6 +200,17 @@ export function createHostBridge(): HostBridge {
       }
     },
 
+    showDisassembly(symbol: string): void {
+      if (inWebview && vscode) {
+        vscode.postMessage({
+          id: HostMsg.showDisassembly,
+          data: { symbol },
+        });
+        return;
+      }
+      console.info('[Callgraph View] Disassemble:', symbol);
+    },
+
     onReportUpdated(cb: (report: BuildReport) => void): () => void {
       updateListeners.add(cb);
       return () => updateListeners.delete(cb);
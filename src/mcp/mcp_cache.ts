@@ -0,0 +1,134 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import { CallToolResult } from '@modelcontextprotocol/sdk/types';
+
+interface ProjectCache {
+    version: number;
+    /** increased when the cache is invalidated, the results of the calls started before are not cached */
+    generation: number;
+    results: Map<string, CallToolResult>;
+}
+
+/**
+ * Cache of the read-only tool results of the projects.
+ *
+ * The results are tagged with the config version of the project, they are
+ * dropped when the extension reports a new version, or when a tool which may
+ * change the project is called.
+*/
+export class ToolResultCache {
+
+    private projects = new Map<string, ProjectCache>();
+
+    hits = 0;
+    misses = 0;
+
+    private static key(tool: string, args: Record<string, unknown>): string {
+        const keys = Object.keys(args).filter(k => k !== 'uid').sort();
+        return keys.length === 0 ? tool : `${tool}:${JSON.stringify(keys.map(k => [k, args[k]]))}`;
+    }
+
+    private getProject(uid: string): ProjectCache {
+        let prj = this.projects.get(uid);
+        if (!prj) {
+            prj = { version: -1, generation: 0, results: new Map() };
+            this.projects.set(uid, prj);
+        }
+        return prj;
+    }
+
+    /**
+     * Update the config version of a project, the results of other versions are dropped
+    */
+    setVersion(uid: string, version: number): void {
+        const prj = this.getProject(uid);
+        if (prj.version !== version) {
+            prj.version = version;
+            prj.generation++;
+            prj.results.clear();
+        }
+    }
+
+    getVersion(uid: string): number | undefined {
+        const prj = this.projects.get(uid);
+        return prj && prj.version >= 0 ? prj.version : undefined;
+    }
+
+    /**
+     * Drop the results of a project, the version is unknown until the next 'setVersion()'
+    */
+    invalidate(uid: string): void {
+        const prj = this.projects.get(uid);
+        if (prj) {
+            prj.version = -1;
+            prj.generation++;
+            prj.results.clear();
+        }
+    }
+
+    /** forget the projects not in the list */
+    retain(uids: Iterable<string>): void {
+        const keep = new Set(uids);
+        for (const uid of Array.from(this.projects.keys())) {
+            if (!keep.has(uid)) {
+                this.projects.delete(uid);
+            }
+        }
+    }
+
+    get(uid: string, tool: string, args: Record<string, unknown>): CallToolResult | undefined {
+        const prj = this.projects.get(uid);
+        const result = prj && prj.version >= 0 ? prj.results.get(ToolResultCache.key(tool, args)) : undefined;
+        if (result) {
+            this.hits++;
+        } else {
+            this.misses++;
+        }
+        return result;
+    }
+
+    /**
+     * A token of the current cache state, must be taken before the tool call
+    */
+    begin(uid: string): number {
+        return this.getProject(uid).generation;
+    }
+
+    /**
+     * Cache a result computed at the config 'version',
+     * it is ignored if the cache is changed after 'begin()' or the version is not the current one
+    */
+    set(uid: string, tool: string, args: Record<string, unknown>, token: number, version: number | undefined, result: CallToolResult): boolean {
+        const prj = this.projects.get(uid);
+        if (!prj || result.isError || version === undefined) {
+            return false;
+        }
+        if (prj.generation !== token || prj.version !== version) {
+            return false;
+        }
+        prj.results.set(ToolResultCache.key(tool, args), result);
+        return true;
+    }
+}
@@ -27,6 +27,7 @@ import * as net from 'net';
 import * as path from 'path';
 import { ExeModule } from '../../lib/node-utility/Executable';
 import { ProjectExplorer } from '../EIDEProjectExplorer';
+import { AbstractProject } from '../EIDEProject';
 import { GlobalEvent } from '../GlobalEvents';
 import { executeTool } from './mcp_impl';
 import {
@@ -66,7 +67,7 @@ function logError(msg: string, err?: unknown): void {
 function collectProjects(explorer: ProjectExplorer): McpProjectInfo[] {
     const projects: McpProjectInfo[] = [];
     explorer.foreachProjects((prj) => {
-        projects.push({ uid: prj.getUid(), name: prj.getProjectName() });
+        projects.push({ uid: prj.getUid(), name: prj.getProjectName(), version: prj.getConfigVersion() });
         return undefined;
     });
     return projects;
@@ -250,8 +251,14 @@ function setupMessageHandler(sock: net.Socket, explorer: ProjectExplorer): void
     attachFrameReader(sock, async (msg: IpcMessage) => {
         if (msg.type === 'toolCall') {
             try {
-                const result = await executeTool(msg.tool, msg.args, explorer);
-                sendMessage(sock, { type: 'toolResult', requestId: msg.requestId, result });
+                const requestId = msg.requestId;
+                const result = await executeTool(msg.tool, msg.args, explorer, progress => {
+                    sendMessage(sock, { type: 'toolProgress', requestId, progress });
+                });
+                // the proxy caches the result with this version
+                const uid = msg.args.uid;
+                const prj = typeof uid === 'string' ? explorer.getProjectByUid(uid) : undefined;
+                sendMessage(sock, { type: 'toolResult', requestId: msg.requestId, result, version: prj?.getConfigVersion() });
             } catch (err) {
                 sendMessage(sock, {
                     type: 'toolResult',
@@ -268,6 +275,24 @@ function setupMessageHandler(sock: net.Socket, explorer: ProjectExplorer): void
     });
 }
 
+const watchedProjects = new WeakSet<AbstractProject>();
+
+/**
+ * Push the new config version to the proxy when a project is changed, the cached results are dropped
+*/
+function watchProjectChanges(prj: AbstractProject): void {
+    if (watchedProjects.has(prj)) {
+        return;
+    }
+    watchedProjects.add(prj);
+    const uid = prj.getUid();
+    prj.on('configVersionChanged', (version) => {
+        if (socket && !socket.destroyed) {
+            sendMessage(socket, { type: 'projectChanged', uid, version });
+        }
+    });
+}
+
 function setupProjectSync(sock: net.Socket, explorer: ProjectExplorer): void {
     const pushProjects = () => {
         if (sock.destroyed) {
@@ -275,6 +300,11 @@ function setupProjectSync(sock: net.Socket, explorer: ProjectExplorer): void {
         }
         sendMessage(sock, { type: 'projects', projects: collectProjects(explorer) });
     };
+    explorer.foreachProjects((prj) => {
+        watchProjectChanges(prj);
+        return undefined;
+    });
+    GlobalEvent.on('project.opened', (prj: AbstractProject) => watchProjectChanges(prj));
     GlobalEvent.on('project.opened', pushProjects);
     GlobalEvent.on('project.closed', pushProjects);
     GlobalEvent.on('project.activeStatusChanged', pushProjects);
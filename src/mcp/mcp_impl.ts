@@ -28,6 +28,13 @@ import { AbstractProject } from '../EIDEProject';
 import { BuilderOptions } from '../EIDETypeDefine';
 import { FlashCommandResult } from '../HexUploader';
 import { loadBuilderOptionsSchema, validateBuilderOptions } from './mcp_builder_opts_validate';
+import { McpToolProgress } from './mcp_protocol';
+import { parseBuildOutputLine, parseFlashOutputLine, ToolOutputReporter } from './mcp_progress';
+import { getMapFileTypeByToolchain, parseMapFileReport } from '../MapFileParser';
+import { SizeHistory } from '../SizeHistory';
+import { File } from '../../lib/node-utility/File';
+import * as yaml from 'yaml';
+import * as NodePath from 'path';
 
 function resolveProject(
     explorer: ProjectExplorer,
@@ -69,9 +76,15 @@ function makeJsonResult(data: unknown, isError = false): CallToolResult {
 export async function executeTool(
     tool: string,
     args: Record<string, unknown>,
-    explorer: ProjectExplorer
+    explorer: ProjectExplorer,
+    onProgress?: (progress: McpToolProgress) => void
 ): Promise<CallToolResult> {
     const uid = args.uid as string | null | undefined;
+    const report = (progress: McpToolProgress) => {
+        if (onProgress) {
+            onProgress(progress);
+        }
+    };
 
     switch (tool) {
         case 'eide_build':
@@ -81,13 +94,15 @@ export async function executeTool(
             if (!prj)
                 return projectNotFound(uid);
             let res: { success: boolean; message: string; };
+            const output = new ToolOutputReporter(parseBuildOutputLine, report);
             if (tool === 'eide_build') {
-                res = await explorer.buildProject(prj, { notRebuild: true, otherArgs: ['--no-color'] }, true);
+                res = await explorer.buildProject(prj, { notRebuild: true, otherArgs: ['--no-color'] }, true, text => output.write(text));
             } else if (tool === 'eide_rebuild') {
-                res = await explorer.buildProject(prj, { otherArgs: ['--no-color'] }, true);
+                res = await explorer.buildProject(prj, { otherArgs: ['--no-color'] }, true, text => output.write(text));
             } else {
                 res = await explorer.cleanProject(prj, true);
             }
+            output.end();
             return makeTextResult(res.success, res.message);
         }
         case 'eide_flash': {
@@ -95,13 +110,19 @@ export async function executeTool(
             if (!prj)
                 return projectNotFound(uid);
             const eraseAll = Boolean(args.eraseAll);
+            const output = new ToolOutputReporter(parseFlashOutputLine, report);
             let res: FlashCommandResult | void;
             if (eraseAll) {
-                res = await explorer.programFlashProject(prj, true, true);
-                if (!res || !res.success)
+                report({ kind: 'flash', message: 'Erase chip ...' });
+                res = await explorer.programFlashProject(prj, true, true, text => output.write(text));
+                if (!res || !res.success) {
+                    output.end();
                     return makeTextResult(false, res ? res.message : 'Failed to erase chip.');
+                }
             }
-            res = await explorer.programFlashProject(prj, false, true);
+            report({ kind: 'flash', message: 'Program flash ...' });
+            res = await explorer.programFlashProject(prj, false, true, text => output.write(text));
+            output.end();
             if (res) {
                 return makeTextResult(res.success, res.message, res.error);
             } else {
@@ -271,6 +292,53 @@ export async function executeTool(
                 return makeTextResult(false, 'Failed to set builder options.', error);
             }
         }
+        case 'eide_get_memory_usage': {
+            const prj = resolveProject(explorer, uid);
+            if (!prj)
+                return projectNotFound(uid);
+            const toolchainName = prj.getToolchain().name;
+            const mapType = getMapFileTypeByToolchain(toolchainName);
+            if (!mapType) {
+                return makeTextResult(false, `Not support map file of toolchain: '${toolchainName}'.`);
+            }
+            const mapFile = File.from(prj.getExecutablePathWithoutSuffix() + '.map');
+            if (!mapFile.IsFile()) {
+                return makeTextResult(false, `Not found map file: '${mapFile.path}', build the project first.`);
+            }
+            try {
+                let toolchainRoot: string | undefined;
+                const viewFile = File.from(mapFile.path + '.view');
+                if (viewFile.IsFile()) {
+                    const conf = yaml.parse(viewFile.Read());
+                    if (conf && conf.compilerPath)
+                        toolchainRoot = NodePath.dirname(NodePath.dirname(conf.compilerPath));
+                }
+                const depth = typeof args.depth == 'number' ? args.depth : 2;
+                const report = parseMapFileReport(mapFile.path, mapType, depth, { toolchainRoot });
+                return makeJsonResult({
+                    mapFile: prj.toRelativePath(mapFile.path) || mapFile.path,
+                    summary: report.summary,
+                    subtotal: report.subtotal,
+                    modules: report.modules
+                });
+            } catch (err) {
+                const error = err instanceof Error ? err : new Error(String(err));
+                return makeTextResult(false, 'Failed to parse map file.', error);
+            }
+        }
+        case 'eide_get_size_diff': {
+            const prj = resolveProject(explorer, uid);
+            if (!prj)
+                return projectNotFound(uid);
+            const history = SizeHistory.load(prj.getOutputFolder().path);
+            const base = typeof args.base == 'string' && args.base ? args.base : 'previous';
+            const top = typeof args.top == 'number' ? args.top : 20;
+            const diff = history.diff(base, top);
+            if (!diff) {
+                return makeTextResult(false, `No size record to compare (base: '${base}', records: ${history.count()}, tags: [${history.getTags().join(', ')}]).`);
+            }
+            return makeJsonResult(diff);
+        }
         default:
             return makeTextResult(false, `Unknown tool: ${tool}`);
     }
@@ -0,0 +1,209 @@
+/*
+    MIT License
+
+    Copyright (c) 2019 github0null
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+import { McpToolProgress } from './mcp_protocol';
+
+/**
+ * Splits a text stream into lines, '\r' is also a line end (progress bars of the flashers)
+*/
+export class LineSplitter {
+
+    private rest = '';
+
+    push(text: string): string[] {
+        const parts = (this.rest + text).split(/\r\n|\r|\n/);
+        this.rest = parts.pop() ?? '';
+        return parts;
+    }
+
+    end(): string[] {
+        const rest = this.rest;
+        this.rest = '';
+        return rest ? [rest] : [];
+    }
+}
+
+const diagnosticMatchers: { regexp: RegExp, file: number, line: number, severity: number, message: number }[] = [
+    // gcc, clang, armclang: 'src/main.c:12:5: error: ...'
+    { regexp: /^(.+?):(\d+):(?:\d+:)?\s*(fatal error|error|warning):\s*(.+)$/i, file: 1, line: 2, severity: 3, message: 4 },
+    // armcc: '"src/main.c", line 12: Error:  #20: ...'
+    { regexp: /^"(.+?)", line (\d+):\s*(Error|Warning):\s*(.+)$/i, file: 1, line: 2, severity: 3, message: 4 },
+    // iar: '"src/main.c",12  Error[Pe020]: ...'
+    { regexp: /^"(.+?)",(\d+)\s+(Fatal error|Error|Warning)\[\w+\]:\s*(.+)$/i, file: 1, line: 2, severity: 3, message: 4 },
+];
+
+/**
+ * Parse a line of the builder output
+ *  - '>> [ 20%] CC 'src/main.c'' -> build progress
+ *  - '[ INFO ] start linking ...' -> build step
+ *  - compiler errors and warnings -> diagnostic
+*/
+export function parseBuildOutputLine(line: string): McpToolProgress | undefined {
+
+    const text = line.trim();
+    if (text === '') {
+        return undefined;
+    }
+
+    let m = /^(?:>>\s*)?\[\s*(\d{1,3})%\]\s*(.+)$/.exec(text);
+    if (m) {
+        return { kind: 'build', percent: Math.min(100, parseInt(m[1], 10)), message: m[2] };
+    }
+
+    m = /^\[\s*(INFO|DONE|WARN|ERROR)\s*\]\s*(.+)$/i.exec(text);
+    if (m) {
+        return { kind: 'build', message: m[2] };
+    }
+
+    for (const matcher of diagnosticMatchers) {
+        m = matcher.regexp.exec(text);
+        if (m) {
+            const severity = m[matcher.severity].toLowerCase().includes('error') ? 'error' : 'warning';
+            return {
+                kind: 'diagnostic',
+                severity,
+                message: `${m[matcher.file]}:${m[matcher.line]}: ${severity}: ${m[matcher.message]}`
+            };
+        }
+    }
+
+    if (/undefined reference to|multiple definition of|region .+ overflowed/.test(text)) {
+        return { kind: 'diagnostic', severity: 'error', message: text };
+    }
+
+    return undefined;
+}
+
+/**
+ * The error lines of the flashers: 'Error: ...' (OpenOCD, STM32CubeProgrammer), 'ERROR: ...' and
+ * '****** Error: ...' (JLink), '0001234 E ...' (pyOCD log), or a 'failed' message,
+ * the counters such as '0 errors' or 'failed: 0' are not errors
+*/
+function isFlashErrorLine(text: string): boolean {
+    if (/^(?:\*+\s*)?error\b\s*[:!]/i.test(text) || /^\d+\s+[CE]\s/.test(text)) {
+        return true;
+    }
+    return /\bfailed\b/i.test(text) && !/\b0\s+failed\b|\bfailed\s*[:=]?\s*0\b/i.test(text);
+}
+
+/**
+ * Parse a line of the flasher output (JLink, pyOCD, OpenOCD, STM32CubeProgrammer ...)
+*/
+export function parseFlashOutputLine(line: string): McpToolProgress | undefined {
+
+    const text = line.trim();
+    if (text === '') {
+        return undefined;
+    }
+
+    if (isFlashErrorLine(text)) {
+        return { kind: 'diagnostic', severity: 'error', message: text };
+    }
+
+    const m = /(\d{1,3}(?:\.\d+)?)\s*%/.exec(text);
+    if (m) {
+        return { kind: 'flash', percent: Math.min(100, parseFloat(m[1])), message: text };
+    }
+
+    if (/\b(eras|program|download|writ|verif|reset|connect)\w*/i.test(text)) {
+        return { kind: 'flash', message: text };
+    }
+
+    return undefined;
+}
+
+export const maxDiagnosticsPerCall = 200;
+
+/**
+ * Parse the output of a tool, report the progress to the caller.
+ *
+ * Diagnostics are reported at once (at most 'maxDiagnosticsPerCall'),
+ * the progress is throttled, only the latest one in the interval is reported.
+*/
+export class ToolOutputReporter {
+
+    private lines = new LineSplitter();
+    private pending: McpToolProgress | undefined;
+    private timer: NodeJS.Timeout | undefined;
+    private lastSent = 0;
+    private diagnostics = new Set<string>();
+
+    constructor(
+        private readonly parser: (line: string) => McpToolProgress | undefined,
+        private readonly report: (progress: McpToolProgress) => void,
+        private readonly intervalMs = 200
+    ) {
+    }
+
+    write(text: string): void {
+        for (const line of this.lines.push(text)) {
+            this.parseLine(line);
+        }
+    }
+
+    end(): void {
+        for (const line of this.lines.end()) {
+            this.parseLine(line);
+        }
+        this.flush();
+    }
+
+    private parseLine(line: string): void {
+
+        const progress = this.parser(line);
+        if (!progress) {
+            return;
+        }
+
+        if (progress.kind === 'diagnostic') {
+            if (this.diagnostics.size < maxDiagnosticsPerCall && !this.diagnostics.has(progress.message)) {
+                this.diagnostics.add(progress.message);
+                this.report(progress);
+            }
+            return;
+        }
+
+        this.pending = progress;
+
+        const wait = this.lastSent + this.intervalMs - Date.now();
+        if (wait <= 0) {
+            this.flush();
+        } else if (!this.timer) {
+            this.timer = setTimeout(() => this.flush(), wait);
+        }
+    }
+
+    private flush(): void {
+        if (this.timer) {
+            clearTimeout(this.timer);
+            this.timer = undefined;
+        }
+        if (this.pending) {
+            const progress = this.pending;
+            this.pending = undefined;
+            this.lastSent = Date.now();
+            this.report(progress);
+        }
+    }
+}
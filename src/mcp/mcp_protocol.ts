@@ -32,6 +32,8 @@ import { CallToolResult } from '@modelcontextprotocol/sdk/types';
 export interface McpProjectInfo {
     uid: string;
     name: string;
+    /** config version of the project, see 'AbstractProject.getConfigVersion()' */
+    version?: number;
 }
 
 export interface McpHealthResponse {
@@ -58,18 +60,49 @@ export function isMcpHealthCompatible(
     return health.version === expectedVersion && health.bundleId === expectedBundleId;
 }
 
+/**
+ * progress of a running tool call, sent before the 'toolResult'
+*/
+export interface McpToolProgress {
+    kind: 'build' | 'flash' | 'diagnostic';
+    message: string;
+    /** percentage of the current step, 0 ~ 100 */
+    percent?: number;
+    /** only for 'diagnostic' */
+    severity?: 'error' | 'warning' | 'info';
+}
+
 export type IpcMessage =
     | { type: 'register'; instanceId: string; projects: McpProjectInfo[] }
     | { type: 'projects'; projects: McpProjectInfo[] }
     | { type: 'toolCall'; requestId: string; tool: string; args: Record<string, unknown> }
-    | { type: 'toolResult'; requestId: string; result: CallToolResult }
+    | { type: 'toolProgress'; requestId: string; progress: McpToolProgress }
+    | { type: 'toolResult'; requestId: string; result: CallToolResult; version?: number }
+    | { type: 'projectChanged'; uid: string; version: number }
     | { type: 'ping' }
     | { type: 'pong' };
 
+/**
+ * Tools which only read the project config, their results are cached by the proxy
+ * until the config version of the project is changed
+*/
+export const mcpReadOnlyTools: [string, ...string[]] = [
+    'eide_get_targets',
+    'eide_get_src_dirs',
+    'eide_get_inc_dirs',
+    'eide_get_defines',
+    'eide_get_builder_opts',
+    'eide_get_builder_opts_schema'
+];
+
+export const mcpBatchQueryTool = 'eide_batch_query';
+
 export const idleShutdownMs = 30_000;
 export const ipcConnectTimeoutMs = 5_000;
 export const ipcPingIntervalMs = 10_000;
+/** a tool call fails if there is no progress or result in this time */
 export const toolCallTimeoutMs = 300_000;
+export const ipcMaxFrameSize = 256 * 1024 * 1024;
 export const healthCheckTimeoutMs = 3_000;
 
 const mcpTmpSubDir = 'eide-mcp';
@@ -126,24 +159,125 @@ export function appendMcpLog(logPath: string, msg: string): void {
 }
 
 export function encodeMessage(msg: IpcMessage): Buffer {
-    const body = Buffer.from(JSON.stringify(msg), 'utf8');
-    const header = Buffer.alloc(4);
-    header.writeUInt32BE(body.length, 0);
-    return Buffer.concat([header, body]);
+    const json = JSON.stringify(msg);
+    const bodyLen = Buffer.byteLength(json, 'utf8');
+    const frame = Buffer.allocUnsafe(4 + bodyLen);
+    frame.writeUInt32BE(bodyLen, 0);
+    frame.write(json, 4, 'utf8');
+    return frame;
 }
 
-export function attachFrameReader(socket: net.Socket, onMessage: (msg: IpcMessage) => void): void {
-    let buffer = Buffer.alloc(0);
+/**
+ * Splits the length prefixed frames of a stream.
+ *
+ * The received chunks are kept in a list, a frame inside one chunk is returned
+ * as a view of the chunk, a frame across chunks is copied once into its own buffer.
+*/
+export class FrameDecoder {
 
-    socket.on('data', (chunk: Buffer) => {
-        buffer = Buffer.concat([buffer, chunk]);
-        while (buffer.length >= 4) {
-            const bodyLen = buffer.readUInt32BE(0);
-            if (buffer.length < 4 + bodyLen) {
+    private chunks: Buffer[] = [];
+    private offset = 0; // read position in chunks[0]
+    private buffered = 0;
+    private bodyLen = -1;
+
+    constructor(private readonly maxFrameSize: number = ipcMaxFrameSize) {
+    }
+
+    /**
+     * @returns the bodies of the completed frames
+     * @throws if a frame is larger than the max frame size
+    */
+    push(chunk: Buffer): Buffer[] {
+
+        const frames: Buffer[] = [];
+
+        if (chunk.length === 0) {
+            return frames;
+        }
+
+        this.chunks.push(chunk);
+        this.buffered += chunk.length;
+
+        for (;;) {
+            if (this.bodyLen < 0) {
+                if (this.buffered < 4) {
+                    break;
+                }
+                this.bodyLen = this.take(4).readUInt32BE(0);
+                if (this.bodyLen > this.maxFrameSize) {
+                    throw new Error(`IPC frame too large: ${this.bodyLen} bytes`);
+                }
+            }
+            if (this.buffered < this.bodyLen) {
                 break;
             }
-            const body = buffer.subarray(4, 4 + bodyLen);
-            buffer = buffer.subarray(4 + bodyLen);
+            frames.push(this.take(this.bodyLen));
+            this.bodyLen = -1;
+        }
+
+        return frames;
+    }
+
+    /** bytes waiting for the rest of a frame */
+    get pendingBytes(): number {
+        return this.buffered;
+    }
+
+    private skip(n: number): void {
+        this.offset += n;
+        this.buffered -= n;
+        if (this.offset === this.chunks[0].length) {
+            this.chunks.shift();
+            this.offset = 0;
+        }
+    }
+
+    private take(n: number): Buffer {
+
+        const head = this.chunks[0];
+
+        if (n === 0) {
+            return Buffer.alloc(0);
+        }
+
+        if (head.length - this.offset >= n) {
+            const view = head.subarray(this.offset, this.offset + n);
+            this.skip(n);
+            return view;
+        }
+
+        const out = Buffer.allocUnsafe(n);
+        let copied = 0;
+        let used = 0;
+        while (copied < n) {
+            const cur = this.chunks[used];
+            const len = Math.min(cur.length - this.offset, n - copied);
+            cur.copy(out, copied, this.offset, this.offset + len);
+            copied += len;
+            this.offset += len;
+            if (this.offset === cur.length) {
+                this.offset = 0;
+                used++;
+            }
+        }
+        this.chunks.splice(0, used);
+        this.buffered -= n;
+        return out;
+    }
+}
+
+export function attachFrameReader(socket: net.Socket, onMessage: (msg: IpcMessage) => void): void {
+    const decoder = new FrameDecoder();
+
+    socket.on('data', (chunk: Buffer) => {
+        let frames: Buffer[];
+        try {
+            frames = decoder.push(chunk);
+        } catch (err) {
+            socket.destroy(err instanceof Error ? err : new Error(String(err)));
+            return;
+        }
+        for (const body of frames) {
             try {
                 onMessage(JSON.parse(body.toString('utf8')) as IpcMessage);
             } catch {
@@ -24,12 +24,19 @@
 
 import * as z from 'zod/v4';
 import { McpServer } from '@modelcontextprotocol/sdk/server/mcp';
-import { CallToolResult } from '@modelcontextprotocol/sdk/types';
+import { CallToolResult, ServerNotification, ServerRequest } from '@modelcontextprotocol/sdk/types';
+import { RequestHandlerExtra } from '@modelcontextprotocol/sdk/shared/protocol';
+import { mcpBatchQueryTool, mcpReadOnlyTools } from './mcp_protocol';
 import { InMemoryTaskStore, InMemoryTaskMessageQueue } from '@modelcontextprotocol/sdk/experimental/tasks/stores/in-memory';
 
 const taskStore = new InMemoryTaskStore();
 
-export type ToolDelegate = (tool: string, args: Record<string, unknown>) => Promise<CallToolResult>;
+export type ToolCallExtra = RequestHandlerExtra<ServerRequest, ServerNotification>;
+
+/**
+ * @param extra is passed by the long running tools, they report the progress by it
+*/
+export type ToolDelegate = (tool: string, args: Record<string, unknown>, extra?: ToolCallExtra) => Promise<CallToolResult>;
 
 export function createMcpServer(delegateToolCall: ToolDelegate): McpServer {
 
@@ -56,7 +63,7 @@ export function createMcpServer(delegateToolCall: ToolDelegate): McpServer {
             description: 'Build your eide project.',
             inputSchema: { uid: uidSchema }
         },
-        async (args) => delegateToolCall('eide_build', args)
+        async (args, extra) => delegateToolCall('eide_build', args, extra)
     );
 
     server.registerTool(
@@ -66,7 +73,7 @@ export function createMcpServer(delegateToolCall: ToolDelegate): McpServer {
             description: 'Rebuild your eide project.',
             inputSchema: { uid: uidSchema }
         },
-        async (args) => delegateToolCall('eide_rebuild', args)
+        async (args, extra) => delegateToolCall('eide_rebuild', args, extra)
     );
 
     server.registerTool(
@@ -76,7 +83,7 @@ export function createMcpServer(delegateToolCall: ToolDelegate): McpServer {
             description: `Clean up the generated products in the "build" directory.`,
             inputSchema: { uid: uidSchema }
         },
-        async (args) => delegateToolCall('eide_clean', args)
+        async (args, extra) => delegateToolCall('eide_clean', args, extra)
     );
 
     server.registerTool(
@@ -89,7 +96,7 @@ export function createMcpServer(delegateToolCall: ToolDelegate): McpServer {
                 eraseAll: z.boolean().describe('Determine whether to perform a chip erase of the mcu.')
             }
         },
-        async (args) => delegateToolCall('eide_flash', args)
+        async (args, extra) => delegateToolCall('eide_flash', args, extra)
     );
 
     server.registerTool(
@@ -268,5 +275,50 @@ export function createMcpServer(delegateToolCall: ToolDelegate): McpServer {
         async (args) => delegateToolCall('eide_set_builder_opts', args)
     );
 
+    server.registerTool(
+        'eide_get_memory_usage',
+        {
+            title: 'Get memory usage',
+            description: 'Parse the linker map file of the last build, get flash/ram usage and the section sizes (.text, .data, .bss, .rodata) of each module.',
+            inputSchema: {
+                uid: uidSchema,
+                depth: z.number().int().min(0).optional().describe(
+                    'Directory depth used to group modules, 0 means list every object file. Default is 2.'
+                )
+            }
+        },
+        async (args) => delegateToolCall('eide_get_memory_usage', args)
+    );
+
+    server.registerTool(
+        'eide_get_size_diff',
+        {
+            title: 'Get code size diff',
+            description: 'Compare the code size (rom/ram, sections, top growing symbols and objects) of the latest build with the previous build or a baseline tag.',
+            inputSchema: {
+                uid: uidSchema,
+                base: z.string().optional().describe(
+                    'Base build to compare with: "previous" (default), a baseline tag name, or a record id like "#12".'
+                ),
+                top: z.number().int().min(1).optional().describe('Max number of growing symbols/objects in the result. Default is 20.')
+            }
+        },
+        async (args) => delegateToolCall('eide_get_size_diff', args)
+    );
+
+    server.registerTool(
+        mcpBatchQueryTool,
+        {
+            title: 'Batch query',
+            description: 'Run several read-only queries of a project in one call, returns a JSON object keyed by the tool name. ' +
+                'Prefer it to gather the project context, the results are cached until the project is changed.',
+            inputSchema: {
+                uid: uidSchema,
+                tools: z.array(z.enum(mcpReadOnlyTools)).min(1).describe('The read-only tools to call, their only argument is "uid".')
+            }
+        },
+        async (args) => delegateToolCall(mcpBatchQueryTool, args)
+    );
+
     return server;
 }
@@ -33,7 +33,8 @@ import { InMemoryEventStore } from '@modelcontextprotocol/sdk/examples/shared/in
 import { CallToolResult } from '@modelcontextprotocol/sdk/types';
 import * as FileLock from '../../lib/node-utility/FileLock';
 import { File } from '../../lib/node-utility/File';
-import { createMcpServer } from './mcp_proxy_tools';
+import { createMcpServer, ToolCallExtra } from './mcp_proxy_tools';
+import { ToolResultCache } from './mcp_cache';
 import {
     appendMcpLog,
     attachFrameReader,
@@ -43,7 +44,10 @@ import {
     getMcpTmpDir,
     idleShutdownMs,
     IpcMessage,
+    mcpBatchQueryTool,
     McpProjectInfo,
+    mcpReadOnlyTools,
+    McpToolProgress,
     sendMessage,
     toolCallTimeoutMs
 } from './mcp_protocol';
@@ -57,21 +61,47 @@ interface ExtensionInstance {
     registeredAt: number;
 }
 
+interface PendingToolCall {
+    instanceId: string;
+    tool: string;
+    uid?: string;
+    resolve: (r: CallToolResult) => void;
+    reject: (e: Error) => void;
+    timer: NodeJS.Timeout;
+    onProgress?: (progress: McpToolProgress) => void;
+}
+
+/**
+ * Routes the tool calls to the extension instances.
+ *
+ * The calls are multiplexed on the IPC socket of an instance by the request id,
+ * a call is failed if its instance is disconnected, or if no progress or result
+ * is received in 'toolCallTimeoutMs'.
+ *
+ * The results of the read-only tools are cached by the config version of the projects,
+ * which is pushed by the extension when a project is changed.
+*/
 class InstanceRouter {
     private instances = new Map<string, ExtensionInstance>();
     private sessionToInstance = new Map<string, string>();
-    private pendingToolCalls = new Map<string, {
-        resolve: (r: CallToolResult) => void;
-        reject: (e: Error) => void;
-        timer: NodeJS.Timeout;
-    }>();
+    private pendingToolCalls = new Map<string, PendingToolCall>();
+    private resultCache = new ToolResultCache();
 
     register(instance: ExtensionInstance): void {
         this.instances.set(instance.instanceId, instance);
+        this.syncProjectVersions(instance.projects);
     }
 
     unregister(instanceId: string): void {
         this.instances.delete(instanceId);
+        for (const [requestId, pending] of this.pendingToolCalls) {
+            if (pending.instanceId === instanceId) {
+                clearTimeout(pending.timer);
+                this.pendingToolCalls.delete(requestId);
+                pending.reject(new Error(`EIDE extension instance disconnected (id=${instanceId}) while running tool: ${pending.tool}`));
+            }
+        }
+        this.retainProjects();
         for (const [sessionId, boundId] of this.sessionToInstance) {
             if (boundId === instanceId) {
                 this.sessionToInstance.delete(sessionId);
@@ -83,7 +113,37 @@ class InstanceRouter {
         const inst = this.instances.get(instanceId);
         if (inst) {
             inst.projects = projects;
+            this.syncProjectVersions(projects);
+            this.retainProjects();
+        }
+    }
+
+    handleProjectChanged(instanceId: string, uid: string, version: number): void {
+        const prj = this.instances.get(instanceId)?.projects.find(p => p.uid === uid);
+        if (prj) {
+            prj.version = version;
+            this.resultCache.setVersion(uid, version);
+        }
+    }
+
+    getCacheStats(): { hits: number; misses: number } {
+        return { hits: this.resultCache.hits, misses: this.resultCache.misses };
+    }
+
+    private syncProjectVersions(projects: McpProjectInfo[]): void {
+        for (const prj of projects) {
+            if (prj.version !== undefined) {
+                this.resultCache.setVersion(prj.uid, prj.version);
+            }
+        }
+    }
+
+    private retainProjects(): void {
+        const uids: string[] = [];
+        for (const inst of this.instances.values()) {
+            uids.push(...inst.projects.map(p => p.uid));
         }
+        this.resultCache.retain(uids);
     }
 
     pickEarliestInstanceId(): string | undefined {
@@ -129,20 +189,120 @@ class InstanceRouter {
         return this.instances.has(defaultInstanceId) ? defaultInstanceId : undefined;
     }
 
-    handleToolResult(requestId: string, result: CallToolResult): void {
+    getPendingCount(instanceId: string): number {
+        let count = 0;
+        for (const pending of this.pendingToolCalls.values()) {
+            if (pending.instanceId === instanceId) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    handleToolResult(instanceId: string, requestId: string, result: CallToolResult, version?: number): void {
         const pending = this.pendingToolCalls.get(requestId);
-        if (!pending) {
+        if (!pending || pending.instanceId !== instanceId) {
             return;
         }
         clearTimeout(pending.timer);
         this.pendingToolCalls.delete(requestId);
+        // the version when the result is made, it's the latest one since the messages are in order
+        if (pending.uid && version !== undefined) {
+            this.handleProjectChanged(instanceId, pending.uid, version);
+        }
         pending.resolve(result);
     }
 
+    handleToolProgress(instanceId: string, requestId: string, progress: McpToolProgress): void {
+        const pending = this.pendingToolCalls.get(requestId);
+        if (!pending || pending.instanceId !== instanceId) {
+            return;
+        }
+        pending.timer.refresh();
+        if (pending.onProgress) {
+            try {
+                pending.onProgress(progress);
+            } catch {
+                // ignore
+            }
+        }
+    }
+
+    /**
+     * Call a tool, the read-only tools are answered from the cache if the project is not changed
+    */
+    async callTool(
+        tool: string,
+        args: Record<string, unknown>,
+        defaultInstanceId: string,
+        onProgress?: (progress: McpToolProgress) => void
+    ): Promise<{ result: CallToolResult; cached: boolean }> {
+        const uid = typeof args.uid === 'string' && args.uid ? args.uid : undefined;
+
+        if (tool === mcpBatchQueryTool) {
+            return { result: await this.batchQuery(args, defaultInstanceId), cached: false };
+        }
+
+        if (!uid) {
+            return { result: await this.delegateToolCall(tool, args, defaultInstanceId, onProgress), cached: false };
+        }
+
+        if (!mcpReadOnlyTools.includes(tool)) {
+            // the project may be changed by this tool
+            this.resultCache.invalidate(uid);
+            return { result: await this.delegateToolCall(tool, args, defaultInstanceId, onProgress), cached: false };
+        }
+
+        const cached = this.resultCache.get(uid, tool, args);
+        if (cached) {
+            return { result: cached, cached: true };
+        }
+
+        const token = this.resultCache.begin(uid);
+        const result = await this.delegateToolCall(tool, args, defaultInstanceId, onProgress);
+        this.resultCache.set(uid, tool, args, token, this.resultCache.getVersion(uid), result);
+        return { result, cached: false };
+    }
+
+    /**
+     * Run several read-only queries of a project in parallel, the results are merged into a JSON object
+    */
+    private async batchQuery(args: Record<string, unknown>, defaultInstanceId: string): Promise<CallToolResult> {
+        const tools = Array.isArray(args.tools) ? Array.from(new Set(args.tools as string[])) : [];
+        const unknown = tools.filter(t => !mcpReadOnlyTools.includes(t));
+        if (tools.length === 0 || unknown.length > 0) {
+            return {
+                isError: true,
+                content: [{ type: 'text', text: `'tools' must be a list of: ${mcpReadOnlyTools.join(', ')}` + (unknown.length ? `, unknown: ${unknown.join(', ')}` : '') }]
+            };
+        }
+
+        const results = await Promise.all(tools.map(t => this.callTool(t, { uid: args.uid }, defaultInstanceId)));
+
+        const data: Record<string, unknown> = {};
+        tools.forEach((tool, i) => {
+            const res = results[i].result;
+            const text = res.content.map(c => c.type === 'text' ? c.text : '').join('');
+            let value: unknown;
+            try {
+                value = JSON.parse(text);
+            } catch {
+                value = text;
+            }
+            data[tool] = res.isError ? { error: value } : value;
+        });
+
+        return {
+            isError: results.every(r => r.result.isError),
+            content: [{ type: 'text', text: JSON.stringify(data, null, 2) }]
+        };
+    }
+
     delegateToolCall(
         tool: string,
         args: Record<string, unknown>,
-        defaultInstanceId: string
+        defaultInstanceId: string,
+        onProgress?: (progress: McpToolProgress) => void
     ): Promise<CallToolResult> {
         const hintUid = args.uid as string | null | undefined;
         const instanceId = this.resolveInstance(defaultInstanceId, hintUid);
@@ -167,7 +327,8 @@ class InstanceRouter {
                 reject(new Error(`Tool call timed out: ${tool}`));
             }, toolCallTimeoutMs);
 
-            this.pendingToolCalls.set(requestId, { resolve, reject, timer });
+            const uid = typeof hintUid === 'string' && hintUid ? hintUid : undefined;
+            this.pendingToolCalls.set(requestId, { instanceId, tool, uid, resolve, reject, timer, onProgress });
             sendMessage(inst.socket, { type: 'toolCall', requestId, tool, args });
         }).catch(err => ({
             isError: true,
@@ -176,6 +337,40 @@ class InstanceRouter {
     }
 }
 
+/**
+ * Forward the progress of a tool call to the MCP client:
+ *  - build/flash steps -> 'notifications/progress', if the client asked for it by a progress token
+ *  - diagnostics -> 'notifications/message'
+*/
+function createProgressForwarder(tool: string, extra: ToolCallExtra | undefined): ((progress: McpToolProgress) => void) | undefined {
+    if (!extra) {
+        return undefined;
+    }
+    const progressToken = extra._meta?.progressToken;
+    let count = 0;
+    return (progress: McpToolProgress) => {
+        if (extra.signal.aborted) {
+            return;
+        }
+        if (progress.kind === 'diagnostic') {
+            extra.sendNotification({
+                method: 'notifications/message',
+                params: { level: progress.severity ?? 'warning', logger: tool, data: progress.message }
+            }).catch(() => { /* session closed */ });
+        } else if (progressToken !== undefined) {
+            // the progress must be increased, the percentage of a step is put into the message
+            extra.sendNotification({
+                method: 'notifications/progress',
+                params: {
+                    progressToken,
+                    progress: ++count,
+                    message: progress.percent !== undefined ? `[${progress.percent}%] ${progress.message}` : progress.message
+                }
+            }).catch(() => { /* session closed */ });
+        }
+    };
+}
+
 interface ProxyArgs {
     port: number;
     version: string;
@@ -227,7 +422,8 @@ async function main(): Promise<void> {
     let ipcServer: net.Server | undefined;
 
     const cleanup = async () => {
-        logInfo('Shutting down mcp proxy...');
+        const cache = instanceRouter.getCacheStats();
+        logInfo(`Shutting down mcp proxy... (result cache: ${cache.hits} hits, ${cache.misses} misses)`);
         for (const sessionId in transports) {
             try {
                 await transports[sessionId].close();
@@ -278,8 +474,12 @@ async function main(): Promise<void> {
             } else if (msg.type === 'projects' && instanceId) {
                 instanceRouter.updateProjects(instanceId, msg.projects);
                 logInfo(`Extension projects changed: ${instanceId} (${msg.projects.length} projects)`);
+            } else if (msg.type === 'toolProgress') {
+                instanceRouter.handleToolProgress(instanceId, msg.requestId, msg.progress);
             } else if (msg.type === 'toolResult') {
-                instanceRouter.handleToolResult(msg.requestId, msg.result);
+                instanceRouter.handleToolResult(instanceId, msg.requestId, msg.result, msg.version);
+            } else if (msg.type === 'projectChanged' && instanceId) {
+                instanceRouter.handleProjectChanged(instanceId, msg.uid, msg.version);
             } else if (msg.type === 'pong') {
                 // keepalive
             }
@@ -360,11 +560,16 @@ async function main(): Promise<void> {
                     }
                 };
 
-                const server = createMcpServer(async (tool, args) => {
+                const server = createMcpServer(async (tool, args, extra) => {
                     const started = performance.now();
-                    const result = await instanceRouter.delegateToolCall(tool, args, boundInstanceId);
+                    const running = instanceRouter.getPendingCount(boundInstanceId);
+                    const onProgress = createProgressForwarder(tool, extra);
+                    const { result, cached } = await instanceRouter.callTool(tool, args, boundInstanceId, onProgress);
+                    if (cached) {
+                        return result; // not logged, it's cheap and frequent
+                    }
                     const sec = ((performance.now() - started) / 1000).toFixed(2);
-                    logInfo(`call tool "${tool}" -> ${result.isError ? 'fail' : 'ok'}, ${sec}sec`);
+                    logInfo(`call tool "${tool}" -> ${result.isError ? 'fail' : 'ok'}, ${sec}sec` + (running > 0 ? ` (${running} calls in parallel)` : ''));
                     return result;
                 });
                 await server.connect(transport);
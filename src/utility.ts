@@ -44,6 +44,10 @@ import { GlobalEvent } from './GlobalEvents';
 import { SettingManager } from './SettingManager';
 import { ToolchainName } from './ToolchainManager';
 import { Time } from '../lib/node-utility/Time';
+import { CxxDemangler } from './CxxDemangler';
+import { FileDownloader, DownloadOptions, DownloadResult, DownloadCanceledError } from './FileDownloader';
+import { CompilerProbeCache } from './CompilerProbeCache';
+import { ToolCatalog, toolStamp, folderStamp, scanFiles } from './ToolCatalog';
 
 export const TIME_ONE_MINUTE = 60 * 1000;
 export const TIME_ONE_HOUR = 3600 * 1000;
@@ -109,11 +113,21 @@ export function reverseStringMap(original: Map<string, string>): Map<string, str
 */
 export function cxxDemangle(name: string, cxxfilt_path?: string): string {
     cxxfilt_path = cxxfilt_path || `arm-none-eabi-c++filt${platform.exeSuffix()}`;
-    try {
-        return child_process.execFileSync(cxxfilt_path, [name]).toString().trim();
-    } catch (error) {
-        return name;
+    return getCxxDemangler().demangleSync([name], cxxfilt_path).get(name) || name;
+}
+
+let _cxxDemangler: CxxDemangler | undefined;
+
+/**
+ * Get the shared C++ demangler, the demangled names are cached in the eide tmp folder.
+ * Prefer `getCxxDemangler().demangle(names, ...)` to demangle a lot of names at once.
+*/
+export function getCxxDemangler(): CxxDemangler {
+    if (_cxxDemangler == undefined) {
+        const cacheFile = File.from(ResManager.instance().GetTmpDir().path, 'eide.cxxnames.json');
+        _cxxDemangler = new CxxDemangler(cacheFile.path);
     }
+    return _cxxDemangler;
 }
 
 export function parseCliArgs(cliStr: string): string[] {
@@ -281,14 +295,18 @@ export function timeStamp(): string {
         "source": "builtin"
        }
     ]
+ *
+ * The list is cached by `getToolCatalog()`, pyocd is only run synchronously if it's never cached
 */
 export function pyocd_getTargetList(projectRootDir: File | undefined, pyocdConfigPath: string | undefined): any[] {
 
     const cmdList: string[] = ['pyocd', 'json'];
+    const stampFiles: (string | undefined)[] = [platform.find('pyocd')];
 
     if (projectRootDir) {
         const cwd = projectRootDir.path;
         cmdList.push('-j', `"${cwd}"`);
+        stampFiles.push(File.from(cwd, 'pyocd.yaml').path, File.from(cwd, 'pyocd.yml').path);
     }
 
     if (pyocdConfigPath) {
@@ -297,20 +315,53 @@ export function pyocd_getTargetList(projectRootDir: File | undefined, pyocdConfi
                 cmdList.push('--config', `"${projectRootDir.ToRelativePath(pyocdConfigPath) || pyocdConfigPath}"`);
             else
                 cmdList.push('--config', `"${pyocdConfigPath}"`);
+            stampFiles.push(pyocdConfigPath);
         }
     }
 
     cmdList.push('-t');
 
     const command = cmdList.join(' ');
-    const result = JSON.parse(child_process.execSync(command).toString());
+    const cwd = projectRootDir ? projectRootDir.path : os.homedir();
+
+    // the targets of the packs installed by 'pyocd pack install' are listed too
+    const packDir = pyocd_getPackCacheDir();
+    stampFiles.push(NodePath.join(packDir, 'index.json'));
+    const stamp = `${toolStamp(stampFiles)};${folderStamp(packDir, 2)}`;
+
+    return getToolCatalog().getSync<any>(`pyocd-targets:${command}`, stamp,
+        () => pyocd_parseTargetList(child_process.execSync(command, { cwd: cwd, maxBuffer: 16 * 1024 * 1024 }).toString()),
+        () => execProbe(command, cwd).then((stdout) => pyocd_parseTargetList(stdout)));
+}
+
+/**
+ * The pack cache of pyocd (the user data folder of 'cmsis-pack-manager'),
+ * the installed packs are saved as '<vendor>/<name>/<version>.pack'
+*/
+function pyocd_getPackCacheDir(): string {
+    switch (os.platform()) {
+        case 'win32':
+            return NodePath.join(process.env['LOCALAPPDATA'] || NodePath.join(os.homedir(), 'AppData', 'Local'),
+                'cmsis-pack-manager', 'cmsis-pack-manager');
+        case 'darwin':
+            return NodePath.join(os.homedir(), 'Library', 'Application Support', 'cmsis-pack-manager');
+        default:
+            return NodePath.join(process.env['XDG_DATA_HOME'] || NodePath.join(os.homedir(), '.local', 'share'),
+                'cmsis-pack-manager');
+    }
+}
+
+function pyocd_parseTargetList(stdout: string): any[] {
+    const result = JSON.parse(stdout);
     if (!Array.isArray(result['targets'])) {
         throw new Error(`Wrong pyocd targets format, 'targets' must be an array !`);
     }
-
     return result['targets'].map(t => t);
 }
 
+/**
+ * The built-in configs are cached by `getToolCatalog()`, the configs in workspace are always listed
+*/
 export function openocd_getConfigList(category: 'interface' | 'target', projectRootDir: File | undefined): { name: string, isInWorkspace?: boolean; }[] {
 
     const openocdExe = new File(SettingManager.GetInstance().getOpenOCDExePath());
@@ -337,12 +388,13 @@ export function openocd_getConfigList(category: 'interface' | 'target', projectR
     for (const path of ['scripts', 'share/openocd/scripts', 'openocd/scripts']) {
         const cfgFolder = File.from(openocdExe.dir, '..', path, category);
         if (cfgFolder.IsDir()) {
-            cfgFolder.GetAll([/\.cfg$/i], File.EXCLUDE_ALL_FILTER).forEach((file) => {
-                const rePath = (cfgFolder.ToRelativePath(file.path) || file.name);
-                resultList.push({
-                    name: File.ToUnixPath(rePath).replace('.cfg', '')
-                });
-            });
+            const names = getToolCatalog().getSync<string>(`openocd-configs:${cfgFolder.path}`,
+                `${toolStamp([openocdExe.path])};${folderStamp(cfgFolder.path)}`,
+                () => cfgFolder.GetAll([/\.cfg$/i], File.EXCLUDE_ALL_FILTER)
+                    .map((file) => File.ToUnixPath(cfgFolder.ToRelativePath(file.path) || file.name).replace('.cfg', '')),
+                () => scanFiles(cfgFolder.path, /\.cfg$/i)
+                    .then((list) => list.map((rePath) => rePath.replace('.cfg', ''))));
+            names.forEach((name) => resultList.push({ name: name }));
             break; // break it if we found
         }
     }
@@ -398,23 +450,75 @@ export class CppMacroParser {
     }
 }
 
+let _toolCatalog: ToolCatalog | undefined;
+
+/**
+ * The cache of the lists exported by the flasher tools in '~/.eide', it's shared by all projects and vscode windows
+*/
+export function getToolCatalog(): ToolCatalog {
+    if (_toolCatalog == undefined) {
+        const cacheFile = File.fromArray([ResManager.GetInstance().getEideHomeFolder().path, 'tool-catalogs.json']);
+        _toolCatalog = new ToolCatalog(cacheFile.path, {
+            onError: (name, error) => GlobalEvent.log_warn(`Failed to rebuild the catalog '${name}': ${(<Error>error).message}`)
+        });
+    }
+    return _toolCatalog;
+}
+
+let _compilerProbeCache: CompilerProbeCache | undefined;
+
+/**
+ * The cache of the compiler probes in '~/.eide', it's shared by all projects and vscode windows
+*/
+export function getCompilerProbeCache(): CompilerProbeCache {
+    if (_compilerProbeCache == undefined) {
+        const cacheFile = File.fromArray([ResManager.GetInstance().getEideHomeFolder().path, 'compiler-probes.json']);
+        _compilerProbeCache = new CompilerProbeCache(cacheFile.path);
+    }
+    return _compilerProbeCache;
+}
+
+function execProbe(cmdLine: string, cwd: string): Promise<string> {
+    return new Promise((resolve, reject) => {
+        child_process.exec(cmdLine, { cwd: cwd, maxBuffer: 16 * 1024 * 1024 }, (err, stdout) => {
+            if (err) reject(err);
+            else resolve(stdout.toString());
+        });
+    });
+}
+
+function gccDefinesProbeCmd(gccpath: string, cmds: string[] | undefined): string {
+    // gcc ... -E -dM - <null
+    const cmdArgs = (cmds || []).concat(['-E', '-dM', '-', `<${platform.osGetNullDev()}`]);
+    return `${gccpath} ` + cmdArgs.join(' ');
+}
+
+function parseGccDefines(output: string): CppMacroDefine[] {
+
+    const results: CppMacroDefine[] = [];
+
+    output.split(/\r\n|\n/)
+        .filter((line) => { return line.trim() !== ''; })
+        .forEach((line) => {
+            const value = CppMacroParser.parse(line);
+            if (value) {
+                results.push(value);
+            }
+        });
+
+    return results;
+}
+
+/**
+ * Get the predefined macros of a gcc compatible compiler, the result is cached by `getCompilerProbeCache()`,
+ * the compiler is run synchronously only if it's not cached
+*/
 export function getGccInternalDefines(gccpath: string, cmds: string[] | undefined): CppMacroDefine[] | undefined {
     try {
-        // gcc ... -E -dM - <null
-        const cmdArgs = (cmds || []).concat(['-E', '-dM', '-', `<${platform.osGetNullDev()}`]);
-        const cmdLine = `${gccpath} ` + cmdArgs.join(' ');
-        const outputs = child_process.execSync(cmdLine, { cwd: NodePath.dirname(gccpath) }).toString().split(/\r\n|\n/);
-        const results: CppMacroDefine[] = [];
-
-        outputs.filter((line) => { return line.trim() !== ''; })
-            .forEach((line) => {
-                const value = CppMacroParser.parse(line);
-                if (value) {
-                    results.push(value);
-                }
-            });
-
-        return results;
+        const output = getCompilerProbeCache().getSync({ kind: 'defines', compiler: gccpath, args: cmds || [] }, () => {
+            return child_process.execSync(gccDefinesProbeCmd(gccpath, cmds), { cwd: NodePath.dirname(gccpath) }).toString();
+        });
+        return parseGccDefines(output);
     } catch (error) {
         GlobalEvent.log_warn(error);
     }
@@ -435,22 +539,49 @@ export function isGccOptionsCompatibleToolchain(name: ToolchainName): boolean {
     return name.includes('GCC') || name.includes('LLVM');
 }
 
+function gccSearchListProbeCmd(gccFullPath: string, args?: string[]): string {
+    const gccName = NodePath.basename(gccFullPath);
+    let cmdArgs: string[] = ['-E', '-v', '-', `<${platform.osGetNullDev()}`, '2>&1'];
+    if (args) cmdArgs = args.concat(cmdArgs);
+    return `${gccName} ` + cmdArgs.join(' ');
+}
+
+function parseGccSearchList(output: string): string[] {
+    const lines = output.split(/\r\n|\n/);
+    const iStart = lines.findIndex((line) => { return line.startsWith('#include <...>'); });
+    const iEnd = lines.indexOf('End of search list.', iStart);
+    return lines.slice(iStart + 1, iEnd)
+        .map((line) => { return new File(File.ToLocalPath(line.trim())); })
+        .filter((file) => { return file.IsDir(); })
+        .map((f) => {
+            return f.path;
+        });
+}
+
+/**
+ * Get the system include paths of a gcc compatible compiler, the compiler output is cached
+ * by `getCompilerProbeCache()`, the compiler is run synchronously only if it's not cached
+*/
 export function getGccSystemSearchList(gccFullPath: string, args?: string[]): string[] | undefined {
     try {
-        const gccName = NodePath.basename(gccFullPath);
-        const gccDir = NodePath.dirname(gccFullPath);
-        let cmdArgs: string[] = ['-E', '-v', '-', `<${platform.osGetNullDev()}`, '2>&1'];
-        if (args) cmdArgs = args.concat(cmdArgs);
-        const cmdLine = `${gccName} ` + cmdArgs.join(' ');
-        const lines = child_process.execSync(cmdLine, { cwd: gccDir }).toString().split(/\r\n|\n/);
-        const iStart = lines.findIndex((line) => { return line.startsWith('#include <...>'); });
-        const iEnd = lines.indexOf('End of search list.', iStart);
-        return lines.slice(iStart + 1, iEnd)
-            .map((line) => { return new File(File.ToLocalPath(line.trim())); })
-            .filter((file) => { return file.IsDir(); })
-            .map((f) => {
-                return f.path;
-            });
+        const output = getCompilerProbeCache().getSync({ kind: 'search-list', compiler: gccFullPath, args: args || [] }, () => {
+            return child_process.execSync(gccSearchListProbeCmd(gccFullPath, args), { cwd: NodePath.dirname(gccFullPath) }).toString();
+        });
+        return parseGccSearchList(output);
+    } catch (error) {
+        GlobalEvent.log_warn(error);
+    }
+}
+
+/**
+ * Same as `getGccSystemSearchList()`, but the compiler is run asynchronously
+*/
+export async function getGccSystemSearchListAsync(gccFullPath: string, args?: string[]): Promise<string[] | undefined> {
+    try {
+        const output = await getCompilerProbeCache().get({ kind: 'search-list', compiler: gccFullPath, args: args || [] }, () => {
+            return execProbe(gccSearchListProbeCmd(gccFullPath, args), NodePath.dirname(gccFullPath));
+        });
+        return parseGccSearchList(output);
     } catch (error) {
         GlobalEvent.log_warn(error);
     }
@@ -994,6 +1125,9 @@ export async function requestTxt(url: string): Promise<string | Error | undefine
     });
 }
 
+/**
+ * Download a file into memory, use `downloadFileToDisk` for big files
+*/
 export async function downloadFileWithProgress(url: string, fileLable: string,
     progress: vscode.Progress<{ message?: string; increment?: number }>, token: vscode.CancellationToken): Promise<Buffer | Error | undefined> {
 
@@ -1051,6 +1185,53 @@ export async function downloadFileWithProgress(url: string, fileLable: string,
     });
 }
 
+/**
+ * Download a file straight to the disk, the data is not kept in memory.
+ * A broken download is resumed next time, see `FileDownloader`.
+ *
+ * @returns undefined if it's canceled
+*/
+export async function downloadFileToDisk(url: string, destPath: string, fileLable: string,
+    progress: vscode.Progress<{ message?: string; increment?: number }>, token: vscode.CancellationToken,
+    opts?: DownloadOptions): Promise<DownloadResult | Error | undefined> {
+
+    let reported = 0; // percent
+
+    const downloader = new FileDownloader(url, destPath, {
+        headers: setProxyHeader({ 'User-Agent': 'Mozilla/5.0' }),
+        rejectUnauthorized: true,
+        segments: SettingManager.GetInstance().getDownloadSegments(),
+        ...opts,
+        onProgress: (received, total) => {
+            if (total) {
+                const percent = Math.min(received / total * 100, 100);
+                if (percent - reported >= 0.1 || percent == 100) {
+                    progress.report({
+                        increment: percent - reported,
+                        message: `${percent.toFixed(1)}% of '${fileLable}'`
+                    });
+                    reported = percent;
+                }
+            } else {
+                progress.report({ message: `${(received / 1024 / 1024).toFixed(1)} MB of '${fileLable}'` });
+            }
+        }
+    });
+
+    const cancelEvt = token.onCancellationRequested(() => downloader.cancel());
+
+    try {
+        return await downloader.download();
+    } catch (error) {
+        if (error instanceof DownloadCanceledError) {
+            return undefined;
+        }
+        return <Error>error;
+    } finally {
+        cancelEvt.dispose();
+    }
+}
+
 export async function readGithubRepoFolder(repo_url: string, token?: vscode.CancellationToken): Promise<GitFileInfo[] | Error> {
 
     // URL: https://api.github.com/repos/github0null/eide-doc/contents/eide-template-list
@@ -1105,87 +1286,31 @@ export async function readGithubRepoTxtFile(repo_path: string, file_path: string
 
 export function genGithubHash(f: File | Buffer): string {
     if (f instanceof File) {
-        const header = Buffer.from('blob ' + f.getSize() + '\0');
-        const buf = Buffer.concat([header, fs.readFileSync(f.path)], header.length + f.getSize());
+        // hash the file by chunks, big files are not loaded into memory
+        const size = f.getSize();
         const hash = crypto.createHash('sha1');
-        hash.update(buf);
+        hash.update(Buffer.from('blob ' + size + '\0'));
+        const fd = fs.openSync(f.path, 'r');
+        try {
+            const buf = Buffer.alloc(1024 * 1024);
+            for (let pos = 0; pos < size;) {
+                const n = fs.readSync(fd, buf, 0, Math.min(buf.length, size - pos), pos);
+                if (n <= 0) break;
+                hash.update(buf.subarray(0, n));
+                pos += n;
+            }
+        } finally {
+            fs.closeSync(fd);
+        }
         return hash.digest('hex');
     } else {
-        const header = Buffer.from('blob ' + f.length + '\0');
-        const buf = Buffer.concat([header, f], header.length + f.length);
         const hash = crypto.createHash('sha1');
-        hash.update(buf);
+        hash.update(Buffer.from('blob ' + f.length + '\0'));
+        hash.update(f);
         return hash.digest('hex');
     }
 }
 
-interface FileCacheInfo {
-
-    version: string;
-
-    files: { name: string; sha: string; }[];
-}
-
-export class FileCache {
-
-    private folder: File;
-    private cacheFile: File;
-    private cache: FileCacheInfo;
-
-    public constructor(rootFolder: File) {
-        this.folder = rootFolder;
-        this.cacheFile = File.fromArray([rootFolder.path, 'cache.json']);
-        this.cache = this.cacheFile.IsFile() ? JSON.parse(this.cacheFile.Read()) : { version: '1.0', files: [] };
-    }
-
-    public add(name: string, sha: string) {
-
-        const idx = this.cache.files.findIndex((inf) => inf.name == name);
-
-        if (idx != -1) {
-            this.cache.files[idx].sha = sha;
-        } else {
-            this.cache.files.push({
-                name: name,
-                sha: sha
-            });
-        }
-    }
-
-    public get(name: string, sha: string): File | undefined {
-
-        const idx = this.cache.files.findIndex((inf) => {
-            return inf.name == name && inf.sha == sha;
-        });
-
-        if (idx == -1) {
-            return undefined;
-        }
-
-        const f = File.fromArray([this.folder.path, this.cache.files[idx].name]);
-        if (!f.IsFile()) {
-            return undefined;
-        }
-
-        return f;
-    }
-
-    public clear(name?: string) {
-        if (name) {
-            const idx = this.cache.files.findIndex((inf) => inf.name == name);
-            if (idx != -1) {
-                this.cache.files.splice(idx, 1);
-            }
-        } else {
-            this.cache.files = [];
-        }
-    }
-
-    public save() {
-        this.cacheFile.Write(JSON.stringify(this.cache));
-    }
-}
-
 export function ToJsonStringExclude(obj: any, excludeList?: string[], indent?: string | number): string {
 
     const my_replacer = (key: string, val: any): any => {
@@ -0,0 +1,195 @@
+/**
+ * Smoke test for ArchiveEngine — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/archive-engine.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import * as zlib from 'zlib';
+import * as crypto from 'crypto';
+
+import { detectArchiveFormat, extractArchive, extractZipSync, zipDirectory, hashFile, hashFileSync } from '../../src/ArchiveEngine';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const isWin = process.platform == 'win32';
+
+/** make a tar file in memory, 'L' entries are GNU long names */
+function makeTar(entries: { name: string, type?: string, data?: Buffer, mode?: number, link?: string }[]): Buffer {
+
+    const blocks: Buffer[] = [];
+
+    const header = (name: string, type: string, size: number, mode: number, link: string) => {
+        const h = Buffer.alloc(512);
+        h.write(name.substr(0, 100), 0);
+        h.write(mode.toString(8).padStart(7, '0') + '\0', 100);
+        h.write(size.toString(8).padStart(11, '0') + '\0', 124);
+        h.write(Math.floor(Date.UTC(2024, 5, 1) / 1000).toString(8).padStart(11, '0') + '\0', 136);
+        h.write('        ', 148);
+        h.write(type, 156);
+        h.write(link, 157);
+        h.write('ustar\0' + '00', 257);
+        let sum = 0;
+        for (const b of h) sum += b;
+        h.write(sum.toString(8).padStart(6, '0') + '\0 ', 148);
+        return h;
+    };
+
+    const pad = (buf: Buffer) => Buffer.concat([buf, Buffer.alloc((512 - buf.length % 512) % 512)]);
+
+    for (const e of entries) {
+        const data = e.data || Buffer.alloc(0);
+        if (e.name.length > 100) {
+            const longName = Buffer.from(e.name + '\0');
+            blocks.push(header('././@LongLink', 'L', longName.length, 0o644, ''), pad(longName));
+        }
+        blocks.push(header(e.name, e.type || '0', data.length, e.mode || 0o644, e.link || ''), pad(data));
+    }
+
+    blocks.push(Buffer.alloc(1024));
+    return Buffer.concat(blocks);
+}
+
+function readTree(dir: string): string[] {
+    const result: string[] = [];
+    const walk = (d: string, rel: string) => {
+        for (const name of fs.readdirSync(d).sort()) {
+            const abs = path.join(d, name);
+            const r = rel ? `${rel}/${name}` : name;
+            const st = fs.lstatSync(abs);
+            if (st.isSymbolicLink()) result.push(`${r} -> ${fs.readlinkSync(abs)}`);
+            else if (st.isDirectory()) { result.push(r + '/'); walk(abs, r); }
+            else result.push(`${r}:${crypto.createHash('md5').update(fs.readFileSync(abs)).digest('hex')}`);
+        }
+    };
+    walk(dir, '');
+    return result;
+}
+
+async function main() {
+
+    const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-archive-'));
+    const src = path.join(tmpDir, 'src');
+
+    // --- source tree ---
+
+    fs.mkdirSync(path.join(src, 'bin'), { recursive: true });
+    fs.mkdirSync(path.join(src, 'lib', 'gcc'), { recursive: true });
+    fs.mkdirSync(path.join(src, 'build'), { recursive: true });
+    fs.writeFileSync(path.join(src, 'bin', 'arm-none-eabi-gcc'), crypto.randomBytes(3 * 1024 * 1024));
+    fs.writeFileSync(path.join(src, 'lib', 'gcc', 'libgcc.a'), Buffer.from('0123456789'.repeat(50000)));
+    fs.writeFileSync(path.join(src, 'readme.txt'), 'hello');
+    fs.writeFileSync(path.join(src, 'empty.txt'), '');
+    fs.writeFileSync(path.join(src, 'main.o'), 'obj');
+    fs.writeFileSync(path.join(src, 'build', 'app.elf'), 'elf');
+    if (!isWin) fs.chmodSync(path.join(src, 'bin', 'arm-none-eabi-gcc'), 0o755);
+
+    // --- zip ---
+
+    const zipPath = path.join(tmpDir, 'toolchain.zip');
+    let zipProgress = 0;
+    await zipDirectory(src, zipPath, {
+        exclude: (rel) => rel == 'build' || rel.endsWith('.o'),
+        onProgress: (done) => zipProgress = done
+    });
+    assert(detectArchiveFormat(zipPath) == 'zip', 'zip format is detected');
+    assert(zipProgress == 3 * 1024 * 1024 + 500000 + 5, 'zip progress in bytes');
+
+    const zipOut = path.join(tmpDir, 'zip-out');
+    let done = 0;
+    let total = 0;
+    await extractArchive(zipPath, zipOut, { concurrency: 4, onProgress: (d, t) => { done = d; total = t; } });
+
+    const expected = readTree(src).filter(p => !p.startsWith('build') && !p.startsWith('main.o'));
+    assert(readTree(zipOut).join('\n') == expected.join('\n'), 'zip round trip, excluded files are not packed');
+    assert(done == total && total == 3 * 1024 * 1024 + 500000 + 5, 'extract progress in bytes');
+    if (!isWin) {
+        assert((fs.statSync(path.join(zipOut, 'bin', 'arm-none-eabi-gcc')).mode & 0o777) == 0o755, 'executable bit is kept');
+    }
+
+    const filtered = path.join(tmpDir, 'zip-filtered');
+    await extractArchive(zipPath, filtered, { filter: (name) => name.startsWith('lib/') });
+    assert(readTree(filtered).join(',').startsWith('lib/,lib/gcc/,lib/gcc/libgcc.a') && !fs.existsSync(path.join(filtered, 'bin')), 'extraction filter');
+
+    const syncOut = path.join(tmpDir, 'zip-sync');
+    const names = extractZipSync(zipPath, syncOut);
+    assert(names.includes('bin/arm-none-eabi-gcc') && readTree(syncOut).join('\n') == expected.join('\n'), 'sync extraction');
+
+    // --- tar / tar.gz ---
+
+    const longName = 'include/' + 'very_long_folder_name/'.repeat(6) + 'header.h';
+    const tarData = makeTar([
+        { name: 'pkg/', type: '5', mode: 0o755 },
+        { name: 'pkg/bin/tool', data: Buffer.from('#!/bin/sh\necho hi\n'), mode: 0o755 },
+        { name: 'pkg/' + longName, data: Buffer.from('#pragma once\n') },
+        { name: 'pkg/data.bin', data: crypto.randomBytes(700 * 1024) },
+        { name: 'pkg/bin/tool-link', type: '2', link: 'tool' },
+    ]);
+
+    const tarPath = path.join(tmpDir, 'pkg.tar');
+    fs.writeFileSync(tarPath, tarData);
+    const tgzPath = path.join(tmpDir, 'pkg.tar.gz');
+    fs.writeFileSync(tgzPath, zlib.gzipSync(tarData));
+    assert(detectArchiveFormat(tarPath) == 'tar' && detectArchiveFormat(tgzPath) == 'tar.gz', 'tar formats are detected');
+
+    for (const p of [tarPath, tgzPath]) {
+        const out = path.join(tmpDir, path.basename(p) + '-out');
+        await extractArchive(p, out);
+        assert(fs.readFileSync(path.join(out, 'pkg', longName), 'utf8') == '#pragma once\n', `${path.basename(p)}: GNU long name`);
+        assert(fs.statSync(path.join(out, 'pkg', 'data.bin')).size == 700 * 1024, `${path.basename(p)}: file data`);
+        if (!isWin) {
+            assert(fs.readlinkSync(path.join(out, 'pkg', 'bin', 'tool-link')) == 'tool', `${path.basename(p)}: symlink`);
+            assert((fs.statSync(path.join(out, 'pkg', 'bin', 'tool')).mode & 0o777) == 0o755, `${path.basename(p)}: file mode`);
+        }
+    }
+
+    // --- bad archives ---
+
+    const evilPath = path.join(tmpDir, 'evil.tar');
+    fs.writeFileSync(evilPath, makeTar([{ name: '../evil.txt', data: Buffer.from('x') }]));
+    let error: any;
+    try {
+        await extractArchive(evilPath, path.join(tmpDir, 'evil-out'));
+    } catch (err) {
+        error = err;
+    }
+    assert(error && /Illegal file path/.test(error.message) && !fs.existsSync(path.join(tmpDir, 'evil.txt')), 'path traversal is rejected');
+
+    const evilLink = path.join(tmpDir, 'evil-link.tar');
+    fs.writeFileSync(evilLink, makeTar([{ name: 'a/link', type: '2', link: '../../etc' }]));
+    error = undefined;
+    try {
+        await extractArchive(evilLink, path.join(tmpDir, 'evil-link-out'));
+    } catch (err) {
+        error = err;
+    }
+    assert(error && /Illegal/.test(error.message), 'link out of the folder is rejected');
+
+    const sevenZip = path.join(tmpDir, 'a.7z');
+    fs.writeFileSync(sevenZip, Buffer.from([0x37, 0x7a, 0xbc, 0xaf, 0x27, 0x1c, 0, 4]));
+    assert(detectArchiveFormat(sevenZip) == 'none', '7z is left to the fallback');
+
+    // --- hash ---
+
+    const gcc = path.join(src, 'bin', 'arm-none-eabi-gcc');
+    const sha = crypto.createHash('sha256').update(fs.readFileSync(gcc)).digest('hex');
+    assert(hashFileSync(gcc, 'sha256') == sha && (await hashFile(gcc, 'sha256')) == sha, 'file hash');
+
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+    console.log('all archive engine tests passed');
+}
+
+main().catch((err) => {
+    console.error(err);
+    process.exit(1);
+});
@@ -0,0 +1,148 @@
+/**
+ * Smoke test for ArtifactStore — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/artifact-store.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import * as crypto from 'crypto';
+import * as child_process from 'child_process';
+
+import { ArtifactStore } from '../../src/ArtifactStore';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const sha256 = (buf: Buffer) => crypto.createHash('sha256').update(buf).digest('hex');
+
+function setAccessTime(store: ArtifactStore, hash: string, time: number) {
+    fs.utimesSync(store.get(hash)!.path, time / 1000, time / 1000);
+}
+
+const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-store-'));
+const root = path.join(tmpDir, 'cache');
+
+// --- put / get ---
+
+const pack = crypto.randomBytes(300 * 1024);
+const packPath = path.join(tmpDir, 'Keil.STM32F4xx_DFP.2.17.0.pack');
+fs.writeFileSync(packPath, pack);
+
+const store = new ArtifactStore(root);
+const a = store.putFile(packPath, { alias: 'pack/Keil.STM32F4xx_DFP.2.17.0.pack', meta: { sha: 'abc' } });
+assert(a.hash == sha256(pack) && a.size == pack.length && fs.readFileSync(a.path).equals(pack), 'file is stored by the content hash');
+assert(fs.existsSync(packPath) && a.path.endsWith(path.join(a.hash, 'Keil.STM32F4xx_DFP.2.17.0.pack')), 'source file is copied, the file name is kept');
+assert(store.get(a.hash.toUpperCase())!.path == a.path, 'get by hash');
+assert(store.putFile(a.path, { holder: 'prj-c' }).path == a.path && store.get(a.hash)!.refs == 1, 'blob of the store is not copied again');
+store.release(a.hash, 'prj-c');
+
+const alias = store.resolve('pack/Keil.STM32F4xx_DFP.2.17.0.pack')!;
+assert(alias.hash == a.hash && alias.meta.sha == 'abc', 'get by alias');
+assert(store.resolve('not/exist') == undefined, 'unknown alias');
+
+const b = store.putFile(packPath, { alias: 'pack/copy.zip', move: true });
+assert(b.hash == a.hash && b.path == a.path && !fs.existsSync(packPath), 'same content is stored once, moved source is removed');
+assert(fs.readdirSync(path.join(root, 'tmp')).length == 0, 'no temp files are left');
+
+const txt = store.putData('{"list":[]}', { alias: 'template-list.json', meta: { lastUpdateTime: 1 } });
+assert(fs.readFileSync(txt.path, 'utf8') == '{"list":[]}' && store.getUsage().count == 2, 'data is stored');
+
+const txt2 = store.putData('{"list":[1]}', { alias: 'template-list.json', meta: { lastUpdateTime: 1 } });
+assert(!fs.existsSync(txt2.path.replace(txt2.hash, txt.hash)) && store.getUsage().count == 2, 'old content of a replaced alias is deleted');
+
+// --- another window sees the changes ---
+
+const other = new ArtifactStore(root);
+assert(other.resolve('template-list.json')!.meta.lastUpdateTime == 1, 'index is shared');
+other.removeAlias('template-list.json');
+assert(store.resolve('template-list.json') == undefined && store.get(txt2.hash) == undefined, 'changes of another window are reloaded');
+
+// --- reference counting and LRU eviction ---
+
+const blobs: string[] = [];
+for (let i = 0; i < 4; i++) {
+    const info = store.putData(crypto.randomBytes(100 * 1024), { alias: `tool-${i}` });
+    setAccessTime(store, info.hash, Date.now() - (10 - i) * 60000);
+    blobs.push(info.hash);
+}
+setAccessTime(store, a.hash, Date.now() - 20 * 60000);
+const old = store.putData('old data', { alias: 'old.txt' });
+setAccessTime(store, old.hash, Date.now() - 30 * 60000);
+
+store.acquire(a.hash, 'prj-a');
+store.acquire(a.hash, 'prj-b');
+store.acquire(a.hash, 'prj-b');
+assert(store.get(a.hash)!.refs == 2, 'holders are counted once');
+
+store.get(blobs[0]); // recently used
+const removed = store.evict(pack.length + 250 * 1024);
+assert(removed.sort().join(',') == [old.hash, blobs[1], blobs[2]].sort().join(','), 'least recently used artifacts are evicted, held ones are kept');
+assert(store.resolve('tool-1') == undefined && store.resolve('tool-0') != undefined, 'aliases of the evicted artifacts are removed');
+
+store.release(a.hash, 'prj-a');
+store.releaseAll('prj-b');
+assert(store.get(a.hash)!.refs == 0, 'artifact is released');
+
+const prjDir = path.join(tmpDir, 'prj');
+fs.mkdirSync(prjDir);
+store.acquire(blobs[3], prjDir);
+fs.rmdirSync(prjDir);
+assert(store.evict(1).includes(blobs[3]), 'holder folder is deleted, the artifact is not held');
+
+const bounded = new ArtifactStore(root, { maxSize: 150 * 1024 });
+const last = bounded.putData(crypto.randomBytes(120 * 1024));
+assert(bounded.get(last.hash) != undefined && bounded.getUsage().size == 120 * 1024, 'old artifacts are evicted over the budget, the new one is kept');
+
+// --- missing blobs ---
+
+fs.unlinkSync(last.path);
+assert(bounded.get(last.hash) == undefined, 'deleted blob is not returned');
+bounded.evict();
+assert(bounded.getUsage().count == 0, 'records of the deleted blobs are pruned');
+
+// --- lock ---
+
+fs.writeFileSync(path.join(root, 'store.lock'), '1');
+let error: any;
+try {
+    new ArtifactStore(root, { lockTimeout: 100 }).putData('x');
+} catch (err) {
+    error = err;
+}
+assert(error && /Timeout to lock/.test(error.message), 'lock of another process is respected');
+
+fs.utimesSync(path.join(root, 'store.lock'), new Date(Date.now() - 10000), new Date(Date.now() - 10000));
+assert(new ArtifactStore(root).putData('x').size == 1, 'stale lock is broken before the lock timeout');
+
+// --- concurrent writers ---
+
+const script = `
+const { ArtifactStore } = require(${JSON.stringify(path.resolve(__dirname, '../../src/ArtifactStore'))});
+const store = new ArtifactStore(${JSON.stringify(root)});
+for (let i = 0; i < 20; i++) store.putData(process.argv[1] + '-' + i, { alias: process.argv[1] + '-' + i });
+`;
+const procs = [0, 1, 2, 3].map((n) => new Promise<number>((resolve) => {
+    child_process.spawn(process.execPath, [...process.execArgv, '-e', script, `w${n}`], { stdio: 'inherit' })
+        .on('exit', (code) => resolve(code || 0));
+}));
+
+Promise.all(procs).then((codes) => {
+    assert(codes.every((c) => c == 0), 'writers are done');
+    const check = new ArtifactStore(root);
+    let found = 0;
+    for (let n = 0; n < 4; n++)
+        for (let i = 0; i < 20; i++)
+            if (check.resolve(`w${n}-${i}`)) found++;
+    assert(found == 80, 'no change is lost with concurrent writers');
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+    console.log('all artifact store tests passed');
+});
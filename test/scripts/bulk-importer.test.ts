@@ -0,0 +1,118 @@
+/**
+ * Smoke test for BulkImporter — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/bulk-importer.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import { scanImportableProjects, runBulkImport, formatBulkImportReport, BulkImportItem } from '../../src/BulkImporter';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const sleep = (ms: number) => new Promise<void>(resolve => setTimeout(resolve, ms));
+
+async function main() {
+
+    const root = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-bulk-'));
+    const touch = (...p: string[]) => {
+        fs.mkdirSync(path.join(root, ...p.slice(0, -1)), { recursive: true });
+        fs.writeFileSync(path.join(root, ...p), '');
+    };
+
+    touch('keil', 'app', 'app.uvprojx');
+    touch('keil', 'app', 'app.uvproj');            // old file of a migrated project
+    touch('keil', 'c51', 'blinky.uvproj');
+    touch('keil', 'two', 'a.uvprojx');
+    touch('keil', 'two', 'b.uvprojx');
+    touch('iar', 'ws.eww');
+    touch('iar', 'prj', 'prj.ewp');
+    touch('eclipse', 'gcc', '.cproject');
+    touch('eclipse', 'gcc', '.project');
+    touch('eclipse', 'broken', '.cproject');
+    touch('done', 'old.uvprojx');
+    touch('done', '.eide', 'eide.yml');
+    touch('.git', 'x.uvprojx');
+    touch('node_modules', 'pkg', 'y.uvprojx');
+
+    // --- scan ---
+
+    const scan = scanImportableProjects(root);
+    const rel = (p: string) => path.relative(root, p).split(path.sep).join('/');
+    const found = scan.items.map(i => `${i.type}:${rel(i.projectFile)}`);
+    assert(found.join(',') == [
+        'eclipse:eclipse/gcc/.cproject',
+        'iar:iar/ws.eww',
+        'mdk:keil/app/app.uvprojx',
+        'mdk:keil/c51/blinky.uvproj',
+        'mdk:keil/two/a.uvprojx'
+    ].join(','), 'projects are found, hidden folders are skipped');
+
+    const skipped = scan.skipped.map(s => `${rel(s.path)}: ${s.reason}`);
+    assert(skipped.some(s => s.startsWith('done/old.uvprojx: already imported')), 'imported project is skipped');
+    assert(skipped.some(s => s.startsWith('keil/two/b.uvprojx') && s.includes('a.uvprojx')), 'only one project in a folder');
+    assert(skipped.some(s => s.startsWith('eclipse/broken/.cproject')), 'eclipse project without \'.project\'');
+
+    const forced = scanImportableProjects(root, true);
+    assert(forced.items.some(i => rel(i.projectFile) == 'done/old.uvprojx'), 'force imports the imported projects again');
+
+    // --- run ---
+
+    let running = 0;
+    let maxRunning = 0;
+    const progress: string[] = [];
+
+    const report = await runBulkImport(root, scan.items, async (item: BulkImportItem, r) => {
+        running++;
+        maxRunning = Math.max(maxRunning, running);
+        await sleep(20);
+        running--;
+        if (item.type == 'iar')
+            throw new Error('Not found any project in this IAR workbench !');
+        if (item.projectFile.endsWith('blinky.uvproj')) {
+            r.warnings.push(`[Keil RTE Import] No such file 'RTE/startup.a51'`);
+            r.warnings.push('unresolved dependences:\nFileName: \'core.h\'');
+        }
+        r.workspaceFile = path.join(path.dirname(item.projectFile), 'x.code-workspace');
+        if (item.type == 'eclipse')
+            return { success: false, message: 'compiling...\narm-none-eabi-gcc: not found' };
+        if (item.projectFile.endsWith('a.uvprojx'))
+            return { success: true, message: '' };
+    }, scan.skipped, {
+        concurrency: 2,
+        onProjectDone: (res, done, total) => progress.push(`${done}/${total}`)
+    });
+
+    assert(maxRunning == 2 && report.concurrency == 2, 'projects are imported in parallel, limited by concurrency');
+    assert(progress.join(',') == '1/5,2/5,3/5,4/5,5/5', 'progress is reported');
+    assert(report.imported == 3 && report.failed == 2, 'failed import and failed verification are counted');
+    assert(report.results[1].error == 'Not found any project in this IAR workbench !' && report.results[0].verify?.success === false, 'results are kept in order');
+    assert(report.results[3].warnings.length == 2 && report.results[3].workspaceFile != undefined, 'warnings and workspace file');
+
+    // --- report ---
+
+    const text = formatBulkImportReport(report);
+    console.log(text);
+    assert(/Result: 3 imported, 2 failed, 3 skipped, 2 warnings/.test(text), 'summary line');
+    assert(/VERIFY\s+eclipse/.test(text) && /FAIL\s+iar/.test(text) && text.includes('    arm-none-eabi-gcc: not found'), 'failed projects are in the table and details');
+    assert(text.includes(`warning: [Keil RTE Import] No such file 'RTE/startup.a51'`) && text.includes(`${os.EOL}    FileName: 'core.h'`), 'warnings are in one report');
+    assert(!text.includes('=== keil/app/app.uvprojx ===') && text.includes('=== skipped ==='), 'clean projects have no details');
+
+    fs.rmSync(root, { recursive: true, force: true });
+    console.log('all bulk importer tests passed');
+}
+
+main().catch((err) => {
+    console.error(err);
+    process.exit(1);
+});
@@ -0,0 +1,266 @@
+/**
+ * Smoke test for CmsisConfigParser — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/cmsis-config-parser.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import { parse, CmsisConfigDocument, CmsisConfigItem, CmsisConfigUpdate } from '../../src/CmsisConfigParser';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+/** a small 'Math.random' with seed */
+function random(seed: number): () => number {
+    return () => {
+        seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+        return seed / 0x7fffffff;
+    };
+}
+
+/** make a config header which has 'n' blocks */
+function makeHeader(n: number, endTag: boolean = true): string[] {
+
+    const lines: string[] = [
+        '#ifndef __APP_CONFIG_H__',
+        '#define __APP_CONFIG_H__',
+        '',
+        '//-------- <<< Use Configuration Wizard in Context Menu >>> --------------------',
+        ''
+    ];
+
+    for (let i = 0; i < n; i++) {
+        lines.push(
+            `// <h> Module ${i}`,
+            `// <i> Settings of the module ${i}`,
+            `//   <o> Clock Source <0=> HSI <1=> HSE <2=> PLL`,
+            `#define MOD${i}_CLK_SRC ${i % 3}`,
+            '',
+            `//   <o MOD${i}_MODE> Mode`,
+            `//   <i> Mode of the module ${i}`,
+            '//     <fast=> Fast',
+            '//     <slow=> Slow',
+            `//   <i> Default: fast`,
+            `//   <q> Enable Interrupt`,
+            `#define MOD${i}_IRQ_EN 1`,
+            `//   <o> Buffer Size <16-4096:16> <#/16>`,
+            `#define MOD${i}_BUF_SIZE ${(i % 8 + 1) * 256}`,
+            `//   <e.${i % 4}> Debug Options`,
+            `//     <q> Trace`,
+            `//     <d> 0`,
+            `#define MOD${i}_TRACE 0`,
+            `//     <s.16> Name`,
+            `#define MOD${i}_NAME "mod${i}"`,
+            `//   </e>`,
+            `#define MOD${i}_DEBUG 0x${(i % 16).toString(16)}`,
+            `#define MOD${i}_MODE fast`,
+            `//   <c1> Use the default handler`,
+            `//   <i> comment out the line to disable it`,
+            `// void MOD${i}_Handler(void);`,
+            `//   </c>`,
+            `// </h>`,
+            `// <n> Notice ${i}`,
+            `// <o> Top Level Option ${i}`,
+            `#define TOP${i}_OPT ${i}`,
+            ''
+        );
+    }
+
+    lines.push(
+        '// <o> Missing Define',
+        ''
+    );
+
+    if (endTag)
+        lines.push('//------------- <<< end of configuration section >>> ---------------------------');
+
+    lines.push('', '#endif', '');
+
+    return lines;
+}
+
+/** apply a update like the webview */
+function applyUpdate(view: { items: CmsisConfigItem[], lines: string[] }, u: CmsisConfigUpdate) {
+
+    view.lines.splice(u.lines.start, u.lines.deleteCount, ...u.lines.lines);
+
+    if (u.shift) {
+        const shift = u.shift;
+        const mv = (n: number) => n >= shift.line ? n + shift.delta : n;
+        const walk = (items: CmsisConfigItem[]) => items.forEach((item) => {
+            item.line_idx = mv(item.line_idx);
+            if (item.location) {
+                item.location.start = mv(item.location.start);
+                if (item.location.end != undefined) item.location.end = mv(item.location.end);
+            }
+            walk(item.children);
+        });
+        walk(view.items);
+    }
+
+    for (const s of u.splices) {
+        let list = view.items;
+        for (const i of s.path) list = list[i].children;
+        list.splice(s.start, s.deleteCount, ...JSON.parse(JSON.stringify(s.items)));
+    }
+}
+
+const toJson = (obj: any) => JSON.stringify(obj);
+
+function countItems(items: CmsisConfigItem[]): number {
+    return items.reduce((n, item) => n + 1 + countItems(item.children), 0);
+}
+
+function main() {
+
+    // --- full parse ---
+
+    const lines = makeHeader(40);
+    const cfg = parse(lines);
+    assert(cfg != undefined && cfg.items.length == 40 * 3 + 1, 'top level items');
+
+    const mod0 = cfg!.items[0];
+    const clk = mod0.children[0];
+    const mode = mod0.children[1];
+    const size = mod0.children[3];
+    const dbg = mod0.children[4];
+    assert(mod0.type == 'group' && mod0.name == 'Module 0' && clk.detail.length == 0, 'group');
+    assert(clk.type == 'option' && clk.var_enum!.length == 3 && clk.location!.start == lines.indexOf('#define MOD0_CLK_SRC 0'), 'option is matched to the next define');
+    assert(mode.var_disp_value == 'fast' && mode.detail.length == 2 && mode.location!.start == lines.indexOf('#define MOD0_MODE fast'), 'option is matched by name');
+    assert(size.var_disp_value == '4096' && size.var_range!.step == 16, 'display value with operator');
+    assert(dbg.type == 'section' && dbg.children.length == 2 && dbg.children[0].detail.length == 0, 'section children');
+    assert(mod0.children[5].type == 'code' && mod0.children[5].var_value == '!', 'code block');
+    assert(cfg!.items[cfg!.items.length - 1].css_class == 'err_blink', 'missing define is an error item');
+    assert(parse(lines.filter((l) => !/<<</.test(l))) == undefined, 'no wizard section');
+
+    // --- random edits ---
+
+    const rand = random(2024);
+    const pick = <T>(arr: T[]) => arr[Math.floor(rand() * arr.length)];
+
+    const edits: ((cur: string[]) => [number, number, string[]])[] = [
+        // change a value
+        (cur) => {
+            const idx = pick(cur.map((l, i) => /#define \w+ \d/.test(l) ? i : -1).filter((i) => i >= 0));
+            return [idx, 1, [cur[idx].replace(/ \d+$/, ` ${Math.floor(rand() * 10)}`)]];
+        },
+        // insert or delete a tooltip
+        (cur) => {
+            const idx = Math.floor(rand() * cur.length);
+            return rand() < 0.5 ? [idx, 0, ['//   <i> a new tooltip']] : [idx, 1, []];
+        },
+        // insert a block
+        (cur) => [Math.floor(rand() * cur.length), 0, ['// <h> New Group', '//   <q> New Bool', '#define NEW_BOOL 1', '// </h>']],
+        // delete some lines
+        (cur) => [Math.floor(rand() * cur.length), 1 + Math.floor(rand() * 6), []],
+        // break or fix a group
+        (cur) => {
+            const idx = Math.floor(rand() * cur.length);
+            return rand() < 0.5 ? [idx, 0, ['// </h>']] : [idx, 0, ['// <h> Unclosed Group']];
+        },
+        // a define is renamed
+        (cur) => {
+            const idx = pick(cur.map((l, i) => /_MODE fast/.test(l) ? i : -1).filter((i) => i >= 0));
+            return [idx, 1, [idx % 2 ? '#define NO_MODE fast' : '#define MOD0_MODE slow']];
+        },
+    ];
+
+    const doc = new CmsisConfigDocument(lines);
+    const view = { items: JSON.parse(toJson(doc.getConfiguration()!.items)), lines: lines.slice() };
+    let cur = lines.slice();
+    let sameDoc = true, sameView = true, resets = 0, splices = 0;
+
+    for (let i = 0; i < 600; i++) {
+        const [start, del, ins] = pick(edits)(cur);
+        cur.splice(start, del, ...ins);
+        const u = doc.applyChange(start, del, ins);
+        const expected = toJson(parse(cur));
+        if (toJson(doc.getConfiguration()) != expected) {
+            sameDoc = false;
+            console.error(`edit ${i}: [${start}, ${del}, ${JSON.stringify(ins)}]`);
+            break;
+        }
+        if (u.reset) {
+            resets++;
+            view.items = JSON.parse(toJson(doc.getConfiguration()?.items || []));
+            view.lines = cur.slice();
+        } else {
+            applyUpdate(view, u);
+            splices += u.splices.length;
+        }
+        if (toJson(view.items) != toJson(parse(cur)?.items || []) || toJson(view.lines) != toJson(cur)) {
+            sameView = false;
+            console.error(`view, edit ${i}: [${start}, ${del}, ${JSON.stringify(ins)}]`);
+            break;
+        }
+    }
+    assert(sameDoc, 'incremental result is same as a full parse');
+    assert(sameView, 'the updates rebuild the same tree in the view');
+
+    // --- minimal updates ---
+
+    const doc2 = new CmsisConfigDocument(lines);
+    let idx = lines.indexOf('#define MOD20_IRQ_EN 1');
+    let u = doc2.applyChange(idx, 1, ['#define MOD20_IRQ_EN 0']);
+    assert(u.shift == undefined && u.splices.length == 1 && countItems(u.splices[0].items) == 1 &&
+        u.splices[0].items[0].var_value == '0' && toJson(u.splices[0].path) == '[60]', 'a value change updates one item');
+
+    idx = lines.indexOf('// <n> Notice 30');
+    u = doc2.applyChange(idx + 1, 0, ['// <q> Inserted', '#define INSERTED 1']);
+    assert(u.shift!.line == idx + 1 && u.shift!.delta == 2 && u.splices[0].deleteCount == 1 && u.splices[0].items.length == 2 &&
+        u.splices[0].items[1].name == 'Inserted', 'an inserted item is a splice, the rest are shifted');
+    assert(u.splices.length == 2 && u.splices[1].items[0].css_class == 'err_blink', 'line numbers in the error messages are updated');
+
+    idx = lines.indexOf('#define MOD5_MODE fast');
+    u = doc2.applyChange(idx, 1, ['#define MOD5_MODE slow']);
+    assert(u.splices.some((s) => s.deleteCount == 1 && s.items[0].name == 'Mode' && s.items[0].var_disp_value == 'slow'), 'named option is updated by its define');
+
+    u = doc2.applyChange(0, 0, ['// header comment']);
+    assert(!u.reset && u.shift!.delta == 1 && u.splices.length == 1, 'a change before the wizard section');
+    assert(toJson(doc2.getConfiguration()) == toJson(parse(doc2.getLines())), 'state after the updates');
+
+    u = doc2.applyChange(4, 1, ['// no wizard']);
+    assert(u.reset == true && doc2.getConfiguration() == undefined, 'the start tag is removed');
+    u = doc2.applyChange(4, 1, [lines[3]]);
+    assert(u.reset == true && toJson(doc2.getConfiguration()) == toJson(parse(doc2.getLines())), 'the start tag is restored');
+
+    const noEnd = makeHeader(5, false);
+    const doc3 = new CmsisConfigDocument(noEnd);
+    doc3.applyChange(noEnd.length, 0, ['#define TOP0_OPT 7', '']);
+    assert(toJson(doc3.getConfiguration()) == toJson(parse(doc3.getLines())), 'append lines without the end tag');
+
+    assert(doc3.setLines(doc3.getLines().slice()) == undefined, 'setLines: no changes');
+    const changed = doc3.getLines().map((l) => l.replace('MOD3_IRQ_EN 1', 'MOD3_IRQ_EN 0'));
+    u = doc3.setLines(changed)!;
+    assert(u.lines.deleteCount == 1 && u.splices.length == 1 && toJson(doc3.getConfiguration()) == toJson(parse(changed)), 'setLines: the changed range');
+
+    // --- large header ---
+
+    const big = makeHeader(1500);
+    let t = process.hrtime.bigint();
+    const bigDoc = new CmsisConfigDocument(big);
+    const fullTime = Number(process.hrtime.bigint() - t) / 1e6;
+
+    const N = 200;
+    const pos = Array.from({ length: N }, (_, i) => big.indexOf(`#define MOD${700 + i}_BUF_SIZE ${((700 + i) % 8 + 1) * 256}`));
+    t = process.hrtime.bigint();
+    for (let i = 0; i < N; i++) {
+        const l = pos[i] + i; // a line is inserted by each loop
+        bigDoc.applyChange(l, 1, [`#define MOD${700 + i}_BUF_SIZE 1024`]);
+        bigDoc.applyChange(l + 1, 0, ['//   <i> new tooltip']);
+    }
+    const editTime = Number(process.hrtime.bigint() - t) / 1e6 / (N * 2);
+    console.log(`${big.length} lines, full parse: ${fullTime.toFixed(1)} ms, one edit: ${editTime.toFixed(3)} ms`);
+    assert(editTime * 10 < fullTime, 'an edit is much faster than a full parse');
+    assert(toJson(bigDoc.getConfiguration()) == toJson(parse(bigDoc.getLines())), 'large header is same as a full parse');
+
+    console.log('all cmsis config parser tests passed');
+}
+
+main();
@@ -0,0 +1,103 @@
+/**
+ * Smoke test for CompilerProbeCache — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/compiler-probe-cache.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import { CompilerProbeCache } from '../../src/CompilerProbeCache';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+async function main() {
+
+    const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-probe-'));
+    const gcc = path.join(tmpDir, 'bin', 'arm-none-eabi-gcc');
+    fs.mkdirSync(path.dirname(gcc));
+    fs.writeFileSync(gcc, 'gcc v1');
+    const cacheFile = path.join(tmpDir, 'compiler-probes.json');
+
+    let runs = 0;
+    const run = () => { runs++; return `#define __GNUC__ 10\n#define RUN ${runs}`; };
+    const probe = { kind: 'defines', compiler: gcc, args: ['-mcpu=cortex-m4', '-mthumb'] };
+
+    // --- sync ---
+
+    const cache = new CompilerProbeCache(cacheFile);
+    const out = cache.getSync(probe, run);
+    assert(cache.getSync(probe, run) == out && runs == 1, 'compiler is run once');
+    assert(cache.getSync({ ...probe, args: [' -mcpu=cortex-m4 ', '', '-mthumb'] }, run) == out && runs == 1, 'arguments are normalized');
+    assert(cache.getSync({ ...probe, kind: 'search-list' }, run) != out && runs == 2, 'probe kind is a part of the key');
+    assert(cache.getSync({ ...probe, args: ['-mcpu=cortex-m0'] }, run) != out && runs == 3, 'different arguments are probed');
+
+    // --- another window ---
+
+    const other = new CompilerProbeCache(cacheFile);
+    assert(other.getSync(probe, run) == out && runs == 3, 'cache is persisted and shared');
+    assert(other.getCached({ ...probe, args: ['-mcpu=cortex-m0'] }) != undefined, 'cached output');
+
+    // both windows add records, no one is lost
+    other.getSync({ ...probe, args: ['-O2'] }, run);
+    cache.getSync({ ...probe, args: ['-O3'] }, run);
+    const third = new CompilerProbeCache(cacheFile);
+    assert(third.getCached({ ...probe, args: ['-O2'] }) != undefined && third.getCached({ ...probe, args: ['-O3'] }) != undefined, 'records of windows are merged');
+
+    // --- compiler is changed ---
+
+    fs.writeFileSync(gcc, 'gcc v2, a new version');
+    const runsBefore = runs;
+    assert(cache.getSync(probe, run) != out && runs == runsBefore + 1, 'changed compiler is probed again');
+
+    const missing = { kind: 'defines', compiler: path.join(tmpDir, 'not-exist-gcc'), args: [] };
+    cache.getSync(missing, run);
+    cache.getSync(missing, run);
+    assert(runs == runsBefore + 3, 'compiler which is not found is not cached');
+
+    // --- async ---
+
+    let asyncRuns = 0;
+    const asyncProbe = { kind: 'search-list', compiler: gcc, args: ['-xc++'] };
+    const asyncRun = () => new Promise<string>((resolve) => { asyncRuns++; setTimeout(() => resolve('/usr/include'), 50); });
+    const results = await Promise.all([1, 2, 3, 4].map(() => cache.get(asyncProbe, asyncRun)));
+    assert(results.every((r) => r == '/usr/include') && asyncRuns == 1, 'probes in running are shared');
+    assert((await cache.get(asyncProbe, asyncRun)) == '/usr/include' && asyncRuns == 1, 'async result is cached');
+
+    let error: any;
+    const failProbe = { ...asyncProbe, args: ['-bad'] };
+    try {
+        await cache.get(failProbe, () => Promise.reject(new Error('bad option')));
+    } catch (err) {
+        error = err;
+    }
+    assert(error && error.message == 'bad option' && cache.getCached(failProbe) == undefined, 'failed probe is not cached');
+    assert((await cache.get(failProbe, () => Promise.resolve('ok'))) == 'ok', 'failed probe is run again');
+
+    // --- size limit ---
+
+    const small = new CompilerProbeCache(path.join(tmpDir, 'small.json'), 3);
+    for (let i = 0; i < 5; i++) {
+        small.getSync({ ...probe, args: [`-O${i}`] }, run);
+        await new Promise((resolve) => setTimeout(resolve, 2));
+    }
+    const reloaded = new CompilerProbeCache(path.join(tmpDir, 'small.json'), 3);
+    assert(reloaded.getCached({ ...probe, args: ['-O0'] }) == undefined && reloaded.getCached({ ...probe, args: ['-O4'] }) != undefined, 'oldest records are dropped');
+
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+    console.log('all compiler probe cache tests passed');
+}
+
+main().catch((err) => {
+    console.error(err);
+    process.exit(1);
+});
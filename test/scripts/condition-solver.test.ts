@@ -0,0 +1,120 @@
+/**
+ * Smoke test for ConditionSolver — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/condition-solver.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import { ConditionSolver } from '../../src/ConditionSolver';
+import { PackComponent, PackConditionGroup } from '../../src/PackIndex';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const conditions = new Map<string, PackConditionGroup>([
+    ['STM32F4', { acceptList: [], requireList: [{ Dvendor: 'STMicroelectronics:13', Dname: /STM32F4.*?/i }] }],
+    ['ARMCC', { acceptList: [], requireList: [{ compiler: 'AC6' }] }],
+    ['GCC', { acceptList: [], requireList: [{ compiler: 'GCC' }] }],
+    ['Any Compiler', { acceptList: [{ condition: 'GCC' }, { condition: 'ARMCC' }], requireList: [] }],
+    ['HAL', { acceptList: [], requireList: [{ condition: 'STM32F4' }, { component: 'Device.HAL.Common' }, { component: 'CMSIS.CORE' }] }],
+    ['HAL GPIO', { acceptList: [], requireList: [{ condition: 'HAL' }, { component: 'Device.HAL.RCC' }] }],
+    ['HAL UART', { acceptList: [], requireList: [{ condition: 'HAL' }, { component: 'Device.HAL.GPIO' }, { component: 'Device.HAL.DMA' }] }],
+    ['HAL DMA', { acceptList: [], requireList: [{ condition: 'HAL' }, { condition: 'GCC' }] }],
+    ['Startup', { acceptList: [{ condition: 'Any Compiler', component: 'Device.Startup' }], requireList: [] }],
+    ['Loop A', { acceptList: [], requireList: [{ condition: 'Loop B' }, { component: 'Device.A' }] }],
+    ['Loop B', { acceptList: [], requireList: [{ condition: 'Loop A' }, { component: 'Device.B' }] }],
+]);
+
+const ctx = { vendor: 'STMicroelectronics:13', device: 'STM32F407VG', compiler: 'AC6', compilerOption: 'AC6' };
+
+// --- conditions ---
+
+const solver = new ConditionSolver(conditions, ctx);
+
+assert(solver.check('STM32F4'), 'device condition');
+assert(!solver.check('GCC') && solver.check('ARMCC'), 'compiler condition');
+assert(solver.check('Any Compiler'), 'one of the accept conditions is passed');
+assert(solver.check('Not Exist'), 'unknown condition is passed');
+
+const gpio = solver.evaluate('HAL GPIO');
+assert(gpio.passed && gpio.requires.join(',') == 'Device.HAL.Common,CMSIS.CORE,Device.HAL.RCC', 'requirements of the nested conditions');
+assert(solver.evaluate('HAL GPIO') === gpio, 'result is cached');
+
+const dma = solver.evaluate('HAL DMA');
+assert(!dma.passed && /Compiler category 'AC6' not match/.test(dma.error!), 'failed reason of a nested condition');
+
+assert(solver.evaluate('Startup').requires.join(',') == 'Device.Startup', 'component of the passed accept condition');
+
+const other = new ConditionSolver(conditions, { vendor: 'NXP:11', device: 'LPC1768' });
+assert(!other.check('HAL') && other.check('GCC') && other.check('Startup'), 'compiler conditions are ignored without a toolchain');
+
+const loopA = solver.evaluate('Loop A');
+assert(loopA.passed && loopA.requires.sort().join(',') == 'Device.A,Device.B', 'condition loop is passed');
+assert(solver.evaluate('Loop B').requires.sort().join(',') == 'Device.A,Device.B', 'result in a loop is not cached with the partial requirements');
+
+// --- components ---
+
+function comp(groupName: string, condition?: string, enable?: boolean): PackComponent {
+    return {
+        groupName, condition, enable: enable !== false,
+        incDirList: [], headerList: [], cFileList: [], asmList: []
+    };
+}
+
+const components = [
+    comp('HAL.Common', 'HAL'),
+    comp('HAL.RCC', 'HAL'),
+    comp('HAL.GPIO', 'HAL GPIO'),
+    comp('HAL.UART', 'HAL UART'),
+    comp('HAL.DMA', 'HAL DMA'),
+    comp('HAL.USB.Device', 'HAL'),
+    comp('HAL.USB.Host', 'HAL', false),
+    comp('Startup', 'Startup'),
+];
+
+const byName = (name: string) => components.find(c => c.groupName == name)!;
+
+const gpioRes = solver.resolveComponents([byName('HAL.GPIO')], components, () => false);
+assert(gpioRes.components.map(c => c.groupName).join(',') == 'HAL.Common,HAL.RCC,HAL.GPIO', 'dependencies are placed first');
+assert(gpioRes.ignored.join(',') == 'CMSIS.CORE' && gpioRes.conflicts.length == 0, 'non device components are ignored');
+
+const installed = solver.resolveComponents([byName('HAL.GPIO')], components, (n) => n == 'HAL.Common');
+assert(installed.components.map(c => c.groupName).join(',') == 'HAL.RCC,HAL.GPIO', 'installed dependencies are skipped');
+
+const uartRes = solver.resolveComponents([byName('HAL.UART')], components, () => false);
+assert(uartRes.conflicts.length == 1 && uartRes.conflicts[0].component == 'HAL.DMA', 'conflict of a dependency is reported');
+assert(!uartRes.components.some(c => c.groupName == 'HAL.DMA'), 'conflicted component is excluded');
+
+const usbRes = solver.resolveComponents([byName('HAL.USB.Device'), byName('Startup')], components, () => false);
+assert(usbRes.components.map(c => c.groupName).join(',') == 'HAL.Common,HAL.USB.Device,Startup', 'a batch of components');
+
+const prefix = new ConditionSolver(new Map([['USB', { acceptList: [], requireList: [{ component: 'Device.HAL.USB' }, { component: 'Device.HAL.SPI' }] }]]), ctx);
+const prefixRes = prefix.resolveComponents([comp('App', 'USB')], components, () => false);
+assert(prefixRes.components.map(c => c.groupName).join(',') == 'HAL.USB.Device,App', 'requirement matches the sub components, disabled ones are skipped');
+assert(prefixRes.missing.join(',') == 'Device.HAL.SPI', 'missing component is reported');
+
+// --- performance ---
+
+const big = new Map<string, PackConditionGroup>();
+const bigComps: PackComponent[] = [];
+for (let i = 0; i < 2000; i++) {
+    const req: any[] = [{ condition: 'STM32F4' }];
+    if (i > 0) req.push({ component: `Device.C${i - 1}` }, { condition: `C${Math.floor(i / 2)}` });
+    big.set(`C${i}`, { acceptList: [], requireList: req });
+    bigComps.push(comp(`C${i}`, `C${i}`));
+}
+big.set('STM32F4', conditions.get('STM32F4')!);
+
+const t0 = Date.now();
+const bigRes = new ConditionSolver(big, ctx).resolveComponents([bigComps[1999]], bigComps, () => false);
+const used = Date.now() - t0;
+assert(bigRes.components.length == 2000 && bigRes.components[0].groupName == 'C0', 'large selection is resolved');
+assert(used < 2000, `large selection is resolved in ${used} ms`);
+
+console.log('all condition solver tests passed');
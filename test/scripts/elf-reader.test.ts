@@ -0,0 +1,195 @@
+/**
+ * Smoke test for ElfReader — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/elf-reader.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import {
+    ElfFile,
+    isElfFile,
+    readElfSymbolTable,
+    getGnuSymbolTypeChar,
+} from '../../src/ElfReader';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+interface TestSym { name: string; value: number; size: number; info: number; shndx: number; }
+
+/**
+ * Build a tiny relocatable-like elf image:
+ *   [0] null, [1] .text, [2] .bss, [3] .symtab, [4] .strtab, [5] .shstrtab
+ */
+function buildElf(is64: boolean, le: boolean, syms: TestSym[]): Buffer {
+
+    const ehsize = is64 ? 64 : 52;
+    const shentsize = is64 ? 64 : 40;
+    const symentsize = is64 ? 24 : 16;
+
+    const w16 = (b: Buffer, v: number, o: number) => le ? b.writeUInt16LE(v, o) : b.writeUInt16BE(v, o);
+    const w32 = (b: Buffer, v: number, o: number) => le ? b.writeUInt32LE(v, o) : b.writeUInt32BE(v, o);
+    const w64 = (b: Buffer, v: number, o: number) => le ? b.writeBigUInt64LE(BigInt(v), o) : b.writeBigUInt64BE(BigInt(v), o);
+    const wword = (b: Buffer, v: number, o: number) => is64 ? w64(b, v, o) : w32(b, v, o);
+
+    // string tables
+    const mkStrtab = (names: string[]) => {
+        const offs: number[] = [];
+        let s = '\0';
+        for (const n of names) { offs.push(s.length); s += n + '\0'; }
+        return { buf: Buffer.from(s, 'utf8'), offs };
+    };
+    const strtab = mkStrtab(syms.map(s => s.name));
+    const shstrtab = mkStrtab(['.text', '.bss', '.symtab', '.strtab', '.shstrtab']);
+
+    const text = Buffer.alloc(16, 0xaa);
+    const symtab = Buffer.alloc(symentsize * (syms.length + 1));
+    syms.forEach((s, i) => {
+        const o = (i + 1) * symentsize;
+        w32(symtab, strtab.offs[i], o);
+        if (is64) {
+            symtab[o + 4] = s.info;
+            w16(symtab, s.shndx, o + 6);
+            w64(symtab, s.value, o + 8);
+            w64(symtab, s.size, o + 16);
+        } else {
+            w32(symtab, s.value, o + 4);
+            w32(symtab, s.size, o + 8);
+            symtab[o + 12] = s.info;
+            w16(symtab, s.shndx, o + 14);
+        }
+    });
+
+    let off = ehsize;
+    const textOff = off; off += text.length;
+    const symOff = off; off += symtab.length;
+    const strOff = off; off += strtab.buf.length;
+    const shstrOff = off; off += shstrtab.buf.length;
+    const shoff = off;
+    const shnum = 6;
+
+    const out = Buffer.alloc(shoff + shnum * shentsize);
+    out.set([0x7f, 0x45, 0x4c, 0x46, is64 ? 2 : 1, le ? 1 : 2, 1], 0);
+    w16(out, 2, 16);            // ET_EXEC
+    w16(out, is64 ? 243 : 40, 18);
+    w32(out, 1, 20);
+    wword(out, 0x08000000, 24); // entry
+    if (is64) {
+        w64(out, shoff, 40);
+        w16(out, ehsize, 52);
+        w16(out, shentsize, 58);
+        w16(out, shnum, 60);
+        w16(out, 5, 62);
+    } else {
+        w32(out, shoff, 32);
+        w16(out, ehsize, 40);
+        w16(out, shentsize, 46);
+        w16(out, shnum, 48);
+        w16(out, 5, 50);
+    }
+
+    text.copy(out, textOff);
+    symtab.copy(out, symOff);
+    strtab.buf.copy(out, strOff);
+    shstrtab.buf.copy(out, shstrOff);
+
+    // name, type, flags, addr, offset, size, link, entsize
+    const shdrs: number[][] = [
+        [0, 0, 0, 0, 0, 0, 0, 0],
+        [shstrtab.offs[0], 1, 0x6, 0x08000000, textOff, text.length, 0, 0],
+        [shstrtab.offs[1], 8, 0x3, 0x20000000, 0, 0x100, 0, 0],
+        [shstrtab.offs[2], 2, 0, 0, symOff, symtab.length, 4, symentsize],
+        [shstrtab.offs[3], 3, 0, 0, strOff, strtab.buf.length, 0, 0],
+        [shstrtab.offs[4], 3, 0, 0, shstrOff, shstrtab.buf.length, 0, 0],
+    ];
+    shdrs.forEach((h, i) => {
+        const o = shoff + i * shentsize;
+        w32(out, h[0], o);
+        w32(out, h[1], o + 4);
+        if (is64) {
+            w64(out, h[2], o + 8);
+            w64(out, h[3], o + 16);
+            w64(out, h[4], o + 24);
+            w64(out, h[5], o + 32);
+            w32(out, h[6], o + 40);
+            w64(out, h[7], o + 56);
+        } else {
+            w32(out, h[2], o + 8);
+            w32(out, h[3], o + 12);
+            w32(out, h[4], o + 16);
+            w32(out, h[5], o + 20);
+            w32(out, h[6], o + 24);
+            w32(out, h[7], o + 36);
+        }
+    });
+
+    return out;
+}
+
+const SYMS: TestSym[] = [
+    { name: 'main.c', value: 0, size: 0, info: 0x04, shndx: 0xfff1 },           // LOCAL FILE
+    { name: 'counter', value: 0x20000010, size: 4, info: 0x01, shndx: 2 },      // LOCAL OBJECT .bss
+    { name: 'main', value: 0x08000001, size: 12, info: 0x12, shndx: 1 },        // GLOBAL FUNC .text
+    { name: 'Default_Handler', value: 0x08000009, size: 2, info: 0x22, shndx: 1 }, // WEAK FUNC
+    { name: 'printf', value: 0, size: 0, info: 0x12, shndx: 0 },                // GLOBAL UNDEF
+];
+
+const tmpdir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-elf-'));
+
+for (const [is64, le] of [[false, true], [false, false], [true, true], [true, false]]) {
+
+    const tag = `elf${is64 ? 64 : 32}-${le ? 'le' : 'be'}`;
+    const file = path.join(tmpdir, `${tag}.elf`);
+    fs.writeFileSync(file, buildElf(is64, le, SYMS));
+
+    assert(isElfFile(file), `${tag}: isElfFile`);
+
+    const tab = readElfSymbolTable(file);
+    assert(tab.header.is64 === is64 && tab.header.littleEndian === le, `${tag}: header class/endian`);
+    assert(tab.header.entry === 0x08000000, `${tag}: entry point`);
+    assert(tab.sections.map(s => s.name).join(',') === ',.text,.bss,.symtab,.strtab,.shstrtab', `${tag}: section names`);
+    assert(tab.symbols.length === SYMS.length + 1, `${tag}: symbol count`);
+
+    const main = tab.symbols.find(s => s.name === 'main')!;
+    assert(main.value === 0x08000001 && main.size === 12, `${tag}: main value/size`);
+    assert(main.bind === 'GLOBAL' && main.type === 'FUNC' && main.section === '.text', `${tag}: main bind/type/section`);
+    assert(getGnuSymbolTypeChar(main, tab.sections) === 'T', `${tag}: main is 'T'`);
+
+    const counter = tab.symbols.find(s => s.name === 'counter')!;
+    assert(counter.bind === 'LOCAL' && counter.section === '.bss', `${tag}: counter local .bss`);
+    assert(getGnuSymbolTypeChar(counter, tab.sections) === 'b', `${tag}: counter is 'b'`);
+
+    const weak = tab.symbols.find(s => s.name === 'Default_Handler')!;
+    assert(getGnuSymbolTypeChar(weak, tab.sections) === 'W', `${tag}: weak is 'W'`);
+
+    const undef = tab.symbols.find(s => s.name === 'printf')!;
+    assert(undef.section === undefined && getGnuSymbolTypeChar(undef, tab.sections) === 'U', `${tag}: undefined is 'U'`);
+
+    const file_sym = tab.symbols.find(s => s.type === 'FILE')!;
+    assert(file_sym.name === 'main.c', `${tag}: file symbol`);
+
+    // early stop
+    let n = 0;
+    const elf = ElfFile.open(file);
+    elf.forEachSymbol(() => { n++; return n < 2; });
+    elf.close();
+    assert(n === 2, `${tag}: forEachSymbol early stop`);
+}
+
+const notElf = path.join(tmpdir, 'app.hex');
+fs.writeFileSync(notElf, ':00000001FF\n');
+assert(!isElfFile(notElf), 'isElfFile: rejects intel hex');
+
+fs.rmSync(tmpdir, { recursive: true, force: true });
+
+console.log('\nAll ElfReader checks passed.');
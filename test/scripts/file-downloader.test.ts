@@ -0,0 +1,207 @@
+/**
+ * Smoke test for FileDownloader — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/file-downloader.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import * as http from 'http';
+import * as crypto from 'crypto';
+import * as net from 'net';
+
+import { FileDownloader, DownloadCanceledError, DOWNLOAD_TEMP_SUFFIX, DOWNLOAD_STATE_SUFFIX } from '../../src/FileDownloader';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const sha256 = (buf: Buffer) => crypto.createHash('sha256').update(buf).digest('hex');
+const gitSha1 = (buf: Buffer) => crypto.createHash('sha1').update(`blob ${buf.length}\0`).update(buf).digest('hex');
+
+// --- a local http server with 'Range' support ---
+
+let content = crypto.randomBytes(5 * 1024 * 1024 + 123);
+let etag = '"v1"';
+let breakAfter = -1;        // close the connection after sending n bytes, once
+const BREAK_SIZE = 1024 * 1024;
+let supportRange = true;
+const ranges: string[] = [];
+
+const server = http.createServer((req, res) => {
+
+    const url = req.url || '';
+
+    if (url == '/redirect') {
+        res.writeHead(302, { Location: '/file' });
+        res.end();
+        return;
+    }
+
+    if (url != '/file') {
+        res.writeHead(404);
+        res.end();
+        return;
+    }
+
+    let start = 0;
+    let end = content.length - 1;
+    let status = 200;
+
+    const range = supportRange ? req.headers['range'] : undefined;
+    const ifRange = req.headers['if-range'];
+    if (range && (ifRange == undefined || ifRange == etag)) {
+        const m = /bytes=(\d+)-(\d*)/.exec(range)!;
+        start = parseInt(m[1]);
+        end = m[2] ? parseInt(m[2]) : end;
+        status = 206;
+        ranges.push(`${start}-${end}`);
+    }
+
+    const headers: http.OutgoingHttpHeaders = { 'Content-Length': end - start + 1, 'ETag': etag };
+    if (status == 206)
+        headers['Content-Range'] = `bytes ${start}-${end}/${content.length}`;
+    res.writeHead(status, headers);
+
+    const body = content.subarray(start, end + 1);
+    if (breakAfter >= 0) {
+        const n = breakAfter;
+        breakAfter = -1;
+        res.write(body.subarray(0, n), () => setTimeout(() => req.socket.destroy(), 50));
+        return;
+    }
+
+    res.end(body);
+});
+
+async function main() {
+
+    await new Promise<void>(resolve => server.listen(0, '127.0.0.1', () => resolve()));
+    const base = `http://127.0.0.1:${(<net.AddressInfo>server.address()).port}`;
+
+    const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-download-'));
+    const dest = path.join(tmpDir, 'toolchain.zip');
+    const noTempFiles = () => !fs.existsSync(dest + DOWNLOAD_TEMP_SUFFIX) && !fs.existsSync(dest + DOWNLOAD_STATE_SUFFIX);
+
+    // --- plain download ---
+
+    let lastProgress = 0;
+    let totalOk = true;
+    let res = await new FileDownloader(`${base}/file`, dest, {
+        hashes: ['sha1', 'sha256', 'git-sha1'],
+        onProgress: (n, total) => { lastProgress = n; totalOk = totalOk && total == content.length; }
+    }).download();
+    assert(fs.readFileSync(dest).equals(content) && res.size == content.length, 'file is downloaded');
+    assert(res.hashes['sha256'] == sha256(content) && res.hashes['sha1'] == crypto.createHash('sha1').update(content).digest('hex'), 'hashes are computed');
+    assert(res.hashes['git-sha1'] == gitSha1(content), 'git hash is computed');
+    assert(lastProgress == content.length && totalOk && !res.resumed && noTempFiles(), 'progress is reported, no temp files are left');
+    fs.unlinkSync(dest);
+
+    // --- redirect and the expected hash ---
+
+    res = await new FileDownloader(`${base}/redirect`, dest, { expectedHash: { algorithm: 'sha256', value: sha256(content).toUpperCase() } }).download();
+    assert(fs.readFileSync(dest).equals(content), 'redirect is followed, the hash is verified');
+    fs.unlinkSync(dest);
+
+    let error: any;
+    try {
+        await new FileDownloader(`${base}/file`, dest, { expectedHash: { algorithm: 'sha256', value: '00' } }).download();
+    } catch (err) {
+        error = err;
+    }
+    assert(error && /not matched/.test(error.message) && !fs.existsSync(dest) && noTempFiles(), 'hash mismatch, the file is deleted');
+
+    error = undefined;
+    try {
+        await new FileDownloader(`${base}/none`, dest).download();
+    } catch (err) {
+        error = err;
+    }
+    assert(error && /http code: 404/.test(error.message), 'http error');
+
+    // --- resume a broken download ---
+
+    breakAfter = BREAK_SIZE;
+    error = undefined;
+    try {
+        await new FileDownloader(`${base}/file`, dest, { retries: 0 }).download();
+    } catch (err) {
+        error = err;
+    }
+    assert(error != undefined && !fs.existsSync(dest) && fs.existsSync(dest + DOWNLOAD_STATE_SUFFIX), 'broken download keeps the resume state');
+
+    ranges.length = 0;
+    res = await new FileDownloader(`${base}/file`, dest, { hashes: ['sha256'] }).download();
+    assert(res.resumed && ranges.length == 1 && ranges[0] == `${BREAK_SIZE}-${content.length - 1}`, 'download is resumed from the broken position');
+    assert(fs.readFileSync(dest).equals(content) && res.hashes['sha256'] == sha256(content) && noTempFiles(), 'resumed file and hash are correct');
+    fs.unlinkSync(dest);
+
+    // --- retry in one download ---
+
+    breakAfter = 100 * 1024;
+    res = await new FileDownloader(`${base}/file`, dest, { hashes: ['sha256'] }).download();
+    assert(res.hashes['sha256'] == sha256(content) && !res.resumed, 'broken connection is retried');
+    fs.unlinkSync(dest);
+
+    // --- the file on the server is changed ---
+
+    breakAfter = 1024 * 1024;
+    try { await new FileDownloader(`${base}/file`, dest, { retries: 0 }).download(); } catch (err) { /* broken */ }
+    content = crypto.randomBytes(3 * 1024 * 1024);
+    etag = '"v2"';
+    res = await new FileDownloader(`${base}/file`, dest, { hashes: ['sha256'] }).download();
+    assert(!res.resumed && res.hashes['sha256'] == sha256(content) && fs.readFileSync(dest).equals(content), 'changed file is downloaded again');
+    fs.unlinkSync(dest);
+
+    // --- parallel segments ---
+
+    ranges.length = 0;
+    res = await new FileDownloader(`${base}/file`, dest, { hashes: ['sha256', 'git-sha1'], segments: 3 }).download();
+    assert(ranges.length == 3 && ranges[0] == `0-${content.length - 1}`, 'the file is downloaded by 3 segments');
+    assert(fs.readFileSync(dest).equals(content) && res.hashes['sha256'] == sha256(content), 'segmented file and hash are correct');
+    assert(res.hashes['git-sha1'] == gitSha1(content), 'git hash of the segmented file');
+    fs.unlinkSync(dest);
+
+    // --- server without 'Range' ---
+
+    supportRange = false;
+    breakAfter = 1024;
+    error = undefined;
+    try {
+        await new FileDownloader(`${base}/file`, dest, { segments: 4 }).download();
+    } catch (err) {
+        error = err;
+    }
+    assert(error && /not support to resume/.test(error.message), 'broken download can not be resumed without \'Range\'');
+    res = await new FileDownloader(`${base}/file`, dest, { segments: 4, hashes: ['sha256'] }).download();
+    assert(res.hashes['sha256'] == sha256(content) && fs.readFileSync(dest).equals(content), 'download without \'Range\'');
+    fs.unlinkSync(dest);
+    supportRange = true;
+
+    // --- cancel ---
+
+    const dl = new FileDownloader(`${base}/file`, dest, { onProgress: () => dl.cancel() });
+    error = undefined;
+    try {
+        await dl.download();
+    } catch (err) {
+        error = err;
+    }
+    assert(error instanceof DownloadCanceledError && !fs.existsSync(dest), 'download is canceled');
+
+    server.close();
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+    console.log('all file downloader tests passed');
+}
+
+main().catch((err) => {
+    console.error(err);
+    process.exit(1);
+});
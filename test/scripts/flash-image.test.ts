@@ -0,0 +1,131 @@
+/**
+ * Smoke test for FlashImage — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/flash-image.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import { FlashImage, FlashSectorRegion, diffFlashImage } from '../../src/FlashImage';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+function hexRecord(type: number, offset: number, data: number[]): string {
+    const rec = [data.length, (offset >> 8) & 0xff, offset & 0xff, type].concat(data);
+    const sum = (0x100 - (rec.reduce((a, b) => a + b, 0) & 0xff)) & 0xff;
+    return ':' + rec.concat(sum).map(b => b.toString(16).padStart(2, '0')).join('').toUpperCase();
+}
+
+const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-flash-image-'));
+
+// --- intel hex / s-record ---
+
+const hexPath = path.join(tmpDir, 'app.hex');
+fs.writeFileSync(hexPath, [
+    hexRecord(0x04, 0, [0x08, 0x00]),
+    hexRecord(0x00, 0x0000, [1, 2, 3, 4]),
+    hexRecord(0x00, 0x0004, [5, 6, 7, 8]),
+    hexRecord(0x00, 0x1000, [9]),
+    hexRecord(0x01, 0, [])
+].join('\n'));
+
+const hexImg = FlashImage.fromFile(hexPath);
+assert(hexImg.segments.length == 2, 'hex: adjacent records are merged');
+assert(hexImg.segments[0].addr == 0x08000000 && hexImg.segments[0].data.length == 8, 'hex: extended linear address');
+assert(hexImg.read(0x08000006, 0x0800000A, 0xff).equals(Buffer.from([7, 8, 0xff, 0xff])), 'hex: read fills the gap');
+
+const srecPath = path.join(tmpDir, 'app.s19');
+const s1 = Buffer.from([0x07, 0x00, 0x00, 1, 2, 3, 4]);
+const s1sum = (~s1.reduce((a, b) => a + b, 0)) & 0xff;
+fs.writeFileSync(srecPath, `S0030000FC\nS1${s1.toString('hex').toUpperCase()}${s1sum.toString(16).padStart(2, '0')}\n`);
+const srecImg = FlashImage.fromFile(srecPath);
+assert(srecImg.segments.length == 1 && srecImg.segments[0].data.equals(Buffer.from([1, 2, 3, 4])), 's-record: data record');
+
+let badHex = false;
+fs.writeFileSync(hexPath, ':0400000001020304F1\n');
+try { FlashImage.fromFile(hexPath); } catch (e) { badHex = true; }
+assert(badHex, 'hex: checksum error is reported');
+
+// --- overwrite and save/load ---
+
+const img = new FlashImage();
+img.write(0x100, Buffer.alloc(16, 0x11));
+img.write(0x108, Buffer.alloc(16, 0x22));
+assert(img.segments.length == 1 && img.segments[0].data.length == 24, 'overlapped writes are merged');
+assert(img.read(0x107, 0x109, 0).equals(Buffer.from([0x11, 0x22])), 'later write wins');
+
+const imgPath = path.join(tmpDir, 'state', 'a.img');
+img.save(imgPath);
+const loaded = FlashImage.load(imgPath);
+assert(loaded.segments.length == 1 && loaded.segments[0].addr == 0x100 &&
+    loaded.segments[0].data.equals(img.segments[0].data), 'save/load round trip');
+
+// --- sector diff ---
+
+const layout: FlashSectorRegion[] = [
+    { start: 0x08000000, end: 0x08010000, sectorSize: 0x4000, erasedValue: 0xff },
+    { start: 0x08010000, end: 0x08020000, sectorSize: 0x10000, erasedValue: 0xff },
+];
+
+const oldImg = new FlashImage();
+oldImg.write(0x08000000, Buffer.alloc(0x12000, 0x55));
+
+const newImg = new FlashImage();
+newImg.write(0x08000000, Buffer.alloc(0x11000, 0x55));
+newImg.write(0x08004010, Buffer.from([1]));
+newImg.write(0x08008000, Buffer.from([2]));
+
+const delta = diffFlashImage(oldImg, newImg, layout);
+assert(delta != undefined, 'diff: image is in the layout');
+if (delta) {
+    assert(delta.totalSectors == 5, 'diff: touched sectors of both images');
+    assert(delta.changedSectors == 3, 'diff: changed sectors (two small ones and the shrunk big one)');
+    assert(delta.chunks.length == 2, 'diff: adjacent sectors are merged');
+    assert(delta.chunks[0].addr == 0x08004000 && delta.chunks[0].data.length == 0x8000, 'diff: merged chunk');
+    assert(delta.chunks[1].addr == 0x08010000 && delta.chunks[1].data.length == 0x10000, 'diff: big sector');
+    assert(delta.chunks[1].data[0x1000] == 0xff, 'diff: bytes out of the new image are erased');
+}
+
+const same = diffFlashImage(newImg, newImg, layout);
+assert(same != undefined && same.chunks.length == 0, 'diff: same image');
+
+const outside = new FlashImage();
+outside.write(0x20000000, Buffer.from([1]));
+assert(diffFlashImage(oldImg, outside, layout) == undefined, 'diff: out of layout needs a full flash');
+
+// --- merge and output ---
+
+const bootPath = path.join(tmpDir, 'boot.bin');
+const appPath = path.join(tmpDir, 'app.bin');
+fs.writeFileSync(bootPath, Buffer.alloc(0x100, 0xb0));
+fs.writeFileSync(appPath, Buffer.alloc(0x20000, 0xa0));
+
+const merged = FlashImage.merge([{ path: bootPath }, { path: appPath, addr: '0x0800FFF0' }], '0x08000000');
+assert(merged.overlaps.length == 0, 'merge: no overlap');
+assert(merged.image.segments.length == 2, 'merge: two segments');
+
+const mergedHex = path.join(tmpDir, 'merged.hex');
+merged.image.writeFile(mergedHex);
+const reloaded = FlashImage.fromFile(mergedHex);
+assert(reloaded.segments.length == 2 && reloaded.segments[1].addr == 0x0800FFF0 &&
+    reloaded.segments[1].data.equals(merged.image.segments[1].data), 'hex output round trip (crosses 64K boundary)');
+
+const bin = merged.image.toBinary();
+assert(bin.addr == 0x08000000 && bin.data.length == 0xFFF0 + 0x20000 && bin.data[0x100] == 0xff, 'bin output fills the gap');
+
+const conflict = FlashImage.merge([{ path: bootPath }, { path: appPath, addr: '0x08000080' }], '0x08000000');
+assert(conflict.overlaps.length == 1 && conflict.overlaps[0].start == 0x08000080 &&
+    conflict.overlaps[0].end == 0x08000100, 'merge: overlap is reported');
+
+fs.rmSync(tmpDir, { recursive: true, force: true });
+console.log('all flash image tests passed');
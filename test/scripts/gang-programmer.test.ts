@@ -0,0 +1,91 @@
+/**
+ * Test for GangProgrammer with a stub flasher executable — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/gang-programmer.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as child_process from 'child_process';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import { GangFlashResult, formatGangReport, parseProbeSerials, runGang } from '../../src/GangProgrammer';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+// a stub flasher: 'BAD*' probes always fail, 'FLAKY*' probes fail at the first time
+const STUB_FLASHER = `
+const fs = require('fs');
+const sn = process.argv[2];
+const mark = process.argv[3] + '.' + sn;
+setTimeout(() => {
+    if (sn.startsWith('BAD') || (sn.startsWith('FLAKY') && !fs.existsSync(mark))) {
+        fs.writeFileSync(mark, '');
+        console.error('Error: target not connected');
+        process.exit(1);
+    }
+    console.log('Programming done: ' + sn);
+}, 100);
+`;
+
+async function main() {
+
+    const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-gang-'));
+    const flasherPath = path.join(tmpDir, 'stub-flasher.js');
+    fs.writeFileSync(flasherPath, STUB_FLASHER);
+
+    let running = 0;
+    let maxRunning = 0;
+
+    const flash = (sn: string) => new Promise<GangFlashResult>((resolve) => {
+        running++;
+        maxRunning = Math.max(maxRunning, running);
+        child_process.execFile(process.execPath, [flasherPath, sn, path.join(tmpDir, 'mark')], (error, stdout, stderr) => {
+            running--;
+            resolve({ success: !error, message: stdout + stderr, error: error || undefined });
+        });
+    });
+
+    // --- serials ---
+
+    const serials = parseProbeSerials('SN1, SN2;SN3 SN4\n SN5,SN1,,FLAKY6 BAD7');
+    assert(serials.join(',') == 'SN1,SN2,SN3,SN4,SN5,FLAKY6,BAD7', 'serials: split and deduplicate');
+
+    // --- parallel ---
+
+    const report = await runGang(serials, flash, { concurrency: 3 });
+    assert(maxRunning == 3, 'gang: boards are flashed in parallel, up to the concurrency limit');
+    assert(report.boards.map(b => b.serial).join(',') == serials.join(','), 'gang: results keep the order of the probes');
+    assert(report.passed == 5 && report.failed == 2, 'gang: pass/fail count');
+    assert(/Error: target not connected/.test(report.boards[6].log), 'gang: log of the failed board');
+    assert(/Programming done: SN1/.test(report.boards[0].log) && report.boards[0].attempts == 1, 'gang: log of the passed board');
+
+    const text = formatGangReport(report, 'test');
+    assert(/5 passed, 2 failed, 7 total/.test(text) && /=== BAD7 ===/.test(text) && !/=== SN1 ===/.test(text), 'report: summary and failed logs');
+
+    // --- retry ---
+
+    const failed = report.boards.filter(b => !b.success).map(b => b.serial);
+    const retried = await runGang(failed, flash, { retries: 2 });
+    assert(retried.boards[0].success && retried.boards[0].attempts == 1, 'retry: flaky board passed');
+    assert(!retried.boards[1].success && retried.boards[1].attempts == 3, 'retry: bad board uses up the retries');
+
+    const thrown = await runGang(['X'], () => { throw new Error('no uploader'); });
+    assert(!thrown.boards[0].success && thrown.boards[0].error == 'no uploader', 'gang: thrown error is a failure');
+
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+    console.log('all gang programmer tests passed');
+}
+
+main().catch((err) => {
+    console.error('FAIL:', err);
+    process.exit(1);
+});
@@ -0,0 +1,223 @@
+/**
+ * Smoke test for res/data/gcc_retarget.c — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/gcc-retarget.test.js
+ *
+ * The library is built for the host with a mock backend, needs 'gcc' or 'clang'.
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import * as child_process from 'child_process';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const resDir = path.resolve(__dirname, '..', '..', '..', '..', 'res', 'data');
+const altResDir = path.resolve(__dirname, '..', '..', 'res', 'data'); // run from the source tree
+const libDir = fs.existsSync(path.join(resDir, 'gcc_retarget.c')) ? resDir : altResDir;
+
+// the driver, it overrides the weak backend and the cycle counter
+const driver = String.raw`
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/times.h>
+#include "gcc_retarget.h"
+
+int _write(int file, char *ptr, int len);
+void *_sbrk(ptrdiff_t incr);
+int _gettimeofday(struct timeval *tv, void *tz);
+clock_t _times(struct tms *buf);
+
+#define CHECK(c, msg) do { if (!(c)) { printf("FAIL: %s\n", msg); exit(1); } printf("OK: %s\n", msg); } while (0)
+
+static uint8_t out[1 << 16];
+static size_t out_len;
+static size_t calls;
+static size_t accept_limit = (size_t)-1;
+static volatile unsigned call_cost;
+
+size_t retarget_backend_write(const uint8_t *data, size_t len)
+{
+    calls++;
+    for (volatile unsigned i = 0; i < call_cost; i++) ;
+    if (len > accept_limit) len = accept_limit;
+    if (out_len + len > sizeof(out)) out_len = 0;
+    memcpy(out + out_len, data, len);
+    out_len += len;
+    return len;
+}
+
+static uint32_t cycles;
+uint32_t retarget_get_cycles(void) { return cycles; }
+
+static void reset(void) { out_len = 0; calls = 0; }
+static int out_is(const char *s) { return out_len == strlen(s) && memcmp(out, s, out_len) == 0; }
+
+/* a usual '_write' of the applications, one backend call per char */
+static int bytewise_write(int file, char *ptr, int len)
+{
+    (void)file;
+    for (int i = 0; i < len; i++)
+        retarget_backend_write((const uint8_t *)&ptr[i], 1);
+    return len;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void bench(void)
+{
+    char line[64];
+    memset(line, 'x', sizeof(line));
+    line[sizeof(line) - 1] = '\n';
+
+    const int lines = 20000;
+    call_cost = 50; // register setup of a uart transfer
+
+    double t0 = now();
+    for (int i = 0; i < lines; i++)
+        bytewise_write(1, line, sizeof(line));
+    double t1 = now();
+    for (int i = 0; i < lines; i++)
+        _write(1, line, sizeof(line));
+    double t2 = now();
+
+    double mb = lines * sizeof(line) / 1e6;
+    printf("BENCH: bytewise %.2f MB/s, buffered %.2f MB/s\n", mb / (t1 - t0), mb / (t2 - t1));
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        bench();
+        return 0;
+    }
+
+    CHECK(retarget_stats.magic == RETARGET_STATS_MAGIC && retarget_stats.version == 1, "stats header");
+
+    /* --- output --- */
+
+    CHECK(_write(1, "abc", 3) == 3 && calls == 0 && retarget_stats.buf_peak == 3, "output is buffered");
+    CHECK(_write(1, "de\n", 3) == 3 && calls == 1 && out_is("abcde\n"), "flushed at a new line, in one backend call");
+
+    reset();
+    CHECK(_write(2, "err", 3) == 3 && out_is("err"), "stderr is not buffered");
+
+    errno = 0;
+    CHECK(_write(3, "x", 1) == -1 && errno == EBADF, "bad file");
+
+    static char big[1024];
+    for (size_t i = 0; i < sizeof(big); i++) big[i] = (char)('a' + i % 26);
+
+    reset();
+    _write(1, big, 200);
+    _write(1, big + 200, 200);
+    retarget_flush();
+    CHECK(out_len == 400 && memcmp(out, big, 400) == 0, "wrapped data is flushed in order");
+
+    reset();
+    CHECK(_write(1, big, 1000) == 1000 && calls == 1 && out_len == 1000 && memcmp(out, big, 1000) == 0, "large block is sent directly");
+
+    reset();
+    accept_limit = 0;
+    uint32_t dropped = retarget_stats.bytes_dropped;
+    _write(1, big, 600);
+    CHECK(retarget_stats.bytes_dropped - dropped == 600 - RETARGET_BUF_SIZE, "data is dropped when the backend is busy");
+    accept_limit = (size_t)-1;
+    retarget_flush();
+    CHECK(out_len == RETARGET_BUF_SIZE && memcmp(out, big, RETARGET_BUF_SIZE) == 0, "buffered data is sent later");
+
+    /* --- heap --- */
+
+    uint8_t *base = _sbrk(100);
+    CHECK(base != (void *)-1 && ((uintptr_t)base & 7) == 0 && retarget_stats.heap_used == 100, "heap is allocated");
+    CHECK(_sbrk(-50) == base + 100 && retarget_stats.heap_used == 50 && retarget_stats.heap_peak == 100, "heap watermark");
+
+    errno = 0;
+    CHECK(_sbrk(retarget_stats.heap_size) == (void *)-1 && errno == ENOMEM && retarget_stats.sbrk_fails == 1, "heap limit");
+
+    CHECK(retarget_heap_check(), "heap guard is intact");
+    memset(base, 0, 60);
+    CHECK(!retarget_heap_check() && retarget_stats.guard_errors == 1, "broken heap guard is detected");
+    CHECK(retarget_heap_check(), "heap guard is restored");
+
+    /* --- time --- */
+
+    struct timeval tv;
+    struct tms tms;
+    errno = 0;
+    CHECK(_gettimeofday(&tv, NULL) == -1 && errno == ENOSYS, "no time without cpu frequency");
+
+    retarget_cpu_freq = 1000000;
+    cycles = 2500000;
+    CHECK(_gettimeofday(&tv, NULL) == 0 && tv.tv_sec == 2 && tv.tv_usec == 500000, "gettimeofday");
+    CHECK(_times(&tms) == (clock_t)(2.5 * CLOCKS_PER_SEC) && tms.tms_utime == (clock_t)(2.5 * CLOCKS_PER_SEC), "times");
+
+    cycles = 0xFFFFFFF0U;
+    retarget_cycles64();
+    cycles = 0x10;
+    CHECK(retarget_cycles64() == 0x100000010ULL, "overflow of the cycle counter");
+
+    return 0;
+}
+`;
+
+let cc: string | undefined;
+for (const c of ['gcc', 'clang']) {
+    try {
+        child_process.execFileSync(c, ['--version'], { stdio: 'ignore' });
+        cc = c;
+        break;
+    } catch (error) {
+        // not found
+    }
+}
+
+if (!cc || os.platform() == 'win32') {
+    console.log('SKIP: no host c compiler');
+    process.exit(0);
+}
+
+const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-retarget-'));
+const drvFile = path.join(tmpDir, 'driver.c');
+const exeFile = path.join(tmpDir, 'retarget_test');
+fs.writeFileSync(drvFile, driver);
+
+const cflags = ['-O2', '-Wall', '-Wextra', '-Werror', '-I', libDir];
+
+// the default configuration (heap from the linker symbol 'end') only needs to compile
+child_process.execFileSync(cc, cflags.concat(['-c', path.join(libDir, 'gcc_retarget.c'), '-o', path.join(tmpDir, 'default.o')]));
+assert(true, 'default configuration is compiled');
+
+child_process.execFileSync(cc, cflags.concat(['-DRETARGET_BUF_SIZE=256', '-DRETARGET_HEAP_SIZE=4096', path.join(libDir, 'gcc_retarget.c'), drvFile, '-o', exeFile]));
+assert(true, 'built with a mock backend');
+
+const run = (args: string[]) => {
+    const r = child_process.spawnSync(exeFile, args, { encoding: 'utf8' });
+    process.stdout.write(r.stdout);
+    return r;
+};
+
+assert(run([]).status == 0, 'host tests are passed');
+
+const m = /bytewise ([\d.]+) MB\/s, buffered ([\d.]+) MB\/s/.exec(run(['bench']).stdout);
+assert(m != null && parseFloat(m[2]) > parseFloat(m[1]), 'buffered output is faster than a bytewise \'_write\'');
+
+fs.rmSync(tmpDir, { recursive: true, force: true });
+console.log('all retarget tests passed');
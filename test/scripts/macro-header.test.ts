@@ -0,0 +1,91 @@
+/**
+ * Smoke test for MacroHeader — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/macro-header.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import * as child_process from 'child_process';
+
+import { renderMacroHeader, writeMacroHeader, MacroDefine, PROBED_MACROS_FLAG } from '../../src/MacroHeader';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-macro-'));
+const outDir = path.join(tmpDir, 'intellisense');
+
+// a builtin header like 'lint_armclang.h'
+const baseHeader = path.join(tmpDir, 'lint_armclang.h');
+fs.writeFileSync(baseHeader, [
+    `#ifndef ${PROBED_MACROS_FLAG}`,
+    `#define __ARMCC_VERSION 6100100`,
+    `#define __ARM_ARCH 4`,
+    `#endif`,
+    `void __breakpoint(int val);`,
+].join('\n'));
+
+const macros: MacroDefine[] = [
+    { type: 'var', name: '__ARMCC_VERSION', value: '6220000' },
+    { type: 'var', name: '__ARM_ARCH', value: '7' },
+    { type: 'var', name: '__ARM_FP', value: '0xC' },
+    { type: 'var', name: '__ARM_ARCH', value: '4' },
+    { type: 'func', name: '__ARM_ALIGN(x)', value: '__attribute__((aligned(x)))' },
+    { type: 'var', name: '__ARM_EMPTY', value: '' },
+];
+
+const src = { toolchain: 'AC6', macros: macros, baseHeaders: [baseHeader] };
+const text = renderMacroHeader(src);
+
+assert(text.includes(`#define ${PROBED_MACROS_FLAG} 1`) && text.includes('#define __ARMCC_VERSION 6220000'), 'compiler macros are written');
+assert(text.split('\n').filter(l => l.startsWith('#define __ARM_ARCH ')).join() == '#define __ARM_ARCH 7', 'duplicated macros are dropped');
+assert(text.includes('#define __ARM_ALIGN(x) __attribute__((aligned(x)))') && text.includes('#define __ARM_EMPTY\n'), 'function and empty macros');
+assert(text.indexOf(`#include "${baseHeader.replace(/\\/g, '/')}"`) > text.indexOf('__ARM_FP'), 'builtin header is included after the macros');
+
+// --- write ---
+
+const p1 = writeMacroHeader(outDir, src);
+const ino = fs.statSync(p1).ino;
+assert(fs.readFileSync(p1, 'utf8') == text && path.basename(p1).startsWith('ac6_'), 'header is written');
+assert(writeMacroHeader(outDir, src) == p1 && fs.statSync(p1).ino == ino, 'same macros, the header is not rewritten');
+
+const p2 = writeMacroHeader(outDir, { ...src, macros: [{ type: 'var', name: '__ARM_ARCH', value: '8' }] });
+assert(p2 != p1 && fs.existsSync(p1), 'other target options, another header');
+
+const old = path.join(outDir, 'ac6_0000000000000000.h');
+fs.writeFileSync(old, '');
+fs.utimesSync(old, new Date(Date.now() - 40 * 24 * 3600 * 1000), new Date(Date.now() - 40 * 24 * 3600 * 1000));
+writeMacroHeader(outDir, { ...src, macros: [{ type: 'var', name: '__ARM_ARCH', value: '6' }] });
+assert(!fs.existsSync(old) && fs.existsSync(p2), 'expired headers are deleted');
+
+// --- the header works with a preprocessor ---
+
+let cc: string | undefined;
+for (const c of ['gcc', 'clang']) {
+    try {
+        child_process.execFileSync(c, ['--version'], { stdio: 'ignore' });
+        cc = c;
+        break;
+    } catch (error) {
+        // not found
+    }
+}
+
+if (cc) {
+    const out = child_process.execFileSync(cc, ['-E', '-dM', '-D__VSCODE_CPPTOOL', '-include', p1, '-x', 'c', os.platform() == 'win32' ? 'NUL' : '/dev/null']).toString();
+    assert(/#define __ARMCC_VERSION 6220000/.test(out) && /#define __ARM_ARCH 7/.test(out), 'macro snapshot of the builtin header is skipped');
+} else {
+    console.log('SKIP: no c preprocessor');
+}
+
+fs.rmSync(tmpDir, { recursive: true, force: true });
+console.log('all macro header tests passed');
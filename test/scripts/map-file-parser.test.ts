@@ -0,0 +1,157 @@
+/**
+ * Smoke test for MapFileParser — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/map-file-parser.test.js
+ *
+ * Expected sizes are the output of res/data/patches/memap.py on the same input.
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import {
+    parseMapLines,
+    parseMapFileReport,
+    makeMemoryReport,
+    makeMemoryReportTable,
+    readLines,
+} from '../../src/MapFileParser';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const GCC_MAP = [
+    'Archive member included to satisfy reference by file (symbol)',
+    '',
+    'Linker script and memory map',
+    '',
+    '.text           0x08000000      0x1a0',
+    ' .text          0x08000000       0x40 ./build/Debug/.obj/src/main.o',
+    '                0x08000000                main',
+    ' .text          0x08000040       0x60 ./build/Debug/.obj/src/drv/uart.o',
+    ' .text          0x080000a0       0x20 /opt/gcc/lib/gcc/arm-none-eabi/10.3.1/thumb/libgcc.a(_udivsi3.o)',
+    ' *fill*         0x080000c0        0x4 ',
+    ' .text.memcpy   0x080000c4       0x1c /opt/gcc/arm-none-eabi/lib/thumb/libc_nano.a(lib_a-memcpy.o)',
+    '',
+    '.rodata         0x080000e0       0x10',
+    ' .rodata        0x080000e0       0x10 ./build/Debug/.obj/src/main.o',
+    '',
+    '.data           0x20000000        0x8 load address 0x080000f0',
+    ' .data          0x20000000        0x8 ./build/Debug/.obj/src/drv/uart.o',
+    '',
+    '.bss            0x20000008      0x104',
+    ' .bss           0x20000008      0x100 ./build/Debug/.obj/src/main.o',
+    ' COMMON         0x20000108        0x4 ./build/Debug/.obj/src/drv/uart.o',
+    'OUTPUT(build/Debug/app.elf elf32-littlearm)',
+    ' .text          0x00000000      0x999 ./build/Debug/.obj/src/ignored.o',
+].join('\n');
+
+const ARMCC_MAP = [
+    'Memory Map of the image',
+    '',
+    '    Base Addr    Size         Type   Attr      Idx    E Section Name        Object',
+    '',
+    '    0x08000000   0x00000188   Data   RO            3    RESET               ./build/Debug/.obj/startup_stm32f103xb.o',
+    '    0x08000188   0x00000004   Code   RO          123    .ARM.Collect$$$$00000001  mc_w.l(entry2.o)',
+    '    0x080001b0   0x00000040   Code   RO           10    i.main              ./build/Debug/.obj/src/main.o',
+    '    0x08000254   0x00000010   Data   RO           11    .constdata          ./build/Debug/.obj/src/main.o',
+    '    0x20000000   0x00000004   Data   RW           12    .data               ./build/Debug/.obj/src/main.o',
+    '    0x20000004   0x00000100   Zero   RW           13    .bss                ./build/Debug/.obj/src/main.o',
+    '    0x20000304   0x00000400   Zero   RW            2    ARM_LIB_HEAP        anon$$obj.o',
+].join('\n');
+
+const IAR_MAP = [
+    '#    Command line =',
+    '#        /proj/build/obj/src/main.o',
+    '#        /proj/build/obj/drv/uart.o -o /proj/build/app.out',
+    '*******************************************************************************',
+    '  Section            Kind         Address    Size  Object',
+    '  -------            ----         -------    ----  ------',
+    '  .text              ro code   0x0800\'0040   0x88  main.o [1]',
+    '  .text              ro code   0x0800\'00c8   0x3c  uart.o [2]',
+    '  .rodata            const     0x0800\'0104   0x10  main.o [1]',
+    '  .text              ro code   0x0800\'0114   0x22  ABImemcpy.o [4]',
+    '  .bss               zero      0x2000\'0000    0x4  main.o [1]',
+    '  .data              inited    0x2000\'0004    0x8  uart.o [2]',
+    '  CSTACK             uninit    0x2000\'0010  0x400  <Block tail>',
+    '*** MODULE SUMMARY',
+    'rt7M_tl.a: [4]',
+    '    ABImemcpy.o          34',
+].join('\n');
+
+const lines = (s: string) => s.split('\n');
+
+// --- GCC ---
+{
+    const { modules } = parseMapLines(lines(GCC_MAP), 'GCC_ARM');
+    const main = modules.get(path.join('src', 'main.o'));
+    assert(main !== undefined && main['.text'] === 0x40 && main['.rodata'] === 0x10 && main['.bss'] === 0x100, 'gcc: src/main.o sizes');
+    const uart = modules.get(path.join('src', 'drv', 'uart.o'));
+    assert(uart !== undefined && uart['.text'] === 0x60 && uart['.data'] === 8 && uart['.bss'] === 4, 'gcc: COMMON counted in .bss');
+    assert(modules.get(path.join('[lib]', 'gcc.a', '_udivsi3.o'))?.['.text'] === 0x20, 'gcc: library member');
+    assert(modules.get(path.join('[lib]', 'c_nano.a', 'lib_a-memcpy.o'))?.['.text'] === 0x1c, 'gcc: library member with section suffix');
+    assert(modules.get('[fill]')?.['.text'] === 4, 'gcc: fill');
+    assert(!modules.has(path.join('src', 'ignored.o')), 'gcc: stop at OUTPUT');
+
+    const report = makeMemoryReport(modules, undefined, 1);
+    assert(report.summary.total_flash === 0x40 + 0x60 + 0x20 + 4 + 0x1c + 0x10 + 8, 'gcc: total flash');
+    assert(report.summary.static_ram === 8 + 0x104, 'gcc: static ram');
+    assert(report.modules.map(m => m.module).join(',') === '[fill],[lib],src', 'gcc: depth 1 module names');
+}
+
+// --- ARMCC ---
+{
+    const { modules } = parseMapLines(lines(ARMCC_MAP), 'ARM_MICRO');
+    const main = modules.get(path.join('src', 'main.o'));
+    assert(main !== undefined && main['.text'] === 0x40 && main['.rodata'] === 0x10 && main['.data'] === 4 && main['.bss'] === 0x100, 'armcc: src/main.o sizes');
+    assert(modules.get('startup_stm32f103xb.o')?.['.rodata'] === 0x188, 'armcc: RO data is .rodata');
+    assert(modules.get(path.join('[lib]', 'mc_w.l', 'entry2.o'))?.['.text'] === 4, 'armcc: library member');
+    assert(!modules.has('anon$$obj.o'), 'armcc: skip ARM_LIB_HEAP');
+}
+
+// --- IAR ---
+{
+    const { modules } = parseMapLines(lines(IAR_MAP), 'IAR');
+    const main = modules.get(path.join('src', 'main.o'));
+    assert(main !== undefined && main['.text'] === 0x88 && main['.rodata'] === 0x10 && main['.bss'] === 4, 'iar: src/main.o sizes');
+    assert(modules.get(path.join('drv', 'uart.o'))?.['.data'] === 8, 'iar: inited is .data');
+    assert(modules.get(path.join('[lib]', 'rt7M_tl.a', 'ABImemcpy.o'))?.['.text'] === 0x22, 'iar: library member renamed');
+    assert(modules.get('[misc]')?.['.stack'] === 0x400, 'iar: CSTACK is .stack');
+}
+
+// --- file + delta with .old ---
+{
+    const tmpdir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-map-'));
+    const mapFile = path.join(tmpdir, 'app.map');
+    // CRLF, and a line split over the read chunk boundary is fine
+    fs.writeFileSync(mapFile, GCC_MAP.replace(/\n/g, '\r\n'));
+    fs.writeFileSync(mapFile + '.old', GCC_MAP.replace('0x40 ./build/Debug/.obj/src/main.o', '0x30 ./build/Debug/.obj/src/main.o'));
+
+    assert(Array.from(readLines(mapFile)).every(l => !l.endsWith('\r')), 'readLines: strip CR');
+
+    // a utf8 char split by the read chunk (256 KiB)
+    const cjkFile = path.join(tmpdir, 'cjk.map');
+    fs.writeFileSync(cjkFile, 'a'.repeat(256 * 1024 - 4) + '\n./工程/主程序.o\n');
+    assert(Array.from(readLines(cjkFile))[1] === './工程/主程序.o', 'readLines: utf8 paths');
+
+    const report = parseMapFileReport(mapFile, 'GCC_ARM', 2);
+    const src = report.modules.find(m => m.module == 'src' + path.sep + 'main.o');
+    assert(src !== undefined && src.size['.text-delta'] === 0x10, 'delta: module .text-delta');
+    assert(report.summary.total_flash_delta === 0x10 && report.summary.static_ram_delta === 0, 'delta: summary');
+
+    const table = makeMemoryReportTable(report);
+    assert(table[0].startsWith('| Module') && table[1].startsWith('|---'), 'table: header');
+    assert(table[table.length - 1] === `Total Flash memory (text + data + rodata): ${report.summary.total_flash}(+16) bytes`, 'table: flash line');
+
+    fs.rmSync(tmpdir, { recursive: true, force: true });
+}
+
+console.log('\nAll MapFileParser checks passed.');
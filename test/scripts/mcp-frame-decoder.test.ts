@@ -0,0 +1,118 @@
+/**
+ * Smoke test for the MCP IPC frames and the tool progress parser — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/mcp-frame-decoder.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import { encodeMessage, FrameDecoder, IpcMessage, McpToolProgress } from '../../src/mcp/mcp_protocol';
+import { parseBuildOutputLine, parseFlashOutputLine, ToolOutputReporter } from '../../src/mcp/mcp_progress';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const decodeAll = (decoder: FrameDecoder, chunks: Buffer[]) => {
+    const msgs: IpcMessage[] = [];
+    for (const c of chunks)
+        for (const body of decoder.push(c))
+            msgs.push(JSON.parse(body.toString('utf8')));
+    return msgs;
+};
+
+// --- encode ---
+
+const msgs: IpcMessage[] = [
+    { type: 'ping' },
+    { type: 'toolCall', requestId: '1', tool: 'eide_build', args: { uid: 'ä中文' } },
+    { type: 'toolProgress', requestId: '1', progress: { kind: 'build', percent: 20, message: 'CC main.c' } },
+    { type: 'pong' },
+];
+const frames = msgs.map(m => encodeMessage(m));
+assert(frames[1].readUInt32BE(0) == Buffer.byteLength(JSON.stringify(msgs[1])) && frames[1].length == frames[1].readUInt32BE(0) + 4, 'frame length of utf8 text');
+
+// --- decode ---
+
+const stream = Buffer.concat(frames);
+assert(JSON.stringify(decodeAll(new FrameDecoder(), [stream])) == JSON.stringify(msgs), 'frames in one chunk');
+
+let splitOk = true;
+for (let i = 1; i < stream.length; i++) {
+    for (const j of [i + 1, i + 3, stream.length]) {
+        if (j > stream.length) continue;
+        const res = decodeAll(new FrameDecoder(), [stream.subarray(0, i), stream.subarray(i, j), stream.subarray(j)]);
+        splitOk = splitOk && JSON.stringify(res) == JSON.stringify(msgs);
+    }
+}
+assert(splitOk, 'frames split at any position');
+
+const bytes: Buffer[] = [];
+for (let i = 0; i < stream.length; i++) bytes.push(stream.subarray(i, i + 1));
+const decoder = new FrameDecoder();
+assert(JSON.stringify(decodeAll(decoder, bytes)) == JSON.stringify(msgs) && decoder.pendingBytes == 0, 'frames byte by byte');
+
+// a frame in one chunk is not copied
+const single = frames[1];
+const body = new FrameDecoder().push(single)[0];
+assert(body.buffer === single.buffer && body.byteOffset == single.byteOffset + 4, 'frame in a chunk is a view of the chunk');
+
+// --- large frame in many chunks ---
+
+const big: IpcMessage = { type: 'toolResult', requestId: 'x', result: { content: [{ type: 'text', text: 'a'.repeat(16 * 1024 * 1024) }] } };
+const bigFrame = encodeMessage(big);
+const chunks: Buffer[] = [];
+for (let i = 0; i < bigFrame.length; i += 64 * 1024) chunks.push(bigFrame.subarray(i, i + 64 * 1024));
+
+const t0 = Date.now();
+const bigRes = decodeAll(new FrameDecoder(), chunks);
+const used = Date.now() - t0;
+assert(bigRes.length == 1 && (<any>bigRes[0]).result.content[0].text.length == 16 * 1024 * 1024, 'large frame in 64K chunks');
+assert(used < 2000, `large frame is decoded in ${used} ms`);
+
+let error: any;
+try {
+    new FrameDecoder(1024).push(encodeMessage(big).subarray(0, 100));
+} catch (err) {
+    error = err;
+}
+assert(error && /too large/.test(error.message), 'frame larger than the limit is rejected');
+
+// --- progress ---
+
+const p1 = parseBuildOutputLine(">> [ 20%] CC 'src/main.c'");
+assert(p1 != undefined && p1.kind == 'build' && p1.percent == 20 && p1.message == "CC 'src/main.c'", 'build progress');
+assert(parseBuildOutputLine('[ INFO ] start linking ...')?.message == 'start linking ...', 'build step');
+
+const d1 = parseBuildOutputLine('src/main.c:12:5: warning: unused variable \'x\' [-Wunused-variable]');
+assert(d1?.kind == 'diagnostic' && d1.severity == 'warning' && d1.message.startsWith('src/main.c:12: warning: unused'), 'gcc warning');
+assert(parseBuildOutputLine('"src/main.c", line 7: Error:  #20: identifier "x" is undefined')?.severity == 'error', 'armcc error');
+assert(parseBuildOutputLine('"src\\main.c",7  Error[Pe020]: identifier "x" is undefined')?.severity == 'error', 'iar error');
+assert(parseBuildOutputLine('main.c:(.text+0x8): undefined reference to `foo\'')?.severity == 'error', 'linker error');
+assert(parseBuildOutputLine('total 12 files') == undefined, 'other lines are ignored');
+
+assert(parseFlashOutputLine('Programming flash [#####    ] 57%')?.percent == 57, 'flash progress');
+assert(parseFlashOutputLine('** Verify Started **')?.kind == 'flash', 'flash step');
+assert(parseFlashOutputLine('Error: unable to connect to the target')?.kind == 'diagnostic', 'flash error');
+assert(parseFlashOutputLine('****** Error: Failed to halt CPU.')?.kind == 'diagnostic', 'flash error: jlink');
+assert(parseFlashOutputLine('0001523 E Error: no target connected [__main__]')?.kind == 'diagnostic', 'flash error: pyocd log');
+assert(parseFlashOutputLine('Verify failed.')?.kind == 'diagnostic', 'flash error: failed');
+assert(parseFlashOutputLine('Flash download done: 0 errors, 0 warnings')?.kind != 'diagnostic', 'flash: zero error count is not an error');
+assert(parseFlashOutputLine('Programmed 4 sectors, failed: 0')?.kind != 'diagnostic', 'flash: zero failed count is not an error');
+assert(parseFlashOutputLine('Error correction disabled, erasing')?.kind != 'diagnostic', 'flash: error word in a message is not an error');
+
+// --- reporter ---
+
+const reported: McpToolProgress[] = [];
+const reporter = new ToolOutputReporter(parseBuildOutputLine, p => reported.push(p), 10000);
+reporter.write(">> [ 10%] CC 'a.c'\n>> [ 20%] CC 'b.c'\r\nsrc/b.c:1:1: error: x\n>> [ 3");
+reporter.write("0%] CC 'c.c'\nsrc/b.c:1:1: error: x\n");
+assert(reported.map(p => p.percent ?? p.severity).join(',') == '10,error', 'progress is throttled, diagnostics are reported at once');
+reporter.end();
+assert(reported.length == 3 && reported[2].percent == 30, 'the latest progress is reported at the end');
+
+console.log('all mcp frame decoder tests passed');
@@ -0,0 +1,72 @@
+/**
+ * Smoke test for the MCP tool result cache — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/mcp-result-cache.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import { CallToolResult } from '@modelcontextprotocol/sdk/types';
+import { ToolResultCache } from '../../src/mcp/mcp_cache';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const text = (t: string): CallToolResult => ({ content: [{ type: 'text', text: t }] });
+
+const cache = new ToolResultCache();
+const args = { uid: 'p1' };
+
+// unknown version, nothing is cached
+let token = cache.begin('p1');
+assert(!cache.set('p1', 'eide_get_defines', args, token, cache.getVersion('p1'), text('[]')), 'not cached without a version');
+
+cache.setVersion('p1', 3);
+assert(cache.get('p1', 'eide_get_defines', args) == undefined, 'cache miss');
+token = cache.begin('p1');
+assert(cache.set('p1', 'eide_get_defines', args, token, 3, text('["A"]')), 'result is cached');
+assert((<any>cache.get('p1', 'eide_get_defines', { uid: 'p1' })?.content[0]).text == '["A"]', 'cache hit');
+assert(cache.get('p1', 'eide_get_defines', { uid: 'p1', depth: 1 }) == undefined, 'other arguments, other entry');
+assert(cache.get('p2', 'eide_get_defines', { uid: 'p2' }) == undefined, 'other project, other entry');
+
+token = cache.begin('p1');
+assert(!cache.set('p1', 'eide_get_targets', args, token, 3, { isError: true, content: [] }), 'errors are not cached');
+
+// a new version drops the results
+cache.setVersion('p1', 3);
+assert(cache.get('p1', 'eide_get_defines', args) != undefined, 'same version keeps the results');
+cache.setVersion('p1', 4);
+assert(cache.get('p1', 'eide_get_defines', args) == undefined, 'new version drops the results');
+
+// the project is changed while the query is running
+token = cache.begin('p1');
+cache.setVersion('p1', 5);
+assert(!cache.set('p1', 'eide_get_inc_dirs', args, token, 5, text('[]')), 'result of a call across a change is not cached');
+
+token = cache.begin('p1');
+cache.invalidate('p1');
+assert(!cache.set('p1', 'eide_get_inc_dirs', args, token, 5, text('[]')) && cache.getVersion('p1') == undefined, 'invalidated by a tool call');
+
+cache.setVersion('p1', 6);
+token = cache.begin('p1');
+assert(!cache.set('p1', 'eide_get_inc_dirs', args, token, 5, text('[]')), 'result of an old version is not cached');
+assert(cache.set('p1', 'eide_get_inc_dirs', args, token, 6, text('[]')), 'result of the current version is cached');
+
+cache.retain(['p2']);
+assert(cache.get('p1', 'eide_get_inc_dirs', args) == undefined && cache.getVersion('p1') == undefined, 'closed projects are forgotten');
+
+// lookups are cheap
+cache.setVersion('p3', 1);
+token = cache.begin('p3');
+cache.set('p3', 'eide_get_targets', { uid: 'p3' }, token, 1, text('{}'));
+const t0 = process.hrtime.bigint();
+for (let i = 0; i < 100000; i++) cache.get('p3', 'eide_get_targets', { uid: 'p3' });
+const us = Number(process.hrtime.bigint() - t0) / 1000 / 100000;
+assert(us < 10, `cache hit in ${us.toFixed(3)} us`);
+
+console.log('all mcp result cache tests passed');
@@ -0,0 +1,120 @@
+/**
+ * Smoke test for PackIndex — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/pack-index.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import { PACK_INDEX_FILE_NAME, PackDeviceInfo, PackIndex, PackIndexInfo } from '../../src/PackIndex';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-pack-index-'));
+const pdscPath = path.join(tmpDir, 'Vendor.Test_DFP.pdsc');
+fs.writeFileSync(pdscPath, '<package/>');
+
+const abs = (rel: string) => tmpDir + path.sep + rel.replace(/\//g, path.sep);
+
+function makeDevice(name: string, flashSize: string): PackDeviceInfo {
+    return {
+        name: name,
+        devClassName: name,
+        core: 'Cortex-M7',
+        define: 'TEST_DEV',
+        endian: 'Little-endian',
+        svdPath: abs('SVD/test.svd'),
+        storageLayout: {
+            RAM: [{ tag: 'IRAM', id: 1, mem: { startAddr: '0x20000000', size: '0x20000' }, isChecked: true, noInit: false }],
+            ROM: [{ tag: 'IROM', id: 1, mem: { startAddr: '0x08000000', size: flashSize }, isChecked: true, isStartup: true }]
+        },
+        flashAlgorithms: [{ path: abs('Flash/test.FLM'), start: '0x08000000', size: flashSize, default: true }]
+    };
+}
+
+const pack: PackIndexInfo = {
+    vendor: 'Vendor',
+    name: 'Test_DFP',
+    familyList: [{
+        name: 'Test Series',
+        vendor: 'Vendor:1',
+        core: 'Cortex-M7',
+        series: 'Test',
+        deviceList: [],
+        subFamilyList: [{
+            name: 'TestA',
+            deviceList: [makeDevice('TEST_A1', '0x100000'), makeDevice('TEST_A2', '0x100000'), makeDevice('TEST_A3', '0x200000')]
+        }]
+    }],
+    components: [{
+        groupName: 'Startup',
+        enable: false,
+        RTE_define: '#define RTE_STARTUP',
+        condition: 'Test CMSIS',
+        incDirList: [{ path: abs('Include') }],
+        headerList: [{ path: abs('Include/test.h') }],
+        cFileList: [{ path: abs('Source/system.c'), attr: 'config', condition: 'GCC' }],
+        asmList: [],
+        linkerList: []
+    }],
+    conditionMap: new Map([
+        ['Test CMSIS', {
+            acceptList: [{ Dname: /TEST_A.*?/i }],
+            requireList: [{ Dvendor: 'Vendor:1', component: 'CMSIS.CORE' }]
+        }]
+    ])
+};
+
+// --- build and save ---
+
+PackIndex.fromPackInfo(pdscPath, pack).save();
+const idxPath = path.join(tmpDir, PACK_INDEX_FILE_NAME);
+assert(fs.existsSync(idxPath), 'index is saved next to the pdsc file');
+
+const raw = JSON.parse(fs.readFileSync(idxPath, 'utf8'));
+assert(raw.layouts.length == 2 && raw.algorithms.length == 2, 'memory layouts and algorithms are shared by devices');
+assert(!fs.readFileSync(idxPath, 'utf8').includes(tmpDir), 'paths are relative to the pack folder');
+
+// --- load ---
+
+const index = PackIndex.load(pdscPath);
+assert(index != undefined && index.deviceCount == 3, 'index is loaded');
+
+const info = index!.toPackInfo();
+const devs = info.familyList[0].subFamilyList[0].deviceList;
+assert(devs.map(d => d.name).join(',') == 'TEST_A1,TEST_A2,TEST_A3', 'device list');
+assert(devs[0].svdPath == abs('SVD/test.svd') && devs[0].devClassName == 'TEST_A1', 'device info');
+
+assert(Object.getOwnPropertyDescriptor(devs[2], 'storageLayout')!.get != undefined, 'memory layout is not created before it is accessed');
+assert(JSON.stringify(devs[2].storageLayout) == JSON.stringify(pack.familyList[0].subFamilyList[0].deviceList[2].storageLayout), 'memory layout');
+assert(Object.getOwnPropertyDescriptor(devs[2], 'storageLayout')!.get == undefined, 'memory layout is kept after the first access');
+assert(devs[0].storageLayout !== devs[1].storageLayout, 'devices do not share the layout objects');
+assert(devs[2].flashAlgorithms![0].path == abs('Flash/test.FLM') && devs[2].flashAlgorithms![0].size == '0x200000', 'flash algorithms');
+
+const comp = info.components[0];
+assert(comp.cFileList[0].path == abs('Source/system.c') && comp.cFileList[0].attr == 'config' && comp.cFileList[0].condition == 'GCC', 'component files');
+assert(comp.incDirList[0].path == abs('Include') && comp.enable === false, 'component include dirs');
+
+const cond = info.conditionMap.get('Test CMSIS')!;
+assert(cond.acceptList[0].Dname!.test('test_a2') && cond.requireList[0].component == 'CMSIS.CORE', 'conditions');
+
+// --- out of date ---
+
+fs.writeFileSync(pdscPath, '<package></package>');
+assert(PackIndex.load(pdscPath) == undefined, 'index is out of date if the pdsc file is changed');
+
+fs.writeFileSync(idxPath, '{ broken');
+assert(PackIndex.load(pdscPath) == undefined, 'broken index is ignored');
+
+fs.rmSync(tmpDir, { recursive: true, force: true });
+console.log('all pack index tests passed');
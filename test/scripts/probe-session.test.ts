@@ -0,0 +1,120 @@
+/**
+ * Integration test for ProbeSession with a stand-in OpenOCD TCL RPC server — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/probe-session.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import { OpenOCDSession, ProbeSessionManager, TclRpcClient } from '../../src/ProbeSession';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+// a fake 'openocd': serve the tcl rpc protocol on the port of '-c "tcl_port <n>"'
+const FAKE_SERVER = `
+const net = require('net');
+const args = process.argv.slice(2);
+const portArg = args.find(a => /^tcl_port \\d+$/.test(a));
+const port = parseInt(portArg.split(' ')[1]);
+let counter = 0;
+net.createServer((sock) => {
+    let buf = '';
+    sock.on('data', (d) => {
+        buf += d.toString();
+        let i;
+        while ((i = buf.indexOf('\\x1a')) >= 0) {
+            const cmd = buf.substr(0, i);
+            buf = buf.substr(i + 1);
+            let res;
+            const m = /^list \\[catch \\{capture \\{(.*)\\}\\} eide_out\\] \\$eide_out$/.exec(cmd);
+            if (m && m[1].startsWith('hang')) continue;
+            if (cmd == 'version') res = 'Open On-Chip Debugger 0.12.0 (fake)';
+            else if (m && m[1].startsWith('fail')) res = '1 {' + m[1] + ': target not halted}';
+            else if (m) res = '0 {' + m[1] + ' #' + (++counter) + ' pid ' + process.pid + '}';
+            else res = 'invalid command name';
+            sock.write(res + '\\x1a');
+        }
+    });
+}).listen(port, '127.0.0.1');
+`;
+
+async function main() {
+
+    const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-probe-session-'));
+    const serverScript = path.join(tmpDir, 'fake-openocd.js');
+    fs.writeFileSync(serverScript, FAKE_SERVER);
+
+    const newSession = () => new OpenOCDSession(process.execPath, [serverScript, '-f', 'interface/fake.cfg']);
+
+    // --- session ---
+
+    const session = newSession();
+    const r1 = await session.run(['program "app.hex" verify', 'reset run']);
+    assert(r1.success, 'session: commands succeed');
+    assert(/program "app.hex" verify #1/.test(r1.output) && /reset run #2/.test(r1.output), 'session: outputs are collected in order');
+    assert(await session.isHealthy(), 'session: health check');
+
+    const pid1 = /pid (\d+)/.exec(r1.output)![1];
+    const r2 = await session.run(['reset run']);
+    assert(r2.success && /pid (\d+)/.exec(r2.output)![1] == pid1, 'session: server is reused');
+
+    const r3 = await session.run(['fail_program "app.hex"', 'reset run']);
+    assert(!r3.success && /target not halted/.test(r3.error || '') && !/reset run/.test(r3.output), 'session: stop at the failed command');
+
+    // kill the server, it should be restarted
+    process.kill(parseInt(pid1));
+    await new Promise((resolve) => setTimeout(resolve, 300));
+    assert(!(await session.isHealthy()), 'session: dead server is detected');
+
+    const r4 = await session.run(['reset run']);
+    const pid2 = /pid (\d+)/.exec(r4.output)![1];
+    assert(r4.success && pid2 != pid1, 'session: server is restarted');
+
+    // a hung command is timeout, the server is dropped
+    session.commandTimeout = 500;
+    let timeoutError: Error | undefined;
+    try { await session.run(['hang_program "app.hex"']); } catch (error) { timeoutError = <Error>error; }
+    assert(timeoutError != undefined && /timeout/.test(timeoutError.message), 'session: command timeout is reported');
+    assert(!session.alive, 'session: hung server is stopped');
+
+    const r5 = await session.run(['reset run']);
+    assert(r5.success && /pid (\d+)/.exec(r5.output)![1] != pid2, 'session: server is restarted after a timeout');
+
+    await session.stop();
+    assert(!session.alive, 'session: stopped');
+
+    // --- client ---
+
+    const client = new TclRpcClient(1);
+    let connectFailed = false;
+    try { await client.connect(500); } catch (error) { connectFailed = true; }
+    assert(connectFailed, 'client: connect error is reported');
+
+    // --- manager ---
+
+    const manager = ProbeSessionManager.instance();
+    const m1 = await manager.run('a', newSession, ['reset run']);
+    assert(m1.success && manager.has('a'), 'manager: session is created');
+    const m2 = await manager.run('b', newSession, ['reset run']);
+    assert(m2.success && manager.has('b') && !manager.has('a'), 'manager: other sessions are closed');
+    await manager.closeAll();
+    assert(!manager.has('b'), 'manager: all sessions are closed');
+
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+    console.log('all probe session tests passed');
+}
+
+main().catch((err) => {
+    console.error('FAIL:', err);
+    process.exit(1);
+});
@@ -0,0 +1,100 @@
+/**
+ * Smoke test for SizeHistory — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/size-history.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import {
+    SizeHistory,
+    SizeSnapshot,
+    checkSizeBudgets,
+    parseSizeBudget,
+    formatSizeDiff,
+} from '../../src/SizeHistory';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+function snapshot(text: number, bss: number, symbols: { [name: string]: number }): SizeSnapshot {
+    return {
+        id: 0,
+        time: Date.now(),
+        target: 'Debug',
+        rom: text + 8,
+        ram: bss + 8,
+        romLimit: 1024,
+        ramLimit: 256,
+        sections: { '.text': text, '.data': 8, '.bss': bss },
+        symbols: symbols,
+        objects: { 'src/main.o': text }
+    };
+}
+
+// --- budgets ---
+assert(parseSizeBudget(100) === 100, 'budget: number');
+assert(parseSizeBudget('2K') === 2048 && parseSizeBudget('1.5KB') === 1536, 'budget: unit');
+assert(parseSizeBudget('0x400') === 1024, 'budget: hex');
+assert(parseSizeBudget('50%', 1000) === 500 && parseSizeBudget('50%') === undefined, 'budget: percent');
+assert(parseSizeBudget('abc') === undefined, 'budget: invalid');
+
+{
+    const snap = snapshot(1000, 100, {});
+    const v = checkSizeBudgets(snap, { rom: '97%', ram: '90%', '.bss': 200, '.not_exist': 1 });
+    assert(v.length === 1 && v[0].name === 'rom' && v[0].size === 1008 && v[0].budget === 993, 'budget: rom exceeded only');
+
+    // the percent of a ram section is based on the ram size
+    const p = checkSizeBudgets({ ...snap, ramSections: ['.data', '.bss'] }, { '.bss': '30%', '.text': '50%' });
+    assert(p.length === 2 && p[0].budget === 76 && p[1].budget === 512, 'budget: percent of ram/rom sections');
+}
+
+// --- history ---
+{
+    const tmpdir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-size-'));
+
+    let h = SizeHistory.load(tmpdir);
+    assert(h.count() === 0 && h.latest() === undefined, 'history: empty');
+
+    h.add(snapshot(500, 64, { main: 100, foo: 40, 'tmp (a.c)': 4 }));
+    h.setTag('v1.0');
+    h.add(snapshot(520, 64, { main: 100, foo: 50, bar: 10 }));
+    h.add(snapshot(600, 80, { main: 120, foo: 50, bar: 70 }));
+    h.save();
+
+    h = SizeHistory.load(tmpdir);
+    assert(h.count() === 3 && h.getTags().join() === 'v1.0', 'history: reload');
+
+    const prev = h.diff('previous')!;
+    assert(prev.base.id === 2 && prev.current.id === 3, 'diff previous: ids');
+    assert(prev.rom.delta === 80 && prev.ram.delta === 16, 'diff previous: rom/ram delta');
+    assert(prev.symbols.map(s => s.name).join() === 'bar,main', 'diff previous: top growing symbols');
+
+    const base = h.diff('v1.0', 1)!;
+    assert(base.base.tag === 'v1.0' && base.symbols.length === 1 && base.symbols[0].name === 'bar', 'diff tag: top 1');
+    assert(base.objects[0].name === 'src/main.o' && base.objects[0].delta === 100, 'diff tag: objects');
+    assert(h.diff('#1')!.base.id === 1 && h.diff('nothing') === undefined, 'diff: by id / unknown ref');
+
+    assert(formatSizeDiff(prev).includes('Top growing symbols'), 'format diff');
+
+    // old untagged records are dropped, the tagged one is kept
+    for (let i = 0; i < 120; i++)
+        h.add(snapshot(600 + i, 80, { main: 120 + i }));
+    h.save();
+    h = SizeHistory.load(tmpdir);
+    assert(h.count() === 100 && h.find('v1.0') !== undefined, 'history: limit records, keep tags');
+    assert(h.find('v1.0')!.symbols['tmp (a.c)'] === 4, 'history: names kept after compact');
+
+    fs.rmSync(tmpdir, { recursive: true, force: true });
+}
+
+console.log('\nAll SizeHistory checks passed.');
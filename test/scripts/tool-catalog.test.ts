@@ -0,0 +1,131 @@
+/**
+ * Smoke test for ToolCatalog — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/tool-catalog.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import { ToolCatalog, toolStamp, folderStamp, uniqueBy, scanFiles } from '../../src/ToolCatalog';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const sleep = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+async function main() {
+
+    const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-catalog-'));
+    const jlink = path.join(tmpDir, 'JLinkExe');
+    fs.writeFileSync(jlink, 'jlink v1');
+    const cacheFile = path.join(tmpDir, 'tool-catalogs.json');
+
+    let builds = 0;
+    const build = async () => { builds++; await sleep(5); return [`dev-${builds}`]; };
+    const buildSync = () => { builds++; return [`dev-${builds}`]; };
+
+    // --- build once ---
+
+    const catalog = new ToolCatalog(cacheFile);
+    const stamp = toolStamp([jlink]);
+    assert(catalog.lookup('jlink-devices', stamp) == undefined, 'not cached');
+
+    const [a, b] = await Promise.all([catalog.get('jlink-devices', stamp, build), catalog.get('jlink-devices', stamp, build)]);
+    assert(a[0] == 'dev-1' && b[0] == 'dev-1' && builds == 1, 'the same catalog in building is shared');
+    assert((await catalog.get('jlink-devices', stamp, build))[0] == 'dev-1' && builds == 1, 'catalog is cached');
+    assert(catalog.getSync('jlink-devices', stamp, buildSync, build)[0] == 'dev-1' && builds == 1, 'sync get from cache');
+    assert(catalog.refresh('jlink-devices', stamp, build) == undefined, 'fresh catalog is not rebuilt');
+
+    // --- persisted ---
+
+    const other = new ToolCatalog(cacheFile);
+    assert(other.getSync('jlink-devices', stamp, buildSync, build)[0] == 'dev-1' && builds == 1, 'catalog is persisted');
+    assert(other.getSync('openocd', 'x', buildSync, build)[0] == 'dev-2' && builds == 2, 'not cached catalog is built synchronously');
+
+    // --- tool is changed ---
+
+    fs.writeFileSync(jlink, 'jlink v2, a new version');
+    const newStamp = toolStamp([jlink]);
+    assert(newStamp != stamp, 'stamp is changed with the tool');
+
+    const changed = catalog.lookup<string>('jlink-devices', newStamp);
+    assert(changed != undefined && !changed.stampMatched && !changed.fresh, 'catalog of the old tool');
+    assert((await catalog.get('jlink-devices', newStamp, build))[0] == 'dev-3' && builds == 3, 'catalog of the old tool is rebuilt before it is returned');
+    assert(other.getSync('openocd', 'y', buildSync, build)[0] == 'dev-4' && builds == 4, 'catalog of the old tool is rebuilt synchronously');
+    assert(new ToolCatalog(cacheFile).lookup('jlink-devices', newStamp)!.items[0] == 'dev-3', 'catalogs of windows are merged');
+
+    // --- catalog is too old ---
+
+    const errors: string[] = [];
+    const expired = new ToolCatalog(cacheFile, { maxAge: 0, onError: (name) => errors.push(name) });
+    const aged = expired.lookup<string>('jlink-devices', newStamp);
+    assert(aged != undefined && aged.stampMatched && !aged.fresh, 'old catalog is stale');
+    assert((await expired.get('jlink-devices', newStamp, build))[0] == 'dev-3', 'old catalog is returned at once');
+    await sleep(20);
+    assert(builds == 5 && expired.lookup<string>('jlink-devices', newStamp)!.items[0] == 'dev-5', 'old catalog is rebuilt in the background');
+
+    // --- failed builds ---
+
+    const fail = () => Promise.reject(new Error('tool crashed'));
+    assert(expired.getSync('jlink-devices', newStamp, buildSync, fail)[0] == 'dev-5', 'old catalog is kept');
+    await sleep(5);
+    assert(errors[0] == 'jlink-devices' && expired.lookup<string>('jlink-devices', newStamp)!.items[0] == 'dev-5', 'failed rebuild is reported, not cached');
+
+    const failed = new ToolCatalog(cacheFile);
+    let error: any;
+    try {
+        await failed.rebuild('pyocd', 'x', fail);
+    } catch (err) {
+        error = err;
+    }
+    assert(error && failed.lookup('pyocd', 'x') == undefined, 'failed build is not cached');
+
+    failed.invalidate('openocd');
+    assert(new ToolCatalog(cacheFile).lookup('openocd', 'x') == undefined, 'invalidate');
+
+    // --- helpers ---
+
+    assert(toolStamp([path.join(tmpDir, 'none')]).endsWith('|none') && toolStamp([undefined]) == '-', 'missing tools');
+
+    const scripts = path.join(tmpDir, 'scripts', 'interface');
+    fs.mkdirSync(path.join(scripts, 'ftdi'), { recursive: true });
+    fs.writeFileSync(path.join(scripts, 'stlink.cfg'), '');
+    fs.writeFileSync(path.join(scripts, 'readme.txt'), '');
+    fs.writeFileSync(path.join(scripts, 'ftdi', 'jtagkey.cfg'), '');
+    assert((await scanFiles(scripts, /\.cfg$/i)).join(',') == 'ftdi/jtagkey.cfg,stlink.cfg', 'scan files');
+
+    const dirStamp = folderStamp(scripts);
+    await sleep(20);
+    fs.writeFileSync(path.join(scripts, 'ftdi', 'olimex.cfg'), '');
+    assert(folderStamp(scripts) != dirStamp, 'folder stamp is changed with a new file in a sub folder');
+
+    fs.mkdirSync(path.join(scripts, 'ftdi', 'olimex'));
+    const deepStamp = folderStamp(scripts, 2);
+    await sleep(20);
+    fs.writeFileSync(path.join(scripts, 'ftdi', 'olimex', 'arm-usb.cfg'), '');
+    assert(folderStamp(scripts) == folderStamp(scripts, 1) && folderStamp(scripts, 2) != deepStamp, 'folder stamp of the second level');
+
+    const devs: { vendor: string, cpuName: string }[] = [];
+    for (let i = 0; i < 100000; i++)
+        devs.push({ vendor: `V${i % 50}`, cpuName: `CPU${i % 20000}` });
+    const t0 = Date.now();
+    const unique = uniqueBy(devs, (d) => `${d.vendor}\n${d.cpuName}`);
+    assert(unique.length == 20000 && unique[0] === devs[0] && Date.now() - t0 < 1000, 'dedupe 100k devices');
+
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+    console.log('all tool catalog tests passed');
+}
+
+main().catch((err) => {
+    console.error(err);
+    process.exit(1);
+});
@@ -0,0 +1,116 @@
+/**
+ * Smoke test for Tracer — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/tracer.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import { TraceRecorder } from '../../src/Tracer';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const sleep = (ms: number) => new Promise<void>(resolve => setTimeout(resolve, ms));
+
+async function main() {
+
+    // --- disabled ---
+
+    const tracer = new TraceRecorder(64);
+    const noop = tracer.span('a');
+    noop.end();
+    tracer.counter('c', 1);
+    tracer.instant('i');
+    assert(tracer.trace('t', 'test', () => 42) == 42 && (await tracer.traceAsync('t', 'test', async () => 'x')) == 'x', 'disabled tracer runs the functions');
+    assert(tracer.count() == 0 && noop === tracer.asyncSpan('b'), 'disabled tracer records nothing');
+
+    let lazyCalls = 0;
+    const lazy = () => { lazyCalls++; return { n: lazyCalls }; };
+    tracer.span('a', 'test', lazy).end(lazy);
+    tracer.instant('i', 'test', lazy);
+    assert(lazyCalls == 0, 'lazy args are not made when disabled');
+
+    let t0 = process.hrtime.bigint();
+    for (let i = 0; i < 1000000; i++) tracer.span('hot', 'test', undefined).end();
+    const disabledNs = Number(process.hrtime.bigint() - t0) / 1000000;
+    assert(disabledNs < 200, `disabled span costs ${disabledNs.toFixed(2)} ns`);
+
+    // --- spans, counters ---
+
+    tracer.enable(true);
+
+    const outer = tracer.span('outer', 'test', { a: 1 });
+    tracer.trace('inner', 'test', () => { for (let i = 0; i < 100000; i++); });
+    tracer.counter('files', 10);
+    tracer.instant('mark');
+    outer.end(() => ({ b: 2 }));
+    outer.end(lazy);
+
+    await Promise.all([
+        tracer.traceAsync('job1', 'async', () => sleep(20)),
+        tracer.traceAsync('job2', 'async', () => sleep(10)),
+    ]);
+
+    assert(tracer.count() == 6, 'events are recorded, a span is only ended once');
+
+    const trace = tracer.toChromeTrace();
+    const events = trace.traceEvents;
+    const byName = (name: string, ph: string) => events.find(e => e.name == name && e.ph == ph);
+
+    assert(events[0].ph == 'M' && events[1].ph == 'M', 'metadata events are first');
+    const o = byName('outer', 'X');
+    const inner = byName('inner', 'X');
+    assert(o && inner && o.ts <= inner.ts && inner.ts + inner.dur <= o.ts + o.dur, 'inner span is nested in the outer span');
+    assert(o.args.a == 1 && o.args.b == 2 && lazyCalls == 0, 'span args are merged, lazy args are made once at the end');
+    assert(byName('files', 'C').args.files == 10 && byName('mark', 'i') != undefined, 'counter and instant events');
+
+    const b1 = byName('job1', 'b');
+    const e1 = byName('job1', 'e');
+    const b2 = byName('job2', 'b');
+    assert(b1 && e1 && b1.id == e1.id && b1.id != b2.id && e1.ts - b1.ts >= 15000, 'async spans have begin/end pairs with unique ids');
+
+    const sorted = events.slice(2).every((e, i, arr) => i == 0 || arr[i - 1].ts <= e.ts);
+    assert(sorted && JSON.parse(JSON.stringify(trace)).traceEvents.length == events.length, 'events are sorted and serializable');
+
+    // --- ring buffer ---
+
+    tracer.clear();
+    for (let i = 0; i < 100; i++) tracer.counter('n', i);
+    const ring = tracer.toChromeTrace();
+    const values = ring.traceEvents.filter(e => e.ph == 'C').map(e => e.args.n);
+    assert(tracer.count() == 64 && ring.otherData.overwritten == 36, 'old events are overwritten');
+    assert(values[0] == 36 && values[63] == 99, 'the newest events are kept in order');
+
+    tracer.setCapacity(1000);
+    assert(tracer.count() == 0, 'resizing drops the events');
+
+    // --- disable ---
+
+    tracer.counter('n', 1);
+    const late = tracer.span('late');
+    tracer.enable(false);
+    late.end();
+    assert(tracer.count() == 0 && tracer.toChromeTrace().traceEvents.length == 2, 'disabling frees the events, a late span is dropped');
+
+    tracer.enable(true);
+    tracer.counter('n', 1);
+    assert(tracer.count() == 1 && tracer.toChromeTrace().otherData.capacity == 1000, 're-enabling allocates the buffer');
+
+    t0 = process.hrtime.bigint();
+    for (let i = 0; i < 100000; i++) tracer.span('hot', 'test').end();
+    const enabledNs = Number(process.hrtime.bigint() - t0) / 100000;
+    console.log(`enabled span costs ${enabledNs.toFixed(0)} ns`);
+
+    console.log('all tracer tests passed');
+}
+
+main().catch((err) => {
+    console.error(err);
+    process.exit(1);
+});
@@ -0,0 +1,157 @@
+/**
+ * Smoke test for XmlStreamParser — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/xml-stream-parser.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+
+import { XmlTokenizer, XmlDomBuilder, XmlParseOptions, parseXmlString, parseXmlFile, decodeXmlEntities } from '../../src/XmlStreamParser';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const same = (a: any, b: any) => JSON.stringify(a) == JSON.stringify(b);
+
+const PROJECT = `﻿<?xml version="1.0" encoding="UTF-8" standalone="no" ?>
+<!DOCTYPE Project [ <!ENTITY x "y"> ]>
+<Project xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance" xsi:noNamespaceSchemaLocation="project_projx.xsd">
+  <SchemaVersion>2.1</SchemaVersion>
+  <!-- a comment with <tags> -->
+  <Targets>
+    <Target>
+      <TargetName>App &amp; Boot</TargetName>
+      <ToolsetName>ARM-ADS</ToolsetName>
+      <Groups>
+        <Group>
+          <GroupName>src</GroupName>
+          <Files>
+            <File>
+              <FileName>main.c</FileName>
+              <FilePath>.\\src\\main.c</FilePath>
+            </File>
+          </Files>
+        </Group>
+        <Group>
+          <GroupName>empty</GroupName>
+        </Group>
+      </Groups>
+      <Define attr="a&gt;b">USE_HAL, VAL=&quot;1&quot;</Define>
+      <Misc/>
+      <Code><![CDATA[if (a < b) {}]]></Code>
+    </Target>
+  </Targets>
+</Project>
+`;
+
+async function main() {
+
+    assert(decodeXmlEntities('&lt;a&gt; &#65;&#x42; &unknown; &amp;amp;') == '<a> AB &unknown; &amp;', 'entities are decoded');
+
+    // --- x2js layout (keil) ---
+
+    const keilOpts = {
+        format: <'x2js'>'x2js',
+        attributePrefix: '$',
+        enableToStringFunc: true,
+        arrayPaths: ['Project.Targets.Target', 'Project.Targets.Target.Groups.Group.Files.File']
+    };
+
+    const doc = parseXmlString(PROJECT, keilOpts);
+    const target = doc.Project.Targets.Target[0];
+    assert(Array.isArray(doc.Project.Targets.Target) && doc.Project.SchemaVersion == '2.1', 'x2js: array path, text element is a string');
+    assert(doc.Project['$xsi:noNamespaceSchemaLocation'] == 'project_projx.xsd', 'x2js: attribute prefix');
+    assert(target.TargetName == 'App & Boot' && target.Misc === '', 'x2js: entities and empty element');
+    assert(Array.isArray(target.Groups.Group) && target.Groups.Group.length == 2, 'x2js: repeated elements are an array');
+    assert(Array.isArray(target.Groups.Group[0].Files.File) && target.Groups.Group[0].Files.File[0].FileName == 'main.c', 'x2js: forced array of a single element');
+    assert(target.Define.__text == 'USE_HAL, VAL="1"' && target.Define.$attr == 'a>b' && `${target.Define}` == 'USE_HAL, VAL="1"', 'x2js: text with attributes, toString');
+    assert(target.Code == 'if (a < b) {}', 'CDATA');
+
+    // --- xml2js layout (eclipse, iar) ---
+
+    const dom = parseXmlString(PROJECT);
+    const t2 = dom.Project.Targets[0].Target[0];
+    assert(dom.Project.$['xsi:noNamespaceSchemaLocation'] == 'project_projx.xsd' && same(dom.Project.SchemaVersion, ['2.1']), 'xml2js: attributes and explicit arrays');
+    assert(same(t2.Define, [{ $: { attr: 'a>b' }, _: 'USE_HAL, VAL="1"' }]), 'xml2js: text with attributes');
+    assert(same(t2.Misc, ['']) && t2.Groups[0].Group.length == 2 && t2.Groups[0].Group[1].GroupName[0] == 'empty', 'xml2js: empty elements');
+
+    // --- split at every position ---
+
+    const parseChunked = (text: string, size: number, options?: XmlParseOptions) => {
+        const builder = new XmlDomBuilder(options);
+        const tokenizer = new XmlTokenizer(builder);
+        for (let i = 0; i < text.length; i += size)
+            tokenizer.write(text.substr(i, size));
+        tokenizer.end();
+        return builder.getResult();
+    };
+
+    let ok = true;
+    for (let size = 1; size < 64 && ok; size++) {
+        ok = same(parseChunked(PROJECT, size, keilOpts), doc) && same(parseChunked(PROJECT, size), dom);
+        if (!ok) console.error(`chunk size: ${size}`);
+    }
+    assert(ok, 'the result is the same for any chunk size');
+
+    // --- errors ---
+
+    let error: any;
+    try { parseXmlString('<a><b></a>'); } catch (err) { error = err; }
+    assert(error && /Unexpected closing tag '<\/a>', expected '<\/b>'/.test(error.message), 'mismatched tag');
+
+    error = undefined;
+    try { parseXmlString('<a><b>'); } catch (err) { error = err; }
+    assert(error && /not closed/.test(error.message), 'unclosed element');
+
+    // --- file stream and skip ---
+
+    const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-xml-'));
+    const cproject = path.join(tmpDir, '.cproject');
+    const scanner = '<scannerConfigBuildInfo>' + '<autodiscovery enabled="true" problemReportingEnabled="true"/>'.repeat(20000) + '</scannerConfigBuildInfo>';
+    fs.writeFileSync(cproject, `<?xml version="1.0"?><cproject>
+        <storageModule moduleId="org.eclipse.cdt.core.settings"><cconfiguration id="debug"/></storageModule>
+        <storageModule moduleId="scannerConfiguration">${scanner}</storageModule>
+        <storageModule moduleId="refreshScope"/>
+    </cproject>`);
+
+    const all = await parseXmlFile(cproject, undefined, 4096);
+    assert(all.cproject.storageModule.length == 3 && all.cproject.storageModule[1].scannerConfigBuildInfo[0].autodiscovery.length == 20000, 'file is parsed by chunks');
+
+    const pruned = await parseXmlFile(cproject, {
+        skip: (p, attrs) => p == 'cproject.storageModule' && attrs['moduleId'] != 'org.eclipse.cdt.core.settings'
+    });
+    assert(pruned.cproject.storageModule.length == 1 && pruned.cproject.storageModule[0].cconfiguration[0].$.id == 'debug', 'sub trees are skipped');
+
+    const bad = path.join(tmpDir, 'bad.xml');
+    fs.writeFileSync(bad, '<a><b></a>');
+    error = undefined;
+    try { await parseXmlFile(bad); } catch (err) { error = err; }
+    assert(error && error.message.includes(bad), 'file error has the path');
+
+    // --- speed ---
+
+    const big = path.join(tmpDir, 'big.uvprojx');
+    const files = '<File><FileName>a.c</FileName><FileType>1</FileType><FilePath>..\\src\\a.c</FilePath></File>'.repeat(50000);
+    fs.writeFileSync(big, `<Project><Targets><Target><Groups><Group><Files>${files}</Files></Group></Groups></Target></Targets></Project>`);
+    const t0 = Date.now();
+    const bigDoc = await parseXmlFile(big, keilOpts);
+    console.log(`${(fs.statSync(big).size / 1048576).toFixed(1)} MB parsed in ${Date.now() - t0} ms`);
+    assert(bigDoc.Project.Targets.Target[0].Groups.Group.Files.File.length == 50000, 'big file');
+
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+    console.log('all xml stream parser tests passed');
+}
+
+main().catch((err) => {
+    console.error(err);
+    process.exit(1);
+});
@@ -0,0 +1,193 @@
+/**
+ * Smoke test for ZipArchive — run with:
+ *   npx tsc -p test
+ *   node out/tmp/test/scripts/zip-archive.test.js
+ *
+ * Build output is under out/tmp only (never emits .js into src/).
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import * as zlib from 'zlib';
+
+import { ZipArchive, crc32 } from '../../src/ZipArchive';
+
+function assert(cond: boolean, msg: string): void {
+    if (!cond) {
+        console.error('FAIL:', msg);
+        process.exit(1);
+    }
+    console.log('OK:', msg);
+}
+
+const DOS_TIME = (12 << 11) | (30 << 5);           // 12:30:00
+const DOS_DATE = ((2025 - 1980) << 9) | (1 << 5) | 2; // 2025-01-02
+
+/** make a zip file in memory, entries are deflated if 'deflate' is set */
+function makeZip(files: { name: string, data: Buffer, deflate?: boolean, mode?: number }[]): Buffer {
+
+    const locals: Buffer[] = [];
+    const centrals: Buffer[] = [];
+    let offset = 0;
+
+    for (const f of files) {
+
+        const name = Buffer.from(f.name);
+        const body = f.deflate ? zlib.deflateRawSync(f.data) : f.data;
+        const method = f.deflate ? 8 : 0;
+        const crc = crc32(f.data);
+
+        const local = Buffer.alloc(30);
+        local.writeUInt32LE(0x04034b50, 0);
+        local.writeUInt16LE(20, 4);
+        local.writeUInt16LE(method, 8);
+        local.writeUInt16LE(DOS_TIME, 10);
+        local.writeUInt16LE(DOS_DATE, 12);
+        local.writeUInt32LE(crc, 14);
+        local.writeUInt32LE(body.length, 18);
+        local.writeUInt32LE(f.data.length, 22);
+        local.writeUInt16LE(name.length, 26);
+        locals.push(local, name, body);
+
+        const central = Buffer.alloc(46);
+        central.writeUInt32LE(0x02014b50, 0);
+        central.writeUInt16LE(f.mode ? (3 << 8) | 20 : 20, 4);
+        central.writeUInt16LE(20, 6);
+        central.writeUInt16LE(method, 10);
+        central.writeUInt16LE(DOS_TIME, 12);
+        central.writeUInt16LE(DOS_DATE, 14);
+        central.writeUInt32LE(crc, 16);
+        central.writeUInt32LE(body.length, 20);
+        central.writeUInt32LE(f.data.length, 24);
+        central.writeUInt16LE(name.length, 28);
+        central.writeUInt32LE(((f.mode || 0) << 16) >>> 0, 38);
+        central.writeUInt32LE(offset, 42);
+        centrals.push(central, name);
+
+        offset += local.length + name.length + body.length;
+    }
+
+    const cd = Buffer.concat(centrals);
+    const eocd = Buffer.alloc(22);
+    eocd.writeUInt32LE(0x06054b50, 0);
+    eocd.writeUInt16LE(files.length, 8);
+    eocd.writeUInt16LE(files.length, 10);
+    eocd.writeUInt32LE(cd.length, 12);
+    eocd.writeUInt32LE(offset, 16);
+
+    return Buffer.concat(locals.concat([cd, eocd]));
+}
+
+assert(crc32(Buffer.from('123456789')) == 0xcbf43926, 'crc32 check value');
+assert(crc32(Buffer.from('56789'), crc32(Buffer.from('1234'))) == 0xcbf43926, 'crc32 can be computed in chunks');
+
+const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'eide-zip-'));
+const zipPath = path.join(tmpDir, 'Vendor.Test_DFP.1.0.0.pack');
+
+const pdsc = Buffer.from('<package><name>Test_DFP</name></package>');
+const header = Buffer.from('#define TEST_H\n'.repeat(200));
+
+fs.writeFileSync(zipPath, makeZip([
+    { name: 'Vendor.Test_DFP.pdsc', data: pdsc },
+    { name: 'Include/', data: Buffer.alloc(0) },
+    { name: 'Include/test.h', data: header, deflate: true },
+    { name: 'Include/sub/regs.h', data: Buffer.from('int x;'), deflate: true },
+    { name: 'SVD/Test.svd', data: Buffer.from('<device/>') },
+]));
+
+// --- central directory ---
+
+const zip = ZipArchive.open(zipPath);
+assert(zip.entries.length == 5, 'all entries are listed');
+
+const hEntry = zip.getEntry('Include/test.h');
+assert(hEntry != undefined && hEntry.size == header.length && hEntry.compressedSize < header.length, 'entry info');
+assert(new Date(hEntry!.mtime).getFullYear() == 2025 && new Date(hEntry!.mtime).getHours() == 12, 'entry mtime');
+assert(zip.getEntry('./include\\TEST.H') === hEntry, 'entry lookup ignores the case and separators');
+assert(zip.getEntry('Include/none.h') == undefined, 'missing entry');
+
+const under = zip.getEntriesUnder('include').map(e => e.name).sort();
+assert(under.join(',') == 'Include/sub/regs.h,Include/test.h', 'files under a folder');
+
+// --- read ---
+
+assert(zip.read(zip.getEntry('Vendor.Test_DFP.pdsc')!).equals(pdsc), 'read a stored entry');
+assert(zip.read(hEntry!).equals(header), 'read a deflated entry');
+
+// --- extract ---
+
+const outDir = path.join(tmpDir, 'out');
+const svdEntry = zip.getEntry('svd/test.svd')!;
+zip.extract(svdEntry, path.join(outDir, 'SVD', 'Test.svd'), outDir);
+assert(fs.readFileSync(path.join(outDir, 'SVD', 'Test.svd'), 'utf8') == '<device/>', 'extract a file, parent folders are created');
+assert(fs.statSync(path.join(outDir, 'SVD', 'Test.svd')).mtime.getTime() == svdEntry.mtime, 'extracted file keeps the mtime');
+assert(fs.readdirSync(path.join(outDir, 'SVD')).length == 1, 'no temp file is left');
+
+zip.extract(zip.getEntry('Include/')!, path.join(outDir, 'Include'), outDir);
+assert(fs.statSync(path.join(outDir, 'Include')).isDirectory(), 'extract a folder');
+
+let pathError = false;
+try { zip.extract(svdEntry, path.join(tmpDir, 'Test.svd'), outDir); } catch (error) { pathError = true; }
+assert(pathError && !fs.existsSync(path.join(tmpDir, 'Test.svd')), 'file out of the root is rejected');
+
+zip.close();
+
+// --- symlinks ---
+
+const linkZipPath = path.join(tmpDir, 'links.zip');
+fs.writeFileSync(linkZipPath, makeZip([
+    { name: 'inc', data: Buffer.from('Include'), mode: 0o120777 },
+    { name: 'evil', data: Buffer.from(tmpDir), mode: 0o120777 },
+    { name: 'up', data: Buffer.from('../..'), mode: 0o120777 },
+]));
+
+const linkZip = ZipArchive.open(linkZipPath);
+assert(ZipArchive.isSymlink(linkZip.getEntry('evil')!), 'symlink entry');
+
+const linkOut = path.join(tmpDir, 'links');
+linkZip.extract(linkZip.getEntry('inc')!, path.join(linkOut, 'inc'), linkOut);
+assert(fs.readlinkSync(path.join(linkOut, 'inc')) == 'Include', 'symlink in the root is created');
+
+for (const name of ['evil', 'up']) {
+    let linkError = false;
+    try { linkZip.extract(linkZip.getEntry(name)!, path.join(linkOut, name), linkOut); } catch (error) { linkError = true; }
+    assert(linkError && !fs.existsSync(path.join(linkOut, name)), `symlink out of the root is rejected: '${name}'`);
+}
+
+
+// --- corrupted data ---
+
+const broken = fs.readFileSync(zipPath);
+const pos = broken.indexOf('<device/>');
+broken[pos + 1] ^= 0xff;
+fs.writeFileSync(zipPath, broken);
+
+const zip2 = ZipArchive.open(zipPath);
+let crcError = false;
+try {
+    zip2.read(zip2.getEntry('SVD/Test.svd')!);
+} catch (error) {
+    crcError = /crc32/.test((<Error>error).message);
+}
+zip2.close();
+assert(crcError, 'corrupted entry is detected by crc32');
+
+fs.writeFileSync(zipPath, 'not a zip');
+let openError = false;
+try {
+    ZipArchive.open(zipPath);
+} catch (error) {
+    openError = true;
+}
+assert(openError, 'non-zip file is rejected');
+
+(async () => {
+    let linkError = false;
+    try { await linkZip.extractAsync(linkZip.getEntry('evil')!, path.join(linkOut, 'evil'), linkOut); } catch (error) { linkError = true; }
+    assert(linkError && !fs.existsSync(path.join(linkOut, 'evil')), 'symlink out of the root is rejected by extractAsync');
+    linkZip.close();
+
+    fs.rmSync(tmpDir, { recursive: true, force: true });
+    console.log('all zip archive tests passed');
+})();